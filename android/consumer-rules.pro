@@ -0,0 +1,4 @@
+# Wrappers.rawTransportOf reads the SDK's private ESPDevice.transport by reflection
+-keepclassmembers class com.espressif.provisioning.ESPDevice {
+  *** transport;
+}
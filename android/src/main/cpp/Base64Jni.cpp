@@ -0,0 +1,48 @@
+#include <jni.h>
+#include "core/Base64.hpp"
+#include "core/Errors.hpp"
+#include <string_view>
+
+// JNI entry points of com.margelo.nitro.espprovtoolkit.NativeBase64
+
+extern "C" JNIEXPORT jbyteArray JNICALL
+Java_com_margelo_nitro_espprovtoolkit_NativeBase64_decode(JNIEnv* env, jclass, jstring base64) {
+  if (base64 == nullptr) {
+    return nullptr;
+  }
+  // Modified UTF-8 keeps ASCII as is, anything else becomes bytes from 0x80 that the decoder rejects
+  const char* chars = env->GetStringUTFChars(base64, nullptr);
+  if (chars == nullptr) {
+    return nullptr;
+  }
+  espprov::Bytes bytes;
+  bool valid = true;
+  try {
+    bytes = espprov::decodeBase64(std::string_view(chars, static_cast<size_t>(env->GetStringUTFLength(base64))));
+  } catch (const espprov::ProtocommError&) {
+    valid = false;
+  }
+  env->ReleaseStringUTFChars(base64, chars);
+  if (!valid) {
+    return nullptr;
+  }
+  jbyteArray array = env->NewByteArray(static_cast<jsize>(bytes.size()));
+  if (array != nullptr) {
+    env->SetByteArrayRegion(array, 0, static_cast<jsize>(bytes.size()), reinterpret_cast<const jbyte*>(bytes.data()));
+  }
+  return array;
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_margelo_nitro_espprovtoolkit_NativeBase64_encode(JNIEnv* env, jclass, jbyteArray bytes) {
+  jsize length = env->GetArrayLength(bytes);
+  void* data = env->GetPrimitiveArrayCritical(bytes, nullptr);
+  if (data == nullptr) {
+    return nullptr;
+  }
+  // Encoding allocates but does not call back into the VM, which is all a critical section asks
+  std::string encoded = espprov::encodeBase64(espprov::ByteView(static_cast<const uint8_t*>(data), static_cast<size_t>(length)));
+  env->ReleasePrimitiveArrayCritical(bytes, data, JNI_ABORT);
+  // The alphabet is ASCII, so this is valid modified UTF-8
+  return env->NewStringUTF(encoded.c_str());
+}
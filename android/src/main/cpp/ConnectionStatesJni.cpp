@@ -0,0 +1,57 @@
+#include <jni.h>
+#include "core/ConnectionStateMachine.hpp"
+#include <chrono>
+#include <optional>
+#include <string>
+
+// JNI entry points of com.margelo.nitro.espprovtoolkit.NativeConnectionStates
+
+namespace {
+  std::string nameOf(JNIEnv* env, jstring deviceName) {
+    const char* chars = env->GetStringUTFChars(deviceName, nullptr);
+    if (chars == nullptr) {
+      return {};
+    }
+    std::string name(chars, static_cast<size_t>(env->GetStringUTFLength(deviceName)));
+    env->ReleaseStringUTFChars(deviceName, chars);
+    return name;
+  }
+} // namespace
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_margelo_nitro_espprovtoolkit_NativeConnectionStates_beginConnect(JNIEnv* env, jclass, jstring deviceName) {
+  auto machine = espprov::ConnectionRegistry::shared().machine(nameOf(env, deviceName));
+  return static_cast<jlong>(machine->beginConnect());
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_margelo_nitro_espprovtoolkit_NativeConnectionStates_post(JNIEnv* env, jclass, jstring deviceName, jlong attempt,
+                                                                  jint event, jint error) {
+  if (event < 0 || event > static_cast<jint>(espprov::ConnectionEvent::TIMEOUT) || attempt < 0) {
+    return JNI_FALSE;
+  }
+  std::optional<int> code = error >= 0 ? std::optional<int>(error) : std::nullopt;
+  auto machine = espprov::ConnectionRegistry::shared().machine(nameOf(env, deviceName));
+  bool applied = machine->post(static_cast<espprov::ConnectionEvent>(event), static_cast<uint64_t>(attempt), code);
+  return applied ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_margelo_nitro_espprovtoolkit_NativeConnectionStates_awaitLeaving(JNIEnv* env, jclass, jstring deviceName, jint state,
+                                                                          jlong attempt, jlong timeoutMs) {
+  auto machine = espprov::ConnectionRegistry::shared().machine(nameOf(env, deviceName));
+  auto left = machine->awaitLeaving(static_cast<espprov::ConnectionState>(state), static_cast<uint64_t>(attempt),
+                                    std::chrono::milliseconds(timeoutMs < 0 ? 0 : timeoutMs));
+  return static_cast<jint>(left);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_margelo_nitro_espprovtoolkit_NativeConnectionStates_state(JNIEnv* env, jclass, jstring deviceName) {
+  auto state = espprov::ConnectionRegistry::shared().state(nameOf(env, deviceName));
+  return static_cast<jint>(state.value_or(espprov::ConnectionState::IDLE));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_margelo_nitro_espprovtoolkit_NativeConnectionStates_release(JNIEnv* env, jclass, jstring deviceName) {
+  espprov::ConnectionRegistry::shared().remove(nameOf(env, deviceName));
+}
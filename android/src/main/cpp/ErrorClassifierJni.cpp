@@ -0,0 +1,41 @@
+#include <jni.h>
+#include "core/ErrorClassifier.hpp"
+#include <optional>
+#include <string_view>
+
+// JNI entry points of com.margelo.nitro.espprovtoolkit.NativeErrorClassifier
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_margelo_nitro_espprovtoolkit_NativeErrorClassifier_classify(JNIEnv* env, jclass, jstring message, jint sdkCode) {
+  std::optional<int> code = sdkCode >= 0 ? std::optional<int>(sdkCode) : std::nullopt;
+  if (message == nullptr) {
+    auto known = espprov::ErrorClassifier::shared().classify({}, code);
+    return known ? static_cast<jint>(*known) : -1;
+  }
+  // Modified UTF-8 keeps ASCII as is, which is all the patterns contain
+  const char* chars = env->GetStringUTFChars(message, nullptr);
+  if (chars == nullptr) {
+    return -1;
+  }
+  std::string_view text(chars, static_cast<size_t>(env->GetStringUTFLength(message)));
+  auto classified = espprov::ErrorClassifier::shared().classify(text, code);
+  env->ReleaseStringUTFChars(message, chars);
+  return classified ? static_cast<jint>(*classified) : -1;
+}
+
+extern "C" JNIEXPORT jobjectArray JNICALL
+Java_com_margelo_nitro_espprovtoolkit_NativeErrorClassifier_descriptions(JNIEnv* env, jclass, jint code) {
+  std::vector<std::string_view> texts;
+  if (espprov::isKnownErrorCode(code)) {
+    texts = espprov::ErrorClassifier::shared().descriptions(static_cast<espprov::ErrorCode>(code));
+  }
+  jclass stringClass = env->FindClass("java/lang/String");
+  jobjectArray array = env->NewObjectArray(static_cast<jsize>(texts.size()), stringClass, nullptr);
+  for (size_t i = 0; i < texts.size(); i++) {
+    // The table's strings are ASCII literals, so they are terminated
+    jstring text = env->NewStringUTF(texts[i].data());
+    env->SetObjectArrayElement(array, static_cast<jsize>(i), text);
+    env->DeleteLocalRef(text);
+  }
+  return array;
+}
@@ -0,0 +1,49 @@
+#include <jni.h>
+#include "core/Tracer.hpp"
+#include <chrono>
+#include <string>
+
+// JNI entry points of com.margelo.nitro.espprovtoolkit.NativeTrace
+
+namespace {
+  std::string stringOf(JNIEnv* env, jstring text) {
+    if (text == nullptr) {
+      return {};
+    }
+    const char* chars = env->GetStringUTFChars(text, nullptr);
+    if (chars == nullptr) {
+      return {};
+    }
+    std::string result(chars, static_cast<size_t>(env->GetStringUTFLength(text)));
+    env->ReleaseStringUTFChars(text, chars);
+    return result;
+  }
+
+  std::chrono::steady_clock::time_point timeOf(jlong nanos) {
+    return std::chrono::steady_clock::time_point(std::chrono::nanoseconds(nanos));
+  }
+} // namespace
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_margelo_nitro_espprovtoolkit_NativeTrace_enabled(JNIEnv*, jclass) {
+  return espprov::Tracer::shared().enabled() ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_margelo_nitro_espprovtoolkit_NativeTrace_now(JNIEnv*, jclass) {
+  return static_cast<jlong>(std::chrono::steady_clock::now().time_since_epoch() / std::chrono::nanoseconds(1));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_margelo_nitro_espprovtoolkit_NativeTrace_complete(JNIEnv* env, jclass, jint category, jstring name, jstring detail,
+                                                           jlong startNanos, jlong endNanos, jstring threadName) {
+  if (category < 0 || category >= static_cast<jint>(espprov::TRACE_CATEGORY_COUNT)) {
+    return;
+  }
+  espprov::Tracer& tracer = espprov::Tracer::shared();
+  if (!espprov::Tracer::isThreadNamed()) {
+    tracer.nameThread(stringOf(env, threadName));
+  }
+  tracer.complete(static_cast<espprov::TraceCategory>(category), stringOf(env, name), stringOf(env, detail), timeOf(startNanos),
+                  timeOf(endNanos));
+}
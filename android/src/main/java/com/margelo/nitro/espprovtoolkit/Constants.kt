@@ -7,6 +7,8 @@ class Constants {
     const val WIFI_CONFIGURE_REQUEST_CODE = 1003;
     const val WIFI_ALL_REQUEST_CODE = 1004;
     const val BLE_SCAN_REQUEST_CODE = 1005;
+    // Distinct devices a streaming discovery holds for a consumer that is not keeping up.
+    const val DISCOVERY_BUFFER_SIZE = 32;
 
 
   }
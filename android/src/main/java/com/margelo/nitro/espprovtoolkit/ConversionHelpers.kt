@@ -4,10 +4,22 @@ import com.margelo.nitro.espprovtoolkit.PTTransport
 
 import com.espressif.provisioning.ESPConstants.SecurityType
 import com.espressif.provisioning.ESPConstants.TransportType
+import com.margelo.nitro.core.ArrayBuffer
+import java.nio.ByteBuffer
 
 
 class ConversionHelpers {
   companion object{
+    // Must run on the calling (JS) thread, a JS owned buffer cannot be read from the thread pool
+    fun bytesOf(buffer : ArrayBuffer): ByteArray{
+      val byteBuffer = buffer.getBuffer(false)
+      val bytes = ByteArray(byteBuffer.remaining())
+      byteBuffer.duplicate().get(bytes)
+      return bytes
+    }
+    fun arrayBufferOf(bytes : ByteArray?): ArrayBuffer{
+      return ArrayBuffer.copy(ByteBuffer.wrap(bytes ?: ByteArray(0)))
+    }
     fun convertSecurity(security : SecurityType): PTSecurity{
       return when (security){
         SecurityType.SECURITY_0 -> PTSecurity.SECURITY_0
@@ -0,0 +1,121 @@
+package com.margelo.nitro.espprovtoolkit
+
+import android.os.SystemClock
+import android.util.Log
+import com.espressif.provisioning.ESPDevice
+
+/**
+ * The process wide store of ESPDevice instances, bounded by count and by idle time.
+ *
+ * Entries are kept in least recently used order. Whenever the registry is touched, entries idle
+ * for longer than [idleTimeoutMs] and the oldest ones beyond [maxDevices] are dropped, and
+ * [onRelease] is called for each of them so their link and session can be torn down. Entries
+ * [isSecured] reports are kept however long they idle, only [maxDevices] drops them.
+ */
+class DeviceRegistry(
+  private val isSecured: (deviceName: String) -> Boolean,
+  private val onRelease: (deviceName: String, device: ESPDevice) -> Unit
+) {
+  companion object {
+    const val TAG = "DeviceRegistry"
+    const val DEFAULT_MAX_DEVICES = 64
+    const val DEFAULT_IDLE_TIMEOUT_MS = 10 * 60 * 1000L
+  }
+
+  private class Entry(val device: ESPDevice, var lastUsed: Long)
+
+  private val lock = Any()
+  // accessOrder = true: iteration starts at the least recently used entry
+  private val entries = LinkedHashMap<String, Entry>(16, 0.75f, true)
+  private var maxDevices = DEFAULT_MAX_DEVICES
+  private var idleTimeoutMs = DEFAULT_IDLE_TIMEOUT_MS
+
+  fun setLimits(maxDevices: Int, idleTimeoutMs: Long) {
+    release(synchronized(lock) {
+      this.maxDevices = maxOf(maxDevices, 1)
+      this.idleTimeoutMs = maxOf(idleTimeoutMs, 0L)
+      evict()
+    })
+  }
+
+  fun put(deviceName: String, device: ESPDevice) {
+    release(synchronized(lock) {
+      val released = mutableListOf<Pair<String, ESPDevice>>()
+      val previous = entries.put(deviceName, Entry(device, SystemClock.elapsedRealtime()))
+      if (previous != null && previous.device !== device) {
+        released.add(deviceName to previous.device)
+      }
+      released + evict()
+    })
+  }
+
+  fun get(deviceName: String): ESPDevice? {
+    var device: ESPDevice? = null
+    release(synchronized(lock) {
+      // Touch first: a device that is asked for again is not idle, however long it waited.
+      val entry = entries[deviceName]
+      entry?.lastUsed = SystemClock.elapsedRealtime()
+      device = entry?.device
+      evict()
+    })
+    return device
+  }
+
+  fun contains(deviceName: String): Boolean {
+    var contained = false
+    release(synchronized(lock) {
+      val released = evict()
+      contained = entries.containsKey(deviceName)
+      released
+    })
+    return contained
+  }
+
+  fun remove(deviceName: String): Boolean {
+    val entry = synchronized(lock) { entries.remove(deviceName) } ?: return false
+    release(listOf(deviceName to entry.device))
+    return true
+  }
+
+  fun clear() {
+    release(synchronized(lock) {
+      val released = entries.map { (deviceName, entry) -> deviceName to entry.device }
+      entries.clear()
+      released
+    })
+  }
+
+  // Drops expired entries, then the least recently used ones above the limit. Must hold lock.
+  private fun evict(): List<Pair<String, ESPDevice>> {
+    val now = SystemClock.elapsedRealtime()
+    val released = mutableListOf<Pair<String, ESPDevice>>()
+    val iterator = entries.entries.iterator()
+    while (iterator.hasNext()) {
+      val (deviceName, entry) = iterator.next()
+      // Use order and idle time agree, so the first entry that is not idle ends the sweep.
+      if (entries.size <= maxDevices) {
+        if (now - entry.lastUsed <= idleTimeoutMs) {
+          break
+        }
+        // A secured session idles on, the entries after it may still have expired
+        if (isSecured(deviceName)) {
+          continue
+        }
+      }
+      iterator.remove()
+      released.add(deviceName to entry.device)
+    }
+    return released
+  }
+
+  // Runs onRelease outside the lock, it calls into the SDK and the native engine.
+  private fun release(released: List<Pair<String, ESPDevice>>) {
+    for ((deviceName, device) in released) {
+      try {
+        onRelease(deviceName, device)
+      } catch (e: Exception) {
+        Log.w(TAG, "Releasing $deviceName failed: ${e.message}")
+      }
+    }
+  }
+}
@@ -10,25 +10,49 @@ import com.espressif.provisioning.ESPConstants
 import com.espressif.provisioning.ESPDevice
 import com.facebook.proguard.annotations.DoNotStrip
 import com.facebook.react.bridge.ReactApplicationContext
+import com.margelo.nitro.core.ArrayBuffer
 import com.margelo.nitro.core.Promise
 import com.margelo.nitro.espprovtoolkit.Wrappers
-import android.util.Base64
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.channels.ClosedReceiveChannelException
+import kotlinx.coroutines.channels.ReceiveChannel
+import kotlinx.coroutines.channels.produce
+import kotlinx.coroutines.withTimeoutOrNull
 
 @DoNotStrip
 class EspProvToolkit : HybridEspProvToolkitSpec() {
   companion object{
     const val TAG = "EspProvToolkit"
-    var devices : MutableMap<String,ESPDevice> = mutableMapOf()
+    // Devices whose BLE link was opened for the native engine's raw transport
+    val rawLinks : MutableSet<String> = java.util.Collections.synchronizedSet(mutableSetOf())
+    // Dropping a device closes its GATT link, which also ends its SDK session and its keys
+    val devices = DeviceRegistry(
+      isSecured = { deviceName -> NativeConnectionStates.state(deviceName) == NativeConnectionStates.SECURED }
+    ) { deviceName, device ->
+      rawLinks.remove(deviceName)
+      SdkConnectionEvents.forget(deviceName)
+      device.disconnectDevice()
+      NativeConnectionStates.release(deviceName)
+    }
+    // The streaming discovery started by startDiscoveringESPDevices, if any
+    @Volatile private var discovery : Discovery? = null
   }
 
+  // Devices created from a streaming scan, handed to JS in batches by nextDiscoveredESPDevices
+  private class Discovery(val scope: CoroutineScope, val devices: ReceiveChannel<ESPDevice>)
+
   private var locationHelper: LocationPermissionHelper? = null
 
   private fun storeDevice(device: ESPDevice, key: String){
-    devices[key] = device
+    devices.put(key, device)
   }
 
   private fun getDevice(deviceName: String): ESPDevice{
-    return devices[deviceName] ?: throw PTException(PTExtendedError.RUNTIME_DOES_NOT_EXIST_LOCALLY)
+    return devices.get(deviceName) ?: throw PTException(PTExtendedError.RUNTIME_DOES_NOT_EXIST_LOCALLY)
   }
 
   private fun getLocationHelper() : LocationPermissionHelper{
@@ -121,6 +145,8 @@ class EspProvToolkit : HybridEspProvToolkitSpec() {
   @RequiresPermission(allOf = [Manifest.permission.ACCESS_FINE_LOCATION, Manifest.permission.BLUETOOTH_ADMIN, Manifest.permission.BLUETOOTH])
   override fun stopSearchingForESPDevices() {
     try {
+      discovery?.scope?.cancel()
+      discovery = null
       Wrappers.stopBleSearch()
     } catch(e : Exception){
      val errCode = handleExceptions(e)
@@ -128,6 +154,96 @@ class EspProvToolkit : HybridEspProvToolkitSpec() {
     }
   }
 
+  @OptIn(ExperimentalCoroutinesApi::class)
+  @RequiresPermission(allOf = [Manifest.permission.ACCESS_FINE_LOCATION, Manifest.permission.BLUETOOTH_ADMIN, Manifest.permission.BLUETOOTH])
+  override fun startDiscoveringESPDevices(
+    devicePrefix: String,
+    transport: PTTransport,
+    security: PTSecurity,
+    scanTimeoutMs: Double?
+  ): PTResult {
+    try {
+      val ctx = getContext()
+      discovery?.scope?.cancel()
+      val scope = CoroutineScope(Dispatchers.Default)
+      // Rendezvous channel: a device is only created once JS asked for more.
+      val found = scope.produce<ESPDevice> {
+        if (transport == PTTransport.TRANSPORT_BLE) {
+          PermissionsHelper.requestBleScanPerms(ctx)
+          // Devices already handed out, so a repeated scan only reports new ones
+          val seen = java.util.Collections.synchronizedSet(mutableSetOf<Pair<String, String>>())
+          val scanOnce: suspend () -> Unit = {
+            val bleDevices = Wrappers.startBleDiscovery(devicePrefix, seen)
+            var scanEnded = false
+            try {
+              for (metadata in bleDevices) {
+                val espDevice = Wrappers.createDeviceNoScan(metadata.deviceName,
+                  ConversionHelpers.convertTransport(transport),
+                  ConversionHelpers.convertSecurity(security),
+                  null, null, null)
+                espDevice.bluetoothDevice = metadata.bleDevice
+                espDevice.primaryServiceUuid = metadata.serviceUuid
+                send(espDevice)
+              }
+              scanEnded = true
+            } finally {
+              // Stopped before the scan window closed, make sure the scan stops too.
+              if (!scanEnded) {
+                bleDevices.cancel()
+                Wrappers.stopBleSearch()
+              }
+            }
+          }
+          if (scanTimeoutMs == null) {
+            scanOnce()
+          } else {
+            // The SDK closes its own scan window, scan again until the requested one closes
+            withTimeoutOrNull(scanTimeoutMs.toLong()) {
+              while (true) {
+                scanOnce()
+              }
+            }
+          }
+        } else { // SoftAP, the platform only reports whole Wi-Fi scans
+          PermissionsHelper.requestSoftapScanPerms(ctx)
+          for (ap in Wrappers.searchSoftap(devicePrefix).distinctBy { it.wifiName }) {
+            val espDevice = Wrappers.createDeviceNoScan(ap.wifiName, ConversionHelpers.convertTransport(transport),
+              ConversionHelpers.convertSecurity(security), null,null,null)
+            espDevice.wifiDevice = ap
+            send(espDevice)
+          }
+        }
+      }
+      discovery = Discovery(scope, found)
+      return PTResult(true, null)
+    } catch (e : Exception){
+      return PTResult(false, handleExceptions(e).toDouble())
+    }
+  }
+
+  override fun nextDiscoveredESPDevices(): Promise<PTSearchResult> {
+    return Promise.async {
+      val found = discovery?.devices ?: return@async PTSearchResult(true, arrayOf(), null)
+      try {
+        // Wait for one device, then take whatever else is ready without waiting again.
+        val batch = mutableListOf(found.receive())
+        while (true) {
+          batch.add(found.tryReceive().getOrNull() ?: break)
+        }
+        for (espDevice in batch) {
+          storeDevice(espDevice, espDevice.deviceName)
+        }
+        return@async PTSearchResult(true, batch.map { it.deviceName }.toTypedArray(), null)
+      } catch (e : ClosedReceiveChannelException) {
+        return@async PTSearchResult(true, arrayOf(), null)
+      } catch (e : CancellationException) {
+        return@async PTSearchResult(true, arrayOf(), null)
+      } catch (e : Exception){
+        return@async PTSearchResult(false, null, handleExceptions(e).toDouble())
+      }
+    }
+  }
+
   @RequiresPermission(allOf = [Manifest.permission.ACCESS_FINE_LOCATION, Manifest.permission.BLUETOOTH_ADMIN, Manifest.permission.BLUETOOTH])
   override fun createESPDevice(
     deviceName: String,
@@ -167,7 +283,7 @@ class EspProvToolkit : HybridEspProvToolkitSpec() {
   }
 
   override fun doesESPDeviceExist(deviceName: String): Boolean {
-    return devices.containsKey(deviceName)
+    return devices.contains(deviceName)
   }
 
   override fun scanWifiListOfESPDevice(deviceName: String): Promise<PTWifiScanResult> {
@@ -194,16 +310,24 @@ class EspProvToolkit : HybridEspProvToolkitSpec() {
      try {
        val device = getDevice(deviceName)
        // first connect, check, then init session
-       val connStatus = Wrappers.connectEspDevice(device)
+       val connStatus = Wrappers.connectEspDevice(deviceName, device)
        if(connStatus == PTSessionStatus.DISCONNECTED){
          return@async PTSessionResult(true,PTSessionStatus.DISCONNECTED,null)
        }
        // now init session
-       val sessionStatus = Wrappers.initSessionEspDevice(device)
+       val sessionStatus = try {
+         Wrappers.initSessionEspDevice(device)
+       } catch (e : Exception){
+         NativeConnectionStates.post(deviceName, 0, NativeConnectionStates.SESSION_FAILED,
+           PTExtendedError.SESSION_NOT_ESTABLISHED.toInt())
+         throw e
+       }
        if(sessionStatus == PTSessionStatus.DISCONNECTED){
+         NativeConnectionStates.post(deviceName, 0, NativeConnectionStates.SESSION_FAILED, -1)
          return@async PTSessionResult(true, PTSessionStatus.DISCONNECTED,null)
        }
        // everything OK if we reached here
+       NativeConnectionStates.post(deviceName, 0, NativeConnectionStates.SESSION_ESTABLISHED, -1)
        return@async PTSessionResult(true,PTSessionStatus.CONNECTED,null)
      } catch (e : Exception){
        return@async PTSessionResult(false,null, handleExceptions(e).toDouble())
@@ -214,7 +338,10 @@ class EspProvToolkit : HybridEspProvToolkitSpec() {
   override fun disconnectFromESPDevice(deviceName: String): PTResult {
     try {
         val device = getDevice(deviceName)
+        rawLinks.remove(deviceName)
+        SdkConnectionEvents.forget(deviceName)
         device.disconnectDevice()
+        NativeConnectionStates.post(deviceName, 0, NativeConnectionStates.DISCONNECT_REQUESTED, -1)
         return PTResult(true,null)
     } catch(e : Exception){
       return PTResult(false, handleExceptions(e).toDouble())
@@ -222,6 +349,19 @@ class EspProvToolkit : HybridEspProvToolkitSpec() {
   }
 
 
+  override fun releaseESPDevice(deviceName: String): Boolean {
+    return devices.remove(deviceName)
+  }
+
+  override fun purgeESPDevices() {
+    devices.clear()
+  }
+
+  override fun setDeviceRegistryLimits(maxDevices: Double, idleTimeoutMs: Double) {
+    // Same bounds as the engine. The conversions saturate, and NaN becomes 0
+    devices.setLimits(maxDevices.toInt().coerceIn(1, 4096), idleTimeoutMs.toLong().coerceIn(0L, 30L * 24 * 3600 * 1000))
+  }
+
   override fun provisionESPDevice(
     deviceName: String,
     ssid: String,
@@ -256,34 +396,66 @@ class EspProvToolkit : HybridEspProvToolkitSpec() {
   ): Promise<PTStringResult> {
     return Promise.async {
       try {
-        var byteData : ByteArray? = null
-
-        // Safely decode the Base64 data
-        try {
-          byteData = Base64.decode(data, Base64.DEFAULT)
-        } catch (e : Exception){
-          return@async PTStringResult(false,null,
+        // Decoding validates too, null means it is not base64
+        val byteData = NativeBase64.decode(data)
+          ?: return@async PTStringResult(false,null,
             PTExtendedError.RUNTIME_BAD_BASE64_DATA.toDouble())
-        }
         // actually send it
         val device = getDevice(deviceName)
+        // no response has nothing to encode, reported as before
         val resp = Wrappers.sendDataToEspDevice(device,path,byteData)
-        // now try to encode the binary data to base64
-        var respBase64 : String? = null
-        try {
-          respBase64 = Base64.encodeToString(resp, Base64.DEFAULT)
-        } catch (e : Exception){
-          return@async PTStringResult(false,null,
+          ?: return@async PTStringResult(false,null,
             PTExtendedError.RUNTIME_BAD_BASE64_DATA.toDouble())
-        }
         // return the base64
-        return@async PTStringResult(true,respBase64,null)
+        return@async PTStringResult(true,NativeBase64.encode(resp),null)
       } catch (e : Exception){
         return@async PTStringResult(false,null, handleExceptions(e).toDouble())
       }
     }
   }
 
+  override fun sendBinaryDataToESPDevice(
+    deviceName: String,
+    path: String,
+    data: ArrayBuffer
+  ): Promise<PTDataResult> {
+    val byteData = ConversionHelpers.bytesOf(data)
+    return Promise.async {
+      try {
+        val device = getDevice(deviceName)
+        val resp = Wrappers.sendDataToEspDevice(device,path,byteData)
+        return@async PTDataResult(true, ConversionHelpers.arrayBufferOf(resp), null)
+      } catch (e : Exception){
+        return@async PTDataResult(false,null, handleExceptions(e).toDouble())
+      }
+    }
+  }
+
+  override fun sendRawDataToESPDevice(
+    deviceName: String,
+    path: String,
+    data: ArrayBuffer
+  ): Promise<PTDataResult> {
+    val byteData = ConversionHelpers.bytesOf(data)
+    return Promise.async {
+      try {
+        val device = getDevice(deviceName)
+        // The engine runs its own session, we only open the BLE link for it
+        if(device.transportType == ESPConstants.TransportType.TRANSPORT_BLE && !rawLinks.contains(deviceName)){
+          if(Wrappers.connectEspDevice(deviceName, device) != PTSessionStatus.CONNECTED){
+            return@async PTDataResult(false,null,
+              PTExtendedError.BLE_FAILED_TO_CONNECT.toDouble())
+          }
+          rawLinks.add(deviceName)
+        }
+        val resp = Wrappers.sendRawDataToEspDevice(device,path,byteData)
+        return@async PTDataResult(true, ConversionHelpers.arrayBufferOf(resp), null)
+      } catch (e : Exception){
+        return@async PTDataResult(false,null, handleExceptions(e).toDouble())
+      }
+    }
+  }
+
   override fun getIPv4AddressOfESPDevice(deviceName: String): PTStringResult { // candidate for removal
     return PTStringResult(false,null,0.0)
   }
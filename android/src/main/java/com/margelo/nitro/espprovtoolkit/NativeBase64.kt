@@ -0,0 +1,20 @@
+package com.margelo.nitro.espprovtoolkit
+
+/**
+ * The base64 codec of the shared C++ engine (cpp/core/Base64.cpp), with SSSE3 and NEON kernels.
+ * It validates while it decodes, so bad input costs no extra pass over the string.
+ */
+object NativeBase64 {
+  init {
+    // Already loaded by EspProvToolkitPackage in the app, a no-op then
+    System.loadLibrary("espprovtoolkit")
+  }
+
+  // The decoded bytes, or null if the string is not base64. Line breaks are skipped and padding is optional.
+  @JvmStatic
+  external fun decode(base64: String): ByteArray?
+
+  // Standard alphabet with padding, without line breaks
+  @JvmStatic
+  external fun encode(bytes: ByteArray): String
+}
@@ -0,0 +1,131 @@
+package com.margelo.nitro.espprovtoolkit
+
+import android.annotation.SuppressLint
+import android.bluetooth.BluetoothManager
+import android.bluetooth.BluetoothProfile
+import android.content.Context
+import com.espressif.provisioning.DeviceConnectionEvent
+import com.espressif.provisioning.ESPConstants
+import com.espressif.provisioning.ESPDevice
+import org.greenrobot.eventbus.EventBus
+import org.greenrobot.eventbus.Subscribe
+import org.greenrobot.eventbus.ThreadMode
+
+/**
+ * The per-device connection state machines of the shared C++ engine (cpp/core/ConnectionStateMachine.cpp).
+ * The SDK's link events and session outcomes are posted here, and connects wait on the state
+ * instead of on the event, so an event that fires before anyone waits is not lost.
+ */
+object NativeConnectionStates {
+  // Values of PTConnectionState
+  const val IDLE = 0
+  const val CONNECTING = 1
+  const val SECURING = 2
+  const val SECURED = 3
+  const val LOST = 4
+
+  // Values of PTConnectionEvent
+  const val LINK_UP = 1
+  const val LINK_FAILED = 2
+  const val LINK_DOWN = 3
+  const val SESSION_ESTABLISHED = 4
+  const val SESSION_FAILED = 5
+  const val DISCONNECT_REQUESTED = 6
+
+  init {
+    // Already loaded by EspProvToolkitPackage in the app, a no-op then
+    System.loadLibrary("espprovtoolkit")
+  }
+
+  // Starts a connect attempt, or joins the running one, and returns its number
+  @JvmStatic
+  external fun beginConnect(deviceName: String): Long
+
+  // Pass 0 as attempt for whichever attempt is current, -1 as error when there is none
+  @JvmStatic
+  external fun post(deviceName: String, attempt: Long, event: Int, error: Int): Boolean
+
+  // Blocks until the device leaves state, the attempt is superseded or timeoutMs passes
+  @JvmStatic
+  external fun awaitLeaving(deviceName: String, state: Int, attempt: Long, timeoutMs: Long): Int
+
+  @JvmStatic
+  external fun state(deviceName: String): Int
+
+  @JvmStatic
+  external fun release(deviceName: String)
+}
+
+/**
+ * The one EventBus subscriber for the SDK's connection events. The events don't name their
+ * device, so a connect outcome goes to the link being opened, which Wrappers keeps to one at a
+ * time, and a drop goes to the linked device whose link is actually gone. A drop that no tracked
+ * link accounts for is ignored rather than tearing down some other device's session.
+ */
+object SdkConnectionEvents {
+  private class Link(val deviceName: String, val attempt: Long, val espDevice: ESPDevice, val failureCode: Int)
+
+  // The link connectToDevice is opening, until its outcome arrives
+  private var opening : Link? = null
+  // The links that came up, by device name
+  private val linked = mutableMapOf<String, Link>()
+
+  // Call before connectToDevice, so no event of the new link can be missed
+  fun track(deviceName: String, attempt: Long, espDevice: ESPDevice) {
+    val failure = if (espDevice.transportType == ESPConstants.TransportType.TRANSPORT_BLE) PTExtendedError.BLE_FAILED_TO_CONNECT
+      else PTExtendedError.SOFTAP_CONNECTION_FAILURE
+    synchronized(this) {
+      linked.remove(deviceName)
+      opening = Link(deviceName, attempt, espDevice, failure.toInt())
+      if (!EventBus.getDefault().isRegistered(this)) {
+        EventBus.getDefault().register(this)
+      }
+    }
+  }
+
+  // Call before closing a device's link on purpose, so its drop is not reported as a loss
+  fun forget(deviceName: String) {
+    synchronized(this) {
+      linked.remove(deviceName)
+      if (opening?.deviceName == deviceName) {
+        opening = null
+      }
+    }
+  }
+
+  @Subscribe(threadMode = ThreadMode.ASYNC)
+  fun onEvent(event: DeviceConnectionEvent) {
+    when (event.eventType) {
+      ESPConstants.EVENT_DEVICE_CONNECTED -> {
+        val link = synchronized(this) { takeOpening()?.also { linked[it.deviceName] = it } } ?: return
+        NativeConnectionStates.post(link.deviceName, link.attempt, NativeConnectionStates.LINK_UP, -1)
+      }
+      ESPConstants.EVENT_DEVICE_DISCONNECTED ->
+        for (link in takeLost()) {
+          NativeConnectionStates.post(link.deviceName, link.attempt, NativeConnectionStates.LINK_DOWN, link.failureCode)
+        }
+      else -> {
+        val link = synchronized(this) { takeOpening() } ?: return
+        NativeConnectionStates.post(link.deviceName, link.attempt, NativeConnectionStates.LINK_FAILED, link.failureCode)
+      }
+    }
+  }
+
+  private fun takeOpening(): Link? = opening.also { opening = null }
+
+  // The links a drop belongs to: BLE links whose GATT connection is gone, else the SoftAP link,
+  // as the phone joins one access point at a time, else the link being opened
+  private fun takeLost(): List<Link> = synchronized(this) {
+    val (ble, softAp) = linked.values.partition { it.espDevice.transportType == ESPConstants.TransportType.TRANSPORT_BLE }
+    val lost = ble.filter { !isGattConnected(it.espDevice) }.ifEmpty { softAp }.ifEmpty { listOfNotNull(takeOpening()) }
+    lost.forEach { linked.remove(it.deviceName) }
+    lost
+  }
+
+  @SuppressLint("MissingPermission")
+  private fun isGattConnected(espDevice: ESPDevice): Boolean {
+    val bluetoothDevice = espDevice.bluetoothDevice ?: return false
+    val manager = Wrappers.getContext()?.getSystemService(Context.BLUETOOTH_SERVICE) as? BluetoothManager ?: return true
+    return manager.getConnectionState(bluetoothDevice, BluetoothProfile.GATT) == BluetoothProfile.STATE_CONNECTED
+  }
+}
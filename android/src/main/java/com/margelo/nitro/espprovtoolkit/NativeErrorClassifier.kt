@@ -0,0 +1,21 @@
+package com.margelo.nitro.espprovtoolkit
+
+/**
+ * The error classifier of the shared C++ engine (cpp/core/ErrorClassifier.cpp).
+ * It holds the one table of known SDK error messages for Android and iOS and matches all of
+ * them in a single pass over the message.
+ */
+object NativeErrorClassifier {
+  init {
+    // Already loaded by EspProvToolkitPackage in the app, a no-op then
+    System.loadLibrary("espprovtoolkit")
+  }
+
+  // Returns the PTError code, or -1 if nothing matched. Pass -1 as sdkCode when there is none.
+  @JvmStatic
+  external fun classify(message: String?, sdkCode: Int): Int
+
+  // The known messages of an error code, canonical description first
+  @JvmStatic
+  external fun descriptions(code: Int): Array<String>
+}
@@ -0,0 +1,61 @@
+package com.margelo.nitro.espprovtoolkit
+
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.withContext
+
+/**
+ * The trace buffer of the shared C++ engine (cpp/core/Tracer.cpp), which JS starts and exports.
+ * Main thread work is recorded twice: how long it waited for the main looper, and how long it ran
+ * there, so a busy main thread shows next to the engine's transport and device waits.
+ */
+object NativeTrace {
+  // Value of TraceCategory
+  const val DISPATCH = 1
+
+  init {
+    // Already loaded by EspProvToolkitPackage in the app, a no-op then
+    System.loadLibrary("espprovtoolkit")
+  }
+
+  @JvmStatic
+  external fun enabled(): Boolean
+
+  // The engine's steady clock in nanoseconds
+  @JvmStatic
+  external fun now(): Long
+
+  @JvmStatic
+  external fun complete(category: Int, name: String, detail: String, startNanos: Long, endNanos: Long, threadName: String)
+
+  // withContext(Dispatchers.Main), traced while tracing runs
+  suspend fun <T> onMain(name: String, detail: String, block: suspend CoroutineScope.() -> T): T {
+    if (!enabled()) {
+      return withContext(Dispatchers.Main, block)
+    }
+    val queued = now()
+    return withContext(Dispatchers.Main) { traced(name, detail, queued) { block() } }
+  }
+
+  // CoroutineScope(Dispatchers.Main).launch, traced while tracing runs
+  fun launchOnMain(name: String, detail: String, block: suspend CoroutineScope.() -> Unit): Job {
+    if (!enabled()) {
+      return CoroutineScope(Dispatchers.Main).launch(block = block)
+    }
+    val queued = now()
+    return CoroutineScope(Dispatchers.Main).launch { traced(name, detail, queued) { block() } }
+  }
+
+  private inline fun <T> traced(name: String, detail: String, queued: Long, block: () -> T): T {
+    val thread = Thread.currentThread().name
+    val started = now()
+    complete(DISPATCH, "$name queued", detail, queued, started, thread)
+    try {
+      return block()
+    } finally {
+      complete(DISPATCH, name, detail, started, now(), thread)
+    }
+  }
+}
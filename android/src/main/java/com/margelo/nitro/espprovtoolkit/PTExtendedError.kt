@@ -50,42 +50,15 @@ enum class PTExtendedError(val code: Int) {
   // General Errors
   ESP_NATIVE_UNKNOWN_ERROR (4),
   ESP_INSUFFICIENT_PERMISSIONS(47),
-  BLE_ADAPTER_NOT_AVAILABLE(48);
+  BLE_ADAPTER_NOT_AVAILABLE(48),
+  OPERATION_CANCELLED(49);
   // Convert to numeric types
   fun toInt(): Int = code
   fun toDouble(): Double = code.toDouble()
   companion object {
-    // Mapping of error codes to their possible descriptions
-    private val descriptionMap = mapOf(
-      1 to listOf("Empty config data during WiFi scan", "Config data is empty"), // WIFI_SCAN_EMPTY_CONFIG_DATA
-      3 to listOf("Failed to send Wi-Fi scan command.",
-        "Failed to get Wi-Fi Networks.", "Failed to get Wi-Fi status."), //  WIFI_SCAN_REQUEST_ERROR
-      11 to listOf("Failed to create session."), // SESSION_INIT_ERROR
-      12 to listOf("Session could not be established", "Session establishment failed !"), // SESSION_NOT_ESTABLISHED
-      13 to listOf("Failed to send wifi credentials to device","No response from device"), // SESSION_SEND_DATA_ERROR
-      14 to listOf("Error ! Connection Lost"), // SOFTAP_CONNECTION_FAILURE
-      15 to listOf("Security version mismatch"),  // SESSION_SECURITY_MISMATCH
-      17 to listOf("Characteristic is not available for given path.",
-        "Read from BLE failed", "Write to BLE failed"), // BLE_FAILED_TO_CONNECT
-      18 to listOf("The public client value 'A' must not be null",
-        "The client evidence message 'M1' must not be null",
-        "The client public value 'A' must not be null",
-        "State violation",
-        "The SRP-6a crypto parameters must not be null", "Unsupported hash algorithm",
-        "The salt 's' must not be null", "The verifier 'v' must not be null", "The timeout must be zero",
-        "The attribute key must not be null",
-        "The public server value 'B' must not be null", "Bad client public value",
-        "Session timeout", "Bad server public value", "The server evidence message",
-        "Bad server credentials", "Undefined hash algorithm", "The prime parameter",
-        "The generator parameter", "The cause type must not be null"),  // ENCRYPTION_ERROR
-      19 to listOf("The user password 'P' must not be null"), // NO_POP
-      20 to listOf("The user identity 'I' must not be null or empty"), // NO_USERNAME
-      32 to listOf("Failed to apply wifi credentials"), // PROV_CONFIGURATION_ERROR
-      37 to listOf("Provisioning Failed"), // PROV_WIFI_STATUS_UNKNOWN_ERROR
-      46 to listOf("BLE scanning failed with error code"), // BLE_SEARCH_ERROR
-      48 to listOf("Please turn on bluetooth and try again.") // BLE_ADAPTER_NOT_AVAILABLE
-    )
-     // Find by int code
+    // The descriptions live in the shared native table, see NativeErrorClassifier
+
+    // Find by int code
     fun fromCode(code: Int): PTExtendedError? =
       entries.find { it.code == code }
 
@@ -95,26 +68,18 @@ enum class PTExtendedError(val code: Int) {
 
     // Get descriptions for an error code
     fun getDescriptions(code: Int): List<String> =
-      descriptionMap[code] ?: listOf("Unknown error")
+      NativeErrorClassifier.descriptions(code).toList().ifEmpty { listOf("Unknown error") }
 
     // Get descriptions for an error enum
     fun getDescriptions(error: PTExtendedError): List<String> =
       getDescriptions(error.code)
 
-    // Find error code from partial description
+    // Find error code from partial description. Unlike on iOS, the Android SDK fails with plain
+    // exceptions that carry no code, and the failures it does report as values, like
+    // ProvisionFailureReason, are already turned into a PTException where they arrive.
     private fun findErrorCodeByDescription(partialDesc: String): Int? {
-
-      val lowerPartial = partialDesc.lowercase()
-
-      for ((code, descriptions) in descriptionMap) {
-        for (desc in descriptions) {
-          if (lowerPartial.contains(desc.lowercase())) {
-            return code
-          }
-        }
-      }
-
-      return null
+      val code = NativeErrorClassifier.classify(partialDesc, -1)
+      return if (code >= 0) code else null
     }
 
     // Find error enum from partial description
@@ -130,7 +95,7 @@ enum class PTExtendedError(val code: Int) {
 
   }
   fun getDescription(): String {
-    return descriptionMap[this.code]?.get(0) ?: "Unknown error"
+    return NativeErrorClassifier.descriptions(this.code).firstOrNull() ?: "Unknown error"
   }
 }
 
@@ -13,6 +13,8 @@ import com.espressif.provisioning.ESPProvisionManager
 import com.espressif.provisioning.listeners.BleScanListener
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
 import kotlinx.coroutines.withContext
 import java.util.concurrent.atomic.AtomicBoolean
 import android.os.Handler
@@ -20,19 +22,14 @@ import android.os.Looper
 import com.espressif.provisioning.ESPConstants
 import com.espressif.provisioning.WiFiAccessPoint
 import com.espressif.provisioning.listeners.WiFiScanListener
-import kotlinx.coroutines.CoroutineScope
-import kotlinx.coroutines.launch
 import java.util.ArrayList
 import kotlin.coroutines.suspendCoroutine
 import kotlinx.coroutines.suspendCancellableCoroutine
 import kotlin.coroutines.resume
 import kotlin.coroutines.resumeWithException
-import org.greenrobot.eventbus.EventBus
-import org.greenrobot.eventbus.Subscribe
-import org.greenrobot.eventbus.ThreadMode
-import com.espressif.provisioning.DeviceConnectionEvent
 import com.espressif.provisioning.listeners.ProvisionListener
 import com.espressif.provisioning.listeners.ResponseListener
+import com.espressif.provisioning.transport.Transport
 import com.facebook.react.bridge.ReactApplicationContext
 
 class Wrappers {
@@ -54,10 +51,6 @@ class Wrappers {
       var serviceUuid: String? = null
     }
 
-    interface EventListener{
-       fun onEvent(event : DeviceConnectionEvent)
-    }
-
     @RequiresPermission(allOf = [Manifest.permission.ACCESS_FINE_LOCATION, Manifest.permission.BLUETOOTH_ADMIN, Manifest.permission.BLUETOOTH])
     suspend fun searchBle(devicePrefix : String?): List<EspBleMetadata>{
 
@@ -110,7 +103,7 @@ class Wrappers {
         }
       }
       // Must switch to Main thread for BLE operations
-      withContext(Dispatchers.Main) {
+      NativeTrace.onMain("searchBleEspDevices", devicePrefix ?: "") {
         ESPProvisionManager.getInstance(getContext()?.applicationContext).searchBleEspDevices(bleListener)
       }
 
@@ -127,7 +120,7 @@ class Wrappers {
       } finally {
         // If somehow we did not stop the scan via callback, make sure we do.
         if(!scanCompleted.getAndSet(true)){
-          withContext(Dispatchers.Main) {
+          NativeTrace.onMain("stopBleScan", devicePrefix ?: "") {
             ESPProvisionManager.getInstance(getContext()?.applicationContext)
               .stopBleScan()
           }
@@ -137,6 +130,68 @@ class Wrappers {
       return devices.distinctBy { it.deviceName to it.serviceUuid }
     }
 
+    /**
+     * Starts a BLE scan that hands out every matching device the first time it is seen, instead of
+     * collecting them until the scan window closes. The channel is closed when the scan ends.
+     *
+     * The channel is bounded: while it is full, new devices are not marked as seen and are offered
+     * again on their next advertisement, so a slow consumer never makes the scan buffer grow.
+     * Pass the `seen` set of an earlier scan to only hand out devices that one did not.
+     */
+    @RequiresPermission(allOf = [Manifest.permission.ACCESS_FINE_LOCATION, Manifest.permission.BLUETOOTH_ADMIN, Manifest.permission.BLUETOOTH])
+    fun startBleDiscovery(
+      devicePrefix: String?,
+      seen: MutableSet<Pair<String, String>> = java.util.Collections.synchronizedSet(mutableSetOf())
+    ): Channel<EspBleMetadata> {
+      val context = getContext() ?: throw IllegalStateException("Android State cannot be null.")
+      val deviceChannel = Channel<EspBleMetadata>(Constants.DISCOVERY_BUFFER_SIZE)
+
+      val bleListener = object : BleScanListener {
+        override fun scanStartFailed() {
+          Log.e(TAG,"BLE discovery failed to start.")
+          deviceChannel.close(Exception("BLE search failed to start."))
+        }
+
+        @RequiresPermission(Manifest.permission.BLUETOOTH_CONNECT)
+        override fun onPeripheralFound(device: BluetoothDevice?, scanResult: ScanResult?) {
+          val deviceName = scanResult?.scanRecord?.deviceName ?: return
+          // BLE device, service uuid should be valid.
+          val serviceUuid = scanResult.scanRecord?.serviceUuids?.getOrNull(0)?.toString() ?: return
+          if (device == null || !deviceName.startsWith(devicePrefix ?: "")) {
+            return
+          }
+          val key = deviceName to serviceUuid
+          if (seen.contains(key)) {
+            return
+          }
+          val espMetadata = EspBleMetadata()
+          espMetadata.deviceName = deviceName
+          espMetadata.bleDevice = device
+          espMetadata.serviceUuid = serviceUuid
+          if (deviceChannel.trySend(espMetadata).isSuccess) {
+            seen.add(key)
+          }
+        }
+
+        override fun scanCompleted() {
+          deviceChannel.close()
+        }
+
+        override fun onFailure(e: java.lang.Exception?) {
+          deviceChannel.close(e)
+        }
+      }
+      // Must switch to Main thread for BLE operations
+      Handler(Looper.getMainLooper()).post {
+        try {
+          ESPProvisionManager.getInstance(context.applicationContext).searchBleEspDevices(bleListener)
+        } catch (e: Exception) {
+          deviceChannel.close(e)
+        }
+      }
+      return deviceChannel
+    }
+
     @RequiresPermission(allOf = [Manifest.permission.ACCESS_FINE_LOCATION, Manifest.permission.BLUETOOTH_ADMIN, Manifest.permission.BLUETOOTH])
     fun stopBleSearch() {
       // Run on Main thread using handler instead of coroutine context
@@ -183,7 +238,7 @@ class Wrappers {
       }
 
       // Launch on Main dispatcher since ESP operations require the main thread
-      CoroutineScope(Dispatchers.Main).launch {
+      NativeTrace.launchOnMain("searchWiFiEspDevices", devicePrefix ?: "") {
         try {
           ESPProvisionManager.getInstance(context.applicationContext).searchWiFiEspDevices(softapListener)
         } catch (e: Exception) {
@@ -202,7 +257,7 @@ class Wrappers {
       proofOfPossession: String?,
       softApPassword: String?,
       username: String?
-    ): ESPDevice = withContext(Dispatchers.Main) {
+    ): ESPDevice = NativeTrace.onMain("createESPDevice", deviceName) {
       // Create the device on the main thread
       val device = ESPProvisionManager.getInstance(getContext()?.applicationContext).createESPDevice(transport, security)
 
@@ -214,7 +269,7 @@ class Wrappers {
       device.wifiDevice.password = softApPassword
       device.userName = username
 
-      return@withContext device
+      return@onMain device
     }
 
     @SuppressLint("MissingPermission")
@@ -270,7 +325,7 @@ class Wrappers {
       }
 
       // Launch on Main dispatcher since ESP operations require the main thread
-      CoroutineScope(Dispatchers.Main).launch {
+      NativeTrace.launchOnMain("scanNetworks", device.deviceName ?: "") {
         try {
           device.scanNetworks(softapListener)
         } catch (e: Exception) {
@@ -282,46 +337,38 @@ class Wrappers {
       }
     }
 
-    @SuppressLint("MissingPermission")
-    suspend fun connectEspDevice(espDevice: ESPDevice): PTSessionStatus
-    = suspendCancellableCoroutine  { continuation ->
+    // Upper bound of a link wait, the state machine's own CONNECTING timeout normally ends it first
+    private const val LINK_WAIT_MS = 60_000L
 
-      // Callback Object set up
-      val connListener = object : EventListener {
-        @Subscribe(threadMode = ThreadMode.ASYNC)
-        override fun onEvent(event: DeviceConnectionEvent) {
-          // Make sure cont is still active and not resumed earlier
-          if(continuation.isActive){
-            // clean up the event registry
-            EventBus.getDefault().unregister(this)
-            // dispatch and return
-            when(event.eventType){
-              ESPConstants.EVENT_DEVICE_CONNECTED-> continuation.resume(PTSessionStatus.CONNECTED)
-              ESPConstants.EVENT_DEVICE_DISCONNECTED -> continuation.resume(PTSessionStatus.DISCONNECTED)
-              else ->  continuation.resume(PTSessionStatus.CHECK_MANUALLY)
-            }
-          }
-        }
-      }
+    // The SDK's link events do not name their device, so one link comes up at a time. The
+    // engine's scheduler lets the linked devices exchange concurrently afterwards
+    private val linkMutex = Mutex()
 
-      // Using suspendCancellableCoroutine to handle cancellation
-      continuation.invokeOnCancellation {
-        // unregister the event callback obj
-        EventBus.getDefault().unregister(connListener)
-      }
+    @SuppressLint("MissingPermission")
+    suspend fun connectEspDevice(deviceName: String, espDevice: ESPDevice): PTSessionStatus = linkMutex.withLock {
+      // Joins the engine's attempt when it opened this link for its raw transport
+      val attempt = NativeConnectionStates.beginConnect(deviceName)
+      SdkConnectionEvents.track(deviceName, attempt, espDevice)
 
-      // Launch on Main dispatcher since ESP operations require the main thread
-      CoroutineScope(Dispatchers.Main).launch {
+      // ESP operations require the main thread
+      NativeTrace.onMain("connectToDevice", deviceName) {
         try {
           espDevice.connectToDevice()
-          EventBus.getDefault().register(connListener)
         } catch (e: Exception) {
-          // Handle any exceptions during the start of scanning
-          if (continuation.isActive) {
-            continuation.resumeWithException(e)
-          }
+          NativeConnectionStates.post(deviceName, attempt, NativeConnectionStates.LINK_FAILED, -1)
+          throw e
         }
       }
+
+      // The link event may already have arrived, the state keeps it
+      val state = withContext(Dispatchers.IO) {
+        NativeConnectionStates.awaitLeaving(deviceName, NativeConnectionStates.CONNECTING, attempt, LINK_WAIT_MS)
+      }
+      when (state) {
+        NativeConnectionStates.SECURING, NativeConnectionStates.SECURED -> PTSessionStatus.CONNECTED
+        NativeConnectionStates.CONNECTING -> PTSessionStatus.CHECK_MANUALLY
+        else -> PTSessionStatus.DISCONNECTED
+      }
     }
 
     suspend fun initSessionEspDevice(espDevice: ESPDevice): PTSessionStatus
@@ -345,7 +392,7 @@ class Wrappers {
         }
 
       // Launch on Main dispatcher since ESP operations require the main thread
-      CoroutineScope(Dispatchers.Main).launch {
+      NativeTrace.launchOnMain("initSession", espDevice.deviceName ?: "") {
         try {
           espDevice.initSession(respListener)
         } catch (e: Exception) {
@@ -435,7 +482,7 @@ class Wrappers {
         }
 
       // Launch on Main dispatcher since ESP operations require the main thread
-      CoroutineScope(Dispatchers.Main).launch {
+      NativeTrace.launchOnMain("provision", espDevice.deviceName ?: "") {
         try {
           espDevice.provision(ssid,password,provListener)
         } catch (e: Exception) {
@@ -447,6 +494,53 @@ class Wrappers {
       }
     }
 
+    // The SDK keeps the transport private, but the native engine needs to talk to it directly.
+    // consumer-rules.pro keeps the field's name through the app's minification
+    private fun rawTransportOf(espDevice: ESPDevice): Transport {
+      val transport = try {
+        val field = ESPDevice::class.java.getDeclaredField("transport")
+        field.isAccessible = true
+        field.get(espDevice)
+      } catch (e: ReflectiveOperationException) {
+        Log.e(TAG, "The SDK's ESPDevice.transport is not reachable.", e)
+        throw PTException(PTExtendedError.SESSION_INIT_ERROR)
+      } catch (e: SecurityException) {
+        Log.e(TAG, "The SDK's ESPDevice.transport is not reachable.", e)
+        throw PTException(PTExtendedError.SESSION_INIT_ERROR)
+      }
+      return transport as? Transport ?: throw PTException(PTExtendedError.SESSION_INIT_ERROR)
+    }
+
+    // Sends bytes to an endpoint as they are, bypassing the SDK session and its encryption
+    suspend fun sendRawDataToEspDevice(espDevice: ESPDevice, path : String, data : ByteArray): ByteArray?
+      = suspendCancellableCoroutine  { continuation ->
+
+      val respListener = object : ResponseListener{
+        override fun onSuccess(returnData: ByteArray?) {
+          if(continuation.isActive){
+            continuation.resume(returnData)
+          }
+        }
+
+        override fun onFailure(e: java.lang.Exception?) {
+          if(continuation.isActive){
+            continuation.resumeWithException(e ?: PTException(PTExtendedError.SESSION_SEND_DATA_ERROR))
+          }
+        }
+      }
+
+      // Launch on Main dispatcher since ESP operations require the main thread
+      NativeTrace.launchOnMain("sendConfigData", path) {
+        try {
+          rawTransportOf(espDevice).sendConfigData(path, data, respListener)
+        } catch (e: Exception) {
+          if (continuation.isActive) {
+            continuation.resumeWithException(e)
+          }
+        }
+      }
+    }
+
     suspend fun sendDataToEspDevice(espDevice: ESPDevice, path : String, data : ByteArray): ByteArray?
       = suspendCancellableCoroutine  { continuation ->
 
@@ -454,7 +548,7 @@ class Wrappers {
       val respListener = object : ResponseListener{
         override fun onSuccess(returnData: ByteArray?) {
           if(continuation.isActive){
-            continuation.resume(data)
+            continuation.resume(returnData)
           }
         }
 
@@ -467,7 +561,7 @@ class Wrappers {
       }
 
       // Launch on Main dispatcher since ESP operations require the main thread
-      CoroutineScope(Dispatchers.Main).launch {
+      NativeTrace.launchOnMain("sendDataToCustomEndPoint", path) {
         try {
           espDevice.sendDataToCustomEndPoint(path,data,respListener)
         } catch (e: Exception) {
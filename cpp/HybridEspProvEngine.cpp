@@ -0,0 +1,854 @@
+///
+/// HybridEspProvEngine.cpp
+/// The C++ HybridObject exposing the shared protocomm engine to JS.
+///
+
+#include "HybridEspProvEngine.hpp"
+#include "PlatformTransport.hpp"
+#include "core/Base64.hpp"
+#include "core/Cancellation.hpp"
+#include "core/ConnectionStateMachine.hpp"
+#include "core/Errors.hpp"
+#include "core/HttpTransport.hpp"
+#include "core/Metrics.hpp"
+#include "core/Task.hpp"
+#include "core/Tracer.hpp"
+#include "core/WifiScanColumns.hpp"
+#include <NitroModules/HybridObjectRegistry.hpp>
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace margelo::nitro::espprovtoolkit {
+
+  namespace {
+    /**
+     * Maps the exception currently being handled to a `PTError` value. Must be called from a catch block.
+     */
+    double currentErrorCode() noexcept {
+      try {
+        throw;
+      } catch (const espprov::ProtocommError& e) {
+        return static_cast<double>(e.code());
+      } catch (...) {
+        return static_cast<double>(espprov::ErrorCode::ESP_NATIVE_UNKNOWN_ERROR);
+      }
+    }
+
+    constexpr size_t DEFAULT_BATCH_CONCURRENCY = 3;
+    constexpr size_t MAX_BATCH_CONCURRENCY = 16;
+    constexpr size_t MAX_REGISTRY_DEVICES = 4096;
+    constexpr size_t MAX_SESSION_SLOTS = 64;
+    /// The longest duration JS can set, so that deadlines computed from it stay within the clock's range.
+    constexpr std::chrono::milliseconds MAX_DURATION = std::chrono::hours(24 * 30);
+
+    std::vector<PTWifiEntry> toWifiEntries(std::vector<espprov::WifiNetwork>&& networks) {
+      std::vector<PTWifiEntry> entries;
+      entries.reserve(networks.size());
+      for (espprov::WifiNetwork& network : networks) {
+        entries.emplace_back(std::move(network.ssid), static_cast<double>(network.rssi), static_cast<double>(network.auth),
+                             std::move(network.bssid), static_cast<double>(network.channel));
+      }
+      return entries;
+    }
+
+    PTConnectionTransition toTransition(const espprov::ConnectionTransition& transition) {
+      auto epochMs = std::chrono::duration_cast<std::chrono::milliseconds>(transition.at.time_since_epoch());
+      std::optional<double> error;
+      if (transition.error.has_value()) {
+        error = static_cast<double>(*transition.error);
+      }
+      return PTConnectionTransition(transition.deviceName, static_cast<PTConnectionState>(transition.from),
+                                    static_cast<PTConnectionState>(transition.to), static_cast<PTConnectionEvent>(transition.event),
+                                    static_cast<double>(transition.attempt), error, static_cast<double>(epochMs.count()));
+    }
+
+    std::vector<PTPhaseSpan> toPhaseSpans(const std::vector<espprov::PhaseSpan>& spans) {
+      std::vector<PTPhaseSpan> result;
+      result.reserve(spans.size());
+      for (const espprov::PhaseSpan& span : spans) {
+        auto epochMs = std::chrono::duration<double, std::milli>(span.start.time_since_epoch());
+        auto durationMs = std::chrono::duration<double, std::milli>(span.duration);
+        std::optional<double> polls = span.polls > 0 ? std::optional<double>(span.polls) : std::nullopt;
+        result.emplace_back(static_cast<PTPhase>(span.phase), epochMs.count(), durationMs.count(), span.failed, polls);
+      }
+      return result;
+    }
+
+    std::vector<PTLatencySummary> toLatencySummaries(const std::vector<espprov::LatencySummary>& summaries) {
+      auto ms = [](uint64_t micros) { return static_cast<double>(micros) / 1000.0; };
+      std::vector<PTLatencySummary> result;
+      result.reserve(summaries.size());
+      for (const espprov::LatencySummary& summary : summaries) {
+        result.emplace_back(summary.name, static_cast<double>(summary.count), ms(summary.min), summary.mean / 1000.0, ms(summary.p50),
+                            ms(summary.p90), ms(summary.p95), ms(summary.p99), ms(summary.max));
+      }
+      return result;
+    }
+
+    /**
+     * `Promise<T>::async` traced as a bridge span on the worker from the JS call until the promise
+     * resolves, so time spent queued for a worker shows too. The call itself is marked on the JS thread.
+     */
+    template <typename T, typename Body>
+    std::shared_ptr<Promise<T>> tracedAsync(const char* method, const std::string& detail, Body&& body) {
+      espprov::Tracer& tracer = espprov::Tracer::shared();
+      if (!tracer.enabled()) {
+        return Promise<T>::async(std::forward<Body>(body));
+      }
+      if (!espprov::Tracer::isThreadNamed()) {
+        tracer.nameThread("JS");
+      }
+      tracer.instant(espprov::TraceCategory::BRIDGE, method, detail);
+      auto called = std::chrono::steady_clock::now();
+      return Promise<T>::async([method, detail, called, body = std::forward<Body>(body)]() mutable -> T {
+        T result = body();
+        espprov::Tracer::shared().complete(espprov::TraceCategory::BRIDGE, method, detail, called, std::chrono::steady_clock::now());
+        return result;
+      });
+    }
+
+    /**
+     * A call JS can cancel through `cancelESPOperation`, registered under the id JS gave it from the
+     * call until its promise settled. Calls without an id get a token that is never cancelled.
+     */
+    class Operation {
+    public:
+      /**
+       * Runs on the JS thread before the call is queued, so a cancel right after the call finds it.
+       */
+      static std::shared_ptr<const Operation> begin(const std::optional<double>& operationId) {
+        auto operation = std::make_shared<Operation>();
+        operation->_id = operationId.has_value() ? toKey(*operationId) : std::nullopt;
+        if (operation->_id.has_value()) {
+          Registry& registry = Operation::registry();
+          std::lock_guard lock(registry.mutex);
+          registry.running[*operation->_id] = operation;
+        }
+        return operation;
+      }
+
+      static bool cancel(double operationId) {
+        std::optional<int64_t> key = toKey(operationId);
+        if (!key.has_value()) {
+          return false;
+        }
+        std::shared_ptr<Operation> operation;
+        {
+          Registry& registry = Operation::registry();
+          std::lock_guard lock(registry.mutex);
+          auto it = registry.running.find(*key);
+          if (it != registry.running.end()) {
+            operation = it->second.lock();
+          }
+        }
+        // Aborting the transport happens outside the registry lock
+        return operation != nullptr && operation->_source.cancel();
+      }
+
+      ~Operation() {
+        if (_id.has_value()) {
+          Registry& registry = Operation::registry();
+          std::lock_guard lock(registry.mutex);
+          // A reused id may already belong to a newer call
+          auto it = registry.running.find(*_id);
+          if (it != registry.running.end() && it->second.expired()) {
+            registry.running.erase(it);
+          }
+        }
+      }
+
+      espprov::CancellationToken token() const {
+        return _id.has_value() ? _source.token() : espprov::CancellationToken();
+      }
+
+    private:
+      struct Registry {
+        std::mutex mutex;
+        std::unordered_map<int64_t, std::weak_ptr<Operation>> running;
+      };
+
+      static Registry& registry() {
+        static Registry registry;
+        return registry;
+      }
+
+      /**
+       * JS ids are safe integers. Anything else, NaN and Infinity included, can not name a call.
+       */
+      static std::optional<int64_t> toKey(double operationId) noexcept {
+        constexpr double MAX_SAFE_INTEGER = 9007199254740991.0;
+        if (!(std::fabs(operationId) <= MAX_SAFE_INTEGER)) {
+          return std::nullopt;
+        }
+        return static_cast<int64_t>(operationId);
+      }
+
+      std::optional<int64_t> _id;
+      espprov::CancellationSource _source;
+    };
+
+    /**
+     * Clamps a JS page bound to a result index. Negative and NaN values become 0.
+     */
+    uint32_t toResultIndex(double value) noexcept {
+      if (!(value > 0)) {
+        return 0;
+      }
+      return value >= static_cast<double>(UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(value);
+    }
+
+    /**
+     * Clamps a JS count to `[min, max]` before the cast, which is undefined for NaN and for values a
+     * `size_t` can not hold. NaN becomes `min`, Infinity `max`.
+     */
+    size_t toCount(double value, size_t min, size_t max) noexcept {
+      if (std::isnan(value) || value <= static_cast<double>(min)) {
+        return min;
+      }
+      if (!std::isfinite(value) || value >= static_cast<double>(max)) {
+        return max;
+      }
+      return static_cast<size_t>(value);
+    }
+
+    /**
+     * Clamps a JS duration in milliseconds to `[0, MAX_DURATION]` before the cast. NaN becomes 0, Infinity
+     * `MAX_DURATION`.
+     */
+    std::chrono::milliseconds toMillis(double value) noexcept {
+      if (std::isnan(value) || value <= 0) {
+        return std::chrono::milliseconds(0);
+      }
+      if (!std::isfinite(value) || value >= static_cast<double>(MAX_DURATION.count())) {
+        return MAX_DURATION;
+      }
+      return std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(value));
+    }
+
+    /**
+     * Turns a failed toolkit result into the `ProtocommError` carrying its `PTError`.
+     */
+    void throwIfFailed(bool success, const std::optional<double>& error, const std::string& what) {
+      if (!success) {
+        double code = error.value_or(static_cast<double>(espprov::ErrorCode::ESP_NATIVE_UNKNOWN_ERROR));
+        throw espprov::ProtocommError(static_cast<espprov::ErrorCode>(static_cast<int>(code)), what + " failed");
+      }
+    }
+
+    /**
+     * What a batch knows about one job's run. Creating the device is timed here until the engine knows it.
+     */
+    struct JobRun {
+      espprov::RunTimings createTimings;
+      bool configured = false;
+
+      std::vector<PTPhaseSpan> timings(espprov::ProtocommEngine& engine, const std::string& deviceName) {
+        try {
+          if (configured) {
+            return toPhaseSpans(engine.runTimings(deviceName));
+          }
+          // The engine's timings feed the metrics themselves
+          std::vector<espprov::PhaseSpan> spans = createTimings.spans();
+          for (const espprov::PhaseSpan& span : spans) {
+            espprov::MetricsRegistry::shared().recordPhase(span.phase, span.duration);
+          }
+          return toPhaseSpans(spans);
+        } catch (...) {
+          return std::vector<PTPhaseSpan>();
+        }
+      }
+    };
+
+    /**
+     * Creates the job's device on the platform, whose link the engine talks through. The toolkit answers
+     * through a promise, which the task waits for on its executor rather than on a thread of its own.
+     */
+    espprov::Task<void> createJobDevice(std::shared_ptr<HybridEspProvToolkitSpec> toolkit, PTProvisionJob job, std::shared_ptr<JobRun> run,
+                                        std::chrono::milliseconds timeout) {
+      espprov::PhaseTimer phase(&run->createTimings, espprov::Phase::CREATE);
+      PTResult created = co_await espprov::awaitCallback<PTResult>(
+          [&toolkit, &job](espprov::Completer<PTResult> done) {
+            std::shared_ptr<Promise<PTResult>> promise = toolkit->createESPDevice(job.deviceName, job.transport, job.security,
+                                                                                   job.proofOfPossession, job.softAPPassword, job.username);
+            promise->addOnResolvedListener([done](const PTResult& result) mutable { done.resolve(result); });
+            promise->addOnRejectedListener([done](const std::exception_ptr& error) mutable { done.reject(error); });
+          },
+          timeout, espprov::ErrorCode::ESP_DEVICE_NOT_FOUND, "Creating " + job.deviceName);
+      throwIfFailed(created.success, created.error, "Creating " + job.deviceName);
+    }
+
+    /**
+     * Connects, provisions and disconnects a created device with the engine. Blocks the calling thread.
+     */
+    PTDeviceProvisionResult provisionJob(espprov::ProtocommEngine& engine, const PTProvisionJob& job, JobRun& run,
+                                         const espprov::CancellationToken& cancel) {
+      espprov::TraceSpan trace(espprov::TraceCategory::BRIDGE, "provisionJob", job.deviceName);
+      try {
+        engine.configureDevice(espprov::DeviceConfig{
+            .name = job.deviceName,
+            .transport = static_cast<espprov::TransportKind>(job.transport),
+            .security = static_cast<espprov::SecurityScheme>(job.security),
+            .securityParams = {.proofOfPossession = job.proofOfPossession, .username = job.username},
+        });
+        run.configured = true;
+        for (const espprov::PhaseSpan& span : run.createTimings.spans()) {
+          engine.recordPhase(job.deviceName, span);
+        }
+        try {
+          engine.connect(job.deviceName, cancel);
+          engine.provision(job.deviceName, job.ssid, job.passphrase, cancel);
+        } catch (...) {
+          engine.disconnect(job.deviceName);
+          throw;
+        }
+        engine.disconnect(job.deviceName);
+        return PTDeviceProvisionResult(job.deviceName, true, std::nullopt, run.timings(engine, job.deviceName));
+      } catch (...) {
+        return PTDeviceProvisionResult(job.deviceName, false, currentErrorCode(), run.timings(engine, job.deviceName));
+      }
+    }
+
+    /**
+     * One `provisionESPDevices` call, at most `concurrency` jobs at a time: a finished job starts the next
+     * ones and the last one resolves the batch, so no thread sits waiting for the others. Each job creates
+     * its device as a task on the engine's executor, then runs the blocking engine calls on the worker pool
+     * behind `Promise::async` like every other engine call.
+     *
+     * SoftAP jobs run one at a time whatever the concurrency. Every SoftAP device answers on the same
+     * address, and the phone joins one device's access point at a time, so two of them at once
+     * would talk to whichever access point happens to be joined. BLE jobs fill the other slots.
+     *
+     * Cancelling the batch's operation or reaching its deadline stops it: running jobs are cancelled
+     * like any engine call and pending ones fail without starting, with `OPERATION_CANCELLED` or
+     * `PROV_TIMED_OUT_ERROR`. The batch still resolves with one result per job.
+     */
+    class Batch : public std::enable_shared_from_this<Batch> {
+    public:
+      using Results = std::vector<PTDeviceProvisionResult>;
+
+      static std::shared_ptr<Promise<Results>> run(std::shared_ptr<espprov::ProtocommEngine> engine,
+                                                   std::shared_ptr<HybridEspProvToolkitSpec> toolkit, espprov::Executor& executor,
+                                                   std::vector<PTProvisionJob> jobs, size_t concurrency,
+                                                   std::optional<std::chrono::milliseconds> timeout,
+                                                   std::shared_ptr<const Operation> operation) {
+        auto batch = std::shared_ptr<Batch>(new Batch(std::move(engine), std::move(toolkit), executor, std::move(jobs), concurrency));
+        std::shared_ptr<Promise<Results>> promise = batch->_promise;
+        if (batch->_jobs.empty()) {
+          promise->resolve(Results());
+          return promise;
+        }
+        std::weak_ptr<Batch> weak = batch;
+        batch->_operation = std::move(operation);
+        batch->_cancelled = batch->_operation->token().onCancel([weak] {
+          if (auto self = weak.lock()) {
+            self->stop(espprov::ErrorCode::OPERATION_CANCELLED);
+          }
+        });
+        if (timeout.has_value()) {
+          executor.postAfter(*timeout, [weak] {
+            if (auto self = weak.lock()) {
+              self->stop(espprov::ErrorCode::PROV_TIMED_OUT_ERROR);
+            }
+          });
+        }
+        batch->startJobs();
+        return promise;
+      }
+
+    private:
+      Batch(std::shared_ptr<espprov::ProtocommEngine> engine, std::shared_ptr<HybridEspProvToolkitSpec> toolkit, espprov::Executor& executor,
+            std::vector<PTProvisionJob> jobs, size_t concurrency)
+          : _engine(std::move(engine)), _toolkit(std::move(toolkit)), _executor(executor), _jobs(std::move(jobs)), _results(_jobs.size()),
+            _promise(Promise<Results>::create()), _concurrency(concurrency) {
+        for (size_t index = 0; index < _jobs.size(); index++) {
+          _pending.push_back(index);
+        }
+      }
+
+      static bool isSoftAp(const PTProvisionJob& job) noexcept {
+        return job.transport == PTTransport::TRANSPORT_SOFTAP;
+      }
+
+      void stop(espprov::ErrorCode code) {
+        {
+          std::lock_guard lock(_mutex);
+          if (_stopped.has_value()) {
+            return;
+          }
+          _stopped = code;
+        }
+        // Aborts the running jobs' links, then fails the pending ones
+        _stop.cancel();
+        startJobs();
+      }
+
+      /**
+       * Starts pending jobs, in job order, until the slots are full or only SoftAP jobs are left while one
+       * runs. Once stopped, fails every pending job instead.
+       */
+      void startJobs() {
+        std::vector<size_t> started;
+        bool last = false;
+        {
+          std::lock_guard lock(_mutex);
+          if (_stopped.has_value()) {
+            for (size_t index : _pending) {
+              _results[index] = PTDeviceProvisionResult(_jobs[index].deviceName, false, static_cast<double>(*_stopped),
+                                                        std::vector<PTPhaseSpan>());
+            }
+            _finished += _pending.size();
+            last = !_pending.empty() && _finished == _jobs.size();
+            _pending.clear();
+          }
+          for (auto it = _pending.begin(); it != _pending.end() && _running < _concurrency;) {
+            if (isSoftAp(_jobs[*it])) {
+              if (_softApRunning) {
+                ++it;
+                continue;
+              }
+              _softApRunning = true;
+            }
+            started.push_back(*it);
+            _running++;
+            it = _pending.erase(it);
+          }
+        }
+        if (last) {
+          resolve();
+        }
+        for (size_t index : started) {
+          startJob(index);
+        }
+      }
+
+      void startJob(size_t index) {
+        auto run = std::make_shared<JobRun>();
+        const PTProvisionJob& job = _jobs[index];
+        espprov::spawn(_executor, createJobDevice(_toolkit, job, run, _engine->timeouts().connect), _stop.token(),
+                       [self = shared_from_this(), index, run](std::exception_ptr error) {
+                         if (error) {
+                           const PTProvisionJob& job = self->_jobs[index];
+                           self->finishJob(index, PTDeviceProvisionResult(job.deviceName, false, self->errorCodeOf(error),
+                                                                          run->timings(*self->_engine, job.deviceName)));
+                           return;
+                         }
+                         Promise<void>::async([self, index, run]() {
+                           PTDeviceProvisionResult result = provisionJob(*self->_engine, self->_jobs[index], *run, self->_stop.token());
+                           if (!result.success) {
+                             result.error = self->stopCodeOr(result.error);
+                           }
+                           self->finishJob(index, std::move(result));
+                         });
+                       });
+      }
+
+      double errorCodeOf(const std::exception_ptr& error) const {
+        try {
+          std::rethrow_exception(error);
+        } catch (...) {
+          return stopCodeOr(currentErrorCode());
+        }
+      }
+
+      /**
+       * A job the deadline cut short fails with `PROV_TIMED_OUT_ERROR` rather than the cancel it saw.
+       */
+      double stopCodeOr(std::optional<double> error) const {
+        std::lock_guard lock(_mutex);
+        if (_stopped.has_value() && error == static_cast<double>(espprov::ErrorCode::OPERATION_CANCELLED)) {
+          return static_cast<double>(*_stopped);
+        }
+        return error.value_or(static_cast<double>(espprov::ErrorCode::ESP_NATIVE_UNKNOWN_ERROR));
+      }
+
+      void finishJob(size_t index, PTDeviceProvisionResult result) {
+        bool last = false;
+        {
+          std::lock_guard lock(_mutex);
+          _results[index] = std::move(result);
+          _running--;
+          if (isSoftAp(_jobs[index])) {
+            _softApRunning = false;
+          }
+          last = ++_finished == _jobs.size();
+        }
+        if (last) {
+          resolve();
+        } else {
+          startJobs();
+        }
+      }
+
+      void resolve() {
+        // Every job settled, nothing touches the results any more
+        _promise->resolve(std::move(_results));
+      }
+
+    private:
+      std::shared_ptr<espprov::ProtocommEngine> _engine;
+      std::shared_ptr<HybridEspProvToolkitSpec> _toolkit;
+      espprov::Executor& _executor;
+      const std::vector<PTProvisionJob> _jobs;
+      Results _results;
+      std::shared_ptr<Promise<Results>> _promise;
+      const size_t _concurrency;
+      std::shared_ptr<const Operation> _operation;
+      espprov::CancellationRegistration _cancelled;
+      espprov::CancellationSource _stop;
+
+      mutable std::mutex _mutex;
+      std::list<size_t> _pending;
+      size_t _running = 0;
+      size_t _finished = 0;
+      bool _softApRunning = false;
+      std::optional<espprov::ErrorCode> _stopped;
+    };
+  } // namespace
+
+  HybridEspProvEngine::HybridEspProvEngine(): HybridObject(TAG), _toolkit(sharedToolkit()), _engine(sharedEngine()) {}
+
+  std::shared_ptr<HybridEspProvToolkitSpec> HybridEspProvEngine::sharedToolkit() {
+    // Created on the JS thread with the first instance, so the platform toolkit can be constructed safely.
+    static std::shared_ptr<HybridEspProvToolkitSpec> toolkit = [] {
+      auto toolkit = std::dynamic_pointer_cast<HybridEspProvToolkitSpec>(HybridObjectRegistry::createHybridObject("EspProvToolkit"));
+      if (toolkit == nullptr) {
+        throw std::runtime_error("EspProvToolkit is not registered, the native engine has no transport!");
+      }
+      return toolkit;
+    }();
+    return toolkit;
+  }
+
+  std::shared_ptr<espprov::ProtocommEngine> HybridEspProvEngine::sharedEngine() {
+    // The executor is constructed first, so it outlives the engine and its transports
+    static std::shared_ptr<espprov::ProtocommEngine> engine =
+        std::make_shared<espprov::ProtocommEngine>([toolkit = sharedToolkit(), &executor = sharedExecutor()](
+                                                       const espprov::DeviceConfig& config) -> std::unique_ptr<espprov::Transport> {
+          // The phone is on the device's network, so SoftAP traffic skips the platform HTTP stacks
+          if (config.transport == espprov::TransportKind::SOFTAP) {
+            return std::make_unique<espprov::HttpTransport>(espprov::SOFTAP_DEFAULT_HOST, espprov::SOFTAP_DEFAULT_PORT);
+          }
+          return std::make_unique<espprov::AsyncTransportBridge>(std::make_unique<PlatformTransport>(toolkit, config.name), executor);
+        });
+    return engine;
+  }
+
+  espprov::Executor& HybridEspProvEngine::sharedExecutor() {
+    static espprov::SerialExecutor executor;
+    return executor;
+  }
+
+  bool HybridEspProvEngine::configureESPDevice(const std::string& deviceName, PTTransport transport, PTSecurity security,
+                                               const std::optional<std::string>& proofOfPossession,
+                                               const std::optional<std::string>& username) {
+    auto scheme = static_cast<espprov::SecurityScheme>(security);
+    if (!espprov::isSecuritySchemeSupported(scheme)) {
+      return false;
+    }
+    _engine->configureDevice(espprov::DeviceConfig{
+        .name = deviceName,
+        .transport = static_cast<espprov::TransportKind>(transport),
+        .security = scheme,
+        .securityParams = {.proofOfPossession = proofOfPossession, .username = username},
+    });
+    return true;
+  }
+
+  std::shared_ptr<Promise<PTSessionResult>> HybridEspProvEngine::connectToESPDevice(const std::string& deviceName,
+                                                                                     std::optional<double> operationId) {
+    return tracedAsync<PTSessionResult>("connectToESPDevice", deviceName,
+        [engine = _engine, deviceName, operation = Operation::begin(operationId)]() -> PTSessionResult {
+          try {
+            engine->connect(deviceName, operation->token());
+            return PTSessionResult(true, PTSessionStatus::CONNECTED, std::nullopt);
+          } catch (...) {
+            return PTSessionResult(false, std::nullopt, currentErrorCode());
+          }
+        });
+  }
+
+  PTResult HybridEspProvEngine::disconnectFromESPDevice(const std::string& deviceName) {
+    try {
+      _engine->disconnect(deviceName);
+      return PTResult(true, std::nullopt);
+    } catch (...) {
+      return PTResult(false, currentErrorCode());
+    }
+  }
+
+  bool HybridEspProvEngine::releaseESPDevice(const std::string& deviceName) {
+    return _engine->releaseDevice(deviceName);
+  }
+
+  void HybridEspProvEngine::purgeESPDevices() {
+    _engine->releaseAllDevices();
+  }
+
+  void HybridEspProvEngine::setDeviceRegistryLimits(double maxDevices, double idleTimeoutMs) {
+    _engine->setRegistryLimits(espprov::RegistryLimits{
+        .maxDevices = toCount(maxDevices, 1, MAX_REGISTRY_DEVICES),
+        .idleTimeout = toMillis(idleTimeoutMs),
+    });
+  }
+
+  double HybridEspProvEngine::addDeviceEvictionListener(const std::function<void(const std::string& /* deviceName */)>& listener) {
+    return static_cast<double>(_engine->addEvictionListener(listener));
+  }
+
+  bool HybridEspProvEngine::removeDeviceEvictionListener(double id) {
+    return id >= 1 && _engine->removeEvictionListener(static_cast<uint64_t>(id));
+  }
+
+  void HybridEspProvEngine::setSessionLimits(double maxLinks, double maxExchanges) {
+    _engine->setSessionLimits(espprov::SessionLimits{
+        .maxLinks = toCount(maxLinks, 1, MAX_SESSION_SLOTS),
+        .maxExchanges = toCount(maxExchanges, 1, MAX_SESSION_SLOTS),
+    });
+  }
+
+  PTBooleanResult HybridEspProvEngine::isESPDeviceSessionEstablished(const std::string& deviceName) {
+    try {
+      return PTBooleanResult(true, _engine->isSessionEstablished(deviceName), std::nullopt);
+    } catch (...) {
+      return PTBooleanResult(false, std::nullopt, currentErrorCode());
+    }
+  }
+
+  PTConnectionState HybridEspProvEngine::getConnectionStateOfESPDevice(const std::string& deviceName) {
+    std::optional<espprov::ConnectionState> state = espprov::ConnectionRegistry::shared().state(deviceName);
+    return static_cast<PTConnectionState>(state.value_or(espprov::ConnectionState::IDLE));
+  }
+
+  double HybridEspProvEngine::addConnectionStateListener(const std::function<void(const PTConnectionTransition& /* transition */)>& listener) {
+    uint64_t id = espprov::ConnectionRegistry::shared().addListener(
+        [listener](const espprov::ConnectionTransition& transition) { listener(toTransition(transition)); });
+    return static_cast<double>(id);
+  }
+
+  bool HybridEspProvEngine::removeConnectionStateListener(double id) {
+    return id >= 1 && espprov::ConnectionRegistry::shared().removeListener(static_cast<uint64_t>(id));
+  }
+
+  std::vector<PTPhaseSpan> HybridEspProvEngine::getRunTimingsOfESPDevice(const std::string& deviceName) {
+    try {
+      return toPhaseSpans(_engine->runTimings(deviceName));
+    } catch (...) {
+      return {};
+    }
+  }
+
+  void HybridEspProvEngine::recordPhaseOfESPDevice(const std::string& deviceName, PTPhase phase, double start, double duration,
+                                                   bool failed) {
+    espprov::PhaseSpan span{
+        .phase = static_cast<espprov::Phase>(phase),
+        .start = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::duration<double, std::milli>(start))),
+        .duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::duration<double, std::milli>(std::max(duration, 0.0))),
+        .failed = failed,
+    };
+    try {
+      _engine->recordPhase(deviceName, span);
+    } catch (const espprov::ProtocommError&) {
+      // Devices the engine does not run keep no timings
+    }
+  }
+
+  PTMetricsSnapshot HybridEspProvEngine::getMetricsSnapshot(bool reset) {
+    espprov::MetricsSnapshot snapshot = espprov::MetricsRegistry::shared().snapshot(reset);
+    std::vector<PTErrorCount> errors;
+    errors.reserve(snapshot.errors.size());
+    for (const auto& [code, count] : snapshot.errors) {
+      errors.emplace_back(static_cast<double>(code), static_cast<double>(count));
+    }
+    auto since = std::chrono::duration_cast<std::chrono::milliseconds>(snapshot.since.time_since_epoch());
+    return PTMetricsSnapshot(static_cast<double>(since.count()), toLatencySummaries(snapshot.phases), toLatencySummaries(snapshot.endpoints),
+                             std::move(errors));
+  }
+
+  void HybridEspProvEngine::resetMetrics() {
+    espprov::MetricsRegistry::shared().reset();
+  }
+
+  void HybridEspProvEngine::countError(double error) {
+    if (error >= 0 && error < espprov::MetricsRegistry::MAX_ERROR_CODE) {
+      espprov::MetricsRegistry::shared().countError(static_cast<int>(error));
+    }
+  }
+
+  void HybridEspProvEngine::startTracing() {
+    espprov::Tracer& tracer = espprov::Tracer::shared();
+    tracer.start();
+    tracer.nameThread("JS");
+  }
+
+  void HybridEspProvEngine::stopTracing() {
+    espprov::Tracer::shared().stop();
+  }
+
+  std::string HybridEspProvEngine::exportTrace() {
+    return espprov::Tracer::shared().exportChromeJson();
+  }
+
+  void HybridEspProvEngine::setWifiScanCacheTTL(double ttlMs) {
+    _engine->setScanCacheTtl(toMillis(ttlMs));
+  }
+
+  std::shared_ptr<Promise<PTWifiScanResult>> HybridEspProvEngine::scanWifiListOfESPDevice(const std::string& deviceName,
+                                                                                         std::optional<bool> forceRefresh,
+                                                                                         std::optional<double> operationId) {
+    return tracedAsync<PTWifiScanResult>("scanWifiListOfESPDevice", deviceName,
+        [engine = _engine, deviceName, force = forceRefresh.value_or(false),
+         operation = Operation::begin(operationId)]() -> PTWifiScanResult {
+          try {
+            return PTWifiScanResult(true, toWifiEntries(engine->scanWifi(deviceName, force, operation->token())), std::nullopt);
+          } catch (...) {
+            return PTWifiScanResult(false, std::nullopt, currentErrorCode());
+          }
+        });
+  }
+
+  std::shared_ptr<Promise<PTWifiScanColumns>> HybridEspProvEngine::scanWifiColumnsOfESPDevice(const std::string& deviceName,
+                                                                                             std::optional<bool> forceRefresh,
+                                                                                             std::optional<double> operationId) {
+    return tracedAsync<PTWifiScanColumns>("scanWifiColumnsOfESPDevice", deviceName,
+        [engine = _engine, deviceName, force = forceRefresh.value_or(false),
+         operation = Operation::begin(operationId)]() -> PTWifiScanColumns {
+          try {
+            std::vector<espprov::WifiNetwork> networks = engine->scanWifi(deviceName, force, operation->token());
+            auto columns = std::make_unique<espprov::Bytes>(espprov::encodeWifiScanColumns(networks));
+            espprov::Bytes* owned = columns.get();
+            std::shared_ptr<ArrayBuffer> buffer = ArrayBuffer::wrap(owned->data(), owned->size(), [owned]() { delete owned; });
+            // The buffer owns the bytes only once wrap succeeded
+            columns.release();
+            return PTWifiScanColumns(true, static_cast<double>(networks.size()), buffer, std::nullopt);
+          } catch (...) {
+            return PTWifiScanColumns(false, std::nullopt, std::nullopt, currentErrorCode());
+          }
+        });
+  }
+
+  std::shared_ptr<Promise<PTWifiScanPage>> HybridEspProvEngine::startWifiScanOfESPDevice(const std::string& deviceName, double pageSize,
+                                                                                        std::optional<bool> forceRefresh,
+                                                                                        std::optional<double> operationId) {
+    return tracedAsync<PTWifiScanPage>("startWifiScanOfESPDevice", deviceName,
+        [engine = _engine, deviceName, count = toResultIndex(pageSize), force = forceRefresh.value_or(false),
+         operation = Operation::begin(operationId)]() -> PTWifiScanPage {
+          try {
+            uint32_t resultCount = engine->startWifiScan(deviceName, force, operation->token());
+            std::vector<PTWifiEntry> entries = toWifiEntries(engine->fetchWifiScanResults(deviceName, 0, count, operation->token()));
+            return PTWifiScanPage(true, std::move(entries), static_cast<double>(resultCount), std::nullopt);
+          } catch (...) {
+            return PTWifiScanPage(false, std::nullopt, std::nullopt, currentErrorCode());
+          }
+        });
+  }
+
+  std::shared_ptr<Promise<PTWifiScanPage>> HybridEspProvEngine::fetchWifiScanPageOfESPDevice(const std::string& deviceName,
+                                                                                            double startIndex, double count,
+                                                                                            std::optional<double> operationId) {
+    return tracedAsync<PTWifiScanPage>("fetchWifiScanPageOfESPDevice", deviceName,
+        [engine = _engine, deviceName, start = toResultIndex(startIndex), count = toResultIndex(count),
+         operation = Operation::begin(operationId)]() -> PTWifiScanPage {
+          try {
+            std::vector<PTWifiEntry> entries = toWifiEntries(engine->fetchWifiScanResults(deviceName, start, count, operation->token()));
+            return PTWifiScanPage(true, std::move(entries), std::nullopt, std::nullopt);
+          } catch (...) {
+            return PTWifiScanPage(false, std::nullopt, std::nullopt, currentErrorCode());
+          }
+        });
+  }
+
+  void HybridEspProvEngine::setStatusPollSchedule(double firstMs, double backoff, double maxMs, double deadlineMs) {
+    std::chrono::milliseconds first = toMillis(firstMs);
+    _engine->setStatusPollSchedule(espprov::StatusPollSchedule{
+        .first = first,
+        // A non-finite factor would make the next delay non-finite, so it is bounded as well
+        .backoff = std::isfinite(backoff) ? std::clamp(backoff, 1.0, 16.0) : (std::isnan(backoff) ? 1.0 : 16.0),
+        .max = std::max(toMillis(maxMs), first),
+        .deadline = toMillis(deadlineMs),
+    });
+  }
+
+  std::shared_ptr<Promise<PTProvisionResult>> HybridEspProvEngine::provisionESPDevice(const std::string& deviceName,
+                                                                                      const std::string& ssid,
+                                                                                      const std::string& password,
+                                                                                      std::optional<double> operationId) {
+    return tracedAsync<PTProvisionResult>("provisionESPDevice", deviceName,
+        [engine = _engine, deviceName, ssid, password, operation = Operation::begin(operationId)]() -> PTProvisionResult {
+          try {
+            engine->provision(deviceName, ssid, password, operation->token());
+            return PTProvisionResult(true, std::nullopt);
+          } catch (...) {
+            return PTProvisionResult(false, currentErrorCode());
+          }
+        });
+  }
+
+  std::shared_ptr<Promise<PTStringResult>> HybridEspProvEngine::sendDataToESPDevice(const std::string& deviceName,
+                                                                                    const std::string& path,
+                                                                                    const std::string& data,
+                                                                                    std::optional<double> operationId) {
+    return tracedAsync<PTStringResult>("sendDataToESPDevice", deviceName,
+        [engine = _engine, deviceName, path, data, operation = Operation::begin(operationId)]() -> PTStringResult {
+          try {
+            espprov::Bytes payload = espprov::decodeBase64(data);
+            espprov::Bytes response = engine->sendData(deviceName, path, payload, operation->token());
+            return PTStringResult(true, espprov::encodeBase64(response), std::nullopt);
+          } catch (...) {
+            return PTStringResult(false, std::nullopt, currentErrorCode());
+          }
+        });
+  }
+
+  std::shared_ptr<Promise<PTDataResult>> HybridEspProvEngine::sendBinaryDataToESPDevice(const std::string& deviceName,
+                                                                                        const std::string& path,
+                                                                                        const std::shared_ptr<ArrayBuffer>& data,
+                                                                                        std::optional<double> operationId) {
+    // A JS owned buffer may only be touched on the JS thread, so it is copied once here. Native buffers are used as is.
+    std::shared_ptr<ArrayBuffer> request = data->isOwner() ? data : ArrayBuffer::copy(data);
+    return tracedAsync<PTDataResult>("sendBinaryDataToESPDevice", deviceName,
+        [engine = _engine, deviceName, path, request, operation = Operation::begin(operationId)]() -> PTDataResult {
+          try {
+            auto response = std::make_unique<espprov::Bytes>(
+                engine->sendData(deviceName, path, espprov::ByteView(request->data(), request->size()), operation->token()));
+            espprov::Bytes* owned = response.get();
+            std::shared_ptr<ArrayBuffer> buffer = ArrayBuffer::wrap(owned->data(), owned->size(), [owned]() { delete owned; });
+            // The buffer owns the bytes only once wrap succeeded
+            response.release();
+            return PTDataResult(true, buffer, std::nullopt);
+          } catch (...) {
+            return PTDataResult(false, std::nullopt, currentErrorCode());
+          }
+        });
+  }
+
+  bool HybridEspProvEngine::cancelESPOperation(double operationId) {
+    return Operation::cancel(operationId);
+  }
+
+  std::shared_ptr<Promise<std::vector<PTDeviceProvisionResult>>>
+  HybridEspProvEngine::provisionESPDevices(const std::vector<PTProvisionJob>& jobs, const std::optional<PTBatchOptions>& options,
+                                           std::optional<double> operationId) {
+    size_t concurrency = DEFAULT_BATCH_CONCURRENCY;
+    std::optional<std::chrono::milliseconds> timeout;
+    if (options.has_value() && options->concurrency.has_value()) {
+      concurrency = toCount(*options->concurrency, 1, MAX_BATCH_CONCURRENCY);
+    }
+    if (options.has_value() && options->timeoutMs.has_value()) {
+      timeout = toMillis(*options->timeoutMs);
+    }
+    espprov::Tracer& tracer = espprov::Tracer::shared();
+    if (tracer.enabled()) {
+      if (!espprov::Tracer::isThreadNamed()) {
+        tracer.nameThread("JS");
+      }
+      tracer.instant(espprov::TraceCategory::BRIDGE, "provisionESPDevices", std::to_string(jobs.size()) + " jobs");
+    }
+    return Batch::run(_engine, _toolkit, sharedExecutor(), jobs, concurrency, timeout, Operation::begin(operationId));
+  }
+
+} // namespace margelo::nitro::espprovtoolkit
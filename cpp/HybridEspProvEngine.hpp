@@ -0,0 +1,82 @@
+///
+/// HybridEspProvEngine.hpp
+/// The C++ HybridObject exposing the shared protocomm engine to JS.
+///
+
+#pragma once
+
+#include "HybridEspProvEngineSpec.hpp"
+#include "HybridEspProvToolkitSpec.hpp"
+#include "core/Executor.hpp"
+#include "core/ProtocommEngine.hpp"
+#include <memory>
+
+namespace margelo::nitro::espprovtoolkit {
+
+  /**
+   * Every instance shares one process wide `espprov::ProtocommEngine`, the same way the Swift and
+   * Kotlin toolkits share their device maps. Blocking engine calls run on Nitro's thread pool.
+   */
+  class HybridEspProvEngine : public HybridEspProvEngineSpec {
+  public:
+    HybridEspProvEngine();
+
+    bool configureESPDevice(const std::string& deviceName, PTTransport transport, PTSecurity security,
+                            const std::optional<std::string>& proofOfPossession, const std::optional<std::string>& username) override;
+    std::shared_ptr<Promise<PTSessionResult>> connectToESPDevice(const std::string& deviceName, std::optional<double> operationId) override;
+    PTResult disconnectFromESPDevice(const std::string& deviceName) override;
+    bool releaseESPDevice(const std::string& deviceName) override;
+    void purgeESPDevices() override;
+    void setDeviceRegistryLimits(double maxDevices, double idleTimeoutMs) override;
+    double addDeviceEvictionListener(const std::function<void(const std::string& /* deviceName */)>& listener) override;
+    bool removeDeviceEvictionListener(double id) override;
+    void setSessionLimits(double maxLinks, double maxExchanges) override;
+    PTBooleanResult isESPDeviceSessionEstablished(const std::string& deviceName) override;
+    PTConnectionState getConnectionStateOfESPDevice(const std::string& deviceName) override;
+    double addConnectionStateListener(const std::function<void(const PTConnectionTransition& /* transition */)>& listener) override;
+    bool removeConnectionStateListener(double id) override;
+    std::vector<PTPhaseSpan> getRunTimingsOfESPDevice(const std::string& deviceName) override;
+    void recordPhaseOfESPDevice(const std::string& deviceName, PTPhase phase, double start, double duration, bool failed) override;
+    PTMetricsSnapshot getMetricsSnapshot(bool reset) override;
+    void resetMetrics() override;
+    void countError(double error) override;
+    void startTracing() override;
+    void stopTracing() override;
+    std::string exportTrace() override;
+    void setWifiScanCacheTTL(double ttlMs) override;
+    std::shared_ptr<Promise<PTWifiScanResult>> scanWifiListOfESPDevice(const std::string& deviceName, std::optional<bool> forceRefresh,
+                                                                       std::optional<double> operationId) override;
+    std::shared_ptr<Promise<PTWifiScanColumns>> scanWifiColumnsOfESPDevice(const std::string& deviceName, std::optional<bool> forceRefresh,
+                                                                           std::optional<double> operationId) override;
+    std::shared_ptr<Promise<PTWifiScanPage>> startWifiScanOfESPDevice(const std::string& deviceName, double pageSize,
+                                                                      std::optional<bool> forceRefresh,
+                                                                      std::optional<double> operationId) override;
+    std::shared_ptr<Promise<PTWifiScanPage>> fetchWifiScanPageOfESPDevice(const std::string& deviceName, double startIndex, double count,
+                                                                          std::optional<double> operationId) override;
+    void setStatusPollSchedule(double firstMs, double backoff, double maxMs, double deadlineMs) override;
+    std::shared_ptr<Promise<PTProvisionResult>> provisionESPDevice(const std::string& deviceName, const std::string& ssid,
+                                                                   const std::string& password, std::optional<double> operationId) override;
+    std::shared_ptr<Promise<PTStringResult>> sendDataToESPDevice(const std::string& deviceName, const std::string& path,
+                                                                 const std::string& data, std::optional<double> operationId) override;
+    std::shared_ptr<Promise<PTDataResult>> sendBinaryDataToESPDevice(const std::string& deviceName, const std::string& path,
+                                                                     const std::shared_ptr<ArrayBuffer>& data,
+                                                                     std::optional<double> operationId) override;
+    bool cancelESPOperation(double operationId) override;
+    std::shared_ptr<Promise<std::vector<PTDeviceProvisionResult>>> provisionESPDevices(const std::vector<PTProvisionJob>& jobs,
+                                                                                      const std::optional<PTBatchOptions>& options,
+                                                                                      std::optional<double> operationId) override;
+
+  private:
+    static std::shared_ptr<HybridEspProvToolkitSpec> sharedToolkit();
+    static std::shared_ptr<espprov::ProtocommEngine> sharedEngine();
+    /**
+     * Where the platform transports' callbacks resume the engine's waiting exchanges.
+     */
+    static espprov::Executor& sharedExecutor();
+
+  private:
+    std::shared_ptr<HybridEspProvToolkitSpec> _toolkit;
+    std::shared_ptr<espprov::ProtocommEngine> _engine;
+  };
+
+} // namespace margelo::nitro::espprovtoolkit
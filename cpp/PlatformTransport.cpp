@@ -0,0 +1,62 @@
+///
+/// PlatformTransport.cpp
+/// Raw transport that tunnels engine traffic through the Swift/Kotlin toolkit.
+///
+
+#include "PlatformTransport.hpp"
+#include "core/Errors.hpp"
+
+namespace margelo::nitro::espprovtoolkit {
+
+  using espprov::ErrorCode;
+
+  PlatformTransport::PlatformTransport(std::shared_ptr<HybridEspProvToolkitSpec> toolkit, std::string deviceName)
+      : _toolkit(std::move(toolkit)), _deviceName(std::move(deviceName)) {}
+
+  PlatformTransport::~PlatformTransport() {
+    disconnect();
+  }
+
+  void PlatformTransport::connect(espprov::Completer<void> done) {
+    _connected = true;
+    done.resolve();
+  }
+
+  void PlatformTransport::exchange(std::string_view endpoint, espprov::ByteView payload, espprov::Completer<espprov::Bytes> done) {
+    if (!_connected) {
+      done.reject(ErrorCode::SESSION_NOT_ESTABLISHED, "Transport to " + _deviceName + " is not connected");
+      return;
+    }
+
+    // The platform may read the request on any thread, so it gets a native owning copy.
+    auto request = ArrayBuffer::copy(payload.data(), payload.size());
+    auto promise = _toolkit->sendRawDataToESPDevice(_deviceName, std::string(endpoint), request);
+    promise->addOnResolvedListener([done, endpoint = std::string(endpoint)](const PTDataResult& result) mutable {
+      if (!result.success) {
+        auto code = static_cast<ErrorCode>(static_cast<int>(result.error.value_or(static_cast<double>(ErrorCode::SESSION_SEND_DATA_ERROR))));
+        done.reject(code, "Platform transport failed on " + endpoint);
+        return;
+      }
+      if (!result.data.has_value() || *result.data == nullptr) {
+        done.resolve({});
+        return;
+      }
+      const std::shared_ptr<ArrayBuffer>& data = *result.data;
+      done.resolve(espprov::Bytes(data->data(), data->data() + data->size()));
+    });
+    promise->addOnRejectedListener([done](const std::exception_ptr& error) mutable { done.reject(error); });
+  }
+
+  void PlatformTransport::disconnect() noexcept {
+    if (!_connected) {
+      return;
+    }
+    _connected = false;
+    try {
+      _toolkit->disconnectFromESPDevice(_deviceName);
+    } catch (...) {
+      // Nothing left to clean up if the platform already dropped the link.
+    }
+  }
+
+} // namespace margelo::nitro::espprovtoolkit
@@ -0,0 +1,42 @@
+///
+/// PlatformTransport.hpp
+/// Raw transport that tunnels engine traffic through the Swift/Kotlin toolkit.
+///
+
+#pragma once
+
+#include "HybridEspProvToolkitSpec.hpp"
+#include "core/AsyncTransport.hpp"
+#include <memory>
+#include <string>
+
+namespace margelo::nitro::espprovtoolkit {
+
+  /**
+   * Implements `espprov::AsyncTransport` on top of `EspProvToolkit.sendRawDataToESPDevice`, so BLE
+   * and SoftAP links keep using the Espressif SDK while the protocol itself runs in C++. The
+   * toolkit's promise settles the exchange from whatever thread the SDK answers on.
+   *
+   * The platform opens the link lazily on the first exchange, so `connect` resolves right away and
+   * `AsyncTransportBridge` gives that exchange the connect timeout.
+   */
+  class PlatformTransport final : public espprov::AsyncTransport {
+  public:
+    PlatformTransport(std::shared_ptr<HybridEspProvToolkitSpec> toolkit, std::string deviceName);
+    ~PlatformTransport() override;
+
+    void connect(espprov::Completer<void> done) override;
+    void exchange(std::string_view endpoint, espprov::ByteView payload, espprov::Completer<espprov::Bytes> done) override;
+    void disconnect() noexcept override;
+
+    bool isConnected() const noexcept override {
+      return _connected;
+    }
+
+  private:
+    std::shared_ptr<HybridEspProvToolkitSpec> _toolkit;
+    std::string _deviceName;
+    bool _connected = false;
+  };
+
+} // namespace margelo::nitro::espprovtoolkit
@@ -0,0 +1,42 @@
+///
+/// AllocationCounter.cpp
+/// Counts the heap allocations of a benchmark process, by replacing the global operator new.
+///
+
+#include "AllocationCounter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// GCC flags the malloc/free pairing once it inlines the replacements, which is exactly what they are.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace {
+  std::atomic<size_t> allocations{0};
+} // namespace
+
+void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  std::free(pointer);
+}
+
+namespace espprov::bench {
+
+  size_t allocationCount() noexcept {
+    return allocations.load(std::memory_order_relaxed);
+  }
+
+} // namespace espprov::bench
@@ -0,0 +1,18 @@
+///
+/// AllocationCounter.hpp
+/// Counts the heap allocations of a benchmark process, by replacing the global operator new.
+///
+
+#pragma once
+
+#include <cstddef>
+
+namespace espprov::bench {
+
+  /**
+   * The number of `operator new` calls so far. Link `bench/AllocationCounter.cpp` into the
+   * benchmark executable for the replacement to take effect.
+   */
+  size_t allocationCount() noexcept;
+
+} // namespace espprov::bench
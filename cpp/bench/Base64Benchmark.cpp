@@ -0,0 +1,245 @@
+///
+/// Base64Benchmark.cpp
+/// Compares the speed of every base64 kernel this CPU supports, and checks them against the RFC 4648
+/// test vectors and a bit by bit reference codec on random input.
+///
+/// The fuzzing covers random lengths and contents, line breaks at random places and every 76
+/// characters as Android's `Base64.DEFAULT` writes them, missing padding, and single corrupted
+/// characters, which have to fail exactly where the reference fails.
+///
+/// Build with optimizations, e.g. `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release`, then run
+/// `build/espprov-base64-bench`. `build/espprov-base64-bench --check [cases]` instead runs the checks and exits with 1 if
+/// a kernel disagrees with the reference; ctest runs it that way.
+///
+
+#include "BenchMode.hpp"
+#include "core/Base64.hpp"
+#include "core/Errors.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace espprov;
+
+namespace {
+  constexpr const char* ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  constexpr Base64Kernel KERNELS[] = {Base64Kernel::SCALAR, Base64Kernel::SSSE3, Base64Kernel::NEON};
+
+  // Keeps the optimizer from discarding results
+  volatile size_t sink = 0;
+  int failures = 0;
+
+  // pragma MARK: Reference
+
+  /**
+   * RFC 4648 section 4 taken literally: a bit queue, read six bits at a time.
+   */
+  std::string referenceEncode(ByteView bytes) {
+    std::string out;
+    uint32_t bits = 0;
+    int count = 0;
+    for (uint8_t byte : bytes) {
+      bits = (bits << 8) | byte;
+      count += 8;
+      while (count >= 6) {
+        count -= 6;
+        out += ALPHABET[(bits >> count) & 0x3F];
+      }
+    }
+    if (count > 0) {
+      out += ALPHABET[(bits << (6 - count)) & 0x3F];
+    }
+    while (out.size() % 4 != 0) {
+      out += '=';
+    }
+    return out;
+  }
+
+  /**
+   * The decoder's documented contract: line breaks anywhere, padding optional but complete if
+   * present, nothing but padding and line breaks after it. Nullopt where it has to throw.
+   */
+  std::optional<Bytes> referenceDecode(std::string_view text) {
+    Bytes out;
+    uint32_t bits = 0;
+    int count = 0;
+    size_t data = 0;
+    size_t padding = 0;
+    for (char c : text) {
+      if (c == '\r' || c == '\n') {
+        continue;
+      }
+      if (c == '=') {
+        padding++;
+        continue;
+      }
+      const char* found = c != '\0' ? std::strchr(ALPHABET, c) : nullptr;
+      if (found == nullptr || padding > 0) {
+        return std::nullopt;
+      }
+      bits = (bits << 6) | static_cast<uint32_t>(found - ALPHABET);
+      count += 6;
+      data++;
+      if (count >= 8) {
+        count -= 8;
+        out.push_back(static_cast<uint8_t>(bits >> count));
+      }
+    }
+    size_t rest = data % 4;
+    if (rest == 1 || (padding > 0 && (rest == 0 || rest + padding != 4))) {
+      return std::nullopt;
+    }
+    return out;
+  }
+
+  // pragma MARK: Checks
+
+  void check(bool condition, Base64Kernel kernel, const char* what, size_t length) {
+    if (!condition) {
+      if (failures < 20) {
+        std::fprintf(stderr, "check failed: %s, %s kernel, %zu bytes\n", what, base64KernelName(kernel), length);
+      }
+      failures++;
+    }
+  }
+
+  std::optional<Bytes> tryDecode(std::string_view text, Base64Kernel kernel) {
+    try {
+      return decodeBase64(text, kernel);
+    } catch (const ProtocommError& e) {
+      if (e.code() != ErrorCode::RUNTIME_BAD_BASE64_DATA) {
+        throw;
+      }
+      return std::nullopt;
+    }
+  }
+
+  void checkDecode(std::string_view text, Base64Kernel kernel, const char* what) {
+    check(tryDecode(text, kernel) == referenceDecode(text), kernel, what, text.size());
+  }
+
+  void checkVectors(Base64Kernel kernel) {
+    // RFC 4648 section 10
+    const char* vectors[][2] = {
+        {"", ""}, {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"}, {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"},
+    };
+    for (const auto& [plain, encoded] : vectors) {
+      check(encodeBase64(asBytes(plain), kernel) == encoded, kernel, "RFC 4648 encode vector", std::strlen(plain));
+      check(tryDecode(encoded, kernel) == toBytes(plain), kernel, "RFC 4648 decode vector", std::strlen(plain));
+    }
+    for (const char* bad : {"Z", "Zg=", "Zg===", "Zm9v=", "Zg==Zg==", "Zm9 v", "Zm9v\t", "Zm-v", "Zm_v"}) {
+      check(!tryDecode(bad, kernel), kernel, "malformed input is rejected", std::strlen(bad));
+    }
+  }
+
+  std::string withLineBreaks(const std::string& encoded, size_t every) {
+    std::string wrapped;
+    for (size_t i = 0; i < encoded.size(); i += every) {
+      wrapped += encoded.substr(i, every);
+      wrapped += '\n';
+    }
+    return wrapped;
+  }
+
+  void fuzz(Base64Kernel kernel, size_t cases) {
+    std::mt19937_64 random(0xE5B);
+    std::uniform_int_distribution<int> byte(0, 255);
+    // Mostly shorter than a few kernel blocks, where the hand over to the scalar loop happens
+    std::uniform_int_distribution<size_t> shortLength(0, 200);
+    std::uniform_int_distribution<size_t> longLength(0, 8192);
+    for (size_t n = 0; n < cases; n++) {
+      Bytes plain((n % 8 == 0 ? longLength : shortLength)(random));
+      for (uint8_t& value : plain) {
+        value = static_cast<uint8_t>(byte(random));
+      }
+      std::string encoded = referenceEncode(plain);
+      check(encodeBase64(plain, kernel) == encoded, kernel, "encode matches the reference", plain.size());
+      check(tryDecode(encoded, kernel) == plain, kernel, "decode round trips", plain.size());
+
+      checkDecode(withLineBreaks(encoded, 76), kernel, "decode of Base64.DEFAULT output");
+      std::string unpadded = encoded.substr(0, encoded.find('='));
+      checkDecode(unpadded, kernel, "decode without padding");
+      if (encoded.empty()) {
+        continue;
+      }
+
+      std::uniform_int_distribution<size_t> position(0, encoded.size() - 1);
+      std::string broken = encoded;
+      broken.insert(position(random), 1, random() % 2 == 0 ? '\r' : '\n');
+      checkDecode(broken, kernel, "decode with a line break");
+      broken = encoded;
+      broken[position(random)] = static_cast<char>(byte(random));
+      checkDecode(broken, kernel, "decode with a corrupted character");
+      broken = encoded;
+      broken.insert(position(random), 1, '=');
+      checkDecode(broken, kernel, "decode with misplaced padding");
+      broken = encoded;
+      broken.erase(position(random), 1);
+      checkDecode(broken, kernel, "decode with a missing character");
+    }
+  }
+
+  double measure(int iterations, const std::function<void()>& body) {
+    body(); // warm up
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      body();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  bool checkOnly = bench::takeCheckFlag(argc, argv);
+  long cases = argc > 1 ? std::atol(argv[1]) : 20000;
+  if (cases <= 0 || (!checkOnly && argc > 1)) {
+    std::fprintf(stderr, "usage: %s [--check [cases]]\n", argv[0]);
+    return 1;
+  }
+
+  if (checkOnly) {
+    for (Base64Kernel kernel : KERNELS) {
+      if (isBase64KernelSupported(kernel)) {
+        checkVectors(kernel);
+        fuzz(kernel, static_cast<size_t>(cases));
+      }
+    }
+    if (failures > 0) {
+      std::fprintf(stderr, "%d checks failed\n", failures);
+      return 1;
+    }
+    std::printf("all supported kernels agree with RFC 4648 on %ld random cases\n", cases);
+    return 0;
+  }
+
+  std::printf("default kernel is %s\n\n", base64KernelName(fastestBase64Kernel()));
+
+  // A certificate sized custom endpoint payload
+  Bytes payload(32 * 1024);
+  for (size_t i = 0; i < payload.size(); i++) {
+    payload[i] = static_cast<uint8_t>(i * 167 + 13);
+  }
+  std::string encoded = encodeBase64(payload);
+  std::string wrapped = withLineBreaks(encoded, 76);
+  auto megabytesPerSecond = [&](double seconds) { return static_cast<double>(payload.size()) / seconds / 1e6; };
+
+  std::printf("%-8s %14s %14s %20s\n", "kernel", "encode MB/s", "decode MB/s", "decode 76/line MB/s");
+  for (Base64Kernel kernel : KERNELS) {
+    if (!isBase64KernelSupported(kernel)) {
+      continue;
+    }
+    double encode = measure(2000, [&] { sink = sink + encodeBase64(payload, kernel).size(); });
+    double decode = measure(2000, [&] { sink = sink + decodeBase64(encoded, kernel).size(); });
+    double decodeWrapped = measure(2000, [&] { sink = sink + decodeBase64(wrapped, kernel).size(); });
+    std::printf("%-8s %14.0f %14.0f %20.0f\n", base64KernelName(kernel), megabytesPerSecond(encode), megabytesPerSecond(decode),
+                megabytesPerSecond(decodeWrapped));
+  }
+  return 0;
+}
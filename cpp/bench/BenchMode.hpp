@@ -0,0 +1,27 @@
+///
+/// BenchMode.hpp
+/// Selects between the correctness checks and the timings of a benchmark executable.
+///
+
+#pragma once
+
+#include <cstring>
+
+namespace espprov::bench {
+
+  /**
+   * Consumes a leading `--check` argument, leaving the remaining arguments in place after the program name.
+   * With it the executable runs its correctness checks and exits with 1 if one fails, which is how ctest
+   * runs it; without it the executable only measures.
+   */
+  inline bool takeCheckFlag(int& argc, char**& argv) {
+    if (argc < 2 || std::strcmp(argv[1], "--check") != 0) {
+      return false;
+    }
+    argv[1] = argv[0];
+    argv++;
+    argc--;
+    return true;
+  }
+
+} // namespace espprov::bench
@@ -0,0 +1,318 @@
+///
+/// CancellationBenchmark.cpp
+/// Measures how long a cancelled engine call takes to return, and checks that cancelling a call ends
+/// it wherever it waits and frees the device's link, over a SoftAP HTTP link and over a BLE link
+/// answering through callbacks.
+///
+/// Build with `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release`, then run
+/// `build/espprov-cancel-bench`. `--check` instead runs the checks and exits with 1 if one fails;
+/// ctest runs it that way.
+///
+
+#include "BenchMode.hpp"
+#include "core/AsyncTransport.hpp"
+#include "core/Cancellation.hpp"
+#include "core/ConnectionStateMachine.hpp"
+#include "core/Errors.hpp"
+#include "core/Executor.hpp"
+#include "core/HttpTransport.hpp"
+#include "core/ProtocommEngine.hpp"
+#include "sim/LoopbackHttpServer.hpp"
+#include "sim/SimulatedDevice.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace espprov;
+using namespace std::chrono_literals;
+
+namespace {
+  int failures = 0;
+
+  void check(bool condition, const char* what) {
+    if (!condition) {
+      std::fprintf(stderr, "check failed: %s\n", what);
+      failures++;
+    }
+  }
+
+  /**
+   * A BLE link answering on the radio's thread after a short latency, or never while `silent` is
+   * set, like a peripheral the installer walked away from.
+   */
+  class FakeRadioTransport final : public AsyncTransport {
+  public:
+    struct Radio {
+      SerialExecutor executor;
+      std::atomic<bool> silent{false};
+      std::atomic<int> abandoned{0};
+    };
+
+    FakeRadioTransport(std::shared_ptr<sim::SimulatedDevice> device, Radio& radio): _device(std::move(device)), _radio(radio) {}
+
+    void connect(Completer<void> done) override {
+      _connected = true;
+      done.resolve();
+    }
+
+    void exchange(std::string_view endpoint, ByteView payload, Completer<Bytes> done) override {
+      done.onAbandoned([&radio = _radio] { radio.abandoned++; });
+      if (_radio.silent) {
+        return;
+      }
+      _radio.executor.postAfter(2ms, [done, reply = _device->handle(endpoint, payload)]() mutable { done.resolve(std::move(reply)); });
+    }
+
+    void disconnect() noexcept override {
+      _connected = false;
+    }
+
+    bool isConnected() const noexcept override {
+      return _connected;
+    }
+
+  private:
+    std::shared_ptr<sim::SimulatedDevice> _device;
+    Radio& _radio;
+    bool _connected = false;
+  };
+
+  std::shared_ptr<sim::SimulatedDevice> makeDevice(std::chrono::milliseconds joinDuration = 0ms) {
+    sim::SimulatedDeviceConfig config;
+    config.security = SecurityScheme::SEC1;
+    config.connectingPolls = 0;
+    config.joinDuration = joinDuration;
+    return std::make_shared<sim::SimulatedDevice>(config);
+  }
+
+  DeviceConfig deviceConfig(const std::string& name, TransportKind transport) {
+    return {
+        .name = name,
+        .transport = transport,
+        .security = SecurityScheme::SEC1,
+        .securityParams = {.proofOfPossession = "abcd1234", .username = std::nullopt},
+    };
+  }
+
+  struct Cancelled {
+    std::optional<ErrorCode> error;
+    std::chrono::microseconds afterCancel{0};
+  };
+
+  /**
+   * Runs `call` on its own thread, cancels it after `delay` and times how long it takes to return
+   * from there.
+   */
+  Cancelled cancelAfter(std::chrono::milliseconds delay, const std::function<void(const CancellationToken&)>& call) {
+    CancellationSource source;
+    std::promise<std::optional<ErrorCode>> done;
+    std::future<std::optional<ErrorCode>> result = done.get_future();
+    std::thread worker([&] {
+      try {
+        call(source.token());
+        done.set_value(std::nullopt);
+      } catch (const ProtocommError& e) {
+        done.set_value(e.code());
+      }
+    });
+    std::this_thread::sleep_for(delay);
+    auto cancelled = std::chrono::steady_clock::now();
+    source.cancel();
+    Cancelled outcome;
+    outcome.error = result.get();
+    outcome.afterCancel = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - cancelled);
+    worker.join();
+    return outcome;
+  }
+
+  bool isIdle(const std::string& deviceName) {
+    return ConnectionRegistry::shared().state(deviceName) == ConnectionState::IDLE;
+  }
+
+  // pragma MARK: SoftAP
+
+  /**
+   * Provisions a device that takes 10 seconds to join and cancels it during the status wait.
+   */
+  Cancelled cancelStatusWait(bool checked) {
+    auto device = makeDevice(10000ms);
+    sim::LoopbackHttpServer server(device);
+    ProtocommEngine engine([&](const DeviceConfig&) { return std::make_unique<HttpTransport>("127.0.0.1", server.port()); });
+    engine.setStatusPollSchedule({.first = 50ms, .backoff = 1, .max = 50ms, .deadline = 30000ms});
+    engine.configureDevice(deviceConfig("softap-status", TransportKind::SOFTAP));
+    engine.connect("softap-status");
+
+    Cancelled outcome = cancelAfter(
+        200ms, [&](const CancellationToken& cancel) { engine.provision("softap-status", "HomeNetwork", "password123", cancel); });
+    if (checked) {
+      check(outcome.error == ErrorCode::OPERATION_CANCELLED, "a cancelled status wait fails with OPERATION_CANCELLED");
+      check(device->statusPolls() > 0, "the status wait had started");
+      check(!engine.isSessionEstablished("softap-status") && isIdle("softap-status"), "a cancelled provision closes the session");
+      engine.connect("softap-status");
+      check(engine.isSessionEstablished("softap-status"), "the device connects again after a cancel");
+    }
+    return outcome;
+  }
+
+  void checkSoftAp() {
+    cancelStatusWait(true);
+
+    auto device = makeDevice();
+    // Blocks the device's only request slot like firmware that stopped answering
+    device->setCustomEndpoint("stuck", [](ByteView request) {
+      std::this_thread::sleep_for(500ms);
+      return Bytes(request.begin(), request.end());
+    });
+    sim::LoopbackHttpServer server(device);
+    ProtocommEngine engine([&](const DeviceConfig&) { return std::make_unique<HttpTransport>("127.0.0.1", server.port()); });
+    engine.configureDevice(deviceConfig("softap-stuck", TransportKind::SOFTAP));
+    engine.connect("softap-stuck");
+
+    const Bytes payload{1, 2, 3};
+    CancellationSource early;
+    early.cancel();
+    std::optional<ErrorCode> error;
+    try {
+      engine.sendData("softap-stuck", "stuck", payload, early.token());
+    } catch (const ProtocommError& e) {
+      error = e.code();
+    }
+    check(error == ErrorCode::OPERATION_CANCELLED, "a call cancelled before it started fails");
+    check(engine.isSessionEstablished("softap-stuck"), "a call cancelled before it started leaves the session open");
+
+    Cancelled stuck = cancelAfter(100ms, [&](const CancellationToken& cancel) { engine.sendData("softap-stuck", "stuck", payload, cancel); });
+    check(stuck.error == ErrorCode::OPERATION_CANCELLED, "a cancelled exchange fails with OPERATION_CANCELLED");
+    check(stuck.afterCancel < 100ms, "a cancel wakes the exchange blocked on the socket");
+    check(!engine.isSessionEstablished("softap-stuck"), "a cancelled exchange closes the session");
+  }
+
+  // pragma MARK: BLE
+
+  struct BleRig {
+    FakeRadioTransport::Radio radio;
+    SerialExecutor resume;
+    ProtocommEngine engine;
+
+    BleRig()
+        : engine([this](const DeviceConfig&) {
+            return std::make_unique<AsyncTransportBridge>(std::make_unique<FakeRadioTransport>(makeDevice(), radio), resume);
+          }) {
+      engine.setSessionLimits({.maxLinks = 1, .maxExchanges = 1});
+    }
+  };
+
+  Cancelled cancelSilentExchange(BleRig& rig, const std::string& deviceName) {
+    rig.engine.connect(deviceName);
+    rig.radio.silent = true;
+    Cancelled outcome =
+        cancelAfter(20ms, [&](const CancellationToken& cancel) { rig.engine.sendData(deviceName, "custom", Bytes{1, 2, 3}, cancel); });
+    rig.radio.silent = false;
+    return outcome;
+  }
+
+  Cancelled cancelQueuedConnect(BleRig& rig, const std::string& holder, const std::string& queued) {
+    rig.engine.connect(holder);
+    Cancelled outcome = cancelAfter(20ms, [&](const CancellationToken& cancel) { rig.engine.connect(queued, cancel); });
+    rig.engine.disconnect(holder);
+    return outcome;
+  }
+
+  void checkBle() {
+    BleRig rig;
+    rig.engine.configureDevice(deviceConfig("ble-a", TransportKind::BLE));
+    rig.engine.configureDevice(deviceConfig("ble-b", TransportKind::BLE));
+
+    rig.engine.connect("ble-a");
+    Cancelled queued = cancelAfter(100ms, [&](const CancellationToken& cancel) { rig.engine.connect("ble-b", cancel); });
+    check(queued.error == ErrorCode::OPERATION_CANCELLED, "a connect cancelled in the link queue fails with OPERATION_CANCELLED");
+    check(queued.afterCancel < 50ms, "a cancel ends the link slot wait at once");
+    check(rig.engine.sessionScheduler().queuedLinks() == 0, "a cancelled connect leaves the link queue");
+    check(rig.engine.isSessionEstablished("ble-a"), "cancelling a queued connect leaves the linked device alone");
+
+    rig.radio.silent = true;
+    Cancelled silent =
+        cancelAfter(100ms, [&](const CancellationToken& cancel) { rig.engine.sendData("ble-a", "custom", Bytes{1, 2, 3}, cancel); });
+    rig.radio.silent = false;
+    check(silent.error == ErrorCode::OPERATION_CANCELLED, "an exchange the peripheral never answers is cancelled");
+    check(silent.afterCancel < 50ms, "a cancel ends the callback wait at once");
+    check(rig.radio.abandoned == 1, "the platform exchange is abandoned");
+    check(rig.engine.sessionScheduler().openLinks() == 0 && isIdle("ble-a"), "a cancelled exchange gives back the link slot");
+
+    rig.engine.connect("ble-a");
+    rig.radio.silent = true;
+    Cancelled scan = cancelAfter(100ms, [&](const CancellationToken& cancel) { rig.engine.startWifiScan("ble-a", true, cancel); });
+    rig.radio.silent = false;
+    check(scan.error == ErrorCode::OPERATION_CANCELLED && scan.afterCancel < 50ms, "a cancel ends a paged scan's wait at once");
+    check(rig.engine.sessionScheduler().openLinks() == 0 && isIdle("ble-a"), "a cancelled paged scan gives back the link slot");
+
+    rig.engine.connect("ble-a");
+    uint32_t resultCount = rig.engine.startWifiScan("ble-a", true);
+    rig.radio.silent = true;
+    Cancelled page =
+        cancelAfter(100ms, [&](const CancellationToken& cancel) { rig.engine.fetchWifiScanResults("ble-a", 0, resultCount, cancel); });
+    rig.radio.silent = false;
+    check(page.error == ErrorCode::OPERATION_CANCELLED && page.afterCancel < 50ms, "a cancel ends a scan page's wait at once");
+    check(rig.engine.sessionScheduler().openLinks() == 0 && isIdle("ble-a"), "a cancelled scan page gives back the link slot");
+
+    auto start = std::chrono::steady_clock::now();
+    rig.engine.connect("ble-b");
+    check(rig.engine.isSessionEstablished("ble-b") && std::chrono::steady_clock::now() - start < 1s,
+          "the next device gets the freed link right away");
+    rig.engine.disconnect("ble-b");
+  }
+
+  std::chrono::microseconds median(std::vector<std::chrono::microseconds> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  bool checkOnly = bench::takeCheckFlag(argc, argv);
+  if (argc > 1) {
+    std::fprintf(stderr, "usage: %s [--check]\n", argv[0]);
+    return 1;
+  }
+
+  if (checkOnly) {
+    checkSoftAp();
+    checkBle();
+    if (failures > 0) {
+      return 1;
+    }
+    std::printf("checks passed\n");
+    return 0;
+  }
+
+  constexpr int RUNS = 15;
+  std::vector<std::chrono::microseconds> statusWait;
+  std::vector<std::chrono::microseconds> silentExchange;
+  std::vector<std::chrono::microseconds> queuedConnect;
+  BleRig rig;
+  rig.engine.configureDevice(deviceConfig("ble-bench-a", TransportKind::BLE));
+  rig.engine.configureDevice(deviceConfig("ble-bench-b", TransportKind::BLE));
+  for (int run = 0; run < RUNS; run++) {
+    statusWait.push_back(cancelStatusWait(false).afterCancel);
+    silentExchange.push_back(cancelSilentExchange(rig, "ble-bench-a").afterCancel);
+    queuedConnect.push_back(cancelQueuedConnect(rig, "ble-bench-a", "ble-bench-b").afterCancel);
+  }
+
+  // Without a cancel each of these held the link until the engine's own timeout
+  Timeouts timeouts;
+  std::printf("%-34s %16s %16s\n", "cancelled while waiting for", "return after", "timeout without");
+  auto row = [](const char* name, std::chrono::microseconds took, std::chrono::milliseconds timeout) {
+    std::printf("%-34s %13.3f ms %13lld ms\n", name, static_cast<double>(took.count()) / 1000.0, static_cast<long long>(timeout.count()));
+  };
+  row("the Wi-Fi status (SoftAP)", median(statusWait), StatusPollSchedule{}.deadline);
+  row("a reply that never comes (BLE)", median(silentExchange), timeouts.request);
+  row("a BLE link slot", median(queuedConnect), timeouts.schedulerWait);
+  return 0;
+}
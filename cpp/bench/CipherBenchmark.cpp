@@ -0,0 +1,229 @@
+///
+/// CipherBenchmark.cpp
+/// Compares the AES paths on Sec1 and Sec2 sized messages, and times the Sec1 key agreement. Checks every
+/// AES path this CPU supports, and X25519, against known answers.
+///
+/// The vectors are FIPS-197 appendix C.3 for the block cipher, SP 800-38A F.5.5 for CTR, RFC 7748
+/// section 5.2 and 6.1 for X25519, and for GCM test case 14 of the GCM specification plus a 16 byte
+/// nonce as Sec2 uses it, whose J0 goes through GHASH. That one was computed independently.
+///
+/// Build with optimizations, e.g. `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release`, then run
+/// `build/espprov-cipher-bench [iterations]`. `build/espprov-cipher-bench --check` instead runs the checks
+/// and exits with 1 if one fails; ctest runs it that way.
+///
+
+#include "BenchMode.hpp"
+#include "KnownAnswer.hpp"
+#include "crypto/AesCtr.hpp"
+#include "crypto/AesGcm.hpp"
+#include "crypto/Random.hpp"
+#include "crypto/Sha256.hpp"
+#include "crypto/X25519.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+using namespace espprov;
+using namespace espprov::crypto;
+
+namespace {
+  constexpr Aes256::Implementation IMPLEMENTATIONS[] = {Aes256::Implementation::PORTABLE, Aes256::Implementation::AES_NI,
+                                                       Aes256::Implementation::ARMV8_CE};
+
+  // Keeps the optimizer from discarding results
+  volatile uint8_t sink = 0;
+  int failures = 0;
+
+  double measure(int iterations, const std::function<void()>& body) {
+    body(); // warm up
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      body();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+  }
+
+  // pragma MARK: Known answers
+
+  constexpr std::string_view AES_KEY = "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f";
+  constexpr std::string_view AES_PLAIN = "00112233445566778899aabbccddeeff";
+  constexpr std::string_view AES_CIPHER = "8ea2b7ca516745bfeafc49904b496089";
+  constexpr std::string_view CTR_KEY = "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4";
+  constexpr std::string_view CTR_COUNTER = "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+  constexpr std::string_view CTR_PLAIN =
+      "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52ef"
+      "f69f2445df4f9b17ad2b417be66c3710";
+  constexpr std::string_view CTR_CIPHER =
+      "601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c52b0930daa23de94ce87017ba2d84988d"
+      "dfc9c58db67aada613c2dd08457941a6";
+  constexpr std::string_view GCM_ZERO_SEALED = "cea7403d4d606b6e074ec5d3baf39d18d0d1c8a799996bf0265b98b5d48ab919";
+  constexpr std::string_view GCM_KEY = "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f";
+  constexpr std::string_view GCM_NONCE = "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf";
+  constexpr std::string_view GCM_PLAIN =
+      "030a11181f262d343b424950575e656c737a81888f969da4abb2b9c0c7ced5dce3eaf1f8ff060d141b222930373e454c"
+      "535a61686f767d848b9299a0a7";
+  constexpr std::string_view GCM_SEALED =
+      "29a932a407ebe042f8dc56e1ba4ae8fcf13fc2f1f1a2cc0856a0d376defbf35bef7b179b6ad5b2a9f52b19922f7cf2bc"
+      "4960c60abb73d0a56dabe7c406a12137d1903cfa9e6e421efe98c52d6c";
+  constexpr std::string_view X25519_ALICE_PRIVATE = "77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a";
+  constexpr std::string_view X25519_ALICE_PUBLIC = "8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a";
+  constexpr std::string_view X25519_BOB_PRIVATE = "5dab087e624a8a4b79e17f8b83800ee66f3bb1292618b6fd1c2f8b27ff88e0eb";
+  constexpr std::string_view X25519_BOB_PUBLIC = "de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f";
+  constexpr std::string_view X25519_SHARED = "4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742";
+  constexpr std::string_view X25519_ONE_ITERATION = "422c8e7a6227d7bca1350b3e2bb7279f7897b87bb6854b783c60e80311ae3079";
+  constexpr std::string_view X25519_THOUSAND_ITERATIONS = "684cf59ba83309552800ef566f2f4d3c1c3887c49360e3875f2eb94d99532c51";
+  constexpr std::string_view SHA256_ABC = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+
+  void expect(const std::string& what, ByteView actual, std::string_view expected) {
+    if (!bench::expectBytes(what.c_str(), actual, expected)) {
+      failures++;
+    }
+  }
+
+  void checkAes(Aes256::Implementation implementation) {
+    std::string name = Aes256::implementationName(implementation);
+    Aes256 aes(bench::fromHex(AES_KEY), implementation);
+    Aes256::Block plain;
+    Bytes plainBytes = bench::fromHex(AES_PLAIN);
+    std::copy(plainBytes.begin(), plainBytes.end(), plain.begin());
+    expect("AES-256 block, " + name, aes.encryptBlock(plain), AES_CIPHER);
+    // Enough blocks for every lane of the interleaved paths, and a tail
+    Aes256::Block blocks[11];
+    std::fill(std::begin(blocks), std::end(blocks), plain);
+    aes.encryptBlocks(blocks, blocks, 11);
+    Bytes encrypted;
+    for (const Aes256::Block& block : blocks) {
+      encrypted.insert(encrypted.end(), block.begin(), block.end());
+    }
+    std::string repeated;
+    for (int i = 0; i < 11; i++) {
+      repeated += AES_CIPHER;
+    }
+    expect("AES-256 blocks, " + name, encrypted, repeated);
+
+    Bytes ctrPlain = bench::fromHex(CTR_PLAIN);
+    expect("AES-256-CTR, " + name, AesCtr(bench::fromHex(CTR_KEY), bench::fromHex(CTR_COUNTER), implementation).apply(ctrPlain),
+           CTR_CIPHER);
+    // Pieces that start and end inside a key stream block
+    AesCtr pieces(bench::fromHex(CTR_KEY), bench::fromHex(CTR_COUNTER), implementation);
+    Bytes output(ctrPlain.size());
+    size_t offset = 0;
+    for (size_t length : {1, 15, 17, 31}) {
+      pieces.apply(ByteView(ctrPlain).subspan(offset, length), output.data() + offset);
+      offset += length;
+    }
+    expect("AES-256-CTR in pieces, " + name, output, CTR_CIPHER);
+
+    AesGcm zero(Bytes(Aes256::KEY_SIZE, 0), implementation);
+    expect("AES-256-GCM, 12 byte nonce, " + name, zero.seal(Bytes(12, 0), Bytes(16, 0)), GCM_ZERO_SEALED);
+    AesGcm gcm(bench::fromHex(GCM_KEY), implementation);
+    Bytes nonce = bench::fromHex(GCM_NONCE);
+    Bytes sealed = gcm.seal(nonce, bench::fromHex(GCM_PLAIN));
+    expect("AES-256-GCM, 16 byte nonce, " + name, sealed, GCM_SEALED);
+    std::optional<Bytes> opened = gcm.open(nonce, sealed);
+    expect("AES-256-GCM open, " + name, opened.value_or(Bytes()), GCM_PLAIN);
+    sealed.back() ^= 0x01;
+    if (gcm.open(nonce, sealed).has_value()) {
+      std::fprintf(stderr, "check failed: AES-256-GCM accepted a corrupted tag, %s\n", name.c_str());
+      failures++;
+    }
+  }
+
+  X25519::Key toKey(std::string_view hex) {
+    Bytes bytes = bench::fromHex(hex);
+    X25519::Key key;
+    std::copy(bytes.begin(), bytes.end(), key.begin());
+    return key;
+  }
+
+  void checkX25519() {
+    X25519::Key alice = toKey(X25519_ALICE_PRIVATE);
+    X25519::Key bob = toKey(X25519_BOB_PRIVATE);
+    expect("X25519 public key of Alice", X25519::publicKey(alice), X25519_ALICE_PUBLIC);
+    expect("X25519 public key of Bob", X25519::publicKey(bob), X25519_BOB_PUBLIC);
+    expect("X25519 shared secret of Alice", X25519::scalarMult(alice, toKey(X25519_BOB_PUBLIC)), X25519_SHARED);
+    expect("X25519 shared secret of Bob", X25519::scalarMult(bob, toKey(X25519_ALICE_PUBLIC)), X25519_SHARED);
+
+    // k = X25519(k, u), u = the previous k, both starting at the base point
+    X25519::Key k{9};
+    X25519::Key u{9};
+    for (int i = 1; i <= 1000; i++) {
+      X25519::Key next = X25519::scalarMult(k, u);
+      u = k;
+      k = next;
+      if (i == 1) {
+        expect("X25519 after 1 iteration", k, X25519_ONE_ITERATION);
+      }
+    }
+    expect("X25519 after 1000 iterations", k, X25519_THOUSAND_ITERATIONS);
+
+    expect("SHA-256 of \"abc\"", Sha256::hash(asBytes("abc")), SHA256_ABC);
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  bool checkOnly = bench::takeCheckFlag(argc, argv);
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+  if (iterations <= 0 || (checkOnly && argc > 1)) {
+    std::fprintf(stderr, "usage: %s [--check | iterations]\n", argv[0]);
+    return 1;
+  }
+
+  if (checkOnly) {
+    for (Aes256::Implementation implementation : IMPLEMENTATIONS) {
+      if (Aes256::isSupported(implementation)) {
+        checkAes(implementation);
+        std::printf("checked the %s AES path\n", Aes256::implementationName(implementation));
+      }
+    }
+    checkX25519();
+    if (failures > 0) {
+      std::fprintf(stderr, "%d checks failed\n", failures);
+      return 1;
+    }
+    std::printf("AES, X25519 and SHA-256 agree with the known answers\n");
+    return 0;
+  }
+
+  Bytes key = randomBytes(Aes256::KEY_SIZE);
+  Bytes iv = randomBytes(Aes256::BLOCK_SIZE);
+  std::printf("%d iterations, fastest AES path: %s\n\n", iterations,
+              Aes256::implementationName(Aes256::fastestImplementation()));
+
+  // A config message, a Wi-Fi scan page, and a large custom endpoint payload
+  const size_t sizes[] = {64, 1024, 16384};
+  std::printf("%-10s %-10s %14s %14s\n", "path", "bytes", "CTR MB/s", "GCM MB/s");
+  for (Aes256::Implementation implementation : IMPLEMENTATIONS) {
+    if (!Aes256::isSupported(implementation)) {
+      continue;
+    }
+    for (size_t size : sizes) {
+      Bytes message = randomBytes(size);
+      Bytes output(size);
+      AesCtr ctr(key, iv, implementation);
+      AesGcm gcm(key, implementation);
+      double ctrMicros = measure(iterations, [&] {
+        ctr.apply(message, output.data());
+        sink = sink ^ output[0];
+      });
+      double gcmMicros = measure(iterations, [&] { sink = sink ^ gcm.seal(iv, message)[0]; });
+      std::printf("%-10s %-10zu %14.1f %14.1f\n", Aes256::implementationName(implementation), size, size / ctrMicros,
+                  size / gcmMicros);
+    }
+  }
+
+  X25519::Key privateKey = X25519::generatePrivateKey();
+  X25519::Key peer = X25519::publicKey(X25519::generatePrivateKey());
+  std::printf("\n%-36s %10.1f us\n", "X25519 shared secret", measure(iterations / 10 + 1, [&] {
+                sink = sink ^ X25519::scalarMult(privateKey, peer)[0];
+              }));
+  std::printf("%-36s %10.1f us\n", "SHA-256 (PoP)", measure(iterations, [&] {
+                sink = sink ^ Sha256::hash(asBytes("abcd1234"))[0];
+              }));
+  return 0;
+}
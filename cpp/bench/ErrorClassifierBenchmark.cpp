@@ -0,0 +1,117 @@
+///
+/// ErrorClassifierBenchmark.cpp
+/// Compares the error classifier's speed with the substring scan it replaces, and checks that the two agree.
+///
+/// The baseline is what `PTExtendedError.fromDescription` did: lowercase the message, then test
+/// every pattern with a substring search until one matches.
+///
+/// Build with optimizations, e.g. `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release`, then run
+/// `build/espprov-errors-bench [iterations]`. `--check` instead compares their classifications and exits with 1 if they
+/// disagree on a message; ctest runs it that way.
+///
+
+#include "BenchMode.hpp"
+#include "core/ErrorClassifier.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <string>
+
+using namespace espprov;
+
+namespace {
+  // Keeps the optimizer from discarding results
+  volatile size_t sink = 0;
+
+  std::string lowercase(std::string_view text) {
+    std::string lower(text);
+    for (char& ch : lower) {
+      if (ch >= 'A' && ch <= 'Z') {
+        ch = static_cast<char>(ch - 'A' + 'a');
+      }
+    }
+    return lower;
+  }
+
+  std::optional<ErrorCode> scanSubstrings(std::string_view message) {
+    std::string lower = lowercase(message);
+    for (const ErrorPattern& pattern : errorPatterns()) {
+      if (lower.find(lowercase(pattern.text)) != std::string::npos) {
+        return pattern.code;
+      }
+    }
+    return std::nullopt;
+  }
+
+  const std::string messages[] = {
+      "java.lang.RuntimeException: Write to BLE failed",
+      "SESSION ESTABLISHMENT FAILED ! status=133",
+      "com.nimbusds.srp6.SRP6Exception: Bad server credentials",
+      "Provisioning failed after 3 attempts: failed to apply wifi credentials",
+      "android.bluetooth.BluetoothGatt: onClientConnectionState() - status=8 clientIf=7 device=24:0A:C4:00:10:01",
+      "",
+  };
+
+  int checkClassifications(const ErrorClassifier& classifier) {
+    int failures = 0;
+    for (const std::string& message : messages) {
+      if (classifier.classify(message) != scanSubstrings(message)) {
+        std::fprintf(stderr, "classification differs: \"%s\"\n", message.c_str());
+        failures++;
+      }
+    }
+    for (const ErrorPattern& pattern : errorPatterns()) {
+      std::string message = "prefix " + lowercase(pattern.text) + " suffix";
+      if (classifier.classify(message) != scanSubstrings(message)) {
+        std::fprintf(stderr, "classification differs: \"%s\"\n", message.c_str());
+        failures++;
+      }
+    }
+    if (classifier.classify("Write to BLE failed", static_cast<int>(ErrorCode::NO_POP)) != ErrorCode::NO_POP ||
+        classifier.classify("Write to BLE failed", 9999) != ErrorCode::BLE_FAILED_TO_CONNECT) {
+      std::fprintf(stderr, "SDK codes are not preferred over the message\n");
+      failures++;
+    }
+    return failures;
+  }
+
+  double measure(int iterations, const std::function<void()>& body) {
+    body(); // warm up
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      body();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  bool checkOnly = bench::takeCheckFlag(argc, argv);
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+  if (iterations <= 0) {
+    std::fprintf(stderr, "usage: %s [--check] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  const ErrorClassifier& classifier = ErrorClassifier::shared();
+  if (checkOnly) {
+    if (checkClassifications(classifier) > 0) {
+      return 1;
+    }
+    std::printf("classifications agree\n");
+    return 0;
+  }
+
+  std::printf("%d iterations\n\n", iterations);
+  std::printf("%-12s %14s %14s\n", "message #", "substrings ns", "automaton ns");
+  for (size_t i = 0; i < std::size(messages); i++) {
+    const std::string& message = messages[i];
+    double substrings = measure(iterations, [&] { sink = sink + scanSubstrings(message).has_value(); });
+    double automaton = measure(iterations, [&] { sink = sink + classifier.classify(message).has_value(); });
+    std::printf("%-12zu %14.1f %14.1f\n", i, substrings, automaton);
+  }
+  return 0;
+}
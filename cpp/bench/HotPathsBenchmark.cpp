@@ -0,0 +1,229 @@
+///
+/// HotPathsBenchmark.cpp
+/// Google Benchmark suite of the CPU bound parts of a provisioning run: the Sec1/Sec2 client
+/// handshakes and message crypto, the scan and config protobuf codecs, base64 for string custom
+/// endpoint payloads, and error classification.
+///
+/// Build and run with `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release && cmake --build build --target bench`,
+/// which writes `build/bench.json`. Compare two builds with Google Benchmark's `tools/compare.py
+/// benchmarks old.json new.json`. `build/espprov-gbench` takes the usual `--benchmark_*` flags.
+///
+
+#include "core/Base64.hpp"
+#include "core/ErrorClassifier.hpp"
+#include "proto/Messages.hpp"
+#include "security/Security.hpp"
+#include "sim/DeviceSecurity.hpp"
+#include <array>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+
+using namespace espprov;
+using namespace espprov::proto;
+
+namespace {
+  constexpr const char* PROOF_OF_POSSESSION = "abcd1234";
+  constexpr const char* USERNAME = "wifiprov";
+
+  /**
+   * A client and device security pair of `scheme`, with the handshake done.
+   */
+  struct Session {
+    std::unique_ptr<Security> client;
+    std::unique_ptr<sim::DeviceSecurity> device;
+  };
+
+  Session establish(SecurityScheme scheme) {
+    Session session{
+        .client = makeSecurity(scheme, {.proofOfPossession = PROOF_OF_POSSESSION, .username = USERNAME}),
+        .device = sim::makeDeviceSecurity(scheme, PROOF_OF_POSSESSION, USERNAME),
+    };
+    session.client->handshake([&](const SessionData& request) { return session.device->handle(request); });
+    return session;
+  }
+
+  /**
+   * Times the client side of the handshake only. The device's replies, OpenSSL in the simulator,
+   * run with the clock paused.
+   */
+  void handshake(benchmark::State& state, SecurityScheme scheme) {
+    auto device = sim::makeDeviceSecurity(scheme, PROOF_OF_POSSESSION, USERNAME);
+    for (auto _ : state) {
+      auto client = makeSecurity(scheme, {.proofOfPossession = PROOF_OF_POSSESSION, .username = USERNAME});
+      client->handshake([&](const SessionData& request) {
+        state.PauseTiming();
+        SessionData response = device->handle(request);
+        state.ResumeTiming();
+        return response;
+      });
+      benchmark::DoNotOptimize(client);
+    }
+  }
+
+  void encrypt(benchmark::State& state, SecurityScheme scheme) {
+    Session session = establish(scheme);
+    Bytes plain(static_cast<size_t>(state.range(0)), 0x5a);
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(session.client->encrypt(plain));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+  }
+
+  void decrypt(benchmark::State& state, SecurityScheme scheme) {
+    Session session = establish(scheme);
+    // Sec2 keeps one nonce per session and Sec1 is a stream cipher, so one response decrypts every time
+    Bytes cipher = session.device->encrypt(Bytes(static_cast<size_t>(state.range(0)), 0x5a));
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(session.client->decrypt(cipher));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+  }
+
+  Bytes scanPage(size_t entries) {
+    const char* ssids[] = {"espressif", "Home Network 5G", "guest", "a-rather-long-ssid-of-32-bytes!!"};
+    RespScanResult page;
+    for (size_t i = 0; i < entries; i++) {
+      page.entries.push_back(WiFiScanResult{
+          .ssid = toBytes(ssids[i % 4]),
+          .channel = static_cast<uint32_t>(1 + i % 13),
+          .rssi = -40 - static_cast<int32_t>(i % 50),
+          .bssid = Bytes{0x24, 0x0a, 0xc4, 0x00, 0x10, static_cast<uint8_t>(i)},
+          .auth = static_cast<WifiAuthMode>(i % 8),
+      });
+    }
+    return encodeRespScanResult(page);
+  }
+
+  // pragma MARK: Session crypto
+
+  void BM_Sec1Handshake(benchmark::State& state) {
+    handshake(state, SecurityScheme::SEC1);
+  }
+
+  void BM_Sec2Handshake(benchmark::State& state) {
+    handshake(state, SecurityScheme::SEC2);
+  }
+
+  void BM_Sec1Encrypt(benchmark::State& state) {
+    encrypt(state, SecurityScheme::SEC1);
+  }
+
+  void BM_Sec1Decrypt(benchmark::State& state) {
+    decrypt(state, SecurityScheme::SEC1);
+  }
+
+  void BM_Sec2Encrypt(benchmark::State& state) {
+    encrypt(state, SecurityScheme::SEC2);
+  }
+
+  void BM_Sec2Decrypt(benchmark::State& state) {
+    decrypt(state, SecurityScheme::SEC2);
+  }
+
+  // pragma MARK: Protobuf
+
+  void BM_EncodeScanResultCommand(benchmark::State& state) {
+    std::array<uint8_t, 64> command;
+    std::array<uint8_t, 64> payload;
+    for (auto _ : state) {
+      size_t size = encodeInto(CmdScanResult{.startIndex = 0, .count = 4}, command);
+      WiFiScanPayloadView scan{.msg = WiFiScanMsgType::TYPE_CMD_SCAN_RESULT, .status = Status::SUCCESS,
+                               .body = ByteView(command).first(size)};
+      benchmark::DoNotOptimize(encodeInto(scan, payload));
+    }
+  }
+
+  void BM_DecodeScanResults(benchmark::State& state) {
+    Bytes page = scanPage(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+      ScanResultReader reader(page);
+      WiFiScanResultView entry;
+      while (reader.next(entry)) {
+        benchmark::DoNotOptimize(entry);
+      }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+  }
+
+  void BM_EncodeSetConfig(benchmark::State& state) {
+    std::array<uint8_t, 256> command;
+    std::array<uint8_t, 256> payload;
+    CmdSetConfigView config{.ssid = asBytes("Home Network 5G"), .passphrase = asBytes("correct horse battery"), .bssid = {}, .channel = -1};
+    for (auto _ : state) {
+      size_t size = encodeInto(config, command);
+      WiFiConfigPayloadView message{.msg = WiFiConfigMsgType::TYPE_CMD_SET_CONFIG, .body = ByteView(command).first(size)};
+      benchmark::DoNotOptimize(encodeInto(message, payload));
+    }
+  }
+
+  void BM_DecodeGetStatus(benchmark::State& state) {
+    RespGetStatus status;
+    status.staState = WifiStationState::CONNECTED;
+    status.connected = WifiConnectedState{
+        .ip4Addr = "192.168.4.23",
+        .authMode = WifiAuthMode::WPA2_PSK,
+        .ssid = toBytes("Home Network 5G"),
+        .bssid = Bytes{0x24, 0x0a, 0xc4, 0x00, 0x10, 0x01},
+        .channel = 6,
+    };
+    Bytes encoded = encodeRespGetStatus(status);
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(decodeRespGetStatusView(encoded));
+    }
+  }
+
+  // pragma MARK: Base64
+
+  void BM_Base64Encode(benchmark::State& state) {
+    Bytes payload(static_cast<size_t>(state.range(0)), 0xa5);
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(encodeBase64(payload));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+  }
+
+  void BM_Base64Decode(benchmark::State& state) {
+    std::string encoded = encodeBase64(Bytes(static_cast<size_t>(state.range(0)), 0xa5));
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(decodeBase64(encoded));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+  }
+
+  // pragma MARK: Error classification
+
+  void BM_ClassifyKnownError(benchmark::State& state) {
+    const ErrorClassifier& classifier = ErrorClassifier::shared();
+    std::string message = "com.nimbusds.srp6.SRP6Exception: Bad server credentials";
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(classifier.classify(message));
+    }
+  }
+
+  void BM_ClassifyUnknownError(benchmark::State& state) {
+    const ErrorClassifier& classifier = ErrorClassifier::shared();
+    std::string message = "android.bluetooth.BluetoothGatt: onClientConnectionState() - status=8 clientIf=7 device=24:0A:C4:00:10:01";
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(classifier.classify(message));
+    }
+  }
+} // namespace
+
+BENCHMARK(BM_Sec1Handshake)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Sec2Handshake)->Unit(benchmark::kMillisecond);
+// A config message, a scan page and a large custom endpoint payload
+BENCHMARK(BM_Sec1Encrypt)->Arg(64)->Arg(256)->Arg(4096);
+BENCHMARK(BM_Sec1Decrypt)->Arg(64)->Arg(256)->Arg(4096);
+BENCHMARK(BM_Sec2Encrypt)->Arg(64)->Arg(256)->Arg(4096);
+BENCHMARK(BM_Sec2Decrypt)->Arg(64)->Arg(256)->Arg(4096);
+BENCHMARK(BM_EncodeScanResultCommand);
+BENCHMARK(BM_DecodeScanResults)->Arg(4)->Arg(16);
+BENCHMARK(BM_EncodeSetConfig);
+BENCHMARK(BM_DecodeGetStatus);
+BENCHMARK(BM_Base64Encode)->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK(BM_Base64Decode)->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK(BM_ClassifyKnownError);
+BENCHMARK(BM_ClassifyUnknownError);
+
+BENCHMARK_MAIN();
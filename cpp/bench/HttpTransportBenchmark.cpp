@@ -0,0 +1,237 @@
+///
+/// HttpTransportBenchmark.cpp
+/// Compares whole provisioning runs over the keep-alive SoftAP transport with runs that open one
+/// connection per message, phase by phase, and checks the transport against the loopback device.
+///
+/// The baseline is `sim::LoopbackTransport`, which posts every message on a fresh `Connection:
+/// close` request like the platform HTTP stacks. The server adds `connect-latency-ms` once per
+/// TCP connection to stand in for connection setup on a congested SoftAP.
+///
+/// Build with `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release`, then run
+/// `build/espprov-http-bench [runs] [connect-latency-ms]`. `--check` instead runs the checks and one
+/// run over each transport, and exits with 1 if one fails; ctest runs it that way.
+///
+
+#include "BenchMode.hpp"
+#include "core/Errors.hpp"
+#include "core/HttpTransport.hpp"
+#include "core/ProtocommEngine.hpp"
+#include "sim/LoopbackHttpServer.hpp"
+#include "sim/LoopbackTransport.hpp"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+using namespace espprov;
+
+namespace {
+  int failures = 0;
+
+  void check(bool condition, const char* what) {
+    if (!condition) {
+      std::fprintf(stderr, "check failed: %s\n", what);
+      failures++;
+    }
+  }
+
+  std::shared_ptr<sim::SimulatedDevice> makeDevice() {
+    sim::SimulatedDeviceConfig config;
+    config.security = SecurityScheme::SEC1;
+    return std::make_shared<sim::SimulatedDevice>(config);
+  }
+
+  struct Run {
+    double millis;
+    uint64_t connections;
+    /// Milliseconds per phase, indexed by `Phase`.
+    std::array<double, PHASE_COUNT> phases{};
+    bool scanned = false;
+    bool echoed = false;
+    /// Whether the run recorded every engine phase in order.
+    bool complete = false;
+  };
+
+  /// The phases a run records, in order.
+  constexpr std::array<Phase, 7> ENGINE_PHASES = {Phase::CONNECT,     Phase::VERSION_INFO, Phase::HANDSHAKE,  Phase::SCAN,
+                                                  Phase::CONFIG_SEND, Phase::APPLY,        Phase::STATUS_WAIT};
+
+  constexpr const char* phaseLabel(Phase phase) {
+    switch (phase) {
+      case Phase::SEARCH:
+        return "search";
+      case Phase::CREATE:
+        return "create";
+      case Phase::CONNECT:
+        return "connect";
+      case Phase::VERSION_INFO:
+        return "version info";
+      case Phase::HANDSHAKE:
+        return "handshake";
+      case Phase::SCAN:
+        return "scan";
+      case Phase::CONFIG_SEND:
+        return "config send";
+      case Phase::APPLY:
+        return "apply";
+      case Phase::STATUS_WAIT:
+        return "status wait";
+    }
+    return "?";
+  }
+
+  /**
+   * Session, scan, provisioning and a custom endpoint call, the messages of a typical SoftAP run.
+   */
+  Run provision(const ProtocommEngine::TransportFactory& factory, const sim::LoopbackHttpServer& server) {
+    Timeouts timeouts;
+    timeouts.statusPoll = {.first = std::chrono::milliseconds(1), .backoff = 1, .max = std::chrono::milliseconds(1)};
+    ProtocommEngine engine(factory, timeouts);
+    engine.configureDevice({
+        .name = "softap",
+        .transport = TransportKind::SOFTAP,
+        .security = SecurityScheme::SEC1,
+        .securityParams = {.proofOfPossession = "abcd1234", .username = std::nullopt},
+    });
+
+    uint64_t connectionsBefore = server.connectionCount();
+    auto start = std::chrono::steady_clock::now();
+    engine.connect("softap");
+    bool scanned = !engine.scanWifi("softap", true).empty();
+    engine.provision("softap", "HomeNetwork", "password123");
+    bool echoed = asString(engine.sendData("softap", "custom-data", asBytes("ping"))) == "ping";
+    engine.disconnect("softap");
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    Run run{elapsed.count(), server.connectionCount() - connectionsBefore};
+    run.scanned = scanned;
+    run.echoed = echoed;
+
+    std::vector<PhaseSpan> spans = engine.runTimings("softap");
+    run.complete = spans.size() == ENGINE_PHASES.size();
+    for (size_t i = 0; run.complete && i < spans.size(); i++) {
+      run.complete = spans[i].phase == ENGINE_PHASES[i] && !spans[i].failed && (i == 0 || spans[i].start >= spans[i - 1].start);
+      run.phases[static_cast<size_t>(spans[i].phase)] = std::chrono::duration<double, std::milli>(spans[i].duration).count();
+    }
+    return run;
+  }
+
+  void checkRun(const Run& run, bool keepAlive) {
+    check(run.scanned, "scan returns networks");
+    check(run.echoed, "custom endpoint echoes");
+    check(run.complete, "a run records every engine phase in order");
+    check(!keepAlive || run.connections == 1, "one connection per keep-alive run");
+  }
+
+  void checkDeadlines() {
+    auto device = makeDevice();
+    sim::LoopbackHttpServer slow(device, {.latency = std::chrono::milliseconds(300)});
+    HttpTransport transport("127.0.0.1", slow.port());
+    transport.connect(std::chrono::milliseconds(1000));
+    check(transport.connectionCount() == 1, "connect opens the connection");
+
+    auto start = std::chrono::steady_clock::now();
+    bool timedOut = false;
+    try {
+      transport.exchange("proto-ver", asBytes("ESP"), std::chrono::milliseconds(50));
+    } catch (const ProtocommError& e) {
+      timedOut = e.code() == ErrorCode::SESSION_SEND_DATA_ERROR;
+    }
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    check(timedOut && waited < std::chrono::milliseconds(250), "exchange gives up at its deadline");
+
+    // The timed out connection may still carry the late reply, so it is replaced
+    Bytes version = transport.exchange("proto-ver", asBytes("ESP"), std::chrono::milliseconds(1000));
+    check(!version.empty() && transport.connectionCount() == 2, "exchange reconnects after a timeout");
+    transport.exchange("proto-ver", asBytes("ESP"), std::chrono::milliseconds(1000));
+    check(transport.connectionCount() == 2, "exchanges reuse the connection");
+
+    transport.disconnect();
+    bool refused = false;
+    try {
+      transport.exchange("proto-ver", asBytes("ESP"), std::chrono::milliseconds(100));
+    } catch (const ProtocommError& e) {
+      refused = e.code() == ErrorCode::SESSION_NOT_ESTABLISHED;
+    }
+    check(refused, "exchange requires connect");
+  }
+
+  void checkRunTimings() {
+    RunTimings timings;
+    for (Phase phase : ENGINE_PHASES) {
+      PhaseTimer timer(&timings, phase);
+    }
+    try {
+      PhaseTimer timer(&timings, Phase::HANDSHAKE);
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "handshake");
+    } catch (const ProtocommError&) {
+    }
+    std::vector<PhaseSpan> spans = timings.spans();
+    check(spans.size() == 3 && spans.back().phase == Phase::HANDSHAKE, "a phase drops the later spans of the run");
+    check(!spans.empty() && spans.back().failed && !spans.front().failed, "a phase left by an exception is failed");
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  bool checkOnly = bench::takeCheckFlag(argc, argv);
+  int runs = argc > 1 ? std::atoi(argv[1]) : 10;
+  int connectLatency = argc > 2 ? std::atoi(argv[2]) : 20;
+  if (runs <= 0 || connectLatency < 0) {
+    std::fprintf(stderr, "usage: %s [--check] [runs] [connect-latency-ms]\n", argv[0]);
+    return 1;
+  }
+
+  auto device = makeDevice();
+  sim::LoopbackHttpServer server(device, {.connectLatency = std::chrono::milliseconds(connectLatency)});
+  ProtocommEngine::TransportFactory perMessage = [&](const DeviceConfig&) {
+    return std::make_unique<sim::LoopbackTransport>("127.0.0.1", server.port());
+  };
+  ProtocommEngine::TransportFactory keepAlive = [&](const DeviceConfig&) {
+    return std::make_unique<HttpTransport>("127.0.0.1", server.port());
+  };
+
+  Run baseline{0, 0};
+  Run persistent{0, 0};
+  auto add = [](Run& total, const Run& run) {
+    total.millis += run.millis;
+    total.connections += run.connections;
+    for (size_t phase = 0; phase < PHASE_COUNT; phase++) {
+      total.phases[phase] += run.phases[phase];
+    }
+  };
+  try {
+    if (checkOnly) {
+      checkDeadlines();
+      checkRunTimings();
+      checkRun(provision(perMessage, server), false);
+      checkRun(provision(keepAlive, server), true);
+      if (failures > 0) {
+        return 1;
+      }
+      std::printf("checks passed\n");
+      return 0;
+    }
+
+    for (int i = 0; i < runs; i++) {
+      add(baseline, provision(perMessage, server));
+      add(persistent, provision(keepAlive, server));
+    }
+  } catch (const ProtocommError& e) {
+    std::fprintf(stderr, "provisioning failed: %s\n", e.what());
+    return 1;
+  }
+
+  std::printf("%d runs, %d ms per TCP connection\n\n", runs, connectLatency);
+  std::printf("%-24s %12s %16s\n", "transport", "ms per run", "connections/run");
+  std::printf("%-24s %12.1f %16.1f\n", "connection per message", baseline.millis / runs,
+              static_cast<double>(baseline.connections) / runs);
+  std::printf("%-24s %12.1f %16.1f\n", "keep-alive", persistent.millis / runs, static_cast<double>(persistent.connections) / runs);
+
+  std::printf("\n%-24s %12s %16s\n", "phase ms per run", "per message", "keep-alive");
+  for (Phase phase : ENGINE_PHASES) {
+    auto index = static_cast<size_t>(phase);
+    std::printf("%-24s %12.1f %16.1f\n", phaseLabel(phase), baseline.phases[index] / runs, persistent.phases[index] / runs);
+  }
+  return 0;
+}
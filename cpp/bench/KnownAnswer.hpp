@@ -0,0 +1,41 @@
+///
+/// KnownAnswer.hpp
+/// Published test vectors, written down as hex, and the comparison the `--check` modes report through.
+///
+
+#pragma once
+
+#include "core/Bytes.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <string_view>
+
+namespace espprov::bench {
+
+  inline Bytes fromHex(std::string_view hex) {
+    auto nibble = [](char c) -> uint8_t {
+      if (c >= '0' && c <= '9') {
+        return static_cast<uint8_t>(c - '0');
+      }
+      return static_cast<uint8_t>((c | 0x20) - 'a' + 10);
+    };
+    Bytes bytes(hex.size() / 2);
+    for (size_t i = 0; i < bytes.size(); i++) {
+      bytes[i] = static_cast<uint8_t>(nibble(hex[2 * i]) << 4 | nibble(hex[2 * i + 1]));
+    }
+    return bytes;
+  }
+
+  /**
+   * Compares `actual` with the hex `expected` and reports a mismatch under `what`. Returns false on one.
+   */
+  inline bool expectBytes(const char* what, ByteView actual, std::string_view expected) {
+    Bytes wanted = fromHex(expected);
+    if (actual.size() == wanted.size() && std::equal(actual.begin(), actual.end(), wanted.begin())) {
+      return true;
+    }
+    std::fprintf(stderr, "check failed: %s\n", what);
+    return false;
+  }
+
+} // namespace espprov::bench
@@ -0,0 +1,209 @@
+///
+/// MetricsBenchmark.cpp
+/// Measures what recording a latency and taking a metrics snapshot cost, and checks the histograms
+/// against exact percentiles and concurrent snapshots.
+///
+/// Build with `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release`, then run
+/// `build/espprov-metrics-bench [values] [threads]`. `--check` instead runs the checks with the same
+/// arguments and exits with 1 if one fails; ctest runs it that way.
+///
+
+#include "BenchMode.hpp"
+#include "core/LatencyHistogram.hpp"
+#include "core/Metrics.hpp"
+#include "core/RunTimings.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace espprov;
+
+namespace {
+  // Keeps the optimizer from discarding results
+  volatile size_t sink = 0;
+  int failures = 0;
+
+  void check(bool condition, const char* what) {
+    if (!condition) {
+      std::fprintf(stderr, "check failed: %s\n", what);
+      failures++;
+    }
+  }
+
+  /**
+   * BLE round trips and Wi-Fi joins: mostly tens of milliseconds with a long tail.
+   */
+  std::vector<uint64_t> makeLatencies(size_t count) {
+    std::mt19937_64 random(42);
+    std::lognormal_distribution<double> distribution(10.0, 1.2);
+    std::vector<uint64_t> values(count);
+    for (uint64_t& value : values) {
+      value = static_cast<uint64_t>(distribution(random));
+    }
+    return values;
+  }
+
+  void checkBuckets() {
+    bool bounded = true;
+    bool ordered = true;
+    for (uint64_t value = 1; value < LatencyHistogram::MAX_VALUE; value = value * 3 / 2 + 1) {
+      for (uint64_t probe : {value - 1, value, value + 1}) {
+        size_t index = LatencyHistogram::bucketIndex(probe);
+        uint64_t upper = LatencyHistogram::bucketUpperBound(index);
+        bounded &= probe <= upper && (upper - probe) * LatencyHistogram::SUB_BUCKET_COUNT <= probe;
+        ordered &= index == 0 || LatencyHistogram::bucketUpperBound(index - 1) < probe;
+      }
+    }
+    check(bounded, "a bucket bound is at most 1/32 above its values");
+    check(ordered, "every value lands in the first bucket that holds it");
+    check(LatencyHistogram::bucketIndex(UINT64_MAX) == LatencyHistogram::BUCKET_COUNT - 1, "values past the range land in the last bucket");
+  }
+
+  void checkPercentiles(const std::vector<uint64_t>& values) {
+    LatencyHistogram histogram;
+    for (uint64_t value : values) {
+      histogram.record(value);
+    }
+    std::vector<uint64_t> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    LatencyHistogram::Snapshot snapshot = histogram.snapshot();
+    check(snapshot.count == values.size(), "every value is counted");
+    check(snapshot.min == sorted.front() && snapshot.max == sorted.back(), "min and max are exact");
+    for (double quantile : {0.5, 0.9, 0.95, 0.99, 0.999}) {
+      uint64_t exact = sorted[static_cast<size_t>(std::ceil(quantile * static_cast<double>(sorted.size()))) - 1];
+      uint64_t estimate = snapshot.percentile(quantile);
+      check(estimate >= exact && (estimate - exact) * LatencyHistogram::SUB_BUCKET_COUNT <= exact,
+            "a percentile is at most 1/32 above the exact one");
+    }
+  }
+
+  void checkConcurrentReset(size_t perThread, size_t threads) {
+    LatencyHistogram histogram;
+    std::atomic<bool> done{false};
+    uint64_t seen = 0;
+    std::thread reader([&] {
+      while (!done.load()) {
+        seen += histogram.snapshot(true).count;
+      }
+    });
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < threads; t++) {
+      writers.emplace_back([&, t] {
+        for (size_t i = 0; i < perThread; i++) {
+          histogram.record(i + t);
+        }
+      });
+    }
+    for (std::thread& writer : writers) {
+      writer.join();
+    }
+    done = true;
+    reader.join();
+    seen += histogram.snapshot(true).count;
+    check(seen == perThread * threads, "consecutive resetting snapshots neither lose nor repeat values");
+  }
+
+  void checkRegistry() {
+    MetricsRegistry registry;
+    RunTimings timings(&registry);
+    timings.record(PhaseSpan{.phase = Phase::HANDSHAKE, .start = {}, .duration = std::chrono::milliseconds(40), .failed = false});
+    timings.record(PhaseSpan{.phase = Phase::HANDSHAKE, .start = {}, .duration = std::chrono::milliseconds(60), .failed = true});
+    for (size_t i = 0; i < MetricsRegistry::MAX_ENDPOINTS + 5; i++) {
+      registry.recordEndpoint("custom-" + std::to_string(i), std::chrono::milliseconds(5));
+    }
+    registry.countError(ErrorCode::PROV_WIFI_STATUS_AUTH_ERROR);
+    registry.countError(ErrorCode::PROV_WIFI_STATUS_AUTH_ERROR);
+    registry.countError(-1);
+    registry.countError(MetricsRegistry::MAX_ERROR_CODE);
+
+    MetricsSnapshot snapshot = registry.snapshot(true);
+    check(snapshot.phases.size() == 1 && snapshot.phases[0].name == "HANDSHAKE" && snapshot.phases[0].count == 2,
+          "run timings feed their phase");
+    check(!snapshot.phases.empty() && snapshot.phases[0].p50 >= 40000 && snapshot.phases[0].max == 60000, "phase latencies in microseconds");
+    check(snapshot.endpoints.size() == MetricsRegistry::MAX_ENDPOINTS + 1 && snapshot.endpoints.back().name == MetricsRegistry::OTHER_ENDPOINTS &&
+              snapshot.endpoints.back().count == 5,
+          "endpoints past the limit share one histogram");
+    check(snapshot.errors.size() == 1 && snapshot.errors[0].first == static_cast<int>(ErrorCode::PROV_WIFI_STATUS_AUTH_ERROR) &&
+              snapshot.errors[0].second == 2,
+          "errors are counted per code");
+
+    MetricsSnapshot empty = registry.snapshot();
+    check(empty.phases.empty() && empty.endpoints.empty() && empty.errors.empty(), "a resetting snapshot starts the counts over");
+    check(empty.since >= snapshot.since, "a reset moves the start");
+  }
+
+  double nanosPerRecord(LatencyHistogram& histogram, const std::vector<uint64_t>& values, size_t threads) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < threads; t++) {
+      writers.emplace_back([&] {
+        for (uint64_t value : values) {
+          histogram.record(value);
+        }
+      });
+    }
+    for (std::thread& writer : writers) {
+      writer.join();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(values.size());
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  bool checkOnly = bench::takeCheckFlag(argc, argv);
+  int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  int threads = argc > 2 ? std::atoi(argv[2]) : 4;
+  if (count <= 0 || threads <= 0) {
+    std::fprintf(stderr, "usage: %s [--check] [values] [threads]\n", argv[0]);
+    return 1;
+  }
+  std::vector<uint64_t> values = makeLatencies(static_cast<size_t>(count));
+
+  if (checkOnly) {
+    checkBuckets();
+    checkPercentiles(values);
+    checkConcurrentReset(static_cast<size_t>(count) / 4, static_cast<size_t>(threads));
+    checkRegistry();
+    if (failures > 0) {
+      return 1;
+    }
+    std::printf("checks passed, %d values, %d threads\n", count, threads);
+    return 0;
+  }
+
+  LatencyHistogram single;
+  double singleNs = nanosPerRecord(single, values, 1);
+  LatencyHistogram shared;
+  double sharedNs = nanosPerRecord(shared, values, static_cast<size_t>(threads));
+
+  MetricsRegistry registry;
+  for (size_t phase = 0; phase < PHASE_COUNT; phase++) {
+    for (size_t i = 0; i < 1000; i++) {
+      registry.recordPhase(static_cast<Phase>(phase), std::chrono::microseconds(values[i]));
+    }
+  }
+  for (size_t endpoint = 0; endpoint < 8; endpoint++) {
+    registry.recordEndpoint("custom-" + std::to_string(endpoint), std::chrono::microseconds(values[endpoint]));
+  }
+  constexpr int snapshots = 1000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < snapshots; i++) {
+    sink = sink + registry.snapshot().phases.size();
+  }
+  std::chrono::duration<double, std::micro> snapshotUs = (std::chrono::steady_clock::now() - start) / snapshots;
+
+  std::printf("%d values, %d threads\n\n", count, threads);
+  std::printf("%-40s %10.1f ns\n", "record, one thread", singleNs);
+  std::printf("%-40s %10.1f ns\n", "record, all threads on one histogram", sharedNs / static_cast<double>(threads));
+  std::printf("%-40s %10.1f us\n", "registry snapshot, 9 phases, 8 endpoints", snapshotUs.count());
+  std::printf("%-40s %10zu KB\n", "memory per histogram", sizeof(LatencyHistogram) / 1024);
+  return 0;
+}
@@ -0,0 +1,217 @@
+///
+/// ProtoBenchmark.cpp
+/// Compares the throughput and allocations of the view codec with the owning one, and checks that the two round trip.
+///
+/// Build with optimizations, e.g. `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release`, then run
+/// `build/espprov-proto-bench [iterations]`. `--check` instead runs the round trip checks and exits with 1 if one fails;
+/// ctest runs it that way.
+///
+
+#include "AllocationCounter.hpp"
+#include "BenchMode.hpp"
+#include "core/Errors.hpp"
+#include "proto/Messages.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+using namespace espprov;
+using namespace espprov::proto;
+
+namespace {
+  // Keeps the optimizer from discarding results
+  volatile size_t sink = 0;
+  int failures = 0;
+
+  void check(bool condition, const char* what) {
+    if (!condition) {
+      std::fprintf(stderr, "round trip failed: %s\n", what);
+      failures++;
+    }
+  }
+
+  bool equal(ByteView a, ByteView b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+  }
+
+  struct Measurement {
+    double micros;
+    double allocations;
+  };
+
+  Measurement measure(int iterations, const std::function<void()>& body) {
+    body(); // warm up
+    size_t allocationsBefore = bench::allocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      body();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return Measurement{elapsed.count() / iterations, static_cast<double>(bench::allocationCount() - allocationsBefore) / iterations};
+  }
+
+  void report(const char* name, const Measurement& owning, const Measurement& view) {
+    std::printf("%-28s %10.3f %8.1f %10.3f %8.1f\n", name, owning.micros, owning.allocations, view.micros, view.allocations);
+  }
+
+  RespScanResult scanPage() {
+    RespScanResult page;
+    const char* ssids[] = {"espressif", "Home Network 5G", "guest", "a-rather-long-ssid-of-32-bytes!!"};
+    for (int i = 0; i < 4; i++) {
+      page.entries.push_back(WiFiScanResult{
+          .ssid = toBytes(ssids[i]),
+          .channel = static_cast<uint32_t>(1 + 5 * i),
+          .rssi = -40 - 9 * i,
+          .bssid = Bytes{0x24, 0x0a, 0xc4, 0x00, 0x10, static_cast<uint8_t>(i)},
+          .auth = static_cast<WifiAuthMode>(i * 2),
+      });
+    }
+    return page;
+  }
+
+  RespGetStatus connectedStatus() {
+    RespGetStatus status;
+    status.staState = WifiStationState::CONNECTED;
+    status.connected = WifiConnectedState{
+        .ip4Addr = "192.168.4.23",
+        .authMode = WifiAuthMode::WPA2_PSK,
+        .ssid = toBytes("espressif"),
+        .bssid = Bytes{0x24, 0x0a, 0xc4, 0x00, 0x10, 0x01},
+        .channel = 6,
+    };
+    return status;
+  }
+
+  void checkRoundTrips() {
+    // Views decode what the owning encoders (and the device simulator) produce
+    RespScanResult page = scanPage();
+    Bytes encodedPage = encodeRespScanResult(page);
+    ScanResultReader reader(encodedPage);
+    WiFiScanResultView entry;
+    size_t index = 0;
+    for (; reader.next(entry) && index < page.entries.size(); index++) {
+      const WiFiScanResult& expected = page.entries[index];
+      check(equal(entry.ssid, expected.ssid) && equal(entry.bssid, expected.bssid), "scan result ssid/bssid");
+      check(entry.channel == expected.channel && entry.rssi == expected.rssi && entry.auth == expected.auth, "scan result scalars");
+    }
+    check(index == page.entries.size(), "scan result count");
+
+    RespGetStatus status = connectedStatus();
+    status.failReason = WifiConnectFailedReason::NETWORK_NOT_FOUND;
+    Bytes encodedStatus = encodeRespGetStatus(status);
+    RespGetStatusView statusView = decodeRespGetStatusView(encodedStatus);
+    check(statusView.staState == status.staState && statusView.failReason == status.failReason, "status state");
+    check(statusView.connected.has_value() && statusView.connected->ip4Addr == status.connected->ip4Addr &&
+              equal(statusView.connected->ssid, status.connected->ssid) && statusView.connected->channel == status.connected->channel,
+          "status connected state");
+
+    // The owning decoders read what the span encoders write, byte for byte what the owning encoders write
+    std::array<uint8_t, 512> buffer;
+    Bytes body(384, 0xa5);
+    SessionDataView session{.secVer = SecSchemeVersion::SEC_SCHEME_2, .msg = 2, .body = body};
+    size_t size = encodeInto(session, buffer);
+    check(size == encodedSize(session), "session size");
+    check(equal(ByteView(buffer).first(size), encodeSessionData(SessionData{session.secVer, session.msg, body})), "session bytes");
+    SessionData decodedSession = decodeSessionData(ByteView(buffer).first(size));
+    check(decodedSession.secVer == session.secVer && decodedSession.msg == session.msg && decodedSession.body == body, "session");
+
+    CmdScanResult command{.startIndex = 300, .count = 4};
+    size = encodeInto(command, buffer);
+    CmdScanResult decodedCommand = decodeCmdScanResult(ByteView(buffer).first(size));
+    check(size == encodedSize(command), "scan command size");
+    check(decodedCommand.startIndex == 300 && decodedCommand.count == 4, "scan command");
+
+    WiFiScanPayloadView scan{.msg = WiFiScanMsgType::TYPE_CMD_SCAN_RESULT, .status = Status::SUCCESS, .body = ByteView(buffer).first(size)};
+    std::array<uint8_t, 64> scanBuffer;
+    size_t scanSize = encodeInto(scan, scanBuffer);
+    WiFiScanPayload decodedScan = decodeWiFiScanPayload(ByteView(scanBuffer).first(scanSize));
+    check(decodedScan.msg == scan.msg && equal(decodedScan.body, scan.body), "scan payload");
+
+    CmdSetConfigView config{.ssid = asBytes("espressif"), .passphrase = asBytes("correct horse"), .bssid = {}, .channel = -1};
+    size = encodeInto(config, buffer);
+    CmdSetConfig decodedConfig = decodeCmdSetConfig(ByteView(buffer).first(size));
+    check(size == encodedSize(config), "config size");
+    check(equal(decodedConfig.ssid, config.ssid) && equal(decodedConfig.passphrase, config.passphrase) && decodedConfig.channel == -1,
+          "config");
+
+    // Writing past the end of the caller's buffer throws instead of truncating
+    bool threw = false;
+    try {
+      encodeInto(config, MutableByteView(buffer).first(encodedSize(config) - 1));
+    } catch (const ProtocommError&) {
+      threw = true;
+    }
+    check(threw, "overflow detection");
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  bool checkOnly = bench::takeCheckFlag(argc, argv);
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+  if (iterations <= 0) {
+    std::fprintf(stderr, "usage: %s [--check] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  if (checkOnly) {
+    checkRoundTrips();
+    if (failures > 0) {
+      return 1;
+    }
+    std::printf("round trips ok\n");
+    return 0;
+  }
+
+  std::printf("%d iterations\n\n", iterations);
+  std::printf("%-28s %10s %8s %10s %8s\n", "message", "owning us", "allocs", "view us", "allocs");
+
+  Bytes encodedPage = encodeWiFiScanPayload(
+      WiFiScanPayload{.msg = WiFiScanMsgType::TYPE_RESP_SCAN_RESULT, .status = Status::SUCCESS, .body = encodeRespScanResult(scanPage())});
+  report("scan page decode",
+         measure(iterations,
+                 [&] {
+                   WiFiScanPayload payload = decodeWiFiScanPayload(encodedPage);
+                   sink = sink + decodeRespScanResult(payload.body).entries.size();
+                 }),
+         measure(iterations, [&] {
+           ScanResultReader reader(decodeWiFiScanPayloadView(encodedPage).body);
+           WiFiScanResultView entry;
+           while (reader.next(entry)) {
+             sink = sink + entry.ssid.size();
+           }
+         }));
+
+  Bytes encodedStatus = encodeWiFiConfigPayload(
+      WiFiConfigPayload{.msg = WiFiConfigMsgType::TYPE_RESP_GET_STATUS, .body = encodeRespGetStatus(connectedStatus())});
+  report("status poll decode",
+         measure(iterations,
+                 [&] {
+                   WiFiConfigPayload payload = decodeWiFiConfigPayload(encodedStatus);
+                   sink = sink + static_cast<size_t>(decodeRespGetStatus(payload.body).staState);
+                 }),
+         measure(iterations, [&] {
+           RespGetStatusView status = decodeRespGetStatusView(decodeWiFiConfigPayloadView(encodedStatus).body);
+           sink = sink + static_cast<size_t>(status.staState);
+         }));
+
+  CmdScanResult command{.startIndex = 8, .count = 4};
+  std::array<uint8_t, 32> commandBuffer;
+  std::array<uint8_t, 64> payloadBuffer;
+  report("scan page request encode",
+         measure(iterations,
+                 [&] {
+                   WiFiScanPayload payload{
+                       .msg = WiFiScanMsgType::TYPE_CMD_SCAN_RESULT, .status = Status::SUCCESS, .body = encodeCmdScanResult(command)};
+                   sink = sink + encodeWiFiScanPayload(payload).size();
+                 }),
+         measure(iterations, [&] {
+           size_t size = encodeInto(command, commandBuffer);
+           WiFiScanPayloadView payload{
+               .msg = WiFiScanMsgType::TYPE_CMD_SCAN_RESULT, .status = Status::SUCCESS, .body = ByteView(commandBuffer).first(size)};
+           sink = sink + encodeInto(payload, payloadBuffer);
+         }));
+  return 0;
+}
@@ -0,0 +1,143 @@
+///
+/// ScanColumnsBenchmark.cpp
+/// Compares marshalling a Wi-Fi scan as one `PTWifiEntry` per network against the columnar buffer.
+///
+/// The host has no JS runtime, so the JSI side is counted rather than timed: the values and
+/// properties each shape makes `toJSI` create. The native side, building what gets handed to the
+/// converter, is timed and its heap allocations counted.
+///
+/// Build with optimizations, e.g. `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release`, then run
+/// `build/espprov-columns-bench [iterations]`. `--check` instead decodes the columns of each scan size and exits with 1
+/// if they do not match the input; ctest runs it that way.
+///
+
+#include "AllocationCounter.hpp"
+#include "BenchMode.hpp"
+#include "core/WifiScanColumns.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <string>
+
+using namespace espprov;
+
+namespace {
+  // Keeps the optimizer from discarding results
+  volatile size_t sink = 0;
+
+  /// The fields of the Nitro `PTWifiEntry` struct, which the host build cannot include.
+  struct EntryShape {
+    std::string ssid;
+    double rssi;
+    double auth;
+    std::optional<std::string> bssid;
+    std::optional<double> channel;
+  };
+
+  struct Measurement {
+    double micros;
+    double allocations;
+  };
+
+  Measurement measure(int iterations, const std::function<void()>& body) {
+    body(); // warm up
+    size_t allocationsBefore = bench::allocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      body();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return Measurement{elapsed.count() / iterations, static_cast<double>(bench::allocationCount() - allocationsBefore) / iterations};
+  }
+
+  std::vector<WifiNetwork> makeScan(size_t count) {
+    static const char* names[] = {"espressif", "Home Network 5G", "guest", "Büro-WLAN", "a-rather-long-ssid-of-32-bytes!!"};
+    std::vector<WifiNetwork> networks;
+    for (size_t i = 0; i < count; i++) {
+      char bssid[13];
+      std::snprintf(bssid, sizeof(bssid), "240ac4%06x", static_cast<unsigned>(i & 0xffffff));
+      networks.push_back(WifiNetwork{
+          .ssid = std::string(names[i % 5]) + "-" + std::to_string(i),
+          .bssid = bssid,
+          .channel = static_cast<uint32_t>(1 + i % 13),
+          .rssi = -30 - static_cast<int32_t>(i % 60),
+          .auth = static_cast<uint32_t>(i % 8),
+      });
+    }
+    return networks;
+  }
+
+  template <typename T>
+  T load(const Bytes& buffer, size_t offset) {
+    T value;
+    std::memcpy(&value, buffer.data() + offset, sizeof(T));
+    return value;
+  }
+
+  bool columnsMatch(const std::vector<WifiNetwork>& networks, const Bytes& columns) {
+    WifiScanColumnLayout layout = WifiScanColumnLayout::forCount(networks.size());
+    for (size_t i = 0; i < networks.size(); i++) {
+      const WifiNetwork& network = networks[i];
+      uint32_t begin = load<uint32_t>(columns, layout.ssidOffsets + i * 4);
+      uint32_t end = load<uint32_t>(columns, layout.ssidOffsets + (i + 1) * 4);
+      std::string ssid(reinterpret_cast<const char*>(columns.data() + layout.ssids + begin), end - begin);
+      double bssid = load<double>(columns, layout.bssid + i * 8);
+      if (ssid != network.ssid || bssid != static_cast<double>(std::stoull(network.bssid, nullptr, 16)) ||
+          load<uint16_t>(columns, layout.channel + i * 2) != network.channel || load<int8_t>(columns, layout.rssi + i) != network.rssi ||
+          load<uint8_t>(columns, layout.auth + i) != network.auth) {
+        return false;
+      }
+    }
+    return true;
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  bool checkOnly = bench::takeCheckFlag(argc, argv);
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+  if (iterations <= 0) {
+    std::fprintf(stderr, "usage: %s [--check] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  if (checkOnly) {
+    for (size_t count : {0, 1, 4, 20, 60, 200}) {
+      std::vector<WifiNetwork> networks = makeScan(count);
+      if (!columnsMatch(networks, encodeWifiScanColumns(networks))) {
+        std::fprintf(stderr, "columns do not match the scan of %zu networks\n", count);
+        return 1;
+      }
+    }
+    std::printf("columns match\n");
+    return 0;
+  }
+
+  std::printf("%d iterations\n\n", iterations);
+  std::printf("%-9s %12s %8s %10s %12s %8s %10s\n", "networks", "entries us", "allocs", "JS calls", "columns us", "allocs",
+              "JS calls");
+  for (size_t count : {4, 20, 60, 200}) {
+    std::vector<WifiNetwork> networks = makeScan(count);
+    Measurement entries = measure(iterations, [&] {
+      std::vector<EntryShape> shaped;
+      shaped.reserve(networks.size());
+      for (const WifiNetwork& network : networks) {
+        shaped.push_back(EntryShape{network.ssid, static_cast<double>(network.rssi), static_cast<double>(network.auth), network.bssid,
+                                    static_cast<double>(network.channel)});
+      }
+      sink = sink + shaped.size();
+    });
+    Measurement columns = measure(iterations, [&] { sink = sink + encodeWifiScanColumns(networks).size(); });
+
+    // Entries: the result object with its three properties and the array, then per network an
+    // object, two strings, five properties and the array slot.
+    // Columns: the result object with its four properties and the ArrayBuffer.
+    size_t entryCalls = 1 + 3 + 1 + count * (1 + 2 + 5 + 1);
+    size_t columnCalls = 1 + 4 + 1;
+    std::printf("%-9zu %12.2f %8.1f %10zu %12.2f %8.1f %10zu\n", count, entries.micros, entries.allocations, entryCalls, columns.micros,
+                columns.allocations, columnCalls);
+  }
+  return 0;
+}
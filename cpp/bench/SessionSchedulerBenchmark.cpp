@@ -0,0 +1,270 @@
+///
+/// SessionSchedulerBenchmark.cpp
+/// Compares a batch of BLE devices provisioned one at a time with one scheduled at once, and checks
+/// that concurrent sessions respect the link slot and exchange limits and take turns fairly.
+///
+/// The devices are simulated in process behind a fake BLE transport that adds a fixed latency to
+/// every exchange and counts the links and exchanges open at the same time.
+///
+/// Build with `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release`, then run
+/// `build/espprov-sessions-bench [devices] [links] [latency-ms]`. `--check` instead runs the checks
+/// with the same arguments and exits with 1 if one fails; ctest runs it that way.
+///
+
+#include "BenchMode.hpp"
+#include "core/Errors.hpp"
+#include "core/ProtocommEngine.hpp"
+#include "core/SessionScheduler.hpp"
+#include "sim/SimulatedDevice.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace espprov;
+
+namespace {
+  int failures = 0;
+
+  void check(bool condition, const char* what) {
+    if (!condition) {
+      std::fprintf(stderr, "check failed: %s\n", what);
+      failures++;
+    }
+  }
+
+  void raiseTo(std::atomic<size_t>& peak, size_t value) {
+    size_t seen = peak.load();
+    while (value > seen && !peak.compare_exchange_weak(seen, value)) {
+    }
+  }
+
+  struct Radio {
+    std::chrono::milliseconds latency{0};
+    std::atomic<size_t> links{0};
+    std::atomic<size_t> peakLinks{0};
+    std::atomic<size_t> exchanges{0};
+    std::atomic<size_t> peakExchanges{0};
+  };
+
+  /**
+   * Stands in for the platform's GATT link to one simulated device.
+   */
+  class FakeBleTransport final : public Transport {
+  public:
+    FakeBleTransport(std::shared_ptr<sim::SimulatedDevice> device, Radio& radio): _device(std::move(device)), _radio(radio) {}
+
+    void connect(std::chrono::milliseconds) override {
+      if (!_connected) {
+        _connected = true;
+        raiseTo(_radio.peakLinks, ++_radio.links);
+      }
+    }
+
+    Bytes exchange(std::string_view endpoint, ByteView payload, std::chrono::milliseconds) override {
+      raiseTo(_radio.peakExchanges, ++_radio.exchanges);
+      std::this_thread::sleep_for(_radio.latency);
+      _radio.exchanges--;
+      return _device->handle(endpoint, payload);
+    }
+
+    void disconnect() noexcept override {
+      if (_connected) {
+        _connected = false;
+        _radio.links--;
+      }
+    }
+
+    bool isConnected() const noexcept override {
+      return _connected;
+    }
+
+  private:
+    std::shared_ptr<sim::SimulatedDevice> _device;
+    Radio& _radio;
+    bool _connected = false;
+  };
+
+  /**
+   * Calls `task(index)` for every index in `[0, count)` on at most `concurrency` threads, the
+   * calling thread being one of them, and returns once all of them finished.
+   */
+  template <typename Task>
+  void forEachBounded(size_t count, size_t concurrency, const Task& task) {
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+      for (size_t index = next++; index < count; index = next++) {
+        task(index);
+      }
+    };
+
+    size_t helpers = std::min(std::max<size_t>(concurrency, 1), count);
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < helpers; i++) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+
+  void waitUntil(const std::function<bool()>& condition) {
+    while (!condition()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  void checkTurnOrder() {
+    SessionScheduler scheduler({.maxLinks = 4, .maxExchanges = 1});
+    std::vector<char> order;
+    std::mutex orderMutex;
+    auto take = [&](char device) {
+      SessionScheduler::Grant turn = scheduler.acquireTurn(std::chrono::seconds(5));
+      std::lock_guard lock(orderMutex);
+      order.push_back(turn ? device : '!');
+    };
+
+    SessionScheduler::Grant first = scheduler.acquireTurn(std::chrono::seconds(5));
+    std::thread b(take, 'b');
+    waitUntil([&] { return scheduler.queuedTurns() == 1; });
+    std::thread c(take, 'c');
+    waitUntil([&] { return scheduler.queuedTurns() == 2; });
+    // Device a is done with its exchange and queues its next one behind b and c
+    std::thread a([&] {
+      first = SessionScheduler::Grant();
+      take('a');
+    });
+    a.join();
+    b.join();
+    c.join();
+    check(std::string(order.begin(), order.end()) == "bca", "turns are granted first come, first served");
+
+    SessionScheduler::Grant link = scheduler.acquireLink(std::chrono::seconds(1));
+    scheduler.setLimits({.maxLinks = 1, .maxExchanges = 1});
+    auto start = std::chrono::steady_clock::now();
+    check(!scheduler.acquireLink(std::chrono::milliseconds(30)), "a full link queue times out");
+    check(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(30), "the link wait lasts its timeout");
+    check(scheduler.queuedLinks() == 0, "a timed out waiter leaves the queue");
+  }
+
+  struct BatchRun {
+    double millis;
+    size_t provisioned;
+    /// The link slots still taken once every device disconnected.
+    size_t openLinks;
+  };
+
+  /**
+   * Connects, provisions and disconnects every device, `concurrency` of them at once.
+   */
+  BatchRun provisionAll(size_t devices, size_t concurrency, SessionLimits limits, Radio& radio) {
+    Timeouts timeouts;
+    timeouts.statusPoll = {.first = std::chrono::milliseconds(1), .backoff = 1, .max = std::chrono::milliseconds(1)};
+    std::vector<std::shared_ptr<sim::SimulatedDevice>> simulated;
+    sim::SimulatedDeviceConfig config;
+    config.security = SecurityScheme::SEC1;
+    for (size_t i = 0; i < devices; i++) {
+      simulated.push_back(std::make_shared<sim::SimulatedDevice>(config));
+    }
+    ProtocommEngine engine(
+        [&](const DeviceConfig& config) {
+          return std::make_unique<FakeBleTransport>(simulated[std::stoul(config.name.substr(4))], radio);
+        },
+        timeouts);
+    engine.setSessionLimits(limits);
+    for (size_t i = 0; i < devices; i++) {
+      engine.configureDevice({
+          .name = "PROV" + std::to_string(i),
+          .transport = TransportKind::BLE,
+          .security = SecurityScheme::SEC1,
+          .securityParams = {.proofOfPossession = "abcd1234", .username = std::nullopt},
+      });
+    }
+
+    std::atomic<size_t> provisioned{0};
+    auto start = std::chrono::steady_clock::now();
+    forEachBounded(devices, concurrency, [&](size_t index) {
+      std::string name = "PROV" + std::to_string(index);
+      try {
+        engine.connect(name);
+        engine.provision(name, "HomeNetwork", "password123");
+        engine.disconnect(name);
+        provisioned++;
+      } catch (const ProtocommError& e) {
+        std::fprintf(stderr, "%s failed: %s\n", name.c_str(), e.what());
+      }
+    });
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return BatchRun{elapsed.count(), provisioned, engine.sessionScheduler().openLinks()};
+  }
+
+  void checkBatch(const BatchRun& run, size_t devices) {
+    check(run.provisioned == devices, "every device is provisioned");
+    check(run.openLinks == 0, "disconnects give their link slots back");
+  }
+
+  void checkLimits(size_t devices, size_t links, std::chrono::milliseconds latency) {
+    SessionLimits limits{.maxLinks = links, .maxExchanges = links};
+    Radio radio;
+    radio.latency = latency;
+    checkBatch(provisionAll(devices, devices, limits, radio), devices);
+    check(radio.peakLinks <= limits.maxLinks, "links stay within the slot limit");
+    check(radio.peakExchanges <= limits.maxExchanges, "exchanges stay within their limit");
+
+    Radio serialized;
+    serialized.latency = latency;
+    limits.maxExchanges = 1;
+    checkBatch(provisionAll(devices, devices, limits, serialized), devices);
+    check(serialized.peakExchanges == 1, "one exchange at a time on a serialized radio");
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  bool checkOnly = bench::takeCheckFlag(argc, argv);
+  int devices = argc > 1 ? std::atoi(argv[1]) : 12;
+  int links = argc > 2 ? std::atoi(argv[2]) : 4;
+  int latency = argc > 3 ? std::atoi(argv[3]) : 10;
+  if (devices <= 0 || links <= 0 || latency < 0) {
+    std::fprintf(stderr, "usage: %s [--check] [devices] [links] [latency-ms]\n", argv[0]);
+    return 1;
+  }
+
+  if (checkOnly) {
+    checkTurnOrder();
+    checkLimits(static_cast<size_t>(devices), static_cast<size_t>(links), std::chrono::milliseconds(latency));
+    if (failures > 0) {
+      return 1;
+    }
+    std::printf("checks passed, %d devices, %d link slots\n", devices, links);
+    return 0;
+  }
+
+  Radio sequentialRadio;
+  sequentialRadio.latency = std::chrono::milliseconds(latency);
+  BatchRun sequential = provisionAll(static_cast<size_t>(devices), 1, {.maxLinks = 1, .maxExchanges = 1}, sequentialRadio);
+
+  SessionLimits limits{.maxLinks = static_cast<size_t>(links), .maxExchanges = static_cast<size_t>(links)};
+  Radio scheduledRadio;
+  scheduledRadio.latency = std::chrono::milliseconds(latency);
+  // Every device asks at once, the scheduler queues whoever finds no slot
+  BatchRun scheduled = provisionAll(static_cast<size_t>(devices), static_cast<size_t>(devices), limits, scheduledRadio);
+
+  Radio sharedRadio;
+  sharedRadio.latency = std::chrono::milliseconds(latency);
+  limits.maxExchanges = 1;
+  BatchRun shared = provisionAll(static_cast<size_t>(devices), static_cast<size_t>(devices), limits, sharedRadio);
+
+  std::printf("%d devices, %d link slots, %d ms per exchange\n\n", devices, links, latency);
+  std::printf("%-32s %10s %10s\n", "schedule", "total ms", "peak links");
+  std::printf("%-32s %10.0f %10zu\n", "one device at a time", sequential.millis, sequentialRadio.peakLinks.load());
+  std::printf("%-32s %10.0f %10zu\n", "all queued, parallel exchanges", scheduled.millis, scheduledRadio.peakLinks.load());
+  std::printf("%-32s %10.0f %10zu\n", "all queued, one exchange at once", shared.millis, sharedRadio.peakLinks.load());
+  return 0;
+}
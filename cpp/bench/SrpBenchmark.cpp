@@ -0,0 +1,226 @@
+///
+/// SrpBenchmark.cpp
+/// Times the client side modular exponentiations of a Sec2 handshake, and checks the SRP6a arithmetic
+/// and SHA-512 against known answers.
+///
+/// The SRP6a vectors take the inputs of RFC 5054 appendix B (identity, password, salt and both private
+/// keys) into the group Sec2 actually uses, the 3072-bit group of RFC 5054 with SHA-512, and follow
+/// `security2.c` where it differs from the RFC: u hashes A and B as sent, K hashes S without padding.
+/// The expected values were computed independently with arbitrary precision integers. The SHA-512
+/// vectors are the ones of FIPS 180-2.
+///
+/// Build with optimizations, e.g. `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release`, then run
+/// `build/espprov-bench [iterations]`. `build/espprov-bench --check` instead runs the checks and exits
+/// with 1 if one fails; ctest runs it that way.
+///
+
+#include "BenchMode.hpp"
+#include "KnownAnswer.hpp"
+#include "crypto/BigNum3072.hpp"
+#include "crypto/Random.hpp"
+#include "crypto/Sha512.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string_view>
+
+using namespace espprov;
+using namespace espprov::crypto;
+
+namespace {
+  // Keeps the optimizer from discarding results
+  volatile uint8_t sink = 0;
+  int failures = 0;
+
+  void consume(const BigNum3072& value) {
+    sink = sink ^ value.toBytes().back();
+  }
+
+  double measure(const char* name, int iterations, const std::function<void()>& body) {
+    body(); // warm up, also builds the Montgomery constants
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      body();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    double perCall = elapsed.count() / iterations;
+    std::printf("%-36s %10.1f us\n", name, perCall);
+    return perCall;
+  }
+
+  // pragma MARK: Known answers
+
+  constexpr std::string_view IDENTITY = "alice";
+  constexpr std::string_view PASSWORD = "password123";
+  constexpr std::string_view SALT = "beb25379d1a8581eb5a727673a2441ee";
+  constexpr std::string_view PRIVATE_A = "60975527035cf2ad1989806f0407210bc81edc04e2762a56afd529ddda2d4393";
+  constexpr std::string_view PRIVATE_B = "e487cb59d31ac550471e81f00f6928e01dda08e974a004f49e61f5d105284d20";
+  constexpr std::string_view VERIFIER =
+      "9b5e061701ea7aeb39cf6e3519655a853cf94c75caf2555ef1faf759bb79cb477014e04a88d68ffc05323891d4c205b8"
+      "de81c2f203d8fad1b24d2c109737f1bebbd71f912447c4a03c26b9fad8edb3e780778e302529ed1ee138ccfc36d4ba31"
+      "3cc48b14ea8c22a0186b222e655f2df5603fd75df76b3b08ff8950069add03a754ee4ae88587cce1bfde36794dbae459"
+      "2b7b904f442b041cb17aebad1e3aebe3cbe99de65f4bb1fa00b0e7af06863db53b02254ec66e781e3b62a8212c86beb0"
+      "d50b5ba6d0b478d8c4e9bbcec21765326fbd14058d2bbde2c33045f03873e53948d78b794f0790e48c36aed6e880f557"
+      "427b2fc06db5e1e2e1d7e661ac482d18e528d7295ef7437295ff1a72d402771713f16876dd050ae5b7ad53ccb90855c9"
+      "3956648358adfd966422f52498732d68d1d7fbef10d78034ab8dcb6f0fcf885cc2b2ea2c3e6ac86609ea058a9da8cc63"
+      "531dc915414df568b09482ddac1954dec7eb714f6ff7d44cd5b86f6bd115810930637c01d0f6013bc9740fa2c633ba89";
+  constexpr std::string_view PUBLIC_A =
+      "fab6f5d2615d1e323512e7991cc37443f487da604ca8c9230fcb04e541dce6280b27ca4680b0374f179dc3bdc7553fe6"
+      "2459798c701ad864a91390a28c93b644adbf9c00745b942b79f9012a21b9b78782319d83a1f8362866fbd6f46bfc0ddb"
+      "2e1ab6e4b45a9906b82e37f05d6f97f6a3eb6e182079759c4f6847837b62321ac1b4fa68641fcb4bb98dd697a0c73641"
+      "385f4bab25b793584cc39fc8d48d4bd867a9a3c10f8ea12170268e34fe3bbe6ff89998d60da2f3e4283cbec1393d52af"
+      "724a57230c604e9fbce583d7613e6bffd67596ad121a8707eec46944957033686a155f644d5c5863b48f61bdbf19a53e"
+      "ab6dad0a186b8c152e5f5d8cad4b0ef8aa4ea5008834c3cd342e5e0f167ad04592cd8bd279639398ef9e114dfaaab919"
+      "e14e850989224ddd98576d79385d2210902e9f9b1f2d86cfa47ee244635465f71058421a0184be51dd10cc9d079e6f16"
+      "04e7aa9b7cf7883c7d4ce12b06ebe16081e23f27a231d18432d7d1bb55c28ae21ffcf005f57528d15a88881bb3bbb7fe";
+  constexpr std::string_view PUBLIC_B =
+      "40f57088a482d4c7733384fe0d301fddca9080ad7d4f6fdf09a01006c3cb6d562e41639ae8fa21de3b5dba7585b27558"
+      "9bdb279863c562807b2b99083cd1429cdbe89e25bfbd7e3cad3173b2e3c5a0b174da6d5391e6a06e465f037a40062548"
+      "39a56bf76da84b1c94e0ae208576156fe5c140a4ba4ffc9e38c3b07b88845fc6f7ddda93381fe0ca6084c4cd2d336e54"
+      "51c464ccb6ec65e7d16e548a273e826284af2559b6264274215960fff47bdd63d3aff064d6137af769661c9d4fee4738"
+      "2603c88eaa0980581d07758461b777e4356dda5835198b51feea308d70f75450b71675c08c7d8302fd7539dd1ff2a11c"
+      "b4258aa70d234436aa42b6a0615f3f915d55cc3b966b2716b36e4d1a06ce5e5d2ea3bee5a1270e8751da45b60b997b0f"
+      "fdb0f9962fee4f03bee780ba0a845b1d9271421783ae6601a61ea2e342e4f2e8bc935a409ead19f221bd1b74e2964dd1"
+      "9fc845f60efc09338b60b6b256d8cac889cca306cc370a0b18c8b886e95da0af5235fef4393020d2b7f3056904759042";
+  constexpr std::string_view SCRAMBLER =
+      "03ae5f3c3fa9eff1a50d7dbb8d2f60a1ea66ea712d50ae976ee34641a1cd0e51c4683da383e8595d6cb56a15d5fbc754"
+      "3e07fbddd316217e01a391a18ef06dff";
+  constexpr std::string_view EXPONENT =
+      "00028c9ff91a02039185817002d702384a7ee31013eea261123ace2b708658c5583430fa0a12aa0c905c9a7601285ecd"
+      "ec4a28086ab47b475971618a1fb7fc2a703dba65574a503113c448eadff1b4e9bb28e178ad9c3f08a84b12de8e8147a8"
+      "746a0f70dcdc1b53d58845a51dd7f2644bcb2c9f29d305365eec0b52c9805e4a8a";
+  constexpr std::string_view PREMASTER =
+      "f1036fecd017c8239c0d5af7e0fcf0d408b009e36411618a60b23aabbfc383397268231214baacdc94ca1c53f442fb51"
+      "c1b027c318ae238e16414d60d1881b66486ade10ed02ba33d098f6ce9bcf1bb0c46ca2c47f2f174c59a9c61e2560899b"
+      "83ef61131e6fb30b714f4e43b735c9fe6080477c1b83e4093e4d456b9bca492cf9339d45bc42e67ce6c02c243e49f5da"
+      "42a869ec855780e84207b8a1ea6501c478aac0dfd3d22614f531a00d826b7954ae8b14a985a429315e6dd3664cf47181"
+      "496a94329cde8005cae63c2f9ca4969bfe84001924037c446559bdbb9db9d4dd142fbcd75eef2e162c843065d99e8f05"
+      "762c4db7abd9db203d41ac85a58c05bd4e2dbf822a934523d54e0653d376ce8b56dcb4527dddc1b994dc7509463a7468"
+      "d7f02b1beb1685714ce1dd1e71808a137f788847b7c6b7bfa1364474b3b7e89478954f6a8e68d45b85a88e4ebfec1336"
+      "8ec0891c3bc86cf50097880178d86135e728723458538858d715b7b247406222c1019f53603f016952d497100858824c";
+  constexpr std::string_view SESSION_KEY =
+      "5cbc219db052138ee1148c71cd4498963d682549ce91ca24f098468f06015beb6af245c2093f98c3651bca83ab8cab2b"
+      "580bbf02184fefdf26142f73df95ac50";
+  constexpr std::string_view CLIENT_PROOF =
+      "5f7c14ab57ed0e94fd1d78c6b4dd09ed7e340b7e05d419a9fd760f6b35e523d1310777a1ae1d2826f596f3a85116cc45"
+      "7c7c964d4f44ded5559da818c88b617f";
+  constexpr std::string_view DEVICE_PROOF =
+      "2fa0e81f5cb73b88fa0964270f321dd641f2227a5d805c40f1bfe96aaf6a19ffce8e23287965a39eab9d5a02215f89e1"
+      "28177ed2c4f103e655a045531bcbf7ad";
+
+  constexpr std::string_view SHA512_EMPTY =
+      "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce47d0d13c5d85f2b0ff8318d2877eec2f"
+      "63b931bd47417a81a538327af927da3e";
+  constexpr std::string_view SHA512_ABC =
+      "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd"
+      "454d4423643ce80e2a9ac94fa54ca49f";
+  constexpr std::string_view SHA512_TWO_BLOCKS =
+      "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018501d289e4900f7e4331b99dec4b5433a"
+      "c7d329eeb6dd26545e96e55b874be909";
+  constexpr std::string_view SHA512_MILLION_A =
+      "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973ebde0ff244877ea60a4cb0432ce577c31b"
+      "eb009c5c2c49aa2e4eadb217ad8cc09b";
+
+  void expect(const char* what, ByteView actual, std::string_view expected) {
+    if (!bench::expectBytes(what, actual, expected)) {
+      failures++;
+    }
+  }
+
+  void checkSha512() {
+    expect("SHA-512 of the empty message", Sha512::hash(asBytes("")), SHA512_EMPTY);
+    expect("SHA-512 of \"abc\"", Sha512::hash(asBytes("abc")), SHA512_ABC);
+    expect("SHA-512 of the two block message",
+           Sha512::hash(asBytes("abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrs"
+                                "mnopqrstnopqrstu")),
+           SHA512_TWO_BLOCKS);
+    // Fed in pieces of every size from 1 to 300 bytes, so updates start and end all over a block
+    Bytes as(300, 'a');
+    Sha512 sha;
+    size_t fed = 0;
+    for (size_t piece = 1; fed < 1000000; piece = piece % 300 + 1) {
+      size_t length = std::min(piece, 1000000 - fed);
+      sha.update(ByteView(as).first(length));
+      fed += length;
+    }
+    expect("SHA-512 of a million \"a\" in pieces", sha.finish(), SHA512_MILLION_A);
+  }
+
+  /**
+   * Walks a Sec2 handshake the way `Security2` computes it, from both ends.
+   */
+  void checkSrp() {
+    Bytes salt = bench::fromHex(SALT);
+    BigNum3072 publicB = BigNum3072::fromBytes(bench::fromHex(PUBLIC_B));
+    BigNum3072 multiplier = BigNum3072::fromBytes(Sha512::hash(BigNum3072::prime().toBytes(), BigNum3072::generator().toBytes()));
+
+    Sha512::Digest x = Sha512::hash(salt, Sha512::hash(asBytes(IDENTITY), asBytes(":"), asBytes(PASSWORD)));
+    BigNum3072 verifier = BigNum3072::generatorPow(x);
+    expect("SRP verifier v = g^x", verifier.toBytes(), VERIFIER);
+    BigNum3072 publicA = BigNum3072::generatorPow(bench::fromHex(PRIVATE_A));
+    expect("SRP client public key A = g^a", publicA.toBytes(), PUBLIC_A);
+    Sha512::Digest u = Sha512::hash(publicA.toBytes(), publicB.toBytes());
+    expect("SRP scrambler u = H(A | B)", u, SCRAMBLER);
+
+    // The client's S = (B - k * v)^(a + u * x), the device's S = (A * v^u)^b
+    BigNum3072 premaster = publicB.modSub(multiplier.modMul(verifier)).modPow(bench::fromHex(EXPONENT));
+    expect("SRP client premaster secret", premaster.toBytes(), PREMASTER);
+    BigNum3072 devicePremaster = publicA.modMul(verifier.modPow(u)).modPow(bench::fromHex(PRIVATE_B));
+    expect("SRP device premaster secret", devicePremaster.toBytes(), PREMASTER);
+
+    Sha512::Digest sessionKey = Sha512::hash(premaster.toMinimalBytes());
+    expect("SRP session key K = H(S)", sessionKey, SESSION_KEY);
+    Sha512::Digest groupHash = Sha512::hash(BigNum3072::prime().toMinimalBytes());
+    Sha512::Digest generatorHash = Sha512::hash(BigNum3072::generator().toMinimalBytes());
+    for (size_t i = 0; i < groupHash.size(); i++) {
+      groupHash[i] ^= generatorHash[i];
+    }
+    Sha512::Digest clientProof =
+        Sha512::hash(groupHash, Sha512::hash(asBytes(IDENTITY)), salt, publicA.toBytes(), publicB.toBytes(), sessionKey);
+    expect("SRP client proof M1", clientProof, CLIENT_PROOF);
+    expect("SRP device proof H(A | M1 | K)", Sha512::hash(publicA.toBytes(), clientProof, sessionKey), DEVICE_PROOF);
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  bool checkOnly = bench::takeCheckFlag(argc, argv);
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 50;
+  if (iterations <= 0 || (checkOnly && argc > 1)) {
+    std::fprintf(stderr, "usage: %s [--check | iterations]\n", argv[0]);
+    return 1;
+  }
+
+  if (checkOnly) {
+    checkSha512();
+    checkSrp();
+    if (failures > 0) {
+      std::fprintf(stderr, "%d checks failed\n", failures);
+      return 1;
+    }
+    std::printf("SRP6a and SHA-512 agree with the known answers\n");
+    return 0;
+  }
+
+  Bytes a = randomBytes(32);
+  Bytes x = randomBytes(Sha512::DIGEST_SIZE);
+  // a + u * x is at most 1025 bits
+  Bytes exponent = randomBytes(129);
+  exponent[0] &= 0x01;
+  BigNum3072 base = BigNum3072::fromBytes(randomBytes(BigNum3072::BYTES));
+  BigNum3072 other = BigNum3072::fromBytes(randomBytes(BigNum3072::BYTES));
+
+  std::printf("%d iterations, %zu-bit limbs\n", iterations, BigNum3072::LIMB_BITS);
+  double total = 0;
+  total += measure("A = g^a (256-bit a)", iterations, [&] { consume(BigNum3072::generatorPow(a)); });
+  total += measure("v = g^x (512-bit x)", iterations, [&] { consume(BigNum3072::generatorPow(x)); });
+  total += measure("k * v mod N", iterations, [&] { consume(base.modMul(other)); });
+  total += measure("S = base^(a + u * x) (1025-bit)", iterations, [&] { consume(base.modPow(exponent)); });
+  measure("SHA-512 (1 KiB)", iterations, [&] {
+    Bytes block(1024, 0x5a);
+    sink = sink ^ Sha512::hash(block)[0];
+  });
+  std::printf("%-36s %10.1f us\n", "client handshake arithmetic", total);
+  return 0;
+}
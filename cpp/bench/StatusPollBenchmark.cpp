@@ -0,0 +1,173 @@
+///
+/// StatusPollBenchmark.cpp
+/// Compares how long the fixed 1 second cadence and the default backoff schedule leave a joined
+/// device waiting for its next Wi-Fi status poll, and checks the poll loop of
+/// `ProtocommEngine::provision` against a simulated device that takes a while to join.
+///
+/// Build with `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release`, then run
+/// `build/espprov-status-poll-bench`. `--check` instead runs the checks and exits with 1 if one
+/// fails; ctest runs it that way.
+///
+
+#include "BenchMode.hpp"
+#include "core/Errors.hpp"
+#include "core/HttpTransport.hpp"
+#include "core/ProtocommEngine.hpp"
+#include "sim/LoopbackHttpServer.hpp"
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace espprov;
+using namespace std::chrono_literals;
+
+namespace {
+  int failures = 0;
+
+  void check(bool condition, const char* what) {
+    if (!condition) {
+      std::fprintf(stderr, "check failed: %s\n", what);
+      failures++;
+    }
+  }
+
+  struct Outcome {
+    std::optional<ErrorCode> error;
+    uint32_t polls = 0;
+    // What the device counted
+    uint32_t devicePolls = 0;
+    // What the STATUS_WAIT span recorded
+    uint32_t spanPolls = 0;
+    std::chrono::milliseconds wait{0};
+  };
+
+  /**
+   * Provisions one simulated SoftAP device that joins `joinDuration` after the config is applied,
+   * and times the status wait alone.
+   */
+  Outcome provision(std::chrono::milliseconds joinDuration, const StatusPollSchedule& schedule, const char* ssid = "HomeNetwork",
+                    const char* passphrase = "password123") {
+    sim::SimulatedDeviceConfig config;
+    config.security = SecurityScheme::SEC1;
+    config.connectingPolls = 0;
+    config.joinDuration = joinDuration;
+    auto device = std::make_shared<sim::SimulatedDevice>(config);
+    sim::LoopbackHttpServer server(device, {});
+    ProtocommEngine engine([&](const DeviceConfig&) { return std::make_unique<HttpTransport>("127.0.0.1", server.port()); });
+    engine.setStatusPollSchedule(schedule);
+    engine.configureDevice({
+        .name = "softap",
+        .transport = TransportKind::SOFTAP,
+        .security = SecurityScheme::SEC1,
+        .securityParams = {.proofOfPossession = "abcd1234", .username = std::nullopt},
+    });
+    engine.connect("softap");
+
+    Outcome outcome;
+    try {
+      outcome.polls = engine.provision("softap", ssid, passphrase);
+    } catch (const ProtocommError& e) {
+      outcome.error = e.code();
+    }
+    for (const PhaseSpan& span : engine.runTimings("softap")) {
+      if (span.phase == Phase::STATUS_WAIT) {
+        outcome.spanPolls = span.polls;
+        outcome.wait = std::chrono::duration_cast<std::chrono::milliseconds>(span.duration);
+      }
+    }
+    outcome.devicePolls = device->statusPolls();
+    engine.disconnect("softap");
+    return outcome;
+  }
+
+  void checkSchedule() {
+    StatusPollSchedule schedule{.first = 100ms, .backoff = 2, .max = 1000ms};
+    std::vector<std::chrono::milliseconds> delays{schedule.first};
+    while (delays.size() < 6) {
+      delays.push_back(schedule.next(delays.back()));
+    }
+    check(delays == std::vector<std::chrono::milliseconds>{100ms, 200ms, 400ms, 800ms, 1000ms, 1000ms}, "delays double up to max");
+    StatusPollSchedule fixed{.first = 250ms, .backoff = 1, .max = 250ms};
+    check(fixed.next(fixed.first) == 250ms, "a backoff of 1 polls at a fixed interval");
+    StatusPollSchedule immediate{.first = 0ms, .backoff = 1.5, .max = 50ms};
+    check(immediate.next(immediate.first) == 2ms, "a zero first delay still backs off");
+    StatusPollSchedule shrinking{.first = 100ms, .backoff = 0.5, .max = 1000ms};
+    check(shrinking.next(shrinking.first) == 100ms, "delays never shrink");
+  }
+
+  void checkOutcomes() {
+    StatusPollSchedule schedule{.first = 20ms, .backoff = 2, .max = 160ms, .deadline = 5000ms};
+
+    Outcome joined = provision(300ms, schedule);
+    check(!joined.error.has_value(), "a joining device is provisioned");
+    check(joined.polls == joined.devicePolls && joined.polls == joined.spanPolls, "the poll count matches the device and the span");
+    // 20 + 40 + 80 + 160 = 300 ms, the fifth poll lands 160 ms later at the latest
+    check(joined.polls <= 6, "the backoff keeps the poll count low");
+    check(joined.wait < 300ms + schedule.max + 100ms, "a joined device is seen within one delay");
+
+    Outcome auth = provision(200ms, schedule, "HomeNetwork", "wrong-password");
+    check(auth.error == ErrorCode::PROV_WIFI_STATUS_AUTH_ERROR, "AuthError ends the wait with its error");
+    check(auth.wait < 200ms + schedule.max + 100ms && auth.spanPolls == auth.devicePolls, "AuthError ends the wait at once");
+
+    Outcome missing = provision(200ms, schedule, "Nowhere", "password123");
+    check(missing.error == ErrorCode::PROV_WIFI_STATUS_NETWORK_NOT_FOUND, "NetworkNotFound ends the wait with its error");
+    check(missing.wait < 200ms + schedule.max + 100ms, "NetworkNotFound ends the wait at once");
+
+    StatusPollSchedule quick{.first = 20ms, .backoff = 2, .max = 160ms, .deadline = 400ms};
+    Outcome late = provision(5000ms, quick);
+    check(late.error == ErrorCode::PROV_TIMED_OUT_ERROR, "a device that never joins times out");
+    check(late.wait >= 400ms && late.wait < 400ms + 100ms, "the deadline bounds the wait");
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  bool checkOnly = bench::takeCheckFlag(argc, argv);
+  if (argc > 1) {
+    std::fprintf(stderr, "usage: %s [--check]\n", argv[0]);
+    return 1;
+  }
+
+  if (checkOnly) {
+    checkSchedule();
+    checkOutcomes();
+    if (failures > 0) {
+      return 1;
+    }
+    std::printf("checks passed\n");
+    return 0;
+  }
+
+  const StatusPollSchedule fixed{.first = 1000ms, .backoff = 1, .max = 1000ms};
+  const StatusPollSchedule adaptive;
+  const std::vector<std::chrono::milliseconds> joins{250ms, 700ms, 1500ms, 2600ms, 4200ms};
+
+  // Every run has its own device and engine, so they all run at once
+  std::vector<Outcome> fixedOutcomes(joins.size());
+  std::vector<Outcome> adaptiveOutcomes(joins.size());
+  std::vector<std::thread> runs;
+  for (size_t i = 0; i < joins.size(); i++) {
+    runs.emplace_back([&, i] { fixedOutcomes[i] = provision(joins[i], fixed); });
+    runs.emplace_back([&, i] { adaptiveOutcomes[i] = provision(joins[i], adaptive); });
+  }
+  for (std::thread& run : runs) {
+    run.join();
+  }
+
+  std::printf("%-10s %22s %22s\n", "join", "fixed 1 s: idle, polls", "backoff: idle, polls");
+  std::chrono::milliseconds fixedIdle{0};
+  std::chrono::milliseconds adaptiveIdle{0};
+  for (size_t i = 0; i < joins.size(); i++) {
+    auto idle = [&](const Outcome& outcome) { return outcome.wait - joins[i]; };
+    std::printf("%-7lld ms %15lld ms %3u %15lld ms %3u\n", static_cast<long long>(joins[i].count()),
+                static_cast<long long>(idle(fixedOutcomes[i]).count()), fixedOutcomes[i].polls,
+                static_cast<long long>(idle(adaptiveOutcomes[i]).count()), adaptiveOutcomes[i].polls);
+    fixedIdle += idle(fixedOutcomes[i]);
+    adaptiveIdle += idle(adaptiveOutcomes[i]);
+  }
+  std::printf("%-10s %15lld ms %19lld ms\n", "total", static_cast<long long>(fixedIdle.count()),
+              static_cast<long long>(adaptiveIdle.count()));
+  return 0;
+}
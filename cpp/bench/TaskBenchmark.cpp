@@ -0,0 +1,348 @@
+///
+/// TaskBenchmark.cpp
+/// Measures what a chain of native coroutine tasks and a callback round trip cost, and checks the
+/// coroutine layer against a fake callback transport that answers late, twice, inline or never,
+/// then runs the engine over it against a simulated device.
+///
+/// Build with `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release`, then run
+/// `build/espprov-task-bench [exchanges]`. `--check` instead runs the checks and exits with 1 if one
+/// fails; ctest runs it that way.
+///
+
+#include "BenchMode.hpp"
+#include "core/AsyncTransport.hpp"
+#include "core/Errors.hpp"
+#include "core/ProtocommEngine.hpp"
+#include "core/Task.hpp"
+#include "sim/SimulatedDevice.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace espprov;
+using namespace std::chrono_literals;
+
+namespace {
+  int failures = 0;
+
+  void check(bool condition, const char* what) {
+    if (!condition) {
+      std::fprintf(stderr, "check failed: %s\n", what);
+      failures++;
+    }
+  }
+
+  /**
+   * How `FakeRadioTransport` answers an exchange.
+   */
+  enum class Answer {
+    // Once, from the radio thread after the latency
+    LATE,
+    // Twice, like an SDK that reports both a response and a disconnect
+    TWICE,
+    // Before `exchange` returns, like a cached reply
+    INLINE,
+    // Not at all, like a peripheral that walked out of range
+    NEVER,
+  };
+
+  /**
+   * Stands in for a BLE stack: requests go to a simulated device in process and the answers come
+   * back on a radio thread of their own.
+   */
+  class FakeRadioTransport final : public AsyncTransport {
+  public:
+    FakeRadioTransport(std::shared_ptr<sim::SimulatedDevice> device, SerialExecutor& radio, std::chrono::milliseconds latency)
+        : _device(std::move(device)), _radio(radio), _latency(latency) {}
+
+    Answer answer = Answer::LATE;
+    std::atomic<int> abandoned{0};
+    std::atomic<int> droppedAnswers{0};
+
+    void connect(Completer<void> done) override {
+      _connected = true;
+      done.resolve();
+    }
+
+    void exchange(std::string_view endpoint, ByteView payload, Completer<Bytes> done) override {
+      done.onAbandoned([this] { abandoned++; });
+      Bytes reply = _device->handle(endpoint, payload);
+      switch (answer) {
+        case Answer::INLINE:
+          done.resolve(std::move(reply));
+          break;
+        case Answer::NEVER:
+          break;
+        case Answer::LATE:
+        case Answer::TWICE:
+          _radio.postAfter(_latency, [this, done, reply = std::move(reply), twice = answer == Answer::TWICE]() mutable {
+            if (!done.resolve(reply)) {
+              droppedAnswers++;
+            }
+            if (twice && !done.reject(ErrorCode::BLE_FAILED_TO_CONNECT, "Peripheral disconnected")) {
+              droppedAnswers++;
+            }
+          });
+          break;
+      }
+    }
+
+    void disconnect() noexcept override {
+      _connected = false;
+    }
+
+    bool isConnected() const noexcept override {
+      return _connected;
+    }
+
+  private:
+    std::shared_ptr<sim::SimulatedDevice> _device;
+    SerialExecutor& _radio;
+    std::chrono::milliseconds _latency;
+    bool _connected = false;
+  };
+
+  std::shared_ptr<sim::SimulatedDevice> makeDevice(SecurityScheme security = SecurityScheme::SEC0) {
+    sim::SimulatedDeviceConfig config;
+    config.security = security;
+    config.connectingPolls = 0;
+    return std::make_shared<sim::SimulatedDevice>(config);
+  }
+
+  std::optional<ErrorCode> errorOf(const std::function<void()>& body) {
+    try {
+      body();
+    } catch (const ProtocommError& e) {
+      return e.code();
+    }
+    return std::nullopt;
+  }
+
+  // pragma MARK: Tasks
+
+  Task<int> leaf(int value) {
+    co_return value;
+  }
+
+  Task<int> nested(int depth) {
+    if (depth == 0) {
+      co_return co_await leaf(1);
+    }
+    co_return 1 + co_await nested(depth - 1);
+  }
+
+  Task<int> sumOfLeaves(size_t count) {
+    int sum = 0;
+    for (size_t i = 0; i < count; i++) {
+      sum += co_await leaf(1);
+    }
+    co_return sum;
+  }
+
+  Task<int> failing() {
+    throw ProtocommError(ErrorCode::PROV_CONFIGURATION_ERROR, "Rejected");
+    co_return 0;
+  }
+
+  Task<int> catching() {
+    try {
+      co_await failing();
+    } catch (const ProtocommError& e) {
+      co_return static_cast<int>(e.code());
+    }
+    co_return 0;
+  }
+
+  Task<Bytes> versionInfo(AsyncTransport& transport, std::chrono::milliseconds timeout) {
+    co_await connectAsync(transport, timeout);
+    co_return co_await exchangeAsync(transport, endpoints::PROTO_VER, asBytes("ESP"), timeout);
+  }
+
+  Task<size_t> exchangeMany(AsyncTransport& transport, size_t count) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+      bytes += (co_await exchangeAsync(transport, endpoints::PROTO_VER, asBytes("ESP"), 1000ms)).size();
+    }
+    co_return bytes;
+  }
+
+  // pragma MARK: Checks
+
+  void checkComposition(SerialExecutor& executor) {
+    uint64_t before = executor.jobsRun();
+    check(syncWait(executor, nested(200)) == 201, "nested tasks return their values");
+    check(executor.jobsRun() - before == 1, "a chain of tasks without callbacks runs in one job");
+    check(syncWait(executor, catching()) == static_cast<int>(ErrorCode::PROV_CONFIGURATION_ERROR), "exceptions reach the awaiting task");
+    check(errorOf([&] { syncWait(executor, failing()); }) == ErrorCode::PROV_CONFIGURATION_ERROR, "exceptions reach syncWait");
+
+    std::promise<bool> onExecutor;
+    spawn(executor, [](std::promise<bool>& result, SerialExecutor& executor) -> Task<void> {
+      bool caught = false;
+      try {
+        syncWait(executor, leaf(1));
+      } catch (const std::logic_error&) {
+        caught = true;
+      }
+      result.set_value(caught);
+      co_return;
+    }(onExecutor, executor));
+    check(onExecutor.get_future().get(), "syncWait refuses to block its own executor");
+  }
+
+  void checkCallbacks(SerialExecutor& executor, SerialExecutor& radio) {
+    auto device = makeDevice();
+    FakeRadioTransport transport(device, radio, 5ms);
+
+    transport.answer = Answer::INLINE;
+    uint64_t before = executor.jobsRun();
+    check(!syncWait(executor, versionInfo(transport, 1000ms)).empty(), "an inline answer is returned");
+    check(executor.jobsRun() - before == 1, "an inline answer does not suspend");
+
+    transport.answer = Answer::LATE;
+    before = executor.jobsRun();
+    check(!syncWait(executor, versionInfo(transport, 1000ms)).empty(), "a late answer is returned");
+    check(executor.jobsRun() - before == 2, "a late answer resumes with one job");
+
+    transport.answer = Answer::TWICE;
+    check(!syncWait(executor, versionInfo(transport, 1000ms)).empty(), "the first of two answers counts");
+    std::this_thread::sleep_for(20ms);
+    check(transport.droppedAnswers == 1, "the second answer is dropped");
+
+    transport.answer = Answer::NEVER;
+    auto start = std::chrono::steady_clock::now();
+    check(errorOf([&] { syncWait(executor, versionInfo(transport, 50ms)); }) == ErrorCode::SESSION_SEND_DATA_ERROR,
+          "a missing answer times out");
+    check(std::chrono::steady_clock::now() - start < 50ms + 100ms, "the timeout is kept");
+    check(transport.abandoned == 1, "a timed out exchange is abandoned");
+  }
+
+  void checkCancellation(SerialExecutor& executor, SerialExecutor& radio) {
+    auto device = makeDevice();
+    FakeRadioTransport transport(device, radio, 5ms);
+
+    CancellationSource early;
+    early.cancel();
+    check(errorOf([&] { syncWait(executor, versionInfo(transport, 1000ms), early.token()); }) == ErrorCode::OPERATION_CANCELLED,
+          "a cancelled token fails the first wait");
+
+    transport.answer = Answer::NEVER;
+    CancellationSource late;
+    radio.postAfter(30ms, [&late] { late.cancel(); });
+    auto start = std::chrono::steady_clock::now();
+    check(errorOf([&] { syncWait(executor, versionInfo(transport, 10000ms), late.token()); }) == ErrorCode::OPERATION_CANCELLED,
+          "cancelling ends a pending wait");
+    check(std::chrono::steady_clock::now() - start < 30ms + 100ms, "cancelling ends the wait at once");
+    check(transport.abandoned == 1, "a cancelled exchange is abandoned");
+
+    CancellationSource sleeping;
+    radio.postAfter(20ms, [&sleeping] { sleeping.cancel(); });
+    start = std::chrono::steady_clock::now();
+    check(errorOf([&] { syncWait(executor, []() -> Task<void> { co_await sleepFor(10000ms); }(), sleeping.token()); }) ==
+              ErrorCode::OPERATION_CANCELLED,
+          "cancelling ends a sleep");
+    check(std::chrono::steady_clock::now() - start < 20ms + 100ms, "cancelling ends the sleep at once");
+
+    bool observed = syncWait(executor, []() -> Task<bool> { co_return (co_await currentCancellationToken()).isCancelled(); }(), early.token());
+    check(observed, "tasks see their token");
+  }
+
+  void checkEngine(SerialExecutor& executor, SerialExecutor& radio) {
+    constexpr size_t DEVICES = 4;
+    std::vector<std::shared_ptr<sim::SimulatedDevice>> devices;
+    for (size_t i = 0; i < DEVICES; i++) {
+      devices.push_back(makeDevice(SecurityScheme::SEC1));
+    }
+    Timeouts timeouts;
+    timeouts.statusPoll = {.first = 1ms, .backoff = 1, .max = 1ms};
+    ProtocommEngine engine(
+        [&](const DeviceConfig& config) -> std::unique_ptr<Transport> {
+          auto& device = devices[static_cast<size_t>(config.name.back() - '0')];
+          return std::make_unique<AsyncTransportBridge>(std::make_unique<FakeRadioTransport>(device, radio, 1ms), executor);
+        },
+        timeouts);
+
+    std::vector<std::thread> workers;
+    std::atomic<int> provisioned{0};
+    for (size_t i = 0; i < DEVICES; i++) {
+      std::string name = "ble-";
+      name += static_cast<char>('0' + i);
+      engine.configureDevice({
+          .name = name,
+          .transport = TransportKind::BLE,
+          .security = SecurityScheme::SEC1,
+          .securityParams = {.proofOfPossession = "abcd1234", .username = std::nullopt},
+      });
+      workers.emplace_back([&engine, &provisioned, name] {
+        engine.connect(name);
+        engine.provision(name, "HomeNetwork", "password123");
+        provisioned++;
+      });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    check(provisioned == static_cast<int>(DEVICES), "the engine provisions over callback transports");
+    for (const auto& device : devices) {
+      check(device->provisionedSsid() == "HomeNetwork", "every device got the credentials");
+    }
+  }
+
+  double microsecondsPer(size_t count, const std::function<void()>& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(count);
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  bool checkOnly = bench::takeCheckFlag(argc, argv);
+  long exchanges = argc > 1 ? std::atol(argv[1]) : 20000;
+  if (exchanges <= 0) {
+    std::fprintf(stderr, "usage: %s [--check] [exchanges]\n", argv[0]);
+    return 1;
+  }
+
+  SerialExecutor executor;
+  SerialExecutor radio;
+  if (checkOnly) {
+    checkComposition(executor);
+    checkCallbacks(executor, radio);
+    checkCancellation(executor, radio);
+    checkEngine(executor, radio);
+    if (failures > 0) {
+      return 1;
+    }
+    std::printf("checks passed\n");
+    return 0;
+  }
+
+  auto count = static_cast<size_t>(exchanges);
+  auto device = makeDevice();
+  FakeRadioTransport transport(device, radio, 0ms);
+  syncWait(executor, connectAsync(transport, 1000ms));
+
+  double await = microsecondsPer(count, [&] { syncWait(executor, sumOfLeaves(count)); });
+  // One task per exchange, each answer posted back from the radio thread
+  double chained = microsecondsPer(count, [&] { syncWait(executor, exchangeMany(transport, count)); });
+  // The engine's worker blocking on every exchange through the bridge
+  AsyncTransportBridge bridge(std::make_unique<FakeRadioTransport>(device, radio, 0ms), executor);
+  bridge.connect(1000ms);
+  double blocking = microsecondsPer(count, [&] {
+    for (size_t i = 0; i < count; i++) {
+      bridge.exchange(endpoints::PROTO_VER, asBytes("ESP"), 1000ms);
+    }
+  });
+
+  std::printf("%-40s %10s\n", "", "us each");
+  std::printf("%-40s %10.3f\n", "nested task await", await);
+  std::printf("%-40s %10.3f\n", "exchange awaited in a task", chained);
+  std::printf("%-40s %10.3f\n", "exchange blocked on through the bridge", blocking);
+  return 0;
+}
@@ -0,0 +1,258 @@
+///
+/// TraceBenchmark.cpp
+/// Measures what recording a trace event costs with tracing off and on, and checks the trace buffer
+/// on a simulated provisioning run and under concurrent writers.
+///
+/// Build with `cmake -S cpp -B build -DCMAKE_BUILD_TYPE=Release`, then run
+/// `build/espprov-trace-bench [trace.json]`. With a path, the trace of the simulated run is written
+/// there to open in Perfetto. `--check` instead runs the checks and exits with 1 if one fails; ctest
+/// runs it that way.
+///
+
+#include "BenchMode.hpp"
+#include "core/Errors.hpp"
+#include "core/HttpTransport.hpp"
+#include "core/ProtocommEngine.hpp"
+#include "core/Tracer.hpp"
+#include "sim/LoopbackHttpServer.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace espprov;
+
+namespace {
+  int failures = 0;
+
+  void check(bool condition, const char* what) {
+    if (!condition) {
+      std::fprintf(stderr, "check failed: %s\n", what);
+      failures++;
+    }
+  }
+
+  struct ExportedEvent {
+    std::string name;
+    std::string detail;
+    double ts;
+  };
+
+  /**
+   * The recorded events of an export, without the metadata. Good enough for the names the checks
+   * record, which need no escaping.
+   */
+  std::vector<ExportedEvent> parseEvents(const std::string& json) {
+    std::vector<ExportedEvent> events;
+    auto field = [&](size_t from, size_t to, std::string_view key) -> std::string {
+      size_t at = json.find(key, from);
+      if (at == std::string::npos || at >= to) {
+        return {};
+      }
+      at += key.size();
+      return json.substr(at, json.find_first_of("\",}", at) - at);
+    };
+    size_t pos = 0;
+    while ((pos = json.find("{\"name\":\"", pos)) != std::string::npos) {
+      size_t end = json.find('}', json.find("\"tid\":", pos));
+      if (json.compare(json.find("\"ph\":\"", pos) + 6, 1, "M") != 0) {
+        events.push_back(ExportedEvent{
+            .name = field(pos, end, "{\"name\":\""),
+            .detail = field(pos, end + 1, "\"detail\":\""),
+            .ts = std::stod(field(pos, end, "\"ts\":")),
+        });
+      }
+      pos = end;
+    }
+    return events;
+  }
+
+  std::string numbered(const char* prefix, size_t number) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%s%zu", prefix, number);
+    return name;
+  }
+
+  bool contains(const std::string& json, const std::string& text) {
+    return json.find(text) != std::string::npos;
+  }
+
+  std::string traceProvisioning() {
+    sim::SimulatedDeviceConfig config;
+    config.security = SecurityScheme::SEC2;
+    auto device = std::make_shared<sim::SimulatedDevice>(config);
+    sim::LoopbackHttpServer server(device, {});
+    Timeouts timeouts;
+    timeouts.statusPoll = {.first = std::chrono::milliseconds(5), .backoff = 1, .max = std::chrono::milliseconds(5)};
+    ProtocommEngine engine([&](const DeviceConfig&) { return std::make_unique<HttpTransport>("127.0.0.1", server.port()); },
+                           timeouts);
+    engine.configureDevice({
+        .name = "softap",
+        .transport = TransportKind::SOFTAP,
+        .security = SecurityScheme::SEC2,
+        .securityParams = {.proofOfPossession = "abcd1234", .username = "wifiprov"},
+    });
+
+    Tracer& tracer = Tracer::shared();
+    tracer.start();
+    tracer.nameThread("bench");
+    engine.connect("softap");
+    engine.scanWifi("softap", true);
+    engine.provision("softap", "HomeNetwork", "password123");
+    engine.sendData("softap", "custom-data", asBytes("ping"));
+    engine.disconnect("softap");
+    tracer.stop();
+    return tracer.exportChromeJson();
+  }
+
+  void checkProvisioningTrace(const std::string& json) {
+    check(contains(json, R"("name":"thread_name","ph":"M","pid":1,"tid":)") && contains(json, R"("args":{"name":"bench"})"),
+          "named threads are exported");
+    check(contains(json, R"("name":"prov-session","cat":"transport","ph":"X")"), "transport exchanges are traced");
+    check(contains(json, R"("name":"srp session key","cat":"crypto")") && contains(json, R"("name":"decrypt","cat":"crypto")"),
+          "crypto is traced");
+    check(contains(json, R"("name":"SECURED","cat":"state","ph":"i","s":"t")"), "state changes are traced");
+    check(contains(json, R"("name":"HANDSHAKE","cat":"phase")") && contains(json, R"("name":"STATUS_WAIT","cat":"phase")"),
+          "phases are traced");
+    check(contains(json, R"("name":"status poll wait","cat":"device")"), "device waits are traced");
+
+    std::vector<ExportedEvent> events = parseEvents(json);
+    bool ordered = !events.empty();
+    for (size_t i = 1; i < events.size(); i++) {
+      ordered &= events[i - 1].ts <= events[i].ts;
+    }
+    check(ordered, "events are exported in start order");
+  }
+
+  void checkStopped() {
+    Tracer& tracer = Tracer::shared();
+    tracer.start();
+    tracer.stop();
+    tracer.instant(TraceCategory::STATE, "ignored");
+    { TraceSpan span(TraceCategory::DEVICE, "ignored"); }
+    check(parseEvents(tracer.exportChromeJson()).empty(), "a stopped tracer records nothing");
+
+    tracer.start();
+    tracer.instant(TraceCategory::STATE, "quote\"and\nnewline", "back\\slash");
+    tracer.stop();
+    std::string json = tracer.exportChromeJson();
+    check(contains(json, R"("name":"quote\"and\u000anewline")") && contains(json, R"("detail":"back\\slash")"),
+          "names and details are escaped");
+  }
+
+  void checkWraparound() {
+    Tracer& tracer = Tracer::shared();
+    tracer.start();
+    for (size_t i = 0; i < Tracer::CAPACITY + 100; i++) {
+      tracer.instant(TraceCategory::DEVICE, numbered("e", i));
+    }
+    tracer.stop();
+    std::string json = tracer.exportChromeJson();
+    std::vector<ExportedEvent> events = parseEvents(json);
+    check(events.size() == Tracer::CAPACITY, "the ring keeps CAPACITY events");
+    check(!events.empty() && events.front().name == "e100" && events.back().name == numbered("e", Tracer::CAPACITY + 99),
+          "the ring keeps the newest events");
+    check(contains(json, R"("overwritten":"100")"), "overwritten events are reported");
+  }
+
+  void checkConcurrentExport(size_t threads) {
+    Tracer& tracer = Tracer::shared();
+    tracer.start();
+    std::atomic<bool> done{false};
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < threads; t++) {
+      writers.emplace_back([&, t] {
+        // Name and detail are written separately, a torn copy would mix two writers
+        std::string name = numbered("writer", t);
+        while (!done.load(std::memory_order_relaxed)) {
+          tracer.instant(TraceCategory::DEVICE, name, name);
+        }
+      });
+    }
+    bool consistent = true;
+    for (int i = 0; i < 20; i++) {
+      for (const ExportedEvent& event : parseEvents(tracer.exportChromeJson())) {
+        consistent &= event.name == event.detail;
+      }
+    }
+    done = true;
+    for (std::thread& writer : writers) {
+      writer.join();
+    }
+    tracer.stop();
+    check(consistent, "exports taken while writers wrap the ring hold no torn events");
+  }
+
+  double nanosPerEvent(size_t threads, size_t events) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < threads; t++) {
+      writers.emplace_back([events] {
+        for (size_t i = 0; i < events; i++) {
+          TraceSpan span(TraceCategory::TRANSPORT, "prov-config", "device");
+        }
+      });
+    }
+    for (std::thread& writer : writers) {
+      writer.join();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(events);
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  bool checkOnly = bench::takeCheckFlag(argc, argv);
+  if (argc > 2) {
+    std::fprintf(stderr, "usage: %s [--check] [trace.json]\n", argv[0]);
+    return 1;
+  }
+
+  std::string trace;
+  try {
+    trace = traceProvisioning();
+  } catch (const ProtocommError& e) {
+    std::fprintf(stderr, "provisioning failed: %s\n", e.what());
+    return 1;
+  }
+  if (argc > 1) {
+    FILE* file = std::fopen(argv[1], "w");
+    if (file == nullptr || std::fwrite(trace.data(), 1, trace.size(), file) != trace.size()) {
+      std::fprintf(stderr, "cannot write %s\n", argv[1]);
+      return 1;
+    }
+    std::fclose(file);
+  }
+  if (checkOnly) {
+    checkProvisioningTrace(trace);
+    checkStopped();
+    checkWraparound();
+    checkConcurrentExport(4);
+    if (failures > 0) {
+      return 1;
+    }
+    std::printf("checks passed\n");
+    return 0;
+  }
+
+  constexpr size_t events = 1000000;
+  Tracer& tracer = Tracer::shared();
+  tracer.stop();
+  double off = nanosPerEvent(1, events);
+  tracer.start();
+  double on = nanosPerEvent(1, events);
+  double contended = nanosPerEvent(4, events);
+  auto start = std::chrono::steady_clock::now();
+  std::string full = tracer.exportChromeJson();
+  std::chrono::duration<double, std::milli> exportMs = std::chrono::steady_clock::now() - start;
+  tracer.stop();
+
+  std::printf("%zu events in the provisioning trace\n\n", parseEvents(trace).size());
+  std::printf("%-40s %10.1f ns\n", "span, tracing off", off);
+  std::printf("%-40s %10.1f ns\n", "span, tracing on", on);
+  std::printf("%-40s %10.1f ns\n", "span, tracing on, 4 threads", contended / 4);
+  std::printf("%-40s %10.1f ms (%zu KB)\n", "export of a full ring", exportMs.count(), full.size() / 1024);
+  return 0;
+}
@@ -0,0 +1,54 @@
+///
+/// AsyncTransport.cpp
+/// The callback flavour of `Transport`, for links whose platform APIs answer on their own threads.
+///
+
+#include "AsyncTransport.hpp"
+
+namespace espprov {
+
+  Task<void> connectAsync(AsyncTransport& transport, std::chrono::milliseconds timeout) {
+    co_await awaitCallback<void>([&transport](Completer<void> done) { transport.connect(std::move(done)); }, timeout,
+                                 ErrorCode::SESSION_INIT_ERROR, "Connect");
+  }
+
+  Task<Bytes> exchangeAsync(AsyncTransport& transport, std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout) {
+    // The views are only read while the exchange starts, before the first suspension
+    co_return co_await awaitCallback<Bytes>(
+        [&transport, endpoint, payload](Completer<Bytes> done) { transport.exchange(endpoint, payload, std::move(done)); }, timeout,
+        ErrorCode::SESSION_SEND_DATA_ERROR, "Request to " + std::string(endpoint));
+  }
+
+  AsyncTransportBridge::AsyncTransportBridge(std::unique_ptr<AsyncTransport> transport, Executor& executor)
+      : _transport(std::move(transport)), _executor(executor) {}
+
+  AsyncTransportBridge::~AsyncTransportBridge() {
+    disconnect();
+  }
+
+  void AsyncTransportBridge::connect(std::chrono::milliseconds timeout) {
+    if (_transport->isConnected()) {
+      return;
+    }
+    syncWait(_executor, connectAsync(*_transport, timeout), _abort.token());
+    _pendingLinkTimeout = timeout;
+  }
+
+  Bytes AsyncTransportBridge::exchange(std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout) {
+    if (!_transport->isConnected()) {
+      throw ProtocommError(ErrorCode::SESSION_NOT_ESTABLISHED, "Transport is not connected");
+    }
+    timeout += std::exchange(_pendingLinkTimeout, std::chrono::milliseconds(0));
+    return syncWait(_executor, exchangeAsync(*_transport, endpoint, payload, timeout), _abort.token());
+  }
+
+  void AsyncTransportBridge::disconnect() noexcept {
+    _pendingLinkTimeout = std::chrono::milliseconds(0);
+    _transport->disconnect();
+  }
+
+  void AsyncTransportBridge::abort() noexcept {
+    _abort.cancel();
+  }
+
+} // namespace espprov
@@ -0,0 +1,95 @@
+///
+/// AsyncTransport.hpp
+/// The callback flavour of `Transport`, for links whose platform APIs answer on their own threads.
+///
+
+#pragma once
+
+#include "Bytes.hpp"
+#include "Cancellation.hpp"
+#include "Errors.hpp"
+#include "Executor.hpp"
+#include "Task.hpp"
+#include "Transport.hpp"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace espprov {
+
+  /**
+   * A raw request/response channel whose operations report back through a `Completer` instead of
+   * blocking, the way the BLE stacks and the Swift/Kotlin toolkits work.
+   *
+   * Implementations only start the operation and settle the completer from whatever thread the
+   * platform calls back on, as often as the platform happens to call. Timeouts, cancellation and
+   * resuming the waiting task exactly once are handled by `connectAsync` and `exchangeAsync`. If
+   * the waiting task gives up first, the completer's `onAbandoned` hook runs, which is where an
+   * implementation stops the platform operation.
+   */
+  class AsyncTransport {
+  public:
+    virtual ~AsyncTransport() = default;
+
+    /**
+     * Opens the underlying link. Links that open lazily on the first exchange resolve right away.
+     */
+    virtual void connect(Completer<void> done) = 0;
+
+    /**
+     * Sends `payload` to the protocomm `endpoint` and resolves `done` with the raw reply. Both
+     * views are only valid during the call.
+     */
+    virtual void exchange(std::string_view endpoint, ByteView payload, Completer<Bytes> done) = 0;
+
+    /**
+     * Closes the link. Must be safe to call at any time, including on a closed transport.
+     */
+    virtual void disconnect() noexcept = 0;
+
+    virtual bool isConnected() const noexcept = 0;
+  };
+
+  /**
+   * Opens the link of `transport`. Throws `ProtocommError(SESSION_INIT_ERROR)` if it did not open
+   * within `timeout`, and `OPERATION_CANCELLED` if the task was cancelled first.
+   */
+  Task<void> connectAsync(AsyncTransport& transport, std::chrono::milliseconds timeout);
+
+  /**
+   * Runs one exchange on `transport`. Throws `ProtocommError(SESSION_SEND_DATA_ERROR)` if no reply
+   * arrived within `timeout`, and `OPERATION_CANCELLED` if the task was cancelled first.
+   */
+  Task<Bytes> exchangeAsync(AsyncTransport& transport, std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout);
+
+  /**
+   * Presents an `AsyncTransport` as the blocking `Transport` the engine drives, running every
+   * operation as a task on `executor`. The engine's worker threads block in `syncWait`, the
+   * platform callbacks only post a job to the executor.
+   *
+   * Platform links open lazily on the first exchange, so that exchange gets the connect timeout on
+   * top of its own. `abort()` cancels the waiting task, which abandons the platform operation.
+   */
+  class AsyncTransportBridge final : public Transport {
+  public:
+    AsyncTransportBridge(std::unique_ptr<AsyncTransport> transport, Executor& executor);
+    ~AsyncTransportBridge() override;
+
+    void connect(std::chrono::milliseconds timeout) override;
+    Bytes exchange(std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout) override;
+    void disconnect() noexcept override;
+    void abort() noexcept override;
+
+    bool isConnected() const noexcept override {
+      return _transport->isConnected();
+    }
+
+  private:
+    std::unique_ptr<AsyncTransport> _transport;
+    Executor& _executor;
+    CancellationSource _abort;
+    std::chrono::milliseconds _pendingLinkTimeout{0};
+  };
+
+} // namespace espprov
@@ -0,0 +1,420 @@
+///
+/// Base64.cpp
+/// RFC 4648 base64, used to move custom endpoint payloads across the JS boundary as strings.
+///
+
+#include "Base64.hpp"
+#include "Errors.hpp"
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ESPPROV_BASE64_SSSE3 1
+#include <cpuid.h>
+#include <tmmintrin.h>
+#endif
+
+// Advanced SIMD is part of the arm64 baseline, and vqtbl4q_u8 is arm64 only
+#if defined(__aarch64__)
+#define ESPPROV_BASE64_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace espprov {
+
+  namespace {
+    constexpr char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    constexpr uint8_t INVALID = 0xFF;
+    constexpr uint8_t SKIP = 0xFE;
+
+    constexpr std::array<uint8_t, 256> makeDecodeTable() {
+      std::array<uint8_t, 256> table{};
+      table.fill(INVALID);
+      for (uint8_t i = 0; i < 64; i++) {
+        table[static_cast<uint8_t>(ALPHABET[i])] = i;
+      }
+      table['\n'] = SKIP;
+      table['\r'] = SKIP;
+      return table;
+    }
+
+    constexpr std::array<uint8_t, 256> DECODE_TABLE = makeDecodeTable();
+
+    [[noreturn]] void badBase64() {
+      throw ProtocommError(ErrorCode::RUNTIME_BAD_BASE64_DATA, "Bad base64 data");
+    }
+
+    /**
+     * A vector kernel encodes whole blocks from the start of `in` and returns how many bytes it
+     * consumed, a multiple of 3.
+     */
+    using EncodeKernel = size_t (*)(const uint8_t* in, size_t size, char* out) noexcept;
+
+    /**
+     * A vector kernel decodes whole blocks from the start of `in` until the end or the first block
+     * with a character outside the alphabet, and returns how many characters it consumed, a
+     * multiple of 4.
+     */
+    using DecodeKernel = size_t (*)(const char* in, size_t size, uint8_t* out) noexcept;
+
+    // pragma MARK: Scalar
+
+    void encodeScalar(const uint8_t* in, size_t size, char* out) noexcept {
+      const uint8_t* end = in + size;
+      for (; end - in >= 3; in += 3, out += 4) {
+        uint32_t chunk = (in[0] << 16) | (in[1] << 8) | in[2];
+        out[0] = ALPHABET[chunk >> 18];
+        out[1] = ALPHABET[(chunk >> 12) & 0x3F];
+        out[2] = ALPHABET[(chunk >> 6) & 0x3F];
+        out[3] = ALPHABET[chunk & 0x3F];
+      }
+
+      size_t rest = static_cast<size_t>(end - in);
+      if (rest > 0) {
+        uint32_t chunk = in[0] << 16;
+        if (rest == 2) {
+          chunk |= in[1] << 8;
+        }
+        out[0] = ALPHABET[chunk >> 18];
+        out[1] = ALPHABET[(chunk >> 12) & 0x3F];
+        out[2] = rest == 2 ? ALPHABET[(chunk >> 6) & 0x3F] : '=';
+        out[3] = '=';
+      }
+    }
+
+    /**
+     * Where the decoder is within a quartet, carried between the scalar loop and a kernel.
+     */
+    struct DecodeState {
+      uint8_t* out;
+      uint32_t chunk = 0;
+      int filled = 0;
+      size_t padding = 0;
+    };
+
+    /**
+     * Decodes up to `end`. With `handBack`, returns early once it has stepped over a line break and
+     * is at a quartet boundary again, so a kernel can continue from there.
+     */
+    const char* decodeScalar(const char* in, const char* end, DecodeState& state, bool handBack) {
+      bool skipped = false;
+      while (in < end) {
+        if (state.filled == 0 && state.padding == 0) {
+          if (skipped && handBack) {
+            return in;
+          }
+          // Whole quartets without line breaks or padding, the common case
+          for (; end - in >= 4; in += 4, state.out += 3) {
+            uint8_t a = DECODE_TABLE[static_cast<uint8_t>(in[0])];
+            uint8_t b = DECODE_TABLE[static_cast<uint8_t>(in[1])];
+            uint8_t c = DECODE_TABLE[static_cast<uint8_t>(in[2])];
+            uint8_t d = DECODE_TABLE[static_cast<uint8_t>(in[3])];
+            if ((a | b | c | d) >= 64) {
+              break;
+            }
+            uint32_t chunk = (a << 18) | (b << 12) | (c << 6) | d;
+            state.out[0] = static_cast<uint8_t>(chunk >> 16);
+            state.out[1] = static_cast<uint8_t>(chunk >> 8);
+            state.out[2] = static_cast<uint8_t>(chunk);
+          }
+          if (in == end) {
+            break;
+          }
+        }
+
+        char c = *in++;
+        if (c == '=') {
+          state.padding++;
+          continue;
+        }
+        uint8_t value = DECODE_TABLE[static_cast<uint8_t>(c)];
+        if (value == SKIP) {
+          skipped = true;
+          continue;
+        }
+        if (value == INVALID || state.padding > 0) {
+          // Unknown character, or data after the padding.
+          badBase64();
+        }
+        state.chunk = (state.chunk << 6) | value;
+        if (++state.filled == 4) {
+          state.out[0] = static_cast<uint8_t>(state.chunk >> 16);
+          state.out[1] = static_cast<uint8_t>(state.chunk >> 8);
+          state.out[2] = static_cast<uint8_t>(state.chunk);
+          state.out += 3;
+          state.chunk = 0;
+          state.filled = 0;
+        }
+      }
+      return in;
+    }
+
+    /**
+     * Writes the bytes of a partial last quartet and checks its padding.
+     */
+    void finishDecode(DecodeState& state) {
+      switch (state.filled) {
+        case 0:
+          if (state.padding != 0) {
+            badBase64();
+          }
+          break;
+        case 2:
+          if (state.padding != 0 && state.padding != 2) {
+            badBase64();
+          }
+          *state.out++ = static_cast<uint8_t>(state.chunk >> 4);
+          break;
+        case 3:
+          if (state.padding > 1) {
+            badBase64();
+          }
+          *state.out++ = static_cast<uint8_t>(state.chunk >> 10);
+          *state.out++ = static_cast<uint8_t>(state.chunk >> 2);
+          break;
+        default:
+          badBase64();
+      }
+    }
+
+#if ESPPROV_BASE64_SSSE3
+    // pragma MARK: SSSE3
+
+    bool hasSsse3() noexcept {
+      unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+      return __get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0 && (ecx & bit_SSSE3) != 0;
+    }
+
+    /// Wojciech Muła's multiply-shift split of 3 bytes into 4 sextets, then one shuffle that maps
+    /// each sextet's range to the offset of its alphabet run.
+    __attribute__((target("ssse3"))) size_t encodeSsse3(const uint8_t* in, size_t size, char* out) noexcept {
+      const __m128i spread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+      const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+      size_t i = 0;
+      // Loads 16 bytes to use 12
+      for (; i + 16 <= size; i += 12, out += 16) {
+        __m128i bytes = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), spread);
+        __m128i high = _mm_mulhi_epu16(_mm_and_si128(bytes, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+        __m128i low = _mm_mullo_epi16(_mm_and_si128(bytes, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+        __m128i sextets = _mm_or_si128(high, low);
+        // 0 for a-z, 1-10 for 0-9, 11 for +, 12 for /, and 13 for A-Z
+        __m128i run = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+        run = _mm_or_si128(run, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), sextets), _mm_set1_epi8(13)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_add_epi8(sextets, _mm_shuffle_epi8(offsets, run)));
+      }
+      return i;
+    }
+
+    /// The nibble table check and decode of Muła and Lemire: a character is in the alphabet when the
+    /// class bits of its low and high nibble share no bit.
+    __attribute__((target("ssse3"))) size_t decodeSsse3(const char* in, size_t size, uint8_t* out) noexcept {
+      const __m128i lowClasses = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B,
+                                               0x1B, 0x1A);
+      const __m128i highClasses = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                                0x10, 0x10);
+      const __m128i offsets = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+      const __m128i slash = _mm_set1_epi8(0x2F);
+      const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+      size_t i = 0;
+      for (; i + 16 <= size; i += 16, out += 12) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Masking with 0x2F clears bit 7, which would zero the shuffle; the shuffles ignore bits 4-6
+        __m128i highNibbles = _mm_and_si128(_mm_srli_epi32(chars, 4), slash);
+        __m128i lowNibbles = _mm_and_si128(chars, slash);
+        __m128i invalid = _mm_and_si128(_mm_shuffle_epi8(lowClasses, lowNibbles), _mm_shuffle_epi8(highClasses, highNibbles));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128())) != 0xFFFF) {
+          break;
+        }
+        // '/' shares its high nibble with '+', the compare moves it to its own offset
+        __m128i offset = _mm_shuffle_epi8(offsets, _mm_add_epi8(_mm_cmpeq_epi8(chars, slash), highNibbles));
+        __m128i sextets = _mm_add_epi8(chars, offset);
+        __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+        __m128i bytes = _mm_shuffle_epi8(merged, pack);
+        // 12 bytes, a 16 byte store could run past the output
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+        uint32_t last = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(bytes, 8)));
+        std::memcpy(out + 8, &last, sizeof(last));
+      }
+      return i;
+    }
+#endif
+
+#if ESPPROV_BASE64_NEON
+    // pragma MARK: NEON
+
+    /// The structured loads split 48 bytes into three planes and 64 characters into four, so the bit
+    /// shuffling is plain shifts and each lookup is one table instruction.
+    size_t encodeNeon(const uint8_t* in, size_t size, char* out) noexcept {
+      const uint8_t* alphabet = reinterpret_cast<const uint8_t*>(ALPHABET);
+      const uint8x16x4_t table = {{vld1q_u8(alphabet), vld1q_u8(alphabet + 16), vld1q_u8(alphabet + 32), vld1q_u8(alphabet + 48)}};
+      const uint8x16_t mask = vdupq_n_u8(0x3F);
+      size_t i = 0;
+      for (; i + 48 <= size; i += 48, out += 64) {
+        uint8x16x3_t bytes = vld3q_u8(in + i);
+        uint8x16x4_t chars;
+        chars.val[0] = vqtbl4q_u8(table, vshrq_n_u8(bytes.val[0], 2));
+        chars.val[1] = vqtbl4q_u8(table, vandq_u8(vorrq_u8(vshlq_n_u8(bytes.val[0], 4), vshrq_n_u8(bytes.val[1], 4)), mask));
+        chars.val[2] = vqtbl4q_u8(table, vandq_u8(vorrq_u8(vshlq_n_u8(bytes.val[1], 2), vshrq_n_u8(bytes.val[2], 6)), mask));
+        chars.val[3] = vqtbl4q_u8(table, vandq_u8(bytes.val[2], mask));
+        vst4q_u8(reinterpret_cast<uint8_t*>(out), chars);
+      }
+      return i;
+    }
+
+    size_t decodeNeon(const char* in, size_t size, uint8_t* out) noexcept {
+      const uint8_t* values = DECODE_TABLE.data();
+      const uint8x16x4_t low = {{vld1q_u8(values), vld1q_u8(values + 16), vld1q_u8(values + 32), vld1q_u8(values + 48)}};
+      const uint8x16x4_t high = {{vld1q_u8(values + 64), vld1q_u8(values + 80), vld1q_u8(values + 96), vld1q_u8(values + 112)}};
+      const uint8x16_t halfway = vdupq_n_u8(64);
+      size_t i = 0;
+      for (; i + 64 <= size; i += 64, out += 48) {
+        uint8x16x4_t chars = vld4q_u8(reinterpret_cast<const uint8_t*>(in + i));
+        uint8x16x4_t sextets;
+        uint8x16_t invalid = vdupq_n_u8(0);
+        for (int plane = 0; plane < 4; plane++) {
+          // Indices past 63 read 0, so a character below 128 hits one half and one from 128 neither
+          sextets.val[plane] = vorrq_u8(vqtbl4q_u8(low, chars.val[plane]), vqtbl4q_u8(high, vsubq_u8(chars.val[plane], halfway)));
+          // INVALID and SKIP have bit 7 set, as have the characters from 128
+          invalid = vorrq_u8(invalid, vorrq_u8(sextets.val[plane], chars.val[plane]));
+        }
+        if (vmaxvq_u8(invalid) >= 0x80) {
+          break;
+        }
+        uint8x16x3_t bytes;
+        bytes.val[0] = vorrq_u8(vshlq_n_u8(sextets.val[0], 2), vshrq_n_u8(sextets.val[1], 4));
+        bytes.val[1] = vorrq_u8(vshlq_n_u8(sextets.val[1], 4), vshrq_n_u8(sextets.val[2], 2));
+        bytes.val[2] = vorrq_u8(vshlq_n_u8(sextets.val[2], 6), sextets.val[3]);
+        vst3q_u8(out, bytes);
+      }
+      return i;
+    }
+#endif
+
+    void requireSupported(Base64Kernel kernel) {
+      if (!isBase64KernelSupported(kernel)) {
+        throw std::invalid_argument(std::string("base64 kernel ") + base64KernelName(kernel) + " is not available on this CPU");
+      }
+    }
+
+    EncodeKernel encodeKernel(Base64Kernel kernel) noexcept {
+      switch (kernel) {
+#if ESPPROV_BASE64_SSSE3
+        case Base64Kernel::SSSE3:
+          return encodeSsse3;
+#endif
+#if ESPPROV_BASE64_NEON
+        case Base64Kernel::NEON:
+          return encodeNeon;
+#endif
+        default:
+          return nullptr;
+      }
+    }
+
+    DecodeKernel decodeKernel(Base64Kernel kernel) noexcept {
+      switch (kernel) {
+#if ESPPROV_BASE64_SSSE3
+        case Base64Kernel::SSSE3:
+          return decodeSsse3;
+#endif
+#if ESPPROV_BASE64_NEON
+        case Base64Kernel::NEON:
+          return decodeNeon;
+#endif
+        default:
+          return nullptr;
+      }
+    }
+  } // namespace
+
+  bool isBase64KernelSupported(Base64Kernel kernel) noexcept {
+    switch (kernel) {
+      case Base64Kernel::SCALAR:
+        return true;
+      case Base64Kernel::SSSE3: {
+#if ESPPROV_BASE64_SSSE3
+        static const bool supported = hasSsse3();
+        return supported;
+#else
+        return false;
+#endif
+      }
+      case Base64Kernel::NEON:
+#if ESPPROV_BASE64_NEON
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+  }
+
+  Base64Kernel fastestBase64Kernel() noexcept {
+    static const Base64Kernel fastest = [] {
+      for (Base64Kernel kernel : {Base64Kernel::SSSE3, Base64Kernel::NEON}) {
+        if (isBase64KernelSupported(kernel)) {
+          return kernel;
+        }
+      }
+      return Base64Kernel::SCALAR;
+    }();
+    return fastest;
+  }
+
+  const char* base64KernelName(Base64Kernel kernel) noexcept {
+    switch (kernel) {
+      case Base64Kernel::SCALAR:
+        return "scalar";
+      case Base64Kernel::SSSE3:
+        return "ssse3";
+      case Base64Kernel::NEON:
+        return "neon";
+    }
+    return "unknown";
+  }
+
+  std::string encodeBase64(ByteView bytes) {
+    return encodeBase64(bytes, fastestBase64Kernel());
+  }
+
+  std::string encodeBase64(ByteView bytes, Base64Kernel kernel) {
+    requireSupported(kernel);
+    std::string out((bytes.size() + 2) / 3 * 4, '\0');
+    size_t done = 0;
+    if (EncodeKernel encode = encodeKernel(kernel)) {
+      done = encode(bytes.data(), bytes.size(), out.data());
+    }
+    encodeScalar(bytes.data() + done, bytes.size() - done, out.data() + done / 3 * 4);
+    return out;
+  }
+
+  Bytes decodeBase64(std::string_view base64) {
+    return decodeBase64(base64, fastestBase64Kernel());
+  }
+
+  Bytes decodeBase64(std::string_view base64, Base64Kernel kernel) {
+    requireSupported(kernel);
+    // Room for every character being data, trimmed once the line breaks and padding are known
+    Bytes out(base64.size() / 4 * 3 + 2);
+    DecodeState state{.out = out.data()};
+    DecodeKernel decode = decodeKernel(kernel);
+    const char* in = base64.data();
+    const char* end = in + base64.size();
+    while (in < end) {
+      if (decode != nullptr && state.filled == 0 && state.padding == 0) {
+        size_t consumed = decode(in, static_cast<size_t>(end - in), state.out);
+        in += consumed;
+        state.out += consumed / 4 * 3;
+      }
+      // Steps over what stopped the kernel, then hands back
+      in = decodeScalar(in, end, state, decode != nullptr);
+    }
+    finishDecode(state);
+    out.resize(static_cast<size_t>(state.out - out.data()));
+    return out;
+  }
+
+} // namespace espprov
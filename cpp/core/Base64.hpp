@@ -0,0 +1,62 @@
+///
+/// Base64.hpp
+/// RFC 4648 base64, used to move custom endpoint payloads across the JS boundary as strings.
+///
+
+#pragma once
+
+#include "Bytes.hpp"
+#include <string>
+#include <string_view>
+
+namespace espprov {
+
+  /**
+   * The loops that encode and decode whole blocks. The scalar loop always finishes the tail, and
+   * takes over around line breaks and padding.
+   */
+  enum class Base64Kernel : uint8_t {
+    SCALAR,
+    // x86, 12 bytes to 16 characters per step
+    SSSE3,
+    // arm64, 48 bytes to 64 characters per step
+    NEON,
+  };
+
+  /**
+   * Whether this build and this CPU can run `kernel`. Detected once.
+   */
+  bool isBase64KernelSupported(Base64Kernel kernel) noexcept;
+
+  /**
+   * The vector kernel if there is one, `SCALAR` otherwise. What the one argument overloads use.
+   */
+  Base64Kernel fastestBase64Kernel() noexcept;
+
+  const char* base64KernelName(Base64Kernel kernel) noexcept;
+
+  /**
+   * Encodes with the standard alphabet and padding, without line breaks.
+   */
+  std::string encodeBase64(ByteView bytes);
+
+  /**
+   * Same output with a given kernel, for the benchmarks. Throws `std::invalid_argument` if the
+   * kernel is not supported.
+   */
+  std::string encodeBase64(ByteView bytes, Base64Kernel kernel);
+
+  /**
+   * Decodes the standard alphabet. Padding is optional and line breaks are skipped, so the output
+   * of Android's `Base64.DEFAULT` is accepted. Throws `ProtocommError(RUNTIME_BAD_BASE64_DATA)`
+   * on anything else. Validation happens while decoding, the input is read once.
+   */
+  Bytes decodeBase64(std::string_view base64);
+
+  /**
+   * Same output with a given kernel, for the benchmarks. Throws `std::invalid_argument` if the
+   * kernel is not supported.
+   */
+  Bytes decodeBase64(std::string_view base64, Base64Kernel kernel);
+
+} // namespace espprov
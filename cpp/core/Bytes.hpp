@@ -0,0 +1,43 @@
+///
+/// Bytes.hpp
+/// Byte buffer aliases shared by the native protocomm engine.
+///
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace espprov {
+
+  /**
+   * An owning, growable byte buffer.
+   */
+  using Bytes = std::vector<uint8_t>;
+
+  /**
+   * A non-owning view over contiguous bytes.
+   */
+  using ByteView = std::span<const uint8_t>;
+
+  /**
+   * A non-owning, writable view over contiguous bytes, e.g. a caller provided output buffer.
+   */
+  using MutableByteView = std::span<uint8_t>;
+
+  inline ByteView asBytes(std::string_view str) noexcept {
+    return ByteView(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+  }
+
+  inline std::string_view asString(ByteView bytes) noexcept {
+    return std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  }
+
+  inline Bytes toBytes(std::string_view str) {
+    return Bytes(str.begin(), str.end());
+  }
+
+} // namespace espprov
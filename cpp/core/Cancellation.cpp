@@ -0,0 +1,114 @@
+///
+/// Cancellation.cpp
+/// Cooperative cancellation for native operations.
+///
+
+#include "Cancellation.hpp"
+#include "Errors.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace espprov {
+
+  namespace detail {
+    struct CancellationState {
+      std::atomic<bool> cancelled{false};
+      std::mutex mutex;
+      uint64_t nextId = 1;
+      std::vector<std::pair<uint64_t, std::function<void()>>> callbacks;
+    };
+  } // namespace detail
+
+  // pragma MARK: CancellationRegistration
+
+  CancellationRegistration::~CancellationRegistration() {
+    reset();
+  }
+
+  CancellationRegistration::CancellationRegistration(CancellationRegistration&& other) noexcept
+      : _state(std::move(other._state)), _id(std::exchange(other._id, 0)) {}
+
+  CancellationRegistration& CancellationRegistration::operator=(CancellationRegistration&& other) noexcept {
+    if (this != &other) {
+      reset();
+      _state = std::move(other._state);
+      _id = std::exchange(other._id, 0);
+    }
+    return *this;
+  }
+
+  void CancellationRegistration::reset() noexcept {
+    std::shared_ptr<detail::CancellationState> state = _state.lock();
+    _state.reset();
+    if (state == nullptr || _id == 0) {
+      return;
+    }
+    std::function<void()> removed;
+    {
+      std::lock_guard lock(state->mutex);
+      for (auto it = state->callbacks.begin(); it != state->callbacks.end(); ++it) {
+        if (it->first == _id) {
+          removed = std::move(it->second);
+          state->callbacks.erase(it);
+          break;
+        }
+      }
+    }
+    _id = 0;
+  }
+
+  // pragma MARK: CancellationToken
+
+  bool CancellationToken::isCancelled() const noexcept {
+    return _state != nullptr && _state->cancelled.load(std::memory_order_acquire);
+  }
+
+  void CancellationToken::throwIfCancelled(const char* what) const {
+    if (isCancelled()) {
+      throw ProtocommError(ErrorCode::OPERATION_CANCELLED, std::string(what) + " was cancelled");
+    }
+  }
+
+  CancellationRegistration CancellationToken::onCancel(std::function<void()> callback) const {
+    if (_state == nullptr) {
+      return {};
+    }
+    {
+      std::lock_guard lock(_state->mutex);
+      if (!_state->cancelled.load(std::memory_order_relaxed)) {
+        uint64_t id = _state->nextId++;
+        _state->callbacks.emplace_back(id, std::move(callback));
+        return CancellationRegistration(_state, id);
+      }
+    }
+    callback();
+    return {};
+  }
+
+  // pragma MARK: CancellationSource
+
+  CancellationSource::CancellationSource(): _state(std::make_shared<detail::CancellationState>()) {}
+
+  bool CancellationSource::cancel() {
+    std::vector<std::pair<uint64_t, std::function<void()>>> callbacks;
+    {
+      std::lock_guard lock(_state->mutex);
+      if (_state->cancelled.exchange(true, std::memory_order_acq_rel)) {
+        return false;
+      }
+      callbacks.swap(_state->callbacks);
+    }
+    for (auto& [id, callback] : callbacks) {
+      callback();
+    }
+    return true;
+  }
+
+  bool CancellationSource::isCancelled() const noexcept {
+    return _state->cancelled.load(std::memory_order_acquire);
+  }
+
+} // namespace espprov
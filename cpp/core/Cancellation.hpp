@@ -0,0 +1,95 @@
+///
+/// Cancellation.hpp
+/// Cooperative cancellation for native operations.
+///
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace espprov {
+
+  namespace detail {
+    struct CancellationState;
+  } // namespace detail
+
+  /**
+   * Unregisters a cancellation callback on destruction. A callback already running on another
+   * thread by then still runs to its end, so callbacks must own what they touch.
+   */
+  class CancellationRegistration {
+  public:
+    CancellationRegistration() = default;
+    ~CancellationRegistration();
+    CancellationRegistration(CancellationRegistration&& other) noexcept;
+    CancellationRegistration& operator=(CancellationRegistration&& other) noexcept;
+    CancellationRegistration(const CancellationRegistration&) = delete;
+    CancellationRegistration& operator=(const CancellationRegistration&) = delete;
+
+    void reset() noexcept;
+
+  private:
+    friend class CancellationToken;
+    CancellationRegistration(std::weak_ptr<detail::CancellationState> state, uint64_t id) noexcept: _state(std::move(state)), _id(id) {}
+
+    std::weak_ptr<detail::CancellationState> _state;
+    uint64_t _id = 0;
+  };
+
+  /**
+   * The side of a cancellation that operations observe. Cheap to copy. A default constructed
+   * token is never cancelled.
+   */
+  class CancellationToken {
+  public:
+    CancellationToken() = default;
+
+    bool canBeCancelled() const noexcept {
+      return _state != nullptr;
+    }
+    bool isCancelled() const noexcept;
+
+    /**
+     * Throws `ProtocommError(OPERATION_CANCELLED)` naming `what` if the token is cancelled.
+     */
+    void throwIfCancelled(const char* what) const;
+
+    /**
+     * Calls `callback` once when the token is cancelled, on the thread that cancels it, or right
+     * away on this thread if it already is. Nothing is registered on a token that can not be
+     * cancelled.
+     */
+    [[nodiscard]] CancellationRegistration onCancel(std::function<void()> callback) const;
+
+  private:
+    friend class CancellationSource;
+    explicit CancellationToken(std::shared_ptr<detail::CancellationState> state) noexcept: _state(std::move(state)) {}
+
+    std::shared_ptr<detail::CancellationState> _state;
+  };
+
+  /**
+   * The side of a cancellation that the caller keeps.
+   */
+  class CancellationSource {
+  public:
+    CancellationSource();
+
+    CancellationToken token() const noexcept {
+      return CancellationToken(_state);
+    }
+
+    /**
+     * Cancels the token and runs its callbacks on this thread, in registration order. Returns
+     * false if it was cancelled before.
+     */
+    bool cancel();
+    bool isCancelled() const noexcept;
+
+  private:
+    std::shared_ptr<detail::CancellationState> _state;
+  };
+
+} // namespace espprov
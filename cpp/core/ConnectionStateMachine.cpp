@@ -0,0 +1,270 @@
+///
+/// ConnectionStateMachine.cpp
+/// Per-device connection states fed directly by transport and session events.
+///
+
+#include "ConnectionStateMachine.hpp"
+#include "Errors.hpp"
+#include "Tracer.hpp"
+#include <array>
+#include <algorithm>
+#include <vector>
+
+namespace espprov {
+
+  namespace {
+    constexpr std::array<std::string_view, 5> STATE_NAMES = {"IDLE", "CONNECTING", "SECURING", "SECURED", "LOST"};
+  } // namespace
+
+  ConnectionStateMachine::ConnectionStateMachine(std::string deviceName, ConnectionTimeouts timeouts, Notify notify)
+      : _deviceName(std::move(deviceName)), _timeouts(timeouts), _notify(std::move(notify)) {}
+
+  std::optional<ConnectionState> ConnectionStateMachine::next(ConnectionState from, ConnectionEvent event) noexcept {
+    using State = ConnectionState;
+    using Event = ConnectionEvent;
+    if (event == Event::DISCONNECT_REQUESTED) {
+      return from == State::IDLE ? std::nullopt : std::optional(State::IDLE);
+    }
+    switch (from) {
+      case State::IDLE:
+        break;
+      case State::CONNECTING:
+        switch (event) {
+          case Event::LINK_UP:
+            return State::SECURING;
+          // Transports that open the link as part of the handshake report only the outcome
+          case Event::SESSION_ESTABLISHED:
+            return State::SECURED;
+          case Event::LINK_FAILED:
+          case Event::LINK_DOWN:
+          case Event::SESSION_FAILED:
+          case Event::TIMEOUT:
+            return State::LOST;
+          default:
+            break;
+        }
+        break;
+      case State::SECURING:
+        switch (event) {
+          case Event::SESSION_ESTABLISHED:
+            return State::SECURED;
+          case Event::LINK_FAILED:
+          case Event::LINK_DOWN:
+          case Event::SESSION_FAILED:
+          case Event::TIMEOUT:
+            return State::LOST;
+          default:
+            break;
+        }
+        break;
+      case State::SECURED:
+        if (event == Event::LINK_DOWN || event == Event::SESSION_FAILED) {
+          return State::LOST;
+        }
+        break;
+      case State::LOST:
+        // A handshake that finished after its attempt timed out still left a session behind
+        if (event == Event::SESSION_ESTABLISHED) {
+          return State::SECURED;
+        }
+        break;
+    }
+    if (event == Event::CONNECT_REQUESTED && from != State::CONNECTING && from != State::SECURING) {
+      return State::CONNECTING;
+    }
+    return std::nullopt;
+  }
+
+  uint64_t ConnectionStateMachine::beginConnect() {
+    std::vector<ConnectionTransition> transitions;
+    uint64_t attempt;
+    {
+      std::lock_guard lock(_mutex);
+      if (auto expired = expireLocked(Clock::now())) {
+        transitions.push_back(std::move(*expired));
+      }
+      if (_state != ConnectionState::CONNECTING && _state != ConnectionState::SECURING) {
+        _attempt++;
+        if (auto started = applyLocked(ConnectionEvent::CONNECT_REQUESTED, std::nullopt)) {
+          transitions.push_back(std::move(*started));
+        }
+      }
+      attempt = _attempt;
+    }
+    for (ConnectionTransition& transition : transitions) {
+      publish(std::move(transition));
+    }
+    return attempt;
+  }
+
+  bool ConnectionStateMachine::post(ConnectionEvent event, uint64_t attempt, std::optional<int> error) {
+    if (event == ConnectionEvent::CONNECT_REQUESTED) {
+      return false; // attempts start through beginConnect(), which numbers them
+    }
+    std::vector<ConnectionTransition> transitions;
+    {
+      std::lock_guard lock(_mutex);
+      if (auto expired = expireLocked(Clock::now())) {
+        transitions.push_back(std::move(*expired));
+      }
+      if (attempt == 0 || attempt == _attempt) {
+        if (auto applied = applyLocked(event, error)) {
+          transitions.push_back(std::move(*applied));
+        }
+      }
+    }
+    bool applied = !transitions.empty() && transitions.back().event == event;
+    for (ConnectionTransition& transition : transitions) {
+      publish(std::move(transition));
+    }
+    return applied;
+  }
+
+  ConnectionState ConnectionStateMachine::state() {
+    std::optional<ConnectionTransition> expired;
+    ConnectionState state;
+    {
+      std::lock_guard lock(_mutex);
+      expired = expireLocked(Clock::now());
+      state = _state;
+    }
+    publish(std::move(expired));
+    return state;
+  }
+
+  uint64_t ConnectionStateMachine::attempt() {
+    std::lock_guard lock(_mutex);
+    return _attempt;
+  }
+
+  ConnectionState ConnectionStateMachine::awaitLeaving(ConnectionState state, uint64_t attempt, std::chrono::milliseconds limit) {
+    TraceSpan trace(TraceCategory::DEVICE, "await connection state", _deviceName);
+    Clock::time_point giveUp = Clock::now() + limit;
+    std::unique_lock lock(_mutex);
+    while (true) {
+      Clock::time_point now = Clock::now();
+      if (auto expired = expireLocked(now)) {
+        lock.unlock();
+        publish(std::move(expired));
+        lock.lock();
+        continue;
+      }
+      if (_state != state || _attempt != attempt || now >= giveUp) {
+        return _state;
+      }
+      Clock::time_point wakeUp = _deadline.has_value() ? std::min(giveUp, *_deadline) : giveUp;
+      _changed.wait_until(lock, wakeUp);
+    }
+  }
+
+  std::optional<ConnectionTransition> ConnectionStateMachine::applyLocked(ConnectionEvent event, std::optional<int> error) {
+    std::optional<ConnectionState> to = next(_state, event);
+    if (!to.has_value()) {
+      return std::nullopt;
+    }
+    ConnectionTransition transition{
+        .deviceName = _deviceName,
+        .from = _state,
+        .to = *to,
+        .event = event,
+        .attempt = _attempt,
+        .error = *to == ConnectionState::LOST ? error : std::nullopt,
+        .at = std::chrono::system_clock::now(),
+    };
+    _state = *to;
+    Tracer::shared().instant(TraceCategory::STATE, STATE_NAMES[static_cast<size_t>(_state)], _deviceName);
+    switch (_state) {
+      case ConnectionState::CONNECTING:
+        _deadline = Clock::now() + _timeouts.connecting;
+        break;
+      case ConnectionState::SECURING:
+        _deadline = Clock::now() + _timeouts.securing;
+        break;
+      default:
+        _deadline.reset();
+        break;
+    }
+    _changed.notify_all();
+    return transition;
+  }
+
+  std::optional<ConnectionTransition> ConnectionStateMachine::expireLocked(Clock::time_point now) {
+    if (!_deadline.has_value() || now < *_deadline) {
+      return std::nullopt;
+    }
+    return applyLocked(ConnectionEvent::TIMEOUT, static_cast<int>(ErrorCode::PROV_TIMED_OUT_ERROR));
+  }
+
+  void ConnectionStateMachine::publish(std::optional<ConnectionTransition> transition) {
+    if (transition.has_value() && _notify) {
+      _notify(*transition);
+    }
+  }
+
+  // pragma MARK: ConnectionRegistry
+
+  ConnectionRegistry& ConnectionRegistry::shared() {
+    static ConnectionRegistry registry;
+    return registry;
+  }
+
+  std::shared_ptr<ConnectionStateMachine> ConnectionRegistry::machine(const std::string& deviceName) {
+    std::lock_guard lock(_machinesMutex);
+    std::shared_ptr<ConnectionStateMachine>& machine = _machines[deviceName];
+    if (machine == nullptr) {
+      machine = std::make_shared<ConnectionStateMachine>(deviceName, _timeouts,
+                                                         [this](const ConnectionTransition& transition) { notify(transition); });
+    }
+    return machine;
+  }
+
+  std::optional<ConnectionState> ConnectionRegistry::state(const std::string& deviceName) {
+    std::shared_ptr<ConnectionStateMachine> machine;
+    {
+      std::lock_guard lock(_machinesMutex);
+      auto it = _machines.find(deviceName);
+      if (it == _machines.end()) {
+        return std::nullopt;
+      }
+      machine = it->second;
+    }
+    return machine->state();
+  }
+
+  void ConnectionRegistry::remove(const std::string& deviceName) {
+    std::lock_guard lock(_machinesMutex);
+    _machines.erase(deviceName);
+  }
+
+  void ConnectionRegistry::setTimeouts(ConnectionTimeouts timeouts) {
+    std::lock_guard lock(_machinesMutex);
+    _timeouts = timeouts;
+  }
+
+  uint64_t ConnectionRegistry::addListener(Listener listener) {
+    std::lock_guard lock(_listenersMutex);
+    uint64_t id = _nextListenerId++;
+    _listeners.emplace(id, std::make_shared<const Listener>(std::move(listener)));
+    return id;
+  }
+
+  bool ConnectionRegistry::removeListener(uint64_t id) {
+    std::lock_guard lock(_listenersMutex);
+    return _listeners.erase(id) > 0;
+  }
+
+  void ConnectionRegistry::notify(const ConnectionTransition& transition) {
+    std::vector<std::shared_ptr<const Listener>> listeners;
+    {
+      std::lock_guard lock(_listenersMutex);
+      listeners.reserve(_listeners.size());
+      for (const auto& entry : _listeners) {
+        listeners.push_back(entry.second);
+      }
+    }
+    for (const std::shared_ptr<const Listener>& listener : listeners) {
+      (*listener)(transition);
+    }
+  }
+
+} // namespace espprov
@@ -0,0 +1,168 @@
+///
+/// ConnectionStateMachine.hpp
+/// Per-device connection states fed directly by transport and session events.
+///
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace espprov {
+
+  /**
+   * Values match `PTConnectionState`.
+   */
+  enum class ConnectionState : uint8_t {
+    /// No link and no attempt running.
+    IDLE = 0,
+    /// Waiting for the transport link.
+    CONNECTING = 1,
+    /// The link is up, the security handshake runs.
+    SECURING = 2,
+    /// The session is established.
+    SECURED = 3,
+    /// The last attempt failed, timed out or the link dropped.
+    LOST = 4,
+  };
+
+  /**
+   * What drives a transition. Values match `PTConnectionEvent`.
+   */
+  enum class ConnectionEvent : uint8_t {
+    CONNECT_REQUESTED = 0,
+    LINK_UP = 1,
+    LINK_FAILED = 2,
+    LINK_DOWN = 3,
+    SESSION_ESTABLISHED = 4,
+    SESSION_FAILED = 5,
+    DISCONNECT_REQUESTED = 6,
+    TIMEOUT = 7,
+  };
+
+  struct ConnectionTransition {
+    std::string deviceName;
+    ConnectionState from;
+    ConnectionState to;
+    ConnectionEvent event;
+    /// The connect attempt the transition belongs to, counting from 1 per device.
+    uint64_t attempt;
+    /// The `ErrorCode` that ended the attempt, if any.
+    std::optional<int> error;
+    std::chrono::system_clock::time_point at;
+  };
+
+  /**
+   * How long an attempt may stay in each transient state before it is declared lost.
+   */
+  struct ConnectionTimeouts {
+    std::chrono::milliseconds connecting = std::chrono::seconds(15);
+    std::chrono::milliseconds securing = std::chrono::seconds(15);
+  };
+
+  /**
+   * The state of one device's connection. The platform layers and the engine post what they
+   * observe, whoever needs the outcome waits on the state instead of subscribing to the event, so
+   * an event that arrives before anyone waits is not lost.
+   *
+   * Events name the attempt they belong to. Events of an attempt that was superseded by a newer
+   * `beginConnect` are dropped, which keeps a late `LINK_DOWN` of a previous link from tearing
+   * down a fresh one during rapid reconnects. Attempt 0 means "whichever attempt is current".
+   *
+   * Timeouts are evaluated lazily, whenever the machine is read, posted to or waited on.
+   * Thread safe.
+   */
+  class ConnectionStateMachine {
+  public:
+    using Clock = std::chrono::steady_clock;
+    using Notify = std::function<void(const ConnectionTransition&)>;
+
+    ConnectionStateMachine(std::string deviceName, ConnectionTimeouts timeouts, Notify notify);
+
+    /**
+     * Starts an attempt from `IDLE`, `LOST` or `SECURED` and returns its number. While an attempt
+     * is `CONNECTING` or `SECURING` the caller joins it instead and gets its number.
+     */
+    uint64_t beginConnect();
+
+    /**
+     * Applies `event` to `attempt`. Returns false if the event is stale or the current state does
+     * not accept it.
+     */
+    bool post(ConnectionEvent event, uint64_t attempt = 0, std::optional<int> error = std::nullopt);
+
+    ConnectionState state();
+    uint64_t attempt();
+
+    /**
+     * Blocks until the machine leaves `state`, `attempt` is superseded or `limit` passes, and
+     * returns the state it is in then. State timeouts fire while waiting.
+     */
+    ConnectionState awaitLeaving(ConnectionState state, uint64_t attempt, std::chrono::milliseconds limit);
+
+    /**
+     * The state `event` moves `from` to, if it applies there.
+     */
+    static std::optional<ConnectionState> next(ConnectionState from, ConnectionEvent event) noexcept;
+
+  private:
+    std::optional<ConnectionTransition> applyLocked(ConnectionEvent event, std::optional<int> error);
+    std::optional<ConnectionTransition> expireLocked(Clock::time_point now);
+    void publish(std::optional<ConnectionTransition> transition);
+
+    const std::string _deviceName;
+    const ConnectionTimeouts _timeouts;
+    const Notify _notify;
+
+    std::mutex _mutex;
+    std::condition_variable _changed;
+    ConnectionState _state = ConnectionState::IDLE;
+    uint64_t _attempt = 0;
+    std::optional<Clock::time_point> _deadline;
+  };
+
+  /**
+   * The process wide connection states, one machine per device name, shared by the engine, the
+   * platform glue and JS listeners.
+   */
+  class ConnectionRegistry {
+  public:
+    using Listener = std::function<void(const ConnectionTransition&)>;
+
+    static ConnectionRegistry& shared();
+
+    /**
+     * The machine of `deviceName`, created in `IDLE` on first use.
+     */
+    std::shared_ptr<ConnectionStateMachine> machine(const std::string& deviceName);
+    std::optional<ConnectionState> state(const std::string& deviceName);
+    void remove(const std::string& deviceName);
+
+    void setTimeouts(ConnectionTimeouts timeouts);
+
+    /**
+     * Listeners are called on the thread that caused the transition, outside of any machine lock.
+     */
+    uint64_t addListener(Listener listener);
+    bool removeListener(uint64_t id);
+
+  private:
+    void notify(const ConnectionTransition& transition);
+
+    std::mutex _machinesMutex;
+    std::unordered_map<std::string, std::shared_ptr<ConnectionStateMachine>> _machines;
+    ConnectionTimeouts _timeouts;
+
+    std::mutex _listenersMutex;
+    std::unordered_map<uint64_t, std::shared_ptr<const Listener>> _listeners;
+    uint64_t _nextListenerId = 1;
+  };
+
+} // namespace espprov
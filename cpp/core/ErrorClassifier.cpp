@@ -0,0 +1,213 @@
+///
+/// ErrorClassifier.cpp
+/// Maps SDK error codes and free-text error messages to `ErrorCode`, shared by the Kotlin and Swift layers.
+///
+
+#include "ErrorClassifier.hpp"
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+
+namespace espprov {
+
+  namespace {
+    // The messages the Espressif Android SDK and its SRP library throw without a code
+    constexpr ErrorPattern PATTERNS[] = {
+        {ErrorCode::WIFI_SCAN_EMPTY_CONFIG_DATA, "Empty config data during WiFi scan"},
+        {ErrorCode::WIFI_SCAN_EMPTY_CONFIG_DATA, "Config data is empty"},
+        {ErrorCode::WIFI_SCAN_REQUEST_ERROR, "Failed to send Wi-Fi scan command."},
+        {ErrorCode::WIFI_SCAN_REQUEST_ERROR, "Failed to get Wi-Fi Networks."},
+        {ErrorCode::WIFI_SCAN_REQUEST_ERROR, "Failed to get Wi-Fi status."},
+        {ErrorCode::SESSION_INIT_ERROR, "Failed to create session."},
+        {ErrorCode::SESSION_NOT_ESTABLISHED, "Session could not be established"},
+        {ErrorCode::SESSION_NOT_ESTABLISHED, "Session establishment failed !"},
+        {ErrorCode::SESSION_SEND_DATA_ERROR, "Failed to send wifi credentials to device"},
+        {ErrorCode::SESSION_SEND_DATA_ERROR, "No response from device"},
+        {ErrorCode::SOFTAP_CONNECTION_FAILURE, "Error ! Connection Lost"},
+        {ErrorCode::SESSION_SECURITY_MISMATCH, "Security version mismatch"},
+        {ErrorCode::BLE_FAILED_TO_CONNECT, "Characteristic is not available for given path."},
+        {ErrorCode::BLE_FAILED_TO_CONNECT, "Read from BLE failed"},
+        {ErrorCode::BLE_FAILED_TO_CONNECT, "Write to BLE failed"},
+        {ErrorCode::ENCRYPTION_ERROR, "The public client value 'A' must not be null"},
+        {ErrorCode::ENCRYPTION_ERROR, "The client evidence message 'M1' must not be null"},
+        {ErrorCode::ENCRYPTION_ERROR, "The client public value 'A' must not be null"},
+        {ErrorCode::ENCRYPTION_ERROR, "State violation"},
+        {ErrorCode::ENCRYPTION_ERROR, "The SRP-6a crypto parameters must not be null"},
+        {ErrorCode::ENCRYPTION_ERROR, "Unsupported hash algorithm"},
+        {ErrorCode::ENCRYPTION_ERROR, "The salt 's' must not be null"},
+        {ErrorCode::ENCRYPTION_ERROR, "The verifier 'v' must not be null"},
+        {ErrorCode::ENCRYPTION_ERROR, "The timeout must be zero"},
+        {ErrorCode::ENCRYPTION_ERROR, "The attribute key must not be null"},
+        {ErrorCode::ENCRYPTION_ERROR, "The public server value 'B' must not be null"},
+        {ErrorCode::ENCRYPTION_ERROR, "Bad client public value"},
+        {ErrorCode::ENCRYPTION_ERROR, "Session timeout"},
+        {ErrorCode::ENCRYPTION_ERROR, "Bad server public value"},
+        {ErrorCode::ENCRYPTION_ERROR, "The server evidence message"},
+        {ErrorCode::ENCRYPTION_ERROR, "Bad server credentials"},
+        {ErrorCode::ENCRYPTION_ERROR, "Undefined hash algorithm"},
+        {ErrorCode::ENCRYPTION_ERROR, "The prime parameter"},
+        {ErrorCode::ENCRYPTION_ERROR, "The generator parameter"},
+        {ErrorCode::ENCRYPTION_ERROR, "The cause type must not be null"},
+        {ErrorCode::NO_POP, "The user password 'P' must not be null"},
+        {ErrorCode::NO_USERNAME, "The user identity 'I' must not be null or empty"},
+        {ErrorCode::PROV_CONFIGURATION_ERROR, "Failed to apply wifi credentials"},
+        {ErrorCode::PROV_WIFI_STATUS_UNKNOWN_ERROR, "Provisioning Failed"},
+        {ErrorCode::BLE_SEARCH_ERROR, "BLE scanning failed with error code"},
+        {ErrorCode::BLE_ADAPTER_NOT_AVAILABLE, "Please turn on bluetooth and try again."},
+    };
+
+    inline uint8_t toLower(uint8_t byte) noexcept {
+      return byte >= 'A' && byte <= 'Z' ? static_cast<uint8_t>(byte - 'A' + 'a') : byte;
+    }
+  } // namespace
+
+  std::span<const ErrorPattern> errorPatterns() noexcept {
+    return PATTERNS;
+  }
+
+  bool isKnownErrorCode(int code) noexcept {
+    switch (static_cast<ErrorCode>(code)) {
+      case ErrorCode::WIFI_SCAN_EMPTY_CONFIG_DATA:
+      case ErrorCode::WIFI_SCAN_EMPTY_RESULT_COUNT:
+      case ErrorCode::WIFI_SCAN_REQUEST_ERROR:
+      case ErrorCode::SESSION_INIT_ERROR:
+      case ErrorCode::SESSION_NOT_ESTABLISHED:
+      case ErrorCode::SESSION_SEND_DATA_ERROR:
+      case ErrorCode::SOFTAP_CONNECTION_FAILURE:
+      case ErrorCode::SESSION_SECURITY_MISMATCH:
+      case ErrorCode::SESSION_VERSION_INFO_ERROR:
+      case ErrorCode::BLE_FAILED_TO_CONNECT:
+      case ErrorCode::ENCRYPTION_ERROR:
+      case ErrorCode::NO_POP:
+      case ErrorCode::NO_USERNAME:
+      case ErrorCode::CAMERA_NOT_AVAILABLE:
+      case ErrorCode::CAMERA_ACCESS_DENIED:
+      case ErrorCode::AV_CAPTURE_DEVICE_INPUT_ERROR:
+      case ErrorCode::VIDEO_INPUT_ERROR:
+      case ErrorCode::VIDEO_OUTPUT_ERROR:
+      case ErrorCode::INVALID_QR_CODE:
+      case ErrorCode::BLE_SEARCH_ERROR:
+      case ErrorCode::ESP_DEVICE_NOT_FOUND:
+      case ErrorCode::AP_SEARCH_NOT_SUPPORTED:
+      case ErrorCode::PROV_SESSION_ERROR:
+      case ErrorCode::PROV_CONFIGURATION_ERROR:
+      case ErrorCode::PROV_WIFI_STATUS_ERROR:
+      case ErrorCode::PROV_WIFI_STATUS_DISCONNECTED:
+      case ErrorCode::PROV_WIFI_STATUS_AUTH_ERROR:
+      case ErrorCode::PROV_WIFI_STATUS_NETWORK_NOT_FOUND:
+      case ErrorCode::PROV_WIFI_STATUS_UNKNOWN_ERROR:
+      case ErrorCode::PROV_TIMED_OUT_ERROR:
+      case ErrorCode::PROV_UNKNOWN_ERROR:
+      case ErrorCode::RUNTIME_BAD_CLOSURE_ARGS:
+      case ErrorCode::RUNTIME_DOES_NOT_EXIST_LOCALLY:
+      case ErrorCode::RUNTIME_BAD_BASE64_DATA:
+      case ErrorCode::RUNTIME_UNKNOWN_ERROR:
+      case ErrorCode::ESP_NATIVE_UNKNOWN_ERROR:
+      case ErrorCode::ESP_INSUFFICIENT_PERMISSIONS:
+      case ErrorCode::BLE_ADAPTER_NOT_AVAILABLE:
+      case ErrorCode::OPERATION_CANCELLED:
+        return true;
+    }
+    return false;
+  }
+
+  const ErrorClassifier& ErrorClassifier::shared() {
+    static const ErrorClassifier classifier(errorPatterns());
+    return classifier;
+  }
+
+  ErrorClassifier::ErrorClassifier(std::span<const ErrorPattern> patterns): _patterns(patterns.begin(), patterns.end()) {
+    if (_patterns.size() >= NO_MATCH) {
+      throw std::length_error("Too many error patterns");
+    }
+
+    // Class 0 stands for every byte no pattern contains
+    for (const ErrorPattern& pattern : _patterns) {
+      for (char ch : pattern.text) {
+        uint8_t byte = toLower(static_cast<uint8_t>(ch));
+        if (_byteClass[byte] == 0) {
+          uint8_t byteClass = static_cast<uint8_t>(_classCount++);
+          _byteClass[byte] = byteClass;
+          if (byte >= 'a' && byte <= 'z') {
+            _byteClass[byte - 'a' + 'A'] = byteClass;
+          }
+        }
+      }
+    }
+
+    // The trie, missing edges marked with the root, which no edge leads back to
+    constexpr State ROOT = 0;
+    _next.assign(_classCount, ROOT);
+    _match.assign(1, NO_MATCH);
+    for (size_t index = 0; index < _patterns.size(); index++) {
+      State state = ROOT;
+      for (char ch : _patterns[index].text) {
+        size_t edge = state * _classCount + _byteClass[static_cast<uint8_t>(ch)];
+        if (_next[edge] == ROOT) {
+          if (_match.size() >= UINT16_MAX) {
+            throw std::length_error("Error patterns exceed the automaton size");
+          }
+          _next[edge] = static_cast<State>(_match.size());
+          _next.resize(_next.size() + _classCount, ROOT);
+          _match.push_back(NO_MATCH);
+        }
+        state = _next[edge];
+      }
+      _match[state] = std::min(_match[state], static_cast<uint16_t>(index));
+    }
+
+    // Breadth first, replace missing edges with the failure state's edges, which are final by then
+    std::vector<State> failure(_match.size(), ROOT);
+    std::deque<State> queue;
+    for (size_t byteClass = 0; byteClass < _classCount; byteClass++) {
+      if (State child = _next[byteClass]; child != ROOT) {
+        queue.push_back(child);
+      }
+    }
+    while (!queue.empty()) {
+      State state = queue.front();
+      queue.pop_front();
+      _match[state] = std::min(_match[state], _match[failure[state]]);
+      for (size_t byteClass = 0; byteClass < _classCount; byteClass++) {
+        State& edge = _next[state * _classCount + byteClass];
+        State fallback = _next[failure[state] * _classCount + byteClass];
+        if (edge == ROOT) {
+          edge = fallback;
+        } else {
+          failure[edge] = fallback;
+          queue.push_back(edge);
+        }
+      }
+    }
+  }
+
+  std::optional<ErrorCode> ErrorClassifier::classify(std::string_view message, std::optional<int> sdkCode) const noexcept {
+    if (sdkCode.has_value() && isKnownErrorCode(*sdkCode)) {
+      return static_cast<ErrorCode>(*sdkCode);
+    }
+    State state = 0;
+    uint16_t best = NO_MATCH;
+    for (char ch : message) {
+      state = _next[state * _classCount + _byteClass[static_cast<uint8_t>(ch)]];
+      best = std::min(best, _match[state]);
+      if (best == 0) {
+        break;
+      }
+    }
+    if (best == NO_MATCH) {
+      return std::nullopt;
+    }
+    return _patterns[best].code;
+  }
+
+  std::vector<std::string_view> ErrorClassifier::descriptions(ErrorCode code) const {
+    std::vector<std::string_view> texts;
+    for (const ErrorPattern& pattern : _patterns) {
+      if (pattern.code == code) {
+        texts.push_back(pattern.text);
+      }
+    }
+    return texts;
+  }
+
+} // namespace espprov
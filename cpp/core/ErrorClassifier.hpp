@@ -0,0 +1,76 @@
+///
+/// ErrorClassifier.hpp
+/// Maps SDK error codes and free-text error messages to `ErrorCode`, shared by the Kotlin and Swift layers.
+///
+
+#pragma once
+
+#include "Errors.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace espprov {
+
+  /**
+   * A message fragment that identifies an error. Fragments are matched ignoring ASCII case.
+   */
+  struct ErrorPattern {
+    ErrorCode code;
+    std::string_view text;
+  };
+
+  /**
+   * The one table of known SDK error messages, in priority order: when a message contains several
+   * fragments, the one listed first wins. Codes with several fragments list their canonical
+   * description first.
+   */
+  std::span<const ErrorPattern> errorPatterns() noexcept;
+
+  /**
+   * Whether `code` is one of the `PTError` values.
+   */
+  bool isKnownErrorCode(int code) noexcept;
+
+  /**
+   * Classifies errors in a single pass over the message. The patterns are compiled into one
+   * Aho–Corasick automaton, flattened into a DFA over the byte classes the patterns use, so each
+   * message byte costs one table lookup however many patterns there are.
+   */
+  class ErrorClassifier {
+  public:
+    /**
+     * The classifier over `errorPatterns()`, built on first use.
+     */
+    static const ErrorClassifier& shared();
+
+    explicit ErrorClassifier(std::span<const ErrorPattern> patterns);
+
+    /**
+     * `sdkCode` when the SDK supplied a known code, otherwise the code of the highest priority
+     * pattern found in `message`, if any.
+     */
+    std::optional<ErrorCode> classify(std::string_view message, std::optional<int> sdkCode = std::nullopt) const noexcept;
+
+    /**
+     * The patterns of `code`, canonical description first.
+     */
+    std::vector<std::string_view> descriptions(ErrorCode code) const;
+
+  private:
+    using State = uint16_t;
+    static constexpr uint16_t NO_MATCH = UINT16_MAX;
+
+    std::vector<ErrorPattern> _patterns;
+    std::array<uint8_t, 256> _byteClass{};
+    size_t _classCount = 1;
+    // _next[state * _classCount + class], the failure links already folded in
+    std::vector<State> _next;
+    // The highest priority pattern ending in each state, counting its suffix states
+    std::vector<uint16_t> _match;
+  };
+
+} // namespace espprov
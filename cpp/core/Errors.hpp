@@ -0,0 +1,87 @@
+///
+/// Errors.hpp
+/// Error codes and the exception type thrown by the native protocomm engine.
+///
+
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+namespace espprov {
+
+  /**
+   * Numeric error codes of the native engine.
+   * The values mirror `PTError` in `src/EspProvToolkit.types.ts` one to one, so they can be
+   * handed to JS without any translation.
+   */
+  enum class ErrorCode : int {
+    // WIFI Scan Request Errors
+    WIFI_SCAN_EMPTY_CONFIG_DATA = 1,
+    WIFI_SCAN_EMPTY_RESULT_COUNT = 2,
+    WIFI_SCAN_REQUEST_ERROR = 3,
+
+    // ESP Session Errors
+    SESSION_INIT_ERROR = 11,
+    SESSION_NOT_ESTABLISHED = 12,
+    SESSION_SEND_DATA_ERROR = 13,
+    SOFTAP_CONNECTION_FAILURE = 14,
+    SESSION_SECURITY_MISMATCH = 15,
+    SESSION_VERSION_INFO_ERROR = 16,
+    BLE_FAILED_TO_CONNECT = 17,
+    ENCRYPTION_ERROR = 18,
+    NO_POP = 19,
+    NO_USERNAME = 20,
+
+    // Create, Scan, Search Errors
+    CAMERA_NOT_AVAILABLE = 21,
+    CAMERA_ACCESS_DENIED = 22,
+    AV_CAPTURE_DEVICE_INPUT_ERROR = 23,
+    VIDEO_INPUT_ERROR = 24,
+    VIDEO_OUTPUT_ERROR = 25,
+    INVALID_QR_CODE = 26,
+    BLE_SEARCH_ERROR = 46,
+    ESP_DEVICE_NOT_FOUND = 27,
+    AP_SEARCH_NOT_SUPPORTED = 28,
+
+    // ESP Provision Errors
+    PROV_SESSION_ERROR = 31,
+    PROV_CONFIGURATION_ERROR = 32,
+    PROV_WIFI_STATUS_ERROR = 33,
+    PROV_WIFI_STATUS_DISCONNECTED = 34,
+    PROV_WIFI_STATUS_AUTH_ERROR = 35,
+    PROV_WIFI_STATUS_NETWORK_NOT_FOUND = 36,
+    PROV_WIFI_STATUS_UNKNOWN_ERROR = 37,
+    PROV_TIMED_OUT_ERROR = 45,
+    PROV_UNKNOWN_ERROR = 38,
+
+    // Runtime errors
+    RUNTIME_BAD_CLOSURE_ARGS = 41,
+    RUNTIME_DOES_NOT_EXIST_LOCALLY = 42,
+    RUNTIME_BAD_BASE64_DATA = 43,
+    RUNTIME_UNKNOWN_ERROR = 44,
+
+    // General Errors
+    ESP_NATIVE_UNKNOWN_ERROR = 4,
+    ESP_INSUFFICIENT_PERMISSIONS = 47,
+    BLE_ADAPTER_NOT_AVAILABLE = 48,
+    OPERATION_CANCELLED = 49,
+  };
+
+  /**
+   * The only exception type the engine throws on purpose.
+   * Anything else escaping the engine is a bug and is reported as `ESP_NATIVE_UNKNOWN_ERROR`.
+   */
+  class ProtocommError : public std::runtime_error {
+  public:
+    ProtocommError(ErrorCode code, const std::string& message): std::runtime_error(message), _code(code) {}
+
+    ErrorCode code() const noexcept {
+      return _code;
+    }
+
+  private:
+    ErrorCode _code;
+  };
+
+} // namespace espprov
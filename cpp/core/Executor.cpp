@@ -0,0 +1,78 @@
+///
+/// Executor.cpp
+/// Where native coroutines run and resume: a queue of jobs and timers.
+///
+
+#include "Executor.hpp"
+
+namespace espprov {
+
+  SerialExecutor::SerialExecutor(): _thread([this] { run(); }) {}
+
+  SerialExecutor::~SerialExecutor() {
+    {
+      std::lock_guard lock(_mutex);
+      _stopping = true;
+    }
+    _wake.notify_one();
+    _thread.join();
+  }
+
+  void SerialExecutor::post(Job job) {
+    // Notified under the lock: the job may let its owner destroy the executor before a notify
+    // outside of it would have run, and the destructor takes the lock first
+    std::lock_guard lock(_mutex);
+    _jobs.push_back(std::move(job));
+    _wake.notify_one();
+  }
+
+  void SerialExecutor::postAfter(std::chrono::milliseconds delay, Job job) {
+    std::lock_guard lock(_mutex);
+    _timers.push(Timer{std::chrono::steady_clock::now() + delay, _nextSequence++, std::move(job)});
+    _wake.notify_one();
+  }
+
+  bool SerialExecutor::isCurrent() const noexcept {
+    return std::this_thread::get_id() == _thread.get_id();
+  }
+
+  uint64_t SerialExecutor::jobsRun() const {
+    std::lock_guard lock(_mutex);
+    return _jobsRun;
+  }
+
+  void SerialExecutor::run() {
+    std::unique_lock lock(_mutex);
+    while (true) {
+      auto now = std::chrono::steady_clock::now();
+      while (!_timers.empty() && _timers.top().due <= now) {
+        // The queue only hands out const references, the job is moved out before popping
+        _jobs.push_back(std::move(const_cast<Timer&>(_timers.top()).job));
+        _timers.pop();
+      }
+      if (!_jobs.empty()) {
+        Job job = std::move(_jobs.front());
+        _jobs.pop_front();
+        _jobsRun++;
+        lock.unlock();
+        job();
+        // A job's captures may post again from their destructors
+        job = nullptr;
+        lock.lock();
+        continue;
+      }
+      if (_stopping) {
+        break;
+      }
+      if (_timers.empty()) {
+        _wake.wait(lock);
+      } else {
+        _wake.wait_until(lock, _timers.top().due);
+      }
+    }
+    // Dropped outside the lock for the same reason
+    auto timers = std::move(_timers);
+    lock.unlock();
+  }
+
+} // namespace espprov
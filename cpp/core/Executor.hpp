@@ -0,0 +1,97 @@
+///
+/// Executor.hpp
+/// Where native coroutines run and resume: a queue of jobs and timers.
+///
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace espprov {
+
+  /**
+   * Runs jobs posted from any thread. `Task`s start on an executor and every awaited callback
+   * resumes them there, so the code between two suspension points never runs concurrently with
+   * itself.
+   */
+  class Executor {
+  public:
+    using Job = std::function<void()>;
+
+    virtual ~Executor() = default;
+
+    /**
+     * Runs `job` soon, after the jobs posted before it. Thread safe.
+     */
+    virtual void post(Job job) = 0;
+
+    /**
+     * Runs `job` once `delay` passed. Thread safe.
+     */
+    virtual void postAfter(std::chrono::milliseconds delay, Job job) = 0;
+
+    /**
+     * Whether the calling thread is the one running this executor's jobs. Callbacks arriving on
+     * it resume their task right away instead of posting a job.
+     */
+    virtual bool isCurrent() const noexcept = 0;
+  };
+
+  /**
+   * An executor with a thread of its own that runs jobs one at a time, in the order they were
+   * posted, and timers in the order they come due.
+   *
+   * The destructor runs the jobs already posted and drops timers that did not come due, so
+   * tasks still waiting on it then never resume.
+   */
+  class SerialExecutor final : public Executor {
+  public:
+    SerialExecutor();
+    ~SerialExecutor() override;
+
+    SerialExecutor(const SerialExecutor&) = delete;
+    SerialExecutor& operator=(const SerialExecutor&) = delete;
+
+    void post(Job job) override;
+    void postAfter(std::chrono::milliseconds delay, Job job) override;
+    bool isCurrent() const noexcept override;
+
+    /**
+     * The jobs run so far, including timers. For the benchmarks.
+     */
+    uint64_t jobsRun() const;
+
+  private:
+    struct Timer {
+      std::chrono::steady_clock::time_point due;
+      // Keeps timers with the same due time in posting order
+      uint64_t sequence;
+      Job job;
+
+      bool operator>(const Timer& other) const noexcept {
+        return due != other.due ? due > other.due : sequence > other.sequence;
+      }
+    };
+
+    void run();
+
+  private:
+    mutable std::mutex _mutex;
+    std::condition_variable _wake;
+    std::deque<Job> _jobs;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> _timers;
+    uint64_t _nextSequence = 0;
+    uint64_t _jobsRun = 0;
+    bool _stopping = false;
+    std::thread _thread;
+  };
+
+} // namespace espprov
@@ -0,0 +1,381 @@
+///
+/// HttpTransport.cpp
+/// Keep-alive HTTP/1.1 client that carries protocomm over the SoftAP link.
+///
+
+#include "HttpTransport.hpp"
+#include "Errors.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace espprov {
+
+  namespace {
+    /// Upper bound for the header block, far above anything `protocomm_httpd` sends.
+    constexpr size_t MAX_HEADER_SIZE = 8 * 1024;
+    /// Upper bound for a body, the ESP httpd never sends anything larger.
+    constexpr size_t MAX_BODY_SIZE = 64 * 1024;
+
+#ifdef MSG_NOSIGNAL
+    constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    constexpr int SEND_FLAGS = 0; // Apple platforms use SO_NOSIGPIPE instead
+#endif
+
+    std::string systemError(const std::string& what) {
+      return what + ": " + std::strerror(errno);
+    }
+
+    bool equalsIgnoringCase(std::string_view a, std::string_view b) {
+      return a.size() == b.size() && ::strncasecmp(a.data(), b.data(), a.size()) == 0;
+    }
+
+    std::string_view trim(std::string_view value) {
+      while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+      }
+      while (!value.empty() && (value.back() == ' ' || value.back() == '\t' || value.back() == '\r')) {
+        value.remove_suffix(1);
+      }
+      return value;
+    }
+
+  } // namespace
+
+  HttpTransport::HttpTransport(std::string host, uint16_t port): _host(std::move(host)), _port(port) {
+    // Without the pipe an abort still fails the next call, it just does not cut a wait short
+    if (::pipe(_abortPipe) == 0) {
+      for (int fd : _abortPipe) {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+      }
+    } else {
+      _abortPipe[0] = _abortPipe[1] = -1;
+    }
+  }
+
+  HttpTransport::~HttpTransport() {
+    closeSocket();
+    for (int fd : _abortPipe) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+  }
+
+  void HttpTransport::connect(std::chrono::milliseconds timeout) {
+    throwIfAborted();
+    if (_connected) {
+      return;
+    }
+    open(Clock::now() + timeout);
+    _connectTimeout = timeout;
+    _connected = true;
+  }
+
+  Bytes HttpTransport::exchange(std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout) {
+    throwIfAborted();
+    if (!_connected) {
+      throw ProtocommError(ErrorCode::SESSION_NOT_ESTABLISHED, "Transport to " + _host + " is not connected");
+    }
+    Clock::time_point deadline = Clock::now() + timeout;
+
+    std::string head = "POST /" + std::string(endpoint) + " HTTP/1.1\r\n"
+                       "Host: " + _host + ":" + std::to_string(_port) + "\r\n"
+                       "Content-Type: application/x-www-form-urlencoded\r\n"
+                       "Accept: text/plain\r\n"
+                       "Content-Length: " + std::to_string(payload.size()) + "\r\n\r\n";
+    _request.assign(head.begin(), head.end());
+    _request.insert(_request.end(), payload.begin(), payload.end());
+
+    for (int attempt = 0;; attempt++) {
+      if (_fd < 0) {
+        open(std::min(deadline, Clock::now() + _connectTimeout));
+      }
+      bool reused = _exchangesOnConnection > 0;
+      std::optional<Response> response;
+      try {
+        if (sendAll(_request, deadline)) {
+          response = readResponse(deadline);
+        }
+      } catch (const ProtocommError& e) {
+        closeSocket();
+        throw ProtocommError(e.code(), "Request to " + std::string(endpoint) + " failed: " + e.what());
+      }
+
+      if (!response.has_value()) {
+        closeSocket();
+        // The device dropped the idle connection before this request reached it
+        if (reused && attempt == 0) {
+          continue;
+        }
+        throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Device closed the connection on " + std::string(endpoint));
+      }
+      _exchangesOnConnection++;
+      if (response->close) {
+        closeSocket();
+      }
+      if (response->status != 200) {
+        throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR,
+                             std::string(endpoint) + " answered HTTP " + std::to_string(response->status));
+      }
+      return std::move(response->body);
+    }
+  }
+
+  void HttpTransport::disconnect() noexcept {
+    _connected = false;
+    closeSocket();
+  }
+
+  void HttpTransport::abort() noexcept {
+    if (_aborted.exchange(true) || _abortPipe[1] < 0) {
+      return;
+    }
+    uint8_t wake = 1;
+    [[maybe_unused]] ssize_t written = ::write(_abortPipe[1], &wake, 1);
+  }
+
+  void HttpTransport::throwIfAborted() const {
+    if (_aborted.load()) {
+      throw ProtocommError(ErrorCode::OPERATION_CANCELLED, "Transport to " + _host + " was aborted");
+    }
+  }
+
+  // pragma MARK: Socket
+
+  bool HttpTransport::waitFor(int fd, short events, Clock::time_point deadline) const {
+    while (true) {
+      throwIfAborted();
+      auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+      if (remaining.count() <= 0) {
+        return false;
+      }
+      pollfd entries[2] = {{.fd = fd, .events = events, .revents = 0}, {.fd = _abortPipe[0], .events = POLLIN, .revents = 0}};
+      // A negative fd is ignored by poll()
+      int ready = ::poll(entries, 2, static_cast<int>(std::min<int64_t>(remaining.count(), INT32_MAX)));
+      if (ready > 0 && entries[0].revents != 0) {
+        return true;
+      }
+      if (ready < 0 && errno != EINTR) {
+        throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, systemError("poll"));
+      }
+    }
+  }
+
+  void HttpTransport::open(Clock::time_point deadline) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV;
+    addrinfo* addresses = nullptr;
+    if (::getaddrinfo(_host.c_str(), std::to_string(_port).c_str(), &hints, &addresses) != 0 || addresses == nullptr) {
+      throw ProtocommError(ErrorCode::SOFTAP_CONNECTION_FAILURE, "Cannot resolve " + _host);
+    }
+    std::unique_ptr<addrinfo, decltype(&::freeaddrinfo)> guard(addresses, ::freeaddrinfo);
+
+    std::string failure = "No address for " + _host;
+    for (addrinfo* address = addresses; address != nullptr; address = address->ai_next) {
+      int fd = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+      if (fd < 0) {
+        failure = systemError("socket");
+        continue;
+      }
+      // Non-blocking for good, every wait goes through poll() with the caller's deadline
+      ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+      int enabled = 1;
+      ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+#ifdef SO_NOSIGPIPE
+      ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+
+      int result = ::connect(fd, address->ai_addr, address->ai_addrlen);
+      if (result != 0 && errno == EINPROGRESS) {
+        bool ready = false;
+        try {
+          ready = waitFor(fd, POLLOUT, deadline);
+        } catch (...) {
+          ::close(fd);
+          throw;
+        }
+        if (!ready) {
+          ::close(fd);
+          throw ProtocommError(ErrorCode::SOFTAP_CONNECTION_FAILURE,
+                               "Connecting to " + _host + ":" + std::to_string(_port) + " timed out");
+        }
+        int error = 0;
+        socklen_t length = sizeof(error);
+        ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+        errno = error;
+        result = error == 0 ? 0 : -1;
+      }
+      if (result != 0) {
+        failure = systemError("connect to " + _host + ":" + std::to_string(_port));
+        ::close(fd);
+        continue;
+      }
+      _fd = fd;
+      _connectionCount++;
+      _exchangesOnConnection = 0;
+      return;
+    }
+    throw ProtocommError(ErrorCode::SOFTAP_CONNECTION_FAILURE, failure);
+  }
+
+  void HttpTransport::closeSocket() noexcept {
+    if (_fd >= 0) {
+      ::close(_fd);
+      _fd = -1;
+    }
+  }
+
+  bool HttpTransport::sendAll(ByteView data, Clock::time_point deadline) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+      ssize_t written = ::send(_fd, data.data() + sent, data.size() - sent, SEND_FLAGS);
+      if (written >= 0) {
+        sent += static_cast<size_t>(written);
+        continue;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        if (!waitFor(_fd, POLLOUT, deadline)) {
+          throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Timed out sending the request");
+        }
+        continue;
+      }
+      if ((errno == EPIPE || errno == ECONNRESET) && sent == 0) {
+        return false;
+      }
+      throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, systemError("send"));
+    }
+    return true;
+  }
+
+  size_t HttpTransport::receive(uint8_t* buffer, size_t size, Clock::time_point deadline) {
+    while (true) {
+      ssize_t received = ::recv(_fd, buffer, size, 0);
+      if (received >= 0) {
+        return static_cast<size_t>(received);
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        if (!waitFor(_fd, POLLIN, deadline)) {
+          throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Timed out waiting for the device");
+        }
+        continue;
+      }
+      if (errno == ECONNRESET) {
+        return 0;
+      }
+      throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, systemError("recv"));
+    }
+  }
+
+  std::optional<HttpTransport::Response> HttpTransport::readResponse(Clock::time_point deadline) {
+    // Read until the end of the header block, keeping whatever body bytes followed it
+    std::string head;
+    uint8_t buffer[2048];
+    size_t headerEnd = std::string::npos;
+    while (headerEnd == std::string::npos) {
+      size_t received = receive(buffer, sizeof(buffer), deadline);
+      if (received == 0) {
+        if (head.empty()) {
+          return std::nullopt;
+        }
+        throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Connection closed inside the HTTP header");
+      }
+      head.append(reinterpret_cast<const char*>(buffer), received);
+      headerEnd = head.find("\r\n\r\n");
+      if (headerEnd == std::string::npos && head.size() > MAX_HEADER_SIZE) {
+        throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "HTTP header too large");
+      }
+    }
+
+    Response response;
+    response.body.assign(head.begin() + static_cast<std::ptrdiff_t>(headerEnd + 4), head.end());
+    std::string_view lines = std::string_view(head).substr(0, headerEnd);
+
+    // "HTTP/1.1 200 OK"
+    size_t lineEnd = lines.find("\r\n");
+    std::string_view statusLine = lines.substr(0, lineEnd);
+    if (!statusLine.starts_with("HTTP/1.") || statusLine.size() < 12 || statusLine[8] != ' ') {
+      throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Malformed HTTP status line");
+    }
+    for (char digit : statusLine.substr(9, 3)) {
+      if (digit < '0' || digit > '9') {
+        throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Malformed HTTP status line");
+      }
+      response.status = response.status * 10 + (digit - '0');
+    }
+    // HTTP/1.0 closes unless asked otherwise
+    response.close = statusLine[7] == '0';
+
+    std::optional<size_t> contentLength;
+    while (lineEnd != std::string_view::npos) {
+      size_t lineStart = lineEnd + 2;
+      lineEnd = lines.find("\r\n", lineStart);
+      std::string_view line = lines.substr(lineStart, lineEnd == std::string_view::npos ? std::string_view::npos : lineEnd - lineStart);
+      size_t colon = line.find(':');
+      if (colon == std::string_view::npos) {
+        throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Malformed HTTP header line");
+      }
+      std::string_view name = trim(line.substr(0, colon));
+      std::string_view value = trim(line.substr(colon + 1));
+      if (equalsIgnoringCase(name, "Content-Length")) {
+        size_t length = 0;
+        for (char digit : value) {
+          if (digit < '0' || digit > '9' || length > MAX_BODY_SIZE) {
+            throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Invalid HTTP Content-Length");
+          }
+          length = length * 10 + static_cast<size_t>(digit - '0');
+        }
+        contentLength = length;
+      } else if (equalsIgnoringCase(name, "Connection")) {
+        response.close = equalsIgnoringCase(value, "close") || (response.close && !equalsIgnoringCase(value, "keep-alive"));
+      } else if (equalsIgnoringCase(name, "Transfer-Encoding") && !equalsIgnoringCase(value, "identity")) {
+        throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Unsupported HTTP Transfer-Encoding");
+      }
+    }
+
+    if (!contentLength.has_value()) {
+      // The body runs until the device closes the connection
+      response.close = true;
+      while (size_t received = receive(buffer, sizeof(buffer), deadline)) {
+        if (response.body.size() + received > MAX_BODY_SIZE) {
+          throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "HTTP body too large");
+        }
+        response.body.insert(response.body.end(), buffer, buffer + received);
+      }
+      return response;
+    }
+    if (*contentLength > MAX_BODY_SIZE || response.body.size() > *contentLength) {
+      throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Invalid HTTP Content-Length");
+    }
+    size_t received = response.body.size();
+    response.body.resize(*contentLength);
+    while (received < *contentLength) {
+      size_t chunk = receive(response.body.data() + received, *contentLength - received, deadline);
+      if (chunk == 0) {
+        throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Connection closed inside the HTTP body");
+      }
+      received += chunk;
+    }
+    return response;
+  }
+
+} // namespace espprov
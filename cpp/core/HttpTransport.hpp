@@ -0,0 +1,103 @@
+///
+/// HttpTransport.hpp
+/// Keep-alive HTTP/1.1 client that carries protocomm over the SoftAP link.
+///
+
+#pragma once
+
+#include "Transport.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace espprov {
+
+  /// Where `protocomm_httpd` listens on the network an ESP SoftAP hosts, as in the Espressif SDKs.
+  inline constexpr const char* SOFTAP_DEFAULT_HOST = "192.168.4.1";
+  inline constexpr uint16_t SOFTAP_DEFAULT_PORT = 80;
+
+  /**
+   * Posts exchanges to `http://<host>:<port>/<endpoint>` over one persistent TCP connection. The
+   * connection is opened by `connect()` and reused by every session, scan, config and custom
+   * endpoint call until `disconnect()`, so a provisioning run pays for one TCP handshake instead
+   * of one per message. Nagle is disabled, every request is one small write waiting for its reply.
+   *
+   * Connect and exchange timeouts are deadlines for the whole operation, enforced with `poll()`
+   * rather than socket options, which some platforms ignore for `connect()`.
+   *
+   * The device may close an idle connection at any time. A request that finds its reused
+   * connection closed before a single response byte arrived is sent once more on a fresh one,
+   * as browsers do. Not thread safe, the engine serializes calls per device. `abort()` wakes a
+   * blocked call through a pipe that every `poll()` watches besides the socket.
+   */
+  class HttpTransport final : public Transport {
+  public:
+    HttpTransport(std::string host, uint16_t port);
+    ~HttpTransport() override;
+
+    HttpTransport(const HttpTransport&) = delete;
+    HttpTransport& operator=(const HttpTransport&) = delete;
+
+    void connect(std::chrono::milliseconds timeout) override;
+    Bytes exchange(std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout) override;
+    void disconnect() noexcept override;
+    void abort() noexcept override;
+
+    bool isConnected() const noexcept override {
+      return _connected;
+    }
+
+    /**
+     * The number of TCP connections opened so far.
+     */
+    uint64_t connectionCount() const noexcept {
+      return _connectionCount;
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Response {
+      int status = 0;
+      bool close = false;
+      Bytes body;
+    };
+
+    void throwIfAborted() const;
+    /**
+     * Waits until the socket is ready for `events`. Returns false once `deadline` passed, throws if
+     * the transport was aborted.
+     */
+    bool waitFor(int fd, short events, Clock::time_point deadline) const;
+    void open(Clock::time_point deadline);
+    void closeSocket() noexcept;
+    /**
+     * Returns false if the peer had already closed the connection.
+     */
+    bool sendAll(ByteView data, Clock::time_point deadline);
+    /**
+     * Returns 0 once the peer closed the connection.
+     */
+    size_t receive(uint8_t* buffer, size_t size, Clock::time_point deadline);
+    /**
+     * Returns `nullopt` if the peer closed the connection before sending anything.
+     */
+    std::optional<Response> readResponse(Clock::time_point deadline);
+
+    std::string _host;
+    uint16_t _port;
+    std::chrono::milliseconds _connectTimeout{0};
+    bool _connected = false;
+    int _fd = -1;
+    uint64_t _connectionCount = 0;
+    uint64_t _exchangesOnConnection = 0;
+    // The request on the wire, head and body in one write, its capacity reused across exchanges
+    Bytes _request;
+    std::atomic<bool> _aborted{false};
+    // Becomes readable once aborted. Never drained, an aborted transport stays aborted
+    int _abortPipe[2] = {-1, -1};
+  };
+
+} // namespace espprov
@@ -0,0 +1,86 @@
+///
+/// LatencyHistogram.cpp
+/// A fixed size, lock free latency histogram with HDR-style log-linear buckets.
+///
+
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace espprov {
+
+  LatencyHistogram::LatencyHistogram() noexcept {
+    for (std::atomic<uint64_t>& bucket : _buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  size_t LatencyHistogram::bucketIndex(uint64_t value) noexcept {
+    value = std::min(value, MAX_VALUE);
+    if (value < SUB_BUCKET_COUNT) {
+      return static_cast<size_t>(value);
+    }
+    // The top SUB_BUCKET_BITS + 1 bits pick the bucket within the value's power of two
+    auto exponent = static_cast<unsigned>(std::bit_width(value) - 1);
+    uint64_t subBucket = (value >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKET_COUNT;
+    return static_cast<size_t>(SUB_BUCKET_COUNT * (exponent - SUB_BUCKET_BITS + 1) + subBucket);
+  }
+
+  uint64_t LatencyHistogram::bucketUpperBound(size_t index) noexcept {
+    if (index < SUB_BUCKET_COUNT) {
+      return index;
+    }
+    auto exponent = static_cast<unsigned>(index / SUB_BUCKET_COUNT + SUB_BUCKET_BITS - 1);
+    uint64_t subBucket = index % SUB_BUCKET_COUNT;
+    unsigned shift = exponent - SUB_BUCKET_BITS;
+    return ((SUB_BUCKET_COUNT + subBucket) << shift) + ((uint64_t(1) << shift) - 1);
+  }
+
+  void LatencyHistogram::record(uint64_t micros) noexcept {
+    _buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(micros, std::memory_order_relaxed);
+    uint64_t seen = _min.load(std::memory_order_relaxed);
+    while (micros < seen && !_min.compare_exchange_weak(seen, micros, std::memory_order_relaxed)) {
+    }
+    seen = _max.load(std::memory_order_relaxed);
+    while (micros > seen && !_max.compare_exchange_weak(seen, micros, std::memory_order_relaxed)) {
+    }
+  }
+
+  LatencyHistogram::Snapshot LatencyHistogram::snapshot(bool reset) noexcept {
+    Snapshot snapshot;
+    snapshot.buckets.resize(BUCKET_COUNT);
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+      uint64_t count = reset ? _buckets[i].exchange(0, std::memory_order_relaxed) : _buckets[i].load(std::memory_order_relaxed);
+      snapshot.buckets[i] = count;
+      snapshot.count += count;
+    }
+    snapshot.sum = reset ? _sum.exchange(0, std::memory_order_relaxed) : _sum.load(std::memory_order_relaxed);
+    uint64_t min = reset ? _min.exchange(UINT64_MAX, std::memory_order_relaxed) : _min.load(std::memory_order_relaxed);
+    snapshot.max = reset ? _max.exchange(0, std::memory_order_relaxed) : _max.load(std::memory_order_relaxed);
+    if (snapshot.count == 0) {
+      return Snapshot{};
+    }
+    snapshot.min = min == UINT64_MAX ? 0 : min;
+    return snapshot;
+  }
+
+  uint64_t LatencyHistogram::Snapshot::percentile(double quantile) const noexcept {
+    if (count == 0) {
+      return 0;
+    }
+    quantile = std::clamp(quantile, 0.0, 1.0);
+    auto rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(count))), 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+      seen += buckets[i];
+      if (seen >= rank) {
+        // The bucket bound may overshoot the largest value that actually landed in it
+        return std::min(std::max(bucketUpperBound(i), min), max);
+      }
+    }
+    return max;
+  }
+
+} // namespace espprov
@@ -0,0 +1,76 @@
+///
+/// LatencyHistogram.hpp
+/// A fixed size, lock free latency histogram with HDR-style log-linear buckets.
+///
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace espprov {
+
+  /**
+   * Counts latencies in microseconds into 1024 buckets: exact below 32 µs, then 32 buckets per
+   * power of two up to about 19 hours. A percentile read from it is at most 1/32 (3.1%) above the
+   * true value. Larger values are counted as the largest one.
+   *
+   * `record` is wait free and may run on any thread. Memory stays at 8 KB however many values
+   * are recorded.
+   */
+  class LatencyHistogram {
+  public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr uint64_t SUB_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;
+    /// The highest power of two that still gets its own buckets.
+    static constexpr unsigned MAX_EXPONENT = 35;
+    static constexpr uint64_t MAX_VALUE = (uint64_t(1) << (MAX_EXPONENT + 1)) - 1;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKET_COUNT * (MAX_EXPONENT - SUB_BUCKET_BITS + 2);
+
+    struct Snapshot {
+      uint64_t count = 0;
+      uint64_t sum = 0;
+      uint64_t min = 0;
+      uint64_t max = 0;
+      /// Indexed by bucket, empty when nothing was recorded.
+      std::vector<uint64_t> buckets;
+
+      double mean() const noexcept {
+        return count == 0 ? 0 : static_cast<double>(sum) / static_cast<double>(count);
+      }
+
+      /**
+       * The smallest recorded value at or above the `quantile` (0 to 1) of all values, rounded up to
+       * its bucket's upper bound. 0 without values.
+       */
+      uint64_t percentile(double quantile) const noexcept;
+    };
+
+    LatencyHistogram() noexcept;
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t micros) noexcept;
+
+    /**
+     * Copies the counts. With `reset` they are taken out instead, so a value recorded concurrently
+     * lands in exactly one of two consecutive snapshots.
+     */
+    Snapshot snapshot(bool reset = false) noexcept;
+
+    static size_t bucketIndex(uint64_t value) noexcept;
+    /// The largest value counted into `index`.
+    static uint64_t bucketUpperBound(size_t index) noexcept;
+
+  private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> _buckets;
+    std::atomic<uint64_t> _sum{0};
+    std::atomic<uint64_t> _min{UINT64_MAX};
+    std::atomic<uint64_t> _max{0};
+  };
+
+} // namespace espprov
@@ -0,0 +1,113 @@
+///
+/// Metrics.cpp
+/// Process wide latency histograms of the provisioning phases and custom endpoints, and error counts.
+///
+
+#include "Metrics.hpp"
+#include <algorithm>
+
+namespace espprov {
+
+  namespace {
+    uint64_t toMicros(std::chrono::microseconds duration) noexcept {
+      return duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+    }
+  } // namespace
+
+  MetricsRegistry::MetricsRegistry(): _since(std::chrono::system_clock::now().time_since_epoch().count()) {
+    for (std::atomic<uint64_t>& count : _errors) {
+      count.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  MetricsRegistry& MetricsRegistry::shared() {
+    static MetricsRegistry registry;
+    return registry;
+  }
+
+  void MetricsRegistry::recordPhase(Phase phase, std::chrono::microseconds duration) noexcept {
+    auto index = static_cast<size_t>(phase);
+    if (index < PHASE_COUNT) {
+      _phases[index].record(toMicros(duration));
+    }
+  }
+
+  void MetricsRegistry::recordEndpoint(std::string_view endpoint, std::chrono::microseconds duration) {
+    LatencyHistogram* histogram = &_otherEndpoints;
+    {
+      std::lock_guard lock(_endpointsMutex);
+      auto it = _endpoints.find(std::string(endpoint));
+      if (it != _endpoints.end()) {
+        histogram = it->second.get();
+      } else if (_endpoints.size() < MAX_ENDPOINTS) {
+        histogram = _endpoints.emplace(std::string(endpoint), std::make_unique<LatencyHistogram>()).first->second.get();
+      }
+    }
+    // Histograms are never removed, so recording needs no lock
+    histogram->record(toMicros(duration));
+  }
+
+  void MetricsRegistry::countError(int code) noexcept {
+    if (code >= 0 && code < MAX_ERROR_CODE) {
+      _errors[static_cast<size_t>(code)].fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  MetricsSnapshot MetricsRegistry::snapshot(bool reset) {
+    MetricsSnapshot snapshot;
+    auto now = std::chrono::system_clock::now().time_since_epoch().count();
+    snapshot.since = std::chrono::system_clock::time_point(
+        std::chrono::system_clock::duration(reset ? _since.exchange(now) : _since.load()));
+
+    for (size_t i = 0; i < PHASE_COUNT; i++) {
+      LatencyHistogram::Snapshot phase = _phases[i].snapshot(reset);
+      if (phase.count > 0) {
+        snapshot.phases.push_back(summarize(std::string(phaseName(static_cast<Phase>(i))), phase));
+      }
+    }
+
+    std::vector<std::pair<std::string, LatencyHistogram*>> endpoints;
+    {
+      std::lock_guard lock(_endpointsMutex);
+      endpoints.reserve(_endpoints.size());
+      for (auto& [name, histogram] : _endpoints) {
+        endpoints.emplace_back(name, histogram.get());
+      }
+    }
+    std::sort(endpoints.begin(), endpoints.end());
+    endpoints.emplace_back(std::string(OTHER_ENDPOINTS), &_otherEndpoints);
+    for (auto& [name, histogram] : endpoints) {
+      LatencyHistogram::Snapshot endpoint = histogram->snapshot(reset);
+      if (endpoint.count > 0) {
+        snapshot.endpoints.push_back(summarize(std::move(name), endpoint));
+      }
+    }
+
+    for (size_t code = 0; code < _errors.size(); code++) {
+      uint64_t count = reset ? _errors[code].exchange(0, std::memory_order_relaxed) : _errors[code].load(std::memory_order_relaxed);
+      if (count > 0) {
+        snapshot.errors.emplace_back(static_cast<int>(code), count);
+      }
+    }
+    return snapshot;
+  }
+
+  void MetricsRegistry::reset() {
+    snapshot(true);
+  }
+
+  LatencySummary MetricsRegistry::summarize(std::string name, const LatencyHistogram::Snapshot& snapshot) {
+    return LatencySummary{
+        .name = std::move(name),
+        .count = snapshot.count,
+        .min = snapshot.min,
+        .mean = snapshot.mean(),
+        .p50 = snapshot.percentile(0.50),
+        .p90 = snapshot.percentile(0.90),
+        .p95 = snapshot.percentile(0.95),
+        .p99 = snapshot.percentile(0.99),
+        .max = snapshot.max,
+    };
+  }
+
+} // namespace espprov
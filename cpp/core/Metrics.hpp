@@ -0,0 +1,98 @@
+///
+/// Metrics.hpp
+/// Process wide latency histograms of the provisioning phases and custom endpoints, and error counts.
+///
+
+#pragma once
+
+#include "Errors.hpp"
+#include "LatencyHistogram.hpp"
+#include "RunTimings.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace espprov {
+
+  /**
+   * The percentiles of one histogram, in microseconds.
+   */
+  struct LatencySummary {
+    std::string name;
+    uint64_t count = 0;
+    uint64_t min = 0;
+    double mean = 0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p95 = 0;
+    uint64_t p99 = 0;
+    uint64_t max = 0;
+  };
+
+  struct MetricsSnapshot {
+    /// When the counts started, at creation or the last reset.
+    std::chrono::system_clock::time_point since;
+    /// One entry per phase that ran, in phase order.
+    std::vector<LatencySummary> phases;
+    /// One entry per custom endpoint that was called, by endpoint name.
+    std::vector<LatencySummary> endpoints;
+    /// `ErrorCode` values and how often they were reported, for codes reported at least once.
+    std::vector<std::pair<int, uint64_t>> errors;
+  };
+
+  /**
+   * Aggregates latencies and errors over the lifetime of the process, or since the last reset.
+   *
+   * Recording never blocks on a snapshot. Phases and errors are lock free, endpoints take a short
+   * lock to find their histogram. At most `MAX_ENDPOINTS` endpoints get their own histogram, later
+   * ones share `OTHER_ENDPOINTS`, so memory stays bounded whatever paths are called.
+   *
+   * Thread safe.
+   */
+  class MetricsRegistry {
+  public:
+    static constexpr size_t MAX_ENDPOINTS = 32;
+    static constexpr std::string_view OTHER_ENDPOINTS = "(other)";
+    /// Error codes at or above it are not counted.
+    static constexpr int MAX_ERROR_CODE = 64;
+
+    MetricsRegistry();
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    static MetricsRegistry& shared();
+
+    void recordPhase(Phase phase, std::chrono::microseconds duration) noexcept;
+    void recordEndpoint(std::string_view endpoint, std::chrono::microseconds duration);
+    void countError(int code) noexcept;
+    void countError(ErrorCode code) noexcept {
+      countError(static_cast<int>(code));
+    }
+
+    /**
+     * Summarizes everything recorded so far. With `reset` the counts start over at the same time,
+     * without losing values recorded concurrently.
+     */
+    MetricsSnapshot snapshot(bool reset = false);
+    void reset();
+
+  private:
+    static LatencySummary summarize(std::string name, const LatencyHistogram::Snapshot& snapshot);
+
+  private:
+    std::array<LatencyHistogram, PHASE_COUNT> _phases;
+    std::mutex _endpointsMutex;
+    std::unordered_map<std::string, std::unique_ptr<LatencyHistogram>> _endpoints;
+    LatencyHistogram _otherEndpoints;
+    std::array<std::atomic<uint64_t>, MAX_ERROR_CODE> _errors;
+    std::atomic<std::chrono::system_clock::rep> _since;
+  };
+
+} // namespace espprov
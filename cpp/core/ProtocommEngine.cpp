@@ -0,0 +1,710 @@
+///
+/// ProtocommEngine.cpp
+/// The platform independent provisioning engine: sessions, Wi-Fi scan, Wi-Fi config and custom endpoints.
+///
+
+#include "ProtocommEngine.hpp"
+#include "ConnectionStateMachine.hpp"
+#include "Errors.hpp"
+#include "Metrics.hpp"
+#include "Tracer.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+
+namespace espprov {
+
+  namespace {
+    std::string toHex(ByteView bytes) {
+      static constexpr char digits[] = "0123456789abcdef";
+      std::string hex;
+      hex.reserve(bytes.size() * 2);
+      for (uint8_t byte : bytes) {
+        hex.push_back(digits[byte >> 4]);
+        hex.push_back(digits[byte & 0x0F]);
+      }
+      return hex;
+    }
+
+    /**
+     * Holds an encoded request. Scan and status requests are a few bytes and stay on the stack,
+     * only a config message with unusually long credentials needs the heap.
+     */
+    class RequestBuffer {
+    public:
+      template <typename Message>
+      ByteView encode(const Message& message) {
+        size_t size = proto::encodedSize(message);
+        MutableByteView output = size <= _inline.size() ? MutableByteView(_inline).first(size) : grow(size);
+        return output.first(proto::encodeInto(message, output));
+      }
+
+    private:
+      MutableByteView grow(size_t size) {
+        _heap.resize(size);
+        return _heap;
+      }
+
+    private:
+      std::array<uint8_t, 128> _inline;
+      Bytes _heap;
+    };
+
+    /**
+     * A decrypted response and the sub message inside it. `body` points into `payload`.
+     */
+    struct Response {
+      Bytes payload;
+      ByteView body;
+    };
+
+    Response scanRequest(ProtocommSession& session, proto::WiFiScanMsgType msg, ByteView body, std::chrono::milliseconds timeout) {
+      RequestBuffer request;
+      proto::WiFiScanPayloadView message{.msg = msg, .status = proto::Status::SUCCESS, .body = body};
+      Response response;
+      response.payload = session.request(endpoints::PROV_SCAN, request.encode(message), timeout);
+
+      proto::WiFiScanPayloadView payload = proto::decodeWiFiScanPayloadView(response.payload);
+      if (static_cast<uint32_t>(payload.msg) != static_cast<uint32_t>(msg) + 1) {
+        throw ProtocommError(ErrorCode::WIFI_SCAN_REQUEST_ERROR, "Unexpected Wi-Fi scan response type");
+      }
+      if (payload.status != proto::Status::SUCCESS) {
+        throw ProtocommError(ErrorCode::WIFI_SCAN_REQUEST_ERROR,
+                             "Wi-Fi scan request failed with status " + std::to_string(static_cast<uint32_t>(payload.status)));
+      }
+      response.body = payload.body;
+      return response;
+    }
+
+    Response configRequest(ProtocommSession& session, proto::WiFiConfigMsgType msg, ByteView body, ErrorCode errorCode) {
+      RequestBuffer request;
+      proto::WiFiConfigPayloadView message{.msg = msg, .body = body};
+      Response response;
+      response.payload = session.request(endpoints::PROV_CONFIG, request.encode(message));
+
+      proto::WiFiConfigPayloadView payload = proto::decodeWiFiConfigPayloadView(response.payload);
+      if (static_cast<uint32_t>(payload.msg) != static_cast<uint32_t>(msg) + 1) {
+        throw ProtocommError(errorCode, "Unexpected Wi-Fi config response type");
+      }
+      response.body = payload.body;
+      return response;
+    }
+
+    /**
+     * Aborts `session` once `cancel` is cancelled, for as long as it lives. Must be gone before the
+     * session is, the cancelling thread only touches the session under the target's lock.
+     */
+    class AbortOnCancel {
+    public:
+      AbortOnCancel(ProtocommSession& session, const CancellationToken& cancel) {
+        if (!cancel.canBeCancelled()) {
+          return;
+        }
+        _target = std::make_shared<Target>();
+        _target->session = &session;
+        _registration = cancel.onCancel([target = _target] {
+          std::lock_guard lock(target->mutex);
+          if (target->session != nullptr) {
+            target->session->abort();
+          }
+        });
+      }
+
+      ~AbortOnCancel() {
+        if (_target != nullptr) {
+          _registration.reset();
+          std::lock_guard lock(_target->mutex);
+          _target->session = nullptr;
+        }
+      }
+
+      AbortOnCancel(const AbortOnCancel&) = delete;
+      AbortOnCancel& operator=(const AbortOnCancel&) = delete;
+
+    private:
+      struct Target {
+        std::mutex mutex;
+        ProtocommSession* session = nullptr;
+      };
+
+      std::shared_ptr<Target> _target;
+      CancellationRegistration _registration;
+    };
+
+    /**
+     * Sleeps for `delay`. Returns false right away once `cancel` is cancelled.
+     */
+    bool sleepUnlessCancelled(std::chrono::steady_clock::duration delay, const CancellationToken& cancel) {
+      if (!cancel.canBeCancelled()) {
+        std::this_thread::sleep_for(delay);
+        return true;
+      }
+      struct Wake {
+        std::mutex mutex;
+        std::condition_variable cancelled;
+      };
+      auto wake = std::make_shared<Wake>();
+      CancellationRegistration registration = cancel.onCancel([wake] {
+        std::lock_guard lock(wake->mutex);
+        wake->cancelled.notify_all();
+      });
+      std::unique_lock lock(wake->mutex);
+      return !wake->cancelled.wait_for(lock, delay, [&] { return cancel.isCancelled(); });
+    }
+
+    /**
+     * A BLE transport holding its device's link slot. Every exchange waits for its turn.
+     */
+    class ScheduledTransport final : public Transport {
+    public:
+      ScheduledTransport(std::unique_ptr<Transport> transport, SessionScheduler& scheduler, SessionScheduler::Grant link,
+                         std::chrono::milliseconds wait)
+          : _link(std::move(link)), _transport(std::move(transport)), _scheduler(scheduler), _wait(wait) {}
+
+      void connect(std::chrono::milliseconds timeout) override {
+        _transport->connect(timeout);
+      }
+
+      Bytes exchange(std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout) override {
+        SessionScheduler::Grant turn = _scheduler.acquireTurn(_wait, _abort.token());
+        if (!turn) {
+          _abort.token().throwIfCancelled("Waiting for a radio turn");
+          throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "No radio turn for " + std::string(endpoint) + " in time");
+        }
+        return _transport->exchange(endpoint, payload, timeout);
+      }
+
+      void disconnect() noexcept override {
+        _transport->disconnect();
+      }
+
+      void abort() noexcept override {
+        // Also gives up a queued turn
+        _abort.cancel();
+        _transport->abort();
+      }
+
+      bool isConnected() const noexcept override {
+        return _transport->isConnected();
+      }
+
+    private:
+      // Declared first so it is released last: the slot goes to the next device only once the
+      // wrapped transport has closed its link.
+      SessionScheduler::Grant _link;
+      std::unique_ptr<Transport> _transport;
+      SessionScheduler& _scheduler;
+      CancellationSource _abort;
+      std::chrono::milliseconds _wait;
+    };
+
+    void checkConfigStatus(ByteView body, const char* step) {
+      proto::RespConfigStatus status = proto::decodeRespConfigStatus(body);
+      if (status.status != proto::Status::SUCCESS) {
+        throw ProtocommError(ErrorCode::PROV_CONFIGURATION_ERROR,
+                             std::string(step) + " failed with status " + std::to_string(static_cast<uint32_t>(status.status)));
+      }
+    }
+  } // namespace
+
+  ProtocommEngine::ProtocommEngine(TransportFactory transportFactory, Timeouts timeouts)
+      : _transportFactory(std::move(transportFactory)), _timeouts(timeouts), _statusPoll(timeouts.statusPoll) {}
+
+  ProtocommEngine::~ProtocommEngine() = default;
+
+  void ProtocommEngine::configureDevice(DeviceConfig config) {
+    std::shared_ptr<Device> previous;
+    std::vector<std::shared_ptr<Device>> evicted;
+    {
+      std::lock_guard lock(_devicesMutex);
+      auto device = std::make_shared<Device>();
+      device->config = config;
+      device->lastUsed = std::chrono::steady_clock::now();
+      auto it = _devices.find(config.name);
+      // Searching and creating the device are part of the run that configures it
+      device->timings = it != _devices.end() ? it->second->timings : std::make_shared<RunTimings>(&MetricsRegistry::shared());
+      if (it != _devices.end()) {
+        previous = std::move(it->second);
+        it->second = std::move(device);
+      } else {
+        _devices.emplace(config.name, std::move(device));
+      }
+      evicted = evictLocked(std::chrono::steady_clock::now());
+    }
+    notifyEvicted(evicted);
+    if (previous != nullptr) {
+      // Wait for in flight calls on the old configuration, then drop its session.
+      std::lock_guard lock(previous->mutex);
+      previous->session.reset();
+    }
+  }
+
+  bool ProtocommEngine::hasDevice(const std::string& deviceName) const {
+    std::lock_guard lock(_devicesMutex);
+    return _devices.contains(deviceName);
+  }
+
+  void ProtocommEngine::setScanCacheTtl(std::chrono::milliseconds ttl) noexcept {
+    _scanCacheTtlMs.store(std::max<std::chrono::milliseconds::rep>(ttl.count(), 0));
+  }
+
+  void ProtocommEngine::setStatusPollSchedule(StatusPollSchedule schedule) {
+    std::lock_guard lock(_devicesMutex);
+    _statusPoll = schedule;
+  }
+
+  StatusPollSchedule ProtocommEngine::statusPollSchedule() const {
+    std::lock_guard lock(_devicesMutex);
+    return _statusPoll;
+  }
+
+  void ProtocommEngine::setSessionLimits(SessionLimits limits) {
+    _scheduler.setLimits(limits);
+  }
+
+  void ProtocommEngine::setRegistryLimits(RegistryLimits limits) {
+    std::vector<std::shared_ptr<Device>> evicted;
+    {
+      std::lock_guard lock(_devicesMutex);
+      _limits = limits;
+      _limits.maxDevices = std::max<size_t>(_limits.maxDevices, 1);
+      evicted = evictLocked(std::chrono::steady_clock::now());
+    }
+    notifyEvicted(evicted);
+  }
+
+  uint64_t ProtocommEngine::addEvictionListener(EvictionListener listener) {
+    std::lock_guard lock(_evictionListenersMutex);
+    uint64_t id = _nextEvictionListenerId++;
+    _evictionListeners.emplace(id, std::make_shared<const EvictionListener>(std::move(listener)));
+    return id;
+  }
+
+  bool ProtocommEngine::removeEvictionListener(uint64_t id) {
+    std::lock_guard lock(_evictionListenersMutex);
+    return _evictionListeners.erase(id) > 0;
+  }
+
+  void ProtocommEngine::notifyEvicted(const std::vector<std::shared_ptr<Device>>& evicted) {
+    if (evicted.empty()) {
+      return;
+    }
+    std::vector<std::shared_ptr<const EvictionListener>> listeners;
+    {
+      std::lock_guard lock(_evictionListenersMutex);
+      listeners.reserve(_evictionListeners.size());
+      for (const auto& [id, listener] : _evictionListeners) {
+        listeners.push_back(listener);
+      }
+    }
+    for (const std::shared_ptr<Device>& device : evicted) {
+      for (const auto& listener : listeners) {
+        (*listener)(device->config.name);
+      }
+    }
+  }
+
+  bool ProtocommEngine::releaseDevice(const std::string& deviceName) {
+    std::shared_ptr<Device> released;
+    std::lock_guard lock(_devicesMutex);
+    auto it = _devices.find(deviceName);
+    if (it == _devices.end()) {
+      return false;
+    }
+    released = std::move(it->second);
+    _devices.erase(it);
+    ConnectionRegistry::shared().remove(deviceName);
+    return true;
+  }
+
+  void ProtocommEngine::releaseAllDevices() {
+    std::unordered_map<std::string, std::shared_ptr<Device>> released;
+    std::lock_guard lock(_devicesMutex);
+    released.swap(_devices);
+    for (const auto& [name, device] : released) {
+      ConnectionRegistry::shared().remove(name);
+    }
+  }
+
+  std::vector<std::shared_ptr<ProtocommEngine::Device>> ProtocommEngine::evictLocked(std::chrono::steady_clock::time_point now) {
+    std::vector<std::shared_ptr<Device>> evicted;
+    std::erase_if(_devices, [&](auto& entry) {
+      if (now - entry.second->lastUsed <= _limits.idleTimeout) {
+        return false;
+      }
+      // A secured session is kept however long it idles, only the capacity below drops it
+      if (ConnectionRegistry::shared().state(entry.first) == ConnectionState::SECURED) {
+        return false;
+      }
+      ConnectionRegistry::shared().remove(entry.first);
+      evicted.push_back(std::move(entry.second));
+      return true;
+    });
+    while (_devices.size() > _limits.maxDevices) {
+      auto oldest = std::min_element(_devices.begin(), _devices.end(),
+                                     [](const auto& a, const auto& b) { return a.second->lastUsed < b.second->lastUsed; });
+      ConnectionRegistry::shared().remove(oldest->first);
+      evicted.push_back(std::move(oldest->second));
+      _devices.erase(oldest);
+    }
+    return evicted;
+  }
+
+  std::shared_ptr<ProtocommEngine::Device> ProtocommEngine::findDevice(const std::string& deviceName) {
+    std::vector<std::shared_ptr<Device>> evicted;
+    std::shared_ptr<Device> device;
+    {
+      std::lock_guard lock(_devicesMutex);
+      auto it = _devices.find(deviceName);
+      if (it == _devices.end()) {
+        throw ProtocommError(ErrorCode::RUNTIME_DOES_NOT_EXIST_LOCALLY, "Device " + deviceName + " does not exist locally");
+      }
+      // Touch first: a device that is asked for again is not idle, however long it waited.
+      device = it->second;
+      auto now = std::chrono::steady_clock::now();
+      device->lastUsed = now;
+      evicted = evictLocked(now);
+    }
+    notifyEvicted(evicted);
+    return device;
+  }
+
+  ProtocommSession& ProtocommEngine::requireSession(Device& device) {
+    if (device.session == nullptr || !device.session->isEstablished()) {
+      throw ProtocommError(ErrorCode::SESSION_NOT_ESTABLISHED, "Session with " + device.config.name + " is not established");
+    }
+    return *device.session;
+  }
+
+  void ProtocommEngine::closeIfCancelled(Device& device, const CancellationToken& cancel, const char* what) {
+    if (!cancel.isCancelled()) {
+      return;
+    }
+    // The aborted transport is dead, closing the session frees the link for the next connect
+    device.session.reset();
+    ConnectionRegistry::shared().machine(device.config.name)
+        ->post(ConnectionEvent::DISCONNECT_REQUESTED, 0, static_cast<int>(ErrorCode::OPERATION_CANCELLED));
+    cancel.throwIfCancelled(what);
+  }
+
+  void ProtocommEngine::connect(const std::string& deviceName, const CancellationToken& cancel) {
+    std::shared_ptr<Device> device = findDevice(deviceName);
+    std::lock_guard lock(device->mutex);
+    cancel.throwIfCancelled("Connecting");
+
+    device->session.reset();
+    device->scanResultCount = 0;
+    device->pagedFromCache.reset();
+    device->pagedFromDevice.clear();
+    std::unique_ptr<Security> security = makeSecurity(device->config.security, device->config.securityParams);
+    std::unique_ptr<Transport> transport = _transportFactory(device->config);
+    if (transport == nullptr) {
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "No transport available for " + deviceName);
+    }
+    if (device->config.transport == TransportKind::BLE) {
+      // Queued devices stay IDLE, their connect timeouts only start with the slot
+      SessionScheduler::Grant link = _scheduler.acquireLink(_timeouts.schedulerWait, cancel);
+      if (!link) {
+        cancel.throwIfCancelled("Waiting for a BLE connection slot");
+        throw ProtocommError(ErrorCode::BLE_FAILED_TO_CONNECT, "No free BLE connection slot for " + deviceName);
+      }
+      transport = std::make_unique<ScheduledTransport>(std::move(transport), _scheduler, std::move(link), _timeouts.schedulerWait);
+    }
+    auto session = std::make_unique<ProtocommSession>(std::move(transport), std::move(security), _timeouts);
+    std::shared_ptr<ConnectionStateMachine> connection = ConnectionRegistry::shared().machine(deviceName);
+    uint64_t attempt = connection->beginConnect();
+    try {
+      AbortOnCancel abortOnCancel(*session, cancel);
+      session->establish(device->timings.get());
+    } catch (const ProtocommError& e) {
+      if (cancel.isCancelled()) {
+        // The half open session goes with this frame, and its link slot with it
+        connection->post(ConnectionEvent::DISCONNECT_REQUESTED, attempt, static_cast<int>(ErrorCode::OPERATION_CANCELLED));
+        cancel.throwIfCancelled("Connecting");
+      }
+      bool linkError = e.code() == ErrorCode::BLE_FAILED_TO_CONNECT || e.code() == ErrorCode::SOFTAP_CONNECTION_FAILURE;
+      connection->post(linkError ? ConnectionEvent::LINK_FAILED : ConnectionEvent::SESSION_FAILED, attempt, static_cast<int>(e.code()));
+      throw;
+    } catch (...) {
+      connection->post(ConnectionEvent::SESSION_FAILED, attempt, static_cast<int>(ErrorCode::ESP_NATIVE_UNKNOWN_ERROR));
+      throw;
+    }
+    device->session = std::move(session);
+    connection->post(ConnectionEvent::SESSION_ESTABLISHED, attempt);
+  }
+
+  void ProtocommEngine::disconnect(const std::string& deviceName) {
+    std::shared_ptr<Device> device = findDevice(deviceName);
+    std::lock_guard lock(device->mutex);
+    device->session.reset();
+    ConnectionRegistry::shared().machine(deviceName)->post(ConnectionEvent::DISCONNECT_REQUESTED);
+  }
+
+  bool ProtocommEngine::isSessionEstablished(const std::string& deviceName) {
+    std::shared_ptr<Device> device = findDevice(deviceName);
+    std::lock_guard lock(device->mutex);
+    return device->session != nullptr && device->session->isEstablished();
+  }
+
+  std::string ProtocommEngine::versionInfo(const std::string& deviceName) {
+    std::shared_ptr<Device> device = findDevice(deviceName);
+    std::lock_guard lock(device->mutex);
+    return requireSession(*device).versionInfo();
+  }
+
+  std::vector<WifiNetwork> ProtocommEngine::scanWifi(const std::string& deviceName, bool forceRefresh,
+                                                     const CancellationToken& cancel) {
+    std::shared_ptr<Device> device = findDevice(deviceName);
+    std::chrono::milliseconds ttl(_scanCacheTtlMs.load());
+    if (!forceRefresh) {
+      if (auto cached = device->scanCache.lookup(WifiScanCache::Clock::now(), ttl)) {
+        return std::move(*cached);
+      }
+    }
+
+    std::lock_guard lock(device->mutex);
+    if (!forceRefresh) {
+      // Another caller may have scanned while this one waited for the device
+      if (auto cached = device->scanCache.lookup(WifiScanCache::Clock::now(), ttl)) {
+        return std::move(*cached);
+      }
+    }
+    cancel.throwIfCancelled("The Wi-Fi scan");
+    ProtocommSession& session = requireSession(*device);
+    std::vector<WifiNetwork> networks;
+    try {
+      AbortOnCancel abortOnCancel(session, cancel);
+      PhaseTimer phase(device->timings.get(), Phase::SCAN);
+      uint32_t resultCount = runWifiScan(session);
+      networks = WifiScanCache::mergeByBssid(readWifiScanResults(session, 0, resultCount));
+    } catch (...) {
+      closeIfCancelled(*device, cancel, "The Wi-Fi scan");
+      throw;
+    }
+    if (ttl.count() > 0) {
+      device->scanCache.store(networks, WifiScanCache::Clock::now());
+    }
+    return networks;
+  }
+
+  uint32_t ProtocommEngine::startWifiScan(const std::string& deviceName, bool forceRefresh, const CancellationToken& cancel) {
+    std::shared_ptr<Device> device = findDevice(deviceName);
+    std::lock_guard lock(device->mutex);
+    cancel.throwIfCancelled("The Wi-Fi scan");
+    device->pagedFromCache.reset();
+    device->pagedFromDevice.clear();
+    if (!forceRefresh) {
+      device->pagedFromCache = device->scanCache.lookup(WifiScanCache::Clock::now(), std::chrono::milliseconds(_scanCacheTtlMs.load()));
+      if (device->pagedFromCache.has_value()) {
+        device->scanResultCount = static_cast<uint32_t>(device->pagedFromCache->size());
+        return device->scanResultCount;
+      }
+    }
+    ProtocommSession& session = requireSession(*device);
+    // A failed scan leaves nothing to page
+    device->scanResultCount = 0;
+    try {
+      AbortOnCancel abortOnCancel(session, cancel);
+      PhaseTimer phase(device->timings.get(), Phase::SCAN);
+      device->scanResultCount = runWifiScan(session);
+    } catch (...) {
+      closeIfCancelled(*device, cancel, "The Wi-Fi scan");
+      throw;
+    }
+    return device->scanResultCount;
+  }
+
+  std::vector<WifiNetwork> ProtocommEngine::fetchWifiScanResults(const std::string& deviceName, uint32_t startIndex, uint32_t count,
+                                                                 const CancellationToken& cancel) {
+    std::shared_ptr<Device> device = findDevice(deviceName);
+    std::lock_guard lock(device->mutex);
+    cancel.throwIfCancelled("Reading the Wi-Fi scan results");
+    if (startIndex >= device->scanResultCount) {
+      return {};
+    }
+    count = std::min(count, device->scanResultCount - startIndex);
+    if (device->pagedFromCache.has_value()) {
+      auto first = device->pagedFromCache->begin() + startIndex;
+      return std::vector<WifiNetwork>(first, first + count);
+    }
+
+    ProtocommSession& session = requireSession(*device);
+    std::vector<WifiNetwork> networks;
+    try {
+      AbortOnCancel abortOnCancel(session, cancel);
+      networks = readWifiScanResults(session, startIndex, count);
+    } catch (...) {
+      closeIfCancelled(*device, cancel, "Reading the Wi-Fi scan results");
+      throw;
+    }
+    std::chrono::milliseconds ttl(_scanCacheTtlMs.load());
+    if (ttl.count() > 0 && startIndex == device->pagedFromDevice.size()) {
+      device->pagedFromDevice.insert(device->pagedFromDevice.end(), networks.begin(), networks.end());
+      if (device->pagedFromDevice.size() == device->scanResultCount) {
+        device->scanCache.store(WifiScanCache::mergeByBssid(std::move(device->pagedFromDevice)), WifiScanCache::Clock::now());
+        device->pagedFromDevice.clear();
+      }
+    }
+    return networks;
+  }
+
+  uint32_t ProtocommEngine::runWifiScan(ProtocommSession& session) {
+    RequestBuffer body;
+    proto::CmdScanStart start{.blocking = true, .passive = false, .groupChannels = 0, .periodMs = 120};
+    scanRequest(session, proto::WiFiScanMsgType::TYPE_CMD_SCAN_START, body.encode(start), _timeouts.scan);
+
+    Response statusResponse = scanRequest(session, proto::WiFiScanMsgType::TYPE_CMD_SCAN_STATUS, {}, _timeouts.request);
+    proto::RespScanStatus status = proto::decodeRespScanStatus(statusResponse.body);
+    if (!status.scanFinished) {
+      throw ProtocommError(ErrorCode::WIFI_SCAN_REQUEST_ERROR, "Device did not finish the Wi-Fi scan");
+    }
+    if (status.resultCount == 0) {
+      throw ProtocommError(ErrorCode::WIFI_SCAN_EMPTY_RESULT_COUNT, "Device found no Wi-Fi networks");
+    }
+    return status.resultCount;
+  }
+
+  std::vector<WifiNetwork> ProtocommEngine::readWifiScanResults(ProtocommSession& session, uint32_t startIndex, uint32_t count) {
+    RequestBuffer body;
+    std::vector<WifiNetwork> networks;
+    networks.reserve(count);
+    uint32_t end = startIndex + count;
+    for (uint32_t index = startIndex; index < end; index += SCAN_RESULT_PAGE_SIZE) {
+      proto::CmdScanResult page{.startIndex = index, .count = std::min(SCAN_RESULT_PAGE_SIZE, end - index)};
+      Response result = scanRequest(session, proto::WiFiScanMsgType::TYPE_CMD_SCAN_RESULT, body.encode(page), _timeouts.request);
+      proto::ScanResultReader reader(result.body);
+      proto::WiFiScanResultView entry;
+      while (reader.next(entry)) {
+        networks.push_back(WifiNetwork{
+            .ssid = std::string(asString(entry.ssid)),
+            .bssid = toHex(entry.bssid),
+            .channel = entry.channel,
+            .rssi = entry.rssi,
+            .auth = static_cast<uint32_t>(entry.auth),
+        });
+      }
+    }
+    return networks;
+  }
+
+  uint32_t ProtocommEngine::provision(const std::string& deviceName, std::string_view ssid, std::string_view passphrase,
+                                      const CancellationToken& cancel) {
+    StatusPollSchedule schedule = statusPollSchedule();
+    std::shared_ptr<Device> device = findDevice(deviceName);
+    std::lock_guard lock(device->mutex);
+    cancel.throwIfCancelled("Provisioning");
+    ProtocommSession& session = requireSession(*device);
+    try {
+      AbortOnCancel abortOnCancel(session, cancel);
+      return applyWifiConfig(*device, session, ssid, passphrase, schedule, cancel);
+    } catch (...) {
+      closeIfCancelled(*device, cancel, "Provisioning");
+      throw;
+    }
+  }
+
+  uint32_t ProtocommEngine::applyWifiConfig(Device& device, ProtocommSession& session, std::string_view ssid,
+                                            std::string_view passphrase, const StatusPollSchedule& schedule,
+                                            const CancellationToken& cancel) {
+    const std::string& deviceName = device.config.name;
+
+    proto::CmdSetConfigView config;
+    config.ssid = asBytes(ssid);
+    config.passphrase = asBytes(passphrase);
+    RunTimings* timings = device.timings.get();
+    {
+      PhaseTimer phase(timings, Phase::CONFIG_SEND);
+      RequestBuffer configBody;
+      Response setResponse = configRequest(session, proto::WiFiConfigMsgType::TYPE_CMD_SET_CONFIG, configBody.encode(config),
+                                           ErrorCode::PROV_CONFIGURATION_ERROR);
+      checkConfigStatus(setResponse.body, "Sending the Wi-Fi config");
+    }
+    {
+      PhaseTimer phase(timings, Phase::APPLY);
+      Response applyResponse =
+          configRequest(session, proto::WiFiConfigMsgType::TYPE_CMD_APPLY_CONFIG, {}, ErrorCode::PROV_CONFIGURATION_ERROR);
+      checkConfigStatus(applyResponse.body, "Applying the Wi-Fi config");
+    }
+
+    PhaseTimer phase(timings, Phase::STATUS_WAIT);
+    auto deadline = std::chrono::steady_clock::now() + schedule.deadline;
+    std::chrono::milliseconds delay = schedule.first;
+    uint32_t polls = 0;
+    while (std::chrono::steady_clock::now() < deadline) {
+      auto remaining = deadline - std::chrono::steady_clock::now();
+      {
+        TraceSpan trace(TraceCategory::DEVICE, "status poll wait", deviceName);
+        if (!sleepUnlessCancelled(std::min<std::chrono::steady_clock::duration>(delay, remaining), cancel)) {
+          cancel.throwIfCancelled("Provisioning");
+        }
+      }
+      delay = schedule.next(delay);
+      phase.setPolls(++polls);
+
+      Response statusResponse =
+          configRequest(session, proto::WiFiConfigMsgType::TYPE_CMD_GET_STATUS, {}, ErrorCode::PROV_WIFI_STATUS_ERROR);
+      proto::RespGetStatusView status = proto::decodeRespGetStatusView(statusResponse.body);
+      if (status.status != proto::Status::SUCCESS) {
+        throw ProtocommError(ErrorCode::PROV_WIFI_STATUS_ERROR,
+                             "Wi-Fi status request failed with status " + std::to_string(static_cast<uint32_t>(status.status)));
+      }
+
+      switch (status.staState) {
+        case proto::WifiStationState::CONNECTED:
+          return polls;
+        case proto::WifiStationState::CONNECTING:
+          continue;
+        case proto::WifiStationState::DISCONNECTED:
+          throw ProtocommError(ErrorCode::PROV_WIFI_STATUS_DISCONNECTED, "Device disconnected from the Wi-Fi network");
+        case proto::WifiStationState::CONNECTION_FAILED:
+          if (status.failReason == proto::WifiConnectFailedReason::AUTH_ERROR) {
+            throw ProtocommError(ErrorCode::PROV_WIFI_STATUS_AUTH_ERROR, "Wi-Fi authentication failed");
+          }
+          if (status.failReason == proto::WifiConnectFailedReason::NETWORK_NOT_FOUND) {
+            throw ProtocommError(ErrorCode::PROV_WIFI_STATUS_NETWORK_NOT_FOUND, "Wi-Fi network not found");
+          }
+          throw ProtocommError(ErrorCode::PROV_WIFI_STATUS_UNKNOWN_ERROR, "Wi-Fi connection failed");
+        default:
+          throw ProtocommError(ErrorCode::PROV_WIFI_STATUS_UNKNOWN_ERROR, "Unknown Wi-Fi station state");
+      }
+    }
+    throw ProtocommError(ErrorCode::PROV_TIMED_OUT_ERROR, "Device did not join the Wi-Fi network in time");
+  }
+
+  Bytes ProtocommEngine::sendData(const std::string& deviceName, std::string_view endpoint, ByteView payload,
+                                  const CancellationToken& cancel) {
+    // Includes waiting for other calls on the device, which is part of what the caller sees
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&] { return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start); };
+    try {
+      std::shared_ptr<Device> device = findDevice(deviceName);
+      std::lock_guard lock(device->mutex);
+      cancel.throwIfCancelled("The request");
+      ProtocommSession& session = requireSession(*device);
+      Bytes response;
+      try {
+        AbortOnCancel abortOnCancel(session, cancel);
+        response = session.request(endpoint, payload);
+      } catch (...) {
+        closeIfCancelled(*device, cancel, "The request");
+        throw;
+      }
+      MetricsRegistry::shared().recordEndpoint(endpoint, elapsed());
+      return response;
+    } catch (...) {
+      MetricsRegistry::shared().recordEndpoint(endpoint, elapsed());
+      throw;
+    }
+  }
+
+  std::vector<PhaseSpan> ProtocommEngine::runTimings(const std::string& deviceName) {
+    return findDevice(deviceName)->timings->spans();
+  }
+
+  void ProtocommEngine::recordPhase(const std::string& deviceName, const PhaseSpan& span) {
+    findDevice(deviceName)->timings->record(span);
+  }
+
+} // namespace espprov
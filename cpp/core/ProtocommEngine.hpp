@@ -0,0 +1,235 @@
+///
+/// ProtocommEngine.hpp
+/// The platform independent provisioning engine: sessions, Wi-Fi scan, Wi-Fi config and custom endpoints.
+///
+
+#pragma once
+
+#include "Bytes.hpp"
+#include "Cancellation.hpp"
+#include "ProtocommSession.hpp"
+#include "RunTimings.hpp"
+#include "SessionScheduler.hpp"
+#include "Timeouts.hpp"
+#include "Transport.hpp"
+#include "WifiScanCache.hpp"
+#include "security/Security.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace espprov {
+
+  /**
+   * The transport a device is reached over. Values match `PTTransport`.
+   */
+  enum class TransportKind : uint8_t {
+    BLE = 0,
+    SOFTAP = 1,
+  };
+
+  struct DeviceConfig {
+    std::string name;
+    TransportKind transport = TransportKind::BLE;
+    SecurityScheme security = SecurityScheme::SEC2;
+    SecurityParams securityParams;
+  };
+
+  /**
+   * Bounds on the devices an engine keeps. Whenever a device is configured or used, devices idle
+   * for longer than `idleTimeout` and the least recently used ones beyond `maxDevices` are dropped
+   * together with their session and keys. A `SECURED` device is never dropped for being idle, only
+   * to stay within `maxDevices`.
+   */
+  struct RegistryLimits {
+    size_t maxDevices = 64;
+    std::chrono::milliseconds idleTimeout = std::chrono::minutes(10);
+  };
+
+  /**
+   * Owns one protocomm session per configured device.
+   *
+   * Every method is blocking and thread safe. Calls on the same device are serialized, calls on
+   * different devices run in parallel. BLE sessions share the phone's link slots and radio through
+   * a `SessionScheduler`. Errors are reported as `ProtocommError`.
+   *
+   * Calls that talk to the device take a `CancellationToken`. Cancelling it while the call waits
+   * for a link slot, a radio turn, a reply or the next status poll aborts the device's transport,
+   * closes its session, which frees the link, and fails the call with `OPERATION_CANCELLED`. A
+   * call still waiting for another call on the same device only notices once that one finished.
+   */
+  class ProtocommEngine {
+  public:
+    /**
+     * Creates the raw transport for a device. Called on every `connect()`.
+     */
+    using TransportFactory = std::function<std::unique_ptr<Transport>(const DeviceConfig& config)>;
+    using EvictionListener = std::function<void(const std::string& deviceName)>;
+
+    /// The number of scan results the ESP firmware returns per `CmdScanResult`.
+    static constexpr uint32_t SCAN_RESULT_PAGE_SIZE = 4;
+
+    explicit ProtocommEngine(TransportFactory transportFactory, Timeouts timeouts = {});
+    ~ProtocommEngine();
+
+    ProtocommEngine(const ProtocommEngine&) = delete;
+    ProtocommEngine& operator=(const ProtocommEngine&) = delete;
+
+    const Timeouts& timeouts() const noexcept {
+      return _timeouts;
+    }
+
+    /**
+     * Registers a device, or replaces its configuration and closes any open session.
+     */
+    void configureDevice(DeviceConfig config);
+    bool hasDevice(const std::string& deviceName) const;
+
+    void setRegistryLimits(RegistryLimits limits);
+    /**
+     * Calls `listener` with the name of every device the registry limits dropped, on the thread that
+     * caused it and outside of any engine lock. Devices released explicitly are not reported. Returns
+     * an id for `removeEvictionListener`.
+     */
+    uint64_t addEvictionListener(EvictionListener listener);
+    bool removeEvictionListener(uint64_t id);
+    /**
+     * How many BLE sessions stay open at once and how many of their exchanges run at once.
+     * Defaults to 4 links and 2 exchanges.
+     */
+    void setSessionLimits(SessionLimits limits);
+    const SessionScheduler& sessionScheduler() const noexcept {
+      return _scheduler;
+    }
+    /**
+     * How long a device's scan result is served from its cache. Zero turns the cache off.
+     * Defaults to 30 seconds.
+     */
+    void setScanCacheTtl(std::chrono::milliseconds ttl) noexcept;
+    /**
+     * When `provision` polls the Wi-Fi status. Starts as `Timeouts::statusPoll`, applies from the
+     * next `provision`.
+     */
+    void setStatusPollSchedule(StatusPollSchedule schedule);
+    StatusPollSchedule statusPollSchedule() const;
+    /**
+     * Drops a device, its session and its connection state. Calls already running on it finish first.
+     * Returns false if the device was not known.
+     */
+    bool releaseDevice(const std::string& deviceName);
+    void releaseAllDevices();
+
+    void connect(const std::string& deviceName, const CancellationToken& cancel = {});
+    void disconnect(const std::string& deviceName);
+    bool isSessionEstablished(const std::string& deviceName);
+    std::string versionInfo(const std::string& deviceName);
+
+    /**
+     * Runs a blocking scan on the device and fetches all results page by page, merged by BSSID.
+     * Unless `forceRefresh` is set, a result younger than the scan cache TTL is returned instead,
+     * without waiting for other calls on the device or touching its radio.
+     */
+    std::vector<WifiNetwork> scanWifi(const std::string& deviceName, bool forceRefresh = false, const CancellationToken& cancel = {});
+
+    /**
+     * Runs a blocking scan on the device and returns the number of networks it found, which
+     * `fetchWifiScanResults` then reads in pages. The results stay on the device until the next scan.
+     * Unless `forceRefresh` is set, a cached result is paged instead. A scan whose pages were all
+     * read in order is cached once the last page arrives.
+     */
+    uint32_t startWifiScan(const std::string& deviceName, bool forceRefresh = false, const CancellationToken& cancel = {});
+
+    /**
+     * Reads up to `count` results of the last scan starting at `startIndex`, one device request per
+     * `SCAN_RESULT_PAGE_SIZE` entries. Returns fewer once the end of the results is reached.
+     */
+    std::vector<WifiNetwork> fetchWifiScanResults(const std::string& deviceName, uint32_t startIndex, uint32_t count,
+                                                  const CancellationToken& cancel = {});
+
+    /**
+     * Sends the credentials, applies them and polls the station state on the status poll schedule
+     * until the device joined the network, reported a failure or the schedule's deadline ran out.
+     * Returns as soon as a poll reports the device connected, with the number of polls it took,
+     * which the `STATUS_WAIT` span records as well.
+     */
+    uint32_t provision(const std::string& deviceName, std::string_view ssid, std::string_view passphrase,
+                       const CancellationToken& cancel = {});
+
+    /**
+     * Sends an already serialized payload to a custom endpoint over the secured session. Its latency
+     * goes into the endpoint's histogram in `MetricsRegistry::shared()`.
+     */
+    Bytes sendData(const std::string& deviceName, std::string_view endpoint, ByteView payload, const CancellationToken& cancel = {});
+
+    /**
+     * The phases of the device's current run the engine and the platform recorded, in phase order.
+     * Answers right away, even while a call runs on the device.
+     */
+    std::vector<PhaseSpan> runTimings(const std::string& deviceName);
+    /**
+     * Adds a phase the platform ran for the device, such as `SEARCH` or `CREATE`.
+     */
+    void recordPhase(const std::string& deviceName, const PhaseSpan& span);
+
+  private:
+    struct Device {
+      DeviceConfig config;
+      std::mutex mutex;
+      std::unique_ptr<ProtocommSession> session;
+      /// Guarded by `_devicesMutex`, not by `mutex`.
+      std::chrono::steady_clock::time_point lastUsed;
+      /// The result count of the last `startWifiScan` on the current session.
+      uint32_t scanResultCount = 0;
+      /// Set while `startWifiScan` pages a cached result instead of the device's.
+      std::optional<std::vector<WifiNetwork>> pagedFromCache;
+      /// The pages of the running `startWifiScan` read so far, cached once complete.
+      std::vector<WifiNetwork> pagedFromDevice;
+      /// Has its own lock.
+      WifiScanCache scanCache;
+      /// Has its own lock. Carried over when the device is configured again.
+      std::shared_ptr<RunTimings> timings;
+    };
+
+    std::shared_ptr<Device> findDevice(const std::string& deviceName);
+    /**
+     * Removes the devices `_limits` no longer allow, and their connection states. Must hold
+     * `_devicesMutex`. The devices are returned so their sessions close once the lock is released.
+     */
+    std::vector<std::shared_ptr<Device>> evictLocked(std::chrono::steady_clock::time_point now);
+    void notifyEvicted(const std::vector<std::shared_ptr<Device>>& evicted);
+    static ProtocommSession& requireSession(Device& device);
+    /**
+     * Called from the handler of a failed call. If `cancel` was the reason, closes the device's
+     * session and throws `OPERATION_CANCELLED` naming `what`. Must hold the device's mutex.
+     */
+    static void closeIfCancelled(Device& device, const CancellationToken& cancel, const char* what);
+    uint32_t applyWifiConfig(Device& device, ProtocommSession& session, std::string_view ssid, std::string_view passphrase,
+                             const StatusPollSchedule& schedule, const CancellationToken& cancel);
+    uint32_t runWifiScan(ProtocommSession& session);
+    std::vector<WifiNetwork> readWifiScanResults(ProtocommSession& session, uint32_t startIndex, uint32_t count);
+
+  private:
+    TransportFactory _transportFactory;
+    Timeouts _timeouts;
+    // Outlives the sessions in `_devices`, whose transports hold its grants
+    SessionScheduler _scheduler;
+    mutable std::mutex _devicesMutex;
+    std::unordered_map<std::string, std::shared_ptr<Device>> _devices;
+    RegistryLimits _limits;
+    // Guarded by `_devicesMutex` like `_limits`
+    StatusPollSchedule _statusPoll;
+    std::atomic<std::chrono::milliseconds::rep> _scanCacheTtlMs{30000};
+
+    std::mutex _evictionListenersMutex;
+    std::unordered_map<uint64_t, std::shared_ptr<const EvictionListener>> _evictionListeners;
+    uint64_t _nextEvictionListenerId = 1;
+  };
+
+} // namespace espprov
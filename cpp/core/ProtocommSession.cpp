@@ -0,0 +1,116 @@
+///
+/// ProtocommSession.cpp
+/// A secured protocomm session on top of a raw transport.
+///
+
+#include "ProtocommSession.hpp"
+#include "Errors.hpp"
+#include "Tracer.hpp"
+#include <cctype>
+#include <optional>
+
+namespace espprov {
+
+  namespace {
+    /**
+     * Pulls `"sec_ver": N` out of the `proto-ver` JSON without a full JSON parser.
+     * Returns `nullopt` for firmwares that do not report it.
+     */
+    std::optional<int> findSecVer(std::string_view json) {
+      constexpr std::string_view key = "\"sec_ver\"";
+      size_t pos = json.find(key);
+      if (pos == std::string_view::npos) {
+        return std::nullopt;
+      }
+      pos += key.size();
+      while (pos < json.size() && (json[pos] == ':' || std::isspace(static_cast<unsigned char>(json[pos])))) {
+        pos++;
+      }
+      int value = 0;
+      bool hasDigits = false;
+      while (pos < json.size() && std::isdigit(static_cast<unsigned char>(json[pos]))) {
+        value = value * 10 + (json[pos] - '0');
+        hasDigits = true;
+        pos++;
+      }
+      return hasDigits ? std::optional<int>(value) : std::nullopt;
+    }
+  } // namespace
+
+  ProtocommSession::ProtocommSession(std::unique_ptr<Transport> transport, std::unique_ptr<Security> security,
+                                     const Timeouts& timeouts)
+      : _transport(std::move(transport)), _security(std::move(security)), _timeouts(timeouts) {}
+
+  ProtocommSession::~ProtocommSession() {
+    close();
+  }
+
+  void ProtocommSession::establish(RunTimings* timings) {
+    close();
+    try {
+      {
+        PhaseTimer phase(timings, Phase::CONNECT);
+        TraceSpan trace(TraceCategory::TRANSPORT, "connect");
+        _transport->connect(_timeouts.connect);
+      }
+      {
+        PhaseTimer phase(timings, Phase::VERSION_INFO);
+        Bytes version = exchange(endpoints::PROTO_VER, asBytes("ESP"), _timeouts.request);
+        _versionInfo.assign(version.begin(), version.end());
+        checkVersionInfo();
+      }
+      {
+        PhaseTimer phase(timings, Phase::HANDSHAKE);
+        _security->handshake([this](const proto::SessionData& request) {
+          Bytes response = exchange(endpoints::PROV_SESSION, proto::encodeSessionData(request), _timeouts.request);
+          return proto::decodeSessionData(response);
+        });
+      }
+      _established = true;
+    } catch (...) {
+      close();
+      throw;
+    }
+  }
+
+  void ProtocommSession::checkVersionInfo() {
+    std::optional<int> secVer = findSecVer(_versionInfo);
+    if (secVer.has_value() && *secVer != static_cast<int>(_security->scheme())) {
+      throw ProtocommError(ErrorCode::SESSION_SECURITY_MISMATCH,
+                           "Device uses security scheme " + std::to_string(*secVer) + " but scheme " +
+                               std::to_string(static_cast<int>(_security->scheme())) + " was requested");
+    }
+  }
+
+  Bytes ProtocommSession::request(std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout) {
+    if (!_established) {
+      throw ProtocommError(ErrorCode::SESSION_NOT_ESTABLISHED, "Session is not established");
+    }
+    Bytes encrypted;
+    {
+      TraceSpan trace(TraceCategory::CRYPTO, "encrypt", endpoint);
+      encrypted = _security->encrypt(payload);
+    }
+    Bytes response = exchange(endpoint, encrypted, timeout);
+    TraceSpan trace(TraceCategory::CRYPTO, "decrypt", endpoint);
+    return _security->decrypt(response);
+  }
+
+  Bytes ProtocommSession::exchange(std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout) {
+    TraceSpan trace(TraceCategory::TRANSPORT, endpoint);
+    try {
+      return _transport->exchange(endpoint, payload, timeout);
+    } catch (const ProtocommError&) {
+      throw;
+    } catch (const std::exception& e) {
+      throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, e.what());
+    }
+  }
+
+  void ProtocommSession::close() noexcept {
+    _established = false;
+    _versionInfo.clear();
+    _transport->disconnect();
+  }
+
+} // namespace espprov
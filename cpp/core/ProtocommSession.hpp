@@ -0,0 +1,87 @@
+///
+/// ProtocommSession.hpp
+/// A secured protocomm session on top of a raw transport.
+///
+
+#pragma once
+
+#include "Bytes.hpp"
+#include "RunTimings.hpp"
+#include "Timeouts.hpp"
+#include "Transport.hpp"
+#include "security/Security.hpp"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace espprov {
+
+  namespace endpoints {
+    inline constexpr std::string_view PROTO_VER = "proto-ver";
+    inline constexpr std::string_view PROV_SESSION = "prov-session";
+    inline constexpr std::string_view PROV_SCAN = "prov-scan";
+    inline constexpr std::string_view PROV_CONFIG = "prov-config";
+  } // namespace endpoints
+
+  /**
+   * Owns the transport and the security layer of one device and runs the protocomm
+   * request/response cycle on them. Not thread safe except for `abort()` - callers serialize access per
+   * device.
+   */
+  class ProtocommSession {
+  public:
+    ProtocommSession(std::unique_ptr<Transport> transport, std::unique_ptr<Security> security, const Timeouts& timeouts);
+    ~ProtocommSession();
+
+    ProtocommSession(const ProtocommSession&) = delete;
+    ProtocommSession& operator=(const ProtocommSession&) = delete;
+
+    /**
+     * Opens the transport, reads `proto-ver` and runs the security handshake, recording each step
+     * in `timings` if given. Throws `ProtocommError` on failure, leaving the session closed.
+     */
+    void establish(RunTimings* timings = nullptr);
+
+    bool isEstablished() const noexcept {
+      return _established;
+    }
+
+    /**
+     * The raw JSON returned by the `proto-ver` endpoint, empty before `establish()`.
+     */
+    const std::string& versionInfo() const noexcept {
+      return _versionInfo;
+    }
+
+    /**
+     * Encrypts `payload`, sends it to `endpoint` and returns the decrypted response.
+     */
+    Bytes request(std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout);
+    Bytes request(std::string_view endpoint, ByteView payload) {
+      return request(endpoint, payload, _timeouts.request);
+    }
+
+    void close() noexcept;
+
+    /**
+     * Aborts the transport, see `Transport::abort()`. May be called from any thread, also while
+     * another thread runs a request, which then fails. The session can not be used afterwards.
+     */
+    void abort() noexcept {
+      _transport->abort();
+    }
+
+  private:
+    Bytes exchange(std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout);
+    void checkVersionInfo();
+
+  private:
+    std::unique_ptr<Transport> _transport;
+    std::unique_ptr<Security> _security;
+    Timeouts _timeouts;
+    std::string _versionInfo;
+    bool _established = false;
+  };
+
+} // namespace espprov
@@ -0,0 +1,85 @@
+///
+/// RunTimings.cpp
+/// When each phase of a device's provisioning run started and how long it took.
+///
+
+#include "RunTimings.hpp"
+#include "Metrics.hpp"
+#include "Tracer.hpp"
+#include <exception>
+
+namespace espprov {
+
+  namespace {
+    constexpr std::array<std::string_view, PHASE_COUNT> PHASE_NAMES = {
+        "SEARCH", "CREATE", "CONNECT", "VERSION_INFO", "HANDSHAKE", "SCAN", "CONFIG_SEND", "APPLY", "STATUS_WAIT",
+    };
+  } // namespace
+
+  std::string_view phaseName(Phase phase) noexcept {
+    auto index = static_cast<size_t>(phase);
+    return index < PHASE_COUNT ? PHASE_NAMES[index] : std::string_view("UNKNOWN");
+  }
+
+  void RunTimings::record(const PhaseSpan& span) {
+    auto index = static_cast<size_t>(span.phase);
+    if (index >= PHASE_COUNT) {
+      return;
+    }
+    if (_metrics != nullptr) {
+      _metrics->recordPhase(span.phase, span.duration);
+    }
+    std::lock_guard lock(_mutex);
+    _spans[index] = span;
+    for (size_t later = index + 1; later < PHASE_COUNT; later++) {
+      _spans[later].reset();
+    }
+  }
+
+  std::vector<PhaseSpan> RunTimings::spans() const {
+    std::lock_guard lock(_mutex);
+    std::vector<PhaseSpan> spans;
+    for (const std::optional<PhaseSpan>& span : _spans) {
+      if (span.has_value()) {
+        spans.push_back(*span);
+      }
+    }
+    return spans;
+  }
+
+  void RunTimings::clear() noexcept {
+    std::lock_guard lock(_mutex);
+    _spans.fill(std::nullopt);
+  }
+
+  // pragma MARK: PhaseTimer
+
+  PhaseTimer::PhaseTimer(RunTimings* timings, Phase phase) noexcept
+      : _timings(timings), _phase(phase), _uncaughtExceptions(std::uncaught_exceptions()) {
+    if (_timings != nullptr) {
+      _start = std::chrono::system_clock::now();
+      _steadyStart = std::chrono::steady_clock::now();
+    }
+  }
+
+  PhaseTimer::~PhaseTimer() {
+    if (_timings == nullptr) {
+      return;
+    }
+    auto end = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - _steadyStart);
+    Tracer::shared().complete(TraceCategory::PHASE, phaseName(_phase), {}, _steadyStart, end);
+    try {
+      _timings->record(PhaseSpan{
+          .phase = _phase,
+          .start = _start,
+          .duration = duration,
+          .failed = std::uncaught_exceptions() > _uncaughtExceptions,
+          .polls = _polls,
+      });
+    } catch (...) {
+      // Timing is best effort, it never replaces the error that ended the phase
+    }
+  }
+
+} // namespace espprov
@@ -0,0 +1,118 @@
+///
+/// RunTimings.hpp
+/// When each phase of a device's provisioning run started and how long it took.
+///
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace espprov {
+
+  class MetricsRegistry;
+
+  /**
+   * The phases of a provisioning run, in the order they run. Values match `PTPhase`.
+   */
+  enum class Phase : uint8_t {
+    /// Discovering the device. Recorded by the platform layer.
+    SEARCH = 0,
+    /// Creating the platform's device object. Recorded by the platform layer.
+    CREATE = 1,
+    /// Opening the transport link.
+    CONNECT = 2,
+    /// Reading `proto-ver`.
+    VERSION_INFO = 3,
+    /// The security handshake on `prov-session`.
+    HANDSHAKE = 4,
+    /// Starting a Wi-Fi scan and reading its results.
+    SCAN = 5,
+    /// Sending the Wi-Fi credentials.
+    CONFIG_SEND = 6,
+    /// Applying them.
+    APPLY = 7,
+    /// Polling the station state until the device joined the network or gave up.
+    STATUS_WAIT = 8,
+  };
+
+  inline constexpr size_t PHASE_COUNT = 9;
+
+  /**
+   * The name of the `PTPhase` value, like `"HANDSHAKE"`.
+   */
+  std::string_view phaseName(Phase phase) noexcept;
+
+  struct PhaseSpan {
+    Phase phase;
+    std::chrono::system_clock::time_point start;
+    /// Measured on the steady clock.
+    std::chrono::microseconds duration;
+    /// The phase ended with an error.
+    bool failed = false;
+    /// How many times the device's Wi-Fi status was polled, for `STATUS_WAIT`.
+    uint32_t polls = 0;
+  };
+
+  /**
+   * The latest span of every phase of one device. Recording a phase starts the run over from it:
+   * spans of later phases belong to an earlier attempt and are dropped, so a reconnect keeps the
+   * search and create spans but forgets the previous scan and config.
+   *
+   * Thread safe. It has its own lock, so reading it never waits for the call running on the device.
+   */
+  class RunTimings {
+  public:
+    /**
+     * Every recorded span is also added to `metrics`, if given.
+     */
+    explicit RunTimings(MetricsRegistry* metrics = nullptr) noexcept: _metrics(metrics) {}
+
+    void record(const PhaseSpan& span);
+    /**
+     * The recorded spans in phase order.
+     */
+    std::vector<PhaseSpan> spans() const;
+    void clear() noexcept;
+
+  private:
+    MetricsRegistry* _metrics;
+    mutable std::mutex _mutex;
+    std::array<std::optional<PhaseSpan>, PHASE_COUNT> _spans;
+  };
+
+  /**
+   * Times a phase from construction to destruction. A phase left by an exception is recorded as
+   * failed. Does nothing without `timings`. The phase is traced as well while the tracer runs.
+   */
+  class PhaseTimer {
+  public:
+    PhaseTimer(RunTimings* timings, Phase phase) noexcept;
+    ~PhaseTimer();
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    /**
+     * Recorded as the span's `polls`.
+     */
+    void setPolls(uint32_t polls) noexcept {
+      _polls = polls;
+    }
+
+  private:
+    RunTimings* _timings;
+    Phase _phase;
+    uint32_t _polls = 0;
+    int _uncaughtExceptions;
+    std::chrono::system_clock::time_point _start;
+    std::chrono::steady_clock::time_point _steadyStart;
+  };
+
+} // namespace espprov
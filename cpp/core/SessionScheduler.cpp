@@ -0,0 +1,125 @@
+///
+/// SessionScheduler.cpp
+/// Shares the phone's BLE connection slots and radio between several open provisioning sessions.
+///
+
+#include "SessionScheduler.hpp"
+#include "Tracer.hpp"
+#include <algorithm>
+
+namespace espprov {
+
+  namespace {
+    SessionLimits sanitized(SessionLimits limits) {
+      limits.maxLinks = std::max<size_t>(limits.maxLinks, 1);
+      limits.maxExchanges = std::max<size_t>(limits.maxExchanges, 1);
+      return limits;
+    }
+  } // namespace
+
+  SessionScheduler::SessionScheduler(SessionLimits limits): _limits(sanitized(limits)) {}
+
+  void SessionScheduler::setLimits(SessionLimits limits) {
+    {
+      std::lock_guard lock(_mutex);
+      _limits = sanitized(limits);
+    }
+    _changed.notify_all();
+  }
+
+  SessionLimits SessionScheduler::limits() const {
+    std::lock_guard lock(_mutex);
+    return _limits;
+  }
+
+  SessionScheduler::Grant SessionScheduler::acquireLink(std::chrono::milliseconds timeout, const CancellationToken& cancel) {
+    return acquire(_links, &SessionLimits::maxLinks, true, timeout, cancel);
+  }
+
+  SessionScheduler::Grant SessionScheduler::acquireTurn(std::chrono::milliseconds timeout, const CancellationToken& cancel) {
+    return acquire(_turns, &SessionLimits::maxExchanges, false, timeout, cancel);
+  }
+
+  SessionScheduler::Grant SessionScheduler::acquire(Queue& queue, const size_t SessionLimits::* limit, bool link,
+                                                    std::chrono::milliseconds timeout, const CancellationToken& cancel) {
+    TraceSpan trace(TraceCategory::DEVICE, link ? "link slot wait" : "exchange turn wait");
+    // Taking the lock before notifying means the wakeup can not slip in between a waiter's check and its wait
+    CancellationRegistration wakeOnCancel = cancel.onCancel([this] {
+      { std::lock_guard wake(_mutex); }
+      _changed.notify_all();
+    });
+    std::unique_lock lock(_mutex);
+    uint64_t ticket = queue.nextTicket++;
+    queue.waiting.push_back(ticket);
+    // Only the head of the queue may take a free slot, so nobody overtakes an earlier waiter
+    bool granted = _changed.wait_for(lock, timeout, [&] {
+      return cancel.isCancelled() || (queue.waiting.front() == ticket && queue.inUse < _limits.*limit);
+    });
+    if (!granted || cancel.isCancelled()) {
+      queue.waiting.erase(std::find(queue.waiting.begin(), queue.waiting.end(), ticket));
+      lock.unlock();
+      // The next waiter may be at the head now
+      _changed.notify_all();
+      return Grant();
+    }
+    queue.waiting.pop_front();
+    queue.inUse++;
+    lock.unlock();
+    // A second free slot is now the next waiter's to take
+    _changed.notify_all();
+    return Grant(this, link);
+  }
+
+  void SessionScheduler::release(bool link) noexcept {
+    {
+      std::lock_guard lock(_mutex);
+      (link ? _links : _turns).inUse--;
+    }
+    _changed.notify_all();
+  }
+
+  size_t SessionScheduler::openLinks() const {
+    std::lock_guard lock(_mutex);
+    return _links.inUse;
+  }
+
+  size_t SessionScheduler::queuedLinks() const {
+    std::lock_guard lock(_mutex);
+    return _links.waiting.size();
+  }
+
+  size_t SessionScheduler::activeTurns() const {
+    std::lock_guard lock(_mutex);
+    return _turns.inUse;
+  }
+
+  size_t SessionScheduler::queuedTurns() const {
+    std::lock_guard lock(_mutex);
+    return _turns.waiting.size();
+  }
+
+  // pragma MARK: Grant
+
+  SessionScheduler::Grant::~Grant() {
+    if (_scheduler != nullptr) {
+      _scheduler->release(_link);
+    }
+  }
+
+  SessionScheduler::Grant::Grant(Grant&& other) noexcept: _scheduler(other._scheduler), _link(other._link) {
+    other._scheduler = nullptr;
+  }
+
+  SessionScheduler::Grant& SessionScheduler::Grant::operator=(Grant&& other) noexcept {
+    if (this != &other) {
+      if (_scheduler != nullptr) {
+        _scheduler->release(_link);
+      }
+      _scheduler = other._scheduler;
+      _link = other._link;
+      other._scheduler = nullptr;
+    }
+    return *this;
+  }
+
+} // namespace espprov
@@ -0,0 +1,111 @@
+///
+/// SessionScheduler.hpp
+/// Shares the phone's BLE connection slots and radio between several open provisioning sessions.
+///
+
+#pragma once
+
+#include "Cancellation.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace espprov {
+
+  struct SessionLimits {
+    /// Links held open at once. Android only allows a handful of concurrent GATT connections.
+    size_t maxLinks = 4;
+    /// Exchanges in flight at once across all linked devices. A blocking Wi-Fi scan holds its
+    /// turn until the device finished scanning.
+    size_t maxExchanges = 2;
+  };
+
+  /**
+   * Schedules several open sessions against the limits of the phone.
+   *
+   * A device holds a link slot from connect until its session closes. Connects beyond
+   * `maxLinks` queue until a slot frees up. Every exchange of a linked device then takes a turn,
+   * at most `maxExchanges` at once. Both queues are first come, first served, and a device only
+   * ever waits for one turn at a time, so handshakes, scans and config pushes of different
+   * devices interleave round robin instead of one device's flow running to completion first.
+   *
+   * Thread safe.
+   */
+  class SessionScheduler {
+  public:
+    explicit SessionScheduler(SessionLimits limits = {});
+
+    SessionScheduler(const SessionScheduler&) = delete;
+    SessionScheduler& operator=(const SessionScheduler&) = delete;
+
+    /**
+     * Takes effect for the next grants. Holders beyond a lowered limit keep what they hold.
+     */
+    void setLimits(SessionLimits limits);
+    SessionLimits limits() const;
+
+    /**
+     * Something granted by the scheduler, given back on destruction.
+     */
+    class Grant {
+    public:
+      Grant() = default;
+      ~Grant();
+      Grant(Grant&& other) noexcept;
+      Grant& operator=(Grant&& other) noexcept;
+      Grant(const Grant&) = delete;
+      Grant& operator=(const Grant&) = delete;
+
+      explicit operator bool() const noexcept {
+        return _scheduler != nullptr;
+      }
+
+    private:
+      friend class SessionScheduler;
+      Grant(SessionScheduler* scheduler, bool link) noexcept: _scheduler(scheduler), _link(link) {}
+
+      SessionScheduler* _scheduler = nullptr;
+      bool _link = false;
+    };
+
+    /**
+     * Waits up to `timeout` for a link slot. Returns an empty grant if none freed up in time or
+     * `cancel` was cancelled first, which also gives up the place in the queue.
+     */
+    Grant acquireLink(std::chrono::milliseconds timeout, const CancellationToken& cancel = {});
+    /**
+     * Waits up to `timeout` for an exchange turn. Returns an empty grant if none freed up in time or
+     * `cancel` was cancelled first.
+     */
+    Grant acquireTurn(std::chrono::milliseconds timeout, const CancellationToken& cancel = {});
+
+    size_t openLinks() const;
+    size_t queuedLinks() const;
+    size_t activeTurns() const;
+    size_t queuedTurns() const;
+
+  private:
+    /**
+     * A first come, first served counting semaphore.
+     */
+    struct Queue {
+      size_t inUse = 0;
+      uint64_t nextTicket = 0;
+      std::deque<uint64_t> waiting;
+    };
+
+    Grant acquire(Queue& queue, const size_t SessionLimits::* limit, bool link, std::chrono::milliseconds timeout,
+                  const CancellationToken& cancel);
+    void release(bool link) noexcept;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _changed;
+    SessionLimits _limits;
+    Queue _links;
+    Queue _turns;
+  };
+
+} // namespace espprov
@@ -0,0 +1,526 @@
+///
+/// Task.hpp
+/// C++20 coroutines for native operations that wait on callbacks.
+///
+
+#pragma once
+
+#include "Cancellation.hpp"
+#include "Errors.hpp"
+#include "Executor.hpp"
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace espprov {
+
+  template <typename T = void>
+  class Task;
+  template <typename T>
+  class CallbackAwaitable;
+
+  namespace detail {
+    /**
+     * What a task runs with. Handed down to every task it awaits, so a whole chain of tasks shares
+     * one executor and one cancellation token.
+     */
+    struct TaskContext {
+      Executor* executor = nullptr;
+      CancellationToken token;
+    };
+
+    /**
+     * The coroutines that can await tasks and callbacks: tasks themselves and the root `spawn` starts.
+     */
+    template <typename Promise>
+    concept HasTaskContext = requires(Promise& promise) {
+      { promise.context() } -> std::same_as<const TaskContext&>;
+    };
+
+    class TaskPromiseBase {
+    public:
+      struct FinalAwaiter {
+        bool await_ready() const noexcept {
+          return false;
+        }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+          // Hands the thread straight to the awaiting task, no job is posted in between
+          std::coroutine_handle<> continuation = handle.promise()._continuation;
+          return continuation ? continuation : std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+      };
+
+      // Lazy, a task runs once awaited or spawned
+      std::suspend_always initial_suspend() const noexcept {
+        return {};
+      }
+      FinalAwaiter final_suspend() const noexcept {
+        return {};
+      }
+      void unhandled_exception() noexcept {
+        _error = std::current_exception();
+      }
+
+      const TaskContext& context() const noexcept {
+        return _context;
+      }
+
+    protected:
+      template <typename>
+      friend struct TaskAwaiter;
+
+      TaskContext _context;
+      std::coroutine_handle<> _continuation;
+      std::exception_ptr _error;
+    };
+
+    template <typename T>
+    class TaskPromise;
+
+    /**
+     * Starts an awaited task on the awaiting task's thread and hands the context down.
+     */
+    template <typename T>
+    struct TaskAwaiter {
+      std::coroutine_handle<TaskPromise<T>> handle;
+
+      bool await_ready() const noexcept {
+        return false;
+      }
+      template <HasTaskContext Parent>
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<Parent> parent) noexcept {
+        handle.promise()._context = parent.promise().context();
+        handle.promise()._continuation = parent;
+        return handle;
+      }
+      T await_resume() {
+        return handle.promise().result();
+      }
+    };
+
+    template <typename T>
+    class TaskPromise final : public TaskPromiseBase {
+    public:
+      Task<T> get_return_object() noexcept;
+
+      template <typename Value>
+      void return_value(Value&& value) {
+        _value.emplace(std::forward<Value>(value));
+      }
+
+      T result() {
+        if (_error) {
+          std::rethrow_exception(_error);
+        }
+        return std::move(*_value);
+      }
+
+    private:
+      std::optional<T> _value;
+    };
+
+    template <>
+    class TaskPromise<void> final : public TaskPromiseBase {
+    public:
+      Task<void> get_return_object() noexcept;
+
+      void return_void() const noexcept {}
+
+      void result() {
+        if (_error) {
+          std::rethrow_exception(_error);
+        }
+      }
+    };
+  } // namespace detail
+
+  /**
+   * A lazily started coroutine producing a `T` or an exception.
+   *
+   * Awaiting a task from another one runs it right away on the same thread, with the awaiting
+   * task's executor and cancellation token, and resumes the awaiting task on the same thread once
+   * it finished. Only a wait on a callback (`awaitCallback`, `sleepFor`) suspends the whole chain,
+   * and the callback resumes it with a single job on the executor. A chain of tasks therefore
+   * costs no thread hops beyond the callbacks it waits for.
+   *
+   * Start the root of a chain with `spawn` or `syncWait`. Move only, and destroys the coroutine
+   * with it.
+   */
+  template <typename T>
+  class [[nodiscard]] Task {
+  public:
+    using promise_type = detail::TaskPromise<T>;
+
+    Task(Task&& other) noexcept: _handle(std::exchange(other._handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+      if (this != &other) {
+        if (_handle) {
+          _handle.destroy();
+        }
+        _handle = std::exchange(other._handle, nullptr);
+      }
+      return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+      if (_handle) {
+        _handle.destroy();
+      }
+    }
+
+    detail::TaskAwaiter<T> operator co_await() && noexcept {
+      return detail::TaskAwaiter<T>{_handle};
+    }
+
+  private:
+    friend class detail::TaskPromise<T>;
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept: _handle(handle) {}
+
+    std::coroutine_handle<promise_type> _handle;
+  };
+
+  namespace detail {
+    template <typename T>
+    Task<T> TaskPromise<T>::get_return_object() noexcept {
+      return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+      return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+    }
+
+    /**
+     * The root coroutine `spawn` starts. Destroys itself when it finished.
+     */
+    struct DetachedTask {
+      struct promise_type {
+        TaskContext _context;
+
+        const TaskContext& context() const noexcept {
+          return _context;
+        }
+        DetachedTask get_return_object() noexcept {
+          return DetachedTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept {
+          return {};
+        }
+        std::suspend_never final_suspend() const noexcept {
+          return {};
+        }
+        void return_void() const noexcept {}
+        // The body catches everything
+        void unhandled_exception() const noexcept {
+          std::terminate();
+        }
+      };
+
+      std::coroutine_handle<promise_type> handle;
+    };
+
+    inline DetachedTask runDetached(Task<void> task, std::function<void(std::exception_ptr)> onDone) {
+      std::exception_ptr error;
+      try {
+        co_await std::move(task);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      if (onDone) {
+        onDone(error);
+      }
+    }
+
+    template <typename T>
+    Task<void> storeResult(Task<T> task, std::shared_ptr<std::optional<T>> result) {
+      result->emplace(co_await std::move(task));
+    }
+
+    struct CurrentTokenAwaiter {
+      CancellationToken token;
+
+      bool await_ready() const noexcept {
+        return false;
+      }
+      template <HasTaskContext Parent>
+      bool await_suspend(std::coroutine_handle<Parent> parent) noexcept {
+        token = parent.promise().context().token;
+        return false;
+      }
+      CancellationToken await_resume() noexcept {
+        return std::move(token);
+      }
+    };
+
+    inline ProtocommError cancelledError(const std::string& what) {
+      return ProtocommError(ErrorCode::OPERATION_CANCELLED, what + " was cancelled");
+    }
+
+    // pragma MARK: Completion
+
+    template <typename T>
+    using CompletionValue = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    /**
+     * Shared by a suspended awaiter and every copy of its `Completer`.
+     */
+    template <typename T>
+    struct CompletionState {
+      // Set by the first settle, every later one is a no-op
+      std::atomic<bool> settled{false};
+      // Set by whichever of the awaiter and the settle comes second, which then resumes the task
+      std::atomic<bool> handedOver{false};
+      std::optional<CompletionValue<T>> value;
+      std::exception_ptr error;
+      std::coroutine_handle<> waiter;
+      Executor* executor = nullptr;
+      CancellationRegistration cancellation;
+
+      std::mutex abandonMutex;
+      bool abandoned = false;
+      std::function<void()> onAbandoned;
+    };
+  } // namespace detail
+
+  /**
+   * Starts `task` on `executor` and returns right away. `onDone` runs on the executor once the task
+   * finished, with the exception that escaped it or null.
+   */
+  inline void spawn(Executor& executor, Task<void> task, CancellationToken token = {},
+                    std::function<void(std::exception_ptr)> onDone = nullptr) {
+    std::coroutine_handle<detail::DetachedTask::promise_type> handle = detail::runDetached(std::move(task), std::move(onDone)).handle;
+    handle.promise()._context = detail::TaskContext{&executor, std::move(token)};
+    executor.post([handle] { handle.resume(); });
+  }
+
+  /**
+   * Runs `task` on `executor` and blocks until it finished, for blocking callers such as the
+   * engine's transports. Must not be called on the executor itself.
+   */
+  template <typename T>
+  T syncWait(Executor& executor, Task<T> task, CancellationToken token = {}) {
+    if (executor.isCurrent()) {
+      throw std::logic_error("syncWait on its own executor would never return");
+    }
+    // Shared with the executor, which still holds them for a moment after waking this thread
+    auto done = std::make_shared<std::promise<void>>();
+    std::future<void> finished = done->get_future();
+    auto onDone = [done](std::exception_ptr error) {
+      if (error) {
+        done->set_exception(error);
+      } else {
+        done->set_value();
+      }
+    };
+    if constexpr (std::is_void_v<T>) {
+      spawn(executor, std::move(task), std::move(token), onDone);
+      finished.get();
+    } else {
+      auto result = std::make_shared<std::optional<T>>();
+      spawn(executor, detail::storeResult(std::move(task), result), std::move(token), onDone);
+      finished.get();
+      return std::move(**result);
+    }
+  }
+
+  /**
+   * The handle a callback settles a suspended task with. Cheap to copy and safe to call from any
+   * thread, any number of times: only the first `resolve` or `reject` counts, later ones return
+   * false and are dropped. A cancellation or timeout of the awaiting task counts as a settle too.
+   */
+  template <typename T = void>
+  class Completer {
+  public:
+    bool resolve()
+      requires std::is_void_v<T>
+    {
+      return settle([](detail::CompletionState<T>& state) { state.value.emplace(); });
+    }
+
+    bool resolve(detail::CompletionValue<T> value)
+      requires(!std::is_void_v<T>)
+    {
+      return settle([&value](detail::CompletionState<T>& state) { state.value.emplace(std::move(value)); });
+    }
+
+    bool reject(std::exception_ptr error) {
+      return settle([&error](detail::CompletionState<T>& state) { state.error = std::move(error); });
+    }
+
+    bool reject(ErrorCode code, const std::string& message) {
+      return reject(std::make_exception_ptr(ProtocommError(code, message)));
+    }
+
+    bool isSettled() const noexcept {
+      return _state->settled.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Runs `hook` if the awaiting task stops waiting before this completer was settled, because
+     * it was cancelled or timed out. Implementations tear down the platform operation there. Runs
+     * right away if that already happened.
+     */
+    void onAbandoned(std::function<void()> hook) const {
+      {
+        std::lock_guard lock(_state->abandonMutex);
+        if (!_state->abandoned) {
+          _state->onAbandoned = std::move(hook);
+          return;
+        }
+      }
+      hook();
+    }
+
+    /**
+     * The executor the awaiting task resumes on, for implementations that need a timer.
+     */
+    Executor& executor() const noexcept {
+      return *_state->executor;
+    }
+
+  private:
+    template <typename>
+    friend class CallbackAwaitable;
+    explicit Completer(std::shared_ptr<detail::CompletionState<T>> state) noexcept: _state(std::move(state)) {}
+
+    template <typename Store>
+    bool settle(Store&& store) {
+      detail::CompletionState<T>& state = *_state;
+      if (state.settled.exchange(true, std::memory_order_acq_rel)) {
+        return false;
+      }
+      store(state);
+      if (state.handedOver.exchange(true, std::memory_order_acq_rel)) {
+        // The awaiter already suspended. Resuming it here could run the task inside whatever
+        // called back, so it resumes on its executor.
+        std::coroutine_handle<> waiter = state.waiter;
+        state.executor->post([waiter] { waiter.resume(); });
+      }
+      return true;
+    }
+
+    /**
+     * Settles with `error` on behalf of the awaiting task, then runs the abandon hook.
+     */
+    void abandon(std::exception_ptr error) {
+      if (!reject(std::move(error))) {
+        return;
+      }
+      std::function<void()> hook;
+      {
+        std::lock_guard lock(_state->abandonMutex);
+        _state->abandoned = true;
+        hook = std::move(_state->onAbandoned);
+      }
+      if (hook) {
+        hook();
+      }
+    }
+
+    std::shared_ptr<detail::CompletionState<T>> _state;
+  };
+
+  /**
+   * Suspends a task until a callback settles its `Completer`. See `awaitCallback`.
+   */
+  template <typename T>
+  class [[nodiscard]] CallbackAwaitable {
+  public:
+    CallbackAwaitable(std::function<void(Completer<T>)> start, std::chrono::milliseconds timeout, ErrorCode timeoutCode, std::string what)
+        : _start(std::move(start)), _timeout(timeout), _timeoutCode(timeoutCode), _what(std::move(what)) {}
+
+    bool await_ready() const noexcept {
+      return false;
+    }
+
+    template <detail::HasTaskContext Parent>
+    bool await_suspend(std::coroutine_handle<Parent> parent) {
+      const detail::TaskContext& context = parent.promise().context();
+      _state = std::make_shared<detail::CompletionState<T>>();
+      _state->waiter = parent;
+      _state->executor = context.executor;
+      Completer<T> completer(_state);
+
+      if (context.token.isCancelled()) {
+        completer.reject(std::make_exception_ptr(detail::cancelledError(_what)));
+      } else {
+        _state->cancellation = context.token.onCancel(
+            [completer, what = _what]() mutable { completer.abandon(std::make_exception_ptr(detail::cancelledError(what))); });
+        if (_timeout.count() > 0) {
+          context.executor->postAfter(_timeout, [completer, code = _timeoutCode, what = _what]() mutable {
+            completer.abandon(std::make_exception_ptr(ProtocommError(code, what + " timed out")));
+          });
+        }
+        try {
+          _start(completer);
+        } catch (...) {
+          completer.reject(std::current_exception());
+        }
+      }
+      // Settled while starting, e.g. by a cached reply: carry on without suspending
+      return !_state->handedOver.exchange(true, std::memory_order_acq_rel);
+    }
+
+    T await_resume() {
+      _state->cancellation.reset();
+      if (_state->error) {
+        std::rethrow_exception(_state->error);
+      }
+      if constexpr (!std::is_void_v<T>) {
+        return std::move(*_state->value);
+      }
+    }
+
+  private:
+    std::function<void(Completer<T>)> _start;
+    std::chrono::milliseconds _timeout;
+    ErrorCode _timeoutCode;
+    std::string _what;
+    std::shared_ptr<detail::CompletionState<T>> _state;
+  };
+
+  /**
+   * Calls `start` with a `Completer` and suspends the task until it is settled, the task's token
+   * is cancelled (`OPERATION_CANCELLED`) or `timeout` ran out (`timeoutCode`). A zero `timeout`
+   * waits without a limit. `what` names the operation in those errors.
+   *
+   * This is the one place a platform callback turns into a value, so the resume-once bookkeeping
+   * every callback wrapper needs lives here.
+   */
+  template <typename T = void>
+  CallbackAwaitable<T> awaitCallback(std::function<void(Completer<T>)> start, std::chrono::milliseconds timeout, ErrorCode timeoutCode,
+                                     std::string what) {
+    return CallbackAwaitable<T>(std::move(start), timeout, timeoutCode, std::move(what));
+  }
+
+  /**
+   * Suspends the task for `delay` without holding a thread. Throws `OPERATION_CANCELLED` as soon
+   * as the task's token is cancelled.
+   */
+  inline CallbackAwaitable<void> sleepFor(std::chrono::milliseconds delay) {
+    return awaitCallback<void>([delay](Completer<void> done) { done.executor().postAfter(delay, [done]() mutable { done.resolve(); }); },
+                               std::chrono::milliseconds(0), ErrorCode::PROV_TIMED_OUT_ERROR, "Sleep");
+  }
+
+  /**
+   * `co_await currentCancellationToken()` gives the token of the running task.
+   */
+  inline detail::CurrentTokenAwaiter currentCancellationToken() noexcept {
+    return {};
+  }
+
+} // namespace espprov
@@ -0,0 +1,54 @@
+///
+/// Timeouts.hpp
+/// The single set of timeouts used by every native protocomm operation.
+///
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace espprov {
+
+  using namespace std::chrono_literals;
+
+  /**
+   * When the Wi-Fi status is polled after the config was applied. A device usually joins within
+   * a few seconds, so the first polls come quickly and later ones back off.
+   */
+  struct StatusPollSchedule {
+    /// Delay between applying the config and the first poll.
+    std::chrono::milliseconds first = 100ms;
+    /// Factor from one delay to the next, 1 for a fixed interval.
+    double backoff = 2.0;
+    /// Longest delay between two polls.
+    std::chrono::milliseconds max = 500ms;
+    /// Until the device has to report that it joined or failed.
+    std::chrono::milliseconds deadline = 30000ms;
+
+    /**
+     * The delay after `delay`, for the next poll. Grows from at least 1 ms, so a zero `first`
+     * polls right away once and then backs off.
+     */
+    std::chrono::milliseconds next(std::chrono::milliseconds delay) const noexcept {
+      double grown = std::ceil(static_cast<double>(std::max<std::chrono::milliseconds::rep>(delay.count(), 1)) * std::max(backoff, 1.0));
+      return std::min(std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(grown)), std::max(max, first));
+    }
+  };
+
+  struct Timeouts {
+    /// Opening the transport link (BLE connect, TCP connect).
+    std::chrono::milliseconds connect = 15000ms;
+    /// A single protocomm request/response round trip.
+    std::chrono::milliseconds request = 5000ms;
+    /// A blocking Wi-Fi scan on the device, which takes a few seconds on its own.
+    std::chrono::milliseconds scan = 15000ms;
+    /// Waiting for the device to join the Wi-Fi network after the config was applied. The initial
+    /// schedule, `ProtocommEngine::setStatusPollSchedule` replaces it.
+    StatusPollSchedule statusPoll;
+    /// Waiting for a BLE link slot or exchange turn while other sessions hold them all.
+    std::chrono::milliseconds schedulerWait = 120000ms;
+  };
+
+} // namespace espprov
@@ -0,0 +1,224 @@
+///
+/// Tracer.cpp
+/// An opt-in, lock free in-memory trace of native and bridge events, exported as Chrome trace JSON.
+///
+
+#include "Tracer.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+namespace espprov {
+
+  namespace {
+    constexpr std::array<const char*, TRACE_CATEGORY_COUNT> CATEGORY_NAMES = {
+        "bridge", "dispatch", "transport", "crypto", "state", "device", "phase",
+    };
+
+    std::atomic<uint32_t> nextThreadId{1};
+    thread_local uint32_t threadId = 0;
+    thread_local bool threadNamed = false;
+
+    uint32_t currentThreadId() noexcept {
+      if (threadId == 0) {
+        threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+      }
+      return threadId;
+    }
+
+    template <size_t N>
+    void copyTruncated(std::array<char, N>& target, std::string_view source) noexcept {
+      size_t length = std::min(source.size(), N - 1);
+      std::copy_n(source.data(), length, target.data());
+      target[length] = '\0';
+    }
+
+    static_assert(std::is_trivially_copyable_v<TraceEvent>);
+
+    template <size_t N>
+    void storeEvent(std::array<std::atomic<uint64_t>, N>& words, const TraceEvent& event) noexcept {
+      uint64_t buffer[N] = {};
+      std::memcpy(buffer, &event, sizeof(TraceEvent));
+      for (size_t i = 0; i < N; i++) {
+        words[i].store(buffer[i], std::memory_order_relaxed);
+      }
+    }
+
+    template <size_t N>
+    TraceEvent loadEvent(const std::array<std::atomic<uint64_t>, N>& words) noexcept {
+      uint64_t buffer[N];
+      for (size_t i = 0; i < N; i++) {
+        buffer[i] = words[i].load(std::memory_order_relaxed);
+      }
+      TraceEvent event;
+      std::memcpy(&event, buffer, sizeof(TraceEvent));
+      return event;
+    }
+
+    void appendEscaped(std::string& out, std::string_view text) {
+      for (char c : text) {
+        switch (c) {
+          case '"':
+            out += "\\\"";
+            break;
+          case '\\':
+            out += "\\\\";
+            break;
+          default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+              char escaped[8];
+              std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+              out += escaped;
+            } else {
+              out += c;
+            }
+        }
+      }
+    }
+
+    /**
+     * Microseconds with nanosecond precision, the unit of `ts` and `dur`.
+     */
+    void appendMicros(std::string& out, std::chrono::nanoseconds duration) {
+      char number[32];
+      std::snprintf(number, sizeof(number), "%lld.%03lld", static_cast<long long>(duration.count() / 1000),
+                    static_cast<long long>(duration.count() % 1000));
+      out += number;
+    }
+  } // namespace
+
+  Tracer& Tracer::shared() {
+    static Tracer tracer;
+    return tracer;
+  }
+
+  void Tracer::start() {
+    std::lock_guard lock(_mutex);
+    if (!_slots) {
+      _slots = std::make_unique<Slot[]>(CAPACITY);
+    }
+    _firstTicket = _cursor.load(std::memory_order_relaxed);
+    _origin = std::chrono::steady_clock::now();
+    _wallOrigin = std::chrono::system_clock::now();
+    // Publishes the ring to the threads that see the tracer enabled
+    _enabled.store(true, std::memory_order_release);
+  }
+
+  void Tracer::stop() noexcept {
+    _enabled.store(false, std::memory_order_relaxed);
+  }
+
+  void Tracer::complete(TraceCategory category, std::string_view name, std::string_view detail,
+                        std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) noexcept {
+    record(category, name, detail, start, std::max<std::chrono::nanoseconds>(end - start, std::chrono::nanoseconds(0)));
+  }
+
+  void Tracer::instant(TraceCategory category, std::string_view name, std::string_view detail) noexcept {
+    if (enabled()) {
+      record(category, name, detail, std::chrono::steady_clock::now(), std::chrono::nanoseconds(-1));
+    }
+  }
+
+  void Tracer::record(TraceCategory category, std::string_view name, std::string_view detail,
+                      std::chrono::steady_clock::time_point start, std::chrono::nanoseconds duration) noexcept {
+    if (!_enabled.load(std::memory_order_acquire)) {
+      return;
+    }
+    // Zeroed, so the bytes past the names and the padding are defined too
+    TraceEvent event{};
+    event.start = start;
+    event.duration = duration;
+    event.thread = currentThreadId();
+    event.category = category;
+    copyTruncated(event.name, name);
+    copyTruncated(event.detail, detail);
+
+    uint64_t ticket = _cursor.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = _slots[ticket % CAPACITY];
+    // A sequence lock: readers that see zero or a changed sequence drop their copy
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    storeEvent(slot.words, event);
+    slot.sequence.store(ticket + 1, std::memory_order_release);
+  }
+
+  void Tracer::nameThread(std::string_view name) {
+    uint32_t id = currentThreadId();
+    threadNamed = true;
+    std::lock_guard lock(_mutex);
+    auto it = std::find_if(_threadNames.begin(), _threadNames.end(), [id](const auto& entry) { return entry.first == id; });
+    if (it != _threadNames.end()) {
+      it->second = name;
+    } else {
+      _threadNames.emplace_back(id, std::string(name));
+    }
+  }
+
+  bool Tracer::isThreadNamed() noexcept {
+    return threadNamed;
+  }
+
+  std::string Tracer::exportChromeJson() const {
+    std::lock_guard lock(_mutex);
+    std::vector<TraceEvent> events;
+    uint64_t end = _cursor.load(std::memory_order_acquire);
+    uint64_t first = std::max(_firstTicket, end > CAPACITY ? end - CAPACITY : 0);
+    if (_slots) {
+      events.reserve(end - first);
+      for (uint64_t ticket = first; ticket < end; ticket++) {
+        const Slot& slot = _slots[ticket % CAPACITY];
+        if (slot.sequence.load(std::memory_order_acquire) != ticket + 1) {
+          continue;
+        }
+        TraceEvent event = loadEvent(slot.words);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == ticket + 1 && event.start >= _origin) {
+          events.push_back(event);
+        }
+      }
+    }
+    // Spans are recorded when they end, so recording order is not start order
+    std::stable_sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b) { return a.start < b.start; });
+
+    std::string out;
+    out.reserve(160 * (events.size() + _threadNames.size() + 1));
+    out += R"({"traceEvents":[{"name":"process_name","ph":"M","pid":1,"tid":0,"args":{"name":"EspProvToolkit"}})";
+    for (const auto& [id, name] : _threadNames) {
+      out += R"(,{"name":"thread_name","ph":"M","pid":1,"tid":)";
+      out += std::to_string(id);
+      out += R"(,"args":{"name":")";
+      appendEscaped(out, name);
+      out += "\"}}";
+    }
+    for (const TraceEvent& event : events) {
+      bool instant = event.duration.count() < 0;
+      out += R"(,{"name":")";
+      appendEscaped(out, event.name.data());
+      out += R"(","cat":")";
+      out += CATEGORY_NAMES[static_cast<size_t>(event.category)];
+      out += instant ? R"(","ph":"i","s":"t","ts":)" : R"(","ph":"X","ts":)";
+      appendMicros(out, event.start - _origin);
+      if (!instant) {
+        out += R"(,"dur":)";
+        appendMicros(out, event.duration);
+      }
+      out += R"(,"pid":1,"tid":)";
+      out += std::to_string(event.thread);
+      if (event.detail[0] != '\0') {
+        out += R"(,"args":{"detail":")";
+        appendEscaped(out, event.detail.data());
+        out += "\"}";
+      }
+      out += '}';
+    }
+    uint64_t recorded = end - _firstTicket;
+    out += R"(],"displayTimeUnit":"ms","otherData":{"startedAtMs":")";
+    out += std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(_wallOrigin.time_since_epoch()).count());
+    out += R"(","overwritten":")";
+    out += std::to_string(recorded > CAPACITY ? recorded - CAPACITY : 0);
+    out += "\"}}";
+    return out;
+  }
+
+} // namespace espprov
@@ -0,0 +1,159 @@
+///
+/// Tracer.hpp
+/// An opt-in, lock free in-memory trace of native and bridge events, exported as Chrome trace JSON.
+///
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace espprov {
+
+  enum class TraceCategory : uint8_t {
+    /// A JS call into the engine, from the call to the promise resolving.
+    BRIDGE = 0,
+    /// Work hopping to or running on the platform's main thread.
+    DISPATCH = 1,
+    /// A request and its response on the transport.
+    TRANSPORT = 2,
+    /// Key agreement, encryption and decryption.
+    CRYPTO = 3,
+    /// A connection state change.
+    STATE = 4,
+    /// Waiting on the device, or for a turn to talk to it.
+    DEVICE = 5,
+    /// A provisioning phase, as in `RunTimings`.
+    PHASE = 6,
+  };
+
+  inline constexpr size_t TRACE_CATEGORY_COUNT = 7;
+
+  /// Trivially copyable, the tracer keeps it as raw words.
+  struct TraceEvent {
+    static constexpr size_t NAME_SIZE = 40;
+    static constexpr size_t DETAIL_SIZE = 48;
+
+    std::chrono::steady_clock::time_point start;
+    /// Negative for an instant event.
+    std::chrono::nanoseconds duration;
+    uint32_t thread;
+    TraceCategory category;
+    /// Zero terminated, truncated to fit.
+    std::array<char, NAME_SIZE> name;
+    std::array<char, DETAIL_SIZE> detail;
+  };
+
+  /**
+   * Collects trace events while started and exports them in the Chrome trace event format, which
+   * Perfetto and chrome://tracing open.
+   *
+   * Events go into a ring of `CAPACITY` fixed size slots, so a long run keeps its most recent
+   * events. Recording claims a slot with one atomic increment and never takes a lock or allocates.
+   * While stopped, recording is a single relaxed load. Exporting copies each slot under a sequence
+   * check and skips slots that are overwritten meanwhile, so it may run while events come in.
+   *
+   * Thread safe.
+   */
+  class Tracer {
+  public:
+    static constexpr size_t CAPACITY = 1 << 14;
+
+    Tracer() = default;
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    static Tracer& shared();
+
+    /**
+     * Drops the events recorded so far and starts recording. The ring is allocated on the first
+     * start and kept afterwards.
+     */
+    void start();
+    void stop() noexcept;
+    bool enabled() const noexcept {
+      return _enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Records a span that ran on the calling thread. The steady clock is the platform's monotonic
+     * clock, `System.nanoTime()` on Android.
+     */
+    void complete(TraceCategory category, std::string_view name, std::string_view detail,
+                  std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) noexcept;
+    void instant(TraceCategory category, std::string_view name, std::string_view detail = {}) noexcept;
+
+    /**
+     * Names the calling thread in exported traces. Threads that are never named show as `thread N`.
+     */
+    void nameThread(std::string_view name);
+    static bool isThreadNamed() noexcept;
+
+    /**
+     * The events recorded since the last start, oldest first, as a Chrome trace JSON object.
+     */
+    std::string exportChromeJson() const;
+
+  private:
+    struct Slot {
+      static constexpr size_t WORDS = (sizeof(TraceEvent) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+      /// The ticket of the event in the slot plus one, zero while it is being written.
+      std::atomic<uint64_t> sequence{0};
+      /// The event, stored and loaded a relaxed word at a time, so an export racing a writer reads
+      /// a torn copy it then drops rather than racing on plain memory.
+      std::array<std::atomic<uint64_t>, WORDS> words{};
+    };
+
+    void record(TraceCategory category, std::string_view name, std::string_view detail,
+                std::chrono::steady_clock::time_point start, std::chrono::nanoseconds duration) noexcept;
+
+  private:
+    std::atomic<bool> _enabled{false};
+    std::atomic<uint64_t> _cursor{0};
+    std::unique_ptr<Slot[]> _slots;
+    /// Tickets at or below it belong to an earlier start.
+    uint64_t _firstTicket = 0;
+    std::chrono::steady_clock::time_point _origin;
+    std::chrono::system_clock::time_point _wallOrigin;
+    mutable std::mutex _mutex;
+    std::vector<std::pair<uint32_t, std::string>> _threadNames;
+  };
+
+  /**
+   * Traces a span from construction to destruction on the calling thread. Does nothing while the
+   * tracer is stopped. `name` and `detail` must outlive the span.
+   */
+  class TraceSpan {
+  public:
+    TraceSpan(TraceCategory category, std::string_view name, std::string_view detail = {}) noexcept
+        : _category(category), _name(name), _detail(detail) {
+      if (Tracer::shared().enabled()) {
+        _start = std::chrono::steady_clock::now();
+      }
+    }
+    ~TraceSpan() {
+      if (_start.time_since_epoch().count() != 0) {
+        Tracer::shared().complete(_category, _name, _detail, _start, std::chrono::steady_clock::now());
+      }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+  private:
+    TraceCategory _category;
+    std::string_view _name;
+    std::string_view _detail;
+    std::chrono::steady_clock::time_point _start{};
+  };
+
+} // namespace espprov
@@ -0,0 +1,53 @@
+///
+/// Transport.hpp
+/// The raw byte pipe every platform has to provide to the native protocomm engine.
+///
+
+#pragma once
+
+#include "Bytes.hpp"
+#include <chrono>
+#include <string_view>
+
+namespace espprov {
+
+  /**
+   * A raw, unencrypted request/response channel to a single ESP device.
+   *
+   * Platforms only implement this interface (BLE GATT on the phone, HTTP for SoftAP, a fake in
+   * host builds). Security, protobuf and the provisioning protocol all live in the engine.
+   * Implementations may block; the engine only calls them from worker threads.
+   */
+  class Transport {
+  public:
+    virtual ~Transport() = default;
+
+    /**
+     * Opens the underlying link. Calling it on an already connected transport is a no-op.
+     * Throws `ProtocommError` if the link could not be opened within `timeout`.
+     */
+    virtual void connect(std::chrono::milliseconds timeout) = 0;
+
+    /**
+     * Sends `payload` to the protocomm `endpoint` (e.g. `prov-session`) and returns the raw reply.
+     * Throws `ProtocommError` on failure or if no reply arrived within `timeout`.
+     */
+    virtual Bytes exchange(std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout) = 0;
+
+    /**
+     * Closes the link. Must be safe to call at any time, including on a closed transport.
+     */
+    virtual void disconnect() noexcept = 0;
+
+    /**
+     * Makes the call blocked in `connect()` or `exchange()` and every later one fail with
+     * `ProtocommError(OPERATION_CANCELLED)` as soon as possible. The only method that may be called
+     * from another thread while one of the others runs. The transport is dead afterwards, only
+     * `disconnect()` and destruction remain. Transports that can not interrupt a call finish it.
+     */
+    virtual void abort() noexcept {}
+
+    virtual bool isConnected() const noexcept = 0;
+  };
+
+} // namespace espprov
@@ -0,0 +1,52 @@
+///
+/// WifiScanCache.cpp
+/// The Wi-Fi networks a device last reported, kept for a while so repeated scans skip the radio.
+///
+
+#include "WifiScanCache.hpp"
+#include <string_view>
+#include <unordered_map>
+
+namespace espprov {
+
+  std::optional<std::vector<WifiNetwork>> WifiScanCache::lookup(Clock::time_point now, std::chrono::milliseconds ttl) const {
+    std::lock_guard lock(_mutex);
+    if (!_networks.has_value() || now - _scannedAt > ttl) {
+      return std::nullopt;
+    }
+    return _networks;
+  }
+
+  void WifiScanCache::store(std::vector<WifiNetwork> networks, Clock::time_point now) {
+    std::lock_guard lock(_mutex);
+    _networks = std::move(networks);
+    _scannedAt = now;
+  }
+
+  void WifiScanCache::clear() noexcept {
+    std::lock_guard lock(_mutex);
+    _networks.reset();
+  }
+
+  std::vector<WifiNetwork> WifiScanCache::mergeByBssid(std::vector<WifiNetwork> networks) {
+    std::vector<WifiNetwork> merged;
+    merged.reserve(networks.size());
+    std::unordered_map<std::string_view, size_t> indexByBssid;
+    indexByBssid.reserve(networks.size());
+    for (WifiNetwork& network : networks) {
+      if (network.bssid.empty()) {
+        merged.push_back(std::move(network));
+        continue;
+      }
+      // The keys point into `networks`, whose strings are not touched until the end
+      auto [it, inserted] = indexByBssid.try_emplace(network.bssid, merged.size());
+      if (inserted) {
+        merged.push_back(network);
+      } else if (network.rssi > merged[it->second].rssi) {
+        merged[it->second] = network;
+      }
+    }
+    return merged;
+  }
+
+} // namespace espprov
@@ -0,0 +1,57 @@
+///
+/// WifiScanCache.hpp
+/// The Wi-Fi networks a device last reported, kept for a while so repeated scans skip the radio.
+///
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace espprov {
+
+  /**
+   * One access point reported by the device, shaped like `PTWifiEntry`.
+   */
+  struct WifiNetwork {
+    std::string ssid;
+    /// Lower case hex, without separators.
+    std::string bssid;
+    uint32_t channel = 0;
+    int32_t rssi = 0;
+    uint32_t auth = 0;
+  };
+
+  /**
+   * Keeps the result of a device's last complete Wi-Fi scan. It has its own lock, so a lookup
+   * answers right away even while a provisioning call holds the device.
+   */
+  class WifiScanCache {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Returns the cached networks if they are not older than `ttl`.
+     */
+    std::optional<std::vector<WifiNetwork>> lookup(Clock::time_point now, std::chrono::milliseconds ttl) const;
+
+    void store(std::vector<WifiNetwork> networks, Clock::time_point now);
+    void clear() noexcept;
+
+    /**
+     * Keeps one entry per BSSID, the one with the strongest RSSI, in the order the BSSIDs were first
+     * reported. Entries without a BSSID are kept as they are.
+     */
+    static std::vector<WifiNetwork> mergeByBssid(std::vector<WifiNetwork> networks);
+
+  private:
+    mutable std::mutex _mutex;
+    std::optional<std::vector<WifiNetwork>> _networks;
+    Clock::time_point _scannedAt;
+  };
+
+} // namespace espprov
@@ -0,0 +1,69 @@
+///
+/// WifiScanColumns.cpp
+/// Scan results as parallel columns in one buffer, which crosses to JS as a single ArrayBuffer.
+///
+
+#include "WifiScanColumns.hpp"
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+namespace espprov {
+
+  namespace {
+    /// Parses the lower case hex BSSID of a `WifiNetwork`, which is 6 bytes when the device sent one.
+    std::optional<uint64_t> parseBssid(std::string_view hex) noexcept {
+      if (hex.size() != 12) {
+        return std::nullopt;
+      }
+      uint64_t value = 0;
+      for (char digit : hex) {
+        uint64_t nibble;
+        if (digit >= '0' && digit <= '9') {
+          nibble = static_cast<uint64_t>(digit - '0');
+        } else if (digit >= 'a' && digit <= 'f') {
+          nibble = static_cast<uint64_t>(digit - 'a' + 10);
+        } else {
+          return std::nullopt;
+        }
+        value = (value << 4) | nibble;
+      }
+      return value;
+    }
+
+    template <typename T>
+    void store(Bytes& buffer, size_t offset, T value) noexcept {
+      std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+  } // namespace
+
+  Bytes encodeWifiScanColumns(const std::vector<WifiNetwork>& networks) {
+    size_t count = networks.size();
+    size_t ssidBytes = 0;
+    for (const WifiNetwork& network : networks) {
+      ssidBytes += network.ssid.size();
+    }
+    WifiScanColumnLayout layout = WifiScanColumnLayout::forCount(count);
+    Bytes buffer(layout.ssids + ssidBytes);
+
+    uint32_t ssidOffset = 0;
+    for (size_t i = 0; i < count; i++) {
+      const WifiNetwork& network = networks[i];
+      // 48-bit integers are exact in a double, which JS reads without BigInt
+      std::optional<uint64_t> bssid = parseBssid(network.bssid);
+      store<double>(buffer, layout.bssid + i * sizeof(double), bssid.has_value() ? static_cast<double>(*bssid) : -1.0);
+      store<uint32_t>(buffer, layout.ssidOffsets + i * sizeof(uint32_t), ssidOffset);
+      store<uint16_t>(buffer, layout.channel + i * sizeof(uint16_t), static_cast<uint16_t>(std::min<uint32_t>(network.channel, UINT16_MAX)));
+      store<int8_t>(buffer, layout.rssi + i, static_cast<int8_t>(std::clamp<int32_t>(network.rssi, INT8_MIN, INT8_MAX)));
+      store<uint8_t>(buffer, layout.auth + i, static_cast<uint8_t>(std::min<uint32_t>(network.auth, UINT8_MAX)));
+      if (!network.ssid.empty()) {
+        std::memcpy(buffer.data() + layout.ssids + ssidOffset, network.ssid.data(), network.ssid.size());
+      }
+      ssidOffset += static_cast<uint32_t>(network.ssid.size());
+    }
+    store<uint32_t>(buffer, layout.ssidOffsets + count * sizeof(uint32_t), ssidOffset);
+    return buffer;
+  }
+
+} // namespace espprov
@@ -0,0 +1,51 @@
+///
+/// WifiScanColumns.hpp
+/// Scan results as parallel columns in one buffer, which crosses to JS as a single ArrayBuffer.
+///
+
+#pragma once
+
+#include "Bytes.hpp"
+#include "WifiScanCache.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace espprov {
+
+  /**
+   * The column layout of `encodeWifiScanColumns` for `count` networks. Columns follow each other in
+   * this order, each one naturally aligned, in host byte order like JS typed arrays:
+   *
+   *   float64 bssid[count]            the 48-bit BSSID as an integer, -1 if the device sent none
+   *   uint32  ssidOffsets[count + 1]  byte range of network i in `ssids` is [offsets[i], offsets[i + 1])
+   *   uint16  channel[count]
+   *   int8    rssi[count]
+   *   uint8   auth[count]
+   *   uint8   ssids[]                 UTF-8, concatenated
+   */
+  struct WifiScanColumnLayout {
+    size_t bssid;
+    size_t ssidOffsets;
+    size_t channel;
+    size_t rssi;
+    size_t auth;
+    size_t ssids;
+
+    static constexpr WifiScanColumnLayout forCount(size_t count) noexcept {
+      WifiScanColumnLayout layout{};
+      layout.bssid = 0;
+      layout.ssidOffsets = layout.bssid + count * sizeof(double);
+      layout.channel = layout.ssidOffsets + (count + 1) * sizeof(uint32_t);
+      layout.rssi = layout.channel + count * sizeof(uint16_t);
+      layout.auth = layout.rssi + count * sizeof(int8_t);
+      layout.ssids = layout.auth + count * sizeof(uint8_t);
+      return layout;
+    }
+  };
+
+  /**
+   * Packs `networks` into the columns described by `WifiScanColumnLayout` with a single allocation.
+   */
+  Bytes encodeWifiScanColumns(const std::vector<WifiNetwork>& networks);
+
+} // namespace espprov
@@ -0,0 +1,466 @@
+///
+/// Aes256.cpp
+/// The AES-256 block cipher, forward direction only: every mode protocomm uses is counter based.
+///
+
+#include "Aes256.hpp"
+#include "SecureWipe.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ESPPROV_AES_NI 1
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#endif
+
+// arm64 builds enable the Crypto Extensions for this file, see CMakeLists.txt; Apple's arm64 targets always have them
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO))
+#define ESPPROV_ARMV8_CE 1
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+#endif
+
+namespace espprov::crypto {
+
+  namespace {
+    using Block = Aes256::Block;
+    constexpr size_t BLOCK_SIZE = Aes256::BLOCK_SIZE;
+    constexpr size_t ROUNDS = Aes256::ROUNDS;
+
+    constexpr std::array<uint8_t, 7> RCON = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40};
+
+    // pragma MARK: Portable
+
+    /// The Boyar-Peralta S-box circuit over bit planes: q[k] holds bit k of 32 bytes.
+    void sbox(uint32_t* q) noexcept {
+      uint32_t x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4], x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
+
+      // Top linear transformation
+      uint32_t y14 = x3 ^ x5;
+      uint32_t y13 = x0 ^ x6;
+      uint32_t y9 = x0 ^ x3;
+      uint32_t y8 = x0 ^ x5;
+      uint32_t t0 = x1 ^ x2;
+      uint32_t y1 = t0 ^ x7;
+      uint32_t y4 = y1 ^ x3;
+      uint32_t y12 = y13 ^ y14;
+      uint32_t y2 = y1 ^ x0;
+      uint32_t y5 = y1 ^ x6;
+      uint32_t y3 = y5 ^ y8;
+      uint32_t t1 = x4 ^ y12;
+      uint32_t y15 = t1 ^ x5;
+      uint32_t y20 = t1 ^ x1;
+      uint32_t y6 = y15 ^ x7;
+      uint32_t y10 = y15 ^ t0;
+      uint32_t y11 = y20 ^ y9;
+      uint32_t y7 = x7 ^ y11;
+      uint32_t y17 = y10 ^ y11;
+      uint32_t y19 = y10 ^ y8;
+      uint32_t y16 = t0 ^ y11;
+      uint32_t y21 = y13 ^ y16;
+      uint32_t y18 = x0 ^ y16;
+
+      // Non-linear section
+      uint32_t t2 = y12 & y15;
+      uint32_t t3 = y3 & y6;
+      uint32_t t4 = t3 ^ t2;
+      uint32_t t5 = y4 & x7;
+      uint32_t t6 = t5 ^ t2;
+      uint32_t t7 = y13 & y16;
+      uint32_t t8 = y5 & y1;
+      uint32_t t9 = t8 ^ t7;
+      uint32_t t10 = y2 & y7;
+      uint32_t t11 = t10 ^ t7;
+      uint32_t t12 = y9 & y11;
+      uint32_t t13 = y14 & y17;
+      uint32_t t14 = t13 ^ t12;
+      uint32_t t15 = y8 & y10;
+      uint32_t t16 = t15 ^ t12;
+      uint32_t t17 = t4 ^ t14;
+      uint32_t t18 = t6 ^ t16;
+      uint32_t t19 = t9 ^ t14;
+      uint32_t t20 = t11 ^ t16;
+      uint32_t t21 = t17 ^ y20;
+      uint32_t t22 = t18 ^ y19;
+      uint32_t t23 = t19 ^ y21;
+      uint32_t t24 = t20 ^ y18;
+
+      uint32_t t25 = t21 ^ t22;
+      uint32_t t26 = t21 & t23;
+      uint32_t t27 = t24 ^ t26;
+      uint32_t t28 = t25 & t27;
+      uint32_t t29 = t28 ^ t22;
+      uint32_t t30 = t23 ^ t24;
+      uint32_t t31 = t22 ^ t26;
+      uint32_t t32 = t31 & t30;
+      uint32_t t33 = t32 ^ t24;
+      uint32_t t34 = t23 ^ t33;
+      uint32_t t35 = t27 ^ t33;
+      uint32_t t36 = t24 & t35;
+      uint32_t t37 = t36 ^ t34;
+      uint32_t t38 = t27 ^ t36;
+      uint32_t t39 = t29 & t38;
+      uint32_t t40 = t25 ^ t39;
+
+      uint32_t t41 = t40 ^ t37;
+      uint32_t t42 = t29 ^ t33;
+      uint32_t t43 = t29 ^ t40;
+      uint32_t t44 = t33 ^ t37;
+      uint32_t t45 = t42 ^ t41;
+      uint32_t z0 = t44 & y15;
+      uint32_t z1 = t37 & y6;
+      uint32_t z2 = t33 & x7;
+      uint32_t z3 = t43 & y16;
+      uint32_t z4 = t40 & y1;
+      uint32_t z5 = t29 & y7;
+      uint32_t z6 = t42 & y11;
+      uint32_t z7 = t45 & y17;
+      uint32_t z8 = t41 & y10;
+      uint32_t z9 = t44 & y12;
+      uint32_t z10 = t37 & y3;
+      uint32_t z11 = t33 & y4;
+      uint32_t z12 = t43 & y13;
+      uint32_t z13 = t40 & y5;
+      uint32_t z14 = t29 & y2;
+      uint32_t z15 = t42 & y9;
+      uint32_t z16 = t45 & y14;
+      uint32_t z17 = t41 & y8;
+
+      // Bottom linear transformation
+      uint32_t t46 = z15 ^ z16;
+      uint32_t t47 = z10 ^ z11;
+      uint32_t t48 = z5 ^ z13;
+      uint32_t t49 = z9 ^ z10;
+      uint32_t t50 = z2 ^ z12;
+      uint32_t t51 = z2 ^ z5;
+      uint32_t t52 = z7 ^ z8;
+      uint32_t t53 = z0 ^ z3;
+      uint32_t t54 = z6 ^ z7;
+      uint32_t t55 = z16 ^ z17;
+      uint32_t t56 = z12 ^ t48;
+      uint32_t t57 = t50 ^ t53;
+      uint32_t t58 = z4 ^ t46;
+      uint32_t t59 = z3 ^ t54;
+      uint32_t t60 = t46 ^ t57;
+      uint32_t t61 = z14 ^ t57;
+      uint32_t t62 = t52 ^ t58;
+      uint32_t t63 = t49 ^ t58;
+      uint32_t t64 = z4 ^ t59;
+      uint32_t t65 = t61 ^ t62;
+      uint32_t t66 = z1 ^ t63;
+      uint32_t s0 = t59 ^ t63;
+      uint32_t s6 = t56 ^ ~t62;
+      uint32_t s7 = t48 ^ ~t60;
+      uint32_t t67 = t64 ^ t65;
+      uint32_t s3 = t53 ^ t66;
+      uint32_t s4 = t51 ^ t66;
+      uint32_t s5 = t47 ^ t65;
+      uint32_t s1 = t64 ^ ~s3;
+      uint32_t s2 = t55 ^ ~t67;
+
+      q[7] = s0;
+      q[6] = s1;
+      q[5] = s2;
+      q[4] = s3;
+      q[3] = s4;
+      q[2] = s5;
+      q[1] = s6;
+      q[0] = s7;
+    }
+
+    /// Transposes an 8x8 bit matrix held as 8 bytes: bit k of byte i becomes bit i of byte k.
+    inline uint64_t transpose(uint64_t x) noexcept {
+      uint64_t t = (x ^ (x >> 7)) & 0x00aa00aa00aa00aaULL;
+      x ^= t ^ (t << 7);
+      t = (x ^ (x >> 14)) & 0x0000cccc0000ccccULL;
+      x ^= t ^ (t << 14);
+      t = (x ^ (x >> 28)) & 0x00000000f0f0f0f0ULL;
+      x ^= t ^ (t << 28);
+      return x;
+    }
+
+    /// SubBytes on 32 bytes at once: transposed into 8 bit planes, pushed through the circuit, and back.
+    void subBytes(uint8_t* bytes) noexcept {
+      uint64_t rows[4];
+      for (size_t g = 0; g < 4; g++) {
+        uint64_t row = 0;
+        for (size_t i = 0; i < 8; i++) {
+          row |= static_cast<uint64_t>(bytes[g * 8 + i]) << (8 * i);
+        }
+        rows[g] = transpose(row);
+      }
+      uint32_t planes[8];
+      for (size_t k = 0; k < 8; k++) {
+        planes[k] = 0;
+        for (size_t g = 0; g < 4; g++) {
+          planes[k] |= static_cast<uint32_t>((rows[g] >> (8 * k)) & 0xff) << (8 * g);
+        }
+      }
+      sbox(planes);
+      for (size_t g = 0; g < 4; g++) {
+        uint64_t row = 0;
+        for (size_t k = 0; k < 8; k++) {
+          row |= static_cast<uint64_t>((planes[k] >> (8 * g)) & 0xff) << (8 * k);
+        }
+        row = transpose(row);
+        for (size_t i = 0; i < 8; i++) {
+          bytes[g * 8 + i] = static_cast<uint8_t>(row >> (8 * i));
+        }
+      }
+    }
+
+    /// Multiplication by x in GF(2^8)
+    inline uint8_t xtime(uint8_t value) noexcept {
+      return static_cast<uint8_t>((value << 1) ^ ((value >> 7) * 0x1b));
+    }
+
+    /// ShiftRows, MixColumns unless this is the last round, then AddRoundKey, on one block.
+    inline void finishRound(uint8_t* state, const uint8_t* roundKey, bool mixColumns) noexcept {
+      // Byte (row r, column c) moves to column c - r
+      Block shifted;
+      for (size_t column = 0; column < 4; column++) {
+        for (size_t row = 0; row < 4; row++) {
+          shifted[column * 4 + row] = state[((column + row) % 4) * 4 + row];
+        }
+      }
+      if (mixColumns) {
+        for (size_t column = 0; column < 4; column++) {
+          uint8_t* c = shifted.data() + column * 4;
+          uint8_t all = c[0] ^ c[1] ^ c[2] ^ c[3];
+          uint8_t first = c[0];
+          c[0] ^= all ^ xtime(c[0] ^ c[1]);
+          c[1] ^= all ^ xtime(c[1] ^ c[2]);
+          c[2] ^= all ^ xtime(c[2] ^ c[3]);
+          c[3] ^= all ^ xtime(c[3] ^ first);
+        }
+      }
+      for (size_t i = 0; i < BLOCK_SIZE; i++) {
+        state[i] = shifted[i] ^ roundKey[i];
+      }
+    }
+
+    void encryptPortable(const uint8_t* roundKeys, const Block* input, Block* output, size_t count) noexcept {
+      // Two blocks fill the 32 lanes of one S-box evaluation
+      uint8_t state[2 * BLOCK_SIZE];
+      for (size_t offset = 0; offset < count; offset += 2) {
+        size_t blocks = std::min<size_t>(2, count - offset);
+        std::fill(std::begin(state), std::end(state), 0);
+        for (size_t b = 0; b < blocks; b++) {
+          for (size_t i = 0; i < BLOCK_SIZE; i++) {
+            state[b * BLOCK_SIZE + i] = input[offset + b][i] ^ roundKeys[i];
+          }
+        }
+        for (size_t round = 1; round <= ROUNDS; round++) {
+          subBytes(state);
+          for (size_t b = 0; b < blocks; b++) {
+            finishRound(state + b * BLOCK_SIZE, roundKeys + round * BLOCK_SIZE, round != ROUNDS);
+          }
+        }
+        for (size_t b = 0; b < blocks; b++) {
+          std::copy(state + b * BLOCK_SIZE, state + (b + 1) * BLOCK_SIZE, output[offset + b].begin());
+        }
+      }
+      secureWipe(state, sizeof(state));
+    }
+
+#if ESPPROV_AES_NI
+    // pragma MARK: AES-NI
+
+    bool hasAesNi() noexcept {
+      unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+      return __get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0 && (ecx & bit_AES) != 0;
+    }
+
+    __attribute__((target("sse2,aes"))) void encryptAesNi(const uint8_t* roundKeys, const Block* input, Block* output,
+                                                          size_t count) noexcept {
+      __m128i keys[ROUNDS + 1];
+      for (size_t round = 0; round <= ROUNDS; round++) {
+        keys[round] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(roundKeys + round * BLOCK_SIZE));
+      }
+      size_t i = 0;
+      // Four independent blocks hide the latency of aesenc
+      for (; i + 4 <= count; i += 4) {
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input[i].data())), keys[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input[i + 1].data())), keys[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input[i + 2].data())), keys[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input[i + 3].data())), keys[0]);
+        for (size_t round = 1; round < ROUNDS; round++) {
+          b0 = _mm_aesenc_si128(b0, keys[round]);
+          b1 = _mm_aesenc_si128(b1, keys[round]);
+          b2 = _mm_aesenc_si128(b2, keys[round]);
+          b3 = _mm_aesenc_si128(b3, keys[round]);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output[i].data()), _mm_aesenclast_si128(b0, keys[ROUNDS]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output[i + 1].data()), _mm_aesenclast_si128(b1, keys[ROUNDS]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output[i + 2].data()), _mm_aesenclast_si128(b2, keys[ROUNDS]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output[i + 3].data()), _mm_aesenclast_si128(b3, keys[ROUNDS]));
+      }
+      for (; i < count; i++) {
+        __m128i b = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input[i].data())), keys[0]);
+        for (size_t round = 1; round < ROUNDS; round++) {
+          b = _mm_aesenc_si128(b, keys[round]);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output[i].data()), _mm_aesenclast_si128(b, keys[ROUNDS]));
+      }
+    }
+#endif
+
+#if ESPPROV_ARMV8_CE
+    // pragma MARK: ARMv8 Crypto Extensions
+
+    bool hasArmAes() noexcept {
+#if defined(__APPLE__)
+      return true;
+#elif defined(__linux__)
+      return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+#else
+      return false;
+#endif
+    }
+
+    /// AESE is AddRoundKey + SubBytes + ShiftRows and AESMC is MixColumns, so the key schedule is
+    /// offset by one round compared to AES-NI and the last key is a plain XOR.
+    inline uint8x16_t encryptArmBlock(uint8x16_t block, const uint8x16_t* keys) noexcept {
+      for (size_t round = 0; round < ROUNDS - 1; round++) {
+        block = vaesmcq_u8(vaeseq_u8(block, keys[round]));
+      }
+      return veorq_u8(vaeseq_u8(block, keys[ROUNDS - 1]), keys[ROUNDS]);
+    }
+
+    void encryptArmCe(const uint8_t* roundKeys, const Block* input, Block* output, size_t count) noexcept {
+      uint8x16_t keys[ROUNDS + 1];
+      for (size_t round = 0; round <= ROUNDS; round++) {
+        keys[round] = vld1q_u8(roundKeys + round * BLOCK_SIZE);
+      }
+      size_t i = 0;
+      // Four independent blocks keep the AESE/AESMC pairs fused and pipelined
+      for (; i + 4 <= count; i += 4) {
+        uint8x16_t b0 = vld1q_u8(input[i].data());
+        uint8x16_t b1 = vld1q_u8(input[i + 1].data());
+        uint8x16_t b2 = vld1q_u8(input[i + 2].data());
+        uint8x16_t b3 = vld1q_u8(input[i + 3].data());
+        for (size_t round = 0; round < ROUNDS - 1; round++) {
+          b0 = vaesmcq_u8(vaeseq_u8(b0, keys[round]));
+          b1 = vaesmcq_u8(vaeseq_u8(b1, keys[round]));
+          b2 = vaesmcq_u8(vaeseq_u8(b2, keys[round]));
+          b3 = vaesmcq_u8(vaeseq_u8(b3, keys[round]));
+        }
+        vst1q_u8(output[i].data(), veorq_u8(vaeseq_u8(b0, keys[ROUNDS - 1]), keys[ROUNDS]));
+        vst1q_u8(output[i + 1].data(), veorq_u8(vaeseq_u8(b1, keys[ROUNDS - 1]), keys[ROUNDS]));
+        vst1q_u8(output[i + 2].data(), veorq_u8(vaeseq_u8(b2, keys[ROUNDS - 1]), keys[ROUNDS]));
+        vst1q_u8(output[i + 3].data(), veorq_u8(vaeseq_u8(b3, keys[ROUNDS - 1]), keys[ROUNDS]));
+      }
+      for (; i < count; i++) {
+        vst1q_u8(output[i].data(), encryptArmBlock(vld1q_u8(input[i].data()), keys));
+      }
+    }
+#endif
+  } // namespace
+
+  bool Aes256::isSupported(Implementation implementation) noexcept {
+    switch (implementation) {
+      case Implementation::PORTABLE:
+        return true;
+      case Implementation::AES_NI: {
+#if ESPPROV_AES_NI
+        static const bool supported = hasAesNi();
+        return supported;
+#else
+        return false;
+#endif
+      }
+      case Implementation::ARMV8_CE: {
+#if ESPPROV_ARMV8_CE
+        static const bool supported = hasArmAes();
+        return supported;
+#else
+        return false;
+#endif
+      }
+    }
+    return false;
+  }
+
+  Aes256::Implementation Aes256::fastestImplementation() noexcept {
+    for (Implementation implementation : {Implementation::AES_NI, Implementation::ARMV8_CE}) {
+      if (isSupported(implementation)) {
+        return implementation;
+      }
+    }
+    return Implementation::PORTABLE;
+  }
+
+  const char* Aes256::implementationName(Implementation implementation) noexcept {
+    switch (implementation) {
+      case Implementation::PORTABLE:
+        return "portable";
+      case Implementation::AES_NI:
+        return "aes-ni";
+      case Implementation::ARMV8_CE:
+        return "armv8-ce";
+    }
+    return "unknown";
+  }
+
+  Aes256::Aes256(ByteView key, Implementation implementation): _implementation(implementation) {
+    if (key.size() != KEY_SIZE) {
+      throw std::invalid_argument("AES-256 needs a 32 byte key");
+    }
+    if (!isSupported(implementation)) {
+      throw std::invalid_argument(std::string("AES implementation ") + implementationName(implementation) +
+                                  " is not available on this CPU");
+    }
+    std::copy(key.begin(), key.end(), _roundKeys.begin());
+    // FIPS 197 key expansion, one 4 byte word at a time
+    uint8_t word[2 * BLOCK_SIZE];
+    for (size_t i = KEY_SIZE; i < _roundKeys.size(); i += 4) {
+      std::fill(std::begin(word), std::end(word), 0);
+      std::copy(_roundKeys.begin() + static_cast<ptrdiff_t>(i) - 4, _roundKeys.begin() + static_cast<ptrdiff_t>(i), word);
+      if (i % KEY_SIZE == 0) {
+        std::rotate(word, word + 1, word + 4);
+        subBytes(word);
+        word[0] ^= RCON[i / KEY_SIZE - 1];
+      } else if (i % KEY_SIZE == 16) {
+        subBytes(word);
+      }
+      for (size_t j = 0; j < 4; j++) {
+        _roundKeys[i + j] = _roundKeys[i + j - KEY_SIZE] ^ word[j];
+      }
+    }
+    secureWipe(word, sizeof(word));
+  }
+
+  Aes256::~Aes256() {
+    secureWipe(_roundKeys.data(), _roundKeys.size());
+  }
+
+  Aes256::Block Aes256::encryptBlock(const Block& input) const noexcept {
+    Block output;
+    encryptBlocks(&input, &output, 1);
+    return output;
+  }
+
+  void Aes256::encryptBlocks(const Block* input, Block* output, size_t count) const noexcept {
+    switch (_implementation) {
+#if ESPPROV_AES_NI
+      case Implementation::AES_NI:
+        encryptAesNi(_roundKeys.data(), input, output, count);
+        return;
+#endif
+#if ESPPROV_ARMV8_CE
+      case Implementation::ARMV8_CE:
+        encryptArmCe(_roundKeys.data(), input, output, count);
+        return;
+#endif
+      default:
+        encryptPortable(_roundKeys.data(), input, output, count);
+        return;
+    }
+  }
+
+} // namespace espprov::crypto
@@ -0,0 +1,74 @@
+///
+/// Aes256.hpp
+/// The AES-256 block cipher, forward direction only: every mode protocomm uses is counter based.
+///
+
+#pragma once
+
+#include "core/Bytes.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace espprov::crypto {
+
+  /**
+   * AES-256 encryption on the best path the CPU offers: AES-NI on x86, the ARMv8 Crypto
+   * Extensions on arm64, and otherwise a portable path whose S-box is a bitsliced Boyar-Peralta
+   * circuit rather than a table, so no path indexes memory with key or data bytes.
+   */
+  class Aes256 {
+  public:
+    static constexpr size_t KEY_SIZE = 32;
+    static constexpr size_t BLOCK_SIZE = 16;
+    static constexpr size_t ROUNDS = 14;
+
+    using Block = std::array<uint8_t, BLOCK_SIZE>;
+
+    enum class Implementation : uint8_t {
+      PORTABLE,
+      AES_NI,
+      ARMV8_CE,
+    };
+
+    /**
+     * Whether this build and this CPU can run `implementation`. Detected once.
+     */
+    static bool isSupported(Implementation implementation) noexcept;
+
+    /**
+     * The hardware path if there is one, `PORTABLE` otherwise.
+     */
+    static Implementation fastestImplementation() noexcept;
+
+    static const char* implementationName(Implementation implementation) noexcept;
+
+    /**
+     * Expands `key`. Throws `std::invalid_argument` unless it is `KEY_SIZE` bytes long and
+     * `implementation` is supported.
+     */
+    explicit Aes256(ByteView key, Implementation implementation = fastestImplementation());
+    ~Aes256();
+
+    Aes256(const Aes256&) = default;
+    Aes256& operator=(const Aes256&) = default;
+
+    Implementation implementation() const noexcept {
+      return _implementation;
+    }
+
+    Block encryptBlock(const Block& input) const noexcept;
+
+    /**
+     * Encrypts `count` independent blocks, e.g. a run of counters. The hardware paths keep four
+     * blocks in flight and the portable path pushes two through each S-box evaluation, so this is
+     * considerably faster than one `encryptBlock` per block.
+     */
+    void encryptBlocks(const Block* input, Block* output, size_t count) const noexcept;
+
+  private:
+    std::array<uint8_t, BLOCK_SIZE * (ROUNDS + 1)> _roundKeys;
+    Implementation _implementation;
+  };
+
+} // namespace espprov::crypto
@@ -0,0 +1,84 @@
+///
+/// AesCtr.cpp
+/// An AES-256-CTR key stream that continues across calls, the record protection of Sec1.
+///
+
+#include "AesCtr.hpp"
+#include "SecureWipe.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace espprov::crypto {
+
+  namespace {
+    // Counter blocks encrypted per batch, enough to keep the hardware pipelines full
+    constexpr size_t BATCH_BLOCKS = 8;
+  } // namespace
+
+  AesCtr::AesCtr(ByteView key, ByteView iv, Aes256::Implementation implementation): _aes(key, implementation) {
+    if (iv.size() != Aes256::BLOCK_SIZE) {
+      throw std::invalid_argument("AES-CTR needs a 16 byte counter block");
+    }
+    std::copy(iv.begin(), iv.end(), _counter.begin());
+  }
+
+  AesCtr::~AesCtr() {
+    secureWipe(_keyStream.data(), _keyStream.size());
+  }
+
+  void AesCtr::nextCounters(Aes256::Block* counters, size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+      counters[i] = _counter;
+      for (size_t j = Aes256::BLOCK_SIZE; j-- > 0;) {
+        if (++_counter[j] != 0) {
+          break;
+        }
+      }
+    }
+  }
+
+  void AesCtr::apply(ByteView input, uint8_t* output) noexcept {
+    const uint8_t* in = input.data();
+    size_t remaining = input.size();
+
+    // Finish the block a previous call started
+    while (remaining > 0 && _keyStreamUsed < Aes256::BLOCK_SIZE) {
+      *output++ = *in++ ^ _keyStream[_keyStreamUsed++];
+      remaining--;
+    }
+
+    Aes256::Block counters[BATCH_BLOCKS];
+    Aes256::Block keyStream[BATCH_BLOCKS];
+    while (remaining >= Aes256::BLOCK_SIZE) {
+      size_t blocks = std::min(BATCH_BLOCKS, remaining / Aes256::BLOCK_SIZE);
+      nextCounters(counters, blocks);
+      _aes.encryptBlocks(counters, keyStream, blocks);
+      for (size_t b = 0; b < blocks; b++) {
+        for (size_t i = 0; i < Aes256::BLOCK_SIZE; i++) {
+          output[i] = in[i] ^ keyStream[b][i];
+        }
+        in += Aes256::BLOCK_SIZE;
+        output += Aes256::BLOCK_SIZE;
+      }
+      remaining -= blocks * Aes256::BLOCK_SIZE;
+    }
+    secureWipe(keyStream, sizeof(keyStream));
+
+    if (remaining > 0) {
+      nextCounters(counters, 1);
+      _keyStream = _aes.encryptBlock(counters[0]);
+      _keyStreamUsed = 0;
+      while (remaining > 0) {
+        *output++ = *in++ ^ _keyStream[_keyStreamUsed++];
+        remaining--;
+      }
+    }
+  }
+
+  Bytes AesCtr::apply(ByteView input) {
+    Bytes output(input.size());
+    apply(input, output.data());
+    return output;
+  }
+
+} // namespace espprov::crypto
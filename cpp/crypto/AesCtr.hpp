@@ -0,0 +1,46 @@
+///
+/// AesCtr.hpp
+/// An AES-256-CTR key stream that continues across calls, the record protection of Sec1.
+///
+
+#pragma once
+
+#include "Aes256.hpp"
+#include "core/Bytes.hpp"
+
+namespace espprov::crypto {
+
+  /**
+   * The whole 16 byte counter block is incremented as one big endian integer, like
+   * `mbedtls_aes_crypt_ctr`. Encryption and decryption are the same operation.
+   */
+  class AesCtr {
+  public:
+    /**
+     * Throws `std::invalid_argument` unless `key` is 32 bytes and `iv` 16 bytes.
+     */
+    AesCtr(ByteView key, ByteView iv, Aes256::Implementation implementation = Aes256::fastestImplementation());
+    ~AesCtr();
+
+    /**
+     * XORs `input` with the next `input.size()` key stream bytes into `output`, which may alias it.
+     */
+    void apply(ByteView input, uint8_t* output) noexcept;
+
+    Bytes apply(ByteView input);
+
+    Aes256::Implementation implementation() const noexcept {
+      return _aes.implementation();
+    }
+
+  private:
+    void nextCounters(Aes256::Block* counters, size_t count) noexcept;
+
+  private:
+    Aes256 _aes;
+    Aes256::Block _counter;
+    Aes256::Block _keyStream{};
+    size_t _keyStreamUsed = Aes256::BLOCK_SIZE;
+  };
+
+} // namespace espprov::crypto
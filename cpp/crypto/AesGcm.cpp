@@ -0,0 +1,162 @@
+///
+/// AesGcm.cpp
+/// AES-256-GCM without associated data, the record protection of Sec2.
+///
+
+#include "AesGcm.hpp"
+#include "SecureWipe.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace espprov::crypto {
+
+  namespace {
+    // Counter blocks encrypted per batch, enough to keep the hardware pipelines full
+    constexpr size_t BATCH_BLOCKS = 8;
+
+    inline uint64_t loadBigEndian64(const uint8_t* p) noexcept {
+      uint64_t value = 0;
+      for (int i = 0; i < 8; i++) {
+        value = (value << 8) | p[i];
+      }
+      return value;
+    }
+
+    inline void storeBigEndian64(uint8_t* p, uint64_t value) noexcept {
+      for (int i = 7; i >= 0; i--) {
+        p[i] = static_cast<uint8_t>(value);
+        value >>= 8;
+      }
+    }
+
+    /// Increments the last 32 bits of the block, big endian, wrapping around.
+    inline void increment32(Aes256::Block& counter) noexcept {
+      for (size_t i = Aes256::BLOCK_SIZE; i-- > Aes256::BLOCK_SIZE - 4;) {
+        if (++counter[i] != 0) {
+          break;
+        }
+      }
+    }
+  } // namespace
+
+  AesGcm::AesGcm(ByteView key, Aes256::Implementation implementation): _aes(key, implementation) {
+    Aes256::Block h = _aes.encryptBlock(Aes256::Block{});
+    _h.high = loadBigEndian64(h.data());
+    _h.low = loadBigEndian64(h.data() + 8);
+    secureWipe(h.data(), h.size());
+  }
+
+  AesGcm::~AesGcm() {
+    secureWipe(&_h, sizeof(_h));
+  }
+
+  Bytes AesGcm::seal(ByteView iv, ByteView plain) const {
+    Aes256::Block j0 = counterBlock(iv);
+    Bytes output(plain.size() + TAG_SIZE);
+    crypt(j0, plain, output.data());
+    Aes256::Block t = tag(j0, ByteView(output.data(), plain.size()));
+    std::memcpy(output.data() + plain.size(), t.data(), TAG_SIZE);
+    return output;
+  }
+
+  std::optional<Bytes> AesGcm::open(ByteView iv, ByteView cipherAndTag) const {
+    if (cipherAndTag.size() < TAG_SIZE) {
+      return std::nullopt;
+    }
+    ByteView cipher = cipherAndTag.first(cipherAndTag.size() - TAG_SIZE);
+    ByteView received = cipherAndTag.last(TAG_SIZE);
+
+    Aes256::Block j0 = counterBlock(iv);
+    Aes256::Block expected = tag(j0, cipher);
+    uint8_t difference = 0;
+    for (size_t i = 0; i < TAG_SIZE; i++) {
+      difference |= expected[i] ^ received[i];
+    }
+    if (difference != 0) {
+      return std::nullopt;
+    }
+
+    Bytes plain(cipher.size());
+    crypt(j0, cipher, plain.data());
+    return plain;
+  }
+
+  Aes256::Block AesGcm::counterBlock(ByteView iv) const noexcept {
+    Aes256::Block j0{};
+    if (iv.size() == 12) {
+      std::memcpy(j0.data(), iv.data(), iv.size());
+      j0[Aes256::BLOCK_SIZE - 1] = 1;
+      return j0;
+    }
+    // J0 = GHASH(IV || pad || [0]64 || [len(IV)]64)
+    Element x;
+    ghashUpdate(x, _h, iv);
+    Aes256::Block lengths{};
+    storeBigEndian64(lengths.data() + 8, static_cast<uint64_t>(iv.size()) * 8);
+    ghashUpdate(x, _h, lengths);
+    storeBigEndian64(j0.data(), x.high);
+    storeBigEndian64(j0.data() + 8, x.low);
+    return j0;
+  }
+
+  void AesGcm::crypt(Aes256::Block counter, ByteView input, uint8_t* output) const noexcept {
+    Aes256::Block counters[BATCH_BLOCKS];
+    Aes256::Block keyStream[BATCH_BLOCKS];
+    for (size_t offset = 0; offset < input.size();) {
+      size_t blocks = std::min(BATCH_BLOCKS, (input.size() - offset + Aes256::BLOCK_SIZE - 1) / Aes256::BLOCK_SIZE);
+      for (size_t b = 0; b < blocks; b++) {
+        increment32(counter);
+        counters[b] = counter;
+      }
+      _aes.encryptBlocks(counters, keyStream, blocks);
+      for (size_t b = 0; b < blocks; b++, offset += Aes256::BLOCK_SIZE) {
+        size_t length = std::min(Aes256::BLOCK_SIZE, input.size() - offset);
+        for (size_t i = 0; i < length; i++) {
+          output[offset + i] = input[offset + i] ^ keyStream[b][i];
+        }
+      }
+    }
+    secureWipe(keyStream, sizeof(keyStream));
+  }
+
+  Aes256::Block AesGcm::tag(const Aes256::Block& j0, ByteView cipher) const noexcept {
+    Element x;
+    ghashUpdate(x, _h, cipher);
+    Aes256::Block lengths{};
+    storeBigEndian64(lengths.data() + 8, static_cast<uint64_t>(cipher.size()) * 8);
+    ghashUpdate(x, _h, lengths);
+
+    Aes256::Block t = _aes.encryptBlock(j0);
+    Aes256::Block s;
+    storeBigEndian64(s.data(), x.high);
+    storeBigEndian64(s.data() + 8, x.low);
+    for (size_t i = 0; i < TAG_SIZE; i++) {
+      t[i] ^= s[i];
+    }
+    return t;
+  }
+
+  void AesGcm::ghashUpdate(Element& x, const Element& h, ByteView data) noexcept {
+    for (size_t offset = 0; offset < data.size(); offset += Aes256::BLOCK_SIZE) {
+      Aes256::Block block{};
+      std::memcpy(block.data(), data.data() + offset, std::min(Aes256::BLOCK_SIZE, data.size() - offset));
+      x.high ^= loadBigEndian64(block.data());
+      x.low ^= loadBigEndian64(block.data() + 8);
+
+      // x = x * h in GF(2^128), bit reflected as GCM defines it, with masks instead of branches
+      Element z;
+      Element v = h;
+      for (int i = 0; i < 128; i++) {
+        uint64_t bit = (i < 64 ? x.high >> (63 - i) : x.low >> (127 - i)) & 1;
+        uint64_t mask = uint64_t(0) - bit;
+        z.high ^= v.high & mask;
+        z.low ^= v.low & mask;
+        uint64_t reduce = uint64_t(0) - (v.low & 1);
+        v.low = (v.low >> 1) | (v.high << 63);
+        v.high = (v.high >> 1) ^ (0xe100000000000000 & reduce);
+      }
+      x = z;
+    }
+  }
+
+} // namespace espprov::crypto
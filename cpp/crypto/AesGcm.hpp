@@ -0,0 +1,49 @@
+///
+/// AesGcm.hpp
+/// AES-256-GCM without associated data, the record protection of Sec2.
+///
+
+#pragma once
+
+#include "Aes256.hpp"
+#include "core/Bytes.hpp"
+#include <optional>
+
+namespace espprov::crypto {
+
+  class AesGcm {
+  public:
+    static constexpr size_t TAG_SIZE = 16;
+
+    explicit AesGcm(ByteView key, Aes256::Implementation implementation = Aes256::fastestImplementation());
+    ~AesGcm();
+
+    /**
+     * Encrypts `plain` and returns the cipher text followed by the 16 byte tag.
+     * Any non empty `iv` is accepted, lengths other than 12 go through GHASH as NIST SP 800-38D says.
+     */
+    Bytes seal(ByteView iv, ByteView plain) const;
+
+    /**
+     * Verifies and decrypts the output of `seal`. Returns `std::nullopt` if the tag does not match.
+     */
+    std::optional<Bytes> open(ByteView iv, ByteView cipherAndTag) const;
+
+  private:
+    struct Element {
+      uint64_t high = 0;
+      uint64_t low = 0;
+    };
+
+    Aes256::Block counterBlock(ByteView iv) const noexcept;
+    void crypt(Aes256::Block counter, ByteView input, uint8_t* output) const noexcept;
+    Aes256::Block tag(const Aes256::Block& j0, ByteView cipher) const noexcept;
+
+    static void ghashUpdate(Element& x, const Element& h, ByteView data) noexcept;
+
+  private:
+    Aes256 _aes;
+    Element _h;
+  };
+
+} // namespace espprov::crypto
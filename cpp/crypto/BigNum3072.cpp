@@ -0,0 +1,376 @@
+///
+/// BigNum3072.cpp
+/// Arithmetic modulo the RFC 3526 / RFC 5054 3072-bit prime, the SRP6a group of Sec2.
+///
+
+#include "BigNum3072.hpp"
+#include "SecureWipe.hpp"
+#include <stdexcept>
+#include <string_view>
+
+namespace espprov::crypto {
+
+  namespace {
+    constexpr size_t L = BigNum3072::LIMBS;
+    constexpr size_t W = BigNum3072::LIMB_BITS;
+    constexpr size_t WINDOW = 5;
+
+    using Residue = std::array<Limb, L>;
+
+    // RFC 3526 section 4, 2^3072 - 2^3008 - 1 + 2^64 * { [2^2942 pi] + 1690314 }
+    constexpr std::string_view PRIME_HEX = "FFFFFFFFFFFFFFFFC90FDAA22168C234C4C6628B80DC1CD129024E088A67CC74"
+                                           "020BBEA63B139B22514A08798E3404DDEF9519B3CD3A431B302B0A6DF25F1437"
+                                           "4FE1356D6D51C245E485B576625E7EC6F44C42E9A637ED6B0BFF5CB6F406B7ED"
+                                           "EE386BFB5A899FA5AE9F24117C4B1FE649286651ECE45B3DC2007CB8A163BF05"
+                                           "98DA48361C55D39A69163FA8FD24CF5F83655D23DCA3AD961C62F356208552BB"
+                                           "9ED529077096966D670C354E4ABC9804F1746C08CA18217C32905E462E36CE3B"
+                                           "E39E772C180E86039B2783A2EC07A28FB5C55DF06F4C52C9DE2BCBF695581718"
+                                           "3995497CEA956AE515D2261898FA051015728E5A8AAAC42DAD33170D04507A33"
+                                           "A85521ABDF1CBA64ECFB850458DBEF0A8AEA71575D060C7DB3970F85A6E1E4C7"
+                                           "ABF5AE8CDB0933D71E8C94E04A25619DCEE3D2261AD2EE6BF12FFA06D98A0864"
+                                           "D87602733EC86A64521F2B18177B200CBBE117577A615D6C770988C0BAD946E2"
+                                           "08E24FA074E5AB3143DB5BFCE0FD108E4B82D120A93AD2CAFFFFFFFFFFFFFFFF";
+
+    constexpr Residue parseHex(std::string_view hex) {
+      Residue value{};
+      constexpr size_t nibblesPerLimb = W / 4;
+      for (size_t i = 0; i < hex.size(); i++) {
+        char c = hex[hex.size() - 1 - i];
+        Limb nibble = c <= '9' ? static_cast<Limb>(c - '0') : static_cast<Limb>(c - 'A' + 10);
+        value[i / nibblesPerLimb] |= nibble << (4 * (i % nibblesPerLimb));
+      }
+      return value;
+    }
+
+    constexpr Residue N = parseHex(PRIME_HEX);
+    static_assert(PRIME_HEX.size() * 4 == BigNum3072::BITS);
+    static_assert(N[0] == ~Limb(0), "The Montgomery reduction below relies on -N^-1 mod 2^w being 1");
+
+    /// All ones if `condition` is 1, zero if it is 0.
+    inline Limb maskOf(Limb condition) noexcept {
+      return static_cast<Limb>(0) - condition;
+    }
+
+    /// All ones if `a == b`, without a data dependent branch.
+    inline Limb equalMask(Limb a, Limb b) noexcept {
+      Limb diff = a ^ b;
+      return ((diff | (static_cast<Limb>(0) - diff)) >> (W - 1)) - 1;
+    }
+
+    inline void select(Residue& out, const Residue& ifSet, const Residue& ifClear, Limb mask) noexcept {
+      for (size_t i = 0; i < L; i++) {
+        out[i] = (ifSet[i] & mask) | (ifClear[i] & ~mask);
+      }
+    }
+
+    /// out = a - b, returns the borrow.
+    inline Limb subtract(Residue& out, const Residue& a, const Residue& b) noexcept {
+      Limb borrow = 0;
+      for (size_t i = 0; i < L; i++) {
+        DoubleLimb diff = static_cast<DoubleLimb>(a[i]) - b[i] - borrow;
+        out[i] = static_cast<Limb>(diff);
+        borrow = static_cast<Limb>(diff >> W) & 1;
+      }
+      return borrow;
+    }
+
+    /// Brings `top * 2^3072 + value` below N, given it is below `(top + 1) * N`. At most 7 * N.
+    inline void reduce(Residue& value, Limb top, int rounds) noexcept {
+      Residue diff;
+      for (int round = 0; round < rounds; round++) {
+        Limb borrow = subtract(diff, value, N);
+        Limb keep = maskOf(static_cast<Limb>(top >= borrow));
+        select(value, diff, value, keep);
+        top = ((top - borrow) & keep) | (top & ~keep);
+      }
+    }
+
+    /**
+     * A column sum of the product scanning loops: up to 2 * LIMBS double limb products, so a
+     * double limb plus one extra limb never overflows.
+     */
+    struct Accumulator {
+      DoubleLimb low = 0;
+      Limb high = 0;
+
+      inline void add(Limb x, Limb y) noexcept {
+        DoubleLimb p = static_cast<DoubleLimb>(x) * y;
+        low += p;
+        high += static_cast<Limb>(low < p);
+      }
+
+      inline void add(const Accumulator& other) noexcept {
+        low += other.low;
+        high += other.high + static_cast<Limb>(low < other.low);
+      }
+
+      inline void twice() noexcept {
+        high = (high << 1) | static_cast<Limb>(low >> (2 * W - 1));
+        low <<= 1;
+      }
+
+      /// Removes and returns the lowest limb.
+      inline Limb shift() noexcept {
+        Limb out = static_cast<Limb>(low);
+        low = (low >> W) | (static_cast<DoubleLimb>(high) << W);
+        high = 0;
+        return out;
+      }
+    };
+
+    /**
+     * Montgomery multiplication in product scanning form (Koc et al., "FIPS"): column i of a * b
+     * and of m * N are summed together, so the carries stay in one accumulator instead of rippling
+     * through every row. With -N^-1 = 1 mod 2^w the quotient limb m[i] is the column's low limb,
+     * and since N[0] is all ones, adding m[i] * N[0] clears that limb and carries exactly m[i].
+     *
+     * `Columns` adds the a * b terms of column i, over the index range [from, to].
+     */
+    template <typename Columns>
+    inline Residue montgomery(const Columns& columns) noexcept {
+      Residue m;
+      Residue out;
+      Accumulator acc;
+      for (size_t i = 0; i < L; i++) {
+        columns(acc, i, 0, i);
+        for (size_t j = 0; j < i; j++) {
+          acc.add(m[j], N[i - j]);
+        }
+        m[i] = static_cast<Limb>(acc.low);
+        acc.shift();
+        acc.low += m[i];
+        acc.high += static_cast<Limb>(acc.low < m[i]);
+      }
+      for (size_t i = L; i < 2 * L - 1; i++) {
+        columns(acc, i, i - L + 1, L - 1);
+        for (size_t j = i - L + 1; j < L; j++) {
+          acc.add(m[j], N[i - j]);
+        }
+        out[i - L] = acc.shift();
+      }
+      out[L - 1] = acc.shift();
+      reduce(out, static_cast<Limb>(acc.low), 1);
+      secureWipe(m.data(), sizeof(m));
+      return out;
+    }
+
+    inline Residue montgomeryMultiply(const Residue& a, const Residue& b) noexcept {
+      return montgomery([&](Accumulator& acc, size_t i, size_t from, size_t to) {
+        for (size_t j = from; j <= to; j++) {
+          acc.add(a[j], b[i - j]);
+        }
+      });
+    }
+
+    /// Squaring sums each cross product of a column once, doubles it, then adds the diagonal.
+    inline Residue montgomerySquare(const Residue& a) noexcept {
+      return montgomery([&](Accumulator& acc, size_t i, size_t from, size_t to) {
+        Accumulator cross;
+        for (size_t j = from, k = to; j < k; j++, k--) {
+          cross.add(a[j], a[k]);
+        }
+        cross.twice();
+        if (i % 2 == 0) {
+          cross.add(a[i / 2], a[i / 2]);
+        }
+        acc.add(cross);
+      });
+    }
+
+    /// a * k mod N for a small k, which keeps a Montgomery residue in Montgomery form.
+    inline Residue multiplySmall(const Residue& a, Limb k) noexcept {
+      Residue out;
+      Limb carry = 0;
+      for (size_t i = 0; i < L; i++) {
+        DoubleLimb p = static_cast<DoubleLimb>(a[i]) * k + carry;
+        out[i] = static_cast<Limb>(p);
+        carry = static_cast<Limb>(p >> W);
+      }
+      reduce(out, carry, static_cast<int>(k) - 1);
+      return out;
+    }
+
+    struct Montgomery {
+      Residue one; // R mod N
+      Residue rr;  // R^2 mod N
+    };
+
+    const Montgomery& montgomery() noexcept {
+      static const Montgomery constants = [] {
+        Montgomery m{};
+        // N > 2^3071, so R mod N is simply R - N
+        subtract(m.one, Residue{}, N);
+        // R^2 mod N by doubling R mod N another 3072 times
+        m.rr = m.one;
+        for (size_t bit = 0; bit < BigNum3072::BITS; bit++) {
+          Limb carry = m.rr[L - 1] >> (W - 1);
+          for (size_t i = L - 1; i > 0; i--) {
+            m.rr[i] = (m.rr[i] << 1) | (m.rr[i - 1] >> (W - 1));
+          }
+          m.rr[0] <<= 1;
+          reduce(m.rr, carry, 1);
+        }
+        return m;
+      }();
+      return constants;
+    }
+
+    inline Residue toMontgomery(const Residue& a) noexcept {
+      return montgomeryMultiply(a, montgomery().rr);
+    }
+
+    inline Residue fromMontgomery(const Residue& a) noexcept {
+      Residue one{};
+      one[0] = 1;
+      return montgomeryMultiply(a, one);
+    }
+
+    /// Bits [position, position + width) of a big endian exponent, bit 0 being the least significant.
+    inline Limb exponentBits(ByteView exponent, size_t position, size_t width) noexcept {
+      Limb bits = 0;
+      for (size_t i = 0; i < width; i++) {
+        size_t bit = position + i;
+        Limb value = (exponent[exponent.size() - 1 - bit / 8] >> (bit % 8)) & 1;
+        bits |= value << i;
+      }
+      return bits;
+    }
+  } // namespace
+
+  BigNum3072 BigNum3072::fromBytes(ByteView bigEndian) {
+    if (bigEndian.size() > BYTES) {
+      throw std::invalid_argument("Integer does not fit in 3072 bits");
+    }
+    BigNum3072 value;
+    for (size_t i = 0; i < bigEndian.size(); i++) {
+      Limb byte = bigEndian[bigEndian.size() - 1 - i];
+      value._limbs[i / sizeof(Limb)] |= byte << (8 * (i % sizeof(Limb)));
+    }
+    // Anything below 2^3072 is below 2 * N
+    reduce(value._limbs, 0, 1);
+    return value;
+  }
+
+  const BigNum3072& BigNum3072::prime() noexcept {
+    static const BigNum3072 value = [] {
+      BigNum3072 n;
+      n._limbs = N;
+      return n;
+    }();
+    return value;
+  }
+
+  BigNum3072 BigNum3072::generator() noexcept {
+    BigNum3072 g;
+    g._limbs[0] = GENERATOR;
+    return g;
+  }
+
+  BigNum3072 BigNum3072::generatorPow(ByteView exponent) noexcept {
+    Residue acc = montgomery().one;
+    for (size_t bit = exponent.size() * 8; bit-- > 0;) {
+      acc = montgomerySquare(acc);
+      Residue multiplied = multiplySmall(acc, GENERATOR);
+      select(acc, multiplied, acc, maskOf(exponentBits(exponent, bit, 1)));
+      secureWipe(multiplied.data(), sizeof(multiplied));
+    }
+    BigNum3072 result;
+    result._limbs = fromMontgomery(acc);
+    secureWipe(acc.data(), sizeof(acc));
+    return result;
+  }
+
+  BigNum3072 BigNum3072::modPow(ByteView exponent) const noexcept {
+    constexpr size_t TABLE_SIZE = size_t(1) << WINDOW;
+    std::array<Residue, TABLE_SIZE> table;
+    table[0] = montgomery().one;
+    table[1] = toMontgomery(_limbs);
+    for (size_t i = 2; i < TABLE_SIZE; i++) {
+      table[i] = i % 2 == 0 ? montgomerySquare(table[i / 2]) : montgomeryMultiply(table[i - 1], table[1]);
+    }
+
+    Residue acc = montgomery().one;
+    Residue entry;
+    size_t position = exponent.size() * 8;
+    size_t width = position % WINDOW == 0 ? WINDOW : position % WINDOW;
+    bool first = true;
+    while (position > 0) {
+      position -= width;
+      Limb index = exponentBits(exponent, position, width);
+      // Read every entry so the memory access pattern does not reveal the window value
+      entry.fill(0);
+      for (size_t i = 0; i < TABLE_SIZE; i++) {
+        select(entry, table[i], entry, equalMask(static_cast<Limb>(i), index));
+      }
+      if (first) {
+        acc = entry;
+        first = false;
+      } else {
+        for (size_t i = 0; i < width; i++) {
+          acc = montgomerySquare(acc);
+        }
+        acc = montgomeryMultiply(acc, entry);
+      }
+      width = WINDOW;
+    }
+
+    BigNum3072 result;
+    result._limbs = fromMontgomery(acc);
+    secureWipe(table.data(), sizeof(table));
+    secureWipe(acc.data(), sizeof(acc));
+    secureWipe(entry.data(), sizeof(entry));
+    return result;
+  }
+
+  BigNum3072 BigNum3072::modMul(const BigNum3072& other) const noexcept {
+    // (a * b / R) * R^2 / R
+    Residue product = montgomeryMultiply(_limbs, other._limbs);
+    BigNum3072 result;
+    result._limbs = montgomeryMultiply(product, montgomery().rr);
+    secureWipe(product.data(), sizeof(product));
+    return result;
+  }
+
+  BigNum3072 BigNum3072::modSub(const BigNum3072& other) const noexcept {
+    BigNum3072 result;
+    Limb mask = maskOf(subtract(result._limbs, _limbs, other._limbs));
+    Limb carry = 0;
+    for (size_t i = 0; i < L; i++) {
+      DoubleLimb sum = static_cast<DoubleLimb>(result._limbs[i]) + (N[i] & mask) + carry;
+      result._limbs[i] = static_cast<Limb>(sum);
+      carry = static_cast<Limb>(sum >> W);
+    }
+    return result;
+  }
+
+  bool BigNum3072::isZero() const noexcept {
+    Limb bits = 0;
+    for (Limb limb : _limbs) {
+      bits |= limb;
+    }
+    return bits == 0;
+  }
+
+  Bytes BigNum3072::toBytes() const {
+    Bytes bytes(BYTES);
+    for (size_t i = 0; i < BYTES; i++) {
+      bytes[BYTES - 1 - i] = static_cast<uint8_t>(_limbs[i / sizeof(Limb)] >> (8 * (i % sizeof(Limb))));
+    }
+    return bytes;
+  }
+
+  Bytes BigNum3072::toMinimalBytes() const {
+    Bytes bytes = toBytes();
+    size_t leadingZeros = 0;
+    while (leadingZeros < bytes.size() && bytes[leadingZeros] == 0) {
+      leadingZeros++;
+    }
+    bytes.erase(bytes.begin(), bytes.begin() + static_cast<ptrdiff_t>(leadingZeros));
+    return bytes;
+  }
+
+  void BigNum3072::wipe() noexcept {
+    secureWipe(_limbs.data(), sizeof(_limbs));
+  }
+
+} // namespace espprov::crypto
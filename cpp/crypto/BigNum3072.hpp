@@ -0,0 +1,86 @@
+///
+/// BigNum3072.hpp
+/// Arithmetic modulo the RFC 3526 / RFC 5054 3072-bit prime, the SRP6a group of Sec2.
+///
+
+#pragma once
+
+#include "core/Bytes.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace espprov::crypto {
+
+#if defined(__SIZEOF_INT128__)
+  using Limb = uint64_t;
+  __extension__ using DoubleLimb = unsigned __int128;
+#else
+  // armv7 and 32-bit x86 have no 128-bit integer type
+  using Limb = uint32_t;
+  using DoubleLimb = uint64_t;
+#endif
+
+  /**
+   * A residue modulo the fixed 3072-bit safe prime `N` of the SRP group, whose generator is 5.
+   *
+   * Only the operations an SRP6a client needs are provided. Exponentiation runs on Montgomery
+   * residues: the prime's lowest limb is all ones, so the Montgomery constant `-N^-1 mod 2^w`
+   * is 1 and every reduction step uses the current limb as is. Multiplications and squarings
+   * are fixed length and exponent bits only pick table entries through masks, so the running
+   * time depends on the length of the exponent, never on its value.
+   */
+  class BigNum3072 {
+  public:
+    static constexpr size_t BITS = 3072;
+    static constexpr size_t BYTES = BITS / 8;
+    static constexpr size_t LIMB_BITS = sizeof(Limb) * 8;
+    static constexpr size_t LIMBS = BITS / LIMB_BITS;
+    static constexpr Limb GENERATOR = 5;
+
+    BigNum3072() noexcept = default;
+
+    /**
+     * Parses an unsigned big endian integer of at most `BYTES` bytes and reduces it modulo `N`.
+     * Throws `std::invalid_argument` if the input is longer.
+     */
+    static BigNum3072 fromBytes(ByteView bigEndian);
+
+    static const BigNum3072& prime() noexcept;
+    static BigNum3072 generator() noexcept;
+
+    /**
+     * `g^exponent mod N`, with `exponent` given as big endian bytes.
+     * Specialised for g = 5: one squaring per exponent bit and a masked multiplication by 5.
+     */
+    static BigNum3072 generatorPow(ByteView exponent) noexcept;
+
+    /**
+     * `this^exponent mod N`, with `exponent` given as big endian bytes of any length.
+     * Uses a fixed 5-bit window and a masked scan over the whole window table.
+     */
+    BigNum3072 modPow(ByteView exponent) const noexcept;
+
+    BigNum3072 modMul(const BigNum3072& other) const noexcept;
+    BigNum3072 modSub(const BigNum3072& other) const noexcept;
+
+    bool isZero() const noexcept;
+
+    /**
+     * Big endian, left padded to `BYTES`.
+     */
+    Bytes toBytes() const;
+
+    /**
+     * Big endian without leading zero bytes, the way `mbedtls_mpi_write_binary` sized by
+     * `mbedtls_mpi_size` encodes it on the device.
+     */
+    Bytes toMinimalBytes() const;
+
+    void wipe() noexcept;
+
+  private:
+    std::array<Limb, LIMBS> _limbs{};
+  };
+
+} // namespace espprov::crypto
@@ -0,0 +1,51 @@
+///
+/// Random.cpp
+/// Key material from the operating system's CSPRNG.
+///
+
+#include "Random.hpp"
+#include <cerrno>
+#include <system_error>
+
+#if defined(__APPLE__)
+#include <stdlib.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace espprov::crypto {
+
+  void randomBytes(uint8_t* output, size_t length) {
+#if defined(__APPLE__)
+    arc4random_buf(output, length);
+#else
+    // getrandom() needs Android API 28, /dev/urandom works on every supported release
+    int fd = ::open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "open /dev/urandom");
+    }
+    size_t filled = 0;
+    while (filled < length) {
+      ssize_t count = ::read(fd, output + filled, length - filled);
+      if (count < 0 && errno == EINTR) {
+        continue;
+      }
+      if (count <= 0) {
+        int error = count < 0 ? errno : EIO;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "read /dev/urandom");
+      }
+      filled += static_cast<size_t>(count);
+    }
+    ::close(fd);
+#endif
+  }
+
+  Bytes randomBytes(size_t length) {
+    Bytes bytes(length);
+    randomBytes(bytes.data(), length);
+    return bytes;
+  }
+
+} // namespace espprov::crypto
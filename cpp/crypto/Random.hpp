@@ -0,0 +1,20 @@
+///
+/// Random.hpp
+/// Key material from the operating system's CSPRNG.
+///
+
+#pragma once
+
+#include "core/Bytes.hpp"
+#include <cstddef>
+
+namespace espprov::crypto {
+
+  /**
+   * Fills `length` bytes at `output`. Throws `std::system_error` if the system source fails.
+   */
+  void randomBytes(uint8_t* output, size_t length);
+
+  Bytes randomBytes(size_t length);
+
+} // namespace espprov::crypto
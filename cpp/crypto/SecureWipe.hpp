@@ -0,0 +1,26 @@
+///
+/// SecureWipe.hpp
+/// Zeroes key material in a way the optimizer cannot drop.
+///
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace espprov::crypto {
+
+  inline void secureWipe(void* data, size_t size) noexcept {
+    volatile uint8_t* bytes = static_cast<volatile uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+      bytes[i] = 0;
+    }
+  }
+
+  inline void secureWipe(std::vector<uint8_t>& bytes) noexcept {
+    secureWipe(bytes.data(), bytes.size());
+    bytes.clear();
+  }
+
+} // namespace espprov::crypto
@@ -0,0 +1,134 @@
+///
+/// Sha256.cpp
+/// SHA-256 (FIPS 180-4), which Sec1 derives its key mask from.
+///
+
+#include "Sha256.hpp"
+#include "SecureWipe.hpp"
+#include <cstring>
+
+namespace espprov::crypto {
+
+  namespace {
+    constexpr std::array<uint32_t, 64> K = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+
+    constexpr std::array<uint32_t, 8> INITIAL_STATE = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    inline uint32_t rotr(uint32_t x, unsigned n) noexcept {
+      return (x >> n) | (x << (32 - n));
+    }
+
+    inline uint32_t loadBigEndian32(const uint8_t* p) noexcept {
+      return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[2]) << 8) | p[3];
+    }
+
+    inline void storeBigEndian32(uint8_t* p, uint32_t value) noexcept {
+      p[0] = static_cast<uint8_t>(value >> 24);
+      p[1] = static_cast<uint8_t>(value >> 16);
+      p[2] = static_cast<uint8_t>(value >> 8);
+      p[3] = static_cast<uint8_t>(value);
+    }
+  } // namespace
+
+  Sha256::Sha256() noexcept: _state(INITIAL_STATE) {}
+
+  Sha256::~Sha256() {
+    secureWipe(_state.data(), sizeof(_state));
+    secureWipe(_buffer.data(), _buffer.size());
+  }
+
+  Sha256& Sha256::update(ByteView data) noexcept {
+    const uint8_t* p = data.data();
+    size_t remaining = data.size();
+    _length += remaining;
+
+    if (_buffered > 0) {
+      size_t take = std::min(remaining, _buffer.size() - _buffered);
+      std::memcpy(_buffer.data() + _buffered, p, take);
+      _buffered += take;
+      p += take;
+      remaining -= take;
+      if (_buffered < _buffer.size()) {
+        return *this;
+      }
+      compress(_buffer.data());
+      _buffered = 0;
+    }
+    for (; remaining >= _buffer.size(); p += _buffer.size(), remaining -= _buffer.size()) {
+      compress(p);
+    }
+    if (remaining > 0) {
+      std::memcpy(_buffer.data(), p, remaining);
+      _buffered = remaining;
+    }
+    return *this;
+  }
+
+  Sha256::Digest Sha256::finish() noexcept {
+    uint64_t bitLength = _length * 8;
+    _buffer[_buffered++] = 0x80;
+    if (_buffered > _buffer.size() - 8) {
+      std::memset(_buffer.data() + _buffered, 0, _buffer.size() - _buffered);
+      compress(_buffer.data());
+      _buffered = 0;
+    }
+    std::memset(_buffer.data() + _buffered, 0, _buffer.size() - 8 - _buffered);
+    storeBigEndian32(_buffer.data() + _buffer.size() - 8, static_cast<uint32_t>(bitLength >> 32));
+    storeBigEndian32(_buffer.data() + _buffer.size() - 4, static_cast<uint32_t>(bitLength));
+    compress(_buffer.data());
+
+    Digest digest;
+    for (size_t i = 0; i < _state.size(); i++) {
+      storeBigEndian32(digest.data() + i * 4, _state[i]);
+    }
+    return digest;
+  }
+
+  void Sha256::compress(const uint8_t* block) noexcept {
+    std::array<uint32_t, 64> w;
+    for (int i = 0; i < 16; i++) {
+      w[i] = loadBigEndian32(block + i * 4);
+    }
+    for (int i = 16; i < 64; i++) {
+      uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+      uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+    uint32_t e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+    for (int i = 0; i < 64; i++) {
+      uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+      uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+    _state[0] += a;
+    _state[1] += b;
+    _state[2] += c;
+    _state[3] += d;
+    _state[4] += e;
+    _state[5] += f;
+    _state[6] += g;
+    _state[7] += h;
+    secureWipe(w.data(), sizeof(w));
+  }
+
+} // namespace espprov::crypto
@@ -0,0 +1,46 @@
+///
+/// Sha256.hpp
+/// SHA-256 (FIPS 180-4), which Sec1 derives its key mask from.
+///
+
+#pragma once
+
+#include "core/Bytes.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace espprov::crypto {
+
+  class Sha256 {
+  public:
+    static constexpr size_t DIGEST_SIZE = 32;
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;
+
+    Sha256() noexcept;
+    ~Sha256();
+
+    Sha256& update(ByteView data) noexcept;
+    Digest finish() noexcept;
+
+    /**
+     * Hashes the concatenation of `parts`.
+     */
+    template <typename... Parts>
+    static Digest hash(const Parts&... parts) noexcept {
+      Sha256 sha;
+      (sha.update(ByteView(parts)), ...);
+      return sha.finish();
+    }
+
+  private:
+    void compress(const uint8_t* block) noexcept;
+
+  private:
+    std::array<uint32_t, 8> _state;
+    std::array<uint8_t, 64> _buffer{};
+    size_t _buffered = 0;
+    uint64_t _length = 0;
+  };
+
+} // namespace espprov::crypto
@@ -0,0 +1,46 @@
+///
+/// Sha512.hpp
+/// SHA-512 (FIPS 180-4), the hash Sec2's SRP6a handshake is built on.
+///
+
+#pragma once
+
+#include "core/Bytes.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace espprov::crypto {
+
+  class Sha512 {
+  public:
+    static constexpr size_t DIGEST_SIZE = 64;
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;
+
+    Sha512() noexcept;
+    ~Sha512();
+
+    Sha512& update(ByteView data) noexcept;
+    Digest finish() noexcept;
+
+    /**
+     * Hashes the concatenation of `parts`.
+     */
+    template <typename... Parts>
+    static Digest hash(const Parts&... parts) noexcept {
+      Sha512 sha;
+      (sha.update(ByteView(parts)), ...);
+      return sha.finish();
+    }
+
+  private:
+    void compress(const uint8_t* block) noexcept;
+
+  private:
+    std::array<uint64_t, 8> _state;
+    std::array<uint8_t, 128> _buffer{};
+    size_t _buffered = 0;
+    uint64_t _length = 0;
+  };
+
+} // namespace espprov::crypto
@@ -0,0 +1,180 @@
+///
+/// X25519.cpp
+/// Curve25519 Diffie-Hellman (RFC 7748), the key agreement of Sec1.
+///
+/// Field elements are sixteen signed 16-bit limbs in 64-bit integers, after TweetNaCl: plain
+/// C++ on every ABI, and every step, including the ladder's conditional swaps, runs in constant time.
+///
+
+#include "X25519.hpp"
+#include "Random.hpp"
+#include "SecureWipe.hpp"
+
+namespace espprov::crypto {
+
+  namespace {
+    using Field = std::array<int64_t, 16>;
+
+    constexpr Field A24 = {0xdb41, 1}; // (486662 - 2) / 4
+
+    /// Carries every limb into the next one, folding the top carry back as 2^256 = 38.
+    void carry(Field& o) noexcept {
+      for (size_t i = 0; i < 16; i++) {
+        o[i] += int64_t(1) << 16;
+        int64_t c = o[i] >> 16;
+        if (i < 15) {
+          o[i + 1] += c - 1;
+        } else {
+          o[0] += 38 * (c - 1);
+        }
+        o[i] -= c << 16;
+      }
+    }
+
+    /// Swaps p and q if `swap` is 1, without branching on it.
+    void conditionalSwap(Field& p, Field& q, int64_t swap) noexcept {
+      int64_t mask = ~(swap - 1);
+      for (size_t i = 0; i < 16; i++) {
+        int64_t t = mask & (p[i] ^ q[i]);
+        p[i] ^= t;
+        q[i] ^= t;
+      }
+    }
+
+    /// Fully reduces modulo 2^255 - 19 and writes 32 little endian bytes.
+    void pack(uint8_t* out, const Field& n) noexcept {
+      Field t = n;
+      Field m;
+      carry(t);
+      carry(t);
+      carry(t);
+      for (int pass = 0; pass < 2; pass++) {
+        m[0] = t[0] - 0xffed;
+        for (size_t i = 1; i < 15; i++) {
+          m[i] = t[i] - 0xffff - ((m[i - 1] >> 16) & 1);
+          m[i - 1] &= 0xffff;
+        }
+        m[15] = t[15] - 0x7fff - ((m[14] >> 16) & 1);
+        int64_t borrow = (m[15] >> 16) & 1;
+        m[14] &= 0xffff;
+        conditionalSwap(t, m, 1 - borrow);
+      }
+      for (size_t i = 0; i < 16; i++) {
+        out[2 * i] = static_cast<uint8_t>(t[i]);
+        out[2 * i + 1] = static_cast<uint8_t>(t[i] >> 8);
+      }
+    }
+
+    void unpack(Field& o, const uint8_t* in) noexcept {
+      for (size_t i = 0; i < 16; i++) {
+        o[i] = in[2 * i] + (int64_t(in[2 * i + 1]) << 8);
+      }
+      o[15] &= 0x7fff;
+    }
+
+    inline void add(Field& o, const Field& a, const Field& b) noexcept {
+      for (size_t i = 0; i < 16; i++) {
+        o[i] = a[i] + b[i];
+      }
+    }
+
+    inline void sub(Field& o, const Field& a, const Field& b) noexcept {
+      for (size_t i = 0; i < 16; i++) {
+        o[i] = a[i] - b[i];
+      }
+    }
+
+    void mul(Field& o, const Field& a, const Field& b) noexcept {
+      std::array<int64_t, 31> t{};
+      for (size_t i = 0; i < 16; i++) {
+        for (size_t j = 0; j < 16; j++) {
+          t[i + j] += a[i] * b[j];
+        }
+      }
+      for (size_t i = 0; i < 15; i++) {
+        t[i] += 38 * t[i + 16];
+      }
+      for (size_t i = 0; i < 16; i++) {
+        o[i] = t[i];
+      }
+      carry(o);
+      carry(o);
+    }
+
+    inline void square(Field& o, const Field& a) noexcept {
+      mul(o, a, a);
+    }
+
+    /// a^(p - 2), by the fixed addition chain of p - 2 = 2^255 - 21.
+    void invert(Field& o, const Field& a) noexcept {
+      Field c = a;
+      for (int bit = 253; bit >= 0; bit--) {
+        square(c, c);
+        if (bit != 2 && bit != 4) {
+          mul(c, c, a);
+        }
+      }
+      o = c;
+    }
+  } // namespace
+
+  X25519::Key X25519::generatePrivateKey() {
+    Key key;
+    randomBytes(key.data(), key.size());
+    return key;
+  }
+
+  X25519::Key X25519::publicKey(const Key& privateKey) noexcept {
+    Key basePoint{9};
+    return scalarMult(privateKey, basePoint);
+  }
+
+  X25519::Key X25519::scalarMult(const Key& privateKey, const Key& point) noexcept {
+    Key scalar = privateKey;
+    scalar[31] = (scalar[31] & 127) | 64;
+    scalar[0] &= 248;
+
+    // Montgomery ladder over (x2 : z2) = a / c and (x3 : z3) = b / d
+    Field x;
+    unpack(x, point.data());
+    Field a{}, b = x, c{}, d{}, e, f;
+    a[0] = 1;
+    d[0] = 1;
+    for (int i = 254; i >= 0; i--) {
+      int64_t bit = (scalar[i >> 3] >> (i & 7)) & 1;
+      conditionalSwap(a, b, bit);
+      conditionalSwap(c, d, bit);
+      add(e, a, c);
+      sub(a, a, c);
+      add(c, b, d);
+      sub(b, b, d);
+      square(d, e);
+      square(f, a);
+      mul(a, c, a);
+      mul(c, b, e);
+      add(e, a, c);
+      sub(a, a, c);
+      square(b, a);
+      sub(c, d, f);
+      mul(a, c, A24);
+      add(a, a, d);
+      mul(c, c, a);
+      mul(a, d, f);
+      mul(d, b, x);
+      square(b, e);
+      conditionalSwap(a, b, bit);
+      conditionalSwap(c, d, bit);
+    }
+    invert(c, c);
+    mul(a, a, c);
+
+    Key out;
+    pack(out.data(), a);
+    secureWipe(scalar.data(), scalar.size());
+    for (Field* field : {&a, &b, &c, &d, &e, &f}) {
+      secureWipe(field->data(), sizeof(Field));
+    }
+    return out;
+  }
+
+} // namespace espprov::crypto
@@ -0,0 +1,39 @@
+///
+/// X25519.hpp
+/// Curve25519 Diffie-Hellman (RFC 7748), the key agreement of Sec1.
+///
+
+#pragma once
+
+#include "core/Bytes.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace espprov::crypto {
+
+  class X25519 {
+  public:
+    static constexpr size_t KEY_SIZE = 32;
+    using Key = std::array<uint8_t, KEY_SIZE>;
+
+    X25519() = delete;
+
+    /**
+     * A fresh private key from the system CSPRNG. Clamping happens inside `scalarMult`.
+     */
+    static Key generatePrivateKey();
+
+    /**
+     * `privateKey * 9`, the public key to send to the peer.
+     */
+    static Key publicKey(const Key& privateKey) noexcept;
+
+    /**
+     * `privateKey * peerPublicKey`. The result is all zeros for a low order peer point; callers
+     * must reject that.
+     */
+    static Key scalarMult(const Key& privateKey, const Key& point) noexcept;
+  };
+
+} // namespace espprov::crypto
@@ -0,0 +1,610 @@
+///
+/// Messages.cpp
+/// The ESP-IDF provisioning protobuf schemas (constants, session, sec0/1/2, wifi_scan, wifi_config).
+///
+
+#include "Messages.hpp"
+#include "ProtoWire.hpp"
+
+namespace espprov::proto {
+
+  namespace {
+    constexpr uint32_t kSecurityBodyFieldBase = 20;
+    constexpr uint32_t kSessionPayloadFieldBase = 10;
+    constexpr uint32_t kWifiBodyFieldBase = 10;
+
+    Bytes copy(ByteView view) {
+      return Bytes(view.begin(), view.end());
+    }
+
+    /// Encodes a view with a single allocation of exactly the encoded size.
+    template <typename Message>
+    Bytes encodeOwned(const Message& message) {
+      Bytes output(encodedSize(message));
+      encodeInto(message, output);
+      return output;
+    }
+
+    size_t securityPayloadSize(uint32_t msg, size_t bodySize) noexcept {
+      return wire::uint32Size(1, msg) + wire::messageSize(kSecurityBodyFieldBase + msg, bodySize);
+    }
+
+    WifiConnectedStateView decodeConnectedState(ByteView encoded) {
+      WifiConnectedStateView connected;
+      ProtoReader reader(encoded);
+      ProtoField field;
+      while (reader.next(field)) {
+        switch (field.number) {
+          case 1: connected.ip4Addr = asString(field.bytes); break;
+          case 2: connected.authMode = static_cast<WifiAuthMode>(field.asUInt32()); break;
+          case 3: connected.ssid = field.bytes; break;
+          case 4: connected.bssid = field.bytes; break;
+          case 5: connected.channel = field.asInt32(); break;
+          default: break;
+        }
+      }
+      return connected;
+    }
+
+    Bytes encodeStatusOnly(Status status) {
+      ProtoWriter writer;
+      writer.writeEnum(1, static_cast<uint32_t>(status));
+      return writer.take();
+    }
+
+    Status decodeStatusOnly(ByteView encoded) {
+      Status status = Status::SUCCESS;
+      ProtoReader reader(encoded);
+      ProtoField field;
+      while (reader.next(field)) {
+        if (field.number == 1) {
+          status = static_cast<Status>(field.asUInt32());
+        }
+      }
+      return status;
+    }
+  } // namespace
+
+  // pragma MARK: session.proto
+
+  Bytes encodeSessionData(const SessionData& data) {
+    return encodeOwned(SessionDataView{.secVer = data.secVer, .msg = data.msg, .body = data.body});
+  }
+
+  SessionData decodeSessionData(ByteView encoded) {
+    SessionDataView view = decodeSessionDataView(encoded);
+    return SessionData{.secVer = view.secVer, .msg = view.msg, .body = copy(view.body)};
+  }
+
+  size_t encodedSize(const SessionDataView& data) noexcept {
+    uint32_t secVer = static_cast<uint32_t>(data.secVer);
+    return wire::uint32Size(2, secVer) +
+           wire::messageSize(kSessionPayloadFieldBase + secVer, securityPayloadSize(data.msg, data.body.size()));
+  }
+
+  size_t encodeInto(const SessionDataView& data, MutableByteView output) {
+    uint32_t secVer = static_cast<uint32_t>(data.secVer);
+    ProtoSpanWriter writer(output);
+    writer.writeEnum(2, secVer);
+    writer.beginMessage(kSessionPayloadFieldBase + secVer, securityPayloadSize(data.msg, data.body.size()));
+    writer.writeEnum(1, data.msg);
+    writer.writeMessage(kSecurityBodyFieldBase + data.msg, data.body);
+    return writer.size();
+  }
+
+  SessionDataView decodeSessionDataView(ByteView encoded) {
+    SessionDataView data;
+    ByteView payload;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      if (field.number == 2) {
+        data.secVer = static_cast<SecSchemeVersion>(field.asUInt32());
+      } else if (field.number >= kSessionPayloadFieldBase && field.number <= kSessionPayloadFieldBase + 2) {
+        payload = field.bytes;
+      }
+    }
+    ProtoReader payloadReader(payload);
+    while (payloadReader.next(field)) {
+      if (field.number == 1) {
+        data.msg = field.asUInt32();
+      } else if (field.number >= kSecurityBodyFieldBase) {
+        data.body = field.bytes;
+      }
+    }
+    return data;
+  }
+
+  // pragma MARK: sec0.proto
+
+  Bytes encodeS0SessionResp(const S0SessionResp& message) {
+    return encodeStatusOnly(message.status);
+  }
+
+  S0SessionResp decodeS0SessionResp(ByteView encoded) {
+    return S0SessionResp{decodeStatusOnly(encoded)};
+  }
+
+  // pragma MARK: sec1.proto
+
+  Bytes encodeSec1SessionCmd0(const Sec1SessionCmd0& message) {
+    ProtoWriter writer;
+    writer.writeBytes(1, message.clientPubkey);
+    return writer.take();
+  }
+
+  Sec1SessionCmd0 decodeSec1SessionCmd0(ByteView encoded) {
+    Sec1SessionCmd0 message;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      if (field.number == 1) {
+        message.clientPubkey = copy(field.bytes);
+      }
+    }
+    return message;
+  }
+
+  Bytes encodeSec1SessionResp0(const Sec1SessionResp0& message) {
+    ProtoWriter writer;
+    writer.writeEnum(1, static_cast<uint32_t>(message.status));
+    writer.writeBytes(2, message.devicePubkey);
+    writer.writeBytes(3, message.deviceRandom);
+    return writer.take();
+  }
+
+  Sec1SessionResp0 decodeSec1SessionResp0(ByteView encoded) {
+    Sec1SessionResp0 message;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      switch (field.number) {
+        case 1: message.status = static_cast<Status>(field.asUInt32()); break;
+        case 2: message.devicePubkey = copy(field.bytes); break;
+        case 3: message.deviceRandom = copy(field.bytes); break;
+        default: break;
+      }
+    }
+    return message;
+  }
+
+  Bytes encodeSec1SessionCmd1(const Sec1SessionCmd1& message) {
+    ProtoWriter writer;
+    writer.writeBytes(2, message.clientVerifyData);
+    return writer.take();
+  }
+
+  Sec1SessionCmd1 decodeSec1SessionCmd1(ByteView encoded) {
+    Sec1SessionCmd1 message;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      if (field.number == 2) {
+        message.clientVerifyData = copy(field.bytes);
+      }
+    }
+    return message;
+  }
+
+  Bytes encodeSec1SessionResp1(const Sec1SessionResp1& message) {
+    ProtoWriter writer;
+    writer.writeEnum(1, static_cast<uint32_t>(message.status));
+    writer.writeBytes(3, message.deviceVerifyData);
+    return writer.take();
+  }
+
+  Sec1SessionResp1 decodeSec1SessionResp1(ByteView encoded) {
+    Sec1SessionResp1 message;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      switch (field.number) {
+        case 1: message.status = static_cast<Status>(field.asUInt32()); break;
+        case 3: message.deviceVerifyData = copy(field.bytes); break;
+        default: break;
+      }
+    }
+    return message;
+  }
+
+  // pragma MARK: sec2.proto
+
+  Bytes encodeSec2SessionCmd0(const Sec2SessionCmd0& message) {
+    ProtoWriter writer;
+    writer.writeBytes(1, message.clientUsername);
+    writer.writeBytes(2, message.clientPubkey);
+    return writer.take();
+  }
+
+  Sec2SessionCmd0 decodeSec2SessionCmd0(ByteView encoded) {
+    Sec2SessionCmd0 message;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      switch (field.number) {
+        case 1: message.clientUsername = copy(field.bytes); break;
+        case 2: message.clientPubkey = copy(field.bytes); break;
+        default: break;
+      }
+    }
+    return message;
+  }
+
+  Bytes encodeSec2SessionResp0(const Sec2SessionResp0& message) {
+    ProtoWriter writer;
+    writer.writeEnum(1, static_cast<uint32_t>(message.status));
+    writer.writeBytes(2, message.devicePubkey);
+    writer.writeBytes(3, message.deviceSalt);
+    return writer.take();
+  }
+
+  Sec2SessionResp0 decodeSec2SessionResp0(ByteView encoded) {
+    Sec2SessionResp0 message;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      switch (field.number) {
+        case 1: message.status = static_cast<Status>(field.asUInt32()); break;
+        case 2: message.devicePubkey = copy(field.bytes); break;
+        case 3: message.deviceSalt = copy(field.bytes); break;
+        default: break;
+      }
+    }
+    return message;
+  }
+
+  Bytes encodeSec2SessionCmd1(const Sec2SessionCmd1& message) {
+    ProtoWriter writer;
+    writer.writeBytes(1, message.clientProof);
+    return writer.take();
+  }
+
+  Sec2SessionCmd1 decodeSec2SessionCmd1(ByteView encoded) {
+    Sec2SessionCmd1 message;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      if (field.number == 1) {
+        message.clientProof = copy(field.bytes);
+      }
+    }
+    return message;
+  }
+
+  Bytes encodeSec2SessionResp1(const Sec2SessionResp1& message) {
+    ProtoWriter writer;
+    writer.writeEnum(1, static_cast<uint32_t>(message.status));
+    writer.writeBytes(2, message.deviceProof);
+    writer.writeBytes(3, message.deviceNonce);
+    return writer.take();
+  }
+
+  Sec2SessionResp1 decodeSec2SessionResp1(ByteView encoded) {
+    Sec2SessionResp1 message;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      switch (field.number) {
+        case 1: message.status = static_cast<Status>(field.asUInt32()); break;
+        case 2: message.deviceProof = copy(field.bytes); break;
+        case 3: message.deviceNonce = copy(field.bytes); break;
+        default: break;
+      }
+    }
+    return message;
+  }
+
+  // pragma MARK: wifi_scan.proto
+
+  Bytes encodeWiFiScanPayload(const WiFiScanPayload& payload) {
+    return encodeOwned(WiFiScanPayloadView{.msg = payload.msg, .status = payload.status, .body = payload.body});
+  }
+
+  WiFiScanPayload decodeWiFiScanPayload(ByteView encoded) {
+    WiFiScanPayloadView view = decodeWiFiScanPayloadView(encoded);
+    return WiFiScanPayload{.msg = view.msg, .status = view.status, .body = copy(view.body)};
+  }
+
+  size_t encodedSize(const WiFiScanPayloadView& payload) noexcept {
+    uint32_t msg = static_cast<uint32_t>(payload.msg);
+    return wire::uint32Size(1, msg) + wire::uint32Size(2, static_cast<uint32_t>(payload.status)) +
+           wire::messageSize(kWifiBodyFieldBase + msg, payload.body.size());
+  }
+
+  size_t encodeInto(const WiFiScanPayloadView& payload, MutableByteView output) {
+    uint32_t msg = static_cast<uint32_t>(payload.msg);
+    ProtoSpanWriter writer(output);
+    writer.writeEnum(1, msg);
+    writer.writeEnum(2, static_cast<uint32_t>(payload.status));
+    writer.writeMessage(kWifiBodyFieldBase + msg, payload.body);
+    return writer.size();
+  }
+
+  WiFiScanPayloadView decodeWiFiScanPayloadView(ByteView encoded) {
+    WiFiScanPayloadView payload;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      if (field.number == 1) {
+        payload.msg = static_cast<WiFiScanMsgType>(field.asUInt32());
+      } else if (field.number == 2) {
+        payload.status = static_cast<Status>(field.asUInt32());
+      } else if (field.number >= kWifiBodyFieldBase) {
+        payload.body = field.bytes;
+      }
+    }
+    return payload;
+  }
+
+  Bytes encodeCmdScanStart(const CmdScanStart& message) {
+    return encodeOwned(message);
+  }
+
+  size_t encodedSize(const CmdScanStart& message) noexcept {
+    return wire::uint32Size(1, message.blocking ? 1 : 0) + wire::uint32Size(2, message.passive ? 1 : 0) +
+           wire::uint32Size(3, message.groupChannels) + wire::uint32Size(4, message.periodMs);
+  }
+
+  size_t encodeInto(const CmdScanStart& message, MutableByteView output) {
+    ProtoSpanWriter writer(output);
+    writer.writeBool(1, message.blocking);
+    writer.writeBool(2, message.passive);
+    writer.writeUInt32(3, message.groupChannels);
+    writer.writeUInt32(4, message.periodMs);
+    return writer.size();
+  }
+
+  CmdScanStart decodeCmdScanStart(ByteView encoded) {
+    CmdScanStart message;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      switch (field.number) {
+        case 1: message.blocking = field.asBool(); break;
+        case 2: message.passive = field.asBool(); break;
+        case 3: message.groupChannels = field.asUInt32(); break;
+        case 4: message.periodMs = field.asUInt32(); break;
+        default: break;
+      }
+    }
+    return message;
+  }
+
+  Bytes encodeRespScanStatus(const RespScanStatus& message) {
+    ProtoWriter writer;
+    writer.writeBool(1, message.scanFinished);
+    writer.writeUInt32(2, message.resultCount);
+    return writer.take();
+  }
+
+  RespScanStatus decodeRespScanStatus(ByteView encoded) {
+    RespScanStatus message;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      switch (field.number) {
+        case 1: message.scanFinished = field.asBool(); break;
+        case 2: message.resultCount = field.asUInt32(); break;
+        default: break;
+      }
+    }
+    return message;
+  }
+
+  Bytes encodeCmdScanResult(const CmdScanResult& message) {
+    return encodeOwned(message);
+  }
+
+  size_t encodedSize(const CmdScanResult& message) noexcept {
+    return wire::uint32Size(1, message.startIndex) + wire::uint32Size(2, message.count);
+  }
+
+  size_t encodeInto(const CmdScanResult& message, MutableByteView output) {
+    ProtoSpanWriter writer(output);
+    writer.writeUInt32(1, message.startIndex);
+    writer.writeUInt32(2, message.count);
+    return writer.size();
+  }
+
+  CmdScanResult decodeCmdScanResult(ByteView encoded) {
+    CmdScanResult message;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      switch (field.number) {
+        case 1: message.startIndex = field.asUInt32(); break;
+        case 2: message.count = field.asUInt32(); break;
+        default: break;
+      }
+    }
+    return message;
+  }
+
+  Bytes encodeRespScanResult(const RespScanResult& message) {
+    ProtoWriter writer;
+    for (const auto& entry : message.entries) {
+      ProtoWriter entryWriter;
+      entryWriter.writeBytes(1, entry.ssid);
+      entryWriter.writeUInt32(2, entry.channel);
+      entryWriter.writeInt32(3, entry.rssi);
+      entryWriter.writeBytes(4, entry.bssid);
+      entryWriter.writeEnum(5, static_cast<uint32_t>(entry.auth));
+      writer.writeMessage(1, entryWriter.bytes());
+    }
+    return writer.take();
+  }
+
+  RespScanResult decodeRespScanResult(ByteView encoded) {
+    RespScanResult message;
+    ScanResultReader reader(encoded);
+    WiFiScanResultView entry;
+    while (reader.next(entry)) {
+      message.entries.push_back(WiFiScanResult{
+          .ssid = copy(entry.ssid),
+          .channel = entry.channel,
+          .rssi = entry.rssi,
+          .bssid = copy(entry.bssid),
+          .auth = entry.auth,
+      });
+    }
+    return message;
+  }
+
+  bool ScanResultReader::next(WiFiScanResultView& entry) {
+    ProtoField field;
+    do {
+      if (!_reader.next(field)) {
+        return false;
+      }
+    } while (field.number != 1);
+
+    entry = WiFiScanResultView{};
+    ProtoReader entryReader(field.bytes);
+    ProtoField entryField;
+    while (entryReader.next(entryField)) {
+      switch (entryField.number) {
+        case 1: entry.ssid = entryField.bytes; break;
+        case 2: entry.channel = entryField.asUInt32(); break;
+        case 3: entry.rssi = entryField.asInt32(); break;
+        case 4: entry.bssid = entryField.bytes; break;
+        case 5: entry.auth = static_cast<WifiAuthMode>(entryField.asUInt32()); break;
+        default: break;
+      }
+    }
+    return true;
+  }
+
+  // pragma MARK: wifi_config.proto
+
+  Bytes encodeWiFiConfigPayload(const WiFiConfigPayload& payload) {
+    return encodeOwned(WiFiConfigPayloadView{.msg = payload.msg, .body = payload.body});
+  }
+
+  WiFiConfigPayload decodeWiFiConfigPayload(ByteView encoded) {
+    WiFiConfigPayloadView view = decodeWiFiConfigPayloadView(encoded);
+    return WiFiConfigPayload{.msg = view.msg, .body = copy(view.body)};
+  }
+
+  Bytes encodeRespGetStatus(const RespGetStatus& message) {
+    ProtoWriter writer;
+    writer.writeEnum(1, static_cast<uint32_t>(message.status));
+    writer.writeEnum(2, static_cast<uint32_t>(message.staState));
+    if (message.failReason.has_value()) {
+      writer.writeOneofEnum(10, static_cast<uint32_t>(message.failReason.value()));
+    }
+    if (message.connected.has_value()) {
+      const auto& connected = message.connected.value();
+      ProtoWriter stateWriter;
+      stateWriter.writeString(1, connected.ip4Addr);
+      stateWriter.writeEnum(2, static_cast<uint32_t>(connected.authMode));
+      stateWriter.writeBytes(3, connected.ssid);
+      stateWriter.writeBytes(4, connected.bssid);
+      stateWriter.writeInt32(5, connected.channel);
+      writer.writeMessage(11, stateWriter.bytes());
+    }
+    return writer.take();
+  }
+
+  RespGetStatus decodeRespGetStatus(ByteView encoded) {
+    RespGetStatusView view = decodeRespGetStatusView(encoded);
+    RespGetStatus message{.status = view.status, .staState = view.staState, .failReason = view.failReason, .connected = {}};
+    if (view.connected.has_value()) {
+      const WifiConnectedStateView& connected = view.connected.value();
+      message.connected = WifiConnectedState{
+          .ip4Addr = std::string(connected.ip4Addr),
+          .authMode = connected.authMode,
+          .ssid = copy(connected.ssid),
+          .bssid = copy(connected.bssid),
+          .channel = connected.channel,
+      };
+    }
+    return message;
+  }
+
+  Bytes encodeCmdSetConfig(const CmdSetConfig& message) {
+    return encodeOwned(
+        CmdSetConfigView{.ssid = message.ssid, .passphrase = message.passphrase, .bssid = message.bssid, .channel = message.channel});
+  }
+
+  CmdSetConfig decodeCmdSetConfig(ByteView encoded) {
+    CmdSetConfig message;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      switch (field.number) {
+        case 1: message.ssid = copy(field.bytes); break;
+        case 2: message.passphrase = copy(field.bytes); break;
+        case 3: message.bssid = copy(field.bytes); break;
+        case 4: message.channel = field.asInt32(); break;
+        default: break;
+      }
+    }
+    return message;
+  }
+
+  Bytes encodeRespConfigStatus(const RespConfigStatus& message) {
+    return encodeStatusOnly(message.status);
+  }
+
+  RespConfigStatus decodeRespConfigStatus(ByteView encoded) {
+    return RespConfigStatus{decodeStatusOnly(encoded)};
+  }
+
+  size_t encodedSize(const WiFiConfigPayloadView& payload) noexcept {
+    uint32_t msg = static_cast<uint32_t>(payload.msg);
+    return wire::uint32Size(1, msg) + wire::messageSize(kWifiBodyFieldBase + msg, payload.body.size());
+  }
+
+  size_t encodeInto(const WiFiConfigPayloadView& payload, MutableByteView output) {
+    uint32_t msg = static_cast<uint32_t>(payload.msg);
+    ProtoSpanWriter writer(output);
+    writer.writeEnum(1, msg);
+    writer.writeMessage(kWifiBodyFieldBase + msg, payload.body);
+    return writer.size();
+  }
+
+  WiFiConfigPayloadView decodeWiFiConfigPayloadView(ByteView encoded) {
+    WiFiConfigPayloadView payload;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      if (field.number == 1) {
+        payload.msg = static_cast<WiFiConfigMsgType>(field.asUInt32());
+      } else if (field.number >= kWifiBodyFieldBase) {
+        payload.body = field.bytes;
+      }
+    }
+    return payload;
+  }
+
+  RespGetStatusView decodeRespGetStatusView(ByteView encoded) {
+    RespGetStatusView message;
+    ProtoReader reader(encoded);
+    ProtoField field;
+    while (reader.next(field)) {
+      switch (field.number) {
+        case 1: message.status = static_cast<Status>(field.asUInt32()); break;
+        case 2: message.staState = static_cast<WifiStationState>(field.asUInt32()); break;
+        case 10: message.failReason = static_cast<WifiConnectFailedReason>(field.asUInt32()); break;
+        case 11: message.connected = decodeConnectedState(field.bytes); break;
+        default: break;
+      }
+    }
+    return message;
+  }
+
+  size_t encodedSize(const CmdSetConfigView& message) noexcept {
+    return wire::bytesSize(1, message.ssid.size()) + wire::bytesSize(2, message.passphrase.size()) +
+           wire::bytesSize(3, message.bssid.size()) + wire::int32Size(4, message.channel);
+  }
+
+  size_t encodeInto(const CmdSetConfigView& message, MutableByteView output) {
+    ProtoSpanWriter writer(output);
+    writer.writeBytes(1, message.ssid);
+    writer.writeBytes(2, message.passphrase);
+    writer.writeBytes(3, message.bssid);
+    writer.writeInt32(4, message.channel);
+    return writer.size();
+  }
+
+} // namespace espprov::proto
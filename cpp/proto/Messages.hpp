@@ -0,0 +1,357 @@
+///
+/// Messages.hpp
+/// The ESP-IDF provisioning protobuf schemas (constants, session, sec0/1/2, wifi_scan, wifi_config).
+///
+
+#pragma once
+
+#include "ProtoWire.hpp"
+#include "core/Bytes.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace espprov::proto {
+
+  // pragma MARK: constants.proto
+
+  enum class Status : uint32_t {
+    SUCCESS = 0,
+    INVALID_SEC_SCHEME = 1,
+    INVALID_PROTO = 2,
+    TOO_MANY_SESSIONS = 3,
+    INVALID_ARGUMENT = 4,
+    INTERNAL_ERROR = 5,
+    CRYPTO_ERROR = 6,
+    INVALID_SESSION = 7,
+  };
+
+  // pragma MARK: session.proto
+
+  enum class SecSchemeVersion : uint32_t {
+    SEC_SCHEME_0 = 0,
+    SEC_SCHEME_1 = 1,
+    SEC_SCHEME_2 = 2,
+  };
+
+  /*
+   * Besides the owning structs, the messages exchanged on every request have `...View` variants.
+   * Their decoders point into the encoded input, which must outlive the view, and their encoders
+   * write into a caller provided buffer of at least `encodedSize()` bytes. Neither allocates.
+   */
+
+  /**
+   * `SessionData` together with its `SecXPayload`.
+   * All three security payloads share the same layout: a `msg` type (field 1) and exactly one
+   * command/response sub message whose field number is `20 + msg`, so they are handled generically.
+   */
+  struct SessionData {
+    SecSchemeVersion secVer = SecSchemeVersion::SEC_SCHEME_0;
+    uint32_t msg = 0;
+    Bytes body;
+  };
+
+  struct SessionDataView {
+    SecSchemeVersion secVer = SecSchemeVersion::SEC_SCHEME_0;
+    uint32_t msg = 0;
+    ByteView body;
+  };
+
+  Bytes encodeSessionData(const SessionData& data);
+  SessionData decodeSessionData(ByteView encoded);
+  size_t encodedSize(const SessionDataView& data) noexcept;
+  size_t encodeInto(const SessionDataView& data, MutableByteView output);
+  SessionDataView decodeSessionDataView(ByteView encoded);
+
+  // pragma MARK: sec0.proto
+
+  enum class Sec0MsgType : uint32_t {
+    S0_SESSION_COMMAND = 0,
+    S0_SESSION_RESPONSE = 1,
+  };
+
+  struct S0SessionResp {
+    Status status = Status::SUCCESS;
+  };
+
+  Bytes encodeS0SessionResp(const S0SessionResp& message);
+  S0SessionResp decodeS0SessionResp(ByteView encoded);
+
+  // pragma MARK: sec1.proto
+
+  enum class Sec1MsgType : uint32_t {
+    SESSION_COMMAND_0 = 0,
+    SESSION_RESPONSE_0 = 1,
+    SESSION_COMMAND_1 = 2,
+    SESSION_RESPONSE_1 = 3,
+  };
+
+  struct Sec1SessionCmd0 {
+    Bytes clientPubkey;
+  };
+  struct Sec1SessionResp0 {
+    Status status = Status::SUCCESS;
+    Bytes devicePubkey;
+    Bytes deviceRandom;
+  };
+  struct Sec1SessionCmd1 {
+    Bytes clientVerifyData;
+  };
+  struct Sec1SessionResp1 {
+    Status status = Status::SUCCESS;
+    Bytes deviceVerifyData;
+  };
+
+  Bytes encodeSec1SessionCmd0(const Sec1SessionCmd0& message);
+  Sec1SessionCmd0 decodeSec1SessionCmd0(ByteView encoded);
+  Bytes encodeSec1SessionResp0(const Sec1SessionResp0& message);
+  Sec1SessionResp0 decodeSec1SessionResp0(ByteView encoded);
+  Bytes encodeSec1SessionCmd1(const Sec1SessionCmd1& message);
+  Sec1SessionCmd1 decodeSec1SessionCmd1(ByteView encoded);
+  Bytes encodeSec1SessionResp1(const Sec1SessionResp1& message);
+  Sec1SessionResp1 decodeSec1SessionResp1(ByteView encoded);
+
+  // pragma MARK: sec2.proto
+
+  enum class Sec2MsgType : uint32_t {
+    S2_SESSION_COMMAND_0 = 0,
+    S2_SESSION_RESPONSE_0 = 1,
+    S2_SESSION_COMMAND_1 = 2,
+    S2_SESSION_RESPONSE_1 = 3,
+  };
+
+  struct Sec2SessionCmd0 {
+    Bytes clientUsername;
+    Bytes clientPubkey;
+  };
+  struct Sec2SessionResp0 {
+    Status status = Status::SUCCESS;
+    Bytes devicePubkey;
+    Bytes deviceSalt;
+  };
+  struct Sec2SessionCmd1 {
+    Bytes clientProof;
+  };
+  struct Sec2SessionResp1 {
+    Status status = Status::SUCCESS;
+    Bytes deviceProof;
+    Bytes deviceNonce;
+  };
+
+  Bytes encodeSec2SessionCmd0(const Sec2SessionCmd0& message);
+  Sec2SessionCmd0 decodeSec2SessionCmd0(ByteView encoded);
+  Bytes encodeSec2SessionResp0(const Sec2SessionResp0& message);
+  Sec2SessionResp0 decodeSec2SessionResp0(ByteView encoded);
+  Bytes encodeSec2SessionCmd1(const Sec2SessionCmd1& message);
+  Sec2SessionCmd1 decodeSec2SessionCmd1(ByteView encoded);
+  Bytes encodeSec2SessionResp1(const Sec2SessionResp1& message);
+  Sec2SessionResp1 decodeSec2SessionResp1(ByteView encoded);
+
+  // pragma MARK: wifi_constants.proto
+
+  enum class WifiStationState : uint32_t {
+    CONNECTED = 0,
+    CONNECTING = 1,
+    DISCONNECTED = 2,
+    CONNECTION_FAILED = 3,
+  };
+
+  enum class WifiConnectFailedReason : uint32_t {
+    AUTH_ERROR = 0,
+    NETWORK_NOT_FOUND = 1,
+  };
+
+  enum class WifiAuthMode : uint32_t {
+    OPEN = 0,
+    WEP = 1,
+    WPA_PSK = 2,
+    WPA2_PSK = 3,
+    WPA_WPA2_PSK = 4,
+    WPA2_ENTERPRISE = 5,
+    WPA3_PSK = 6,
+    WPA2_WPA3_PSK = 7,
+  };
+
+  struct WifiConnectedState {
+    std::string ip4Addr;
+    WifiAuthMode authMode = WifiAuthMode::OPEN;
+    Bytes ssid;
+    Bytes bssid;
+    int32_t channel = 0;
+  };
+
+  // pragma MARK: wifi_scan.proto
+
+  enum class WiFiScanMsgType : uint32_t {
+    TYPE_CMD_SCAN_START = 0,
+    TYPE_RESP_SCAN_START = 1,
+    TYPE_CMD_SCAN_STATUS = 2,
+    TYPE_RESP_SCAN_STATUS = 3,
+    TYPE_CMD_SCAN_RESULT = 4,
+    TYPE_RESP_SCAN_RESULT = 5,
+  };
+
+  /**
+   * `WiFiScanPayload`. The sub message sits in field `10 + msg`.
+   */
+  struct WiFiScanPayload {
+    WiFiScanMsgType msg = WiFiScanMsgType::TYPE_CMD_SCAN_START;
+    Status status = Status::SUCCESS;
+    Bytes body;
+  };
+
+  struct CmdScanStart {
+    bool blocking = false;
+    bool passive = false;
+    uint32_t groupChannels = 0;
+    uint32_t periodMs = 0;
+  };
+  struct RespScanStatus {
+    bool scanFinished = false;
+    uint32_t resultCount = 0;
+  };
+  struct CmdScanResult {
+    uint32_t startIndex = 0;
+    uint32_t count = 0;
+  };
+  struct WiFiScanResult {
+    Bytes ssid;
+    uint32_t channel = 0;
+    int32_t rssi = 0;
+    Bytes bssid;
+    WifiAuthMode auth = WifiAuthMode::OPEN;
+  };
+  struct RespScanResult {
+    std::vector<WiFiScanResult> entries;
+  };
+
+  struct WiFiScanPayloadView {
+    WiFiScanMsgType msg = WiFiScanMsgType::TYPE_CMD_SCAN_START;
+    Status status = Status::SUCCESS;
+    ByteView body;
+  };
+  struct WiFiScanResultView {
+    ByteView ssid;
+    uint32_t channel = 0;
+    int32_t rssi = 0;
+    ByteView bssid;
+    WifiAuthMode auth = WifiAuthMode::OPEN;
+  };
+
+  /**
+   * Iterates over the entries of an encoded `RespScanResult` without collecting them.
+   * Throws `ProtocommError` on malformed input.
+   */
+  class ScanResultReader {
+  public:
+    explicit ScanResultReader(ByteView encoded) noexcept: _reader(encoded) {}
+
+    /**
+     * Decodes the next entry into `entry`. Returns `false` once all entries were read.
+     */
+    bool next(WiFiScanResultView& entry);
+
+  private:
+    ProtoReader _reader;
+  };
+
+  Bytes encodeWiFiScanPayload(const WiFiScanPayload& payload);
+  WiFiScanPayload decodeWiFiScanPayload(ByteView encoded);
+  Bytes encodeCmdScanStart(const CmdScanStart& message);
+  CmdScanStart decodeCmdScanStart(ByteView encoded);
+  Bytes encodeRespScanStatus(const RespScanStatus& message);
+  RespScanStatus decodeRespScanStatus(ByteView encoded);
+  Bytes encodeCmdScanResult(const CmdScanResult& message);
+  CmdScanResult decodeCmdScanResult(ByteView encoded);
+  Bytes encodeRespScanResult(const RespScanResult& message);
+  RespScanResult decodeRespScanResult(ByteView encoded);
+
+  size_t encodedSize(const WiFiScanPayloadView& payload) noexcept;
+  size_t encodeInto(const WiFiScanPayloadView& payload, MutableByteView output);
+  WiFiScanPayloadView decodeWiFiScanPayloadView(ByteView encoded);
+  size_t encodedSize(const CmdScanStart& message) noexcept;
+  size_t encodeInto(const CmdScanStart& message, MutableByteView output);
+  size_t encodedSize(const CmdScanResult& message) noexcept;
+  size_t encodeInto(const CmdScanResult& message, MutableByteView output);
+
+  // pragma MARK: wifi_config.proto
+
+  enum class WiFiConfigMsgType : uint32_t {
+    TYPE_CMD_GET_STATUS = 0,
+    TYPE_RESP_GET_STATUS = 1,
+    TYPE_CMD_SET_CONFIG = 2,
+    TYPE_RESP_SET_CONFIG = 3,
+    TYPE_CMD_APPLY_CONFIG = 4,
+    TYPE_RESP_APPLY_CONFIG = 5,
+  };
+
+  /**
+   * `WiFiConfigPayload`. The sub message sits in field `10 + msg`.
+   */
+  struct WiFiConfigPayload {
+    WiFiConfigMsgType msg = WiFiConfigMsgType::TYPE_CMD_GET_STATUS;
+    Bytes body;
+  };
+
+  struct RespGetStatus {
+    Status status = Status::SUCCESS;
+    WifiStationState staState = WifiStationState::CONNECTED;
+    std::optional<WifiConnectFailedReason> failReason;
+    std::optional<WifiConnectedState> connected;
+  };
+  struct CmdSetConfig {
+    Bytes ssid;
+    Bytes passphrase;
+    Bytes bssid;
+    int32_t channel = 0;
+  };
+  /**
+   * `RespSetConfig` and `RespApplyConfig`, which only carry a status.
+   */
+  struct RespConfigStatus {
+    Status status = Status::SUCCESS;
+  };
+
+  struct WiFiConfigPayloadView {
+    WiFiConfigMsgType msg = WiFiConfigMsgType::TYPE_CMD_GET_STATUS;
+    ByteView body;
+  };
+  struct WifiConnectedStateView {
+    std::string_view ip4Addr;
+    WifiAuthMode authMode = WifiAuthMode::OPEN;
+    ByteView ssid;
+    ByteView bssid;
+    int32_t channel = 0;
+  };
+  struct RespGetStatusView {
+    Status status = Status::SUCCESS;
+    WifiStationState staState = WifiStationState::CONNECTED;
+    std::optional<WifiConnectFailedReason> failReason;
+    std::optional<WifiConnectedStateView> connected;
+  };
+  struct CmdSetConfigView {
+    ByteView ssid;
+    ByteView passphrase;
+    ByteView bssid;
+    int32_t channel = 0;
+  };
+
+  Bytes encodeWiFiConfigPayload(const WiFiConfigPayload& payload);
+  WiFiConfigPayload decodeWiFiConfigPayload(ByteView encoded);
+  Bytes encodeRespGetStatus(const RespGetStatus& message);
+  RespGetStatus decodeRespGetStatus(ByteView encoded);
+  Bytes encodeCmdSetConfig(const CmdSetConfig& message);
+  CmdSetConfig decodeCmdSetConfig(ByteView encoded);
+  Bytes encodeRespConfigStatus(const RespConfigStatus& message);
+  RespConfigStatus decodeRespConfigStatus(ByteView encoded);
+
+  size_t encodedSize(const WiFiConfigPayloadView& payload) noexcept;
+  size_t encodeInto(const WiFiConfigPayloadView& payload, MutableByteView output);
+  WiFiConfigPayloadView decodeWiFiConfigPayloadView(ByteView encoded);
+  RespGetStatusView decodeRespGetStatusView(ByteView encoded);
+  size_t encodedSize(const CmdSetConfigView& message) noexcept;
+  size_t encodeInto(const CmdSetConfigView& message, MutableByteView output);
+
+} // namespace espprov::proto
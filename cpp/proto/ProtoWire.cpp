@@ -0,0 +1,204 @@
+///
+/// ProtoWire.cpp
+/// Minimal protobuf wire format reader/writer for the provisioning messages.
+///
+
+#include "ProtoWire.hpp"
+#include "core/Errors.hpp"
+#include <cstring>
+
+namespace espprov::proto {
+
+  void ProtoWriter::writeTag(uint32_t field, WireType type) {
+    writeVarint((static_cast<uint64_t>(field) << 3) | static_cast<uint64_t>(type));
+  }
+
+  void ProtoWriter::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+      _buffer.push_back(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    _buffer.push_back(static_cast<uint8_t>(value));
+  }
+
+  void ProtoWriter::writeUInt32(uint32_t field, uint32_t value) {
+    if (value == 0) {
+      return;
+    }
+    writeTag(field, WireType::VARINT);
+    writeVarint(value);
+  }
+
+  void ProtoWriter::writeInt32(uint32_t field, int32_t value) {
+    if (value == 0) {
+      return;
+    }
+    writeTag(field, WireType::VARINT);
+    // Negative int32 values are sign extended to 64 bits on the wire.
+    writeVarint(static_cast<uint64_t>(static_cast<int64_t>(value)));
+  }
+
+  void ProtoWriter::writeBool(uint32_t field, bool value) {
+    writeUInt32(field, value ? 1 : 0);
+  }
+
+  void ProtoWriter::writeEnum(uint32_t field, uint32_t value) {
+    writeUInt32(field, value);
+  }
+
+  void ProtoWriter::writeOneofEnum(uint32_t field, uint32_t value) {
+    writeTag(field, WireType::VARINT);
+    writeVarint(value);
+  }
+
+  void ProtoWriter::writeBytes(uint32_t field, ByteView value) {
+    if (value.empty()) {
+      return;
+    }
+    writeMessage(field, value);
+  }
+
+  void ProtoWriter::writeString(uint32_t field, std::string_view value) {
+    writeBytes(field, asBytes(value));
+  }
+
+  void ProtoWriter::writeMessage(uint32_t field, ByteView encoded) {
+    writeTag(field, WireType::LENGTH_DELIMITED);
+    writeVarint(encoded.size());
+    _buffer.insert(_buffer.end(), encoded.begin(), encoded.end());
+  }
+
+  void ProtoSpanWriter::reserve(size_t size) {
+    if (size > _output.size() - _offset) {
+      throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Protobuf message does not fit the output buffer");
+    }
+  }
+
+  void ProtoSpanWriter::writeTag(uint32_t field, WireType type) {
+    writeVarint((static_cast<uint64_t>(field) << 3) | static_cast<uint64_t>(type));
+  }
+
+  void ProtoSpanWriter::writeVarint(uint64_t value) {
+    reserve(wire::varintSize(value));
+    while (value >= 0x80) {
+      _output[_offset++] = static_cast<uint8_t>(value | 0x80);
+      value >>= 7;
+    }
+    _output[_offset++] = static_cast<uint8_t>(value);
+  }
+
+  void ProtoSpanWriter::writeRaw(ByteView value) {
+    reserve(value.size());
+    if (!value.empty()) {
+      std::memcpy(_output.data() + _offset, value.data(), value.size());
+      _offset += value.size();
+    }
+  }
+
+  void ProtoSpanWriter::writeUInt32(uint32_t field, uint32_t value) {
+    if (value == 0) {
+      return;
+    }
+    writeTag(field, WireType::VARINT);
+    writeVarint(value);
+  }
+
+  void ProtoSpanWriter::writeInt32(uint32_t field, int32_t value) {
+    if (value == 0) {
+      return;
+    }
+    writeTag(field, WireType::VARINT);
+    writeVarint(static_cast<uint64_t>(static_cast<int64_t>(value)));
+  }
+
+  void ProtoSpanWriter::writeBool(uint32_t field, bool value) {
+    writeUInt32(field, value ? 1 : 0);
+  }
+
+  void ProtoSpanWriter::writeEnum(uint32_t field, uint32_t value) {
+    writeUInt32(field, value);
+  }
+
+  void ProtoSpanWriter::writeOneofEnum(uint32_t field, uint32_t value) {
+    writeTag(field, WireType::VARINT);
+    writeVarint(value);
+  }
+
+  void ProtoSpanWriter::writeBytes(uint32_t field, ByteView value) {
+    if (value.empty()) {
+      return;
+    }
+    writeMessage(field, value);
+  }
+
+  void ProtoSpanWriter::writeString(uint32_t field, std::string_view value) {
+    writeBytes(field, asBytes(value));
+  }
+
+  void ProtoSpanWriter::writeMessage(uint32_t field, ByteView encoded) {
+    beginMessage(field, encoded.size());
+    writeRaw(encoded);
+  }
+
+  void ProtoSpanWriter::beginMessage(uint32_t field, size_t length) {
+    writeTag(field, WireType::LENGTH_DELIMITED);
+    writeVarint(length);
+  }
+
+  uint64_t ProtoReader::readVarint() {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (_offset >= _data.size()) {
+        throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Truncated protobuf varint");
+      }
+      uint8_t byte = _data[_offset++];
+      result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return result;
+      }
+    }
+    throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Malformed protobuf varint");
+  }
+
+  bool ProtoReader::next(ProtoField& field) {
+    if (_offset >= _data.size()) {
+      return false;
+    }
+    uint64_t tag = readVarint();
+    field.number = static_cast<uint32_t>(tag >> 3);
+    field.type = static_cast<WireType>(tag & 0x7);
+    field.value = 0;
+    field.bytes = {};
+
+    switch (field.type) {
+      case WireType::VARINT:
+        field.value = readVarint();
+        break;
+      case WireType::FIXED64:
+      case WireType::FIXED32: {
+        size_t width = field.type == WireType::FIXED64 ? 8 : 4;
+        if (_data.size() - _offset < width) {
+          throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Truncated protobuf fixed field");
+        }
+        for (size_t i = 0; i < width; i++) {
+          field.value |= static_cast<uint64_t>(_data[_offset + i]) << (8 * i);
+        }
+        _offset += width;
+        break;
+      }
+      case WireType::LENGTH_DELIMITED: {
+        uint64_t length = readVarint();
+        if (length > _data.size() - _offset) {
+          throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Truncated protobuf length delimited field");
+        }
+        field.bytes = _data.subspan(_offset, static_cast<size_t>(length));
+        _offset += static_cast<size_t>(length);
+        break;
+      }
+      default:
+        throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Unsupported protobuf wire type");
+    }
+    return true;
+  }
+
+} // namespace espprov::proto
@@ -0,0 +1,172 @@
+///
+/// ProtoWire.hpp
+/// Minimal protobuf wire format reader/writer for the provisioning messages.
+///
+
+#pragma once
+
+#include "core/Bytes.hpp"
+#include <cstdint>
+#include <string_view>
+
+namespace espprov::proto {
+
+  enum class WireType : uint8_t {
+    VARINT = 0,
+    FIXED64 = 1,
+    LENGTH_DELIMITED = 2,
+    FIXED32 = 5,
+  };
+
+  /**
+   * Appends protobuf fields to a growing buffer.
+   * Like proto3, scalar fields holding their default value are not written at all.
+   */
+  class ProtoWriter {
+  public:
+    void writeUInt32(uint32_t field, uint32_t value);
+    void writeInt32(uint32_t field, int32_t value);
+    void writeBool(uint32_t field, bool value);
+    void writeEnum(uint32_t field, uint32_t value);
+    /**
+     * Writes an enum that is a `oneof` member. It is written even if it holds the default value,
+     * otherwise the receiver could not tell which member of the `oneof` is set.
+     */
+    void writeOneofEnum(uint32_t field, uint32_t value);
+    void writeBytes(uint32_t field, ByteView value);
+    void writeString(uint32_t field, std::string_view value);
+    /**
+     * Writes an embedded message. Unlike scalars this is always written, even if empty,
+     * because the presence of a `oneof` member is meaningful.
+     */
+    void writeMessage(uint32_t field, ByteView encoded);
+
+    const Bytes& bytes() const noexcept {
+      return _buffer;
+    }
+    Bytes take() noexcept {
+      return std::move(_buffer);
+    }
+
+  private:
+    void writeTag(uint32_t field, WireType type);
+    void writeVarint(uint64_t value);
+
+  private:
+    Bytes _buffer;
+  };
+
+  /**
+   * The encoded size of protobuf fields, mirroring what the writers emit, so a message can be
+   * sized before it is written into a fixed buffer.
+   */
+  namespace wire {
+    constexpr size_t varintSize(uint64_t value) noexcept {
+      size_t size = 1;
+      while (value >= 0x80) {
+        value >>= 7;
+        size++;
+      }
+      return size;
+    }
+    constexpr size_t tagSize(uint32_t field) noexcept {
+      return varintSize(static_cast<uint64_t>(field) << 3);
+    }
+    constexpr size_t uint32Size(uint32_t field, uint32_t value) noexcept {
+      return value == 0 ? 0 : tagSize(field) + varintSize(value);
+    }
+    constexpr size_t int32Size(uint32_t field, int32_t value) noexcept {
+      return value == 0 ? 0 : tagSize(field) + varintSize(static_cast<uint64_t>(static_cast<int64_t>(value)));
+    }
+    constexpr size_t oneofEnumSize(uint32_t field, uint32_t value) noexcept {
+      return tagSize(field) + varintSize(value);
+    }
+    constexpr size_t messageSize(uint32_t field, size_t length) noexcept {
+      return tagSize(field) + varintSize(length) + length;
+    }
+    constexpr size_t bytesSize(uint32_t field, size_t length) noexcept {
+      return length == 0 ? 0 : messageSize(field, length);
+    }
+  } // namespace wire
+
+  /**
+   * Writes protobuf fields into a caller provided buffer, with the same encoding rules as `ProtoWriter`
+   * but without any allocation. Throws `ProtocommError` if the buffer is too small.
+   */
+  class ProtoSpanWriter {
+  public:
+    explicit ProtoSpanWriter(MutableByteView output) noexcept: _output(output) {}
+
+    void writeUInt32(uint32_t field, uint32_t value);
+    void writeInt32(uint32_t field, int32_t value);
+    void writeBool(uint32_t field, bool value);
+    void writeEnum(uint32_t field, uint32_t value);
+    void writeOneofEnum(uint32_t field, uint32_t value);
+    void writeBytes(uint32_t field, ByteView value);
+    void writeString(uint32_t field, std::string_view value);
+    void writeMessage(uint32_t field, ByteView encoded);
+    /**
+     * Starts an embedded message of `length` bytes in place. The caller writes exactly
+     * that many bytes of fields next, which avoids encoding the sub message separately.
+     */
+    void beginMessage(uint32_t field, size_t length);
+
+    size_t size() const noexcept {
+      return _offset;
+    }
+    ByteView written() const noexcept {
+      return ByteView(_output.data(), _offset);
+    }
+
+  private:
+    void writeTag(uint32_t field, WireType type);
+    void writeVarint(uint64_t value);
+    void writeRaw(ByteView value);
+    void reserve(size_t size);
+
+  private:
+    MutableByteView _output;
+    size_t _offset = 0;
+  };
+
+  struct ProtoField {
+    uint32_t number = 0;
+    WireType type = WireType::VARINT;
+    /// Set for VARINT, FIXED32 and FIXED64 fields.
+    uint64_t value = 0;
+    /// Set for LENGTH_DELIMITED fields, points into the reader's input.
+    ByteView bytes;
+
+    uint32_t asUInt32() const noexcept {
+      return static_cast<uint32_t>(value);
+    }
+    int32_t asInt32() const noexcept {
+      return static_cast<int32_t>(static_cast<uint32_t>(value));
+    }
+    bool asBool() const noexcept {
+      return value != 0;
+    }
+  };
+
+  /**
+   * Iterates over the top level fields of an encoded message.
+   * Throws `ProtocommError` on malformed input.
+   */
+  class ProtoReader {
+  public:
+    explicit ProtoReader(ByteView data) noexcept: _data(data) {}
+
+    /**
+     * Reads the next field into `field`. Returns `false` once the end of the message is reached.
+     */
+    bool next(ProtoField& field);
+
+  private:
+    uint64_t readVarint();
+
+  private:
+    ByteView _data;
+    size_t _offset = 0;
+  };
+
+} // namespace espprov::proto
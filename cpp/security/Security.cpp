@@ -0,0 +1,45 @@
+///
+/// Security.cpp
+/// Factory for the protocomm security schemes.
+///
+
+#include "Security.hpp"
+#include "Security0.hpp"
+#include "Security1.hpp"
+#include "Security2.hpp"
+#include "core/Errors.hpp"
+
+namespace espprov {
+
+  bool isSecuritySchemeSupported(SecurityScheme scheme) noexcept {
+    switch (scheme) {
+      case SecurityScheme::SEC0:
+      case SecurityScheme::SEC1:
+      case SecurityScheme::SEC2:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  std::unique_ptr<Security> makeSecurity(SecurityScheme scheme, const SecurityParams& params) {
+    switch (scheme) {
+      case SecurityScheme::SEC0:
+        return std::make_unique<Security0>();
+      case SecurityScheme::SEC1:
+        return std::make_unique<Security1>(params.proofOfPossession);
+      case SecurityScheme::SEC2:
+        if (!params.username || params.username->empty()) {
+          throw ProtocommError(ErrorCode::NO_USERNAME, "Security scheme 2 needs a username");
+        }
+        if (!params.proofOfPossession || params.proofOfPossession->empty()) {
+          throw ProtocommError(ErrorCode::NO_POP, "Security scheme 2 needs a proof of possession");
+        }
+        return std::make_unique<Security2>(*params.username, *params.proofOfPossession);
+      default:
+        throw ProtocommError(ErrorCode::SESSION_SECURITY_MISMATCH,
+                             "Security scheme " + std::to_string(static_cast<int>(scheme)) + " is not supported by the native engine");
+    }
+  }
+
+} // namespace espprov
@@ -0,0 +1,66 @@
+///
+/// Security.hpp
+/// The protocomm security layer: session handshake plus per message encryption.
+///
+
+#pragma once
+
+#include "core/Bytes.hpp"
+#include "proto/Messages.hpp"
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace espprov {
+
+  /**
+   * The protocomm security schemes. Values match `PTSecurity` and `SecSchemeVersion`.
+   */
+  enum class SecurityScheme : uint8_t {
+    SEC0 = 0,
+    SEC1 = 1,
+    SEC2 = 2,
+  };
+
+  struct SecurityParams {
+    std::optional<std::string> proofOfPossession;
+    std::optional<std::string> username;
+  };
+
+  /**
+   * One instance per session. Runs the handshake against `prov-session` and afterwards
+   * encrypts requests and decrypts responses on every other endpoint.
+   */
+  class Security {
+  public:
+    /**
+     * Sends one `SessionData` message to the `prov-session` endpoint and returns the reply.
+     */
+    using Exchange = std::function<proto::SessionData(const proto::SessionData&)>;
+
+    virtual ~Security() = default;
+
+    virtual SecurityScheme scheme() const noexcept = 0;
+
+    /**
+     * Runs the full handshake. Throws `ProtocommError` if the device rejects it.
+     */
+    virtual void handshake(const Exchange& exchange) = 0;
+
+    virtual Bytes encrypt(ByteView plain) = 0;
+    virtual Bytes decrypt(ByteView cipher) = 0;
+  };
+
+  /**
+   * Whether the native engine implements the given scheme.
+   */
+  bool isSecuritySchemeSupported(SecurityScheme scheme) noexcept;
+
+  /**
+   * Creates the client side of the given scheme.
+   * Throws `ProtocommError` if the scheme is unsupported or required parameters are missing.
+   */
+  std::unique_ptr<Security> makeSecurity(SecurityScheme scheme, const SecurityParams& params);
+
+} // namespace espprov
@@ -0,0 +1,28 @@
+///
+/// Security0.cpp
+/// Protocomm security scheme 0: a plain text handshake and no encryption.
+///
+
+#include "Security0.hpp"
+#include "core/Errors.hpp"
+
+namespace espprov {
+
+  void Security0::handshake(const Exchange& exchange) {
+    proto::SessionData request;
+    request.secVer = proto::SecSchemeVersion::SEC_SCHEME_0;
+    request.msg = static_cast<uint32_t>(proto::Sec0MsgType::S0_SESSION_COMMAND);
+
+    proto::SessionData response = exchange(request);
+    if (response.secVer != proto::SecSchemeVersion::SEC_SCHEME_0) {
+      throw ProtocommError(ErrorCode::SESSION_SECURITY_MISMATCH, "Device answered with a different security scheme");
+    }
+    if (response.msg != static_cast<uint32_t>(proto::Sec0MsgType::S0_SESSION_RESPONSE)) {
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Unexpected Sec0 session response type");
+    }
+    if (proto::decodeS0SessionResp(response.body).status != proto::Status::SUCCESS) {
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Device rejected the Sec0 session");
+    }
+  }
+
+} // namespace espprov
@@ -0,0 +1,28 @@
+///
+/// Security0.hpp
+/// Protocomm security scheme 0: a plain text handshake and no encryption.
+///
+
+#pragma once
+
+#include "Security.hpp"
+
+namespace espprov {
+
+  class Security0 final : public Security {
+  public:
+    SecurityScheme scheme() const noexcept override {
+      return SecurityScheme::SEC0;
+    }
+
+    void handshake(const Exchange& exchange) override;
+
+    Bytes encrypt(ByteView plain) override {
+      return Bytes(plain.begin(), plain.end());
+    }
+    Bytes decrypt(ByteView cipher) override {
+      return Bytes(cipher.begin(), cipher.end());
+    }
+  };
+
+} // namespace espprov
@@ -0,0 +1,123 @@
+///
+/// Security1.cpp
+/// Protocomm security scheme 1: X25519 key agreement, a PoP mask and AES-256-CTR.
+///
+
+#include "Security1.hpp"
+#include "core/Errors.hpp"
+#include "core/Tracer.hpp"
+#include "crypto/SecureWipe.hpp"
+#include "crypto/Sha256.hpp"
+#include "crypto/X25519.hpp"
+
+namespace espprov {
+
+  namespace {
+    using crypto::X25519;
+
+    proto::SessionData exchangeStep(const Security::Exchange& exchange, proto::Sec1MsgType command, Bytes body,
+                                    proto::Sec1MsgType expectedResponse) {
+      proto::SessionData request;
+      request.secVer = proto::SecSchemeVersion::SEC_SCHEME_1;
+      request.msg = static_cast<uint32_t>(command);
+      request.body = std::move(body);
+
+      proto::SessionData response = exchange(request);
+      if (response.secVer != proto::SecSchemeVersion::SEC_SCHEME_1) {
+        throw ProtocommError(ErrorCode::SESSION_SECURITY_MISMATCH, "Device answered with a different security scheme");
+      }
+      if (response.msg != static_cast<uint32_t>(expectedResponse)) {
+        throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Unexpected Sec1 session response type");
+      }
+      return response;
+    }
+  } // namespace
+
+  Security1::Security1(std::optional<std::string> proofOfPossession): _proofOfPossession(std::move(proofOfPossession)) {}
+
+  Security1::~Security1() {
+    if (_proofOfPossession) {
+      crypto::secureWipe(_proofOfPossession->data(), _proofOfPossession->size());
+    }
+  }
+
+  void Security1::handshake(const Exchange& exchange) {
+    _cipher.reset();
+
+    // Command 0 exchanges the public keys and the device's counter start
+    X25519::Key privateKey = X25519::generatePrivateKey();
+    X25519::Key publicKey;
+    {
+      TraceSpan trace(TraceCategory::CRYPTO, "x25519 public key");
+      publicKey = X25519::publicKey(privateKey);
+    }
+
+    proto::Sec1SessionCmd0 command0;
+    command0.clientPubkey = Bytes(publicKey.begin(), publicKey.end());
+    proto::SessionData response = exchangeStep(exchange, proto::Sec1MsgType::SESSION_COMMAND_0,
+                                               proto::encodeSec1SessionCmd0(command0), proto::Sec1MsgType::SESSION_RESPONSE_0);
+    proto::Sec1SessionResp0 response0 = proto::decodeSec1SessionResp0(response.body);
+    if (response0.status != proto::Status::SUCCESS) {
+      crypto::secureWipe(privateKey.data(), privateKey.size());
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Device rejected the Sec1 session");
+    }
+    if (response0.devicePubkey.size() != X25519::KEY_SIZE || response0.deviceRandom.size() != DEVICE_RANDOM_SIZE) {
+      crypto::secureWipe(privateKey.data(), privateKey.size());
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Invalid Sec1 device public key or random");
+    }
+
+    X25519::Key devicePublicKey;
+    std::copy(response0.devicePubkey.begin(), response0.devicePubkey.end(), devicePublicKey.begin());
+    X25519::Key sharedKey;
+    {
+      TraceSpan trace(TraceCategory::CRYPTO, "x25519 shared key");
+      sharedKey = X25519::scalarMult(privateKey, devicePublicKey);
+    }
+    crypto::secureWipe(privateKey.data(), privateKey.size());
+    uint8_t nonZero = 0;
+    for (uint8_t byte : sharedKey) {
+      nonZero |= byte;
+    }
+    if (nonZero == 0) {
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Invalid Sec1 device public key");
+    }
+    if (_proofOfPossession && !_proofOfPossession->empty()) {
+      crypto::Sha256::Digest popHash = crypto::Sha256::hash(asBytes(*_proofOfPossession));
+      for (size_t i = 0; i < sharedKey.size(); i++) {
+        sharedKey[i] ^= popHash[i];
+      }
+    }
+    _cipher.emplace(sharedKey, response0.deviceRandom);
+    crypto::secureWipe(sharedKey.data(), sharedKey.size());
+
+    // Command 1 proves the key: each side returns the other's public key, encrypted
+    proto::Sec1SessionCmd1 command1;
+    command1.clientVerifyData = _cipher->apply(response0.devicePubkey);
+    response = exchangeStep(exchange, proto::Sec1MsgType::SESSION_COMMAND_1, proto::encodeSec1SessionCmd1(command1),
+                            proto::Sec1MsgType::SESSION_RESPONSE_1);
+    proto::Sec1SessionResp1 response1 = proto::decodeSec1SessionResp1(response.body);
+    if (response1.status != proto::Status::SUCCESS) {
+      _cipher.reset();
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Device rejected the Sec1 proof, wrong proof of possession");
+    }
+    if (_cipher->apply(response1.deviceVerifyData) != command0.clientPubkey) {
+      _cipher.reset();
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Sec1 device verification mismatch");
+    }
+  }
+
+  Bytes Security1::encrypt(ByteView plain) {
+    if (!_cipher) {
+      throw ProtocommError(ErrorCode::SESSION_NOT_ESTABLISHED, "Sec1 session is not established");
+    }
+    return _cipher->apply(plain);
+  }
+
+  Bytes Security1::decrypt(ByteView cipher) {
+    if (!_cipher) {
+      throw ProtocommError(ErrorCode::SESSION_NOT_ESTABLISHED, "Sec1 session is not established");
+    }
+    return _cipher->apply(cipher);
+  }
+
+} // namespace espprov
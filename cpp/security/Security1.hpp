@@ -0,0 +1,42 @@
+///
+/// Security1.hpp
+/// Protocomm security scheme 1: X25519 key agreement, a PoP mask and AES-256-CTR.
+///
+
+#pragma once
+
+#include "Security.hpp"
+#include "crypto/AesCtr.hpp"
+#include <optional>
+#include <string>
+
+namespace espprov {
+
+  /**
+   * The client side of `security1.c`. The X25519 shared secret, XORed with SHA-256 of the proof
+   * of possession when there is one, keys a single AES-256-CTR stream starting at the device's
+   * random. Requests and responses advance that same stream in turn, so messages must be
+   * encrypted and decrypted in the order they travel.
+   */
+  class Security1 final : public Security {
+  public:
+    static constexpr size_t DEVICE_RANDOM_SIZE = 16;
+
+    explicit Security1(std::optional<std::string> proofOfPossession);
+    ~Security1() override;
+
+    SecurityScheme scheme() const noexcept override {
+      return SecurityScheme::SEC1;
+    }
+
+    void handshake(const Exchange& exchange) override;
+
+    Bytes encrypt(ByteView plain) override;
+    Bytes decrypt(ByteView cipher) override;
+
+  private:
+    std::optional<std::string> _proofOfPossession;
+    std::optional<crypto::AesCtr> _cipher;
+  };
+
+} // namespace espprov
@@ -0,0 +1,192 @@
+///
+/// Security2.cpp
+/// Protocomm security scheme 2: an SRP6a handshake followed by AES-256-GCM.
+///
+
+#include "Security2.hpp"
+#include "core/Errors.hpp"
+#include "core/Tracer.hpp"
+#include "crypto/BigNum3072.hpp"
+#include "crypto/Random.hpp"
+#include "crypto/SecureWipe.hpp"
+#include "crypto/Sha512.hpp"
+
+namespace espprov {
+
+  namespace {
+    using crypto::BigNum3072;
+    using crypto::Sha512;
+
+    proto::SessionData exchangeStep(const Security::Exchange& exchange, proto::Sec2MsgType command, Bytes body,
+                                    proto::Sec2MsgType expectedResponse) {
+      proto::SessionData request;
+      request.secVer = proto::SecSchemeVersion::SEC_SCHEME_2;
+      request.msg = static_cast<uint32_t>(command);
+      request.body = std::move(body);
+
+      proto::SessionData response = exchange(request);
+      if (response.secVer != proto::SecSchemeVersion::SEC_SCHEME_2) {
+        throw ProtocommError(ErrorCode::SESSION_SECURITY_MISMATCH, "Device answered with a different security scheme");
+      }
+      if (response.msg != static_cast<uint32_t>(expectedResponse)) {
+        throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Unexpected Sec2 session response type");
+      }
+      return response;
+    }
+
+    bool equalInConstantTime(ByteView a, ByteView b) noexcept {
+      if (a.size() != b.size()) {
+        return false;
+      }
+      uint8_t difference = 0;
+      for (size_t i = 0; i < a.size(); i++) {
+        difference |= a[i] ^ b[i];
+      }
+      return difference == 0;
+    }
+
+    /// The RFC 5054 multiplier k = H(N | PAD(g)), a constant of the group.
+    const BigNum3072& multiplier() {
+      static const BigNum3072 k = BigNum3072::fromBytes(
+          Sha512::hash(BigNum3072::prime().toBytes(), BigNum3072::generator().toBytes()));
+      return k;
+    }
+
+    /**
+     * The exponent of the premaster secret, a + u * x, as big endian bytes. It is not reduced:
+     * the device computes the same power of the same base.
+     */
+    Bytes clientExponent(ByteView a, ByteView u, ByteView x) {
+      // Schoolbook product in base 256; 64 partial products of 16 bits never overflow a cell
+      std::vector<uint32_t> cells(std::max(a.size(), u.size() + x.size()) + 1, 0);
+      for (size_t i = 0; i < u.size(); i++) {
+        for (size_t j = 0; j < x.size(); j++) {
+          cells[i + j] += static_cast<uint32_t>(u[u.size() - 1 - i]) * x[x.size() - 1 - j];
+        }
+      }
+      for (size_t i = 0; i < a.size(); i++) {
+        cells[i] += a[a.size() - 1 - i];
+      }
+      Bytes exponent(cells.size());
+      uint32_t carry = 0;
+      for (size_t i = 0; i < cells.size(); i++) {
+        uint32_t value = cells[i] + carry;
+        exponent[exponent.size() - 1 - i] = static_cast<uint8_t>(value);
+        carry = value >> 8;
+      }
+      crypto::secureWipe(cells.data(), cells.size() * sizeof(uint32_t));
+      return exponent;
+    }
+  } // namespace
+
+  Security2::Security2(std::string username, std::string proofOfPossession)
+      : _username(std::move(username)), _proofOfPossession(std::move(proofOfPossession)) {}
+
+  Security2::~Security2() {
+    crypto::secureWipe(_proofOfPossession.data(), _proofOfPossession.size());
+  }
+
+  void Security2::handshake(const Exchange& exchange) {
+    _cipher.reset();
+
+    // Command 0 sends the identity and A = g^a
+    Bytes a = crypto::randomBytes(PRIVATE_KEY_SIZE);
+    Bytes publicA;
+    {
+      TraceSpan trace(TraceCategory::CRYPTO, "srp public key");
+      publicA = BigNum3072::generatorPow(a).toBytes();
+    }
+
+    proto::Sec2SessionCmd0 command0;
+    command0.clientUsername = toBytes(_username);
+    command0.clientPubkey = publicA;
+    proto::SessionData response = exchangeStep(exchange, proto::Sec2MsgType::S2_SESSION_COMMAND_0,
+                                               proto::encodeSec2SessionCmd0(command0),
+                                               proto::Sec2MsgType::S2_SESSION_RESPONSE_0);
+    proto::Sec2SessionResp0 response0 = proto::decodeSec2SessionResp0(response.body);
+    if (response0.status != proto::Status::SUCCESS) {
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Device rejected the Sec2 session");
+    }
+    const Bytes& publicB = response0.devicePubkey;
+    const Bytes& salt = response0.deviceSalt;
+    if (publicB.empty() || publicB.size() > BigNum3072::BYTES || salt.empty()) {
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Invalid Sec2 device public key or salt");
+    }
+    BigNum3072 b = BigNum3072::fromBytes(publicB);
+    // u = H(A | B), both as sent on the wire
+    Sha512::Digest u = Sha512::hash(publicA, publicB);
+    if (b.isZero() || BigNum3072::fromBytes(u).isZero()) {
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Invalid Sec2 device public key");
+    }
+
+    // x = H(s | H(I | ":" | P)), S = (B - k * g^x)^(a + u * x), K = H(S)
+    std::optional<TraceSpan> trace(std::in_place, TraceCategory::CRYPTO, "srp session key");
+    Sha512::Digest identity = Sha512::hash(asBytes(_username), asBytes(":"), asBytes(_proofOfPossession));
+    Sha512::Digest x = Sha512::hash(salt, identity);
+    BigNum3072 v = BigNum3072::generatorPow(x);
+    BigNum3072 base = b.modSub(multiplier().modMul(v));
+    Bytes exponent = clientExponent(a, u, x);
+    BigNum3072 s = base.modPow(exponent);
+    Bytes premaster = s.toMinimalBytes();
+    Sha512::Digest sessionKey = Sha512::hash(premaster);
+    crypto::secureWipe(a);
+    crypto::secureWipe(exponent);
+    crypto::secureWipe(premaster);
+    crypto::secureWipe(identity.data(), identity.size());
+    crypto::secureWipe(x.data(), x.size());
+    v.wipe();
+    base.wipe();
+    s.wipe();
+
+    // Command 1 sends M1 = H(H(N) xor H(g) | H(I) | s | A | B | K), the device answers H(A | M1 | K)
+    Sha512::Digest groupHash = Sha512::hash(BigNum3072::prime().toMinimalBytes());
+    Sha512::Digest generatorHash = Sha512::hash(BigNum3072::generator().toMinimalBytes());
+    for (size_t i = 0; i < groupHash.size(); i++) {
+      groupHash[i] ^= generatorHash[i];
+    }
+    Sha512::Digest clientProof = Sha512::hash(groupHash, Sha512::hash(asBytes(_username)), salt, publicA, publicB, sessionKey);
+    trace.reset();
+
+    proto::Sec2SessionCmd1 command1;
+    command1.clientProof = Bytes(clientProof.begin(), clientProof.end());
+    response = exchangeStep(exchange, proto::Sec2MsgType::S2_SESSION_COMMAND_1, proto::encodeSec2SessionCmd1(command1),
+                            proto::Sec2MsgType::S2_SESSION_RESPONSE_1);
+    proto::Sec2SessionResp1 response1 = proto::decodeSec2SessionResp1(response.body);
+    if (response1.status != proto::Status::SUCCESS) {
+      crypto::secureWipe(sessionKey.data(), sessionKey.size());
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Device rejected the Sec2 proof, wrong username or proof of possession");
+    }
+    Sha512::Digest deviceProof = Sha512::hash(publicA, clientProof, sessionKey);
+    if (!equalInConstantTime(deviceProof, response1.deviceProof)) {
+      crypto::secureWipe(sessionKey.data(), sessionKey.size());
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Sec2 device proof mismatch");
+    }
+    if (response1.deviceNonce.size() != NONCE_SIZE) {
+      crypto::secureWipe(sessionKey.data(), sessionKey.size());
+      throw ProtocommError(ErrorCode::SESSION_INIT_ERROR, "Invalid Sec2 device nonce");
+    }
+
+    _cipher.emplace(ByteView(sessionKey).first(crypto::Aes256::KEY_SIZE));
+    _nonce = std::move(response1.deviceNonce);
+    crypto::secureWipe(sessionKey.data(), sessionKey.size());
+  }
+
+  Bytes Security2::encrypt(ByteView plain) {
+    if (!_cipher) {
+      throw ProtocommError(ErrorCode::SESSION_NOT_ESTABLISHED, "Sec2 session is not established");
+    }
+    return _cipher->seal(_nonce, plain);
+  }
+
+  Bytes Security2::decrypt(ByteView cipher) {
+    if (!_cipher) {
+      throw ProtocommError(ErrorCode::SESSION_NOT_ESTABLISHED, "Sec2 session is not established");
+    }
+    std::optional<Bytes> plain = _cipher->open(_nonce, cipher);
+    if (!plain) {
+      throw ProtocommError(ErrorCode::ENCRYPTION_ERROR, "Sec2 message failed authentication");
+    }
+    return std::move(*plain);
+  }
+
+} // namespace espprov
@@ -0,0 +1,44 @@
+///
+/// Security2.hpp
+/// Protocomm security scheme 2: an SRP6a handshake followed by AES-256-GCM.
+///
+
+#pragma once
+
+#include "Security.hpp"
+#include "crypto/AesGcm.hpp"
+#include <optional>
+#include <string>
+
+namespace espprov {
+
+  /**
+   * The client side of `security2.c`: SRP6a over the RFC 5054 3072-bit group with SHA-512,
+   * the username as identity and the proof of possession as password. The session key's first
+   * 32 bytes key AES-256-GCM, used with the device's nonce for every message in both directions.
+   */
+  class Security2 final : public Security {
+  public:
+    static constexpr size_t PRIVATE_KEY_SIZE = 32;
+    static constexpr size_t NONCE_SIZE = 16;
+
+    Security2(std::string username, std::string proofOfPossession);
+    ~Security2() override;
+
+    SecurityScheme scheme() const noexcept override {
+      return SecurityScheme::SEC2;
+    }
+
+    void handshake(const Exchange& exchange) override;
+
+    Bytes encrypt(ByteView plain) override;
+    Bytes decrypt(ByteView cipher) override;
+
+  private:
+    std::string _username;
+    std::string _proofOfPossession;
+    std::optional<crypto::AesGcm> _cipher;
+    Bytes _nonce;
+  };
+
+} // namespace espprov
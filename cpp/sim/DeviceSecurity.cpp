@@ -0,0 +1,413 @@
+///
+/// DeviceSecurity.cpp
+/// The device side of the protocomm security schemes, used by the simulated ESP device.
+///
+/// The simulator is a host only tool, so it uses OpenSSL. This also keeps it an implementation
+/// independent from the engine's own client side crypto.
+///
+
+#include "DeviceSecurity.hpp"
+#include <openssl/bn.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <stdexcept>
+
+namespace espprov::sim {
+
+  namespace {
+    constexpr size_t SEC1_KEY_LENGTH = 32;
+    constexpr size_t SEC1_RANDOM_LENGTH = 16;
+    constexpr size_t SEC2_SALT_LENGTH = 16;
+    constexpr size_t SEC2_PRIVATE_KEY_LENGTH = 32;
+    constexpr size_t SEC2_PUBLIC_KEY_LENGTH = 384;
+    constexpr size_t SEC2_AES_KEY_LENGTH = 32;
+    constexpr size_t SEC2_IV_LENGTH = 16;
+    constexpr size_t SEC2_TAG_LENGTH = 16;
+    constexpr unsigned SEC2_GENERATOR = 5;
+
+    using CipherContext = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>;
+    using PKey = std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)>;
+    using PKeyContext = std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)>;
+    using BigNum = std::unique_ptr<BIGNUM, decltype(&BN_free)>;
+    using BigNumContext = std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)>;
+
+    void check(bool ok, const char* what) {
+      if (!ok) {
+        throw std::runtime_error(std::string("OpenSSL failure: ") + what);
+      }
+    }
+
+    Bytes randomBytes(size_t length) {
+      Bytes bytes(length);
+      check(RAND_bytes(bytes.data(), static_cast<int>(length)) == 1, "RAND_bytes");
+      return bytes;
+    }
+
+    template <typename... Parts>
+    Bytes digest(const EVP_MD* md, const Parts&... parts) {
+      std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+      check(ctx != nullptr && EVP_DigestInit_ex(ctx.get(), md, nullptr) == 1, "EVP_DigestInit_ex");
+      (check(EVP_DigestUpdate(ctx.get(), ByteView(parts).data(), ByteView(parts).size()) == 1, "EVP_DigestUpdate"), ...);
+      Bytes out(EVP_MD_size(md));
+      check(EVP_DigestFinal_ex(ctx.get(), out.data(), nullptr) == 1, "EVP_DigestFinal_ex");
+      return out;
+    }
+
+    BigNum newBigNum() {
+      BigNum bn(BN_new(), BN_free);
+      check(bn != nullptr, "BN_new");
+      return bn;
+    }
+
+    BigNum bigNumFrom(ByteView bytes) {
+      BigNum bn(BN_bin2bn(bytes.data(), static_cast<int>(bytes.size()), nullptr), BN_free);
+      check(bn != nullptr, "BN_bin2bn");
+      return bn;
+    }
+
+    /// Minimal big endian encoding, the way `esp_mpi_to_bin` writes it.
+    Bytes bigNumBytes(const BIGNUM* bn) {
+      Bytes bytes(BN_num_bytes(bn));
+      BN_bn2bin(bn, bytes.data());
+      return bytes;
+    }
+
+    Bytes toPaddedBytes(const BIGNUM* bn, size_t length) {
+      Bytes bytes(length);
+      check(BN_bn2binpad(bn, bytes.data(), static_cast<int>(length)) >= 0, "BN_bn2binpad");
+      return bytes;
+    }
+
+    proto::SessionData reply(SecurityScheme scheme, uint32_t msg, Bytes body) {
+      proto::SessionData data;
+      data.secVer = static_cast<proto::SecSchemeVersion>(scheme);
+      data.msg = msg;
+      data.body = std::move(body);
+      return data;
+    }
+
+    // pragma MARK: Sec0
+
+    class DeviceSecurity0 final : public DeviceSecurity {
+    public:
+      SecurityScheme scheme() const noexcept override {
+        return SecurityScheme::SEC0;
+      }
+
+      proto::SessionData handle(const proto::SessionData& request) override {
+        if (request.msg != static_cast<uint32_t>(proto::Sec0MsgType::S0_SESSION_COMMAND)) {
+          throw std::runtime_error("Unexpected Sec0 message");
+        }
+        return reply(scheme(), static_cast<uint32_t>(proto::Sec0MsgType::S0_SESSION_RESPONSE), proto::encodeS0SessionResp({}));
+      }
+
+      bool isEstablished() const noexcept override {
+        return true;
+      }
+
+      Bytes decrypt(ByteView cipher) override {
+        return Bytes(cipher.begin(), cipher.end());
+      }
+      Bytes encrypt(ByteView plain) override {
+        return Bytes(plain.begin(), plain.end());
+      }
+    };
+
+    // pragma MARK: Sec1
+
+    /**
+     * X25519 key agreement, the shared secret XORed with SHA-256(PoP), then a single AES-256-CTR
+     * stream that both directions advance, exactly like `security1.c`.
+     */
+    class DeviceSecurity1 final : public DeviceSecurity {
+    public:
+      explicit DeviceSecurity1(std::string proofOfPossession): _pop(std::move(proofOfPossession)) {}
+
+      SecurityScheme scheme() const noexcept override {
+        return SecurityScheme::SEC1;
+      }
+
+      proto::SessionData handle(const proto::SessionData& request) override {
+        switch (static_cast<proto::Sec1MsgType>(request.msg)) {
+          case proto::Sec1MsgType::SESSION_COMMAND_0:
+            return handleCommand0(proto::decodeSec1SessionCmd0(request.body));
+          case proto::Sec1MsgType::SESSION_COMMAND_1:
+            return handleCommand1(proto::decodeSec1SessionCmd1(request.body));
+          default:
+            throw std::runtime_error("Unexpected Sec1 message");
+        }
+      }
+
+      bool isEstablished() const noexcept override {
+        return _established;
+      }
+
+      Bytes decrypt(ByteView cipher) override {
+        return crypt(cipher);
+      }
+      Bytes encrypt(ByteView plain) override {
+        return crypt(plain);
+      }
+
+    private:
+      proto::SessionData handleCommand0(const proto::Sec1SessionCmd0& command) {
+        if (command.clientPubkey.size() != SEC1_KEY_LENGTH) {
+          throw std::runtime_error("Invalid Sec1 client public key");
+        }
+        _established = false;
+        _clientPubkey = command.clientPubkey;
+
+        PKeyContext keygen(EVP_PKEY_CTX_new_id(EVP_PKEY_X25519, nullptr), EVP_PKEY_CTX_free);
+        EVP_PKEY* rawKey = nullptr;
+        check(keygen != nullptr && EVP_PKEY_keygen_init(keygen.get()) == 1 && EVP_PKEY_keygen(keygen.get(), &rawKey) == 1,
+              "X25519 keygen");
+        PKey deviceKey(rawKey, EVP_PKEY_free);
+
+        _devicePubkey.resize(SEC1_KEY_LENGTH);
+        size_t length = _devicePubkey.size();
+        check(EVP_PKEY_get_raw_public_key(deviceKey.get(), _devicePubkey.data(), &length) == 1, "X25519 public key");
+
+        PKey clientKey(EVP_PKEY_new_raw_public_key(EVP_PKEY_X25519, nullptr, _clientPubkey.data(), _clientPubkey.size()),
+                       EVP_PKEY_free);
+        PKeyContext derive(EVP_PKEY_CTX_new(deviceKey.get(), nullptr), EVP_PKEY_CTX_free);
+        Bytes sharedKey(SEC1_KEY_LENGTH);
+        length = sharedKey.size();
+        check(clientKey != nullptr && derive != nullptr && EVP_PKEY_derive_init(derive.get()) == 1 &&
+                  EVP_PKEY_derive_set_peer(derive.get(), clientKey.get()) == 1 &&
+                  EVP_PKEY_derive(derive.get(), sharedKey.data(), &length) == 1,
+              "X25519 derive");
+
+        if (!_pop.empty()) {
+          Bytes popHash = digest(EVP_sha256(), asBytes(_pop));
+          for (size_t i = 0; i < SEC1_KEY_LENGTH; i++) {
+            sharedKey[i] ^= popHash[i];
+          }
+        }
+
+        Bytes deviceRandom = randomBytes(SEC1_RANDOM_LENGTH);
+        _cipher.reset(EVP_CIPHER_CTX_new());
+        check(_cipher != nullptr &&
+                  EVP_EncryptInit_ex(_cipher.get(), EVP_aes_256_ctr(), nullptr, sharedKey.data(), deviceRandom.data()) == 1,
+              "AES-CTR init");
+
+        proto::Sec1SessionResp0 response;
+        response.devicePubkey = _devicePubkey;
+        response.deviceRandom = std::move(deviceRandom);
+        return reply(scheme(), static_cast<uint32_t>(proto::Sec1MsgType::SESSION_RESPONSE_0),
+                     proto::encodeSec1SessionResp0(response));
+      }
+
+      proto::SessionData handleCommand1(const proto::Sec1SessionCmd1& command) {
+        if (_cipher == nullptr) {
+          throw std::runtime_error("Sec1 command 1 before command 0");
+        }
+        if (crypt(command.clientVerifyData) != _devicePubkey) {
+          throw std::runtime_error("Sec1 client verification failed, wrong proof of possession");
+        }
+        proto::Sec1SessionResp1 response;
+        response.deviceVerifyData = crypt(_clientPubkey);
+        _established = true;
+        return reply(scheme(), static_cast<uint32_t>(proto::Sec1MsgType::SESSION_RESPONSE_1),
+                     proto::encodeSec1SessionResp1(response));
+      }
+
+      Bytes crypt(ByteView input) {
+        Bytes output(input.size());
+        int length = 0;
+        check(EVP_EncryptUpdate(_cipher.get(), output.data(), &length, input.data(), static_cast<int>(input.size())) == 1,
+              "AES-CTR update");
+        return output;
+      }
+
+    private:
+      std::string _pop;
+      Bytes _clientPubkey;
+      Bytes _devicePubkey;
+      CipherContext _cipher{nullptr, EVP_CIPHER_CTX_free};
+      bool _established = false;
+    };
+
+    // pragma MARK: Sec2
+
+    /**
+     * SRP6a over the RFC 5054 3072-bit group with SHA-512, followed by AES-256-GCM with the session
+     * nonce, mirroring `esp_srp.c` and `security2.c` including their unpadded encodings of B and S.
+     */
+    class DeviceSecurity2 final : public DeviceSecurity {
+    public:
+      DeviceSecurity2(const std::string& proofOfPossession, const std::string& username)
+          : _n(newBigNum()), _g(newBigNum()), _v(newBigNum()), _ctx(BN_CTX_new(), BN_CTX_free) {
+        check(_ctx != nullptr && BN_get_rfc3526_prime_3072(_n.get()) != nullptr && BN_set_word(_g.get(), SEC2_GENERATOR) == 1,
+              "SRP group");
+        _nBytes = bigNumBytes(_n.get());
+        _gBytes = bigNumBytes(_g.get());
+
+        // esp_srp_gen_salt_verifier: x = H(s | H(I | ":" | P)), v = g^x
+        _salt = randomBytes(SEC2_SALT_LENGTH);
+        Bytes inner = digest(EVP_sha512(), asBytes(username), asBytes(":"), asBytes(proofOfPossession));
+        BigNum x = bigNumFrom(digest(EVP_sha512(), _salt, inner));
+        check(BN_mod_exp(_v.get(), _g.get(), x.get(), _n.get(), _ctx.get()) == 1, "SRP verifier");
+      }
+
+      SecurityScheme scheme() const noexcept override {
+        return SecurityScheme::SEC2;
+      }
+
+      proto::SessionData handle(const proto::SessionData& request) override {
+        switch (static_cast<proto::Sec2MsgType>(request.msg)) {
+          case proto::Sec2MsgType::S2_SESSION_COMMAND_0:
+            return handleCommand0(proto::decodeSec2SessionCmd0(request.body));
+          case proto::Sec2MsgType::S2_SESSION_COMMAND_1:
+            return handleCommand1(proto::decodeSec2SessionCmd1(request.body));
+          default:
+            throw std::runtime_error("Unexpected Sec2 message");
+        }
+      }
+
+      bool isEstablished() const noexcept override {
+        return _established;
+      }
+
+      Bytes decrypt(ByteView cipher) override {
+        if (cipher.size() < SEC2_TAG_LENGTH) {
+          throw std::runtime_error("Sec2 message shorter than its tag");
+        }
+        size_t plainLength = cipher.size() - SEC2_TAG_LENGTH;
+        CipherContext ctx = gcm(false);
+        Bytes plain(plainLength);
+        int length = 0;
+        Bytes tag(cipher.begin() + plainLength, cipher.end());
+        check(EVP_DecryptUpdate(ctx.get(), plain.data(), &length, cipher.data(), static_cast<int>(plainLength)) == 1 &&
+                  EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_SET_TAG, SEC2_TAG_LENGTH, tag.data()) == 1,
+              "AES-GCM decrypt");
+        if (EVP_DecryptFinal_ex(ctx.get(), plain.data() + length, &length) != 1) {
+          throw std::runtime_error("Sec2 message failed authentication");
+        }
+        return plain;
+      }
+
+      Bytes encrypt(ByteView plain) override {
+        CipherContext ctx = gcm(true);
+        Bytes cipher(plain.size() + SEC2_TAG_LENGTH);
+        int length = 0;
+        check(EVP_EncryptUpdate(ctx.get(), cipher.data(), &length, plain.data(), static_cast<int>(plain.size())) == 1 &&
+                  EVP_EncryptFinal_ex(ctx.get(), cipher.data() + length, &length) == 1 &&
+                  EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_GET_TAG, SEC2_TAG_LENGTH, cipher.data() + plain.size()) == 1,
+              "AES-GCM encrypt");
+        return cipher;
+      }
+
+    private:
+      proto::SessionData handleCommand0(const proto::Sec2SessionCmd0& command) {
+        if (command.clientPubkey.size() != SEC2_PUBLIC_KEY_LENGTH) {
+          throw std::runtime_error("Invalid Sec2 client public key");
+        }
+        _established = false;
+        _username = command.clientUsername;
+        _aBytes = command.clientPubkey;
+        BigNum a = bigNumFrom(_aBytes);
+        BigNum check0 = newBigNum();
+        check(BN_mod(check0.get(), a.get(), _n.get(), _ctx.get()) == 1, "SRP A mod N");
+        if (BN_is_zero(check0.get())) {
+          throw std::runtime_error("Invalid Sec2 client public key");
+        }
+
+        // B = k * v + g^b, with k = H(N | PAD(g))
+        BigNum b = bigNumFrom(randomBytes(SEC2_PRIVATE_KEY_LENGTH));
+        BigNum k = bigNumFrom(digest(EVP_sha512(), _nBytes, toPaddedBytes(_g.get(), _nBytes.size())));
+        BigNum kv = newBigNum();
+        BigNum gb = newBigNum();
+        BigNum bigB = newBigNum();
+        check(BN_mod_mul(kv.get(), k.get(), _v.get(), _n.get(), _ctx.get()) == 1 &&
+                  BN_mod_exp(gb.get(), _g.get(), b.get(), _n.get(), _ctx.get()) == 1 &&
+                  BN_mod_add(bigB.get(), kv.get(), gb.get(), _n.get(), _ctx.get()) == 1,
+              "SRP B");
+        _bBytes = bigNumBytes(bigB.get());
+
+        // u = H(A | B), S = (A * v^u)^b, K = H(S)
+        BigNum u = bigNumFrom(digest(EVP_sha512(), _aBytes, _bBytes));
+        BigNum vu = newBigNum();
+        BigNum avu = newBigNum();
+        BigNum s = newBigNum();
+        check(BN_mod_exp(vu.get(), _v.get(), u.get(), _n.get(), _ctx.get()) == 1 &&
+                  BN_mod_mul(avu.get(), a.get(), vu.get(), _n.get(), _ctx.get()) == 1 &&
+                  BN_mod_exp(s.get(), avu.get(), b.get(), _n.get(), _ctx.get()) == 1,
+              "SRP S");
+        _sessionKey = digest(EVP_sha512(), bigNumBytes(s.get()));
+
+        proto::Sec2SessionResp0 response;
+        response.devicePubkey = _bBytes;
+        response.deviceSalt = _salt;
+        return reply(scheme(), static_cast<uint32_t>(proto::Sec2MsgType::S2_SESSION_RESPONSE_0),
+                     proto::encodeSec2SessionResp0(response));
+      }
+
+      proto::SessionData handleCommand1(const proto::Sec2SessionCmd1& command) {
+        if (_sessionKey.empty()) {
+          throw std::runtime_error("Sec2 command 1 before command 0");
+        }
+        // M1 = H(H(N) xor H(g) | H(I) | s | A | B | K)
+        Bytes hashN = digest(EVP_sha512(), _nBytes);
+        Bytes hashG = digest(EVP_sha512(), _gBytes);
+        for (size_t i = 0; i < hashN.size(); i++) {
+          hashN[i] ^= hashG[i];
+        }
+        Bytes clientProof = digest(EVP_sha512(), hashN, digest(EVP_sha512(), _username), _salt, _aBytes, _bBytes, _sessionKey);
+        if (clientProof != command.clientProof) {
+          throw std::runtime_error("Sec2 client proof mismatch, wrong username or proof of possession");
+        }
+
+        // M2 = H(A | M1 | K)
+        proto::Sec2SessionResp1 response;
+        response.deviceProof = digest(EVP_sha512(), _aBytes, clientProof, _sessionKey);
+        _iv = randomBytes(SEC2_IV_LENGTH);
+        response.deviceNonce = _iv;
+        _established = true;
+        return reply(scheme(), static_cast<uint32_t>(proto::Sec2MsgType::S2_SESSION_RESPONSE_1),
+                     proto::encodeSec2SessionResp1(response));
+      }
+
+      CipherContext gcm(bool encrypt) {
+        if (!_established) {
+          throw std::runtime_error("Sec2 session is not established");
+        }
+        CipherContext ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+        check(ctx != nullptr && EVP_CipherInit_ex(ctx.get(), EVP_aes_256_gcm(), nullptr, nullptr, nullptr, encrypt) == 1 &&
+                  EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_SET_IVLEN, static_cast<int>(_iv.size()), nullptr) == 1 &&
+                  EVP_CipherInit_ex(ctx.get(), nullptr, nullptr, _sessionKey.data(), _iv.data(), encrypt) == 1,
+              "AES-GCM init");
+        static_assert(SEC2_AES_KEY_LENGTH == 32, "AES-256 takes the first half of the SHA-512 session key");
+        return ctx;
+      }
+
+    private:
+      BigNum _n;
+      BigNum _g;
+      BigNum _v;
+      BigNumContext _ctx;
+      Bytes _nBytes;
+      Bytes _gBytes;
+      Bytes _salt;
+      Bytes _username;
+      Bytes _aBytes;
+      Bytes _bBytes;
+      Bytes _sessionKey;
+      Bytes _iv;
+      bool _established = false;
+    };
+  } // namespace
+
+  std::unique_ptr<DeviceSecurity> makeDeviceSecurity(SecurityScheme scheme, const std::string& proofOfPossession,
+                                                     const std::string& username) {
+    switch (scheme) {
+      case SecurityScheme::SEC0:
+        return std::make_unique<DeviceSecurity0>();
+      case SecurityScheme::SEC1:
+        return std::make_unique<DeviceSecurity1>(proofOfPossession);
+      case SecurityScheme::SEC2:
+        return std::make_unique<DeviceSecurity2>(proofOfPossession, username);
+    }
+    throw std::invalid_argument("Unknown security scheme");
+  }
+
+} // namespace espprov::sim
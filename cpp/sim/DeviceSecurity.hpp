@@ -0,0 +1,48 @@
+///
+/// DeviceSecurity.hpp
+/// The device side of the protocomm security schemes, used by the simulated ESP device.
+///
+
+#pragma once
+
+#include "core/Bytes.hpp"
+#include "proto/Messages.hpp"
+#include "security/Security.hpp"
+#include <memory>
+#include <string>
+
+namespace espprov::sim {
+
+  /**
+   * The device half of a protocomm security scheme. Answers `prov-session` messages and, once the
+   * handshake completed, decrypts requests and encrypts responses on every other endpoint.
+   * One instance lives as long as the device: every session command 0 starts a new session.
+   *
+   * Throws `std::runtime_error` when the client fails the handshake, which the simulated device
+   * turns into an HTTP 500 the same way `protocomm_httpd` does.
+   */
+  class DeviceSecurity {
+  public:
+    virtual ~DeviceSecurity() = default;
+
+    virtual SecurityScheme scheme() const noexcept = 0;
+
+    /**
+     * Handles one handshake step and returns the `SessionData` reply.
+     */
+    virtual proto::SessionData handle(const proto::SessionData& request) = 0;
+
+    virtual bool isEstablished() const noexcept = 0;
+
+    virtual Bytes decrypt(ByteView cipher) = 0;
+    virtual Bytes encrypt(ByteView plain) = 0;
+  };
+
+  /**
+   * Creates the device side of `scheme`. Sec1 ignores `username`, Sec0 ignores both.
+   * Sec2 derives its salt and verifier once from `proofOfPossession`, like `esp_srp_gen_salt_verifier`.
+   */
+  std::unique_ptr<DeviceSecurity> makeDeviceSecurity(SecurityScheme scheme, const std::string& proofOfPossession,
+                                                     const std::string& username);
+
+} // namespace espprov::sim
@@ -0,0 +1,210 @@
+///
+/// Http.cpp
+/// The minimal HTTP/1.1 framing spoken between protocomm SoftAP clients and `protocomm_httpd`.
+///
+
+#include "Http.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace espprov::sim {
+
+  namespace {
+    /// Upper bound for the header block, far above anything protocomm sends.
+    constexpr size_t MAX_HEADER_SIZE = 8 * 1024;
+    /// Upper bound for a body, the ESP httpd rejects anything larger anyway.
+    constexpr size_t MAX_BODY_SIZE = 64 * 1024;
+
+    std::runtime_error socketError(const std::string& what) {
+      return std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    std::string_view trim(std::string_view value) {
+      while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+      }
+      while (!value.empty() && (value.back() == ' ' || value.back() == '\t' || value.back() == '\r')) {
+        value.remove_suffix(1);
+      }
+      return value;
+    }
+
+    /// Receives into `buffer`, returns the number of bytes read (0 on EOF).
+    size_t receive(Socket& socket, uint8_t* buffer, size_t size) {
+      while (true) {
+        ssize_t received = ::recv(socket.fd(), buffer, size, 0);
+        if (received >= 0) {
+          return static_cast<size_t>(received);
+        }
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          throw std::runtime_error("Timed out waiting for the peer");
+        }
+        throw socketError("recv");
+      }
+    }
+  } // namespace
+
+  // pragma MARK: Socket
+
+  Socket::~Socket() {
+    close();
+  }
+
+  Socket& Socket::operator=(Socket&& other) noexcept {
+    if (this != &other) {
+      close();
+      _fd = other.release();
+    }
+    return *this;
+  }
+
+  int Socket::release() noexcept {
+    int fd = _fd;
+    _fd = -1;
+    return fd;
+  }
+
+  void Socket::close() noexcept {
+    if (_fd >= 0) {
+      ::close(_fd);
+      _fd = -1;
+    }
+  }
+
+  Socket Socket::connect(const std::string& host, uint16_t port, std::chrono::milliseconds timeout) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0 || addresses == nullptr) {
+      throw std::runtime_error("Cannot resolve " + host);
+    }
+    std::unique_ptr<addrinfo, decltype(&::freeaddrinfo)> guard(addresses, ::freeaddrinfo);
+
+    Socket socket(::socket(addresses->ai_family, addresses->ai_socktype, addresses->ai_protocol));
+    if (!socket.isOpen()) {
+      throw socketError("socket");
+    }
+    // Linux honours SO_SNDTIMEO for connect(), which is all the simulator needs.
+    socket.setTimeout(timeout);
+    if (::connect(socket.fd(), addresses->ai_addr, addresses->ai_addrlen) != 0) {
+      throw socketError("connect to " + host + ":" + std::to_string(port));
+    }
+    int noDelay = 1;
+    ::setsockopt(socket.fd(), IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return socket;
+  }
+
+  void Socket::setTimeout(std::chrono::milliseconds timeout) {
+    timeval tv{};
+    tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    tv.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+    ::setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(_fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+  }
+
+  // pragma MARK: HttpMessage
+
+  std::optional<std::string_view> HttpMessage::header(std::string_view name) const {
+    for (const auto& [key, value] : headers) {
+      if (key.size() == name.size() && ::strncasecmp(key.data(), name.data(), name.size()) == 0) {
+        return std::string_view(value);
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::optional<HttpMessage> readHttpMessage(Socket& socket) {
+    // Read byte blocks until the end of the header block, keeping whatever body bytes followed it.
+    std::string head;
+    Bytes body;
+    uint8_t buffer[2048];
+    size_t headerEnd = std::string::npos;
+    while (headerEnd == std::string::npos) {
+      size_t received = receive(socket, buffer, sizeof(buffer));
+      if (received == 0) {
+        if (head.empty()) {
+          return std::nullopt;
+        }
+        throw std::runtime_error("Connection closed inside the HTTP header");
+      }
+      head.append(reinterpret_cast<const char*>(buffer), received);
+      headerEnd = head.find("\r\n\r\n");
+      if (headerEnd == std::string::npos && head.size() > MAX_HEADER_SIZE) {
+        throw std::runtime_error("HTTP header too large");
+      }
+    }
+    body.assign(head.begin() + static_cast<std::ptrdiff_t>(headerEnd + 4), head.end());
+    head.resize(headerEnd);
+
+    HttpMessage message;
+    size_t lineEnd = head.find("\r\n");
+    message.startLine = head.substr(0, lineEnd);
+    while (lineEnd != std::string::npos) {
+      size_t lineStart = lineEnd + 2;
+      lineEnd = head.find("\r\n", lineStart);
+      size_t lineLength = lineEnd == std::string::npos ? std::string::npos : lineEnd - lineStart;
+      std::string_view line = std::string_view(head).substr(lineStart, lineLength);
+      size_t colon = line.find(':');
+      if (colon == std::string_view::npos) {
+        throw std::runtime_error("Malformed HTTP header line");
+      }
+      message.headers.emplace_back(std::string(trim(line.substr(0, colon))), std::string(trim(line.substr(colon + 1))));
+    }
+
+    size_t contentLength = 0;
+    if (auto value = message.header("Content-Length")) {
+      contentLength = std::stoul(std::string(*value));
+    }
+    if (contentLength > MAX_BODY_SIZE || body.size() > contentLength) {
+      throw std::runtime_error("Invalid HTTP Content-Length");
+    }
+    size_t received = body.size();
+    body.resize(contentLength);
+    while (received < contentLength) {
+      size_t chunk = receive(socket, body.data() + received, contentLength - received);
+      if (chunk == 0) {
+        throw std::runtime_error("Connection closed inside the HTTP body");
+      }
+      received += chunk;
+    }
+    message.body = std::move(body);
+    return message;
+  }
+
+  void writeHttpMessage(Socket& socket, const HttpMessage& message) {
+    std::string head = message.startLine + "\r\n";
+    for (const auto& [key, value] : message.headers) {
+      head += key + ": " + value + "\r\n";
+    }
+    head += "Content-Length: " + std::to_string(message.body.size()) + "\r\n\r\n";
+
+    Bytes wire(head.begin(), head.end());
+    wire.insert(wire.end(), message.body.begin(), message.body.end());
+    size_t sent = 0;
+    while (sent < wire.size()) {
+      ssize_t written = ::send(socket.fd(), wire.data() + sent, wire.size() - sent, MSG_NOSIGNAL);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw socketError("send");
+      }
+      sent += static_cast<size_t>(written);
+    }
+  }
+
+} // namespace espprov::sim
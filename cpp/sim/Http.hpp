@@ -0,0 +1,76 @@
+///
+/// Http.hpp
+/// The minimal HTTP/1.1 framing spoken between protocomm SoftAP clients and `protocomm_httpd`.
+///
+
+#pragma once
+
+#include "core/Bytes.hpp"
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace espprov::sim {
+
+  /**
+   * An owned POSIX socket descriptor, closed on destruction.
+   */
+  class Socket {
+  public:
+    Socket() = default;
+    explicit Socket(int fd): _fd(fd) {}
+    ~Socket();
+
+    Socket(Socket&& other) noexcept: _fd(other.release()) {}
+    Socket& operator=(Socket&& other) noexcept;
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    int fd() const noexcept {
+      return _fd;
+    }
+    bool isOpen() const noexcept {
+      return _fd >= 0;
+    }
+    int release() noexcept;
+    void close() noexcept;
+
+    /**
+     * Opens a TCP connection to `host:port`. Throws `std::runtime_error` on failure.
+     */
+    static Socket connect(const std::string& host, uint16_t port, std::chrono::milliseconds timeout);
+
+    /**
+     * Applies `timeout` to every following blocking send and receive.
+     */
+    void setTimeout(std::chrono::milliseconds timeout);
+
+  private:
+    int _fd = -1;
+  };
+
+  /**
+   * A request or a response: the start line, the headers and the body.
+   */
+  struct HttpMessage {
+    std::string startLine;
+    std::vector<std::pair<std::string, std::string>> headers;
+    Bytes body;
+
+    /**
+     * Case insensitive header lookup.
+     */
+    std::optional<std::string_view> header(std::string_view name) const;
+  };
+
+  /**
+   * Reads one message framed by `Content-Length`. Returns `nullopt` if the peer closed the
+   * connection before sending anything, throws `std::runtime_error` on malformed or truncated input.
+   */
+  std::optional<HttpMessage> readHttpMessage(Socket& socket);
+
+  void writeHttpMessage(Socket& socket, const HttpMessage& message);
+
+} // namespace espprov::sim
@@ -0,0 +1,152 @@
+///
+/// LoopbackHttpServer.cpp
+/// Serves a simulated device over protocomm-over-HTTP on 127.0.0.1, like `protocomm_httpd` on the SoftAP.
+///
+
+#include "LoopbackHttpServer.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace espprov::sim {
+
+  namespace {
+    bool wantsClose(const HttpMessage& request) {
+      std::optional<std::string_view> connection = request.header("Connection");
+      if (request.startLine.ends_with("HTTP/1.0")) {
+        return !connection.has_value() || *connection != "keep-alive";
+      }
+      return connection.has_value() && *connection == "close";
+    }
+  } // namespace
+
+  LoopbackHttpServer::LoopbackHttpServer(std::shared_ptr<SimulatedDevice> device, LoopbackHttpServerOptions options)
+      : _device(std::move(device)), _options(options), _listener(::socket(AF_INET, SOCK_STREAM, 0)) {
+    if (!_listener.isOpen()) {
+      throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    }
+    int reuse = 1;
+    ::setsockopt(_listener.fd(), SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(_options.port);
+    if (::bind(_listener.fd(), reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(_listener.fd(), SOMAXCONN) != 0) {
+      throw std::runtime_error("Cannot listen on 127.0.0.1:" + std::to_string(_options.port) + ": " + std::strerror(errno));
+    }
+    socklen_t length = sizeof(address);
+    ::getsockname(_listener.fd(), reinterpret_cast<sockaddr*>(&address), &length);
+    _port = ntohs(address.sin_port);
+
+    _acceptThread = std::thread([this] { acceptLoop(); });
+  }
+
+  LoopbackHttpServer::~LoopbackHttpServer() {
+    stop();
+  }
+
+  void LoopbackHttpServer::stop() noexcept {
+    if (!_running.exchange(false)) {
+      return;
+    }
+    // Unblocks accept() and every recv() without racing the descriptors' owners on close().
+    ::shutdown(_listener.fd(), SHUT_RDWR);
+    if (_acceptThread.joinable()) {
+      _acceptThread.join();
+    }
+    std::unique_lock lock(_connectionsMutex);
+    for (int fd : _openConnections) {
+      ::shutdown(fd, SHUT_RDWR);
+    }
+    _connectionsClosed.wait(lock, [this] { return _openConnections.empty(); });
+    _listener.close();
+  }
+
+  void LoopbackHttpServer::acceptLoop() {
+    while (_running) {
+      int fd = ::accept(_listener.fd(), nullptr, nullptr);
+      if (fd < 0) {
+        if (errno == EINTR || errno == ECONNABORTED) {
+          continue;
+        }
+        return;
+      }
+      int noDelay = 1;
+      ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+      std::lock_guard lock(_connectionsMutex);
+      if (!_running) {
+        ::close(fd);
+        return;
+      }
+      _connectionCount++;
+      _openConnections.push_back(fd);
+      std::thread([this, fd] { serve(fd); }).detach();
+    }
+  }
+
+  void LoopbackHttpServer::serve(int fd) {
+    try {
+      Socket socket(fd);
+      bool first = true;
+      while (_running) {
+        std::optional<HttpMessage> request = readHttpMessage(socket);
+        if (!request.has_value()) {
+          break;
+        }
+        HttpMessage response = respond(*request);
+        bool close = wantsClose(*request);
+        if (close) {
+          response.headers.emplace_back("Connection", "close");
+        }
+        std::chrono::milliseconds delay = _options.latency + (first ? _options.connectLatency : std::chrono::milliseconds(0));
+        first = false;
+        if (delay.count() > 0) {
+          std::this_thread::sleep_for(delay);
+        }
+        writeHttpMessage(socket, response);
+        if (close) {
+          break;
+        }
+      }
+    } catch (const std::exception&) {
+      // The client went away or sent garbage, either way this connection is done.
+    }
+    // The socket is closed at this point, so stop() can no longer shut down a reused descriptor.
+    std::lock_guard lock(_connectionsMutex);
+    _openConnections.erase(std::remove(_openConnections.begin(), _openConnections.end(), fd), _openConnections.end());
+    _connectionsClosed.notify_all();
+  }
+
+  HttpMessage LoopbackHttpServer::respond(const HttpMessage& request) {
+    HttpMessage response;
+    response.headers.emplace_back("Content-Type", "application/octet-stream");
+
+    // "POST /prov-session HTTP/1.1"
+    size_t pathStart = request.startLine.find(' ');
+    size_t pathEnd = request.startLine.find(' ', pathStart + 1);
+    if (!request.startLine.starts_with("POST ") || pathEnd == std::string::npos || request.startLine[pathStart + 1] != '/') {
+      response.startLine = "HTTP/1.1 405 Method Not Allowed";
+      return response;
+    }
+    std::string_view endpoint = std::string_view(request.startLine).substr(pathStart + 2, pathEnd - pathStart - 2);
+
+    try {
+      response.body = _device->handle(endpoint, request.body);
+      response.startLine = "HTTP/1.1 200 OK";
+    } catch (const std::exception& e) {
+      response.startLine = "HTTP/1.1 500 Internal Server Error";
+      response.body = toBytes(e.what());
+    }
+    return response;
+  }
+
+} // namespace espprov::sim
@@ -0,0 +1,80 @@
+///
+/// LoopbackHttpServer.hpp
+/// Serves a simulated device over protocomm-over-HTTP on 127.0.0.1, like `protocomm_httpd` on the SoftAP.
+///
+
+#pragma once
+
+#include "Http.hpp"
+#include "SimulatedDevice.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace espprov::sim {
+
+  struct LoopbackHttpServerOptions {
+    /// 0 picks a free port, see `LoopbackHttpServer::port()`.
+    uint16_t port = 0;
+    /// Added before every response, to model the radio round trip of a real SoftAP link.
+    std::chrono::milliseconds latency{0};
+    /// Added once before the first response on each connection, to model TCP setup on the SoftAP.
+    std::chrono::milliseconds connectLatency{0};
+  };
+
+  /**
+   * Accepts `POST /<endpoint>` requests and answers them with `SimulatedDevice::handle`.
+   *
+   * Connections are kept alive unless the client asks otherwise, each one served by its own
+   * detached thread. Requests the device rejects are answered with `500 Internal Server Error`.
+   */
+  class LoopbackHttpServer {
+  public:
+    /**
+     * Binds and starts listening right away. Throws `std::runtime_error` if the port is taken.
+     */
+    LoopbackHttpServer(std::shared_ptr<SimulatedDevice> device, LoopbackHttpServerOptions options = {});
+    ~LoopbackHttpServer();
+
+    LoopbackHttpServer(const LoopbackHttpServer&) = delete;
+    LoopbackHttpServer& operator=(const LoopbackHttpServer&) = delete;
+
+    uint16_t port() const noexcept {
+      return _port;
+    }
+
+    /**
+     * The number of TCP connections accepted so far.
+     */
+    uint64_t connectionCount() const noexcept {
+      return _connectionCount.load();
+    }
+
+    /**
+     * Stops accepting, closes every open connection and joins all threads. Idempotent.
+     */
+    void stop() noexcept;
+
+  private:
+    void acceptLoop();
+    void serve(int fd);
+    HttpMessage respond(const HttpMessage& request);
+
+  private:
+    std::shared_ptr<SimulatedDevice> _device;
+    LoopbackHttpServerOptions _options;
+    Socket _listener;
+    uint16_t _port = 0;
+    std::atomic<bool> _running{true};
+    std::atomic<uint64_t> _connectionCount{0};
+    std::thread _acceptThread;
+    std::mutex _connectionsMutex;
+    std::condition_variable _connectionsClosed;
+    std::vector<int> _openConnections;
+  };
+
+} // namespace espprov::sim
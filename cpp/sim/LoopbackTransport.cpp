@@ -0,0 +1,65 @@
+///
+/// LoopbackTransport.cpp
+/// Host side `espprov::Transport` that talks protocomm-over-HTTP to a simulated device.
+///
+
+#include "LoopbackTransport.hpp"
+#include "Http.hpp"
+#include "core/Errors.hpp"
+
+namespace espprov::sim {
+
+  LoopbackTransport::LoopbackTransport(std::string host, uint16_t port): _host(std::move(host)), _port(port) {}
+
+  void LoopbackTransport::connect(std::chrono::milliseconds timeout) {
+    if (_connected) {
+      return;
+    }
+    // Make sure the device answers at all, the SoftAP equivalent of joining its network.
+    try {
+      Socket::connect(_host, _port, timeout);
+    } catch (const std::exception& e) {
+      throw ProtocommError(ErrorCode::SOFTAP_CONNECTION_FAILURE, e.what());
+    }
+    _connectTimeout = timeout;
+    _connected = true;
+  }
+
+  Bytes LoopbackTransport::exchange(std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout) {
+    if (!_connected) {
+      throw ProtocommError(ErrorCode::SESSION_NOT_ESTABLISHED, "Transport to " + _host + " is not connected");
+    }
+    std::optional<HttpMessage> response;
+    try {
+      Socket socket = Socket::connect(_host, _port, _connectTimeout);
+      socket.setTimeout(timeout);
+
+      HttpMessage request;
+      request.startLine = "POST /" + std::string(endpoint) + " HTTP/1.1";
+      request.headers = {
+          {"Host", _host + ":" + std::to_string(_port)},
+          {"Content-Type", "application/x-www-form-urlencoded"},
+          {"Accept", "text/plain"},
+          {"Connection", "close"},
+      };
+      request.body.assign(payload.begin(), payload.end());
+      writeHttpMessage(socket, request);
+      response = readHttpMessage(socket);
+    } catch (const std::exception& e) {
+      throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Request to " + std::string(endpoint) + " failed: " + e.what());
+    }
+
+    if (!response.has_value()) {
+      throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, "Device closed the connection on " + std::string(endpoint));
+    }
+    if (!response->startLine.starts_with("HTTP/1.1 200") && !response->startLine.starts_with("HTTP/1.0 200")) {
+      throw ProtocommError(ErrorCode::SESSION_SEND_DATA_ERROR, std::string(endpoint) + " answered " + response->startLine);
+    }
+    return std::move(response->body);
+  }
+
+  void LoopbackTransport::disconnect() noexcept {
+    _connected = false;
+  }
+
+} // namespace espprov::sim
@@ -0,0 +1,37 @@
+///
+/// LoopbackTransport.hpp
+/// Host side `espprov::Transport` that talks protocomm-over-HTTP to a simulated device.
+///
+
+#pragma once
+
+#include "core/Transport.hpp"
+#include <chrono>
+#include <string>
+
+namespace espprov::sim {
+
+  /**
+   * Posts every exchange to `http://<host>:<port>/<endpoint>` on a fresh `Connection: close`
+   * request, which is how the Espressif SDKs drive the SoftAP link.
+   */
+  class LoopbackTransport final : public Transport {
+  public:
+    LoopbackTransport(std::string host, uint16_t port);
+
+    void connect(std::chrono::milliseconds timeout) override;
+    Bytes exchange(std::string_view endpoint, ByteView payload, std::chrono::milliseconds timeout) override;
+    void disconnect() noexcept override;
+
+    bool isConnected() const noexcept override {
+      return _connected;
+    }
+
+  private:
+    std::string _host;
+    uint16_t _port;
+    std::chrono::milliseconds _connectTimeout{0};
+    bool _connected = false;
+  };
+
+} // namespace espprov::sim
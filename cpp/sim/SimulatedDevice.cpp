@@ -0,0 +1,228 @@
+///
+/// SimulatedDevice.cpp
+/// A simulated ESP32 provisioning peer: protocomm endpoints, Wi-Fi scan and Wi-Fi config.
+///
+
+#include "SimulatedDevice.hpp"
+#include "core/ProtocommSession.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace espprov::sim {
+
+  namespace {
+    SimulatedNetwork network(std::string ssid, uint8_t id, uint32_t channel, int32_t rssi, proto::WifiAuthMode auth,
+                             std::string passphrase) {
+      return SimulatedNetwork{
+          .ssid = std::move(ssid),
+          .bssid = Bytes{0x24, 0x0A, 0xC4, 0x00, 0x00, id},
+          .channel = channel,
+          .rssi = rssi,
+          .auth = auth,
+          .passphrase = std::move(passphrase),
+      };
+    }
+  } // namespace
+
+  SimulatedDevice::SimulatedDevice(SimulatedDeviceConfig config): _config(std::move(config)) {
+    if (_config.networks.empty()) {
+      _config.networks = defaultNetworks();
+    }
+    _security = makeDeviceSecurity(_config.security, _config.proofOfPossession, _config.username);
+  }
+
+  SimulatedDevice::~SimulatedDevice() = default;
+
+  std::vector<SimulatedNetwork> SimulatedDevice::defaultNetworks() {
+    return {
+        network("HomeNetwork", 1, 6, -42, proto::WifiAuthMode::WPA2_PSK, "password123"),
+        network("Office-5G", 2, 36, -58, proto::WifiAuthMode::WPA2_WPA3_PSK, "correct horse"),
+        network("CoffeeShop", 3, 11, -71, proto::WifiAuthMode::OPEN, ""),
+        network("Neighbour", 4, 1, -80, proto::WifiAuthMode::WPA_WPA2_PSK, "hunter22"),
+        network("IoT-Lab", 5, 6, -64, proto::WifiAuthMode::WPA3_PSK, "esp32-lab"),
+        network("Guest", 6, 11, -75, proto::WifiAuthMode::WPA2_PSK, "welcome!"),
+    };
+  }
+
+  void SimulatedDevice::setCustomEndpoint(std::string endpoint, EndpointHandler handler) {
+    std::lock_guard lock(_mutex);
+    _customEndpoints[std::move(endpoint)] = std::move(handler);
+  }
+
+  std::optional<std::string> SimulatedDevice::provisionedSsid() const {
+    std::lock_guard lock(_mutex);
+    if (!_appliedConfig.has_value()) {
+      return std::nullopt;
+    }
+    return std::string(asString(_appliedConfig->ssid));
+  }
+
+  uint32_t SimulatedDevice::statusPolls() const {
+    std::lock_guard lock(_mutex);
+    return _statusPolls;
+  }
+
+  std::string SimulatedDevice::versionInfo() const {
+    std::string caps = "\"wifi_scan\"";
+    if (_config.security == SecurityScheme::SEC0) {
+      caps += ",\"no_sec\"";
+    } else if (_config.security == SecurityScheme::SEC1 && _config.proofOfPossession.empty()) {
+      caps += ",\"no_pop\"";
+    }
+    return "{\"prov\":{\"ver\":\"v1.1\",\"sec_ver\":" + std::to_string(static_cast<int>(_config.security)) +
+           ",\"sec_patch_ver\":0,\"cap\":[" + caps + "]}}";
+  }
+
+  Bytes SimulatedDevice::handle(std::string_view endpoint, ByteView payload) {
+    std::lock_guard lock(_mutex);
+
+    if (endpoint == endpoints::PROTO_VER) {
+      return toBytes(versionInfo());
+    }
+    if (endpoint == endpoints::PROV_SESSION) {
+      proto::SessionData request = proto::decodeSessionData(payload);
+      if (static_cast<uint32_t>(request.secVer) != static_cast<uint32_t>(_config.security)) {
+        throw std::runtime_error("Client requested security scheme " + std::to_string(static_cast<uint32_t>(request.secVer)));
+      }
+      return proto::encodeSessionData(_security->handle(request));
+    }
+
+    if (!_security->isEstablished()) {
+      throw std::runtime_error("No session established for " + std::string(endpoint));
+    }
+    Bytes request = _security->decrypt(payload);
+    Bytes response;
+    if (endpoint == endpoints::PROV_SCAN) {
+      response = handleScan(request);
+    } else if (endpoint == endpoints::PROV_CONFIG) {
+      response = handleConfig(request);
+    } else if (auto it = _customEndpoints.find(std::string(endpoint)); it != _customEndpoints.end()) {
+      response = it->second(request);
+    } else {
+      response = std::move(request);
+    }
+    return _security->encrypt(response);
+  }
+
+  Bytes SimulatedDevice::handleScan(ByteView encoded) {
+    proto::WiFiScanPayload request = proto::decodeWiFiScanPayload(encoded);
+    proto::WiFiScanPayload response;
+    response.msg = static_cast<proto::WiFiScanMsgType>(static_cast<uint32_t>(request.msg) + 1);
+
+    auto resultCount = static_cast<uint32_t>(_config.networks.size());
+    switch (request.msg) {
+      case proto::WiFiScanMsgType::TYPE_CMD_SCAN_START: {
+        proto::CmdScanStart start = proto::decodeCmdScanStart(request.body);
+        if (start.blocking && _config.scanDuration.count() > 0) {
+          std::this_thread::sleep_for(_config.scanDuration);
+        }
+        _scanFinished = true;
+        break;
+      }
+      case proto::WiFiScanMsgType::TYPE_CMD_SCAN_STATUS: {
+        proto::RespScanStatus status{.scanFinished = _scanFinished, .resultCount = _scanFinished ? resultCount : 0};
+        response.body = proto::encodeRespScanStatus(status);
+        break;
+      }
+      case proto::WiFiScanMsgType::TYPE_CMD_SCAN_RESULT: {
+        proto::CmdScanResult page = proto::decodeCmdScanResult(request.body);
+        if (!_scanFinished || page.startIndex >= resultCount) {
+          response.status = proto::Status::INVALID_ARGUMENT;
+          break;
+        }
+        proto::RespScanResult result;
+        uint32_t end = std::min(resultCount, page.startIndex + page.count);
+        for (uint32_t i = page.startIndex; i < end; i++) {
+          const SimulatedNetwork& network = _config.networks[i];
+          result.entries.push_back(proto::WiFiScanResult{
+              .ssid = toBytes(network.ssid),
+              .channel = network.channel,
+              .rssi = network.rssi,
+              .bssid = network.bssid,
+              .auth = network.auth,
+          });
+        }
+        response.body = proto::encodeRespScanResult(result);
+        break;
+      }
+      default:
+        response.status = proto::Status::INVALID_PROTO;
+        break;
+    }
+    return proto::encodeWiFiScanPayload(response);
+  }
+
+  Bytes SimulatedDevice::handleConfig(ByteView encoded) {
+    proto::WiFiConfigPayload request = proto::decodeWiFiConfigPayload(encoded);
+    proto::WiFiConfigPayload response;
+    response.msg = static_cast<proto::WiFiConfigMsgType>(static_cast<uint32_t>(request.msg) + 1);
+
+    switch (request.msg) {
+      case proto::WiFiConfigMsgType::TYPE_CMD_GET_STATUS:
+        response.body = proto::encodeRespGetStatus(stationStatus());
+        break;
+      case proto::WiFiConfigMsgType::TYPE_CMD_SET_CONFIG:
+        _pendingConfig = proto::decodeCmdSetConfig(request.body);
+        response.body = proto::encodeRespConfigStatus({});
+        break;
+      case proto::WiFiConfigMsgType::TYPE_CMD_APPLY_CONFIG: {
+        proto::RespConfigStatus status;
+        if (_pendingConfig.has_value()) {
+          _appliedConfig = std::move(_pendingConfig);
+          _pendingConfig.reset();
+          _statusPolls = 0;
+          _appliedAt = std::chrono::steady_clock::now();
+        } else {
+          status.status = proto::Status::INVALID_ARGUMENT;
+        }
+        response.body = proto::encodeRespConfigStatus(status);
+        break;
+      }
+      default:
+        throw std::runtime_error("Unknown Wi-Fi config message");
+    }
+    return proto::encodeWiFiConfigPayload(response);
+  }
+
+  proto::RespGetStatus SimulatedDevice::stationStatus() {
+    proto::RespGetStatus status;
+    if (!_appliedConfig.has_value()) {
+      status.staState = proto::WifiStationState::DISCONNECTED;
+      return status;
+    }
+    bool joining = std::chrono::steady_clock::now() - _appliedAt < _config.joinDuration;
+    if (_statusPolls++ < _config.connectingPolls || joining) {
+      status.staState = proto::WifiStationState::CONNECTING;
+      return status;
+    }
+
+    std::string_view ssid = asString(_appliedConfig->ssid);
+    auto network = std::find_if(_config.networks.begin(), _config.networks.end(),
+                                [&](const SimulatedNetwork& candidate) { return candidate.ssid == ssid; });
+    std::optional<proto::WifiConnectFailedReason> failReason = _config.failReason;
+    if (!failReason.has_value()) {
+      if (network == _config.networks.end()) {
+        failReason = proto::WifiConnectFailedReason::NETWORK_NOT_FOUND;
+      } else if (network->auth != proto::WifiAuthMode::OPEN && asString(_appliedConfig->passphrase) != network->passphrase) {
+        failReason = proto::WifiConnectFailedReason::AUTH_ERROR;
+      }
+    }
+    if (failReason.has_value()) {
+      status.staState = proto::WifiStationState::CONNECTION_FAILED;
+      status.failReason = failReason;
+      return status;
+    }
+
+    status.staState = proto::WifiStationState::CONNECTED;
+    status.connected = proto::WifiConnectedState{
+        .ip4Addr = _config.ip4Addr,
+        .authMode = network->auth,
+        .ssid = toBytes(network->ssid),
+        .bssid = network->bssid,
+        .channel = static_cast<int32_t>(network->channel),
+    };
+    return status;
+  }
+
+} // namespace espprov::sim
@@ -0,0 +1,121 @@
+///
+/// SimulatedDevice.hpp
+/// A simulated ESP32 provisioning peer: protocomm endpoints, Wi-Fi scan and Wi-Fi config.
+///
+
+#pragma once
+
+#include "DeviceSecurity.hpp"
+#include "core/Bytes.hpp"
+#include "proto/Messages.hpp"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace espprov::sim {
+
+  /**
+   * An access point the simulated device "sees" during a scan and may be provisioned onto.
+   */
+  struct SimulatedNetwork {
+    std::string ssid;
+    /// 6 raw bytes.
+    Bytes bssid;
+    uint32_t channel = 1;
+    int32_t rssi = -50;
+    proto::WifiAuthMode auth = proto::WifiAuthMode::WPA2_PSK;
+    /// The passphrase the device accepts. Ignored for open networks.
+    std::string passphrase;
+  };
+
+  struct SimulatedDeviceConfig {
+    SecurityScheme security = SecurityScheme::SEC2;
+    std::string proofOfPossession = "abcd1234";
+    std::string username = "wifiprov";
+    std::vector<SimulatedNetwork> networks;
+    /// How long a blocking `CmdScanStart` takes to answer.
+    std::chrono::milliseconds scanDuration{0};
+    /// How many `CmdGetStatus` polls report `CONNECTING` before the final state.
+    uint32_t connectingPolls = 1;
+    /// How long after `CmdApplyConfig` the station keeps reporting `CONNECTING` regardless of the
+    /// polls, like a real join.
+    std::chrono::milliseconds joinDuration{0};
+    /**
+     * Forces the outcome of every provisioning attempt. Without it the device joins a network from
+     * `networks` when the passphrase matches, fails with `AUTH_ERROR` when it does not and with
+     * `NETWORK_NOT_FOUND` for unknown SSIDs.
+     */
+    std::optional<proto::WifiConnectFailedReason> failReason;
+    /// The IPv4 address reported once connected.
+    std::string ip4Addr = "192.168.1.42";
+  };
+
+  /**
+   * The device side of the protocomm protocol, independent of the transport carrying it.
+   *
+   * Every endpoint except `proto-ver` and `prov-session` requires an established session and sees
+   * decrypted payloads. Unknown endpoints go to the handler registered with `setCustomEndpoint`, or
+   * are echoed back. Thread safe; requests are serialized like on the real firmware.
+   */
+  class SimulatedDevice {
+  public:
+    using EndpointHandler = std::function<Bytes(ByteView request)>;
+
+    explicit SimulatedDevice(SimulatedDeviceConfig config);
+    ~SimulatedDevice();
+
+    SimulatedDevice(const SimulatedDevice&) = delete;
+    SimulatedDevice& operator=(const SimulatedDevice&) = delete;
+
+    const SimulatedDeviceConfig& config() const noexcept {
+      return _config;
+    }
+
+    /**
+     * The default scan list used when the config does not provide one.
+     */
+    static std::vector<SimulatedNetwork> defaultNetworks();
+
+    void setCustomEndpoint(std::string endpoint, EndpointHandler handler);
+
+    /**
+     * Handles one raw protocomm request. Throws `std::runtime_error` for requests the firmware
+     * would reject with an HTTP error (bad handshake, no session, malformed payload).
+     */
+    Bytes handle(std::string_view endpoint, ByteView payload);
+
+    /**
+     * The credentials received by the last `CmdSetConfig`, if any.
+     */
+    std::optional<std::string> provisionedSsid() const;
+
+    /**
+     * The `CmdGetStatus` requests since the last `CmdApplyConfig`.
+     */
+    uint32_t statusPolls() const;
+
+  private:
+    std::string versionInfo() const;
+    Bytes handleScan(ByteView request);
+    Bytes handleConfig(ByteView request);
+    proto::RespGetStatus stationStatus();
+
+  private:
+    SimulatedDeviceConfig _config;
+    mutable std::mutex _mutex;
+    std::unique_ptr<DeviceSecurity> _security;
+    std::unordered_map<std::string, EndpointHandler> _customEndpoints;
+    bool _scanFinished = false;
+    std::optional<proto::CmdSetConfig> _pendingConfig;
+    std::optional<proto::CmdSetConfig> _appliedConfig;
+    uint32_t _statusPolls = 0;
+    std::chrono::steady_clock::time_point _appliedAt;
+  };
+
+} // namespace espprov::sim
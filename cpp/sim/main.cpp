@@ -0,0 +1,159 @@
+///
+/// main.cpp
+/// `espprov-sim`: runs a simulated ESP provisioning device on a loopback port until interrupted.
+///
+
+#include "LoopbackHttpServer.hpp"
+#include "SimulatedDevice.hpp"
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace espprov;
+using namespace espprov::sim;
+
+namespace {
+  constexpr const char* USAGE = R"(Usage: espprov-sim [options]
+
+  --port N               TCP port on 127.0.0.1 (default: 8080, 0 picks a free one)
+  --security 0|1|2       protocomm security scheme (default: 2)
+  --pop STRING           proof of possession (default: abcd1234)
+  --username STRING      Sec2 username (default: wifiprov)
+  --networks FILE        scan list, one network per line:
+                         ssid<TAB>bssid<TAB>channel<TAB>rssi<TAB>auth<TAB>passphrase
+                         bssid is 12 hex digits, auth is the wifi_constants.proto value
+  --fail auth|not-found  fail every provisioning attempt with this reason
+  --scan-ms N            duration of a blocking Wi-Fi scan (default: 0)
+  --connecting-polls N   status polls answered with CONNECTING (default: 1)
+  --join-ms N            time after applying the config answered with CONNECTING (default: 0)
+  --latency-ms N         delay added to every HTTP response (default: 0)
+  --connect-latency-ms N delay added once per TCP connection (default: 0)
+)";
+
+  [[noreturn]] void fail(const std::string& message) {
+    std::cerr << "espprov-sim: " << message << "\n\n" << USAGE;
+    std::exit(2);
+  }
+
+  Bytes parseHex(const std::string& hex) {
+    if (hex.size() % 2 != 0) {
+      fail("odd number of hex digits in " + hex);
+    }
+    Bytes bytes;
+    for (size_t i = 0; i < hex.size(); i += 2) {
+      bytes.push_back(static_cast<uint8_t>(std::stoul(hex.substr(i, 2), nullptr, 16)));
+    }
+    return bytes;
+  }
+
+  std::vector<SimulatedNetwork> loadNetworks(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+      fail("cannot open " + path);
+    }
+    std::vector<SimulatedNetwork> networks;
+    std::string line;
+    while (std::getline(file, line)) {
+      if (line.empty() || line.front() == '#') {
+        continue;
+      }
+      std::vector<std::string> fields;
+      std::stringstream stream(line);
+      std::string field;
+      while (std::getline(stream, field, '\t')) {
+        fields.push_back(field);
+      }
+      if (fields.size() < 5) {
+        fail("expected at least 5 tab separated fields in: " + line);
+      }
+      networks.push_back(SimulatedNetwork{
+          .ssid = fields[0],
+          .bssid = parseHex(fields[1]),
+          .channel = static_cast<uint32_t>(std::stoul(fields[2])),
+          .rssi = std::stoi(fields[3]),
+          .auth = static_cast<proto::WifiAuthMode>(std::stoul(fields[4])),
+          .passphrase = fields.size() > 5 ? fields[5] : "",
+      });
+    }
+    return networks;
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  SimulatedDeviceConfig config;
+  LoopbackHttpServerOptions options{.port = 8080};
+
+  for (int i = 1; i < argc; i++) {
+    std::string option = argv[i];
+    if (option == "--help" || option == "-h") {
+      std::cout << USAGE;
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      fail("missing value for " + option);
+    }
+    std::string value = argv[++i];
+    try {
+      if (option == "--port") {
+        options.port = static_cast<uint16_t>(std::stoul(value));
+      } else if (option == "--security") {
+        unsigned scheme = std::stoul(value);
+        if (scheme > 2) {
+          fail("unknown security scheme " + value);
+        }
+        config.security = static_cast<SecurityScheme>(scheme);
+      } else if (option == "--pop") {
+        config.proofOfPossession = value;
+      } else if (option == "--username") {
+        config.username = value;
+      } else if (option == "--networks") {
+        config.networks = loadNetworks(value);
+      } else if (option == "--fail") {
+        if (value == "auth") {
+          config.failReason = proto::WifiConnectFailedReason::AUTH_ERROR;
+        } else if (value == "not-found") {
+          config.failReason = proto::WifiConnectFailedReason::NETWORK_NOT_FOUND;
+        } else {
+          fail("unknown failure reason " + value);
+        }
+      } else if (option == "--scan-ms") {
+        config.scanDuration = std::chrono::milliseconds(std::stoul(value));
+      } else if (option == "--connecting-polls") {
+        config.connectingPolls = static_cast<uint32_t>(std::stoul(value));
+      } else if (option == "--join-ms") {
+        config.joinDuration = std::chrono::milliseconds(std::stoul(value));
+      } else if (option == "--latency-ms") {
+        options.latency = std::chrono::milliseconds(std::stoul(value));
+      } else if (option == "--connect-latency-ms") {
+        options.connectLatency = std::chrono::milliseconds(std::stoul(value));
+      } else {
+        fail("unknown option " + option);
+      }
+    } catch (const std::logic_error&) {
+      fail("invalid value for " + option + ": " + value);
+    }
+  }
+
+  // Block the shutdown signals before any thread starts, so only sigwait() below receives them.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  auto device = std::make_shared<SimulatedDevice>(config);
+  LoopbackHttpServer server(device, options);
+  std::cout << "Simulated ESP device (sec" << static_cast<int>(config.security) << ", "
+            << device->config().networks.size() << " networks) listening on http://127.0.0.1:" << server.port() << std::endl;
+
+  int received = 0;
+  sigwait(&signals, &received);
+  server.stop();
+  if (auto ssid = device->provisionedSsid()) {
+    std::cout << "Last provisioned network: " << *ssid << std::endl;
+  }
+  return 0;
+}
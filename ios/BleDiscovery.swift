@@ -0,0 +1,119 @@
+//
+//  BleDiscovery.swift
+//  EspProvToolkit
+//
+
+import Foundation
+import CoreBluetooth
+import ESPProvision
+
+/// A streaming BLE scan for ESP devices.
+///
+/// `ESPProvisionManager.searchESPDevices` only reports once its scan window closes, so this scans
+/// with CoreBluetooth directly and hands out every matching name the first time it is seen.
+/// Names are pulled with `next()`. While `bufferSize` names wait for a consumer, new devices are
+/// not marked as seen and are picked up again from their next advertisement. Concurrent `next()`
+/// calls wait in line, like receivers of the channel the Android discovery reads from.
+class BleDiscovery : NSObject, CBCentralManagerDelegate {
+  private let devicePrefix : String
+  private let scanTimeout : TimeInterval
+  private let bufferSize : Int
+  /// Serializes the CoreBluetooth callbacks with `next()` and `stop()`
+  private let queue = DispatchQueue(label: "EspProvToolkit.BleDiscovery")
+  private var centralManager : CBCentralManager?
+
+  private var seen : Set<String> = []
+  private var pending : [String] = []
+  private var waiters : [CheckedContinuation<[String], Error>] = []
+  private var finished = false
+  private var failure : Error?
+
+  init(devicePrefix : String, scanTimeout : TimeInterval = 5.0, bufferSize : Int = 32){
+    self.devicePrefix = devicePrefix
+    self.scanTimeout = scanTimeout
+    self.bufferSize = bufferSize
+    super.init()
+  }
+
+  func start(){
+    queue.async {
+      self.centralManager = CBCentralManager(delegate: self, queue: self.queue)
+      self.queue.asyncAfter(deadline: .now() + self.scanTimeout) { self.finish(with: nil) }
+    }
+  }
+
+  /// Waits for at least one new device and returns every name found since the last call.
+  /// An empty array means the scan has ended.
+  func next() async throws -> [String] {
+    return try await withCheckedThrowingContinuation { continuation in
+      queue.async {
+        if !self.pending.isEmpty {
+          let names = self.pending
+          self.pending.removeAll()
+          continuation.resume(returning: names)
+        } else if self.finished {
+          if let error = self.failure {
+            continuation.resume(throwing: error)
+          } else {
+            continuation.resume(returning: [])
+          }
+        } else {
+          self.waiters.append(continuation)
+        }
+      }
+    }
+  }
+
+  func stop(){
+    queue.async { self.finish(with: nil) }
+  }
+
+  private func finish(with error : Error?){
+    guard !finished else { return }
+    finished = true
+    failure = error
+    if let manager = centralManager, manager.state == .poweredOn {
+      manager.stopScan()
+    }
+    centralManager = nil
+    // Waiters only exist while nothing is pending, all of them see the end.
+    let ended = waiters
+    waiters.removeAll()
+    for waiter in ended {
+      if let error = error {
+        waiter.resume(throwing: error)
+      } else {
+        waiter.resume(returning: [])
+      }
+    }
+  }
+
+  func centralManagerDidUpdateState(_ central: CBCentralManager) {
+    switch central.state {
+    case .poweredOn:
+      // Duplicates let a device that did not fit into the buffer be picked up later.
+      central.scanForPeripherals(withServices: nil, options: [CBCentralManagerScanOptionAllowDuplicatesKey: true])
+    case .unauthorized, .unsupported, .poweredOff:
+      finish(with: ESPDeviceCSSError.espDeviceNotFound)
+    default:
+      return
+    }
+  }
+
+  func centralManager(_ central: CBCentralManager, didDiscover peripheral: CBPeripheral,
+                      advertisementData: [String : Any], rssi RSSI: NSNumber) {
+    guard !finished,
+          let name = advertisementData[CBAdvertisementDataLocalNameKey] as? String ?? peripheral.name,
+          name.hasPrefix(devicePrefix),
+          !seen.contains(name),
+          pending.count < bufferSize else {
+      return
+    }
+    seen.insert(name)
+    if !waiters.isEmpty {
+      waiters.removeFirst().resume(returning: [name])
+    } else {
+      pending.append(name)
+    }
+  }
+}
@@ -0,0 +1,120 @@
+//
+//  DeviceRegistry.swift
+//  EspProvToolkit
+//
+
+import Foundation
+import ESPProvision
+
+/// The process wide store of `ESPDevice` instances, bounded by count and by idle time.
+///
+/// Whenever the registry is touched, entries idle for longer than `idleTimeout` and the least
+/// recently used ones beyond `maxDevices` are dropped, and `onRelease` is called for each of them
+/// so their link and session can be torn down. Entries `isSecured` reports are kept however long
+/// they idle, only `maxDevices` drops them.
+class DeviceRegistry {
+  static let defaultMaxDevices = 64
+  static let defaultIdleTimeout : TimeInterval = 10 * 60
+
+  private struct Entry {
+    let device : ESPDevice
+    var lastUsed : TimeInterval
+  }
+
+  private let lock = NSLock()
+  private var entries : [String : Entry] = [:]
+  private var maxDevices = DeviceRegistry.defaultMaxDevices
+  private var idleTimeout = DeviceRegistry.defaultIdleTimeout
+  private let isSecured : (String) -> Bool
+  private let onRelease : (String, ESPDevice) -> Void
+
+  init(isSecured : @escaping (String) -> Bool, onRelease : @escaping (String, ESPDevice) -> Void){
+    self.isSecured = isSecured
+    self.onRelease = onRelease
+  }
+
+  private static func now() -> TimeInterval {
+    return ProcessInfo.processInfo.systemUptime
+  }
+
+  func setLimits(maxDevices : Int, idleTimeout : TimeInterval){
+    release(withLock {
+      self.maxDevices = max(maxDevices, 1)
+      self.idleTimeout = max(idleTimeout, 0)
+      return evict()
+    })
+  }
+
+  func put(_ device : ESPDevice, forKey key : String){
+    release(withLock {
+      var released : [(String, ESPDevice)] = []
+      if let previous = entries[key], previous.device !== device {
+        released.append((key, previous.device))
+      }
+      entries[key] = Entry(device: device, lastUsed: DeviceRegistry.now())
+      return released + evict()
+    })
+  }
+
+  func get(_ key : String) -> ESPDevice? {
+    var device : ESPDevice?
+    release(withLock {
+      // Touch first: a device that is asked for again is not idle, however long it waited.
+      if entries[key] != nil {
+        entries[key]!.lastUsed = DeviceRegistry.now()
+        device = entries[key]!.device
+      }
+      return evict()
+    })
+    return device
+  }
+
+  @discardableResult
+  func remove(_ key : String) -> Bool {
+    let released = withLock { () -> [(String, ESPDevice)] in
+      guard let entry = entries.removeValue(forKey: key) else { return [] }
+      return [(key, entry.device)]
+    }
+    release(released)
+    return !released.isEmpty
+  }
+
+  func removeAll(){
+    release(withLock {
+      let released = entries.map { ($0.key, $0.value.device) }
+      entries.removeAll()
+      return released
+    })
+  }
+
+  private func withLock<T>(_ body : () -> T) -> T {
+    lock.lock()
+    defer { lock.unlock() }
+    return body()
+  }
+
+  /// Drops expired entries, then the least recently used ones above the limit. Must hold `lock`.
+  private func evict() -> [(String, ESPDevice)] {
+    let now = DeviceRegistry.now()
+    var released : [(String, ESPDevice)] = []
+    for (key, entry) in entries where now - entry.lastUsed > idleTimeout && !isSecured(key) {
+      entries.removeValue(forKey: key)
+      released.append((key, entry.device))
+    }
+    if entries.count > maxDevices {
+      let oldest = entries.sorted { $0.value.lastUsed < $1.value.lastUsed }.prefix(entries.count - maxDevices)
+      for (key, entry) in oldest {
+        entries.removeValue(forKey: key)
+        released.append((key, entry.device))
+      }
+    }
+    return released
+  }
+
+  /// Runs `onRelease` outside the lock, it may call back into the SDK.
+  private func release(_ released : [(String, ESPDevice)]){
+    for (key, device) in released {
+      onRelease(key, device)
+    }
+  }
+}
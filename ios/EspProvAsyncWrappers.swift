@@ -6,6 +6,7 @@
 //
 
 import Foundation
+import CoreBluetooth
 import ESPProvision
 
 
@@ -74,13 +75,20 @@ extension ESPProvisionManager {
 
 extension ESPDevice {
   
-  func connectAsync() async throws -> ESPSessionStatus {
+  // The SDK calls connect's handler again with .disconnected when the link drops later on,
+  // that call goes to onDisconnect.
+  func connectAsync(onDisconnect: (() -> Void)? = nil) async throws -> ESPSessionStatus {
     // Safety check so that resume NEVER gets called more than once.
     var hasResumed = false
     return try await withCheckedThrowingContinuation { continuation in
       self.connect { espStatus in
         // At this point, the call resolved and we need to resume
-        guard !hasResumed else { return }
+        guard !hasResumed else {
+          if case .disconnected = espStatus {
+            onDisconnect?()
+          }
+          return
+        }
         hasResumed = true
         switch espStatus{
         case .connected,.disconnected:
@@ -112,6 +120,41 @@ extension ESPDevice {
     }
   }
   
+  // ESPDevice keeps its transport internal, but the native engine needs the raw link.
+  private var rawTransport: ESPCommunicable? {
+    return Mirror(reflecting: self).children.first { $0.label == "transportLayer" }?.value as? ESPCommunicable
+  }
+  
+  // The peripheral the SDK's scan found for a BLE device, which RawBleLink connects to.
+  var blePeripheralId: UUID? {
+    let peripheral = Mirror(reflecting: self).children.first { $0.label == "peripheral" }?.value as? CBPeripheral
+    return peripheral?.identifier
+  }
+  
+  // Sends bytes to an endpoint as they are, bypassing the SDK session and its encryption.
+  // Used for SoftAP, whose HTTP transport needs no connect; BLE devices go through RawBleLink.
+  func sendRawDataAsync(path : String, data : Data) async throws -> Data{
+    guard let transport = rawTransport else {
+      throw ESPSessionError.sessionNotEstablished
+    }
+    // Safety check so that resume NEVER gets called more than once.
+    var hasResumed = false
+    return try await withCheckedThrowingContinuation { continuation in
+      transport.SendConfigData(path: path, data: data) { espData, espError in
+        guard !hasResumed else { return }
+        hasResumed = true
+        
+        if let data = espData{
+          continuation.resume(returning: data)
+        } else if let error = espError {
+          continuation.resume(throwing: error)
+        } else{
+          continuation.resume(throwing: ESPRuntimeError.badClosureArgs)
+        }
+      }
+    }
+  }
+  
   func provisionAsync(ssid: String, passcode: String = "") async throws -> ESPProvisionStatus {
       // Safety check so that resume NEVER gets called more than once.
       var hasResumed = false
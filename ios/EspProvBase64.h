@@ -0,0 +1,24 @@
+//
+//  EspProvBase64.h
+//  EspProvToolkit
+//
+//  Swift access to the base64 codec of the shared C++ engine (cpp/core/Base64.hpp), with SSSE3
+//  and NEON kernels, used for the string payloads of custom endpoints.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface EspProvBase64 : NSObject
+
+/// The decoded bytes, or nil if the string is not base64. Decoding validates as it goes, there is
+/// no separate check. Line breaks are skipped and padding is optional.
++ (nullable NSData *)decode:(NSString *)base64;
+
+/// Standard alphabet with padding, without line breaks.
++ (NSString *)encode:(NSData *)data;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,34 @@
+//
+//  EspProvBase64.mm
+//  EspProvToolkit
+//
+
+#import "EspProvBase64.h"
+#include "core/Base64.hpp"
+#include "core/Errors.hpp"
+#include <cstring>
+#include <string>
+#include <string_view>
+
+@implementation EspProvBase64
+
++ (nullable NSData *)decode:(NSString *)base64 {
+  const char *utf8 = base64.UTF8String;
+  if (utf8 == nullptr) {
+    return nil;
+  }
+  espprov::Bytes bytes;
+  try {
+    bytes = espprov::decodeBase64(std::string_view(utf8, std::strlen(utf8)));
+  } catch (const espprov::ProtocommError &) {
+    return nil;
+  }
+  return [NSData dataWithBytes:bytes.data() length:bytes.size()];
+}
+
++ (NSString *)encode:(NSData *)data {
+  std::string encoded = espprov::encodeBase64(espprov::ByteView(static_cast<const uint8_t *>(data.bytes), data.length));
+  return [[NSString alloc] initWithBytes:encoded.data() length:encoded.size() encoding:NSASCIIStringEncoding];
+}
+
+@end
@@ -0,0 +1,38 @@
+//
+//  EspProvConnectionStates.h
+//  EspProvToolkit
+//
+//  Swift access to the per-device connection state machines of the shared C++ engine
+//  (cpp/core/ConnectionStateMachine.hpp), which JS reads and listens to.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Values of PTConnectionEvent that the Swift layer posts.
+typedef NS_ENUM(NSInteger, EspProvConnectionEvent) {
+  EspProvConnectionEventLinkUp = 1,
+  EspProvConnectionEventLinkFailed = 2,
+  EspProvConnectionEventLinkDown = 3,
+  EspProvConnectionEventSessionEstablished = 4,
+  EspProvConnectionEventSessionFailed = 5,
+  EspProvConnectionEventDisconnectRequested = 6,
+};
+
+@interface EspProvConnectionStates : NSObject
+
+/// Starts a connect attempt, or joins the running one, and returns its number.
++ (NSInteger)beginConnect:(NSString *)deviceName;
+
+/// Pass 0 as attempt for whichever attempt is current, -1 as error when there is none.
++ (BOOL)post:(EspProvConnectionEvent)event deviceName:(NSString *)deviceName attempt:(NSInteger)attempt error:(NSInteger)error;
+
++ (void)releaseDevice:(NSString *)deviceName;
+
+/// Whether the device's session is established, which keeps it from being dropped for idling.
++ (BOOL)isSecured:(NSString *)deviceName;
+
+@end
+
+NS_ASSUME_NONNULL_END
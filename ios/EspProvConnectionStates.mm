@@ -0,0 +1,36 @@
+//
+//  EspProvConnectionStates.mm
+//  EspProvToolkit
+//
+
+#import "EspProvConnectionStates.h"
+#include "core/ConnectionStateMachine.hpp"
+#include <optional>
+#include <string>
+
+@implementation EspProvConnectionStates
+
++ (NSInteger)beginConnect:(NSString *)deviceName {
+  auto machine = espprov::ConnectionRegistry::shared().machine(std::string(deviceName.UTF8String));
+  return static_cast<NSInteger>(machine->beginConnect());
+}
+
++ (BOOL)post:(EspProvConnectionEvent)event deviceName:(NSString *)deviceName attempt:(NSInteger)attempt error:(NSInteger)error {
+  if (attempt < 0) {
+    return NO;
+  }
+  std::optional<int> code = error >= 0 ? std::optional<int>(static_cast<int>(error)) : std::nullopt;
+  auto machine = espprov::ConnectionRegistry::shared().machine(std::string(deviceName.UTF8String));
+  return machine->post(static_cast<espprov::ConnectionEvent>(event), static_cast<uint64_t>(attempt), code) ? YES : NO;
+}
+
++ (void)releaseDevice:(NSString *)deviceName {
+  espprov::ConnectionRegistry::shared().remove(std::string(deviceName.UTF8String));
+}
+
++ (BOOL)isSecured:(NSString *)deviceName {
+  auto state = espprov::ConnectionRegistry::shared().state(std::string(deviceName.UTF8String));
+  return state == espprov::ConnectionState::SECURED ? YES : NO;
+}
+
+@end
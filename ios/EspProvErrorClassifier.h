@@ -0,0 +1,21 @@
+//
+//  EspProvErrorClassifier.h
+//  EspProvToolkit
+//
+//  Swift access to the error classifier of the shared C++ engine (cpp/core/ErrorClassifier.hpp),
+//  which holds the one table of known SDK error messages for Android and iOS.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface EspProvErrorClassifier : NSObject
+
+/// The PTError code of an error, or -1 if nothing matched. `sdkCode` wins when it is a known
+/// PTError code, pass -1 when the SDK supplied none.
++ (NSInteger)classifyMessage:(nullable NSString *)message sdkCode:(NSInteger)sdkCode;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,21 @@
+//
+//  EspProvErrorClassifier.mm
+//  EspProvToolkit
+//
+
+#import "EspProvErrorClassifier.h"
+#include "core/ErrorClassifier.hpp"
+#include <optional>
+#include <string_view>
+
+@implementation EspProvErrorClassifier
+
++ (NSInteger)classifyMessage:(nullable NSString *)message sdkCode:(NSInteger)sdkCode {
+  std::optional<int> code = sdkCode >= 0 ? std::optional<int>(static_cast<int>(sdkCode)) : std::nullopt;
+  const char *utf8 = message.UTF8String;
+  std::string_view text = utf8 != nullptr ? std::string_view(utf8) : std::string_view();
+  std::optional<espprov::ErrorCode> classified = espprov::ErrorClassifier::shared().classify(text, code);
+  return classified ? static_cast<NSInteger>(*classified) : -1;
+}
+
+@end
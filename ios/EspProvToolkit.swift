@@ -4,21 +4,85 @@ import SystemConfiguration.CaptiveNetwork
 import NetworkExtension
 
 class EspProvToolkit: HybridEspProvToolkitSpec {
-  // Static dict to store EspDevice instances
-  private static var devices : [String : ESPDevice]  = [:];
+  // Bounded store of EspDevice instances. Dropping one closes its link, which ends its session.
+  private static let devices = DeviceRegistry(isSecured: { EspProvConnectionStates.isSecured($0) }) { key, device in
+    let link = EspProvToolkit.withState { () -> RawBleLink? in
+      EspProvToolkit.discoveredDevices.removeValue(forKey: key)
+      return EspProvToolkit.rawLinks.removeValue(forKey: key)
+    }
+    link?.close()
+    device.disconnect()
+    EspProvConnectionStates.releaseDevice(key)
+  }
   
   static private func storeDeviceEntry(_ device : ESPDevice, withkey key: String){
-    devices[key] = device;
+    devices.put(device, forKey: key)
   }
   
   // Due to a force unwrapping in EspProvision, we need to keep track if we are doing BLE Scan,
   // because if you call stop search while you are not searching, it will crash.
   static private var isBLEScanActive : Bool = false;
   
+  // Guards the static state below, which JS calls, async tasks and registry releases all touch.
+  static private let stateLock = NSLock()
+  
+  // BLE links opened for the native engine's raw transport, by device name.
+  static private var rawLinks : [String : RawBleLink] = [:]
+  
+  // The streaming scan started by startDiscoveringESPDevices, if any.
+  static private var discovery : (scan: BleDiscovery, security: PTSecurity)?
+  
+  // Devices reported by a streaming scan. The SDK cannot build an ESPDevice from our own scan,
+  // so they are created by name when they are first connected to.
+  static private var discoveredDevices : [String : (transport: PTTransport, security: PTSecurity)] = [:]
+  
+  static private func postConnectFailure(_ error: ESPSessionError, deviceName: String, attempt: Int){
+    switch error{
+    case .softAPConnectionFailure:
+      // Thrown even when the link is fine, the attempt's timeout decides instead
+      return
+    case .bleFailedToConnect:
+      EspProvConnectionStates.post(.linkFailed, deviceName: deviceName, attempt: attempt, error: Int(PTError(from: error).rawValue))
+    default:
+      EspProvConnectionStates.post(.sessionFailed, deviceName: deviceName, attempt: attempt, error: Int(PTError(from: error).rawValue))
+    }
+  }
+  
+  static private func withState<T>(_ body: () throws -> T) rethrows -> T {
+    stateLock.lock()
+    defer { stateLock.unlock() }
+    return try body()
+  }
+  
+  // Like Android's LINK_DOWN, a drop after the link was up ends the attempt's session.
+  // The next raw send opens a new link.
+  static private func postLinkLost(deviceName: String, transport: ESPTransport, attempt: Int){
+    withState { rawLinks.removeValue(forKey: deviceName) }?.close()
+    let error: ESPSessionError = transport == .ble ? .bleFailedToConnect : .softAPConnectionFailure
+    EspProvConnectionStates.post(.linkDown, deviceName: deviceName, attempt: attempt, error: Int(PTError(from: error).rawValue))
+  }
+  
   static private func getDeviceEntry(forKey key: String) throws -> ESPDevice{
-    guard let device = devices[key] else {
+    guard let device = devices.get(key) else {
+      throw ESPRuntimeError.doesNotExistLocally
+    }
+    return device
+  }
+  
+  static private func getOrCreateDeviceEntry(forKey key: String) async throws -> ESPDevice{
+    if let device = devices.get(key) {
+      return device
+    }
+    guard let discovered = withState({ discoveredDevices[key] }) else {
       throw ESPRuntimeError.doesNotExistLocally
     }
+    let device = try await ESPProvisionManager.shared.createESPDeviceAsync(deviceName: key,
+                                                                           transport: ESPTransport(from: discovered.transport),
+                                                                           security: ESPSecurity(from: discovered.security),
+                                                                           proofOfPossession: nil,
+                                                                           softAPPassword: nil,
+                                                                           username: nil)
+    storeDeviceEntry(device, withkey: key)
     return device
   }
   
@@ -48,6 +112,12 @@ class EspProvToolkit: HybridEspProvToolkitSpec {
   }
   
   func stopSearchingForESPDevices() throws {
+    let discovery = EspProvToolkit.withState { () -> (scan: BleDiscovery, security: PTSecurity)? in
+      let previous = EspProvToolkit.discovery
+      EspProvToolkit.discovery = nil
+      return previous
+    }
+    discovery?.scan.stop()
     // Make sure we dont cancel while scan is not active
     guard EspProvToolkit.isBLEScanActive else {
       ESPProvisionManager.shared.stopESPDevicesSearch()
@@ -56,6 +126,46 @@ class EspProvToolkit: HybridEspProvToolkitSpec {
     }
   }
   
+  func startDiscoveringESPDevices(devicePrefix: String, transport: PTTransport, security: PTSecurity, scanTimeoutMs: Double?) throws -> PTResult {
+    // Like searchESPDevices, iOS can only search for BLE devices.
+    guard transport == .transportBle else {
+      return PTResult(success: false, error: Double(PTError(from: ESPDeviceCSSError.softApSearchNotSupported).rawValue))
+    }
+    let scan = scanTimeoutMs.map { BleDiscovery(devicePrefix: devicePrefix, scanTimeout: $0 / 1000.0) }
+      ?? BleDiscovery(devicePrefix: devicePrefix)
+    let previous = EspProvToolkit.withState { () -> (scan: BleDiscovery, security: PTSecurity)? in
+      let previous = EspProvToolkit.discovery
+      EspProvToolkit.discovery = (scan: scan, security: security)
+      // Names from earlier scans that were never connected to are stale by now.
+      EspProvToolkit.discoveredDevices.removeAll()
+      return previous
+    }
+    previous?.scan.stop()
+    scan.start()
+    return PTResult(success: true, error: nil)
+  }
+  
+  func nextDiscoveredESPDevices() throws -> NitroModules.Promise<PTSearchResult> {
+    return Promise.async{
+      guard let discovery = EspProvToolkit.withState({ EspProvToolkit.discovery }) else {
+        return PTSearchResult(success: true, deviceNames: [], error: nil)
+      }
+      do{
+        let names = try await discovery.scan.next()
+        EspProvToolkit.withState {
+          // A scan started meanwhile has cleared the names of this one
+          if let current = EspProvToolkit.discovery, current.scan !== discovery.scan { return }
+          for name in names {
+            EspProvToolkit.discoveredDevices[name] = (transport: .transportBle, security: discovery.security)
+          }
+        }
+        return PTSearchResult(success: true, deviceNames: names, error: nil)
+      } catch let error as ESPDeviceCSSError {
+        return PTSearchResult(success: false, deviceNames: nil, error: Double(PTError(from: error).rawValue))
+      }
+    }
+  }
+  
   func createESPDevice(deviceName: String, transport: PTTransport, security: PTSecurity, proofOfPossession: String?, softAPPassword: String?, username: String?) throws -> NitroModules.Promise<PTResult> {
     return Promise.async{
       do{
@@ -80,7 +190,8 @@ class EspProvToolkit: HybridEspProvToolkitSpec {
       let _ = try EspProvToolkit.getDeviceEntry(forKey: deviceName)
       return true
     } catch {
-      return false
+      // Discovered devices are created on first connect
+      return EspProvToolkit.withState { EspProvToolkit.discoveredDevices[deviceName] != nil }
     }
   }
   
@@ -108,8 +219,20 @@ class EspProvToolkit: HybridEspProvToolkitSpec {
   func connectToESPDevice(deviceName: String) throws -> NitroModules.Promise<PTSessionResult> {
     return Promise.async{
       do{
-        let device = try EspProvToolkit.getDeviceEntry(forKey: deviceName)
-        let sessionStatus = try await device.connectAsync()
+        let device = try await EspProvToolkit.getOrCreateDeviceEntry(forKey: deviceName)
+        let attempt = EspProvConnectionStates.beginConnect(deviceName)
+        let sessionStatus: ESPSessionStatus
+        do{
+          sessionStatus = try await device.connectAsync { [transport = device.transport] in
+            EspProvToolkit.postLinkLost(deviceName: deviceName, transport: transport, attempt: attempt)
+          }
+        } catch let sessionErr as ESPSessionError {
+          EspProvToolkit.postConnectFailure(sessionErr, deviceName: deviceName, attempt: attempt)
+          throw sessionErr
+        }
+        // connect opens the link and runs the handshake in one step
+        let event: EspProvConnectionEvent = sessionStatus == .connected ? .sessionEstablished : .linkDown
+        EspProvConnectionStates.post(event, deviceName: deviceName, attempt: attempt, error: -1)
         return PTSessionResult(success: true, status: PTSessionStatus(from: sessionStatus), error: nil)
         
       } catch (ESPSessionError.softAPConnectionFailure){
@@ -122,6 +245,10 @@ class EspProvToolkit: HybridEspProvToolkitSpec {
         
       } catch (let rtimeError as ESPRuntimeError){
         return PTSessionResult(success: false, status: nil, error: Double(PTError(from: rtimeError).rawValue))
+        
+      } catch (let cssError as ESPDeviceCSSError){
+        // A discovered device that could not be created on first use
+        return PTSessionResult(success: false, status: nil, error: Double(PTError(from: cssError).rawValue))
       }
     }
   }
@@ -129,7 +256,9 @@ class EspProvToolkit: HybridEspProvToolkitSpec {
   func disconnectFromESPDevice(deviceName: String) throws -> PTResult {
     do{
       let device = try EspProvToolkit.getDeviceEntry(forKey: deviceName)
+      EspProvToolkit.withState { EspProvToolkit.rawLinks.removeValue(forKey: deviceName) }?.close()
       device.disconnect()
+      EspProvConnectionStates.post(.disconnectRequested, deviceName: deviceName, attempt: 0, error: -1)
       return PTResult(success: true, error: nil)
       
     } catch(let rtimeError as ESPRuntimeError){
@@ -137,6 +266,23 @@ class EspProvToolkit: HybridEspProvToolkitSpec {
     }
   }
   
+  func releaseESPDevice(deviceName: String) throws -> Bool {
+    let discovered = EspProvToolkit.withState { EspProvToolkit.discoveredDevices.removeValue(forKey: deviceName) != nil }
+    return EspProvToolkit.devices.remove(deviceName) || discovered
+  }
+  
+  func purgeESPDevices() throws {
+    EspProvToolkit.devices.removeAll()
+    EspProvToolkit.withState { EspProvToolkit.discoveredDevices.removeAll() }
+  }
+  
+  func setDeviceRegistryLimits(maxDevices: Double, idleTimeoutMs: Double) throws {
+    // Int(_:) traps on NaN and Infinity, so the count is clamped like the engine clamps it
+    let count = maxDevices.isNaN ? 1 : Int(min(max(maxDevices, 1), 4096))
+    let idleTimeout = idleTimeoutMs.isNaN ? 0 : min(max(idleTimeoutMs, 0), 30 * 24 * 3600 * 1000) / 1000
+    EspProvToolkit.devices.setLimits(maxDevices: count, idleTimeout: idleTimeout)
+  }
+  
   func createSessionWithESPDevice(deviceName: String) throws -> NitroModules.Promise<PTSessionResult> {
     return Promise.async{
       do{
@@ -180,13 +326,13 @@ class EspProvToolkit: HybridEspProvToolkitSpec {
     return Promise.async{
       do{
         let device = try EspProvToolkit.getDeviceEntry(forKey: deviceName);
-        // First check if it's valid base64 data
-        guard let decodedData = Data(base64Encoded: data) else {
+        // Decoding validates it, nil means it is not base64
+        guard let decodedData = EspProvBase64.decode(data) else {
           throw ESPRuntimeError.badBase64Data
         }
         // Send it to device and get response
         let response = try await device.sendDataAsync(path: path, data: decodedData)
-        let resp_base64 = response.base64EncodedString()
+        let resp_base64 = EspProvBase64.encode(response)
         return PTStringResult(success: true, str: resp_base64, error: nil)
 
       } catch (let sessionError as ESPSessionError){
@@ -197,6 +343,85 @@ class EspProvToolkit: HybridEspProvToolkitSpec {
     }
   }
   
+  func sendBinaryDataToESPDevice(deviceName: String, path: String, data: ArrayBuffer) throws -> NitroModules.Promise<PTDataResult> {
+    // A JS owned buffer can only be read on the JS thread, so read it before going async
+    let payload = data.toData(copyIfNeeded: true)
+    return Promise.async{
+      do{
+        let device = try EspProvToolkit.getDeviceEntry(forKey: deviceName)
+        let response = try await device.sendDataAsync(path: path, data: payload)
+        return PTDataResult(success: true, data: try ArrayBuffer.copy(data: response), error: nil)
+
+      } catch (let sessionError as ESPSessionError){
+        return PTDataResult(success: false, data: nil, error: Double(PTError(from : sessionError).rawValue))
+      } catch (let rtimeError as ESPRuntimeError){
+        return PTDataResult(success: false, data: nil, error: Double(PTError(from: rtimeError).rawValue))
+      }
+    }
+  }
+  
+  func sendRawDataToESPDevice(deviceName: String, path: String, data: ArrayBuffer) throws -> NitroModules.Promise<PTDataResult> {
+    let payload = data.toData(copyIfNeeded: true)
+    return Promise.async{
+      do{
+        let device = try await EspProvToolkit.getOrCreateDeviceEntry(forKey: deviceName)
+        guard device.transport == .ble else {
+          let response = try await device.sendRawDataAsync(path: path, data: payload)
+          return PTDataResult(success: true, data: try ArrayBuffer.copy(data: response), error: nil)
+        }
+        // The engine runs its own session, so only the BLE link is opened, never the SDK's session
+        var link = EspProvToolkit.withState { EspProvToolkit.rawLinks[deviceName] }
+        if link == nil {
+          guard let peripheralId = device.blePeripheralId else {
+            throw ESPSessionError.bleFailedToConnect
+          }
+          let opened = RawBleLink(peripheralId: peripheralId)
+          // Joins the attempt the engine started for this link
+          let attempt = EspProvConnectionStates.beginConnect(deviceName)
+          do{
+            try await opened.open {
+              EspProvToolkit.postLinkLost(deviceName: deviceName, transport: .ble, attempt: attempt)
+            }
+          } catch let sessionErr as ESPSessionError {
+            EspProvToolkit.postConnectFailure(sessionErr, deviceName: deviceName, attempt: attempt)
+            throw sessionErr
+          }
+          EspProvConnectionStates.post(.linkUp, deviceName: deviceName, attempt: attempt, error: -1)
+          // A concurrent send may have opened one first, the later link is dropped
+          link = EspProvToolkit.withState { () -> RawBleLink in
+            if let existing = EspProvToolkit.rawLinks[deviceName] {
+              return existing
+            }
+            EspProvToolkit.rawLinks[deviceName] = opened
+            return opened
+          }
+          if link !== opened {
+            opened.close()
+          }
+        }
+        let response: Data
+        do{
+          response = try await link!.send(path: path, data: payload)
+        } catch {
+          // The link may be gone, the next send connects again
+          EspProvToolkit.withState { () -> RawBleLink? in
+            guard EspProvToolkit.rawLinks[deviceName] === link else { return nil }
+            return EspProvToolkit.rawLinks.removeValue(forKey: deviceName)
+          }?.close()
+          throw error
+        }
+        return PTDataResult(success: true, data: try ArrayBuffer.copy(data: response), error: nil)
+
+      } catch (let sessionError as ESPSessionError){
+        return PTDataResult(success: false, data: nil, error: Double(PTError(from : sessionError).rawValue))
+      } catch (let rtimeError as ESPRuntimeError){
+        return PTDataResult(success: false, data: nil, error: Double(PTError(from: rtimeError).rawValue))
+      } catch (let cssError as ESPDeviceCSSError){
+        return PTDataResult(success: false, data: nil, error: Double(PTError(from: cssError).rawValue))
+      }
+    }
+  }
+  
   func getIPv4AddressOfESPDevice(deviceName: String) throws -> PTStringResult {
     do{
       let device = try EspProvToolkit.getDeviceEntry(forKey: deviceName)
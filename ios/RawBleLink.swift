@@ -0,0 +1,216 @@
+//
+//  RawBleLink.swift
+//  EspProvToolkit
+//
+
+import Foundation
+import CoreBluetooth
+import ESPProvision
+
+/// A BLE link to a provisioning device without a session on top, for the native engine's raw transport.
+///
+/// `ESPDevice.connect` always runs the SDK's own security handshake once the peripheral is up, which the
+/// engine would then repeat, and which fails for devices created without a proof of possession. The SDK's
+/// BLE transport cannot be connected on its own from outside the SDK, so this connects to the device's
+/// peripheral with CoreBluetooth directly. Like the SDK, it finds each protocomm endpoint by the user
+/// description of its characteristic, and sends by writing the request and reading back the response.
+class RawBleLink : NSObject, CBCentralManagerDelegate, CBPeripheralDelegate {
+  private let peripheralId : UUID
+  private let connectTimeout : TimeInterval
+  /// Serializes the CoreBluetooth callbacks with `open()`, `send()` and `close()`
+  private let queue = DispatchQueue(label: "EspProvToolkit.RawBleLink")
+  private var centralManager : CBCentralManager?
+  private var peripheral : CBPeripheral?
+
+  private var endpoints : [String : CBCharacteristic] = [:]
+  private var unresolved = 0
+  private var opener : CheckedContinuation<Void, Error>?
+  private var request : CheckedContinuation<Data, Error>?
+  private var closed = false
+  private var onLost : (() -> Void)?
+
+  init(peripheralId : UUID, connectTimeout : TimeInterval = 15.0){
+    self.peripheralId = peripheralId
+    self.connectTimeout = connectTimeout
+    super.init()
+  }
+
+  /// Connects and discovers the endpoints. `onLost` runs when an open link drops later on.
+  func open(onLost : @escaping () -> Void) async throws {
+    try await withCheckedThrowingContinuation { (continuation : CheckedContinuation<Void, Error>) in
+      queue.async {
+        guard !self.closed, self.opener == nil, self.centralManager == nil else {
+          continuation.resume(throwing: ESPSessionError.sessionNotEstablished)
+          return
+        }
+        self.opener = continuation
+        self.onLost = onLost
+        self.centralManager = CBCentralManager(delegate: self, queue: self.queue)
+        self.queue.asyncAfter(deadline: .now() + self.connectTimeout) {
+          self.failOpen(ESPSessionError.bleFailedToConnect)
+        }
+      }
+    }
+  }
+
+  /// Writes `data` to the endpoint at `path` and returns what the device answers.
+  /// One request at a time, as protocomm answers each write with a single read.
+  func send(path : String, data : Data) async throws -> Data {
+    return try await withCheckedThrowingContinuation { continuation in
+      queue.async {
+        guard !self.closed, self.opener == nil, let peripheral = self.peripheral,
+              let characteristic = self.endpoints[path] else {
+          continuation.resume(throwing: ESPSessionError.sessionNotEstablished)
+          return
+        }
+        guard self.request == nil else {
+          continuation.resume(throwing: ESPRuntimeError.badClosureArgs)
+          return
+        }
+        self.request = continuation
+        peripheral.writeValue(data, for: characteristic, type: .withResponse)
+      }
+    }
+  }
+
+  func close(){
+    queue.async { self.shutDown(with: ESPSessionError.sessionNotEstablished, notify: false) }
+  }
+
+  private func failOpen(_ error : Error){
+    guard opener != nil else { return }
+    shutDown(with: error, notify: false)
+  }
+
+  /// Drops the link and fails whoever still waits on it. Only a link that was open reports its loss.
+  private func shutDown(with error : Error, notify : Bool){
+    guard !closed else { return }
+    closed = true
+    if let manager = centralManager, let peripheral = peripheral, manager.state == .poweredOn {
+      manager.cancelPeripheralConnection(peripheral)
+    }
+    peripheral?.delegate = nil
+    peripheral = nil
+    centralManager = nil
+    endpoints.removeAll()
+    if let opener = opener {
+      self.opener = nil
+      opener.resume(throwing: error)
+    }
+    if let request = request {
+      self.request = nil
+      request.resume(throwing: error)
+    }
+    let lost = onLost
+    onLost = nil
+    if notify {
+      lost?()
+    }
+  }
+
+  func centralManagerDidUpdateState(_ central: CBCentralManager) {
+    switch central.state {
+    case .poweredOn:
+      guard opener != nil, peripheral == nil else { return }
+      // The SDK's scan found the peripheral on its own manager, this one looks it up by identifier
+      guard let found = central.retrievePeripherals(withIdentifiers: [peripheralId]).first else {
+        failOpen(ESPSessionError.bleFailedToConnect)
+        return
+      }
+      peripheral = found
+      found.delegate = self
+      central.connect(found, options: nil)
+    case .unauthorized, .unsupported, .poweredOff:
+      shutDown(with: ESPSessionError.bleFailedToConnect, notify: opener == nil)
+    default:
+      return
+    }
+  }
+
+  func centralManager(_ central: CBCentralManager, didConnect peripheral: CBPeripheral) {
+    peripheral.discoverServices(nil)
+  }
+
+  func centralManager(_ central: CBCentralManager, didFailToConnect peripheral: CBPeripheral, error: Error?) {
+    failOpen(ESPSessionError.bleFailedToConnect)
+  }
+
+  func centralManager(_ central: CBCentralManager, didDisconnectPeripheral peripheral: CBPeripheral, error: Error?) {
+    shutDown(with: ESPSessionError.bleFailedToConnect, notify: opener == nil)
+  }
+
+  func peripheral(_ peripheral: CBPeripheral, didDiscoverServices error: Error?) {
+    guard let services = peripheral.services, error == nil, !services.isEmpty else {
+      failOpen(ESPSessionError.bleFailedToConnect)
+      return
+    }
+    unresolved = services.count
+    for service in services {
+      peripheral.discoverCharacteristics(nil, for: service)
+    }
+  }
+
+  func peripheral(_ peripheral: CBPeripheral, didDiscoverCharacteristicsFor service: CBService, error: Error?) {
+    unresolved -= 1
+    for characteristic in service.characteristics ?? [] where error == nil {
+      unresolved += 1
+      peripheral.discoverDescriptors(for: characteristic)
+    }
+    resolveIfDone()
+  }
+
+  func peripheral(_ peripheral: CBPeripheral, didDiscoverDescriptorsFor characteristic: CBCharacteristic, error: Error?) {
+    unresolved -= 1
+    let userDescription = CBUUID(string: CBUUIDCharacteristicUserDescriptionString)
+    for descriptor in characteristic.descriptors ?? [] where error == nil && descriptor.uuid == userDescription {
+      unresolved += 1
+      peripheral.readValue(for: descriptor)
+    }
+    resolveIfDone()
+  }
+
+  func peripheral(_ peripheral: CBPeripheral, didUpdateValueFor descriptor: CBDescriptor, error: Error?) {
+    unresolved -= 1
+    if error == nil, let characteristic = descriptor.characteristic {
+      let name = (descriptor.value as? String) ?? (descriptor.value as? Data).flatMap { String(data: $0, encoding: .utf8) }
+      if let name = name {
+        endpoints[name] = characteristic
+      }
+    }
+    resolveIfDone()
+  }
+
+  private func resolveIfDone(){
+    guard unresolved == 0, let opener = opener else { return }
+    self.opener = nil
+    if endpoints.isEmpty {
+      shutDown(with: ESPSessionError.bleFailedToConnect, notify: false)
+      opener.resume(throwing: ESPSessionError.bleFailedToConnect)
+    } else {
+      opener.resume()
+    }
+  }
+
+  func peripheral(_ peripheral: CBPeripheral, didWriteValueFor characteristic: CBCharacteristic, error: Error?) {
+    guard request != nil else { return }
+    if let error = error {
+      finishRequest(.failure(ESPSessionError.sendDataError(error)))
+    } else {
+      peripheral.readValue(for: characteristic)
+    }
+  }
+
+  func peripheral(_ peripheral: CBPeripheral, didUpdateValueFor characteristic: CBCharacteristic, error: Error?) {
+    if let error = error {
+      finishRequest(.failure(ESPSessionError.sendDataError(error)))
+    } else {
+      finishRequest(.success(characteristic.value ?? Data()))
+    }
+  }
+
+  private func finishRequest(_ result : Result<Data, Error>){
+    guard let request = request else { return }
+    self.request = nil
+    request.resume(with: result)
+  }
+}
@@ -73,25 +73,31 @@ extension ESPTransport{
 
 
 extension PTError {
-  init(from cssError: ESPDeviceCSSError) {
-    self = PTError(rawValue: Int32(cssError.code))!
+  /// Maps through the shared native table, so iOS and Android agree. The SDK's own code wins
+  /// when it is a PTError, otherwise the message is classified.
+  init(classifying error: Error, sdkCode: Int = -1) {
+    let code = EspProvErrorClassifier.classifyMessage(String(describing: error), sdkCode: sdkCode)
+    self = PTError(rawValue: Int32(code)) ?? PTError.espNativeUnknownError
+  }
 
+  init(from cssError: ESPDeviceCSSError) {
+    self.init(classifying: cssError, sdkCode: cssError.code)
   }
   
   init(from sessionError: ESPSessionError){
-    self = PTError(rawValue: Int32(sessionError.code))!
+    self.init(classifying: sessionError, sdkCode: sessionError.code)
   }
   
   init(from provErr : ESPProvisionError){
-    self = PTError(rawValue : Int32(provErr.code))!
+    self.init(classifying: provErr, sdkCode: provErr.code)
   }
   
   init(from wifiErr : ESPWiFiScanError){
-    self = PTError(rawValue : Int32(wifiErr.code))!
+    self.init(classifying: wifiErr, sdkCode: wifiErr.code)
   }
   
   init(from rtimeErr : ESPRuntimeError){
-    self = PTError(rawValue : Int32(rtimeErr.code))!
+    self.init(classifying: rtimeErr, sdkCode: rtimeErr.code)
   }
 }
 
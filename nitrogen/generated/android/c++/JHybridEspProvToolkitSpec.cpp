@@ -33,6 +33,8 @@ namespace margelo::nitro::espprovtoolkit { struct PTProvisionResult; }
 namespace margelo::nitro::espprovtoolkit { struct PTBooleanResult; }
 // Forward declaration of `PTStringResult` to properly resolve imports.
 namespace margelo::nitro::espprovtoolkit { struct PTStringResult; }
+// Forward declaration of `PTDataResult` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTDataResult; }
 // Forward declaration of `PTLocationAccess` to properly resolve imports.
 namespace margelo::nitro::espprovtoolkit { enum class PTLocationAccess; }
 // Forward declaration of `PTError` to properly resolve imports.
@@ -69,6 +71,10 @@ namespace margelo::nitro::espprovtoolkit { enum class PTError; }
 #include "JPTBooleanResult.hpp"
 #include "PTStringResult.hpp"
 #include "JPTStringResult.hpp"
+#include "PTDataResult.hpp"
+#include "JPTDataResult.hpp"
+#include <NitroModules/ArrayBuffer.hpp>
+#include <NitroModules/JArrayBuffer.hpp>
 #include "PTLocationAccess.hpp"
 #include "JPTLocationAccess.hpp"
 #include <functional>
@@ -130,6 +136,27 @@ namespace margelo::nitro::espprovtoolkit {
     static const auto method = _javaPart->javaClassStatic()->getMethod<void()>("stopSearchingForESPDevices");
     method(_javaPart);
   }
+  PTResult JHybridEspProvToolkitSpec::startDiscoveringESPDevices(const std::string& devicePrefix, PTTransport transport, PTSecurity security, std::optional<double> scanTimeoutMs) {
+    static const auto method = _javaPart->javaClassStatic()->getMethod<jni::local_ref<JPTResult>(jni::alias_ref<jni::JString> /* devicePrefix */, jni::alias_ref<JPTTransport> /* transport */, jni::alias_ref<JPTSecurity> /* security */, jni::alias_ref<jni::JDouble> /* scanTimeoutMs */)>("startDiscoveringESPDevices");
+    auto __result = method(_javaPart, jni::make_jstring(devicePrefix), JPTTransport::fromCpp(transport), JPTSecurity::fromCpp(security), scanTimeoutMs.has_value() ? jni::JDouble::valueOf(scanTimeoutMs.value()) : nullptr);
+    return __result->toCpp();
+  }
+  std::shared_ptr<Promise<PTSearchResult>> JHybridEspProvToolkitSpec::nextDiscoveredESPDevices() {
+    static const auto method = _javaPart->javaClassStatic()->getMethod<jni::local_ref<JPromise::javaobject>()>("nextDiscoveredESPDevices");
+    auto __result = method(_javaPart);
+    return [&]() {
+      auto __promise = Promise<PTSearchResult>::create();
+      __result->cthis()->addOnResolvedListener([=](const jni::alias_ref<jni::JObject>& __boxedResult) {
+        auto __result = jni::static_ref_cast<JPTSearchResult>(__boxedResult);
+        __promise->resolve(__result->toCpp());
+      });
+      __result->cthis()->addOnRejectedListener([=](const jni::alias_ref<jni::JThrowable>& __throwable) {
+        jni::JniException __jniError(__throwable);
+        __promise->reject(std::make_exception_ptr(__jniError));
+      });
+      return __promise;
+    }();
+  }
   std::shared_ptr<Promise<PTResult>> JHybridEspProvToolkitSpec::createESPDevice(const std::string& deviceName, PTTransport transport, PTSecurity security, const std::optional<std::string>& proofOfPossession, const std::optional<std::string>& softAPPassword, const std::optional<std::string>& username) {
     static const auto method = _javaPart->javaClassStatic()->getMethod<jni::local_ref<JPromise::javaobject>(jni::alias_ref<jni::JString> /* deviceName */, jni::alias_ref<JPTTransport> /* transport */, jni::alias_ref<JPTSecurity> /* security */, jni::alias_ref<jni::JString> /* proofOfPossession */, jni::alias_ref<jni::JString> /* softAPPassword */, jni::alias_ref<jni::JString> /* username */)>("createESPDevice");
     auto __result = method(_javaPart, jni::make_jstring(deviceName), JPTTransport::fromCpp(transport), JPTSecurity::fromCpp(security), proofOfPossession.has_value() ? jni::make_jstring(proofOfPossession.value()) : nullptr, softAPPassword.has_value() ? jni::make_jstring(softAPPassword.value()) : nullptr, username.has_value() ? jni::make_jstring(username.value()) : nullptr);
@@ -193,6 +220,19 @@ namespace margelo::nitro::espprovtoolkit {
     auto __result = method(_javaPart, jni::make_jstring(deviceName));
     return __result->toCpp();
   }
+  bool JHybridEspProvToolkitSpec::releaseESPDevice(const std::string& deviceName) {
+    static const auto method = _javaPart->javaClassStatic()->getMethod<jboolean(jni::alias_ref<jni::JString> /* deviceName */)>("releaseESPDevice");
+    auto __result = method(_javaPart, jni::make_jstring(deviceName));
+    return static_cast<bool>(__result);
+  }
+  void JHybridEspProvToolkitSpec::purgeESPDevices() {
+    static const auto method = _javaPart->javaClassStatic()->getMethod<void()>("purgeESPDevices");
+    method(_javaPart);
+  }
+  void JHybridEspProvToolkitSpec::setDeviceRegistryLimits(double maxDevices, double idleTimeoutMs) {
+    static const auto method = _javaPart->javaClassStatic()->getMethod<void(double /* maxDevices */, double /* idleTimeoutMs */)>("setDeviceRegistryLimits");
+    method(_javaPart, maxDevices, idleTimeoutMs);
+  }
   std::shared_ptr<Promise<PTProvisionResult>> JHybridEspProvToolkitSpec::provisionESPDevice(const std::string& deviceName, const std::string& ssid, const std::string& password) {
     static const auto method = _javaPart->javaClassStatic()->getMethod<jni::local_ref<JPromise::javaobject>(jni::alias_ref<jni::JString> /* deviceName */, jni::alias_ref<jni::JString> /* ssid */, jni::alias_ref<jni::JString> /* password */)>("provisionESPDevice");
     auto __result = method(_javaPart, jni::make_jstring(deviceName), jni::make_jstring(ssid), jni::make_jstring(password));
@@ -230,6 +270,38 @@ namespace margelo::nitro::espprovtoolkit {
       return __promise;
     }();
   }
+  std::shared_ptr<Promise<PTDataResult>> JHybridEspProvToolkitSpec::sendBinaryDataToESPDevice(const std::string& deviceName, const std::string& path, const std::shared_ptr<ArrayBuffer>& data) {
+    static const auto method = _javaPart->javaClassStatic()->getMethod<jni::local_ref<JPromise::javaobject>(jni::alias_ref<jni::JString> /* deviceName */, jni::alias_ref<jni::JString> /* path */, jni::alias_ref<JArrayBuffer::javaobject> /* data */)>("sendBinaryDataToESPDevice");
+    auto __result = method(_javaPart, jni::make_jstring(deviceName), jni::make_jstring(path), JArrayBuffer::wrap(data));
+    return [&]() {
+      auto __promise = Promise<PTDataResult>::create();
+      __result->cthis()->addOnResolvedListener([=](const jni::alias_ref<jni::JObject>& __boxedResult) {
+        auto __result = jni::static_ref_cast<JPTDataResult>(__boxedResult);
+        __promise->resolve(__result->toCpp());
+      });
+      __result->cthis()->addOnRejectedListener([=](const jni::alias_ref<jni::JThrowable>& __throwable) {
+        jni::JniException __jniError(__throwable);
+        __promise->reject(std::make_exception_ptr(__jniError));
+      });
+      return __promise;
+    }();
+  }
+  std::shared_ptr<Promise<PTDataResult>> JHybridEspProvToolkitSpec::sendRawDataToESPDevice(const std::string& deviceName, const std::string& path, const std::shared_ptr<ArrayBuffer>& data) {
+    static const auto method = _javaPart->javaClassStatic()->getMethod<jni::local_ref<JPromise::javaobject>(jni::alias_ref<jni::JString> /* deviceName */, jni::alias_ref<jni::JString> /* path */, jni::alias_ref<JArrayBuffer::javaobject> /* data */)>("sendRawDataToESPDevice");
+    auto __result = method(_javaPart, jni::make_jstring(deviceName), jni::make_jstring(path), JArrayBuffer::wrap(data));
+    return [&]() {
+      auto __promise = Promise<PTDataResult>::create();
+      __result->cthis()->addOnResolvedListener([=](const jni::alias_ref<jni::JObject>& __boxedResult) {
+        auto __result = jni::static_ref_cast<JPTDataResult>(__boxedResult);
+        __promise->resolve(__result->toCpp());
+      });
+      __result->cthis()->addOnRejectedListener([=](const jni::alias_ref<jni::JThrowable>& __throwable) {
+        jni::JniException __jniError(__throwable);
+        __promise->reject(std::make_exception_ptr(__jniError));
+      });
+      return __promise;
+    }();
+  }
   PTStringResult JHybridEspProvToolkitSpec::getIPv4AddressOfESPDevice(const std::string& deviceName) {
     static const auto method = _javaPart->javaClassStatic()->getMethod<jni::local_ref<JPTStringResult>(jni::alias_ref<jni::JString> /* deviceName */)>("getIPv4AddressOfESPDevice");
     auto __result = method(_javaPart, jni::make_jstring(deviceName));
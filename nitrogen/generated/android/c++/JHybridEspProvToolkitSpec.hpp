@@ -56,15 +56,22 @@ namespace margelo::nitro::espprovtoolkit {
     // Methods
     std::shared_ptr<Promise<PTSearchResult>> searchForESPDevices(const std::string& devicePrefix, PTTransport transport, PTSecurity security) override;
     void stopSearchingForESPDevices() override;
+    PTResult startDiscoveringESPDevices(const std::string& devicePrefix, PTTransport transport, PTSecurity security, std::optional<double> scanTimeoutMs) override;
+    std::shared_ptr<Promise<PTSearchResult>> nextDiscoveredESPDevices() override;
     std::shared_ptr<Promise<PTResult>> createESPDevice(const std::string& deviceName, PTTransport transport, PTSecurity security, const std::optional<std::string>& proofOfPossession, const std::optional<std::string>& softAPPassword, const std::optional<std::string>& username) override;
     PTDeviceResult getESPDevice(const std::string& deviceName) override;
     bool doesESPDeviceExist(const std::string& deviceName) override;
     std::shared_ptr<Promise<PTWifiScanResult>> scanWifiListOfESPDevice(const std::string& deviceName) override;
     std::shared_ptr<Promise<PTSessionResult>> connectToESPDevice(const std::string& deviceName) override;
     PTResult disconnectFromESPDevice(const std::string& deviceName) override;
+    bool releaseESPDevice(const std::string& deviceName) override;
+    void purgeESPDevices() override;
+    void setDeviceRegistryLimits(double maxDevices, double idleTimeoutMs) override;
     std::shared_ptr<Promise<PTProvisionResult>> provisionESPDevice(const std::string& deviceName, const std::string& ssid, const std::string& password) override;
     PTBooleanResult isESPDeviceSessionEstablished(const std::string& deviceName) override;
     std::shared_ptr<Promise<PTStringResult>> sendDataToESPDevice(const std::string& deviceName, const std::string& path, const std::string& data) override;
+    std::shared_ptr<Promise<PTDataResult>> sendBinaryDataToESPDevice(const std::string& deviceName, const std::string& path, const std::shared_ptr<ArrayBuffer>& data) override;
+    std::shared_ptr<Promise<PTDataResult>> sendRawDataToESPDevice(const std::string& deviceName, const std::string& path, const std::shared_ptr<ArrayBuffer>& data) override;
     PTStringResult getIPv4AddressOfESPDevice(const std::string& deviceName) override;
     std::shared_ptr<Promise<PTStringResult>> getCurrentNetworkSSID() override;
     void requestLocationPermission() override;
@@ -0,0 +1,67 @@
+///
+/// JPTDataResult.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#include <fbjni/fbjni.h>
+#include "PTDataResult.hpp"
+
+#include <NitroModules/ArrayBuffer.hpp>
+#include <NitroModules/JArrayBuffer.hpp>
+#include <optional>
+
+namespace margelo::nitro::espprovtoolkit {
+
+  using namespace facebook;
+
+  /**
+   * The C++ JNI bridge between the C++ struct "PTDataResult" and the the Kotlin data class "PTDataResult".
+   */
+  struct JPTDataResult final: public jni::JavaClass<JPTDataResult> {
+  public:
+    static constexpr auto kJavaDescriptor = "Lcom/margelo/nitro/espprovtoolkit/PTDataResult;";
+
+  public:
+    /**
+     * Convert this Java/Kotlin-based struct to the C++ struct PTDataResult by copying all values to C++.
+     */
+    [[maybe_unused]]
+    [[nodiscard]]
+    PTDataResult toCpp() const {
+      static const auto clazz = javaClassStatic();
+      static const auto fieldSuccess = clazz->getField<jboolean>("success");
+      jboolean success = this->getFieldValue(fieldSuccess);
+      static const auto fieldData = clazz->getField<JArrayBuffer::javaobject>("data");
+      jni::local_ref<JArrayBuffer::javaobject> data = this->getFieldValue(fieldData);
+      static const auto fieldError = clazz->getField<jni::JDouble>("error");
+      jni::local_ref<jni::JDouble> error = this->getFieldValue(fieldError);
+      return PTDataResult(
+        static_cast<bool>(success),
+        data != nullptr ? std::make_optional(data->cthis()->getArrayBuffer()) : std::nullopt,
+        error != nullptr ? std::make_optional(error->value()) : std::nullopt
+      );
+    }
+
+  public:
+    /**
+     * Create a Java/Kotlin-based struct by copying all values from the given C++ struct to Java.
+     */
+    [[maybe_unused]]
+    static jni::local_ref<JPTDataResult::javaobject> fromCpp(const PTDataResult& value) {
+      using JSignature = JPTDataResult(jboolean, jni::alias_ref<JArrayBuffer::javaobject>, jni::alias_ref<jni::JDouble>);
+      static const auto clazz = javaClassStatic();
+      static const auto create = clazz->getStaticMethod<JSignature>("fromCpp");
+      return create(
+        clazz,
+        value.success,
+        value.data.has_value() ? JArrayBuffer::wrap(value.data.value()) : nullptr,
+        value.error.has_value() ? jni::JDouble::valueOf(value.error.value()) : nullptr
+      );
+    }
+  };
+
+} // namespace margelo::nitro::espprovtoolkit
@@ -156,6 +156,9 @@ namespace margelo::nitro::espprovtoolkit {
         case PTError::BLE_ADAPTER_NOT_AVAILABLE:
           static const auto fieldBLE_ADAPTER_NOT_AVAILABLE = clazz->getStaticField<JPTError>("BLE_ADAPTER_NOT_AVAILABLE");
           return clazz->getStaticFieldValue(fieldBLE_ADAPTER_NOT_AVAILABLE);
+        case PTError::OPERATION_CANCELLED:
+          static const auto fieldOPERATION_CANCELLED = clazz->getStaticField<JPTError>("OPERATION_CANCELLED");
+          return clazz->getStaticFieldValue(fieldOPERATION_CANCELLED);
         default:
           std::string stringValue = std::to_string(static_cast<int>(value));
           throw std::invalid_argument("Invalid enum value (" + stringValue + "!");
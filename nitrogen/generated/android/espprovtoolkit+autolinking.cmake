@@ -34,6 +34,7 @@ target_sources(
   ../nitrogen/generated/android/espprovtoolkitOnLoad.cpp
   # Shared Nitrogen C++ sources
   ../nitrogen/generated/shared/c++/HybridEspProvToolkitSpec.cpp
+  ../nitrogen/generated/shared/c++/HybridEspProvEngineSpec.cpp
   # Android-specific Nitrogen C++ sources
   ../nitrogen/generated/android/c++/JHybridEspProvToolkitSpec.cpp
 )
@@ -17,6 +17,7 @@
 
 #include "JHybridEspProvToolkitSpec.hpp"
 #include "JFunc_std__shared_ptr_Promise_bool___PTLocationAccess.hpp"
+#include "HybridEspProvEngine.hpp"
 #include <NitroModules/DefaultConstructableObject.hpp>
 
 namespace margelo::nitro::espprovtoolkit {
@@ -51,6 +52,13 @@ void registerAllNatives() {
       return JHybridEspProvToolkitSpecImpl::create();
     }
   );
+  HybridObjectRegistry::registerHybridObjectConstructor(
+    "EspProvEngine",
+    []() -> std::shared_ptr<HybridObject> {
+      static DefaultConstructableObject<HybridEspProvEngine> object("HybridEspProvEngine");
+      return object.create();
+    }
+  );
 }
 
 } // namespace margelo::nitro::espprovtoolkit
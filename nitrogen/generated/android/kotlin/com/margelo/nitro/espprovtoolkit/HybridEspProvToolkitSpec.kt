@@ -11,6 +11,7 @@ import androidx.annotation.Keep
 import com.facebook.jni.HybridData
 import com.facebook.proguard.annotations.DoNotStrip
 import com.margelo.nitro.core.Promise
+import com.margelo.nitro.core.ArrayBuffer
 import com.margelo.nitro.core.HybridObject
 
 /**
@@ -37,6 +38,14 @@ abstract class HybridEspProvToolkitSpec: HybridObject() {
   @Keep
   abstract fun stopSearchingForESPDevices(): Unit
   
+  @DoNotStrip
+  @Keep
+  abstract fun startDiscoveringESPDevices(devicePrefix: String, transport: PTTransport, security: PTSecurity, scanTimeoutMs: Double?): PTResult
+  
+  @DoNotStrip
+  @Keep
+  abstract fun nextDiscoveredESPDevices(): Promise<PTSearchResult>
+  
   @DoNotStrip
   @Keep
   abstract fun createESPDevice(deviceName: String, transport: PTTransport, security: PTSecurity, proofOfPossession: String?, softAPPassword: String?, username: String?): Promise<PTResult>
@@ -61,6 +70,18 @@ abstract class HybridEspProvToolkitSpec: HybridObject() {
   @Keep
   abstract fun disconnectFromESPDevice(deviceName: String): PTResult
   
+  @DoNotStrip
+  @Keep
+  abstract fun releaseESPDevice(deviceName: String): Boolean
+  
+  @DoNotStrip
+  @Keep
+  abstract fun purgeESPDevices(): Unit
+  
+  @DoNotStrip
+  @Keep
+  abstract fun setDeviceRegistryLimits(maxDevices: Double, idleTimeoutMs: Double): Unit
+  
   @DoNotStrip
   @Keep
   abstract fun provisionESPDevice(deviceName: String, ssid: String, password: String): Promise<PTProvisionResult>
@@ -73,6 +94,14 @@ abstract class HybridEspProvToolkitSpec: HybridObject() {
   @Keep
   abstract fun sendDataToESPDevice(deviceName: String, path: String, data: String): Promise<PTStringResult>
   
+  @DoNotStrip
+  @Keep
+  abstract fun sendBinaryDataToESPDevice(deviceName: String, path: String, data: ArrayBuffer): Promise<PTDataResult>
+  
+  @DoNotStrip
+  @Keep
+  abstract fun sendRawDataToESPDevice(deviceName: String, path: String, data: ArrayBuffer): Promise<PTDataResult>
+  
   @DoNotStrip
   @Keep
   abstract fun getIPv4AddressOfESPDevice(deviceName: String): PTStringResult
@@ -0,0 +1,62 @@
+///
+/// PTDataResult.kt
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+package com.margelo.nitro.espprovtoolkit
+
+import androidx.annotation.Keep
+import com.facebook.proguard.annotations.DoNotStrip
+import com.margelo.nitro.core.ArrayBuffer
+import java.util.Objects
+
+
+/**
+ * Represents the JavaScript object/struct "PTDataResult".
+ */
+@DoNotStrip
+@Keep
+data class PTDataResult(
+  @DoNotStrip
+  @Keep
+  val success: Boolean,
+  @DoNotStrip
+  @Keep
+  val data: ArrayBuffer?,
+  @DoNotStrip
+  @Keep
+  val error: Double?
+) {
+  /* primary constructor */
+
+  override fun equals(other: Any?): Boolean {
+    if (this === other) return true
+    if (other !is PTDataResult) return false
+    return Objects.deepEquals(this.success, other.success)
+      && Objects.deepEquals(this.data, other.data)
+      && Objects.deepEquals(this.error, other.error)
+  }
+
+  override fun hashCode(): Int {
+    return arrayOf<Any?>(
+      success,
+      data,
+      error
+    ).contentDeepHashCode()
+  }
+
+  companion object {
+    /**
+     * Constructor called from C++
+     */
+    @DoNotStrip
+    @Keep
+    @Suppress("unused")
+    @JvmStatic
+    private fun fromCpp(success: Boolean, data: ArrayBuffer?, error: Double?): PTDataResult {
+      return PTDataResult(success, data, error)
+    }
+  }
+}
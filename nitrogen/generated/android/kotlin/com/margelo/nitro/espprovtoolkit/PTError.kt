@@ -53,7 +53,8 @@ enum class PTError(@DoNotStrip @Keep val value: Int) {
   RUNTIME_UNKNOWN_ERROR(44),
   ESP_NATIVE_UNKNOWN_ERROR(4),
   ESP_INSUFFICIENT_PERMISSIONS(47),
-  BLE_ADAPTER_NOT_AVAILABLE(48);
+  BLE_ADAPTER_NOT_AVAILABLE(48),
+  OPERATION_CANCELLED(49);
 
   companion object
 }
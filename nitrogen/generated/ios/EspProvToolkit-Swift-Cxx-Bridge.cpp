@@ -70,6 +70,14 @@ namespace margelo::nitro::espprovtoolkit::bridge::swift {
     };
   }
   
+  // pragma MARK: std::function<void(const PTDataResult& /* result */)>
+  Func_void_PTDataResult create_Func_void_PTDataResult(void* NON_NULL swiftClosureWrapper) noexcept {
+    auto swiftClosure = EspProvToolkit::Func_void_PTDataResult::fromUnsafe(swiftClosureWrapper);
+    return [swiftClosure = std::move(swiftClosure)](const PTDataResult& result) mutable -> void {
+      swiftClosure.call(result);
+    };
+  }
+  
   // pragma MARK: std::function<std::shared_ptr<Promise<bool>>(PTLocationAccess /* level */)>
   Func_std__shared_ptr_Promise_bool___PTLocationAccess create_Func_std__shared_ptr_Promise_bool___PTLocationAccess(void* NON_NULL swiftClosureWrapper) noexcept {
     auto swiftClosure = EspProvToolkit::Func_std__shared_ptr_Promise_bool___PTLocationAccess::fromUnsafe(swiftClosureWrapper);
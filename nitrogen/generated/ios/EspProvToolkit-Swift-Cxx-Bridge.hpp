@@ -12,6 +12,8 @@
 namespace margelo::nitro::espprovtoolkit { class HybridEspProvToolkitSpec; }
 // Forward declaration of `PTBooleanResult` to properly resolve imports.
 namespace margelo::nitro::espprovtoolkit { struct PTBooleanResult; }
+// Forward declaration of `PTDataResult` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTDataResult; }
 // Forward declaration of `PTDeviceResult` to properly resolve imports.
 namespace margelo::nitro::espprovtoolkit { struct PTDeviceResult; }
 // Forward declaration of `PTDevice` to properly resolve imports.
@@ -46,6 +48,7 @@ namespace EspProvToolkit { class HybridEspProvToolkitSpec_cxx; }
 // Include C++ defined types
 #include "HybridEspProvToolkitSpec.hpp"
 #include "PTBooleanResult.hpp"
+#include "PTDataResult.hpp"
 #include "PTDevice.hpp"
 #include "PTDeviceResult.hpp"
 #include "PTLocationAccess.hpp"
@@ -59,6 +62,7 @@ namespace EspProvToolkit { class HybridEspProvToolkitSpec_cxx; }
 #include "PTTransport.hpp"
 #include "PTWifiEntry.hpp"
 #include "PTWifiScanResult.hpp"
+#include <NitroModules/ArrayBuffer.hpp>
 #include <NitroModules/Promise.hpp>
 #include <NitroModules/PromiseHolder.hpp>
 #include <NitroModules/Result.hpp>
@@ -428,6 +432,55 @@ namespace margelo::nitro::espprovtoolkit::bridge::swift {
     return Func_void_PTStringResult_Wrapper(std::move(value));
   }
   
+  // pragma MARK: std::optional<std::shared_ptr<ArrayBuffer>>
+  /**
+   * Specialized version of `std::optional<std::shared_ptr<ArrayBuffer>>`.
+   */
+  using std__optional_std__shared_ptr_ArrayBuffer__ = std::optional<std::shared_ptr<ArrayBuffer>>;
+  inline std::optional<std::shared_ptr<ArrayBuffer>> create_std__optional_std__shared_ptr_ArrayBuffer__(const std::shared_ptr<ArrayBuffer>& value) noexcept {
+    return std::optional<std::shared_ptr<ArrayBuffer>>(value);
+  }
+  inline bool has_value_std__optional_std__shared_ptr_ArrayBuffer__(const std::optional<std::shared_ptr<ArrayBuffer>>& optional) noexcept {
+    return optional.has_value();
+  }
+  inline std::shared_ptr<ArrayBuffer> get_std__optional_std__shared_ptr_ArrayBuffer__(const std::optional<std::shared_ptr<ArrayBuffer>>& optional) noexcept {
+    return *optional;
+  }
+  
+  // pragma MARK: std::shared_ptr<Promise<PTDataResult>>
+  /**
+   * Specialized version of `std::shared_ptr<Promise<PTDataResult>>`.
+   */
+  using std__shared_ptr_Promise_PTDataResult__ = std::shared_ptr<Promise<PTDataResult>>;
+  inline std::shared_ptr<Promise<PTDataResult>> create_std__shared_ptr_Promise_PTDataResult__() noexcept {
+    return Promise<PTDataResult>::create();
+  }
+  inline PromiseHolder<PTDataResult> wrap_std__shared_ptr_Promise_PTDataResult__(std::shared_ptr<Promise<PTDataResult>> promise) noexcept {
+    return PromiseHolder<PTDataResult>(std::move(promise));
+  }
+  
+  // pragma MARK: std::function<void(const PTDataResult& /* result */)>
+  /**
+   * Specialized version of `std::function<void(const PTDataResult&)>`.
+   */
+  using Func_void_PTDataResult = std::function<void(const PTDataResult& /* result */)>;
+  /**
+   * Wrapper class for a `std::function<void(const PTDataResult& / * result * /)>`, this can be used from Swift.
+   */
+  class Func_void_PTDataResult_Wrapper final {
+  public:
+    explicit Func_void_PTDataResult_Wrapper(std::function<void(const PTDataResult& /* result */)>&& func): _function(std::make_unique<std::function<void(const PTDataResult& /* result */)>>(std::move(func))) {}
+    inline void call(PTDataResult result) const noexcept {
+      _function->operator()(result);
+    }
+  private:
+    std::unique_ptr<std::function<void(const PTDataResult& /* result */)>> _function;
+  } SWIFT_NONCOPYABLE;
+  Func_void_PTDataResult create_Func_void_PTDataResult(void* NON_NULL swiftClosureWrapper) noexcept;
+  inline Func_void_PTDataResult_Wrapper wrap_Func_void_PTDataResult(Func_void_PTDataResult value) noexcept {
+    return Func_void_PTDataResult_Wrapper(std::move(value));
+  }
+  
   // pragma MARK: std::function<std::shared_ptr<Promise<bool>>(PTLocationAccess /* level */)>
   /**
    * Specialized version of `std::function<std::shared_ptr<Promise<bool>>(PTLocationAccess)>`.
@@ -596,6 +649,15 @@ namespace margelo::nitro::espprovtoolkit::bridge::swift {
     return Result<std::shared_ptr<Promise<PTStringResult>>>::withError(error);
   }
   
+  // pragma MARK: Result<std::shared_ptr<Promise<PTDataResult>>>
+  using Result_std__shared_ptr_Promise_PTDataResult___ = Result<std::shared_ptr<Promise<PTDataResult>>>;
+  inline Result_std__shared_ptr_Promise_PTDataResult___ create_Result_std__shared_ptr_Promise_PTDataResult___(const std::shared_ptr<Promise<PTDataResult>>& value) noexcept {
+    return Result<std::shared_ptr<Promise<PTDataResult>>>::withValue(value);
+  }
+  inline Result_std__shared_ptr_Promise_PTDataResult___ create_Result_std__shared_ptr_Promise_PTDataResult___(const std::exception_ptr& error) noexcept {
+    return Result<std::shared_ptr<Promise<PTDataResult>>>::withError(error);
+  }
+  
   // pragma MARK: Result<PTStringResult>
   using Result_PTStringResult_ = Result<PTStringResult>;
   inline Result_PTStringResult_ create_Result_PTStringResult_(const PTStringResult& value) noexcept {
@@ -12,6 +12,8 @@
 namespace margelo::nitro::espprovtoolkit { class HybridEspProvToolkitSpec; }
 // Forward declaration of `PTBooleanResult` to properly resolve imports.
 namespace margelo::nitro::espprovtoolkit { struct PTBooleanResult; }
+// Forward declaration of `PTDataResult` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTDataResult; }
 // Forward declaration of `PTDeviceResult` to properly resolve imports.
 namespace margelo::nitro::espprovtoolkit { struct PTDeviceResult; }
 // Forward declaration of `PTDevice` to properly resolve imports.
@@ -44,6 +46,7 @@ namespace margelo::nitro::espprovtoolkit { struct PTWifiScanResult; }
 // Include C++ defined types
 #include "HybridEspProvToolkitSpec.hpp"
 #include "PTBooleanResult.hpp"
+#include "PTDataResult.hpp"
 #include "PTDevice.hpp"
 #include "PTDeviceResult.hpp"
 #include "PTError.hpp"
@@ -58,6 +61,7 @@ namespace margelo::nitro::espprovtoolkit { struct PTWifiScanResult; }
 #include "PTTransport.hpp"
 #include "PTWifiEntry.hpp"
 #include "PTWifiScanResult.hpp"
+#include <NitroModules/ArrayBuffer.hpp>
 #include <NitroModules/Promise.hpp>
 #include <NitroModules/Result.hpp>
 #include <exception>
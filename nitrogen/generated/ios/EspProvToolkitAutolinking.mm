@@ -7,10 +7,12 @@
 
 #import <Foundation/Foundation.h>
 #import <NitroModules/HybridObjectRegistry.hpp>
+#import <NitroModules/DefaultConstructableObject.hpp>
 #import "EspProvToolkit-Swift-Cxx-Umbrella.hpp"
 #import <type_traits>
 
 #include "HybridEspProvToolkitSpecSwift.hpp"
+#include "HybridEspProvEngine.hpp"
 
 @interface EspProvToolkitAutolinking : NSObject
 @end
@@ -28,6 +30,13 @@
       return hybridObject;
     }
   );
+  HybridObjectRegistry::registerHybridObjectConstructor(
+    "EspProvEngine",
+    []() -> std::shared_ptr<HybridObject> {
+      static DefaultConstructableObject<HybridEspProvEngine> object("HybridEspProvEngine");
+      return object.create();
+    }
+  );
 }
 
 @end
@@ -38,6 +38,10 @@ namespace margelo::nitro::espprovtoolkit { struct PTProvisionResult; }
 namespace margelo::nitro::espprovtoolkit { struct PTBooleanResult; }
 // Forward declaration of `PTStringResult` to properly resolve imports.
 namespace margelo::nitro::espprovtoolkit { struct PTStringResult; }
+// Forward declaration of `PTDataResult` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTDataResult; }
+// Forward declaration of `ArrayBufferHolder` to properly resolve imports.
+namespace NitroModules { class ArrayBufferHolder; }
 // Forward declaration of `PTLocationAccess` to properly resolve imports.
 namespace margelo::nitro::espprovtoolkit { enum class PTLocationAccess; }
 // Forward declaration of `PTError` to properly resolve imports.
@@ -60,6 +64,9 @@ namespace margelo::nitro::espprovtoolkit { enum class PTError; }
 #include "PTProvisionResult.hpp"
 #include "PTBooleanResult.hpp"
 #include "PTStringResult.hpp"
+#include "PTDataResult.hpp"
+#include <NitroModules/ArrayBuffer.hpp>
+#include <NitroModules/ArrayBufferHolder.hpp>
 #include "PTLocationAccess.hpp"
 #include <functional>
 #include "PTError.hpp"
@@ -128,6 +135,22 @@ namespace margelo::nitro::espprovtoolkit {
         std::rethrow_exception(__result.error());
       }
     }
+    inline PTResult startDiscoveringESPDevices(const std::string& devicePrefix, PTTransport transport, PTSecurity security, std::optional<double> scanTimeoutMs) override {
+      auto __result = _swiftPart.startDiscoveringESPDevices(devicePrefix, static_cast<int>(transport), static_cast<int>(security), scanTimeoutMs);
+      if (__result.hasError()) [[unlikely]] {
+        std::rethrow_exception(__result.error());
+      }
+      auto __value = std::move(__result.value());
+      return __value;
+    }
+    inline std::shared_ptr<Promise<PTSearchResult>> nextDiscoveredESPDevices() override {
+      auto __result = _swiftPart.nextDiscoveredESPDevices();
+      if (__result.hasError()) [[unlikely]] {
+        std::rethrow_exception(__result.error());
+      }
+      auto __value = std::move(__result.value());
+      return __value;
+    }
     inline std::shared_ptr<Promise<PTResult>> createESPDevice(const std::string& deviceName, PTTransport transport, PTSecurity security, const std::optional<std::string>& proofOfPossession, const std::optional<std::string>& softAPPassword, const std::optional<std::string>& username) override {
       auto __result = _swiftPart.createESPDevice(deviceName, static_cast<int>(transport), static_cast<int>(security), proofOfPossession, softAPPassword, username);
       if (__result.hasError()) [[unlikely]] {
@@ -176,6 +199,26 @@ namespace margelo::nitro::espprovtoolkit {
       auto __value = std::move(__result.value());
       return __value;
     }
+    inline bool releaseESPDevice(const std::string& deviceName) override {
+      auto __result = _swiftPart.releaseESPDevice(deviceName);
+      if (__result.hasError()) [[unlikely]] {
+        std::rethrow_exception(__result.error());
+      }
+      auto __value = std::move(__result.value());
+      return __value;
+    }
+    inline void purgeESPDevices() override {
+      auto __result = _swiftPart.purgeESPDevices();
+      if (__result.hasError()) [[unlikely]] {
+        std::rethrow_exception(__result.error());
+      }
+    }
+    inline void setDeviceRegistryLimits(double maxDevices, double idleTimeoutMs) override {
+      auto __result = _swiftPart.setDeviceRegistryLimits(std::forward<decltype(maxDevices)>(maxDevices), std::forward<decltype(idleTimeoutMs)>(idleTimeoutMs));
+      if (__result.hasError()) [[unlikely]] {
+        std::rethrow_exception(__result.error());
+      }
+    }
     inline std::shared_ptr<Promise<PTProvisionResult>> provisionESPDevice(const std::string& deviceName, const std::string& ssid, const std::string& password) override {
       auto __result = _swiftPart.provisionESPDevice(deviceName, ssid, password);
       if (__result.hasError()) [[unlikely]] {
@@ -200,6 +243,22 @@ namespace margelo::nitro::espprovtoolkit {
       auto __value = std::move(__result.value());
       return __value;
     }
+    inline std::shared_ptr<Promise<PTDataResult>> sendBinaryDataToESPDevice(const std::string& deviceName, const std::string& path, const std::shared_ptr<ArrayBuffer>& data) override {
+      auto __result = _swiftPart.sendBinaryDataToESPDevice(deviceName, path, ArrayBufferHolder(data));
+      if (__result.hasError()) [[unlikely]] {
+        std::rethrow_exception(__result.error());
+      }
+      auto __value = std::move(__result.value());
+      return __value;
+    }
+    inline std::shared_ptr<Promise<PTDataResult>> sendRawDataToESPDevice(const std::string& deviceName, const std::string& path, const std::shared_ptr<ArrayBuffer>& data) override {
+      auto __result = _swiftPart.sendRawDataToESPDevice(deviceName, path, ArrayBufferHolder(data));
+      if (__result.hasError()) [[unlikely]] {
+        std::rethrow_exception(__result.error());
+      }
+      auto __value = std::move(__result.value());
+      return __value;
+    }
     inline PTStringResult getIPv4AddressOfESPDevice(const std::string& deviceName) override {
       auto __result = _swiftPart.getIPv4AddressOfESPDevice(deviceName);
       if (__result.hasError()) [[unlikely]] {
@@ -0,0 +1,46 @@
+///
+/// Func_void_PTDataResult.swift
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+import NitroModules
+
+/**
+ * Wraps a Swift `(_ value: PTDataResult) -> Void` as a class.
+ * This class can be used from C++, e.g. to wrap the Swift closure as a `std::function`.
+ */
+public final class Func_void_PTDataResult {
+  public typealias bridge = margelo.nitro.espprovtoolkit.bridge.swift
+
+  private let closure: (_ value: PTDataResult) -> Void
+
+  public init(_ closure: @escaping (_ value: PTDataResult) -> Void) {
+    self.closure = closure
+  }
+
+  @inline(__always)
+  public func call(value: PTDataResult) -> Void {
+    self.closure(value)
+  }
+
+  /**
+   * Casts this instance to a retained unsafe raw pointer.
+   * This acquires one additional strong reference on the object!
+   */
+  @inline(__always)
+  public func toUnsafe() -> UnsafeMutableRawPointer {
+    return Unmanaged.passRetained(self).toOpaque()
+  }
+
+  /**
+   * Casts an unsafe pointer to a `Func_void_PTDataResult`.
+   * The pointer has to be a retained opaque `Unmanaged<Func_void_PTDataResult>`.
+   * This removes one strong reference from the object!
+   */
+  @inline(__always)
+  public static func fromUnsafe(_ pointer: UnsafeMutableRawPointer) -> Func_void_PTDataResult {
+    return Unmanaged<Func_void_PTDataResult>.fromOpaque(pointer).takeRetainedValue()
+  }
+}
@@ -15,15 +15,22 @@ public protocol HybridEspProvToolkitSpec_protocol: HybridObject {
   // Methods
   func searchForESPDevices(devicePrefix: String, transport: PTTransport, security: PTSecurity) throws -> Promise<PTSearchResult>
   func stopSearchingForESPDevices() throws -> Void
+  func startDiscoveringESPDevices(devicePrefix: String, transport: PTTransport, security: PTSecurity, scanTimeoutMs: Double?) throws -> PTResult
+  func nextDiscoveredESPDevices() throws -> Promise<PTSearchResult>
   func createESPDevice(deviceName: String, transport: PTTransport, security: PTSecurity, proofOfPossession: String?, softAPPassword: String?, username: String?) throws -> Promise<PTResult>
   func getESPDevice(deviceName: String) throws -> PTDeviceResult
   func doesESPDeviceExist(deviceName: String) throws -> Bool
   func scanWifiListOfESPDevice(deviceName: String) throws -> Promise<PTWifiScanResult>
   func connectToESPDevice(deviceName: String) throws -> Promise<PTSessionResult>
   func disconnectFromESPDevice(deviceName: String) throws -> PTResult
+  func releaseESPDevice(deviceName: String) throws -> Bool
+  func purgeESPDevices() throws -> Void
+  func setDeviceRegistryLimits(maxDevices: Double, idleTimeoutMs: Double) throws -> Void
   func provisionESPDevice(deviceName: String, ssid: String, password: String) throws -> Promise<PTProvisionResult>
   func isESPDeviceSessionEstablished(deviceName: String) throws -> PTBooleanResult
   func sendDataToESPDevice(deviceName: String, path: String, data: String) throws -> Promise<PTStringResult>
+  func sendBinaryDataToESPDevice(deviceName: String, path: String, data: ArrayBuffer) throws -> Promise<PTDataResult>
+  func sendRawDataToESPDevice(deviceName: String, path: String, data: ArrayBuffer) throws -> Promise<PTDataResult>
   func getIPv4AddressOfESPDevice(deviceName: String) throws -> PTStringResult
   func getCurrentNetworkSSID() throws -> Promise<PTStringResult>
   func requestLocationPermission() throws -> Void
@@ -154,6 +154,44 @@ open class HybridEspProvToolkitSpec_cxx {
     }
   }
   
+  @inline(__always)
+  public final func startDiscoveringESPDevices(devicePrefix: std.string, transport: Int32, security: Int32, scanTimeoutMs: bridge.std__optional_double_) -> bridge.Result_PTResult_ {
+    do {
+      let __result = try self.__implementation.startDiscoveringESPDevices(devicePrefix: String(devicePrefix), transport: margelo.nitro.espprovtoolkit.PTTransport(rawValue: transport)!, security: margelo.nitro.espprovtoolkit.PTSecurity(rawValue: security)!, scanTimeoutMs: { () -> Double? in
+        if bridge.has_value_std__optional_double_(scanTimeoutMs) {
+          let __unwrapped = bridge.get_std__optional_double_(scanTimeoutMs)
+          return __unwrapped
+        } else {
+          return nil
+        }
+      }())
+      let __resultCpp = __result
+      return bridge.create_Result_PTResult_(__resultCpp)
+    } catch (let __error) {
+      let __exceptionPtr = __error.toCpp()
+      return bridge.create_Result_PTResult_(__exceptionPtr)
+    }
+  }
+  
+  @inline(__always)
+  public final func nextDiscoveredESPDevices() -> bridge.Result_std__shared_ptr_Promise_PTSearchResult___ {
+    do {
+      let __result = try self.__implementation.nextDiscoveredESPDevices()
+      let __resultCpp = { () -> bridge.std__shared_ptr_Promise_PTSearchResult__ in
+        let __promise = bridge.create_std__shared_ptr_Promise_PTSearchResult__()
+        let __promiseHolder = bridge.wrap_std__shared_ptr_Promise_PTSearchResult__(__promise)
+        __result
+          .then({ __result in __promiseHolder.resolve(__result) })
+          .catch({ __error in __promiseHolder.reject(__error.toCpp()) })
+        return __promise
+      }()
+      return bridge.create_Result_std__shared_ptr_Promise_PTSearchResult___(__resultCpp)
+    } catch (let __error) {
+      let __exceptionPtr = __error.toCpp()
+      return bridge.create_Result_std__shared_ptr_Promise_PTSearchResult___(__exceptionPtr)
+    }
+  }
+  
   @inline(__always)
   public final func createESPDevice(deviceName: std.string, transport: Int32, security: Int32, proofOfPossession: bridge.std__optional_std__string_, softAPPassword: bridge.std__optional_std__string_, username: bridge.std__optional_std__string_) -> bridge.Result_std__shared_ptr_Promise_PTResult___ {
     do {
@@ -268,6 +306,40 @@ open class HybridEspProvToolkitSpec_cxx {
     }
   }
   
+  @inline(__always)
+  public final func releaseESPDevice(deviceName: std.string) -> bridge.Result_bool_ {
+    do {
+      let __result = try self.__implementation.releaseESPDevice(deviceName: String(deviceName))
+      let __resultCpp = __result
+      return bridge.create_Result_bool_(__resultCpp)
+    } catch (let __error) {
+      let __exceptionPtr = __error.toCpp()
+      return bridge.create_Result_bool_(__exceptionPtr)
+    }
+  }
+  
+  @inline(__always)
+  public final func purgeESPDevices() -> bridge.Result_void_ {
+    do {
+      try self.__implementation.purgeESPDevices()
+      return bridge.create_Result_void_()
+    } catch (let __error) {
+      let __exceptionPtr = __error.toCpp()
+      return bridge.create_Result_void_(__exceptionPtr)
+    }
+  }
+  
+  @inline(__always)
+  public final func setDeviceRegistryLimits(maxDevices: Double, idleTimeoutMs: Double) -> bridge.Result_void_ {
+    do {
+      try self.__implementation.setDeviceRegistryLimits(maxDevices: maxDevices, idleTimeoutMs: idleTimeoutMs)
+      return bridge.create_Result_void_()
+    } catch (let __error) {
+      let __exceptionPtr = __error.toCpp()
+      return bridge.create_Result_void_(__exceptionPtr)
+    }
+  }
+  
   @inline(__always)
   public final func provisionESPDevice(deviceName: std.string, ssid: std.string, password: std.string) -> bridge.Result_std__shared_ptr_Promise_PTProvisionResult___ {
     do {
@@ -318,6 +390,44 @@ open class HybridEspProvToolkitSpec_cxx {
     }
   }
   
+  @inline(__always)
+  public final func sendBinaryDataToESPDevice(deviceName: std.string, path: std.string, data: ArrayBuffer) -> bridge.Result_std__shared_ptr_Promise_PTDataResult___ {
+    do {
+      let __result = try self.__implementation.sendBinaryDataToESPDevice(deviceName: String(deviceName), path: String(path), data: data)
+      let __resultCpp = { () -> bridge.std__shared_ptr_Promise_PTDataResult__ in
+        let __promise = bridge.create_std__shared_ptr_Promise_PTDataResult__()
+        let __promiseHolder = bridge.wrap_std__shared_ptr_Promise_PTDataResult__(__promise)
+        __result
+          .then({ __result in __promiseHolder.resolve(__result) })
+          .catch({ __error in __promiseHolder.reject(__error.toCpp()) })
+        return __promise
+      }()
+      return bridge.create_Result_std__shared_ptr_Promise_PTDataResult___(__resultCpp)
+    } catch (let __error) {
+      let __exceptionPtr = __error.toCpp()
+      return bridge.create_Result_std__shared_ptr_Promise_PTDataResult___(__exceptionPtr)
+    }
+  }
+  
+  @inline(__always)
+  public final func sendRawDataToESPDevice(deviceName: std.string, path: std.string, data: ArrayBuffer) -> bridge.Result_std__shared_ptr_Promise_PTDataResult___ {
+    do {
+      let __result = try self.__implementation.sendRawDataToESPDevice(deviceName: String(deviceName), path: String(path), data: data)
+      let __resultCpp = { () -> bridge.std__shared_ptr_Promise_PTDataResult__ in
+        let __promise = bridge.create_std__shared_ptr_Promise_PTDataResult__()
+        let __promiseHolder = bridge.wrap_std__shared_ptr_Promise_PTDataResult__(__promise)
+        __result
+          .then({ __result in __promiseHolder.resolve(__result) })
+          .catch({ __error in __promiseHolder.reject(__error.toCpp()) })
+        return __promise
+      }()
+      return bridge.create_Result_std__shared_ptr_Promise_PTDataResult___(__resultCpp)
+    } catch (let __error) {
+      let __exceptionPtr = __error.toCpp()
+      return bridge.create_Result_std__shared_ptr_Promise_PTDataResult___(__exceptionPtr)
+    }
+  }
+  
   @inline(__always)
   public final func getIPv4AddressOfESPDevice(deviceName: std.string) -> bridge.Result_PTStringResult_ {
     do {
@@ -0,0 +1,65 @@
+///
+/// PTDataResult.swift
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+import NitroModules
+
+/**
+ * Represents an instance of `PTDataResult`, backed by a C++ struct.
+ */
+public typealias PTDataResult = margelo.nitro.espprovtoolkit.PTDataResult
+
+public extension PTDataResult {
+  private typealias bridge = margelo.nitro.espprovtoolkit.bridge.swift
+
+  /**
+   * Create a new instance of `PTDataResult`.
+   */
+  init(success: Bool, data: ArrayBuffer?, error: Double?) {
+    self.init(success, { () -> bridge.std__optional_std__shared_ptr_ArrayBuffer__ in
+      if let __unwrappedValue = data {
+        return bridge.create_std__optional_std__shared_ptr_ArrayBuffer__(__unwrappedValue.getArrayBuffer())
+      } else {
+        return .init()
+      }
+    }(), { () -> bridge.std__optional_double_ in
+      if let __unwrappedValue = error {
+        return bridge.create_std__optional_double_(__unwrappedValue)
+      } else {
+        return .init()
+      }
+    }())
+  }
+
+  @inline(__always)
+  var success: Bool {
+    return self.__success
+  }
+  
+  @inline(__always)
+  var data: ArrayBuffer? {
+    return { () -> ArrayBuffer? in
+      if bridge.has_value_std__optional_std__shared_ptr_ArrayBuffer__(self.__data) {
+        let __unwrapped = bridge.get_std__optional_std__shared_ptr_ArrayBuffer__(self.__data)
+        return ArrayBuffer(__unwrapped)
+      } else {
+        return nil
+      }
+    }()
+  }
+  
+  @inline(__always)
+  var error: Double? {
+    return { () -> Double? in
+      if bridge.has_value_std__optional_double_(self.__error) {
+        let __unwrapped = bridge.get_std__optional_double_(self.__error)
+        return __unwrapped
+      } else {
+        return nil
+      }
+    }()
+  }
+}
@@ -93,6 +93,8 @@ public extension PTError {
         self = .espInsufficientPermissions
       case "BLE_ADAPTER_NOT_AVAILABLE":
         self = .bleAdapterNotAvailable
+      case "OPERATION_CANCELLED":
+        self = .operationCancelled
       default:
         return nil
     }
@@ -179,6 +181,8 @@ public extension PTError {
         return "ESP_INSUFFICIENT_PERMISSIONS"
       case .bleAdapterNotAvailable:
         return "BLE_ADAPTER_NOT_AVAILABLE"
+      case .operationCancelled:
+        return "OPERATION_CANCELLED"
     }
   }
 }
@@ -0,0 +1,52 @@
+///
+/// HybridEspProvEngineSpec.cpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#include "HybridEspProvEngineSpec.hpp"
+
+namespace margelo::nitro::espprovtoolkit {
+
+  void HybridEspProvEngineSpec::loadHybridMethods() {
+    // load base methods/properties
+    HybridObject::loadHybridMethods();
+    // load custom methods/properties
+    registerHybrids(this, [](Prototype& prototype) {
+      prototype.registerHybridMethod("configureESPDevice", &HybridEspProvEngineSpec::configureESPDevice);
+      prototype.registerHybridMethod("connectToESPDevice", &HybridEspProvEngineSpec::connectToESPDevice);
+      prototype.registerHybridMethod("disconnectFromESPDevice", &HybridEspProvEngineSpec::disconnectFromESPDevice);
+      prototype.registerHybridMethod("releaseESPDevice", &HybridEspProvEngineSpec::releaseESPDevice);
+      prototype.registerHybridMethod("purgeESPDevices", &HybridEspProvEngineSpec::purgeESPDevices);
+      prototype.registerHybridMethod("setDeviceRegistryLimits", &HybridEspProvEngineSpec::setDeviceRegistryLimits);
+      prototype.registerHybridMethod("addDeviceEvictionListener", &HybridEspProvEngineSpec::addDeviceEvictionListener);
+      prototype.registerHybridMethod("removeDeviceEvictionListener", &HybridEspProvEngineSpec::removeDeviceEvictionListener);
+      prototype.registerHybridMethod("setSessionLimits", &HybridEspProvEngineSpec::setSessionLimits);
+      prototype.registerHybridMethod("isESPDeviceSessionEstablished", &HybridEspProvEngineSpec::isESPDeviceSessionEstablished);
+      prototype.registerHybridMethod("getConnectionStateOfESPDevice", &HybridEspProvEngineSpec::getConnectionStateOfESPDevice);
+      prototype.registerHybridMethod("addConnectionStateListener", &HybridEspProvEngineSpec::addConnectionStateListener);
+      prototype.registerHybridMethod("removeConnectionStateListener", &HybridEspProvEngineSpec::removeConnectionStateListener);
+      prototype.registerHybridMethod("getRunTimingsOfESPDevice", &HybridEspProvEngineSpec::getRunTimingsOfESPDevice);
+      prototype.registerHybridMethod("recordPhaseOfESPDevice", &HybridEspProvEngineSpec::recordPhaseOfESPDevice);
+      prototype.registerHybridMethod("getMetricsSnapshot", &HybridEspProvEngineSpec::getMetricsSnapshot);
+      prototype.registerHybridMethod("resetMetrics", &HybridEspProvEngineSpec::resetMetrics);
+      prototype.registerHybridMethod("countError", &HybridEspProvEngineSpec::countError);
+      prototype.registerHybridMethod("startTracing", &HybridEspProvEngineSpec::startTracing);
+      prototype.registerHybridMethod("stopTracing", &HybridEspProvEngineSpec::stopTracing);
+      prototype.registerHybridMethod("exportTrace", &HybridEspProvEngineSpec::exportTrace);
+      prototype.registerHybridMethod("setWifiScanCacheTTL", &HybridEspProvEngineSpec::setWifiScanCacheTTL);
+      prototype.registerHybridMethod("scanWifiListOfESPDevice", &HybridEspProvEngineSpec::scanWifiListOfESPDevice);
+      prototype.registerHybridMethod("scanWifiColumnsOfESPDevice", &HybridEspProvEngineSpec::scanWifiColumnsOfESPDevice);
+      prototype.registerHybridMethod("startWifiScanOfESPDevice", &HybridEspProvEngineSpec::startWifiScanOfESPDevice);
+      prototype.registerHybridMethod("fetchWifiScanPageOfESPDevice", &HybridEspProvEngineSpec::fetchWifiScanPageOfESPDevice);
+      prototype.registerHybridMethod("setStatusPollSchedule", &HybridEspProvEngineSpec::setStatusPollSchedule);
+      prototype.registerHybridMethod("provisionESPDevice", &HybridEspProvEngineSpec::provisionESPDevice);
+      prototype.registerHybridMethod("sendDataToESPDevice", &HybridEspProvEngineSpec::sendDataToESPDevice);
+      prototype.registerHybridMethod("sendBinaryDataToESPDevice", &HybridEspProvEngineSpec::sendBinaryDataToESPDevice);
+      prototype.registerHybridMethod("cancelESPOperation", &HybridEspProvEngineSpec::cancelESPOperation);
+      prototype.registerHybridMethod("provisionESPDevices", &HybridEspProvEngineSpec::provisionESPDevices);
+    });
+  }
+
+} // namespace margelo::nitro::espprovtoolkit
@@ -0,0 +1,154 @@
+///
+/// HybridEspProvEngineSpec.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/HybridObject.hpp>)
+#include <NitroModules/HybridObject.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+// Forward declaration of `PTTransport` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { enum class PTTransport; }
+// Forward declaration of `PTSecurity` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { enum class PTSecurity; }
+// Forward declaration of `PTSessionResult` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTSessionResult; }
+// Forward declaration of `PTResult` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTResult; }
+// Forward declaration of `PTBooleanResult` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTBooleanResult; }
+// Forward declaration of `PTConnectionState` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { enum class PTConnectionState; }
+// Forward declaration of `PTConnectionTransition` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTConnectionTransition; }
+// Forward declaration of `PTPhaseSpan` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTPhaseSpan; }
+// Forward declaration of `PTPhase` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { enum class PTPhase; }
+// Forward declaration of `PTMetricsSnapshot` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTMetricsSnapshot; }
+// Forward declaration of `PTWifiScanResult` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTWifiScanResult; }
+// Forward declaration of `PTWifiScanColumns` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTWifiScanColumns; }
+// Forward declaration of `PTWifiScanPage` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTWifiScanPage; }
+// Forward declaration of `PTProvisionResult` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTProvisionResult; }
+// Forward declaration of `PTStringResult` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTStringResult; }
+// Forward declaration of `PTDataResult` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTDataResult; }
+// Forward declaration of `PTDeviceProvisionResult` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTDeviceProvisionResult; }
+// Forward declaration of `PTProvisionJob` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTProvisionJob; }
+// Forward declaration of `PTBatchOptions` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTBatchOptions; }
+
+#include <string>
+#include "PTTransport.hpp"
+#include "PTSecurity.hpp"
+#include <optional>
+#include "PTSessionResult.hpp"
+#include <NitroModules/Promise.hpp>
+#include "PTResult.hpp"
+#include "PTBooleanResult.hpp"
+#include "PTConnectionState.hpp"
+#include "PTConnectionTransition.hpp"
+#include <functional>
+#include "PTPhaseSpan.hpp"
+#include <vector>
+#include "PTPhase.hpp"
+#include "PTMetricsSnapshot.hpp"
+#include "PTWifiScanResult.hpp"
+#include "PTWifiScanColumns.hpp"
+#include "PTWifiScanPage.hpp"
+#include "PTProvisionResult.hpp"
+#include "PTStringResult.hpp"
+#include "PTDataResult.hpp"
+#include <NitroModules/ArrayBuffer.hpp>
+#include "PTDeviceProvisionResult.hpp"
+#include "PTProvisionJob.hpp"
+#include "PTBatchOptions.hpp"
+
+namespace margelo::nitro::espprovtoolkit {
+
+  using namespace margelo::nitro;
+
+  /**
+   * An abstract base class for `EspProvEngine`
+   * Inherit this class to create instances of `HybridEspProvEngineSpec` in C++.
+   * You must explicitly call `HybridObject`'s constructor yourself, because it is virtual.
+   * @example
+   * ```cpp
+   * class HybridEspProvEngine: public HybridEspProvEngineSpec {
+   * public:
+   *   HybridEspProvEngine(...): HybridObject(TAG) { ... }
+   *   // ...
+   * };
+   * ```
+   */
+  class HybridEspProvEngineSpec: public virtual HybridObject {
+    public:
+      // Constructor
+      explicit HybridEspProvEngineSpec(): HybridObject(TAG) { }
+
+      // Destructor
+      ~HybridEspProvEngineSpec() override = default;
+
+    public:
+      // Properties
+      
+
+    public:
+      // Methods
+      virtual bool configureESPDevice(const std::string& deviceName, PTTransport transport, PTSecurity security, const std::optional<std::string>& proofOfPossession, const std::optional<std::string>& username) = 0;
+      virtual std::shared_ptr<Promise<PTSessionResult>> connectToESPDevice(const std::string& deviceName, std::optional<double> operationId) = 0;
+      virtual PTResult disconnectFromESPDevice(const std::string& deviceName) = 0;
+      virtual bool releaseESPDevice(const std::string& deviceName) = 0;
+      virtual void purgeESPDevices() = 0;
+      virtual void setDeviceRegistryLimits(double maxDevices, double idleTimeoutMs) = 0;
+      virtual double addDeviceEvictionListener(const std::function<void(const std::string& /* deviceName */)>& listener) = 0;
+      virtual bool removeDeviceEvictionListener(double id) = 0;
+      virtual void setSessionLimits(double maxLinks, double maxExchanges) = 0;
+      virtual PTBooleanResult isESPDeviceSessionEstablished(const std::string& deviceName) = 0;
+      virtual PTConnectionState getConnectionStateOfESPDevice(const std::string& deviceName) = 0;
+      virtual double addConnectionStateListener(const std::function<void(const PTConnectionTransition& /* transition */)>& listener) = 0;
+      virtual bool removeConnectionStateListener(double id) = 0;
+      virtual std::vector<PTPhaseSpan> getRunTimingsOfESPDevice(const std::string& deviceName) = 0;
+      virtual void recordPhaseOfESPDevice(const std::string& deviceName, PTPhase phase, double start, double duration, bool failed) = 0;
+      virtual PTMetricsSnapshot getMetricsSnapshot(bool reset) = 0;
+      virtual void resetMetrics() = 0;
+      virtual void countError(double error) = 0;
+      virtual void startTracing() = 0;
+      virtual void stopTracing() = 0;
+      virtual std::string exportTrace() = 0;
+      virtual void setWifiScanCacheTTL(double ttlMs) = 0;
+      virtual std::shared_ptr<Promise<PTWifiScanResult>> scanWifiListOfESPDevice(const std::string& deviceName, std::optional<bool> forceRefresh, std::optional<double> operationId) = 0;
+      virtual std::shared_ptr<Promise<PTWifiScanColumns>> scanWifiColumnsOfESPDevice(const std::string& deviceName, std::optional<bool> forceRefresh, std::optional<double> operationId) = 0;
+      virtual std::shared_ptr<Promise<PTWifiScanPage>> startWifiScanOfESPDevice(const std::string& deviceName, double pageSize, std::optional<bool> forceRefresh, std::optional<double> operationId) = 0;
+      virtual std::shared_ptr<Promise<PTWifiScanPage>> fetchWifiScanPageOfESPDevice(const std::string& deviceName, double startIndex, double count, std::optional<double> operationId) = 0;
+      virtual void setStatusPollSchedule(double firstMs, double backoff, double maxMs, double deadlineMs) = 0;
+      virtual std::shared_ptr<Promise<PTProvisionResult>> provisionESPDevice(const std::string& deviceName, const std::string& ssid, const std::string& password, std::optional<double> operationId) = 0;
+      virtual std::shared_ptr<Promise<PTStringResult>> sendDataToESPDevice(const std::string& deviceName, const std::string& path, const std::string& data, std::optional<double> operationId) = 0;
+      virtual std::shared_ptr<Promise<PTDataResult>> sendBinaryDataToESPDevice(const std::string& deviceName, const std::string& path, const std::shared_ptr<ArrayBuffer>& data, std::optional<double> operationId) = 0;
+      virtual bool cancelESPOperation(double operationId) = 0;
+      virtual std::shared_ptr<Promise<std::vector<PTDeviceProvisionResult>>> provisionESPDevices(const std::vector<PTProvisionJob>& jobs, const std::optional<PTBatchOptions>& options, std::optional<double> operationId) = 0;
+
+    protected:
+      // Hybrid Setup
+      void loadHybridMethods() override;
+
+    protected:
+      // Tag for logging
+      static constexpr auto TAG = "EspProvEngine";
+  };
+
+} // namespace margelo::nitro::espprovtoolkit
@@ -16,15 +16,22 @@ namespace margelo::nitro::espprovtoolkit {
     registerHybrids(this, [](Prototype& prototype) {
       prototype.registerHybridMethod("searchForESPDevices", &HybridEspProvToolkitSpec::searchForESPDevices);
       prototype.registerHybridMethod("stopSearchingForESPDevices", &HybridEspProvToolkitSpec::stopSearchingForESPDevices);
+      prototype.registerHybridMethod("startDiscoveringESPDevices", &HybridEspProvToolkitSpec::startDiscoveringESPDevices);
+      prototype.registerHybridMethod("nextDiscoveredESPDevices", &HybridEspProvToolkitSpec::nextDiscoveredESPDevices);
       prototype.registerHybridMethod("createESPDevice", &HybridEspProvToolkitSpec::createESPDevice);
       prototype.registerHybridMethod("getESPDevice", &HybridEspProvToolkitSpec::getESPDevice);
       prototype.registerHybridMethod("doesESPDeviceExist", &HybridEspProvToolkitSpec::doesESPDeviceExist);
       prototype.registerHybridMethod("scanWifiListOfESPDevice", &HybridEspProvToolkitSpec::scanWifiListOfESPDevice);
       prototype.registerHybridMethod("connectToESPDevice", &HybridEspProvToolkitSpec::connectToESPDevice);
       prototype.registerHybridMethod("disconnectFromESPDevice", &HybridEspProvToolkitSpec::disconnectFromESPDevice);
+      prototype.registerHybridMethod("releaseESPDevice", &HybridEspProvToolkitSpec::releaseESPDevice);
+      prototype.registerHybridMethod("purgeESPDevices", &HybridEspProvToolkitSpec::purgeESPDevices);
+      prototype.registerHybridMethod("setDeviceRegistryLimits", &HybridEspProvToolkitSpec::setDeviceRegistryLimits);
       prototype.registerHybridMethod("provisionESPDevice", &HybridEspProvToolkitSpec::provisionESPDevice);
       prototype.registerHybridMethod("isESPDeviceSessionEstablished", &HybridEspProvToolkitSpec::isESPDeviceSessionEstablished);
       prototype.registerHybridMethod("sendDataToESPDevice", &HybridEspProvToolkitSpec::sendDataToESPDevice);
+      prototype.registerHybridMethod("sendBinaryDataToESPDevice", &HybridEspProvToolkitSpec::sendBinaryDataToESPDevice);
+      prototype.registerHybridMethod("sendRawDataToESPDevice", &HybridEspProvToolkitSpec::sendRawDataToESPDevice);
       prototype.registerHybridMethod("getIPv4AddressOfESPDevice", &HybridEspProvToolkitSpec::getIPv4AddressOfESPDevice);
       prototype.registerHybridMethod("getCurrentNetworkSSID", &HybridEspProvToolkitSpec::getCurrentNetworkSSID);
       prototype.registerHybridMethod("requestLocationPermission", &HybridEspProvToolkitSpec::requestLocationPermission);
@@ -33,6 +33,8 @@ namespace margelo::nitro::espprovtoolkit { struct PTProvisionResult; }
 namespace margelo::nitro::espprovtoolkit { struct PTBooleanResult; }
 // Forward declaration of `PTStringResult` to properly resolve imports.
 namespace margelo::nitro::espprovtoolkit { struct PTStringResult; }
+// Forward declaration of `PTDataResult` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTDataResult; }
 // Forward declaration of `PTLocationAccess` to properly resolve imports.
 namespace margelo::nitro::espprovtoolkit { enum class PTLocationAccess; }
 // Forward declaration of `PTError` to properly resolve imports.
@@ -51,6 +53,8 @@ namespace margelo::nitro::espprovtoolkit { enum class PTError; }
 #include "PTProvisionResult.hpp"
 #include "PTBooleanResult.hpp"
 #include "PTStringResult.hpp"
+#include "PTDataResult.hpp"
+#include <NitroModules/ArrayBuffer.hpp>
 #include "PTLocationAccess.hpp"
 #include <functional>
 #include "PTError.hpp"
@@ -88,15 +92,22 @@ namespace margelo::nitro::espprovtoolkit {
       // Methods
       virtual std::shared_ptr<Promise<PTSearchResult>> searchForESPDevices(const std::string& devicePrefix, PTTransport transport, PTSecurity security) = 0;
       virtual void stopSearchingForESPDevices() = 0;
+      virtual PTResult startDiscoveringESPDevices(const std::string& devicePrefix, PTTransport transport, PTSecurity security, std::optional<double> scanTimeoutMs) = 0;
+      virtual std::shared_ptr<Promise<PTSearchResult>> nextDiscoveredESPDevices() = 0;
       virtual std::shared_ptr<Promise<PTResult>> createESPDevice(const std::string& deviceName, PTTransport transport, PTSecurity security, const std::optional<std::string>& proofOfPossession, const std::optional<std::string>& softAPPassword, const std::optional<std::string>& username) = 0;
       virtual PTDeviceResult getESPDevice(const std::string& deviceName) = 0;
       virtual bool doesESPDeviceExist(const std::string& deviceName) = 0;
       virtual std::shared_ptr<Promise<PTWifiScanResult>> scanWifiListOfESPDevice(const std::string& deviceName) = 0;
       virtual std::shared_ptr<Promise<PTSessionResult>> connectToESPDevice(const std::string& deviceName) = 0;
       virtual PTResult disconnectFromESPDevice(const std::string& deviceName) = 0;
+      virtual bool releaseESPDevice(const std::string& deviceName) = 0;
+      virtual void purgeESPDevices() = 0;
+      virtual void setDeviceRegistryLimits(double maxDevices, double idleTimeoutMs) = 0;
       virtual std::shared_ptr<Promise<PTProvisionResult>> provisionESPDevice(const std::string& deviceName, const std::string& ssid, const std::string& password) = 0;
       virtual PTBooleanResult isESPDeviceSessionEstablished(const std::string& deviceName) = 0;
       virtual std::shared_ptr<Promise<PTStringResult>> sendDataToESPDevice(const std::string& deviceName, const std::string& path, const std::string& data) = 0;
+      virtual std::shared_ptr<Promise<PTDataResult>> sendBinaryDataToESPDevice(const std::string& deviceName, const std::string& path, const std::shared_ptr<ArrayBuffer>& data) = 0;
+      virtual std::shared_ptr<Promise<PTDataResult>> sendRawDataToESPDevice(const std::string& deviceName, const std::string& path, const std::shared_ptr<ArrayBuffer>& data) = 0;
       virtual PTStringResult getIPv4AddressOfESPDevice(const std::string& deviceName) = 0;
       virtual std::shared_ptr<Promise<PTStringResult>> getCurrentNetworkSSID() = 0;
       virtual void requestLocationPermission() = 0;
@@ -0,0 +1,85 @@
+///
+/// PTBatchOptions.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+#include <optional>
+
+namespace margelo::nitro::espprovtoolkit {
+
+  /**
+   * A struct which can be represented as a JavaScript object (PTBatchOptions).
+   */
+  struct PTBatchOptions final {
+  public:
+    std::optional<double> concurrency     SWIFT_PRIVATE;
+    std::optional<double> timeoutMs     SWIFT_PRIVATE;
+
+  public:
+    PTBatchOptions() = default;
+    explicit PTBatchOptions(std::optional<double> concurrency, std::optional<double> timeoutMs): concurrency(concurrency), timeoutMs(timeoutMs) {}
+
+  public:
+    friend bool operator==(const PTBatchOptions& lhs, const PTBatchOptions& rhs) = default;
+  };
+
+} // namespace margelo::nitro::espprovtoolkit
+
+namespace margelo::nitro {
+
+  // C++ PTBatchOptions <> JS PTBatchOptions (object)
+  template <>
+  struct JSIConverter<margelo::nitro::espprovtoolkit::PTBatchOptions> final {
+    static inline margelo::nitro::espprovtoolkit::PTBatchOptions fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::espprovtoolkit::PTBatchOptions(
+        JSIConverter<std::optional<double>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "concurrency"))),
+        JSIConverter<std::optional<double>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "timeoutMs")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::espprovtoolkit::PTBatchOptions& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "concurrency"), JSIConverter<std::optional<double>>::toJSI(runtime, arg.concurrency));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "timeoutMs"), JSIConverter<std::optional<double>>::toJSI(runtime, arg.timeoutMs));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<std::optional<double>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "concurrency")))) return false;
+      if (!JSIConverter<std::optional<double>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "timeoutMs")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
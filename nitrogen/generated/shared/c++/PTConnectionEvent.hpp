@@ -0,0 +1,68 @@
+///
+/// PTConnectionEvent.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+namespace margelo::nitro::espprovtoolkit {
+
+  /**
+   * An enum which can be represented as a JavaScript enum (PTConnectionEvent).
+   */
+  enum class PTConnectionEvent {
+    CONNECT_REQUESTED      SWIFT_NAME(connectRequested) = 0,
+    LINK_UP      SWIFT_NAME(linkUp) = 1,
+    LINK_FAILED      SWIFT_NAME(linkFailed) = 2,
+    LINK_DOWN      SWIFT_NAME(linkDown) = 3,
+    SESSION_ESTABLISHED      SWIFT_NAME(sessionEstablished) = 4,
+    SESSION_FAILED      SWIFT_NAME(sessionFailed) = 5,
+    DISCONNECT_REQUESTED      SWIFT_NAME(disconnectRequested) = 6,
+    TIMEOUT      SWIFT_NAME(timeout) = 7,
+  } CLOSED_ENUM;
+
+} // namespace margelo::nitro::espprovtoolkit
+
+namespace margelo::nitro {
+
+  // C++ PTConnectionEvent <> JS PTConnectionEvent (enum)
+  template <>
+  struct JSIConverter<margelo::nitro::espprovtoolkit::PTConnectionEvent> final {
+    static inline margelo::nitro::espprovtoolkit::PTConnectionEvent fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      int enumValue = JSIConverter<int>::fromJSI(runtime, arg);
+      return static_cast<margelo::nitro::espprovtoolkit::PTConnectionEvent>(enumValue);
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, margelo::nitro::espprovtoolkit::PTConnectionEvent arg) {
+      int enumValue = static_cast<int>(arg);
+      return JSIConverter<int>::toJSI(runtime, enumValue);
+    }
+    static inline bool canConvert(jsi::Runtime&, const jsi::Value& value) {
+      if (!value.isNumber()) {
+        return false;
+      }
+      double number = value.getNumber();
+      int integer = static_cast<int>(number);
+      if (number != integer) {
+        // The integer is not the same value as the double - we truncated floating points.
+        // Enums are all integers, so the input floating point number is obviously invalid.
+        return false;
+      }
+      // Check if we are within the bounds of the enum.
+      return integer >= 0 && integer <= 7;
+    }
+  };
+
+} // namespace margelo::nitro
@@ -0,0 +1,65 @@
+///
+/// PTConnectionState.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+namespace margelo::nitro::espprovtoolkit {
+
+  /**
+   * An enum which can be represented as a JavaScript enum (PTConnectionState).
+   */
+  enum class PTConnectionState {
+    IDLE      SWIFT_NAME(idle) = 0,
+    CONNECTING      SWIFT_NAME(connecting) = 1,
+    SECURING      SWIFT_NAME(securing) = 2,
+    SECURED      SWIFT_NAME(secured) = 3,
+    LOST      SWIFT_NAME(lost) = 4,
+  } CLOSED_ENUM;
+
+} // namespace margelo::nitro::espprovtoolkit
+
+namespace margelo::nitro {
+
+  // C++ PTConnectionState <> JS PTConnectionState (enum)
+  template <>
+  struct JSIConverter<margelo::nitro::espprovtoolkit::PTConnectionState> final {
+    static inline margelo::nitro::espprovtoolkit::PTConnectionState fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      int enumValue = JSIConverter<int>::fromJSI(runtime, arg);
+      return static_cast<margelo::nitro::espprovtoolkit::PTConnectionState>(enumValue);
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, margelo::nitro::espprovtoolkit::PTConnectionState arg) {
+      int enumValue = static_cast<int>(arg);
+      return JSIConverter<int>::toJSI(runtime, enumValue);
+    }
+    static inline bool canConvert(jsi::Runtime&, const jsi::Value& value) {
+      if (!value.isNumber()) {
+        return false;
+      }
+      double number = value.getNumber();
+      int integer = static_cast<int>(number);
+      if (number != integer) {
+        // The integer is not the same value as the double - we truncated floating points.
+        // Enums are all integers, so the input floating point number is obviously invalid.
+        return false;
+      }
+      // Check if we are within the bounds of the enum.
+      return integer >= 0 && integer <= 4;
+    }
+  };
+
+} // namespace margelo::nitro
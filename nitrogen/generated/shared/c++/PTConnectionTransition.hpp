@@ -0,0 +1,113 @@
+///
+/// PTConnectionTransition.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+// Forward declaration of `PTConnectionState` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { enum class PTConnectionState; }
+// Forward declaration of `PTConnectionEvent` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { enum class PTConnectionEvent; }
+
+#include <string>
+#include "PTConnectionState.hpp"
+#include "PTConnectionEvent.hpp"
+#include <optional>
+
+namespace margelo::nitro::espprovtoolkit {
+
+  /**
+   * A struct which can be represented as a JavaScript object (PTConnectionTransition).
+   */
+  struct PTConnectionTransition final {
+  public:
+    std::string deviceName     SWIFT_PRIVATE;
+    PTConnectionState from     SWIFT_PRIVATE;
+    PTConnectionState to     SWIFT_PRIVATE;
+    PTConnectionEvent event     SWIFT_PRIVATE;
+    double attempt     SWIFT_PRIVATE;
+    std::optional<double> error     SWIFT_PRIVATE;
+    double timestamp     SWIFT_PRIVATE;
+
+  public:
+    PTConnectionTransition() = default;
+    explicit PTConnectionTransition(std::string deviceName, PTConnectionState from, PTConnectionState to, PTConnectionEvent event, double attempt, std::optional<double> error, double timestamp): deviceName(deviceName), from(from), to(to), event(event), attempt(attempt), error(error), timestamp(timestamp) {}
+
+  public:
+    friend bool operator==(const PTConnectionTransition& lhs, const PTConnectionTransition& rhs) = default;
+  };
+
+} // namespace margelo::nitro::espprovtoolkit
+
+namespace margelo::nitro {
+
+  // C++ PTConnectionTransition <> JS PTConnectionTransition (object)
+  template <>
+  struct JSIConverter<margelo::nitro::espprovtoolkit::PTConnectionTransition> final {
+    static inline margelo::nitro::espprovtoolkit::PTConnectionTransition fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::espprovtoolkit::PTConnectionTransition(
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "deviceName"))),
+        JSIConverter<margelo::nitro::espprovtoolkit::PTConnectionState>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "from"))),
+        JSIConverter<margelo::nitro::espprovtoolkit::PTConnectionState>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "to"))),
+        JSIConverter<margelo::nitro::espprovtoolkit::PTConnectionEvent>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "event"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "attempt"))),
+        JSIConverter<std::optional<double>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "error"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "timestamp")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::espprovtoolkit::PTConnectionTransition& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "deviceName"), JSIConverter<std::string>::toJSI(runtime, arg.deviceName));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "from"), JSIConverter<margelo::nitro::espprovtoolkit::PTConnectionState>::toJSI(runtime, arg.from));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "to"), JSIConverter<margelo::nitro::espprovtoolkit::PTConnectionState>::toJSI(runtime, arg.to));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "event"), JSIConverter<margelo::nitro::espprovtoolkit::PTConnectionEvent>::toJSI(runtime, arg.event));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "attempt"), JSIConverter<double>::toJSI(runtime, arg.attempt));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "error"), JSIConverter<std::optional<double>>::toJSI(runtime, arg.error));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "timestamp"), JSIConverter<double>::toJSI(runtime, arg.timestamp));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "deviceName")))) return false;
+      if (!JSIConverter<margelo::nitro::espprovtoolkit::PTConnectionState>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "from")))) return false;
+      if (!JSIConverter<margelo::nitro::espprovtoolkit::PTConnectionState>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "to")))) return false;
+      if (!JSIConverter<margelo::nitro::espprovtoolkit::PTConnectionEvent>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "event")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "attempt")))) return false;
+      if (!JSIConverter<std::optional<double>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "error")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "timestamp")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
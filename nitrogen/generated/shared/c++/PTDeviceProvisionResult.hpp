@@ -0,0 +1,99 @@
+///
+/// PTDeviceProvisionResult.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+// Forward declaration of `PTPhaseSpan` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTPhaseSpan; }
+
+#include <string>
+#include <optional>
+#include "PTPhaseSpan.hpp"
+#include <vector>
+
+namespace margelo::nitro::espprovtoolkit {
+
+  /**
+   * A struct which can be represented as a JavaScript object (PTDeviceProvisionResult).
+   */
+  struct PTDeviceProvisionResult final {
+  public:
+    std::string deviceName     SWIFT_PRIVATE;
+    bool success     SWIFT_PRIVATE;
+    std::optional<double> error     SWIFT_PRIVATE;
+    std::optional<std::vector<PTPhaseSpan>> timings     SWIFT_PRIVATE;
+
+  public:
+    PTDeviceProvisionResult() = default;
+    explicit PTDeviceProvisionResult(std::string deviceName, bool success, std::optional<double> error, std::optional<std::vector<PTPhaseSpan>> timings): deviceName(deviceName), success(success), error(error), timings(timings) {}
+
+  public:
+    friend bool operator==(const PTDeviceProvisionResult& lhs, const PTDeviceProvisionResult& rhs) = default;
+  };
+
+} // namespace margelo::nitro::espprovtoolkit
+
+namespace margelo::nitro {
+
+  // C++ PTDeviceProvisionResult <> JS PTDeviceProvisionResult (object)
+  template <>
+  struct JSIConverter<margelo::nitro::espprovtoolkit::PTDeviceProvisionResult> final {
+    static inline margelo::nitro::espprovtoolkit::PTDeviceProvisionResult fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::espprovtoolkit::PTDeviceProvisionResult(
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "deviceName"))),
+        JSIConverter<bool>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "success"))),
+        JSIConverter<std::optional<double>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "error"))),
+        JSIConverter<std::optional<std::vector<margelo::nitro::espprovtoolkit::PTPhaseSpan>>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "timings")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::espprovtoolkit::PTDeviceProvisionResult& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "deviceName"), JSIConverter<std::string>::toJSI(runtime, arg.deviceName));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "success"), JSIConverter<bool>::toJSI(runtime, arg.success));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "error"), JSIConverter<std::optional<double>>::toJSI(runtime, arg.error));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "timings"), JSIConverter<std::optional<std::vector<margelo::nitro::espprovtoolkit::PTPhaseSpan>>>::toJSI(runtime, arg.timings));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "deviceName")))) return false;
+      if (!JSIConverter<bool>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "success")))) return false;
+      if (!JSIConverter<std::optional<double>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "error")))) return false;
+      if (!JSIConverter<std::optional<std::vector<margelo::nitro::espprovtoolkit::PTPhaseSpan>>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "timings")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
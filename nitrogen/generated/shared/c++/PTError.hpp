@@ -62,6 +62,7 @@ namespace margelo::nitro::espprovtoolkit {
     ESP_NATIVE_UNKNOWN_ERROR      SWIFT_NAME(espNativeUnknownError) = 4,
     ESP_INSUFFICIENT_PERMISSIONS      SWIFT_NAME(espInsufficientPermissions) = 47,
     BLE_ADAPTER_NOT_AVAILABLE      SWIFT_NAME(bleAdapterNotAvailable) = 48,
+    OPERATION_CANCELLED      SWIFT_NAME(operationCancelled) = 49,
   } CLOSED_ENUM;
 
 } // namespace margelo::nitro::espprovtoolkit
@@ -129,6 +130,7 @@ namespace margelo::nitro {
         case 4 /* ESP_NATIVE_UNKNOWN_ERROR */: return true;
         case 47 /* ESP_INSUFFICIENT_PERMISSIONS */: return true;
         case 48 /* BLE_ADAPTER_NOT_AVAILABLE */: return true;
+        case 49 /* OPERATION_CANCELLED */: return true;
         default: return false;
       }
     }
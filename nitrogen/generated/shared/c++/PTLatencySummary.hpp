@@ -0,0 +1,113 @@
+///
+/// PTLatencySummary.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+#include <string>
+
+namespace margelo::nitro::espprovtoolkit {
+
+  /**
+   * A struct which can be represented as a JavaScript object (PTLatencySummary).
+   */
+  struct PTLatencySummary final {
+  public:
+    std::string name     SWIFT_PRIVATE;
+    double count     SWIFT_PRIVATE;
+    double minMs     SWIFT_PRIVATE;
+    double meanMs     SWIFT_PRIVATE;
+    double p50Ms     SWIFT_PRIVATE;
+    double p90Ms     SWIFT_PRIVATE;
+    double p95Ms     SWIFT_PRIVATE;
+    double p99Ms     SWIFT_PRIVATE;
+    double maxMs     SWIFT_PRIVATE;
+
+  public:
+    PTLatencySummary() = default;
+    explicit PTLatencySummary(std::string name, double count, double minMs, double meanMs, double p50Ms, double p90Ms, double p95Ms, double p99Ms, double maxMs): name(name), count(count), minMs(minMs), meanMs(meanMs), p50Ms(p50Ms), p90Ms(p90Ms), p95Ms(p95Ms), p99Ms(p99Ms), maxMs(maxMs) {}
+
+  public:
+    friend bool operator==(const PTLatencySummary& lhs, const PTLatencySummary& rhs) = default;
+  };
+
+} // namespace margelo::nitro::espprovtoolkit
+
+namespace margelo::nitro {
+
+  // C++ PTLatencySummary <> JS PTLatencySummary (object)
+  template <>
+  struct JSIConverter<margelo::nitro::espprovtoolkit::PTLatencySummary> final {
+    static inline margelo::nitro::espprovtoolkit::PTLatencySummary fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::espprovtoolkit::PTLatencySummary(
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "name"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "count"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "minMs"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "meanMs"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "p50Ms"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "p90Ms"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "p95Ms"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "p99Ms"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "maxMs")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::espprovtoolkit::PTLatencySummary& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "name"), JSIConverter<std::string>::toJSI(runtime, arg.name));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "count"), JSIConverter<double>::toJSI(runtime, arg.count));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "minMs"), JSIConverter<double>::toJSI(runtime, arg.minMs));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "meanMs"), JSIConverter<double>::toJSI(runtime, arg.meanMs));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "p50Ms"), JSIConverter<double>::toJSI(runtime, arg.p50Ms));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "p90Ms"), JSIConverter<double>::toJSI(runtime, arg.p90Ms));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "p95Ms"), JSIConverter<double>::toJSI(runtime, arg.p95Ms));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "p99Ms"), JSIConverter<double>::toJSI(runtime, arg.p99Ms));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "maxMs"), JSIConverter<double>::toJSI(runtime, arg.maxMs));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "name")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "count")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "minMs")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "meanMs")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "p50Ms")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "p90Ms")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "p95Ms")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "p99Ms")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "maxMs")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
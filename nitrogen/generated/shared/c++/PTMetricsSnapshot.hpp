@@ -0,0 +1,100 @@
+///
+/// PTMetricsSnapshot.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+// Forward declaration of `PTLatencySummary` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTLatencySummary; }
+// Forward declaration of `PTErrorCount` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTErrorCount; }
+
+#include "PTLatencySummary.hpp"
+#include <vector>
+#include "PTErrorCount.hpp"
+
+namespace margelo::nitro::espprovtoolkit {
+
+  /**
+   * A struct which can be represented as a JavaScript object (PTMetricsSnapshot).
+   */
+  struct PTMetricsSnapshot final {
+  public:
+    double since     SWIFT_PRIVATE;
+    std::vector<PTLatencySummary> phases     SWIFT_PRIVATE;
+    std::vector<PTLatencySummary> endpoints     SWIFT_PRIVATE;
+    std::vector<PTErrorCount> errors     SWIFT_PRIVATE;
+
+  public:
+    PTMetricsSnapshot() = default;
+    explicit PTMetricsSnapshot(double since, std::vector<PTLatencySummary> phases, std::vector<PTLatencySummary> endpoints, std::vector<PTErrorCount> errors): since(since), phases(phases), endpoints(endpoints), errors(errors) {}
+
+  public:
+    friend bool operator==(const PTMetricsSnapshot& lhs, const PTMetricsSnapshot& rhs) = default;
+  };
+
+} // namespace margelo::nitro::espprovtoolkit
+
+namespace margelo::nitro {
+
+  // C++ PTMetricsSnapshot <> JS PTMetricsSnapshot (object)
+  template <>
+  struct JSIConverter<margelo::nitro::espprovtoolkit::PTMetricsSnapshot> final {
+    static inline margelo::nitro::espprovtoolkit::PTMetricsSnapshot fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::espprovtoolkit::PTMetricsSnapshot(
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "since"))),
+        JSIConverter<std::vector<margelo::nitro::espprovtoolkit::PTLatencySummary>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "phases"))),
+        JSIConverter<std::vector<margelo::nitro::espprovtoolkit::PTLatencySummary>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "endpoints"))),
+        JSIConverter<std::vector<margelo::nitro::espprovtoolkit::PTErrorCount>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "errors")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::espprovtoolkit::PTMetricsSnapshot& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "since"), JSIConverter<double>::toJSI(runtime, arg.since));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "phases"), JSIConverter<std::vector<margelo::nitro::espprovtoolkit::PTLatencySummary>>::toJSI(runtime, arg.phases));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "endpoints"), JSIConverter<std::vector<margelo::nitro::espprovtoolkit::PTLatencySummary>>::toJSI(runtime, arg.endpoints));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "errors"), JSIConverter<std::vector<margelo::nitro::espprovtoolkit::PTErrorCount>>::toJSI(runtime, arg.errors));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "since")))) return false;
+      if (!JSIConverter<std::vector<margelo::nitro::espprovtoolkit::PTLatencySummary>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "phases")))) return false;
+      if (!JSIConverter<std::vector<margelo::nitro::espprovtoolkit::PTLatencySummary>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "endpoints")))) return false;
+      if (!JSIConverter<std::vector<margelo::nitro::espprovtoolkit::PTErrorCount>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "errors")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
@@ -0,0 +1,69 @@
+///
+/// PTPhase.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+namespace margelo::nitro::espprovtoolkit {
+
+  /**
+   * An enum which can be represented as a JavaScript enum (PTPhase).
+   */
+  enum class PTPhase {
+    SEARCH      SWIFT_NAME(search) = 0,
+    CREATE      SWIFT_NAME(create) = 1,
+    CONNECT      SWIFT_NAME(connect) = 2,
+    VERSION_INFO      SWIFT_NAME(versionInfo) = 3,
+    HANDSHAKE      SWIFT_NAME(handshake) = 4,
+    SCAN      SWIFT_NAME(scan) = 5,
+    CONFIG_SEND      SWIFT_NAME(configSend) = 6,
+    APPLY      SWIFT_NAME(apply) = 7,
+    STATUS_WAIT      SWIFT_NAME(statusWait) = 8,
+  } CLOSED_ENUM;
+
+} // namespace margelo::nitro::espprovtoolkit
+
+namespace margelo::nitro {
+
+  // C++ PTPhase <> JS PTPhase (enum)
+  template <>
+  struct JSIConverter<margelo::nitro::espprovtoolkit::PTPhase> final {
+    static inline margelo::nitro::espprovtoolkit::PTPhase fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      int enumValue = JSIConverter<int>::fromJSI(runtime, arg);
+      return static_cast<margelo::nitro::espprovtoolkit::PTPhase>(enumValue);
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, margelo::nitro::espprovtoolkit::PTPhase arg) {
+      int enumValue = static_cast<int>(arg);
+      return JSIConverter<int>::toJSI(runtime, enumValue);
+    }
+    static inline bool canConvert(jsi::Runtime&, const jsi::Value& value) {
+      if (!value.isNumber()) {
+        return false;
+      }
+      double number = value.getNumber();
+      int integer = static_cast<int>(number);
+      if (number != integer) {
+        // The integer is not the same value as the double - we truncated floating points.
+        // Enums are all integers, so the input floating point number is obviously invalid.
+        return false;
+      }
+      // Check if we are within the bounds of the enum.
+      return integer >= 0 && integer <= 8;
+    }
+  };
+
+} // namespace margelo::nitro
@@ -0,0 +1,101 @@
+///
+/// PTPhaseSpan.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+// Forward declaration of `PTPhase` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { enum class PTPhase; }
+
+#include "PTPhase.hpp"
+#include <optional>
+
+namespace margelo::nitro::espprovtoolkit {
+
+  /**
+   * A struct which can be represented as a JavaScript object (PTPhaseSpan).
+   */
+  struct PTPhaseSpan final {
+  public:
+    PTPhase phase     SWIFT_PRIVATE;
+    double start     SWIFT_PRIVATE;
+    double duration     SWIFT_PRIVATE;
+    bool failed     SWIFT_PRIVATE;
+    std::optional<double> polls     SWIFT_PRIVATE;
+
+  public:
+    PTPhaseSpan() = default;
+    explicit PTPhaseSpan(PTPhase phase, double start, double duration, bool failed, std::optional<double> polls): phase(phase), start(start), duration(duration), failed(failed), polls(polls) {}
+
+  public:
+    friend bool operator==(const PTPhaseSpan& lhs, const PTPhaseSpan& rhs) = default;
+  };
+
+} // namespace margelo::nitro::espprovtoolkit
+
+namespace margelo::nitro {
+
+  // C++ PTPhaseSpan <> JS PTPhaseSpan (object)
+  template <>
+  struct JSIConverter<margelo::nitro::espprovtoolkit::PTPhaseSpan> final {
+    static inline margelo::nitro::espprovtoolkit::PTPhaseSpan fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::espprovtoolkit::PTPhaseSpan(
+        JSIConverter<margelo::nitro::espprovtoolkit::PTPhase>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "phase"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "start"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "duration"))),
+        JSIConverter<bool>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "failed"))),
+        JSIConverter<std::optional<double>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "polls")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::espprovtoolkit::PTPhaseSpan& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "phase"), JSIConverter<margelo::nitro::espprovtoolkit::PTPhase>::toJSI(runtime, arg.phase));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "start"), JSIConverter<double>::toJSI(runtime, arg.start));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "duration"), JSIConverter<double>::toJSI(runtime, arg.duration));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "failed"), JSIConverter<bool>::toJSI(runtime, arg.failed));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "polls"), JSIConverter<std::optional<double>>::toJSI(runtime, arg.polls));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<margelo::nitro::espprovtoolkit::PTPhase>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "phase")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "start")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "duration")))) return false;
+      if (!JSIConverter<bool>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "failed")))) return false;
+      if (!JSIConverter<std::optional<double>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "polls")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
@@ -0,0 +1,117 @@
+///
+/// PTProvisionJob.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+// Forward declaration of `PTTransport` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { enum class PTTransport; }
+// Forward declaration of `PTSecurity` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { enum class PTSecurity; }
+
+#include <string>
+#include "PTTransport.hpp"
+#include "PTSecurity.hpp"
+#include <optional>
+
+namespace margelo::nitro::espprovtoolkit {
+
+  /**
+   * A struct which can be represented as a JavaScript object (PTProvisionJob).
+   */
+  struct PTProvisionJob final {
+  public:
+    std::string deviceName     SWIFT_PRIVATE;
+    PTTransport transport     SWIFT_PRIVATE;
+    PTSecurity security     SWIFT_PRIVATE;
+    std::optional<std::string> proofOfPossession     SWIFT_PRIVATE;
+    std::optional<std::string> softAPPassword     SWIFT_PRIVATE;
+    std::optional<std::string> username     SWIFT_PRIVATE;
+    std::string ssid     SWIFT_PRIVATE;
+    std::string passphrase     SWIFT_PRIVATE;
+
+  public:
+    PTProvisionJob() = default;
+    explicit PTProvisionJob(std::string deviceName, PTTransport transport, PTSecurity security, std::optional<std::string> proofOfPossession, std::optional<std::string> softAPPassword, std::optional<std::string> username, std::string ssid, std::string passphrase): deviceName(deviceName), transport(transport), security(security), proofOfPossession(proofOfPossession), softAPPassword(softAPPassword), username(username), ssid(ssid), passphrase(passphrase) {}
+
+  public:
+    friend bool operator==(const PTProvisionJob& lhs, const PTProvisionJob& rhs) = default;
+  };
+
+} // namespace margelo::nitro::espprovtoolkit
+
+namespace margelo::nitro {
+
+  // C++ PTProvisionJob <> JS PTProvisionJob (object)
+  template <>
+  struct JSIConverter<margelo::nitro::espprovtoolkit::PTProvisionJob> final {
+    static inline margelo::nitro::espprovtoolkit::PTProvisionJob fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::espprovtoolkit::PTProvisionJob(
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "deviceName"))),
+        JSIConverter<margelo::nitro::espprovtoolkit::PTTransport>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "transport"))),
+        JSIConverter<margelo::nitro::espprovtoolkit::PTSecurity>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "security"))),
+        JSIConverter<std::optional<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "proofOfPossession"))),
+        JSIConverter<std::optional<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "softAPPassword"))),
+        JSIConverter<std::optional<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "username"))),
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "ssid"))),
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "passphrase")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::espprovtoolkit::PTProvisionJob& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "deviceName"), JSIConverter<std::string>::toJSI(runtime, arg.deviceName));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "transport"), JSIConverter<margelo::nitro::espprovtoolkit::PTTransport>::toJSI(runtime, arg.transport));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "security"), JSIConverter<margelo::nitro::espprovtoolkit::PTSecurity>::toJSI(runtime, arg.security));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "proofOfPossession"), JSIConverter<std::optional<std::string>>::toJSI(runtime, arg.proofOfPossession));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "softAPPassword"), JSIConverter<std::optional<std::string>>::toJSI(runtime, arg.softAPPassword));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "username"), JSIConverter<std::optional<std::string>>::toJSI(runtime, arg.username));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "ssid"), JSIConverter<std::string>::toJSI(runtime, arg.ssid));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "passphrase"), JSIConverter<std::string>::toJSI(runtime, arg.passphrase));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "deviceName")))) return false;
+      if (!JSIConverter<margelo::nitro::espprovtoolkit::PTTransport>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "transport")))) return false;
+      if (!JSIConverter<margelo::nitro::espprovtoolkit::PTSecurity>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "security")))) return false;
+      if (!JSIConverter<std::optional<std::string>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "proofOfPossession")))) return false;
+      if (!JSIConverter<std::optional<std::string>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "softAPPassword")))) return false;
+      if (!JSIConverter<std::optional<std::string>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "username")))) return false;
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "ssid")))) return false;
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "passphrase")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
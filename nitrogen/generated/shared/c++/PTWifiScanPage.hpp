@@ -0,0 +1,98 @@
+///
+/// PTWifiScanPage.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+// Forward declaration of `PTWifiEntry` to properly resolve imports.
+namespace margelo::nitro::espprovtoolkit { struct PTWifiEntry; }
+
+#include "PTWifiEntry.hpp"
+#include <vector>
+#include <optional>
+
+namespace margelo::nitro::espprovtoolkit {
+
+  /**
+   * A struct which can be represented as a JavaScript object (PTWifiScanPage).
+   */
+  struct PTWifiScanPage final {
+  public:
+    bool success     SWIFT_PRIVATE;
+    std::optional<std::vector<PTWifiEntry>> networks     SWIFT_PRIVATE;
+    std::optional<double> resultCount     SWIFT_PRIVATE;
+    std::optional<double> error     SWIFT_PRIVATE;
+
+  public:
+    PTWifiScanPage() = default;
+    explicit PTWifiScanPage(bool success, std::optional<std::vector<PTWifiEntry>> networks, std::optional<double> resultCount, std::optional<double> error): success(success), networks(networks), resultCount(resultCount), error(error) {}
+
+  public:
+    friend bool operator==(const PTWifiScanPage& lhs, const PTWifiScanPage& rhs) = default;
+  };
+
+} // namespace margelo::nitro::espprovtoolkit
+
+namespace margelo::nitro {
+
+  // C++ PTWifiScanPage <> JS PTWifiScanPage (object)
+  template <>
+  struct JSIConverter<margelo::nitro::espprovtoolkit::PTWifiScanPage> final {
+    static inline margelo::nitro::espprovtoolkit::PTWifiScanPage fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::espprovtoolkit::PTWifiScanPage(
+        JSIConverter<bool>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "success"))),
+        JSIConverter<std::optional<std::vector<margelo::nitro::espprovtoolkit::PTWifiEntry>>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "networks"))),
+        JSIConverter<std::optional<double>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "resultCount"))),
+        JSIConverter<std::optional<double>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "error")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::espprovtoolkit::PTWifiScanPage& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "success"), JSIConverter<bool>::toJSI(runtime, arg.success));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "networks"), JSIConverter<std::optional<std::vector<margelo::nitro::espprovtoolkit::PTWifiEntry>>>::toJSI(runtime, arg.networks));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "resultCount"), JSIConverter<std::optional<double>>::toJSI(runtime, arg.resultCount));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "error"), JSIConverter<std::optional<double>>::toJSI(runtime, arg.error));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<bool>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "success")))) return false;
+      if (!JSIConverter<std::optional<std::vector<margelo::nitro::espprovtoolkit::PTWifiEntry>>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "networks")))) return false;
+      if (!JSIConverter<std::optional<double>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "resultCount")))) return false;
+      if (!JSIConverter<std::optional<double>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "error")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
@@ -0,0 +1,256 @@
+import type { HybridObject } from 'react-native-nitro-modules';
+import type {
+  PTTransport,
+  PTSecurity,
+  PTResult,
+  PTWifiScanResult,
+  PTWifiScanPage,
+  PTWifiScanColumns,
+  PTSessionResult,
+  PTProvisionResult,
+  PTStringResult,
+  PTDataResult,
+  PTBooleanResult,
+  PTConnectionState,
+  PTConnectionTransition,
+  PTPhase,
+  PTPhaseSpan,
+  PTMetricsSnapshot,
+  PTProvisionJob,
+  PTBatchOptions,
+  PTDeviceProvisionResult,
+} from './EspProvToolkit.types';
+
+/**
+ * The shared C++ protocomm engine. It runs the session handshake, the
+ * wifi_scan/wifi_config protocol and custom endpoints itself, and only uses
+ * the platform (`EspProvToolkit.sendRawDataToESPDevice`) as a byte pipe.
+ */
+export interface EspProvEngine
+  extends HybridObject<{ ios: 'c++'; android: 'c++' }> {
+  /**
+   * Registers a device created through `EspProvToolkit` with the engine.
+   * Returns `false` if the engine cannot handle it (e.g. an unsupported
+   * security scheme), in which case the platform implementation is used.
+   */
+  configureESPDevice(
+    deviceName: string,
+    transport: PTTransport,
+    security: PTSecurity,
+    proofOfPossession?: string,
+    username?: string
+  ): boolean;
+
+  /**
+   * `operationId`, on this and the other device calls, registers the call for
+   * `cancelESPOperation` until it settles.
+   */
+  connectToESPDevice(
+    deviceName: string,
+    operationId?: number
+  ): Promise<PTSessionResult>;
+
+  disconnectFromESPDevice(deviceName: string): PTResult;
+
+  /**
+   * Drops a device and closes its link and session. Returns false if it
+   * was not known.
+   */
+  releaseESPDevice(deviceName: string): boolean;
+
+  /**
+   * Drops every device, see `releaseESPDevice`.
+   */
+  purgeESPDevices(): void;
+
+  /**
+   * Bounds the device store. Devices idle for longer than `idleTimeoutMs`
+   * and the least recently used ones beyond `maxDevices` are released.
+   * A device whose session is `SECURED` is only released to stay within
+   * `maxDevices`. Defaults to 64 devices and 10 minutes.
+   */
+  setDeviceRegistryLimits(maxDevices: number, idleTimeoutMs: number): void;
+
+  /**
+   * Calls `listener` with every device the registry limits released, but
+   * not with the ones released explicitly. Returns an id for
+   * `removeDeviceEvictionListener`.
+   */
+  addDeviceEvictionListener(listener: (deviceName: string) => void): number;
+  removeDeviceEvictionListener(id: number): boolean;
+
+  /**
+   * Bounds the BLE sessions open at once. Connects beyond `maxLinks` wait for
+   * a free link, and linked devices take turns for at most `maxExchanges`
+   * messages in flight, first come, first served. Defaults to 4 and 2.
+   */
+  setSessionLimits(maxLinks: number, maxExchanges: number): void;
+
+  isESPDeviceSessionEstablished(deviceName: string): PTBooleanResult;
+
+  /**
+   * The native connection state of a device, fed by the engine and by the
+   * platform's transport events. `IDLE` for devices never connected.
+   */
+  getConnectionStateOfESPDevice(deviceName: string): PTConnectionState;
+
+  /**
+   * Calls `listener` on every connection state transition of any device.
+   * Returns an id for `removeConnectionStateListener`.
+   */
+  addConnectionStateListener(
+    listener: (transition: PTConnectionTransition) => void
+  ): number;
+  removeConnectionStateListener(id: number): boolean;
+
+  /**
+   * The phases of the device's current run, in phase order. A phase starts
+   * the run over from itself, so spans of later phases from an earlier
+   * attempt are dropped. Empty for devices the engine does not run.
+   */
+  getRunTimingsOfESPDevice(deviceName: string): PTPhaseSpan[];
+
+  /**
+   * Adds a phase the caller timed, such as `SEARCH` or `CREATE`. `start` is
+   * in milliseconds since the epoch.
+   */
+  recordPhaseOfESPDevice(
+    deviceName: string,
+    phase: PTPhase,
+    start: number,
+    duration: number,
+    failed: boolean
+  ): void;
+
+  /**
+   * Percentiles of every phase and custom endpoint, and the count of every
+   * error code, since the start or the last reset. With `reset` the counts
+   * start over, without losing values recorded meanwhile.
+   */
+  getMetricsSnapshot(reset: boolean): PTMetricsSnapshot;
+  resetMetrics(): void;
+  /**
+   * Counts a `PTError` reported to the app.
+   */
+  countError(error: number): void;
+
+  /**
+   * Starts recording native trace events, dropping earlier ones. The buffer
+   * keeps the most recent 16384 events.
+   */
+  startTracing(): void;
+  stopTracing(): void;
+  /**
+   * The events recorded since `startTracing` as Chrome trace event JSON, which
+   * opens in Perfetto (ui.perfetto.dev) and chrome://tracing.
+   */
+  exportTrace(): string;
+
+  /**
+   * How long a device's scan result is served from the native cache.
+   * Zero turns the cache off. Defaults to 30 seconds.
+   */
+  setWifiScanCacheTTL(ttlMs: number): void;
+
+  /**
+   * Resolves with the networks merged by BSSID, keeping the strongest RSSI.
+   * Unless `forceRefresh` is set, a result younger than the cache TTL is
+   * returned right away without scanning again.
+   */
+  scanWifiListOfESPDevice(
+    deviceName: string,
+    forceRefresh?: boolean,
+    operationId?: number
+  ): Promise<PTWifiScanResult>;
+
+  /**
+   * The same result as `scanWifiListOfESPDevice`, packed into parallel
+   * columns of one ArrayBuffer (see `WifiScanColumnLayout` in
+   * `cpp/core/WifiScanColumns.hpp`) so it crosses the bridge as one value.
+   */
+  scanWifiColumnsOfESPDevice(
+    deviceName: string,
+    forceRefresh?: boolean,
+    operationId?: number
+  ): Promise<PTWifiScanColumns>;
+
+  /**
+   * Runs a Wi-Fi scan and resolves with the total `resultCount` and the
+   * first `pageSize` networks. Later pages come from
+   * `fetchWifiScanPageOfESPDevice` while the caller renders the first one.
+   * Unless `forceRefresh` is set, a cached result is paged instead.
+   */
+  startWifiScanOfESPDevice(
+    deviceName: string,
+    pageSize: number,
+    forceRefresh?: boolean,
+    operationId?: number
+  ): Promise<PTWifiScanPage>;
+
+  /**
+   * Reads up to `count` networks of the last scan, starting at `startIndex`.
+   * Resolves with an empty page past the end of the results.
+   */
+  fetchWifiScanPageOfESPDevice(
+    deviceName: string,
+    startIndex: number,
+    count: number,
+    operationId?: number
+  ): Promise<PTWifiScanPage>;
+
+  /**
+   * When provisioning polls the device's Wi-Fi status after applying the
+   * config: `firstMs` after applying, then each delay `backoff` times the
+   * previous one up to `maxMs`, until `deadlineMs` ran out. A poll that
+   * reports the device connected or failed ends the wait at once. Defaults to
+   * 100 ms, 2, 500 ms and 30 seconds.
+   */
+  setStatusPollSchedule(
+    firstMs: number,
+    backoff: number,
+    maxMs: number,
+    deadlineMs: number
+  ): void;
+
+  provisionESPDevice(
+    deviceName: string,
+    ssid: string,
+    password: string,
+    operationId?: number
+  ): Promise<PTProvisionResult>;
+
+  sendDataToESPDevice(
+    deviceName: string,
+    path: string,
+    data: string,
+    operationId?: number
+  ): Promise<PTStringResult>;
+  sendBinaryDataToESPDevice(
+    deviceName: string,
+    path: string,
+    data: ArrayBuffer,
+    operationId?: number
+  ): Promise<PTDataResult>;
+
+  /**
+   * Cancels the running call registered under `operationId`. The device's
+   * link is aborted and its session closed, and the call resolves with
+   * `OPERATION_CANCELLED` as soon as the transport gives up. Returns false
+   * if no such call is running.
+   */
+  cancelESPOperation(operationId: number): boolean;
+
+  /**
+   * Creates, connects and provisions every job's device, running at most
+   * `options.concurrency` (clamped to 1 to 16) of them at once, but only one
+   * SoftAP job at a time. Resolves with one result per job, in job order,
+   * once all of them finished. Cancelling `operationId` or passing
+   * `options.timeoutMs` stops the batch: running jobs are aborted and the
+   * pending ones fail without starting.
+   */
+  provisionESPDevices(
+    jobs: PTProvisionJob[],
+    options?: PTBatchOptions,
+    operationId?: number
+  ): Promise<PTDeviceProvisionResult[]>;
+}
@@ -8,6 +8,7 @@ import type {
   PTSessionResult,
   PTProvisionResult,
   PTStringResult,
+  PTDataResult,
   PTBooleanResult,
   PTLocationAccess,
   PTDeviceResult,
@@ -24,6 +25,25 @@ export interface EspProvToolkit
 
   stopSearchingForESPDevices(): void;
 
+  /**
+   * Starts a streaming scan. Every matching device is stored as soon as it is
+   * first seen and handed out by `nextDiscoveredESPDevices`. Ends on
+   * `stopSearchingForESPDevices` or when the scan window closes, after
+   * `scanTimeoutMs` or else the platform's default window.
+   */
+  startDiscoveringESPDevices(
+    devicePrefix: string,
+    transport: PTTransport,
+    security: PTSecurity,
+    scanTimeoutMs?: number
+  ): PTResult;
+
+  /**
+   * Resolves with the devices found since the previous call, waiting until
+   * there is at least one. An empty `deviceNames` means discovery has ended.
+   */
+  nextDiscoveredESPDevices(): Promise<PTSearchResult>;
+
   createESPDevice(
     deviceName: string,
     transport: PTTransport,
@@ -43,6 +63,25 @@ export interface EspProvToolkit
 
   disconnectFromESPDevice(deviceName: string): PTResult;
 
+  /**
+   * Drops a device and closes its link and session. Returns false if it
+   * was not known.
+   */
+  releaseESPDevice(deviceName: string): boolean;
+
+  /**
+   * Drops every device, see `releaseESPDevice`.
+   */
+  purgeESPDevices(): void;
+
+  /**
+   * Bounds the device store. Devices idle for longer than `idleTimeoutMs`
+   * and the least recently used ones beyond `maxDevices` are released.
+   * A device whose session is `SECURED` is only released to stay within
+   * `maxDevices`. Defaults to 64 devices and 10 minutes.
+   */
+  setDeviceRegistryLimits(maxDevices: number, idleTimeoutMs: number): void;
+
   provisionESPDevice(
     deviceName: string,
     ssid: string,
@@ -57,6 +96,26 @@ export interface EspProvToolkit
     data: string
   ): Promise<PTStringResult>;
 
+  /**
+   * Binary variant of `sendDataToESPDevice`: the payload and the reply are
+   * passed as `ArrayBuffer`s instead of base64 strings.
+   */
+  sendBinaryDataToESPDevice(
+    deviceName: string,
+    path: string,
+    data: ArrayBuffer
+  ): Promise<PTDataResult>;
+
+  /**
+   * Raw transport for the native protocomm engine: sends `data` to `path` as is,
+   * without the SDK session or its encryption, and returns the raw reply.
+   */
+  sendRawDataToESPDevice(
+    deviceName: string,
+    path: string,
+    data: ArrayBuffer
+  ): Promise<PTDataResult>;
+
   getIPv4AddressOfESPDevice(deviceName: string): PTStringResult;
 
   getCurrentNetworkSSID(): Promise<PTStringResult>;
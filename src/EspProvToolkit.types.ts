@@ -83,7 +83,8 @@ export enum PTError {
   // General Errors
   ESP_NATIVE_UNKNOWN_ERROR = 4,
   ESP_INSUFFICIENT_PERMISSIONS = 47,
-  BLE_ADAPTER_NOT_AVAILABLE = 48, // last
+  BLE_ADAPTER_NOT_AVAILABLE = 48,
+  OPERATION_CANCELLED = 49, // last
 }
 
 // Return Interfaces
@@ -93,6 +94,92 @@ export enum PTSessionStatus {
   DISCONNECTED,
 }
 
+// Values match espprov::ConnectionState in cpp/core/ConnectionStateMachine.hpp
+export enum PTConnectionState {
+  IDLE,
+  CONNECTING,
+  SECURING,
+  SECURED,
+  LOST,
+}
+
+export enum PTConnectionEvent {
+  CONNECT_REQUESTED,
+  LINK_UP,
+  LINK_FAILED,
+  LINK_DOWN,
+  SESSION_ESTABLISHED,
+  SESSION_FAILED,
+  DISCONNECT_REQUESTED,
+  TIMEOUT,
+}
+
+export interface PTConnectionTransition {
+  deviceName: string;
+  from: PTConnectionState;
+  to: PTConnectionState;
+  event: PTConnectionEvent;
+  // Counts the connect attempts of the device, starting at 1
+  attempt: number;
+  // The PTError that ended the attempt, on transitions to LOST
+  error?: number;
+  // Milliseconds since the epoch
+  timestamp: number;
+}
+
+// Values match espprov::Phase in cpp/core/RunTimings.hpp
+export enum PTPhase {
+  SEARCH,
+  CREATE,
+  CONNECT,
+  VERSION_INFO,
+  HANDSHAKE,
+  SCAN,
+  CONFIG_SEND,
+  APPLY,
+  STATUS_WAIT,
+}
+
+export interface PTPhaseSpan {
+  phase: PTPhase;
+  // Milliseconds since the epoch
+  start: number;
+  // Milliseconds
+  duration: number;
+  // The phase ended with an error
+  failed: boolean;
+  // STATUS_WAIT of engine devices: how many times the Wi-Fi status was polled
+  polls?: number;
+}
+
+// Latencies of one phase or custom endpoint, in milliseconds. Percentiles
+// are at most 3.1% above the true value.
+export interface PTLatencySummary {
+  // The PTPhase name, or the endpoint path
+  name: string;
+  count: number;
+  minMs: number;
+  meanMs: number;
+  p50Ms: number;
+  p90Ms: number;
+  p95Ms: number;
+  p99Ms: number;
+  maxMs: number;
+}
+
+export interface PTErrorCount {
+  error: number;
+  count: number;
+}
+
+export interface PTMetricsSnapshot {
+  // When counting started, in milliseconds since the epoch
+  since: number;
+  phases: PTLatencySummary[];
+  endpoints: PTLatencySummary[];
+  errors: PTErrorCount[];
+}
+
 export enum PTLocationAccess {
   GRANTED,
   DENIED,
@@ -127,6 +214,39 @@ export interface PTStringResult {
   error?: number;
 }
 
+export interface PTDataResult {
+  success: boolean;
+  data?: ArrayBuffer;
+  error?: number;
+}
+
+export interface PTProvisionJob {
+  deviceName: string;
+  transport: PTTransport;
+  security: PTSecurity;
+  proofOfPossession?: string;
+  softAPPassword?: string;
+  username?: string;
+  ssid: string;
+  passphrase: string;
+}
+
+export interface PTBatchOptions {
+  // How many devices are provisioned at the same time (default 3)
+  concurrency?: number;
+  // Once passed, running jobs are cut short and the ones left fail with
+  // PROV_TIMED_OUT_ERROR
+  timeoutMs?: number;
+}
+
+export interface PTDeviceProvisionResult {
+  deviceName: string;
+  success: boolean;
+  error?: number;
+  // The phases the run went through, in phase order
+  timings?: PTPhaseSpan[];
+}
+
 export interface PTBooleanResult {
   success: boolean;
   result?: boolean;
@@ -138,3 +258,47 @@ export interface PTWifiScanResult {
   networks?: PTWifiEntry[];
   error?: number;
 }
+
+export interface PTWifiScanColumns {
+  success: boolean;
+  count?: number;
+  // The packed columns, unpacked by `scanWifiColumnsOfESPDevice`
+  columns?: ArrayBuffer;
+  error?: number;
+}
+
+// A scan as parallel typed arrays, network `i` being index `i` of each
+export interface PTWifiColumns {
+  count: number;
+  // The 48-bit BSSID as an integer, -1 if the device sent none
+  bssid: Float64Array;
+  // Network i's SSID is ssidBytes[ssidOffsets[i]..ssidOffsets[i + 1]], UTF-8
+  ssidOffsets: Uint32Array;
+  ssidBytes: Uint8Array;
+  channel: Uint16Array;
+  rssi: Int8Array;
+  auth: Uint8Array;
+}
+
+// Stops a device call early. Either way the native operation is torn down
+// and the call rejects, with OPERATION_CANCELLED once `signal` aborts and
+// PROV_TIMED_OUT_ERROR once `timeoutMs` passed
+export interface PTCallOptions {
+  signal?: AbortSignal;
+  timeoutMs?: number;
+}
+
+// How long `discoverESPDevices` scans for BLE devices. Without `scanTimeoutMs`
+// the platform's default window applies, 5 seconds on iOS and the SDK's
+// scan window on Android
+export interface PTDiscoveryOptions {
+  scanTimeoutMs?: number;
+}
+
+export interface PTWifiScanPage {
+  success: boolean;
+  networks?: PTWifiEntry[];
+  // How many networks the scan found in total
+  resultCount?: number;
+  error?: number;
+}
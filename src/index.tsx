@@ -1,42 +1,321 @@
 import { NitroModules } from 'react-native-nitro-modules';
 import type { EspProvToolkit } from './EspProvToolkit.nitro';
+import type { EspProvEngine } from './EspProvEngine.nitro';
 import {
   PTSecurity,
   PTTransport,
   PTSessionStatus,
   PTError,
   PTLocationAccess,
+  PTConnectionState,
+  PTConnectionEvent,
+  PTPhase,
+} from './EspProvToolkit.types';
+import type {
+  PTBatchOptions,
+  PTCallOptions,
+  PTConnectionTransition,
+  PTDevice,
+  PTDeviceProvisionResult,
+  PTDiscoveryOptions,
+  PTErrorCount,
+  PTLatencySummary,
+  PTMetricsSnapshot,
+  PTPhaseSpan,
+  PTProvisionJob,
+  PTWifiColumns,
+  PTWifiEntry,
 } from './EspProvToolkit.types';
-import type { PTDevice, PTWifiEntry } from './EspProvToolkit.types';
 import { PTException } from './utils';
+import { columnsFromBuffer, columnsFromEntries } from './wifiColumns';
 import { useLocationPermissions } from './hooks/useLocationPermissions';
 
 const EspProvToolkitHybridObject =
   NitroModules.createHybridObject<EspProvToolkit>('EspProvToolkit');
 
+const EspProvEngineHybridObject =
+  NitroModules.createHybridObject<EspProvEngine>('EspProvEngine');
+
+// Devices whose protocol runs in the shared C++ engine.
+// The platform only moves raw bytes for them.
+const engineDevices = new Set<string>();
+let nativeProtocommEnabled = true;
+// Ids of engine calls `cancelESPOperation` can cancel
+let nextOperationId = 1;
+
+// The engine's registry limits drop devices on their own. Its platform entry,
+// which only carried the raw link, and the routing go with them.
+EspProvEngineHybridObject.addDeviceEvictionListener((deviceName) => {
+  if (engineDevices.delete(deviceName)) {
+    EspProvToolkitHybridObject.releaseESPDevice(deviceName);
+  }
+});
+
+/**
+ * Toggles the shared C++ protocomm engine. When disabled, every call goes
+ * through the Espressif SDKs again. Only affects devices created afterwards.
+ */
+export function setNativeProtocommEnabled(enabled: boolean): void {
+  nativeProtocommEnabled = enabled;
+  if (!enabled) {
+    engineDevices.clear();
+  }
+}
+
+function registerWithEngine(
+  deviceName: string,
+  transport: PTTransport,
+  security: PTSecurity,
+  proofOfPossession?: string,
+  username?: string
+): void {
+  const handled =
+    nativeProtocommEnabled &&
+    EspProvEngineHybridObject.configureESPDevice(
+      deviceName,
+      transport,
+      security,
+      proofOfPossession,
+      username
+    );
+  if (handled) {
+    engineDevices.add(deviceName);
+  } else {
+    engineDevices.delete(deviceName);
+  }
+}
+
+/**
+ * Adds a phase that ran on the platform, from `start` until now, to the
+ * run timings of the engine devices among `deviceNames`.
+ */
+function recordPhase(
+  deviceNames: string[],
+  phase: PTPhase,
+  start: number,
+  failed = false
+): void {
+  const duration = Date.now() - start;
+  for (const deviceName of deviceNames) {
+    if (engineDevices.has(deviceName)) {
+      EspProvEngineHybridObject.recordPhaseOfESPDevice(
+        deviceName,
+        phase,
+        start,
+        duration,
+        failed
+      );
+    }
+  }
+}
+
+function backendFor(deviceName: string): EspProvToolkit | EspProvEngine {
+  return engineDevices.has(deviceName)
+    ? EspProvEngineHybridObject
+    : EspProvToolkitHybridObject;
+}
+
+/**
+ * Counts an error in the native metrics and wraps it for throwing. Every
+ * error the app sees passes through here exactly once.
+ */
+function failure(error: number): PTException {
+  EspProvEngineHybridObject.countError(error);
+  return new PTException(error as PTError);
+}
+
 async function handleError<T>(
   promise: Promise<{ success: boolean; error?: number } & T>
 ): Promise<T> {
   const result = await promise;
   if (!result.success && result.error) {
-    throw new PTException(result.error as PTError);
+    throw failure(result.error);
   }
   return result as T;
 }
 
+/**
+ * Races a native call against `options`. Once the signal aborts or the
+ * timeout passes, `cancel` tears the native operation down and the returned
+ * promise rejects right away; the call's own late result is dropped.
+ */
+function cancellable<T>(
+  options: PTCallOptions | undefined,
+  call: () => Promise<T>,
+  cancel: () => void
+): Promise<T> {
+  const signal = options?.signal;
+  const timeoutMs = options?.timeoutMs;
+  if (!signal && timeoutMs === undefined) {
+    return call();
+  }
+  if (signal?.aborted) {
+    return Promise.reject(failure(PTError.OPERATION_CANCELLED));
+  }
+  const pending = call();
+  return new Promise<T>((resolve, reject) => {
+    let timer: ReturnType<typeof setTimeout> | undefined;
+    let settled = false;
+    const settle = () => {
+      settled = true;
+      clearTimeout(timer);
+      signal?.removeEventListener('abort', onAbort);
+    };
+    const stop = (error: PTError) => {
+      if (settled) {
+        return;
+      }
+      settle();
+      cancel();
+      reject(failure(error));
+    };
+    const onAbort = () => stop(PTError.OPERATION_CANCELLED);
+    signal?.addEventListener('abort', onAbort);
+    if (timeoutMs !== undefined) {
+      timer = setTimeout(
+        () => stop(PTError.PROV_TIMED_OUT_ERROR),
+        Math.max(timeoutMs, 0)
+      );
+    }
+    pending.then(
+      (value) => {
+        if (!settled) {
+          settle();
+          resolve(value);
+        }
+      },
+      (error) => {
+        if (!settled) {
+          settle();
+          reject(error);
+        }
+      }
+    );
+  });
+}
+
+/**
+ * Runs an engine call under `options`. The call is registered under a fresh
+ * operation id, and cancelling it aborts the device's link natively.
+ */
+function engineCall<T>(
+  options: PTCallOptions | undefined,
+  call: (operationId?: number) => Promise<T>
+): Promise<T> {
+  if (!options?.signal && options?.timeoutMs === undefined) {
+    return call();
+  }
+  const operationId = nextOperationId++;
+  return cancellable(
+    options,
+    () => call(operationId),
+    () => EspProvEngineHybridObject.cancelESPOperation(operationId)
+  );
+}
+
+/**
+ * Runs a call on the device's backend under `options`. The platform SDKs
+ * have no cancel, so their device is disconnected instead, which frees the
+ * radio all the same.
+ */
+function deviceCall<T>(
+  deviceName: string,
+  options: PTCallOptions | undefined,
+  onEngine: (operationId?: number) => Promise<T>,
+  onToolkit: () => Promise<T>
+): Promise<T> {
+  if (engineDevices.has(deviceName)) {
+    return engineCall(options, onEngine);
+  }
+  return cancellable(options, onToolkit, () =>
+    EspProvToolkitHybridObject.disconnectFromESPDevice(deviceName)
+  );
+}
+
+/**
+ * Searches for devices whose name starts with `devicePrefix`. Aborting
+ * `options.signal` or passing `options.timeoutMs` stops the search, see
+ * `PTCallOptions`.
+ */
 export async function searchForESPDevices(
   devicePrefix: string,
   transport: PTTransport,
-  security: PTSecurity
+  security: PTSecurity,
+  options?: PTCallOptions
 ): Promise<string[]> {
+  const start = Date.now();
   const result = await handleError(
-    EspProvToolkitHybridObject.searchForESPDevices(
-      devicePrefix,
-      transport,
-      security
+    cancellable(
+      options,
+      () =>
+        EspProvToolkitHybridObject.searchForESPDevices(
+          devicePrefix,
+          transport,
+          security
+        ),
+      () => EspProvToolkitHybridObject.stopSearchingForESPDevices()
     )
   );
-  return result.deviceNames || [];
+  const deviceNames = result.deviceNames || [];
+  for (const deviceName of deviceNames) {
+    registerWithEngine(deviceName, transport, security);
+  }
+  recordPhase(deviceNames, PTPhase.SEARCH, start);
+  return deviceNames;
+}
+
+/**
+ * Streams matching devices as soon as they are first seen, instead of waiting
+ * for the whole scan window like `searchForESPDevices`. Devices are only
+ * fetched from native while the loop asks for more, and leaving the loop
+ * (or `stopSearchingForESPDevices()`) stops the scan. The scan window lasts
+ * `options.scanTimeoutMs`, or the platform's default.
+ *
+ * ```ts
+ * for await (const deviceName of discoverESPDevices('PROV_', t, s)) {
+ *   if (isTheOne(deviceName)) break;
+ * }
+ * ```
+ */
+export async function* discoverESPDevices(
+  devicePrefix: string,
+  transport: PTTransport,
+  security: PTSecurity,
+  options?: PTDiscoveryOptions
+): AsyncGenerator<string, void, undefined> {
+  const start = Date.now();
+  const started = EspProvToolkitHybridObject.startDiscoveringESPDevices(
+    devicePrefix,
+    transport,
+    security,
+    options?.scanTimeoutMs
+  );
+  if (!started.success && started.error) {
+    throw failure(started.error);
+  }
+  let ended = false;
+  try {
+    while (true) {
+      const result = await handleError(
+        EspProvToolkitHybridObject.nextDiscoveredESPDevices()
+      );
+      const deviceNames = result.deviceNames || [];
+      if (deviceNames.length === 0) {
+        ended = true;
+        return;
+      }
+      for (const deviceName of deviceNames) {
+        registerWithEngine(deviceName, transport, security);
+        // The search phase of a streamed device ends when it is first seen
+        recordPhase([deviceName], PTPhase.SEARCH, start);
+        yield deviceName;
+      }
+    }
+  } finally {
+    if (!ended) {
+      EspProvToolkitHybridObject.stopSearchingForESPDevices();
+    }
+  }
 }
 
 export function stopSearchingForESPDevices(): void {
@@ -51,16 +330,30 @@ export async function createESPDevice(
   softAPPassword?: string,
   username?: string
 ): Promise<void> {
-  await handleError(
-    EspProvToolkitHybridObject.createESPDevice(
-      deviceName,
-      transport,
-      security,
-      proofOfPossession,
-      softAPPassword,
-      username
-    )
+  const start = Date.now();
+  try {
+    await handleError(
+      EspProvToolkitHybridObject.createESPDevice(
+        deviceName,
+        transport,
+        security,
+        proofOfPossession,
+        softAPPassword,
+        username
+      )
+    );
+  } catch (e) {
+    recordPhase([deviceName], PTPhase.CREATE, start, true);
+    throw e;
+  }
+  registerWithEngine(
+    deviceName,
+    transport,
+    security,
+    proofOfPossession,
+    username
   );
+  recordPhase([deviceName], PTPhase.CREATE, start);
 }
 
 export function doesESPDeviceExist(deviceName: string): boolean {
@@ -76,68 +369,587 @@ export function getESPDevice(deviceName: string): PTDevice | undefined {
   }
 }
 
+/**
+ * Scans for the networks the device sees. Engine devices cache the result
+ * per device (see `setWifiScanCacheTTL`) and merge it by BSSID, so calling
+ * this again on every screen re-entry does not rescan unless `forceRefresh`
+ * is set.
+ */
 export async function scanWifiListOfESPDevice(
-  deviceName: string
+  deviceName: string,
+  forceRefresh: boolean = false,
+  options?: PTCallOptions
 ): Promise<PTWifiEntry[]> {
   const result = await handleError(
-    EspProvToolkitHybridObject.scanWifiListOfESPDevice(deviceName)
+    deviceCall(
+      deviceName,
+      options,
+      (operationId) =>
+        EspProvEngineHybridObject.scanWifiListOfESPDevice(
+          deviceName,
+          forceRefresh,
+          operationId
+        ),
+      () => EspProvToolkitHybridObject.scanWifiListOfESPDevice(deviceName)
+    )
   );
   return result.networks || [];
 }
 
+/**
+ * Same scan as `scanWifiListOfESPDevice`, returned as parallel typed arrays
+ * instead of one object per network. Engine devices hand the whole result
+ * over as a single ArrayBuffer, which keeps long lists cheap to cross into
+ * JS and to sort or filter. Decode SSIDs lazily with `getWifiColumnsSsid`.
+ */
+export async function scanWifiColumnsOfESPDevice(
+  deviceName: string,
+  forceRefresh: boolean = false,
+  options?: PTCallOptions
+): Promise<PTWifiColumns> {
+  if (!engineDevices.has(deviceName)) {
+    return columnsFromEntries(
+      await scanWifiListOfESPDevice(deviceName, forceRefresh, options)
+    );
+  }
+  const result = await handleError(
+    engineCall(options, (operationId) =>
+      EspProvEngineHybridObject.scanWifiColumnsOfESPDevice(
+        deviceName,
+        forceRefresh,
+        operationId
+      )
+    )
+  );
+  if (!result.columns) {
+    return columnsFromEntries([]);
+  }
+  return columnsFromBuffer(result.count ?? 0, result.columns);
+}
+
+/**
+ * How long scan results stay cached per device. Zero turns the cache off.
+ * Defaults to 30 seconds.
+ */
+export function setWifiScanCacheTTL(ttlMs: number): void {
+  EspProvEngineHybridObject.setWifiScanCacheTTL(ttlMs);
+}
+
+/**
+ * Streams the scan results page by page as they arrive from the device, so a
+ * network picker can render the first access points while later pages are
+ * still being fetched. The next page is requested before the current one is
+ * yielded. A cached scan is paged without touching the radio unless
+ * `forceRefresh` is set. Devices handled by the Espressif SDKs, which only
+ * return the whole list, yield it as a single page. `options.signal` ends the
+ * stream wherever it is, and `options.timeoutMs` bounds the scan and all of
+ * its pages together, see `PTCallOptions`.
+ *
+ * ```ts
+ * for await (const page of streamWifiListOfESPDevice(deviceName)) {
+ *   setNetworks((networks) => [...networks, ...page]);
+ * }
+ * ```
+ */
+export async function* streamWifiListOfESPDevice(
+  deviceName: string,
+  pageSize: number = 4,
+  forceRefresh: boolean = false,
+  options?: PTCallOptions
+): AsyncGenerator<PTWifiEntry[], void, undefined> {
+  if (!engineDevices.has(deviceName)) {
+    yield await scanWifiListOfESPDevice(deviceName, forceRefresh, options);
+    return;
+  }
+  // Each call gets what is left of the stream's deadline
+  const deadline =
+    options?.timeoutMs !== undefined
+      ? Date.now() + options.timeoutMs
+      : undefined;
+  const remaining = (): PTCallOptions | undefined =>
+    options && {
+      signal: options.signal,
+      timeoutMs: deadline !== undefined ? deadline - Date.now() : undefined,
+    };
+  const first = await handleError(
+    engineCall(remaining(), (operationId) =>
+      EspProvEngineHybridObject.startWifiScanOfESPDevice(
+        deviceName,
+        pageSize,
+        forceRefresh,
+        operationId
+      )
+    )
+  );
+  const resultCount = first.resultCount ?? 0;
+  let page = first.networks || [];
+  let index = page.length;
+  while (page.length > 0) {
+    const next =
+      index < resultCount
+        ? handleError(
+            engineCall(remaining(), (operationId) =>
+              EspProvEngineHybridObject.fetchWifiScanPageOfESPDevice(
+                deviceName,
+                index,
+                pageSize,
+                operationId
+              )
+            )
+          )
+        : undefined;
+    // Keeps an abandoned prefetch from surfacing as an unhandled rejection
+    next?.catch(() => {});
+    yield page;
+    page = next ? (await next).networks || [] : [];
+    index += page.length;
+  }
+}
+
+/**
+ * Opens the device's session. With `options`, an abandoned connect gives
+ * up the BLE link or SoftAP session right away, see `PTCallOptions`.
+ */
 export async function connectToESPDevice(
-  deviceName: string
+  deviceName: string,
+  options?: PTCallOptions
 ): Promise<PTSessionStatus> {
   const result = await handleError(
-    EspProvToolkitHybridObject.connectToESPDevice(deviceName)
+    deviceCall(
+      deviceName,
+      options,
+      (operationId) =>
+        EspProvEngineHybridObject.connectToESPDevice(deviceName, operationId),
+      () => EspProvToolkitHybridObject.connectToESPDevice(deviceName)
+    )
   );
   return result.status!;
 }
 
 export function disconnectFromESPDevice(deviceName: string): void {
-  const result = EspProvToolkitHybridObject.disconnectFromESPDevice(deviceName);
+  const result = backendFor(deviceName).disconnectFromESPDevice(deviceName);
   if (!result.success && result.error) {
-    throw new PTException(result.error);
+    throw failure(result.error);
   }
 }
 
+/**
+ * Forgets a device and closes its link, session and keys. Returns false if
+ * the device was not known.
+ */
+export function releaseESPDevice(deviceName: string): boolean {
+  const inEngine = EspProvEngineHybridObject.releaseESPDevice(deviceName);
+  const inToolkit = EspProvToolkitHybridObject.releaseESPDevice(deviceName);
+  engineDevices.delete(deviceName);
+  return inEngine || inToolkit;
+}
+
+/**
+ * Forgets every device, see `releaseESPDevice`.
+ */
+export function purgeESPDevices(): void {
+  EspProvEngineHybridObject.purgeESPDevices();
+  EspProvToolkitHybridObject.purgeESPDevices();
+  engineDevices.clear();
+}
+
+/**
+ * Bounds the device store. Devices idle for longer than `idleTimeoutMs` and
+ * the least recently used ones beyond `maxDevices` are released
+ * automatically. A device with a `SECURED` session is only released to stay
+ * within `maxDevices`. Defaults to 64 devices and 10 minutes.
+ */
+export function setDeviceRegistryLimits(limits: {
+  maxDevices: number;
+  idleTimeoutMs: number;
+}): void {
+  EspProvEngineHybridObject.setDeviceRegistryLimits(
+    limits.maxDevices,
+    limits.idleTimeoutMs
+  );
+  EspProvToolkitHybridObject.setDeviceRegistryLimits(
+    limits.maxDevices,
+    limits.idleTimeoutMs
+  );
+}
+
+/**
+ * Bounds the BLE sessions of engine devices open at once. Connects beyond
+ * `maxLinks` wait for another device to disconnect, and linked devices take
+ * turns for at most `maxExchanges` messages in flight, so several devices
+ * can be provisioned in parallel. Defaults to 4 links and 2 exchanges.
+ */
+export function setSessionLimits(limits: {
+  maxLinks: number;
+  maxExchanges: number;
+}): void {
+  EspProvEngineHybridObject.setSessionLimits(
+    limits.maxLinks,
+    limits.maxExchanges
+  );
+}
+
+/**
+ * When provisioning engine devices polls their Wi-Fi status after applying
+ * the config: quickly at first, then backing off up to `maxMs`, until
+ * `deadlineMs`. The wait ends with the first poll that reports the device
+ * connected or failed, and the STATUS_WAIT phase of the run timings records
+ * how many polls it took. Defaults to 100 ms, 2, 500 ms and 30 seconds.
+ */
+export function setStatusPollSchedule(schedule: {
+  firstMs: number;
+  backoff: number;
+  maxMs: number;
+  deadlineMs: number;
+}): void {
+  EspProvEngineHybridObject.setStatusPollSchedule(
+    schedule.firstMs,
+    schedule.backoff,
+    schedule.maxMs,
+    schedule.deadlineMs
+  );
+}
+
+/**
+ * Sends the credentials and waits until the device joined the network.
+ * Cancelling through `options` also ends the status wait, see
+ * `PTCallOptions`; the device keeps whatever config it already applied.
+ */
 export async function provisionESPDevice(
   deviceName: string,
   ssid: string,
-  password: string
+  password: string,
+  options?: PTCallOptions
 ): Promise<void> {
   await handleError(
-    EspProvToolkitHybridObject.provisionESPDevice(deviceName, ssid, password)
+    deviceCall(
+      deviceName,
+      options,
+      (operationId) =>
+        EspProvEngineHybridObject.provisionESPDevice(
+          deviceName,
+          ssid,
+          password,
+          operationId
+        ),
+      () =>
+        EspProvToolkitHybridObject.provisionESPDevice(deviceName, ssid, password)
+    )
   );
 }
 
 export function isESPDeviceSessionEstablished(deviceName: string): boolean {
   const result =
-    EspProvToolkitHybridObject.isESPDeviceSessionEstablished(deviceName);
+    backendFor(deviceName).isESPDeviceSessionEstablished(deviceName);
   if (!result.success && result.error) {
-    throw new PTException(result.error);
+    throw failure(result.error);
   }
   return result.result!;
 }
 
+/**
+ * The connection state the native layers track for the device, for either
+ * backend. Devices that never connected are IDLE.
+ */
+export function getConnectionStateOfESPDevice(
+  deviceName: string
+): PTConnectionState {
+  return EspProvEngineHybridObject.getConnectionStateOfESPDevice(deviceName);
+}
+
+/**
+ * Calls `listener` on every connection state change of any device, including
+ * drops and timeouts nobody waited for. Returns a function that unsubscribes.
+ */
+export function onConnectionStateChange(
+  listener: (transition: PTConnectionTransition) => void
+): () => void {
+  const id = EspProvEngineHybridObject.addConnectionStateListener(listener);
+  return () => {
+    EspProvEngineHybridObject.removeConnectionStateListener(id);
+  };
+}
+
+/**
+ * When each phase of the device's current run started and how long it took:
+ * search, create, connect, version info, handshake, scan, config send, apply
+ * and status wait, in that order. A phase starts the run over from itself,
+ * so a reconnect drops the previous attempt's later phases. Only devices the
+ * native engine runs are timed, others return an empty list.
+ */
+export function getRunTimingsOfESPDevice(deviceName: string): PTPhaseSpan[] {
+  if (!engineDevices.has(deviceName)) {
+    return [];
+  }
+  return EspProvEngineHybridObject.getRunTimingsOfESPDevice(deviceName);
+}
+
+/**
+ * Latency percentiles of every provisioning phase and custom endpoint path,
+ * aggregated natively over all devices, and how often each `PTError` was
+ * reported. Counting starts at launch or at the last reset; pass
+ * `{ reset: true }` to read and restart in one step, e.g. at a shift change.
+ * Phases are timed for engine devices only, endpoints for engine devices'
+ * `sendDataToESPDevice` calls.
+ */
+export function getMetricsSnapshot(options?: {
+  reset?: boolean;
+}): PTMetricsSnapshot {
+  return EspProvEngineHybridObject.getMetricsSnapshot(options?.reset ?? false);
+}
+
+export function resetMetrics(): void {
+  EspProvEngineHybridObject.resetMetrics();
+}
+
+/**
+ * Starts recording a native timeline of engine calls, transport exchanges,
+ * crypto, connection state changes, device waits and, on Android, work
+ * dispatched to the main thread. Off by default; while off, tracing costs one
+ * flag check per event. Starting again drops the events recorded so far.
+ */
+export function startTracing(): void {
+  EspProvEngineHybridObject.startTracing();
+}
+
+export function stopTracing(): void {
+  EspProvEngineHybridObject.stopTracing();
+}
+
+/**
+ * The recorded timeline as Chrome trace event JSON. Write it to a file and
+ * open it in Perfetto (ui.perfetto.dev) or chrome://tracing. Works while
+ * tracing runs and after it stopped.
+ */
+export function exportTrace(): string {
+  return EspProvEngineHybridObject.exportTrace();
+}
+
+export async function sendDataToESPDevice(
+  deviceName: string,
+  path: string,
+  data: string,
+  options?: PTCallOptions
+): Promise<string>;
+export async function sendDataToESPDevice(
+  deviceName: string,
+  path: string,
+  data: ArrayBuffer,
+  options?: PTCallOptions
+): Promise<ArrayBuffer>;
 export async function sendDataToESPDevice(
   deviceName: string,
   path: string,
-  data: string
-): Promise<string> {
+  data: string | ArrayBuffer,
+  options?: PTCallOptions
+): Promise<string | ArrayBuffer> {
+  if (typeof data !== 'string') {
+    const result = await handleError(
+      deviceCall(
+        deviceName,
+        options,
+        (operationId) =>
+          EspProvEngineHybridObject.sendBinaryDataToESPDevice(
+            deviceName,
+            path,
+            data,
+            operationId
+          ),
+        () =>
+          EspProvToolkitHybridObject.sendBinaryDataToESPDevice(
+            deviceName,
+            path,
+            data
+          )
+      )
+    );
+    return result.data!;
+  }
   const result = await handleError(
-    EspProvToolkitHybridObject.sendDataToESPDevice(deviceName, path, data)
+    deviceCall(
+      deviceName,
+      options,
+      (operationId) =>
+        EspProvEngineHybridObject.sendDataToESPDevice(
+          deviceName,
+          path,
+          data,
+          operationId
+        ),
+      () =>
+        EspProvToolkitHybridObject.sendDataToESPDevice(deviceName, path, data)
+    )
   );
   return result.str!;
 }
 
+async function provisionJob(
+  job: PTProvisionJob,
+  options: () => PTCallOptions | undefined
+): Promise<PTDeviceProvisionResult> {
+  try {
+    await createESPDevice(
+      job.deviceName,
+      job.transport,
+      job.security,
+      job.proofOfPossession,
+      job.softAPPassword,
+      job.username
+    );
+    const status = await connectToESPDevice(job.deviceName, options());
+    if (status !== PTSessionStatus.CONNECTED) {
+      throw failure(PTError.SESSION_INIT_ERROR);
+    }
+    try {
+      await provisionESPDevice(
+        job.deviceName,
+        job.ssid,
+        job.passphrase,
+        options()
+      );
+    } finally {
+      disconnectFromESPDevice(job.deviceName);
+    }
+    return { deviceName: job.deviceName, success: true };
+  } catch (e) {
+    // PTExceptions were counted when they were thrown
+    const error =
+      e instanceof PTException
+        ? e.code
+        : failure(PTError.ESP_NATIVE_UNKNOWN_ERROR).code;
+    return { deviceName: job.deviceName, success: false, error };
+  }
+}
+
+/**
+ * Provisions several devices at once, at most `options.concurrency` (1 to
+ * 16) at a time. SoftAP jobs run one after the other, since the phone joins
+ * one device's access point at a time. Never rejects: every job gets its own
+ * result, in the order of `jobs`. Once `options.signal` aborts or
+ * `options.timeoutMs` passed, running jobs are cut short and the ones left
+ * fail with `OPERATION_CANCELLED` or `PROV_TIMED_OUT_ERROR`.
+ */
+export async function provisionESPDevices(
+  jobs: PTProvisionJob[],
+  options?: PTBatchOptions & PTCallOptions
+): Promise<PTDeviceProvisionResult[]> {
+  const signal = options?.signal;
+  if (nativeProtocommEnabled) {
+    // The engine keeps the deadline itself, the signal cancels the operation
+    const operationId = signal ? nextOperationId++ : undefined;
+    const pending = EspProvEngineHybridObject.provisionESPDevices(
+      jobs,
+      { concurrency: options?.concurrency, timeoutMs: options?.timeoutMs },
+      operationId
+    );
+    const onAbort = () =>
+      EspProvEngineHybridObject.cancelESPOperation(operationId!);
+    if (signal?.aborted) {
+      onAbort();
+    } else {
+      signal?.addEventListener('abort', onAbort);
+    }
+    let results: PTDeviceProvisionResult[];
+    try {
+      results = await pending;
+    } finally {
+      signal?.removeEventListener('abort', onAbort);
+    }
+    for (const job of jobs) {
+      registerWithEngine(
+        job.deviceName,
+        job.transport,
+        job.security,
+        job.proofOfPossession,
+        job.username
+      );
+    }
+    for (const result of results) {
+      if (!result.success && result.error) {
+        EspProvEngineHybridObject.countError(result.error);
+      }
+    }
+    return results;
+  }
+
+  // Each call of a job gets what is left of the batch's deadline
+  const deadline =
+    options?.timeoutMs !== undefined
+      ? Date.now() + options.timeoutMs
+      : undefined;
+  const remaining = (): PTCallOptions | undefined =>
+    signal || deadline !== undefined
+      ? {
+          signal,
+          timeoutMs: deadline !== undefined ? deadline - Date.now() : undefined,
+        }
+      : undefined;
+  const stopped = (): PTError | undefined => {
+    if (signal?.aborted) {
+      return PTError.OPERATION_CANCELLED;
+    }
+    if (deadline !== undefined && Date.now() >= deadline) {
+      return PTError.PROV_TIMED_OUT_ERROR;
+    }
+    return undefined;
+  };
+  const results = new Array<PTDeviceProvisionResult>(jobs.length);
+  const pending = jobs.map((_, index) => index);
+  // Set while a SoftAP job runs, see the native batch
+  let softAp: Promise<void> | undefined;
+  const worker = async () => {
+    while (pending.length > 0) {
+      const at = pending.findIndex(
+        (index) =>
+          softAp === undefined ||
+          jobs[index]!.transport !== PTTransport.TRANSPORT_SOFTAP
+      );
+      if (at < 0) {
+        await softAp;
+        continue;
+      }
+      const index = pending.splice(at, 1)[0]!;
+      const job = jobs[index]!;
+      const stop = stopped();
+      if (stop !== undefined) {
+        results[index] = {
+          deviceName: job.deviceName,
+          success: false,
+          error: failure(stop).code,
+        };
+        continue;
+      }
+      const run = provisionJob(job, remaining).then((result) => {
+        results[index] = result;
+      });
+      if (job.transport === PTTransport.TRANSPORT_SOFTAP) {
+        softAp = run.then(() => {
+          softAp = undefined;
+        });
+        await softAp;
+      } else {
+        await run;
+      }
+    }
+  };
+  // Clamped like the engine clamps it, NaN included
+  const requested = options?.concurrency ?? 3;
+  const concurrency = Number.isNaN(requested)
+    ? 1
+    : Math.min(Math.max(1, Math.floor(requested)), 16);
+  await Promise.all(
+    Array.from({ length: Math.min(concurrency, jobs.length) }, worker)
+  );
+  return results;
+}
+
 export function getIPv4AddressOfESPDevice(
   deviceName: string
 ): string | undefined {
   const result =
     EspProvToolkitHybridObject.getIPv4AddressOfESPDevice(deviceName);
   if (!result.success && result.error) {
-    throw new PTException(result.error);
+    throw failure(result.error);
   }
   return result.str;
 }
@@ -168,10 +980,33 @@ export function getCurrentLocationStatus(): PTLocationAccess {
 }
 
 // Export enums as values
-export { PTSecurity, PTTransport, PTSessionStatus, PTLocationAccess, PTError };
+export {
+  PTSecurity,
+  PTTransport,
+  PTSessionStatus,
+  PTLocationAccess,
+  PTError,
+  PTConnectionState,
+  PTConnectionEvent,
+  PTPhase,
+};
 
 // Export types
-export type { PTWifiEntry, PTDevice };
+export type {
+  PTCallOptions,
+  PTDiscoveryOptions,
+  PTWifiEntry,
+  PTWifiColumns,
+  PTDevice,
+  PTProvisionJob,
+  PTBatchOptions,
+  PTDeviceProvisionResult,
+  PTConnectionTransition,
+  PTPhaseSpan,
+  PTMetricsSnapshot,
+  PTLatencySummary,
+  PTErrorCount,
+};
 
 // export hooks
 export { useLocationPermissions };
@@ -179,3 +1014,4 @@ export { useSoftAPDevice } from './hooks/useSoftAPDevice';
 export { useProvisionDevice } from './hooks/useProvisionDevice';
 export { useSoftapProvisioning } from './hooks/useSoftapProvisioning';
 export { getErrorDescription } from './utils';
+export { getWifiColumnsSsid } from './wifiColumns';
@@ -78,6 +78,8 @@ export function getErrorDescription(errorCode: PTError): string {
       return 'Insufficient permissions for this operation.';
     case PTError.BLE_ADAPTER_NOT_AVAILABLE:
       return 'Bluetooth adapter of device is not available.';
+    case PTError.OPERATION_CANCELLED:
+      return 'The operation was cancelled.';
     default:
       return 'Unknown error';
   }
@@ -0,0 +1,122 @@
+import type { PTWifiColumns, PTWifiEntry } from './EspProvToolkit.types';
+
+/**
+ * Views the columns the engine packs into one ArrayBuffer, see
+ * `WifiScanColumnLayout` in cpp/core/WifiScanColumns.hpp. No bytes are
+ * copied, every column aliases `buffer`.
+ */
+export function columnsFromBuffer(
+  count: number,
+  buffer: ArrayBuffer
+): PTWifiColumns {
+  const ssidOffsets = count * 8;
+  const channel = ssidOffsets + (count + 1) * 4;
+  const rssi = channel + count * 2;
+  const auth = rssi + count;
+  const ssids = auth + count;
+  return {
+    count,
+    bssid: new Float64Array(buffer, 0, count),
+    ssidOffsets: new Uint32Array(buffer, ssidOffsets, count + 1),
+    ssidBytes: new Uint8Array(buffer, ssids),
+    channel: new Uint16Array(buffer, channel, count),
+    rssi: new Int8Array(buffer, rssi, count),
+    auth: new Uint8Array(buffer, auth, count),
+  };
+}
+
+/**
+ * Builds the same columns from the entries the Espressif SDKs return.
+ */
+export function columnsFromEntries(entries: PTWifiEntry[]): PTWifiColumns {
+  const count = entries.length;
+  const encoded = entries.map((entry) => encodeUtf8(entry.ssid));
+  const ssidOffsets = new Uint32Array(count + 1);
+  for (let i = 0; i < count; i++) {
+    ssidOffsets[i + 1] = ssidOffsets[i]! + encoded[i]!.length;
+  }
+  const ssidBytes = new Uint8Array(ssidOffsets[count]!);
+  const bssid = new Float64Array(count);
+  const channel = new Uint16Array(count);
+  const rssi = new Int8Array(count);
+  const auth = new Uint8Array(count);
+  entries.forEach((entry, i) => {
+    ssidBytes.set(encoded[i]!, ssidOffsets[i]!);
+    bssid[i] = parseBssid(entry.bssid);
+    channel[i] = entry.channel ?? 0;
+    rssi[i] = entry.rssi;
+    auth[i] = entry.auth;
+  });
+  return { count, bssid, ssidOffsets, ssidBytes, channel, rssi, auth };
+}
+
+/**
+ * Decodes the SSID of network `index`. Only call it for the rows that are
+ * actually rendered, that is the point of the columns.
+ */
+export function getWifiColumnsSsid(
+  columns: PTWifiColumns,
+  index: number
+): string {
+  const begin = columns.ssidOffsets[index]!;
+  const end = columns.ssidOffsets[index + 1]!;
+  return decodeUtf8(columns.ssidBytes, begin, end);
+}
+
+// The BSSID as a 48-bit integer, -1 when missing or malformed
+function parseBssid(bssid: string | undefined): number {
+  const hex = bssid?.replace(/[:-]/g, '') ?? '';
+  return /^[0-9a-fA-F]{12}$/.test(hex) ? parseInt(hex, 16) : -1;
+}
+
+// Hermes does not ship TextEncoder/TextDecoder on every supported version
+function encodeUtf8(text: string): Uint8Array {
+  const bytes: number[] = [];
+  for (const character of text) {
+    const code = character.codePointAt(0)!;
+    if (code < 0x80) {
+      bytes.push(code);
+    } else if (code < 0x800) {
+      bytes.push(0xc0 | (code >> 6), 0x80 | (code & 0x3f));
+    } else if (code < 0x10000) {
+      bytes.push(
+        0xe0 | (code >> 12),
+        0x80 | ((code >> 6) & 0x3f),
+        0x80 | (code & 0x3f)
+      );
+    } else {
+      bytes.push(
+        0xf0 | (code >> 18),
+        0x80 | ((code >> 12) & 0x3f),
+        0x80 | ((code >> 6) & 0x3f),
+        0x80 | (code & 0x3f)
+      );
+    }
+  }
+  return Uint8Array.from(bytes);
+}
+
+function decodeUtf8(bytes: Uint8Array, begin: number, end: number): string {
+  let text = '';
+  let i = begin;
+  while (i < end) {
+    const lead = bytes[i]!;
+    const length = lead < 0x80 ? 1 : lead < 0xe0 ? 2 : lead < 0xf0 ? 3 : 4;
+    if (lead < 0x80) {
+      text += String.fromCharCode(lead);
+    } else if (i + length > end || (lead & 0xc0) === 0x80) {
+      // SSIDs are raw bytes, not guaranteed UTF-8
+      text += '�';
+      i += 1;
+      continue;
+    } else {
+      let code = lead & (0xff >> (length + 1));
+      for (let k = 1; k < length; k++) {
+        code = (code << 6) | (bytes[i + k]! & 0x3f);
+      }
+      text += String.fromCodePoint(code);
+    }
+    i += length;
+  }
+  return text;
+}